@@ -17,7 +17,7 @@
 #include "jf_basic.h"
 #include "jf_err.h"
 #include "jf_logger.h"
-#include "jf_hashtable.h"
+#include "jf_flattable.h"
 #include "jf_string.h"
 #include "jf_process.h"
 #include "jf_jiukun.h"
@@ -92,8 +92,9 @@ typedef struct
 
     /**Maximum number of command supported.*/
     u32 icp_u32MaxCmd;
-    /**Hash table for commands.*/
-    jf_hashtable_t * icp_jhCmd;
+    /**Flat hash table for commands, the key is the command name and the value is the pointer to
+       the command.*/
+    jf_flattable_t * icp_jfCmd;
 } internal_clieng_parser_t;
 
 /** Declare the internal command parser object.
@@ -280,9 +281,9 @@ static u32 _parseAndProcess(internal_clieng_parser_t * picp)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_clieng_cmd_t * picc = NULL;
+    internal_clieng_cmd_t ** ppicc = NULL;
 
-    u32Ret = jf_hashtable_getEntry(
-        picp->icp_jhCmd, (void *)picp->icp_pstrArgv[0], (void **)&picc);
+    u32Ret = jf_flattable_get(picp->icp_jfCmd, picp->icp_pstrArgv[0], (void **)&ppicc);
 
     if (u32Ret != JF_ERR_NO_ERROR)
     {
@@ -291,6 +292,8 @@ static u32 _parseAndProcess(internal_clieng_parser_t * picp)
     }
     else
     {
+        picc = *ppicc;
+
         /*Set default parameters of the command.*/
         u32Ret = picc->icc_fnSetDefaultParam(picp->icp_pMaster, picc->icc_pParam);
 
@@ -314,32 +317,20 @@ static u32 _parseAndProcess(internal_clieng_parser_t * picp)
     return u32Ret;
 }
 
-static olint_t _cmpKeysOfCliengCmd(void * pKey1, void * pKey2)
-{
-    return ol_strcmp((const olchar_t *)pKey1, (const olchar_t *)pKey2);
-}
-
-static u32 _freeCliengCmd(void ** ppCmd)
+static void _freeCliengCmdTable(internal_clieng_parser_t * picp)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-//    internal_clieng_cmd_t * picc = *ppCmd;
-
-    jf_jiukun_freeMemory(ppCmd);
-
-    return u32Ret;
-}
+    jf_flattable_iterator_t jfi;
 
-static olint_t _hashKeyOfCliengCmd(void * pKey)
-{
-    return jf_hashtable_hashPJW(pKey);
-}
+    /*Free all commands before the table is destroyed.*/
+    jf_flattable_setupIterator(picp->icp_jfCmd, &jfi);
+    while (! jf_flattable_isEndOfIterator(&jfi))
+    {
+        jf_jiukun_freeMemory((void **)jf_flattable_getValueFromIterator(&jfi));
 
-static void * _getKeyFromCliengCmd(void * pCmd)
-{
-    internal_clieng_cmd_t * picc = pCmd;
+        jf_flattable_incrementIterator(&jfi);
+    }
 
-    /*Use command name as the key.*/
-    return picc->icc_strName;
+    jf_flattable_destroy(&picp->icp_jfCmd);
 }
 
 /* --- public routine section ------------------------------------------------------------------- */
@@ -348,7 +339,7 @@ u32 initCliengParser(clieng_parser_init_param_t * pcpip)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_clieng_parser_t * picp = &ls_icpCliengParser;
-    jf_hashtable_create_param_t jhcp;
+    jf_flattable_create_param_t jfcp;
     olsize_t size = 0;
 
     assert(pcpip != NULL);
@@ -380,15 +371,14 @@ u32 initCliengParser(clieng_parser_init_param_t * pcpip)
     {
         picp->icp_u32MaxCmd = (pcpip->cpip_u32MaxCmd > 0) ? pcpip->cpip_u32MaxCmd : MAX_CMD;
 
-        ol_bzero(&jhcp, sizeof(jhcp));
+        ol_bzero(&jfcp, sizeof(jfcp));
 
-        jhcp.jhcp_u32MinSize = picp->icp_u32MaxCmd;
-        jhcp.jhcp_fnCmpKeys = _cmpKeysOfCliengCmd;
-        jhcp.jhcp_fnHashKey = _hashKeyOfCliengCmd;
-        jhcp.jhcp_fnGetKeyFromEntry = _getKeyFromCliengCmd;
-        jhcp.jhcp_fnFreeEntry = _freeCliengCmd;
+        /*Use command name as the key, the name is saved in the command.*/
+        jfcp.jfcp_u32MinSize = picp->icp_u32MaxCmd;
+        jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_STRING;
+        jfcp.jfcp_u16ValueSize = sizeof(internal_clieng_cmd_t *);
 
-        u32Ret = jf_hashtable_create(&picp->icp_jhCmd, &jhcp);
+        u32Ret = jf_flattable_create(&picp->icp_jfCmd, &jfcp);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -409,8 +399,8 @@ u32 finiCliengParser(void)
     if (picp->icp_piccsCmdSet != NULL)
         jf_jiukun_freeMemory((void **)&picp->icp_piccsCmdSet);
 
-    if (picp->icp_jhCmd != NULL)
-        jf_hashtable_destroy(&picp->icp_jhCmd);
+    if (picp->icp_jfCmd != NULL)
+        _freeCliengCmdTable(picp);
 
     picp->icp_bInitialized = FALSE;
 
@@ -469,7 +459,7 @@ u32 newCliengCmd(
     /*Check if the command is already added.*/
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        if (jf_hashtable_isKeyInTable(picp->icp_jhCmd, (void *)pstrName))
+        if (jf_flattable_get(picp->icp_jfCmd, pstrName, NULL) == JF_ERR_NO_ERROR)
             u32Ret = JF_ERR_CMD_ALREADY_EXIST;
     }
 
@@ -487,8 +477,8 @@ u32 newCliengCmd(
         picc->icc_fnProcessCmd = fnProcessCmd;
         picc->icc_pParam = pParam;
 
-        /*Insert the command to hash table.*/
-        u32Ret = jf_hashtable_insertEntry(picp->icp_jhCmd, (void *)picc);
+        /*Insert the command to flat hash table.*/
+        u32Ret = jf_flattable_insert(picp->icp_jfCmd, picc->icc_strName, &picc);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -498,7 +488,7 @@ u32 newCliengCmd(
     }
     else if (picc != NULL)
     {
-        _freeCliengCmd((void **)&picc);
+        jf_jiukun_freeMemory((void **)&picc);
     }
 
     return u32Ret;
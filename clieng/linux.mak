@@ -15,7 +15,7 @@ SONAME = jf_clieng
 
 SOURCES = clieng.c engio.c cmdparser.c cmdhistory.c 
 
-JIUTAI_SRCS = jf_hashtable.c jf_mutex.c jf_process.c jf_hex.c
+JIUTAI_SRCS = jf_flattable.c jf_mutex.c jf_process.c jf_hex.c
 
 EXTRA_LIBS = -ljf_logger -ljf_string -ljf_files -ljf_jiukun
 
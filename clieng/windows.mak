@@ -16,7 +16,7 @@ RESOURCE = clieng
 
 SOURCES = clieng.c engio.c cmdparser.c cmdhistory.c
 
-JIUTAI_SRCS = $(JIUTAI_DIR)\jf_mutex.c $(JIUTAI_DIR)\jf_hashtable.c $(JIUTAI_DIR)\jf_hex.c \
+JIUTAI_SRCS = $(JIUTAI_DIR)\jf_mutex.c $(JIUTAI_DIR)\jf_flattable.c $(JIUTAI_DIR)\jf_hex.c \
     $(JIUTAI_DIR)\jf_process.c
 
 EXTRA_LIBS = ws2_32.lib Psapi.lib jf_logger.lib jf_string.lib jf_files.lib jf_jiukun.lib
@@ -92,6 +92,10 @@ static u32 _initConfigTree(internal_config_tree_t * pict, config_tree_init_param
     if (u32Ret == JF_ERR_NO_ERROR)
         u32Ret = jf_ptree_create(&pict->ict_pjpConfig);
 
+    /*The config is found with full path, enable the path index.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_enablePathIndex(pict->ict_pjpConfig);
+
     /*Load config from persistency.*/
     if (u32Ret == JF_ERR_NO_ERROR)
         u32Ret = loadConfigFromPersistency(
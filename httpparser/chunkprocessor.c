@@ -70,22 +70,13 @@ static u32 _reallocHttpParserChunkMemory(
     internal_httpparser_chunk_processor_t * pihcp, u32 u32MallocSize)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    u8 * pu8Buffer = NULL;
 
     assert(pihcp->ihcp_u32MallocSize < u32MallocSize);
 
-    /*Allocate new buffer.*/
-    u32Ret = jf_jiukun_allocMemory((void **)&pu8Buffer, u32MallocSize);
+    /*Grow the buffer, the data is copied only if the buffer cannot be extended in place.*/
+    u32Ret = jf_jiukun_reallocMemory((void **)&pihcp->ihcp_pu8Buffer, u32MallocSize);
     if (u32Ret == JF_ERR_NO_ERROR)
-    {
-        /*Copy the data to new buffer.*/
-        ol_memcpy(pu8Buffer, pihcp->ihcp_pu8Buffer, pihcp->ihcp_u32Offset);
-
-        /*Free the old buffer and save the new buffer.*/
-        jf_jiukun_freeMemory((void **)&pihcp->ihcp_pu8Buffer);
-        pihcp->ihcp_pu8Buffer = pu8Buffer;
         pihcp->ihcp_u32MallocSize = u32MallocSize;
-    }
 
     return u32Ret;
 }
@@ -11,6 +11,16 @@
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#if defined(LINUX) && ! defined(_GNU_SOURCE)
+    /*The jiukun library is built without _GNU_SOURCE, getcpu() requires it.*/
+    #define _GNU_SOURCE
+#endif
+
+#if defined(LINUX)
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -58,12 +68,52 @@ typedef struct buddy_zone
     u8 * bz_pu8Pool;
     /**The end memory address of pool for the zone.*/
     u8 * bz_pu8PoolEnd;
+    /**Size of the memory mapping for the pool, 0 if the pool is allocated from heap.*/
+    olsize_t bz_sPoolMap;
+    /**NUMA node of the zone.*/
+    u32 bz_u32NodeId;
 } buddy_zone_t;
 
 /** Maximum buddy zones.
  */
 #define MAX_BUDDY_ZONES            (20)
 
+/** Size of the huge page.
+ */
+#define BUDDY_HUGE_PAGE_SIZE       (1 << 21)
+
+/** Maximum NUMA node the buddy can bind a zone to.
+ */
+#define MAX_BUDDY_NUMA_NODE        (64)
+
+/** Minimal order of the free block returned to the kernel by the reclaimer, smaller blocks are
+ *  likely to be allocated again soon.
+ */
+#define BUDDY_RECLAIM_MIN_ORDER    (4)
+
+/** Number of page allocation using the cached NUMA node before the node is read again.
+ */
+#define BUDDY_NUMA_NODE_REFRESH    (64)
+
+/** Thread local storage specifier.
+ */
+#if defined(LINUX)
+    #define BUDDY_THREAD_LOCAL     __thread
+#elif defined(WINDOWS)
+    #define BUDDY_THREAD_LOCAL     __declspec(thread)
+#endif
+
+#if defined(LINUX)
+
+/** Memory policy for mbind(), allocate memory from the specified node and fall back to other nodes
+ *  when the node is out of memory.
+ */
+#ifndef MPOL_PREFERRED
+    #define MPOL_PREFERRED         (1)
+#endif
+
+#endif
+
 /** Define the internal jiukun buddy data type.
  */
 typedef struct
@@ -72,7 +122,11 @@ typedef struct
     boolean_t ijb_bInitialized;
     /**Donot grow if it's TRUE.*/
     boolean_t ijb_bNoGrow;
-    u8 ijb_u8Reserved[6];
+    /**Back the zone with huge page if it's TRUE.*/
+    boolean_t ijb_bHugePage;
+    /**Bind the zone to NUMA node if it's TRUE.*/
+    boolean_t ijb_bNumaNode;
+    u8 ijb_u8Reserved[4];
 
     /**Maximum page order.*/
     u32 ijb_u32MaxOrder;
@@ -115,17 +169,22 @@ static inline ulong _getPageOrder(jiukun_page_t * page)
 }
 
 /** Split the page list of high order and add the last half part to low order.
+ *
+ *  @note
+ *  -# The last half parts of a reclaimed block are still reclaimed.
  *
  *  @param zone [in] The zone from which jiukun page is allocated.
  *  @param page [in/out] The page list to split.
  *  @param low [in] The low page order.
  *  @param high [in] The high page order.
  *  @param area [in/out] The free area for the high page order.
+ *  @param bReclaimed [in] The page list is reclaimed.
  *
  *  @return The jiukun page object.
  */
 static jiukun_page_t * _splitPageList(
-    buddy_zone_t * zone, jiukun_page_t * page, olint_t low, olint_t high, free_area_t * area)
+    buddy_zone_t * zone, jiukun_page_t * page, olint_t low, olint_t high, free_area_t * area,
+    boolean_t bReclaimed)
 {
     ulong size = 1 << high;
 
@@ -138,6 +197,10 @@ static jiukun_page_t * _splitPageList(
         jf_listhead_add(&(area->fa_jlFree), &(page[size].jp_jlLru));
         area->fa_u32Free++;
         _setPageOrder(&page[size], high);
+        if (bReclaimed)
+            setJpReclaimed((&page[size]));
+        else
+            clearJpReclaimed((&page[size]));
     }
 
     return page;
@@ -150,6 +213,7 @@ static jiukun_page_t * _rmqueue(buddy_zone_t * zone, u32 order)
     free_area_t * area = NULL;
     u32 current_order = 0;
     jiukun_page_t * page = NULL;
+    boolean_t bReclaimed = FALSE;
 
     /*Iterate the linked list head in free area.*/
     for (current_order = order; current_order < zone->bz_u32MaxOrder; ++current_order)
@@ -162,11 +226,13 @@ static jiukun_page_t * _rmqueue(buddy_zone_t * zone, u32 order)
         page = jf_listhead_getEntry(area->fa_jlFree.jl_pjlNext, jiukun_page_t, jp_jlLru);
         jf_listhead_del(&page->jp_jlLru);
         _clearPageOrder(page);
+        bReclaimed = isJpReclaimed(page);
+        clearJpReclaimed(page);
         area->fa_u32Free--;
         zone->bz_u32FreePages -= 1UL << order;
 
         /*Split page list if the current order is higher than the expected order.*/
-        return _splitPageList(zone, page, order, current_order, area);
+        return _splitPageList(zone, page, order, current_order, area, bReclaimed);
     }
 
     return NULL;
@@ -226,6 +292,8 @@ static inline void _freeOnePage(buddy_zone_t * zone, jiukun_page_t * page, u32 o
         area = zone->bz_faFreeArea + order;
         area->fa_u32Free--;
         _clearPageOrder(buddy);
+        /*The merged block is not reclaimed as the freed page is not.*/
+        clearJpReclaimed(buddy);
         page = (buddy_idx > page_idx) ? page : buddy;
         page_idx = pageToIndex(page, zone->bz_papPage);
         order++;
@@ -236,6 +304,155 @@ static inline void _freeOnePage(buddy_zone_t * zone, jiukun_page_t * page, u32 o
     zone->bz_faFreeArea[order].fa_u32Free++;
 }
 
+/** Get the NUMA node of the CPU the calling thread is running on.
+ *
+ *  @note
+ *  -# The node is cached per thread and refreshed every BUDDY_NUMA_NODE_REFRESH calls, so the
+ *   thread migrated to another node uses the new node soon.
+ *  -# The getcpu() of glibc uses vDSO, the system call is used only for old glibc.
+ */
+static u32 _getCurrentNumaNode(void)
+{
+    static BUDDY_THREAD_LOCAL u32 ls_u32BuddyNumaNode = 0;
+    static BUDDY_THREAD_LOCAL u32 ls_u32BuddyNumaNodeRefresh = 0;
+#if defined(LINUX)
+    unsigned int uCpu = 0, uNodeId = 0;
+#endif
+
+    if (ls_u32BuddyNumaNodeRefresh > 0)
+    {
+        ls_u32BuddyNumaNodeRefresh --;
+        return ls_u32BuddyNumaNode;
+    }
+
+#if defined(LINUX)
+  #if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 29))
+    if (getcpu(&uCpu, &uNodeId) != 0)
+        uNodeId = 0;
+  #else
+    if (syscall(SYS_getcpu, &uCpu, &uNodeId, NULL) != 0)
+        uNodeId = 0;
+  #endif
+    ls_u32BuddyNumaNode = (u32)uNodeId;
+#endif
+    ls_u32BuddyNumaNodeRefresh = BUDDY_NUMA_NODE_REFRESH;
+
+    return ls_u32BuddyNumaNode;
+}
+
+#if defined(LINUX)
+
+/** Map memory for the pool of the zone.
+ *
+ *  @note
+ *  -# If huge page is requested, the pool is mapped with the huge pages reserved in the system. If
+ *   no huge page is reserved, the pool is aligned to huge page size and transparent huge page is
+ *   advised.
+ *  -# If NUMA node is requested, the memory policy of the pool prefers the node of the zone. The
+ *   policy is set before the memory is touched so the pages are placed on the node at first fault.
+ */
+static u32 _mapBuddyZonePool(
+    internal_jiukun_buddy_t * piab, buddy_zone_t * pbz, olsize_t sPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Map = MAP_FAILED, * pu8Pool = NULL;
+    olsize_t sMap = sPool;
+    ulong ulNodeMask = 0;
+
+    if (piab->ijb_bHugePage)
+    {
+        sMap = ALIGN_CEIL(sPool, BUDDY_HUGE_PAGE_SIZE);
+        /*Try the huge pages reserved in the system.*/
+        pu8Map = mmap(
+            NULL, sMap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        pu8Pool = pu8Map;
+    }
+
+    if ((pu8Map == MAP_FAILED) && piab->ijb_bHugePage)
+    {
+        /*Map one more huge page so the pool can be aligned to huge page size.*/
+        pu8Map = mmap(
+            NULL, sMap + BUDDY_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0);
+        if (pu8Map != MAP_FAILED)
+        {
+            pu8Pool = (u8 *)ALIGN_CEIL((ulong)pu8Map, BUDDY_HUGE_PAGE_SIZE);
+            /*Unmap the unaligned head and tail.*/
+            if (pu8Pool > pu8Map)
+                munmap(pu8Map, pu8Pool - pu8Map);
+            munmap(pu8Pool + sMap, pu8Map + BUDDY_HUGE_PAGE_SIZE - pu8Pool);
+            pu8Map = pu8Pool;
+
+            madvise(pu8Pool, sMap, MADV_HUGEPAGE);
+            JF_LOGGER_INFO("no reserved huge page, use transparent huge page");
+        }
+    }
+    else if (pu8Map == MAP_FAILED)
+    {
+        pu8Map = mmap(NULL, sMap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        pu8Pool = pu8Map;
+    }
+
+    if (pu8Map == MAP_FAILED)
+        u32Ret = JF_ERR_OUT_OF_MEMORY;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && piab->ijb_bNumaNode &&
+        (pbz->bz_u32NodeId < MAX_BUDDY_NUMA_NODE))
+    {
+        ulNodeMask = 1UL << pbz->bz_u32NodeId;
+        /*The policy is a hint, the pool is still usable if it fails.*/
+        if (syscall(SYS_mbind, pu8Pool, sMap, MPOL_PREFERRED, &ulNodeMask,
+                    MAX_BUDDY_NUMA_NODE, 0) != 0)
+            JF_LOGGER_INFO("failed to bind zone to node %u", pbz->bz_u32NodeId);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pbz->bz_pu8Pool = pu8Pool;
+        pbz->bz_sPoolMap = sMap;
+    }
+
+    return u32Ret;
+}
+
+#endif
+
+/** Allocate memory pool for the zone.
+ *
+ *  @note
+ *  -# On Linux, the pool is always mapped so it's aligned to system page, the slab colouring and
+ *   the cache line alignment rely on it.
+ */
+static u32 _allocBuddyZonePool(
+    internal_jiukun_buddy_t * piab, buddy_zone_t * pbz, olsize_t sPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+#if defined(LINUX)
+    u32Ret = _mapBuddyZonePool(piab, pbz, sPool);
+#else
+    u32Ret = jf_mem_alloc((void **)&(pbz->bz_pu8Pool), sPool);
+#endif
+
+    return u32Ret;
+}
+
+/** Free memory pool of the zone.
+ */
+static void _freeBuddyZonePool(buddy_zone_t * pbz)
+{
+#if defined(LINUX)
+    if (pbz->bz_sPoolMap != 0)
+    {
+        munmap(pbz->bz_pu8Pool, pbz->bz_sPoolMap);
+        pbz->bz_pu8Pool = NULL;
+        pbz->bz_sPoolMap = 0;
+    }
+    else
+#endif
+        jf_mem_free((void **)&(pbz->bz_pu8Pool));
+}
+
 static u32 _destroyBuddyZone(buddy_zone_t ** ppZone)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -251,7 +468,7 @@ static u32 _destroyBuddyZone(buddy_zone_t ** ppZone)
 
     /*Free the memory pool.*/
     if (pbz->bz_pu8Pool != NULL)
-        jf_mem_free((void **)&(pbz->bz_pu8Pool));
+        _freeBuddyZonePool(pbz);
 
     jf_mem_free((void **)ppZone);
 
@@ -272,19 +489,22 @@ static void _initBuddyPage(
 
 }
 
-static u32 _createBuddyZone(buddy_zone_t ** ppZone, u32 u32MaxOrder, u32 u32ZoneId)
+static u32 _createBuddyZone(
+    internal_jiukun_buddy_t * piab, buddy_zone_t ** ppZone, u32 u32ZoneId, u32 u32NodeId)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     buddy_zone_t * pbz = NULL;
     u32 u32Index;
+    u32 u32MaxOrder = piab->ijb_u32MaxOrder;
 
-    JF_LOGGER_INFO("max order: %u, zoneid: %u", u32MaxOrder, u32ZoneId);
+    JF_LOGGER_INFO("max order: %u, zoneid: %u, node: %u", u32MaxOrder, u32ZoneId, u32NodeId);
 
     /*Allocate memory for buddy zone.*/
     u32Ret = jf_mem_calloc((void **)&pbz, sizeof(buddy_zone_t));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         pbz->bz_u32MaxOrder = u32MaxOrder;
+        pbz->bz_u32NodeId = u32NodeId;
         pbz->bz_u32NumOfPage = 1UL << (pbz->bz_u32MaxOrder - 1);
         pbz->bz_u32FreePages = pbz->bz_u32NumOfPage;
 
@@ -310,8 +530,7 @@ static u32 _createBuddyZone(buddy_zone_t ** ppZone, u32 u32MaxOrder, u32 u32Zone
             &(pbz->bz_papPage[0].jp_jlLru));
 
         /*Allocate memory pool.*/
-        u32Ret = jf_mem_alloc(
-            (void **)&(pbz->bz_pu8Pool), pbz->bz_u32NumOfPage * BUDDY_PAGE_SIZE);
+        u32Ret = _allocBuddyZonePool(piab, pbz, pbz->bz_u32NumOfPage * BUDDY_PAGE_SIZE);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -329,19 +548,75 @@ static u32 _createBuddyZone(buddy_zone_t ** ppZone, u32 u32MaxOrder, u32 u32Zone
     return u32Ret;
 }
 
-static jiukun_page_t * _allocPages(
-    internal_jiukun_buddy_t * piab, u32 u32Order, jf_flag_t flag)
+/** Return the free blocks in the zone to the kernel.
+ *
+ *  @note
+ *  -# The physical pages of the block are dropped, the block is zero-filled when it's touched
+ *   again.
+ *  -# The zone lock must be held so the block cannot be allocated while it's advised.
+ *  -# The block returned is flagged, the flag is cleared when the block is allocated or merged,
+ *   so the block is advised only once.
+ *
+ *  @return Number of pages returned in this call.
+ */
+static u32 _reclaimBuddyZone(buddy_zone_t * pbz)
+{
+    u32 u32Pages = 0;
+#if defined(LINUX)
+    u32 order = 0;
+    jf_listhead_t * pos = NULL;
+    jiukun_page_t * page = NULL;
+    ulong ulSysPage = (ulong)sysconf(_SC_PAGESIZE);
+    ulong ulStart = 0, ulEnd = 0;
+
+    for (order = BUDDY_RECLAIM_MIN_ORDER; order < pbz->bz_u32MaxOrder; order ++)
+    {
+        jf_listhead_forEach(&(pbz->bz_faFreeArea[order].fa_jlFree), pos)
+        {
+            page = jf_listhead_getEntry(pos, jiukun_page_t, jp_jlLru);
+            /*The block is already returned to the kernel.*/
+            if (isJpReclaimed(page))
+                continue;
+
+            ulStart = (ulong)pbz->bz_pu8Pool +
+                (ulong)pageToIndex(page, pbz->bz_papPage) * BUDDY_PAGE_SIZE;
+            ulEnd = ulStart + (BUDDY_PAGE_SIZE << order);
+
+            /*The pool allocated from heap may not be aligned to the system page.*/
+            ulStart = ALIGN_CEIL(ulStart, ulSysPage);
+            ulEnd = ulEnd & ~(ulSysPage - 1);
+
+            if ((ulEnd > ulStart) &&
+                (madvise((void *)ulStart, ulEnd - ulStart, MADV_DONTNEED) == 0))
+            {
+                setJpReclaimed(page);
+                u32Pages += 1 << order;
+            }
+        }
+    }
+#endif
+    return u32Pages;
+}
+
+/** Find the zone with least free pages left after allocation.
+ *
+ *  @param piab [in] The internal buddy object.
+ *  @param u32Pages [in] Number of pages to allocate.
+ *  @param u32NodeId [in] The NUMA node of the zone, U32_MAX for any node.
+ *
+ *  @return The zone index, U32_MAX if no zone is found.
+ */
+static u32 _findBuddyZone(internal_jiukun_buddy_t * piab, u32 u32Pages, u32 u32NodeId)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    u32 u32Pages = 1UL << u32Order;
     u32 u32Index = 0, u32Left = U32_MAX, u32Id = U32_MAX;
     buddy_zone_t * pbz = NULL;
-    jiukun_page_t * page = NULL;
 
-    /*Find a zone to allocate pages.*/
     for (u32Index = 0; u32Index < piab->ijb_u32NumOfZone; u32Index ++)
     {
         pbz = piab->ijb_pbzZone[u32Index];
+        if ((u32NodeId != U32_MAX) && (pbz->bz_u32NodeId != u32NodeId))
+            continue;
+
         if ((pbz->bz_u32FreePages >= u32Pages) && (u32Left > pbz->bz_u32FreePages - u32Pages))
         {
             u32Left = pbz->bz_u32FreePages - u32Pages;
@@ -349,6 +624,24 @@ static jiukun_page_t * _allocPages(
         }
     }
 
+    return u32Id;
+}
+
+static jiukun_page_t * _allocPages(
+    internal_jiukun_buddy_t * piab, u32 u32Order, jf_flag_t flag)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Pages = 1UL << u32Order;
+    u32 u32Id = U32_MAX, u32NodeId = U32_MAX;
+    buddy_zone_t * pbz = NULL;
+    jiukun_page_t * page = NULL;
+
+    /*Prefer the zone on the local node of the calling thread.*/
+    if (piab->ijb_bNumaNode)
+        u32NodeId = _getCurrentNumaNode();
+
+    /*Find a zone to allocate pages.*/
+    u32Id = _findBuddyZone(piab, u32Pages, u32NodeId);
     if (u32Id != U32_MAX)
     {
         /*Allocate page from zone.*/
@@ -357,15 +650,25 @@ static jiukun_page_t * _allocPages(
             return page;
     }
 
-    /*Maximum zone is reached, return NULL if grow is not allowed.*/
+    /*Maximum zone is reached or grow is not allowed.*/
     if ((piab->ijb_u32NumOfZone == MAX_BUDDY_ZONES) || piab->ijb_bNoGrow)
-        return NULL;
+    {
+        if (u32NodeId == U32_MAX)
+            return NULL;
+
+        /*Fall back to the zone on remote node.*/
+        u32Id = _findBuddyZone(piab, u32Pages, U32_MAX);
+        if (u32Id != U32_MAX)
+            page = _rmqueue(piab->ijb_pbzZone[u32Id], u32Order);
+
+        return page;
+    }
 
     /*Create a new zone.*/
     if (u32Ret == JF_ERR_NO_ERROR)
         u32Ret = _createBuddyZone(
-            &(piab->ijb_pbzZone[piab->ijb_u32NumOfZone]), piab->ijb_u32MaxOrder,
-            piab->ijb_u32NumOfZone);
+            piab, &(piab->ijb_pbzZone[piab->ijb_u32NumOfZone]), piab->ijb_u32NumOfZone,
+            (u32NodeId == U32_MAX) ? 0 : u32NodeId);
 
     /*Allocate page from the created zone.*/
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -449,13 +752,18 @@ u32 initJiukunBuddy(buddy_param_t * pbp)
            (pbp->bp_u8MaxOrder > 0));
     assert(! piab->ijb_bInitialized);
 
-    JF_LOGGER_INFO("max order: %u, no grow: %u", pbp->bp_u8MaxOrder, pbp->bp_bNoGrow);
+    JF_LOGGER_INFO(
+        "max order: %u, no grow: %u, huge page: %u, numa node: %u", pbp->bp_u8MaxOrder,
+        pbp->bp_bNoGrow, pbp->bp_bHugePage, pbp->bp_bNumaNode);
 
     piab->ijb_u32MaxOrder = pbp->bp_u8MaxOrder + 1;
     piab->ijb_bNoGrow = pbp->bp_bNoGrow;
+    piab->ijb_bHugePage = pbp->bp_bHugePage;
+    piab->ijb_bNumaNode = pbp->bp_bNumaNode;
 
     /*Create one zone.*/
-    u32Ret = _createBuddyZone(&(piab->ijb_pbzZone[0]), piab->ijb_u32MaxOrder, 0);
+    u32Ret = _createBuddyZone(
+        piab, &(piab->ijb_pbzZone[0]), 0, piab->ijb_bNumaNode ? _getCurrentNumaNode() : 0);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         piab->ijb_u32NumOfZone ++;
@@ -489,7 +797,8 @@ u32 finiJiukunBuddy(void)
 
     jf_mutex_fini(&(piab->ijb_jmLock));
 
-    piab->ijb_bInitialized = FALSE;
+    /*Clear the zone table so the buddy can be initialized again.*/
+    ol_bzero(piab, sizeof(*piab));
 
     return u32Ret;
 }
@@ -526,6 +835,31 @@ void jf_jiukun_freePage(void ** pptr)
     putJiukunPage(&pap);
 }
 
+u32 jf_jiukun_allocLargeMemory(void ** pptr, olsize_t size)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Order = 0;
+
+    if (size <= JF_JIUKUN_MAX_MEMORY_SIZE)
+        return jf_jiukun_allocMemory(pptr, size);
+
+    /*Get the order of pages for the size.*/
+    while (((olsize_t)JF_JIUKUN_PAGE_SIZE << u32Order) < size)
+        u32Order ++;
+
+    u32Ret = jf_jiukun_allocPage(pptr, u32Order, 0);
+
+    return u32Ret;
+}
+
+void jf_jiukun_freeLargeMemory(void ** pptr, olsize_t size)
+{
+    if (size <= JF_JIUKUN_MAX_MEMORY_SIZE)
+        jf_jiukun_freeMemory(pptr);
+    else
+        jf_jiukun_freePage(pptr);
+}
+
 u32 getJiukunPage(jiukun_page_t ** ppPage, u32 u32Order, jf_flag_t flag)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -614,6 +948,102 @@ void putJiukunPage(jiukun_page_t ** ppPage)
     *ppPage = NULL;
 }
 
+u32 extendJiukunPage(jiukun_page_t * pPage, u32 u32Order)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jiukun_buddy_t * piab = &ls_ijbBuddy;
+    buddy_zone_t * zone = NULL;
+    jiukun_page_t * buddy = NULL;
+    u32 u32CurOrder = 0, order = 0;
+    olint_t page_idx = 0;
+
+    assert(piab->ijb_bInitialized);
+    assert((pPage != NULL) && isJpAllocated(pPage));
+
+    zone = piab->ijb_pbzZone[getJpZoneId(pPage)];
+    u32CurOrder = getJpOrder(pPage);
+
+    if ((u32Order <= u32CurOrder) || (u32Order >= zone->bz_u32MaxOrder))
+        return JF_ERR_INVALID_JIUKUN_PAGE_ORDER;
+
+    page_idx = pageToIndex(pPage, zone->bz_papPage);
+
+    /*The page must be the first half of the block with the new order.*/
+    if ((page_idx & ((1 << u32Order) - 1)) != 0)
+        return JF_ERR_FAIL_EXTEND_JIUKUN_PAGE;
+
+    jf_mutex_acquire(&(piab->ijb_jmLock));
+
+    /*All buddies up to the new order must be free with exactly the same order.*/
+    for (order = u32CurOrder; (order < u32Order) && (u32Ret == JF_ERR_NO_ERROR); order ++)
+    {
+        buddy = _findBuddyPage(pPage, page_idx, order);
+        if (! _isBuddyPage(buddy, order))
+            u32Ret = JF_ERR_FAIL_EXTEND_JIUKUN_PAGE;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Remove the buddies from free area.*/
+        for (order = u32CurOrder; order < u32Order; order ++)
+        {
+            buddy = _findBuddyPage(pPage, page_idx, order);
+            jf_listhead_del(&buddy->jp_jlLru);
+            zone->bz_faFreeArea[order].fa_u32Free--;
+            zone->bz_u32FreePages -= 1UL << order;
+            _clearPageOrder(buddy);
+            clearJpReclaimed(buddy);
+        }
+
+        _setPageOrder(pPage, u32Order);
+    }
+
+    jf_mutex_release(&(piab->ijb_jmLock));
+
+    return u32Ret;
+}
+
+u32 reclaimJiukunBuddy(void)
+{
+    internal_jiukun_buddy_t * piab = &ls_ijbBuddy;
+    u32 u32Index = 0, u32Pages = 0;
+
+    assert(piab->ijb_bInitialized);
+
+    /*Dropping the pages breaks the huge pages, leave them to the kernel.*/
+    if (piab->ijb_bHugePage)
+        return u32Pages;
+
+    for (u32Index = 0; u32Index < piab->ijb_u32NumOfZone; u32Index ++)
+    {
+        /*Release the lock between zones so the allocation is not blocked for long.*/
+        jf_mutex_acquire(&(piab->ijb_jmLock));
+        u32Pages += _reclaimBuddyZone(piab->ijb_pbzZone[u32Index]);
+        jf_mutex_release(&(piab->ijb_jmLock));
+    }
+
+    return u32Pages;
+}
+
+void getJiukunBuddyStat(u32 * pu32NumOfPage, u32 * pu32FreePages)
+{
+    internal_jiukun_buddy_t * piab = &ls_ijbBuddy;
+    u32 u32Index = 0;
+
+    assert(piab->ijb_bInitialized);
+
+    *pu32NumOfPage = 0;
+    *pu32FreePages = 0;
+
+    jf_mutex_acquire(&(piab->ijb_jmLock));
+    for (u32Index = 0; u32Index < piab->ijb_u32NumOfZone; u32Index ++)
+    {
+        *pu32NumOfPage += piab->ijb_pbzZone[u32Index]->bz_u32NumOfPage;
+        *pu32FreePages += piab->ijb_pbzZone[u32Index]->bz_u32FreePages;
+    }
+    jf_mutex_release(&(piab->ijb_jmLock));
+}
+
 void * jiukunPageToAddr(jiukun_page_t * pap)
 {
     internal_jiukun_buddy_t * piab = &ls_ijbBuddy;
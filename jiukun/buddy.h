@@ -42,6 +42,8 @@ typedef enum jiukun_page_flag
     JP_FLAG_ALLOCATED = 0,
     /**Page is used by slab.*/
     JP_FLAG_SLAB,
+    /**Page is the first page of a free block which is returned to the kernel.*/
+    JP_FLAG_RECLAIMED,
 } jiukun_page_flag_t;
 
 /** Define the jiukun page data type.
@@ -81,6 +83,18 @@ typedef struct jiukun_page
  */
 #define isJpSlab(page)              (JF_FLAG_GET(page->jp_jfPage, JP_FLAG_SLAB))
 
+/** Set the free block reclaimed.
+ */
+#define setJpReclaimed(page)        (JF_FLAG_SET(page->jp_jfPage, JP_FLAG_RECLAIMED))
+
+/** Clear the free block reclaimed.
+ */
+#define clearJpReclaimed(page)      (JF_FLAG_CLEAR(page->jp_jfPage, JP_FLAG_RECLAIMED))
+
+/** Test if the free block is reclaimed.
+ */
+#define isJpReclaimed(page)         (JF_FLAG_GET(page->jp_jfPage, JP_FLAG_RECLAIMED))
+
 /** Set the order to the page, the order is at bit 48 ~ 55.
  */
 #define setJpOrder(page, order)     (JF_FLAG_SET_VALUE(page->jp_jfPage, 55, 48, order))
@@ -109,7 +123,11 @@ typedef struct
     u8 bp_u8MaxOrder;
     /**Donot grow the memery if it's TRUE.*/
     boolean_t bp_bNoGrow;
-    u8 bp_u8Reserved[6];
+    /**Back the zone with huge page if it's TRUE.*/
+    boolean_t bp_bHugePage;
+    /**Bind the zone to NUMA node if it's TRUE.*/
+    boolean_t bp_bNumaNode;
+    u8 bp_u8Reserved[4];
 } buddy_param_t;
 
 /* --- functional routines ---------------------------------------------------------------------- */
@@ -162,6 +180,43 @@ u32 getJiukunPage(jiukun_page_t ** ppPage, u32 u32Order, jf_flag_t flag);
  */
 void putJiukunPage(jiukun_page_t ** ppPage);
 
+/** Extend the allocated page in place to a higher order.
+ *
+ *  @note
+ *  -# The page must be aligned to the new order, and the buddies from the current order up to the
+ *   new order must be free, the buddies are then merged to the page.
+ *  -# The page is not changed if the extension fails.
+ *
+ *  @param pPage [in/out] The page to be extended.
+ *  @param u32Order [in] The new page order.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_JIUKUN_PAGE_ORDER Invalid page order.
+ *  @retval JF_ERR_FAIL_EXTEND_JIUKUN_PAGE The adjacent pages are not free.
+ */
+u32 extendJiukunPage(jiukun_page_t * pPage, u32 u32Order);
+
+/** Return the free pages of buddy page allocator to the kernel.
+ *
+ *  @note
+ *  -# Only the free blocks with 16 pages or more are returned.
+ *  -# The blocks returned by previous call are skipped.
+ *  -# Nothing is returned if the pool is backed with huge page.
+ *
+ *  @return Number of pages returned in this call.
+ */
+u32 reclaimJiukunBuddy(void);
+
+/** Get the statistic of buddy page allocator.
+ *
+ *  @param pu32NumOfPage [out] Number of pages in all zones.
+ *  @param pu32FreePages [out] Number of free pages in all zones.
+ *
+ *  @return Void.
+ */
+void getJiukunBuddyStat(u32 * pu32NumOfPage, u32 * pu32FreePages);
+
 /** Convert the jiukun page object to memery address.
  *
  *  @param pbp [in] The jiukun page object to be checked.
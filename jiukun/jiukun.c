@@ -18,6 +18,8 @@
 #include "jf_basic.h"
 #include "jf_limit.h"
 #include "jf_jiukun.h"
+#include "jf_thread.h"
+#include "jf_sem.h"
 
 #include "buddy.h"
 #include "slab.h"
@@ -37,15 +39,47 @@ static u32 ls_u32OrderPrimes[] = {
     2147483647, 4294967295UL,
 };
 
+/** Default interval of the reclaimer in millisecond.
+ */
+#define JIUKUN_DEFAULT_RECLAIM_INTERVAL           (1000)
+
+/** Default threshold in byte for reaping the free slabs.
+ */
+#define JIUKUN_DEFAULT_RECLAIM_THRESHOLD          (4 * 1024 * 1024)
+
+/** Default percentage of free memory for notifying the memory pressure.
+ */
+#define JIUKUN_DEFAULT_PRESSURE_PERCENT           (10)
+
 /** Define the internal jiukun data type.
  */
 typedef struct
 {
     /**Jiukun is initialized if it's TRUE.*/
     boolean_t ia_bInitialized;
-    u8 ia_u8Reserved[7];
-
-    u32 ia_u32Reserved[4];
+    /**The reclaimer thread is started if it's TRUE.*/
+    boolean_t ia_bReclaimer;
+    /**The reclaimer thread should quit if it's TRUE.*/
+    volatile boolean_t ia_bStopReclaimer;
+    /**Percentage of free memory for notifying the memory pressure.*/
+    u8 ia_u8PressurePercent;
+    u8 ia_u8Reserved[4];
+
+    /**Interval of the reclaimer in millisecond.*/
+    u32 ia_u32ReclaimInterval;
+    /**Reap the free slabs when the number of pages held by them is more than the threshold.*/
+    u32 ia_u32ReclaimThreshold;
+    u32 ia_u32Reserved[2];
+
+    /**Callback function to notify the memory pressure.*/
+    jf_jiukun_fnNotifyPressure_t ia_fnNotifyPressure;
+    /**Argument of the callback function.*/
+    void * ia_pPressureArg;
+
+    /**The reclaimer thread.*/
+    jf_thread_id_t ia_jtiReclaimer;
+    /**The semaphore to wake up the reclaimer thread when jiukun is finalized.*/
+    jf_sem_t ia_jsReclaimer;
 } internal_jiukun_t;
 
 /** Declare the internal jiukun object.
@@ -58,6 +92,101 @@ static internal_jiukun_t ls_iaJiukun;
 
 /* --- private routine section ------------------------------------------------------------------ */
 
+/** Reclaim the free memory, the free slabs are reaped and the free pages are returned to kernel.
+ */
+static void _reclaimJiukun(internal_jiukun_t * pia)
+{
+    u32 u32Pages = 0, u32NumOfPage = 0, u32FreePages = 0, u32FreePercent = 0;
+
+    /*Reap the free slabs so the pages are given back to buddy.*/
+    u32Pages = getJiukunSlabFreePages();
+    if (u32Pages > pia->ia_u32ReclaimThreshold)
+    {
+        JF_LOGGER_DEBUG("reap %u pages in free slabs", u32Pages);
+        reapJiukunSlab(TRUE);
+    }
+
+    /*Return the free pages to kernel.*/
+    u32Pages = reclaimJiukunBuddy();
+
+    /*Notify the memory pressure.*/
+    getJiukunBuddyStat(&u32NumOfPage, &u32FreePages);
+    if (u32NumOfPage != 0)
+        u32FreePercent = (u32)((u64)u32FreePages * 100 / u32NumOfPage);
+
+    if ((pia->ia_fnNotifyPressure != NULL) && (u32FreePercent < pia->ia_u8PressurePercent))
+    {
+        JF_LOGGER_DEBUG("memory pressure, free: %u%%", u32FreePercent);
+        pia->ia_fnNotifyPressure(u32FreePercent, pia->ia_pPressureArg);
+    }
+}
+
+static JF_THREAD_RETURN_VALUE _jiukunReclaimer(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jiukun_t * pia = (internal_jiukun_t *)pArg;
+
+    JF_LOGGER_INFO("reclaimer starts, interval: %u", pia->ia_u32ReclaimInterval);
+
+    while (! pia->ia_bStopReclaimer)
+    {
+        /*The semaphore is up when jiukun is finalized.*/
+        jf_sem_downWithTimeout(&pia->ia_jsReclaimer, pia->ia_u32ReclaimInterval);
+
+        if (! pia->ia_bStopReclaimer)
+            _reclaimJiukun(pia);
+    }
+
+    JF_LOGGER_INFO("reclaimer quits");
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _startJiukunReclaimer(internal_jiukun_t * pia, jf_jiukun_init_param_t * pjjip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    pia->ia_u32ReclaimInterval = pjjip->jjip_u32ReclaimInterval;
+    if (pia->ia_u32ReclaimInterval == 0)
+        pia->ia_u32ReclaimInterval = JIUKUN_DEFAULT_RECLAIM_INTERVAL;
+
+    pia->ia_u32ReclaimThreshold = sizeToPages(pjjip->jjip_sReclaimThreshold);
+    if (pia->ia_u32ReclaimThreshold == 0)
+        pia->ia_u32ReclaimThreshold = sizeToPages(JIUKUN_DEFAULT_RECLAIM_THRESHOLD);
+
+    pia->ia_u8PressurePercent = pjjip->jjip_u8PressurePercent;
+    if (pia->ia_u8PressurePercent == 0)
+        pia->ia_u8PressurePercent = JIUKUN_DEFAULT_PRESSURE_PERCENT;
+
+    pia->ia_fnNotifyPressure = pjjip->jjip_fnNotifyPressure;
+    pia->ia_pPressureArg = pjjip->jjip_pPressureArg;
+    pia->ia_bStopReclaimer = FALSE;
+
+    u32Ret = jf_sem_init(&pia->ia_jsReclaimer, 0, 1);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_thread_create(&pia->ia_jtiReclaimer, NULL, _jiukunReclaimer, pia);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            pia->ia_bReclaimer = TRUE;
+        else
+            jf_sem_fini(&pia->ia_jsReclaimer);
+    }
+
+    return u32Ret;
+}
+
+static void _stopJiukunReclaimer(internal_jiukun_t * pia)
+{
+    u32 u32RetCode = 0;
+
+    pia->ia_bStopReclaimer = TRUE;
+    jf_sem_up(&pia->ia_jsReclaimer);
+
+    jf_thread_waitForThreadTermination(pia->ia_jtiReclaimer, &u32RetCode);
+    jf_sem_fini(&pia->ia_jsReclaimer);
+
+    pia->ia_bReclaimer = FALSE;
+}
 
 /* --- public routine section ------------------------------------------------------------------- */
 
@@ -78,6 +207,8 @@ u32 jf_jiukun_init(jf_jiukun_init_param_t * pjjip)
     ol_bzero(pia, sizeof(internal_jiukun_t));
     ol_bzero(&bp, sizeof(buddy_param_t));
     bp.bp_bNoGrow = pjjip->jjip_bNoGrow;
+    bp.bp_bHugePage = pjjip->jjip_bHugePage;
+    bp.bp_bNumaNode = pjjip->jjip_bNumaNode;
     u32NumOfPages = sizeToPages(pjjip->jjip_sPool);
 
     while (u32NumOfPages > ls_u32OrderPrimes[bp.bp_u8MaxOrder])
@@ -98,6 +229,9 @@ u32 jf_jiukun_init(jf_jiukun_init_param_t * pjjip)
         u32Ret = initJiukunSlab(&sp);
     }
 
+    if ((u32Ret == JF_ERR_NO_ERROR) && pjjip->jjip_bReclaimer)
+        u32Ret = _startJiukunReclaimer(pia, pjjip);
+
     if (u32Ret == JF_ERR_NO_ERROR)
         pia->ia_bInitialized = TRUE;
     else
@@ -115,6 +249,10 @@ u32 jf_jiukun_fini(void)
     JF_LOGGER_INFO("fini");
 #endif
 
+    /*Stop the reclaimer before the slab and buddy are finalized.*/
+    if (pia->ia_bReclaimer)
+        _stopJiukunReclaimer(pia);
+
     /*Finalize the jiukun slab.*/
     finiJiukunSlab();
 
@@ -14,7 +14,7 @@ SONAME = jf_jiukun
 
 SOURCES = buddy.c slab.c jiukun.c
 
-JIUTAI_SRCS = jf_mem.c jf_mutex.c
+JIUTAI_SRCS = jf_mem.c jf_mutex.c jf_thread.c jf_sem.c
 
 EXTRA_LIBS = -ljf_logger
 
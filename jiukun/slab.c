@@ -49,6 +49,8 @@ typedef struct
 {
     /**List entry, chained into three list: fully used, partial, fully free slabs.*/
     jf_listhead_t s_jlList;
+    /**Pointer to the pages of the slab.*/
+    void * s_pPage;
     /**Pointer to objects.*/
     void * s_pMem;
     /**Number of objs active in slab.*/
@@ -105,6 +107,17 @@ typedef struct slab_cache
     /**Order of pages per slab (2^n).*/
     u32 sc_u32Order;
 
+    /**Alignment of object and colour offset.*/
+    u32 sc_u32Align;
+    /**Number of colours, the objects in slabs start at different offsets so they don't collide in
+       the same CPU cache sets.*/
+    u32 sc_u32Colour;
+    /**Colour of the next slab.*/
+    u32 sc_u32ColourNext;
+    /**Size of the red zone before and after the object, it's padded to the alignment so the object
+       keeps aligned.*/
+    u32 sc_u32RedZone;
+
     /**Page flags.*/
     jf_flag_t sc_jfPage;
 
@@ -169,6 +182,14 @@ typedef struct slab_cache
  */
 #define RED_MAGIC2               (0x170FC2A5UL)
 
+/** Get the red zone word before the object.
+ */
+#define RED_ZONE_HEAD(pc, objp)  ((ulong *)((objp) + (pc)->sc_u32RedZone - SLAB_ALIGN_SIZE))
+
+/** Get the red zone word after the object.
+ */
+#define RED_ZONE_TAIL(pc, objp)  ((ulong *)((objp) + (pc)->sc_u32ObjSize - (pc)->sc_u32RedZone))
+
 #endif
 
 /** Define the general cache data type.
@@ -224,6 +245,11 @@ typedef struct internal_jiukun_slab
  */
 #define SLAB_ALIGN_SIZE          (BYTES_PER_POINTER)
 
+/** CPU cache line size, it's the alignment for cache with hardware cache align flag and the unit
+ *  of colour offset.
+ */
+#define SLAB_HWCACHE_ALIGN_SIZE  (64)
+
 /* Store the cache object pointer to page object.
  */
 #define SET_PAGE_CACHE(pg, x)    ((pg)->jp_jlLru.jl_pjlNext = (jf_listhead_t *)(x))
@@ -306,7 +332,7 @@ static inline u32 _allocObj(
 /** Calulate the number of objects, wastage, and bytes left over for a given slab size.
  */
 static void _slabCacheEstimate(
-    ulong jporder, olsize_t size, jf_flag_t flag, olsize_t * left_over, u32 * num)
+    ulong jporder, olsize_t size, u32 align, jf_flag_t flag, olsize_t * left_over, u32 * num)
 {
     olint_t i = 0;
     olsize_t wastage = BUDDY_PAGE_SIZE << jporder;
@@ -319,7 +345,7 @@ static void _slabCacheEstimate(
         extra = sizeof(slab_bufctl_t);
     }
     i = 0;
-    while (i * size + ALIGN_CEIL(base + i * extra, SLAB_ALIGN_SIZE) <= wastage)
+    while (i * size + ALIGN_CEIL(base + i * extra, align) <= wastage)
         i++;
     if (i > 0)
         i--;
@@ -329,7 +355,7 @@ static void _slabCacheEstimate(
 
     *num = i;
     wastage -= i * size;
-    wastage -= ALIGN_CEIL(base + i * extra, SLAB_ALIGN_SIZE);
+    wastage -= ALIGN_CEIL(base + i * extra, align);
     *left_over = wastage;
 }
 
@@ -380,8 +406,8 @@ static inline void * _allocOneObjFromTail(slab_cache_t * pCache, slab_t * slabp)
     if (JF_FLAG_GET(pCache->sc_jfCache, SC_FLAG_RED_ZONE))
     {
         /*Check old one.*/
-        if ((*((ulong *)(objp)) != RED_MAGIC1) ||
-            (*((ulong *)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) != RED_MAGIC1))
+        if ((*RED_ZONE_HEAD(pCache, objp) != RED_MAGIC1) ||
+            (*RED_ZONE_TAIL(pCache, objp) != RED_MAGIC1))
         {
             /*Magic number is missing, out of bound.*/
             JF_LOGGER_ERR(JF_ERR_JIUKUN_MEMORY_CORRUPTED, "Invalid red zone");
@@ -389,10 +415,10 @@ static inline void * _allocOneObjFromTail(slab_cache_t * pCache, slab_t * slabp)
         }
 
         /*Set alloc red-zone.*/
-        *((ulong *)(objp)) = RED_MAGIC2;
-        *((ulong *)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) = RED_MAGIC2;
+        *RED_ZONE_HEAD(pCache, objp) = RED_MAGIC2;
+        *RED_ZONE_TAIL(pCache, objp) = RED_MAGIC2;
 
-        objp += SLAB_ALIGN_SIZE;
+        objp += pCache->sc_u32RedZone;
     }
 #endif
 
@@ -400,13 +426,15 @@ static inline void * _allocOneObjFromTail(slab_cache_t * pCache, slab_t * slabp)
 }
 
 /** Get the memory for a slab management object.
+ *
+ *  @param colour_off [in] The colour offset of the slab.
  */
 static inline slab_t * _slabMgmt(
-    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, u8 * objp)
+    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, u8 * objp, u32 colour_off)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     slab_t * slabp = NULL;
-    olint_t offset = 0;
+    olint_t offset = colour_off;
 
     if (OFF_SLAB(pCache))
     {
@@ -417,12 +445,13 @@ static inline slab_t * _slabMgmt(
     }
     else
     {
-        /*Slab management object is located at the start of the page.*/
-        slabp = (slab_t *)objp;
-        offset = ALIGN_CEIL(
-            pCache->sc_u32Num * sizeof(slab_bufctl_t) + sizeof(slab_t), SLAB_ALIGN_SIZE);
+        /*Slab management object is located after the colour offset.*/
+        slabp = (slab_t *)(objp + offset);
+        offset += ALIGN_CEIL(
+            pCache->sc_u32Num * sizeof(slab_bufctl_t) + sizeof(slab_t), pCache->sc_u32Align);
     }
     slabp->s_u32InUse = 0;
+    slabp->s_pPage = objp;
     slabp->s_pMem = objp + offset;
 
     return slabp;
@@ -440,8 +469,8 @@ static inline void _initSlabCacheObjs(slab_cache_t * pCache, slab_t * slabp)
         /*If red zone is enabled, set magic number at the head and tail of the object.*/
         if (JF_FLAG_GET(pCache->sc_jfCache, SC_FLAG_RED_ZONE))
         {
-            *((ulong*)(objp)) = RED_MAGIC1;
-            *((ulong*)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) = RED_MAGIC1;
+            *RED_ZONE_HEAD(pCache, objp) = RED_MAGIC1;
+            *RED_ZONE_TAIL(pCache, objp) = RED_MAGIC1;
         }
 #endif
         /*Set the list array.*/
@@ -463,10 +492,16 @@ static u32 _growSlabCache(
     slab_t * slabp = NULL;
     jiukun_page_t * page = NULL;
     void * objp = NULL;
-    u32 i = 0;
+    u32 i = 0, colour_off = 0;
 
     JF_FLAG_SET(pCache->sc_jfCache, SC_FLAG_GROWN);
 
+    /*Get the colour offset of the slab, the cache lock is held by caller.*/
+    colour_off = pCache->sc_u32ColourNext * SLAB_HWCACHE_ALIGN_SIZE;
+    pCache->sc_u32ColourNext ++;
+    if (pCache->sc_u32ColourNext >= pCache->sc_u32Colour)
+        pCache->sc_u32ColourNext = 0;
+
     /*Get free page from jiukun page allocator.*/
     jpflag |= pCache->sc_jfPage;
     u32Ret = jf_jiukun_allocPage(&objp, pCache->sc_u32Order, jpflag);
@@ -476,7 +511,7 @@ static u32 _growSlabCache(
         JF_LOGGER_DEBUG("addr: %p", objp);
 #endif
         /*Get slab management object.*/
-        slabp = _slabMgmt(pijs, pCache, objp);
+        slabp = _slabMgmt(pijs, pCache, objp, colour_off);
         if (slabp == NULL)
         {
             _freePages(pijs, pCache, objp);
@@ -642,19 +677,19 @@ static inline void _freeOneObj(
     /*Check red zone if it's enabled.*/
     if (JF_FLAG_GET(pCache->sc_jfCache, SC_FLAG_RED_ZONE))
     {
-        objp -= SLAB_ALIGN_SIZE;
+        objp -= pCache->sc_u32RedZone;
 
         /*Check old one.*/
-        if ((*((ulong *)(objp)) != RED_MAGIC2) ||
-            (*((ulong *)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) != RED_MAGIC2))
+        if ((*RED_ZONE_HEAD(pCache, objp) != RED_MAGIC2) ||
+            (*RED_ZONE_TAIL(pCache, objp) != RED_MAGIC2))
         {
             jf_logger_logErrMsg(JF_ERR_JIUKUN_FREE_UNALLOCATED, "red zone check");
             abort();
         }
 
         /*Set alloc red-zone.*/
-        *((ulong *)(objp)) = RED_MAGIC1;
-        *((ulong *)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) = RED_MAGIC1;
+        *RED_ZONE_HEAD(pCache, objp) = RED_MAGIC1;
+        *RED_ZONE_TAIL(pCache, objp) = RED_MAGIC1;
     }
 
     if (_extraFreeChecks(pCache, slabp, objp))
@@ -703,11 +738,29 @@ static inline void _freeObj(
     *pptr = NULL;
 }
 
+/** Free an object to the cache when the lock of jiukun slab object is already held by caller.
+ */
+static inline void _freeObjWithSlabLocked(
+    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, void ** pptr)
+{
+    JF_FLAG_SET(pCache->sc_jfCache, SC_FLAG_LOCKED);
+
+    jf_mutex_acquire(&pCache->sc_jmCache);
+    _freeOneObj(pijs, pCache, *pptr);
+    jf_mutex_release(&pCache->sc_jmCache);
+
+    JF_FLAG_CLEAR(pCache->sc_jfCache, SC_FLAG_LOCKED);
+
+    *pptr = NULL;
+}
+
 /** Destroy all the objects in a slab, and release the memory back to page allocator. Before calling
  *  the slab must have been unlinked from the cache. The cache-lock is not held/needed.
+ *
+ *  @param bSlabLocked [in] The lock of jiukun slab object is held by caller if it's TRUE.
  */
 static void _destroySlab(
-    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, slab_t * slabp)
+    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, slab_t * slabp, boolean_t bSlabLocked)
 {
     slab_t * pSlab = slabp;
 
@@ -720,22 +773,28 @@ static void _destroySlab(
         {
             u8 * objp = (u8 *)slabp->s_pMem + pCache->sc_u32ObjSize * i;
 
-            if ((*((ulong *)(objp)) != RED_MAGIC1) ||
-                (*((ulong *)(objp + pCache->sc_u32ObjSize - SLAB_ALIGN_SIZE)) != RED_MAGIC1))
+            if ((*RED_ZONE_HEAD(pCache, objp) != RED_MAGIC1) ||
+                (*RED_ZONE_TAIL(pCache, objp) != RED_MAGIC1))
             {
                 jf_logger_logErrMsg(
-                    JF_ERR_JIUKUN_MEMORY_LEAK, "destroy slab, objp: %p", objp + SLAB_ALIGN_SIZE);
+                    JF_ERR_JIUKUN_MEMORY_LEAK, "destroy slab, objp: %p",
+                    objp + pCache->sc_u32RedZone);
             }
         }
     }
 #endif
 
     /*Free the page.*/
-    _freePages(pijs, pCache, (u8 *)slabp->s_pMem);
+    _freePages(pijs, pCache, slabp->s_pPage);
 
     /*Free the slab management object if the it's off slab.*/
     if (OFF_SLAB(pCache))
-        _freeObj(pijs, pCache->sc_pscSlab, (void **)&pSlab);
+    {
+        if (bSlabLocked)
+            _freeObjWithSlabLocked(pijs, pCache->sc_pscSlab, (void **)&pSlab);
+        else
+            _freeObj(pijs, pCache->sc_pscSlab, (void **)&pSlab);
+    }
 }
 
 static u32 _destroySlabCacheSlabs(
@@ -757,7 +816,7 @@ static u32 _destroySlabCacheSlabs(
 
         jf_listhead_del(pos);
 
-        _destroySlab(pijs, psc, slabp);
+        _destroySlab(pijs, psc, slabp, FALSE);
     }
 
     return u32Ret;
@@ -796,6 +855,61 @@ static slab_cache_t * _findGeneralSlabCache(
     return pgc->gc_pscCache;
 }
 
+/** Extend the object in place by moving its slab to the cache with larger object.
+ *
+ *  @note
+ *  -# Only the slab with one object and off-slab management object can be moved, the slab pages
+ *   are exactly the object, so the object is extended if the buddy pages are extended.
+ *  -# The cache is locked from the small object to the large object, the lock order is always the
+ *   same.
+ */
+static u32 _extendObj(
+    internal_jiukun_slab_t * pijs, slab_cache_t * pCache, slab_cache_t * pNewCache, void * objp)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jiukun_page_t * page = addrToJiukunPage(objp);
+    slab_t * slabp = GET_PAGE_SLAB(page);
+    u32 i = 0;
+
+    if ((pCache->sc_u32Num != 1) || (pNewCache->sc_u32Num != 1) || ! OFF_SLAB(pCache) ||
+        ! OFF_SLAB(pNewCache) || (pCache->sc_pscSlab != pNewCache->sc_pscSlab) ||
+        (pNewCache->sc_u32Order <= pCache->sc_u32Order) || (slabp->s_pPage != objp))
+        return JF_ERR_FAIL_EXTEND_JIUKUN_PAGE;
+
+    _lockSlabCache(pijs, pCache);
+    _lockSlabCache(pijs, pNewCache);
+    jf_mutex_acquire(&pCache->sc_jmCache);
+    jf_mutex_acquire(&pNewCache->sc_jmCache);
+
+    u32Ret = extendJiukunPage(page, pNewCache->sc_u32Order);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The slab is full as it has only one object, move it to the full list of new cache.*/
+        jf_listhead_del(&(slabp->s_jlList));
+        jf_listhead_add(&(pNewCache->sc_jlFull), &(slabp->s_jlList));
+
+        i = 1 << pNewCache->sc_u32Order;
+        do
+        {
+            SET_PAGE_CACHE(page, pNewCache);
+            SET_PAGE_SLAB(page, slabp);
+            setJpSlab(page);
+            page++;
+        } while (--i);
+
+        STATS_DEC_ACTIVE(pCache);
+        STATS_INC_ACTIVE(pNewCache);
+        STATS_SET_HIGH(pNewCache);
+    }
+
+    jf_mutex_release(&pNewCache->sc_jmCache);
+    jf_mutex_release(&pCache->sc_jmCache);
+    _unlockSlabCache(pijs, pNewCache);
+    _unlockSlabCache(pijs, pCache);
+
+    return u32Ret;
+}
+
 static u32 _createSlabCache(
     internal_jiukun_slab_t * pijs, jf_jiukun_cache_t ** ppCache,
     jf_jiukun_cache_create_param_t * pjjccp)
@@ -804,6 +918,7 @@ static u32 _createSlabCache(
     olsize_t left_over = 0, slab_size = 0;
     slab_cache_t * pCache = NULL;
     u32 realobjsize = pjjccp->jjccp_sObj;
+    u32 align = SLAB_ALIGN_SIZE;
 #ifdef DEBUG_JIUKUN
     jf_listhead_t * pjl = NULL;
 #endif
@@ -814,6 +929,10 @@ static u32 _createSlabCache(
         pjjccp->jjccp_pstrName, pjjccp->jjccp_sObj, pjjccp->jjccp_jfCache);
 #endif
 
+    /*Align the object to cache line if it's requested.*/
+    if (JF_FLAG_GET(pjjccp->jjccp_jfCache, JF_JIUKUN_CACHE_CREATE_FLAG_HWCACHE_ALIGN))
+        align = SLAB_HWCACHE_ALIGN_SIZE;
+
 #if DEBUG_JIUKUN
     /*Do not red zone large object, causes severe fragmentation.*/
     if (pjjccp->jjccp_sObj < (BUDDY_PAGE_SIZE >> 3))
@@ -824,7 +943,7 @@ static u32 _createSlabCache(
     /*Check that size is in terms of words. This is needed to avoid unaligned accesses for some
       archs when redzoning is used, and makes sure any on-slab bufctl's are also correctly
       aligned.*/
-    pjjccp->jjccp_sObj = ALIGN_CEIL(pjjccp->jjccp_sObj, SLAB_ALIGN_SIZE);
+    pjjccp->jjccp_sObj = ALIGN_CEIL(pjjccp->jjccp_sObj, align);
 
     /*Get cache's description object.*/
     u32Ret = _allocObj(pijs, &(pijs->ijs_scCacheCache), (void **)&pCache);
@@ -835,8 +954,9 @@ static u32 _createSlabCache(
 #if DEBUG_JIUKUN
         if (JF_FLAG_GET(pjjccp->jjccp_jfCache, SC_FLAG_RED_ZONE))
         {
-            /*Reserve spaces for redzone.*/
-            pjjccp->jjccp_sObj += 2 * SLAB_ALIGN_SIZE;
+            /*Reserve spaces for redzone, the red zone is padded to the alignment.*/
+            pCache->sc_u32RedZone = align;
+            pjjccp->jjccp_sObj += 2 * align;
         }
 #endif
         /*Determine if the slab management is 'on' or 'off' slab.*/
@@ -854,8 +974,8 @@ static u32 _createSlabCache(
             u32 break_flag = 0;
 
             _slabCacheEstimate(
-                pCache->sc_u32Order, pjjccp->jjccp_sObj, pjjccp->jjccp_jfCache, &left_over,
-                &pCache->sc_u32Num);
+                pCache->sc_u32Order, pjjccp->jjccp_sObj, align, pjjccp->jjccp_jfCache,
+                &left_over, &pCache->sc_u32Num);
             if (break_flag)
                 break;
             if (pCache->sc_u32Order >= MAX_JP_ORDER)
@@ -898,7 +1018,7 @@ static u32 _createSlabCache(
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         slab_size = ALIGN_CEIL(
-            pCache->sc_u32Num * sizeof(slab_bufctl_t) + sizeof(slab_t), SLAB_ALIGN_SIZE);
+            pCache->sc_u32Num * sizeof(slab_bufctl_t) + sizeof(slab_t), align);
 
         /*If the slab has been placed off-slab, and we have enough space then move it on-slab.*/
         if (JF_FLAG_GET(pjjccp->jjccp_jfCache, SC_FLAG_OFF_SLAB) && (left_over >= slab_size))
@@ -907,6 +1027,10 @@ static u32 _createSlabCache(
             left_over -= slab_size;
         }
 
+        /*The space left over is used to colour the slabs.*/
+        pCache->sc_u32Align = align;
+        pCache->sc_u32Colour = left_over / SLAB_HWCACHE_ALIGN_SIZE + 1;
+
         pCache->sc_jfCache = pjjccp->jjccp_jfCache;
         pCache->sc_jfPage = 0;
 
@@ -972,7 +1096,9 @@ static u32 _initSlabCache(internal_jiukun_slab_t * pijs)
     JF_FLAG_SET(pkc->sc_jfCache, JF_JIUKUN_CACHE_CREATE_FLAG_NOREAP);
     ol_strcpy(pkc->sc_strName, "cache_cache");
 
-    _slabCacheEstimate(0, pkc->sc_u32ObjSize, 0, &left_over, &(pkc->sc_u32Num));
+    pkc->sc_u32Align = SLAB_ALIGN_SIZE;
+    _slabCacheEstimate(0, pkc->sc_u32ObjSize, pkc->sc_u32Align, 0, &left_over, &(pkc->sc_u32Num));
+    pkc->sc_u32Colour = left_over / SLAB_HWCACHE_ALIGN_SIZE + 1;
 
     /*Create the general cache.*/
     sizes = &(pijs->ijs_gcGeneral[0]);
@@ -1044,7 +1170,7 @@ static olint_t _shrinkSlabCache(
 #endif
         jf_listhead_del(&(slabp->s_jlList));
 
-        _destroySlab(pijs, pCache, slabp);
+        _destroySlab(pijs, pCache, slabp, TRUE);
         ret++;
     }
 
@@ -1073,7 +1199,7 @@ static void * _getMemoryEndAddr(internal_jiukun_slab_t * pijs, void * pMem)
 
     /*Add the space used by red zone.*/
     if (JF_FLAG_GET(pCache->sc_jfCache, SC_FLAG_RED_ZONE))
-        pRet = (u8 *)pRet + SLAB_ALIGN_SIZE;
+        pRet = (u8 *)pRet + pCache->sc_u32RedZone;
 
     return pRet;
 }
@@ -1134,7 +1260,8 @@ u32 finiJiukunSlab(void)
 
     jf_mutex_fini(&(pijs->ijs_smLock));
 
-    pijs->ijs_bInitialized = FALSE;
+    /*Clear the cache chain so the slab can be initialized again.*/
+    ol_bzero(pijs, sizeof(*pijs));
 
     return u32Ret;
 }
@@ -1234,6 +1361,14 @@ olint_t reapJiukunSlab(boolean_t bNoWait)
             continue;
         }
 
+        /*Skip the cache whose slab management cache is locked, the slab management object cannot
+          be freed.*/
+        if (OFF_SLAB(searchp) && JF_FLAG_GET(searchp->sc_pscSlab->sc_jfCache, SC_FLAG_LOCKED))
+        {
+            JF_LOGGER_DEBUG("slab cache of %s is locked", searchp->sc_strName);
+            continue;
+        }
+
         /*Lock the cache.*/
         jf_mutex_acquire(&(searchp->sc_jmCache));
 #if DEBUG_JIUKUN
@@ -1253,6 +1388,41 @@ olint_t reapJiukunSlab(boolean_t bNoWait)
     return ret;
 }
 
+u32 getJiukunSlabFreePages(void)
+{
+    internal_jiukun_slab_t * pijs = &ls_iasSlab;
+    slab_cache_t * searchp = NULL;
+    jf_listhead_t * pjl = NULL, * pos = NULL;
+    u32 u32Pages = 0;
+
+    assert(pijs->ijs_bInitialized);
+
+    jf_mutex_acquire(&(pijs->ijs_smLock));
+
+    jf_listhead_forEach(&(pijs->ijs_scCacheCache.sc_jlNext), pjl)
+    {
+        searchp = jf_listhead_getEntry(pjl, slab_cache_t, sc_jlNext);
+
+        /*Skip the cache which is in use, the lock of the cache may be held by the thread waiting
+          for the lock of jiukun slab object.*/
+        if (JF_FLAG_GET(searchp->sc_jfCache, JF_JIUKUN_CACHE_CREATE_FLAG_NOREAP) ||
+            JF_FLAG_GET(searchp->sc_jfCache, SC_FLAG_GROWN) ||
+            JF_FLAG_GET(searchp->sc_jfCache, SC_FLAG_LOCKED))
+            continue;
+
+        jf_mutex_acquire(&(searchp->sc_jmCache));
+        jf_listhead_forEach(&(searchp->sc_jlFree), pos)
+        {
+            u32Pages += 1 << searchp->sc_u32Order;
+        }
+        jf_mutex_release(&(searchp->sc_jmCache));
+    }
+
+    jf_mutex_release(&(pijs->ijs_smLock));
+
+    return u32Pages;
+}
+
 void jf_jiukun_freeObject(jf_jiukun_cache_t * pCache, void ** pptr)
 {
     internal_jiukun_slab_t * pijs = &ls_iasSlab;
@@ -1334,6 +1504,51 @@ void jf_jiukun_freeMemory(void ** pptr)
     _freeObj(pijs, pCache, pptr);
 }
 
+u32 jf_jiukun_reallocMemory(void ** pptr, olsize_t size)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jiukun_slab_t * pijs = &ls_iasSlab;
+    slab_cache_t * pCache = NULL, * pNewCache = NULL;
+    void * pNew = NULL;
+
+    assert(pijs->ijs_bInitialized);
+    assert(pptr != NULL);
+
+    if (*pptr == NULL)
+        return jf_jiukun_allocMemory(pptr, size);
+
+    pCache = GET_PAGE_CACHE(addrToJiukunPage(*pptr));
+
+    /*The object has enough space, nothing to do.*/
+    if (size <= pCache->sc_u32RealObjSize)
+        return u32Ret;
+
+    pNewCache = _findGeneralSlabCache(pijs, size, 0);
+    if (pNewCache == NULL)
+        return JF_ERR_UNSUPPORTED_MEMORY_SIZE;
+
+    /*Try to grow the object with the adjacent free pages.*/
+    u32Ret = _extendObj(pijs, pCache, pNewCache, *pptr);
+
+    /*Fall back to allocate new memory and copy the data.*/
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        u32Ret = _allocObj(pijs, pNewCache, &pNew);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ol_memcpy(pNew, *pptr, pCache->sc_u32RealObjSize);
+            _freeObj(pijs, pCache, pptr);
+            *pptr = pNew;
+        }
+    }
+
+#if defined(DEBUG_JIUKUN_VERBOSE)
+    JF_LOGGER_DEBUG("memory: %p, size: %u", *pptr, size);
+#endif
+
+    return u32Ret;
+}
+
 u32 jf_jiukun_cloneMemory(void ** pptr, const u8 * pu8Buffer, olsize_t size)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -64,6 +64,15 @@ u32 finiJiukunSlab(void);
  */
 olint_t reapJiukunSlab(boolean_t bNoWait);
 
+/** Get the number of pages held by the free slabs which can be reaped.
+ *
+ *  @note
+ *  -# The caches in use are skipped, the number is an estimate.
+ *
+ *  @return Number of pages.
+ */
+u32 getJiukunSlabFreePages(void);
+
 #endif /*JIUKUN_SLAB_H*/
 
 /*------------------------------------------------------------------------------------------------*/
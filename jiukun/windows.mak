@@ -16,7 +16,8 @@ RESOURCE = jiukun
 
 SOURCES = buddy.c slab.c jiukun.c
 
-JIUTAI_SRCS = $(JIUTAI_DIR)\jf_mem.c $(JIUTAI_DIR)\jf_mutex.c
+JIUTAI_SRCS = $(JIUTAI_DIR)\jf_mem.c $(JIUTAI_DIR)\jf_mutex.c $(JIUTAI_DIR)\jf_thread.c \
+    $(JIUTAI_DIR)\jf_sem.c
 
 EXTRA_DEFS = /DJIUFENG_JIUKUN_DLL
 
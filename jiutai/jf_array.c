@@ -6,7 +6,8 @@
  *  @author Min Zhang
  *
  *  @note
- *  
+ *  -# The elements are stored in a contiguous array which grows by doubling. A small inline buffer
+ *   in the array object is used before the array is grown.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -20,123 +21,124 @@
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
-/** Define the internal array node data type.
+/** Number of element stored in the inline buffer of the array, no memory is allocated for the
+ *  element array before the number of element exceeds it.
  */
-typedef struct internal_jf_array_node_t
-{
-    /**The element of the node.*/
-    jf_array_element_t * ijan_pjaeElement;
-    /**The pointer to the next node.*/
-    struct internal_jf_array_node_t * ijan_pijanNext;
-} internal_jf_array_node_t;
+#define JF_ARRAY_INLINE_CAPACITY          (8)
 
 /** Define the internal array data type.
  */
 typedef struct
 {
-    /**Number of node in the array.*/
+    /**Number of element in the array.*/
     u32 ija_u32ArraySize;
-    /**The first node in the array.*/
-    internal_jf_array_node_t * ija_pijanElements;
+    /**Number of element the element array can hold.*/
+    u32 ija_u32Capacity;
+    /**The element array, it points to the inline buffer or to the allocated memory.*/
+    jf_array_element_t ** ija_ppjaeElements;
+    /**The inline buffer for small array.*/
+    jf_array_element_t * ija_pjaeInline[JF_ARRAY_INLINE_CAPACITY];
 } internal_jf_array_t;
 
 /* --- private routine section ------------------------------------------------------------------ */
 
-/** Get element at specified position.
+static inline olsize_t _getArrayElementsSize(u32 u32Capacity)
+{
+    return (olsize_t)u32Capacity * sizeof(jf_array_element_t *);
+}
+
+/** Allocate memory for the element array.
  */
-static u32 _getElementAt(internal_jf_array_t * pija, u32 u32Index, jf_array_element_t ** ppjae)
+static u32 _allocArrayElements(u32 u32Capacity, jf_array_element_t *** pppjae)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_jf_array_node_t * pijan = NULL;
-    u32 u32Pos = 0;
+    return jf_jiukun_allocLargeMemory((void **)pppjae, _getArrayElementsSize(u32Capacity));
+}
 
-    pijan = pija->ija_pijanElements;
-    while ((u32Pos < u32Index) && (pijan != NULL))
-    {
-        pijan = pijan->ijan_pijanNext;
-        u32Pos ++;
-    }
+/** Free the element array if it's not the inline buffer.
+ */
+static void _freeArrayElements(internal_jf_array_t * pija)
+{
+    if (pija->ija_ppjaeElements == pija->ija_pjaeInline)
+        return;
 
-    if ((u32Pos == u32Index) && (pijan != NULL))
-        *ppjae = pijan->ijan_pjaeElement;
-    else
-        u32Ret = JF_ERR_OUT_OF_RANGE;
+    jf_jiukun_freeLargeMemory(
+        (void **)&pija->ija_ppjaeElements, _getArrayElementsSize(pija->ija_u32Capacity));
 
-    return u32Ret;
+    pija->ija_ppjaeElements = pija->ija_pjaeInline;
+    pija->ija_u32Capacity = JF_ARRAY_INLINE_CAPACITY;
 }
 
-/** Remove element at specified position.
+/** Make sure the element array can hold the specified number of element.
+ *
+ *  @note
+ *  -# The capacity is doubled at least, so the appending is amortised O(1).
  */
-static u32 _removeElementAt(
-    internal_jf_array_t * pija, u32 u32Index, jf_array_fnDestroyElement_t fnDestoryElement)
+static u32 _reserveArrayElements(internal_jf_array_t * pija, u32 u32Capacity)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_jf_array_node_t * pijanPrevious = NULL, * pijan = NULL;
-    u32 u32Pos = 0;
+    jf_array_element_t ** ppjae = NULL;
+    u32 u32NewCapacity = pija->ija_u32Capacity;
 
-    pijan = pija->ija_pijanElements;
-    while ((u32Pos < u32Index) && (pijan != NULL))
-    {
-        pijanPrevious = pijan;
-        pijan = pijan->ijan_pijanNext;
-        u32Pos ++;
-    }
+    if (u32Capacity <= pija->ija_u32Capacity)
+        return u32Ret;
 
-    if ((u32Pos != u32Index) || (pijan == NULL))
+    while (u32NewCapacity < u32Capacity)
     {
-        /*Cannot find the node at the specified index.*/
-        u32Ret = JF_ERR_OUT_OF_RANGE;
+        if (u32NewCapacity > U32_MAX / 2)
+        {
+            u32NewCapacity = u32Capacity;
+            break;
+        }
+        u32NewCapacity *= 2;
     }
-    else
-    {
-        /*Destroy the element by invoking the callback function.*/
-        if (fnDestoryElement != NULL)
-            fnDestoryElement(&(pijan->ijan_pjaeElement));
 
-        /*Adjust the list.*/
-        if (pijanPrevious != NULL)
-            pijanPrevious->ijan_pijanNext = pijan->ijan_pijanNext;
-        else
-            pija->ija_pijanElements = pijan->ijan_pijanNext;
+    u32Ret = _allocArrayElements(u32NewCapacity, &ppjae);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_memcpy(
+            ppjae, pija->ija_ppjaeElements,
+            pija->ija_u32ArraySize * sizeof(jf_array_element_t *));
 
-        pija->ija_u32ArraySize --;
+        _freeArrayElements(pija);
 
-        jf_jiukun_freeMemory((void **)&pijan);
+        pija->ija_ppjaeElements = ppjae;
+        pija->ija_u32Capacity = u32NewCapacity;
     }
 
     return u32Ret;
 }
 
-/** Insert element at specified position.
+/** Remove element at specified position, the following elements are moved forward.
+ */
+static void _removeElementAt(internal_jf_array_t * pija, u32 u32Index)
+{
+    pija->ija_u32ArraySize --;
+
+    if (u32Index < pija->ija_u32ArraySize)
+        ol_memmove(
+            &pija->ija_ppjaeElements[u32Index], &pija->ija_ppjaeElements[u32Index + 1],
+            (pija->ija_u32ArraySize - u32Index) * sizeof(jf_array_element_t *));
+}
+
+/** Insert element at specified position, the element is appended if the position is out of range.
  */
 static u32 _insertElementAt(internal_jf_array_t * pija, u32 u32Index, jf_array_element_t * pjae)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_jf_array_node_t * pijanPrevious = NULL, * pijan = NULL, * pijanNew = NULL;
-    u32 u32Pos = 0;
 
-    pijanPrevious = NULL;
-    pijan = pija->ija_pijanElements;
-    while ((u32Pos < u32Index) && (pijan != NULL))
-    {
-        pijanPrevious = pijan;
-        pijan = pijan->ijan_pijanNext;
-        u32Pos ++;
-    }
+    if (pija->ija_u32ArraySize == pija->ija_u32Capacity)
+        u32Ret = _reserveArrayElements(pija, pija->ija_u32ArraySize + 1);
 
-    u32Ret = jf_jiukun_allocMemory((void **)&pijanNew, sizeof(*pijanNew));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        pijanNew->ijan_pjaeElement = pjae;
-
-        /*Adjust the list.*/
-        if (pijanPrevious == NULL)
-            pija->ija_pijanElements = pijanNew;
+        if (u32Index < pija->ija_u32ArraySize)
+            ol_memmove(
+                &pija->ija_ppjaeElements[u32Index + 1], &pija->ija_ppjaeElements[u32Index],
+                (pija->ija_u32ArraySize - u32Index) * sizeof(jf_array_element_t *));
         else
-            pijanPrevious->ijan_pijanNext = pijanNew;
-
-        pijanNew->ijan_pijanNext = pijan;
+            u32Index = pija->ija_u32ArraySize;
 
+        pija->ija_ppjaeElements[u32Index] = pjae;
         pija->ija_u32ArraySize ++;
     }
 
@@ -155,8 +157,8 @@ u32 jf_array_create(jf_array_t ** ppja)
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         pija->ija_u32ArraySize = 0;
-        pija->ija_pijanElements = NULL;
-
+        pija->ija_u32Capacity = JF_ARRAY_INLINE_CAPACITY;
+        pija->ija_ppjaeElements = pija->ija_pjaeInline;
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -176,8 +178,8 @@ u32 jf_array_destroy(jf_array_t ** ppja)
 
     pija = (internal_jf_array_t *) *ppja;
 
-    /*Destroy all elements in the array.*/
-    u32Ret = jf_array_removeAllElements(pija);
+    /*Free the element array.*/
+    _freeArrayElements(pija);
 
     /*Free the array.*/
     jf_jiukun_freeMemory(ppja);
@@ -194,6 +196,15 @@ u32 jf_array_getSize(jf_array_t * pja)
     return pija->ija_u32ArraySize;
 }
 
+u32 jf_array_reserve(jf_array_t * pja, u32 u32Capacity)
+{
+    internal_jf_array_t * pija = (internal_jf_array_t *) pja;
+
+    assert(pja != NULL);
+
+    return _reserveArrayElements(pija, u32Capacity);
+}
+
 u32 jf_array_getElementAt(jf_array_t * pja, u32 u32Index, jf_array_element_t ** ppjae)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -204,7 +215,7 @@ u32 jf_array_getElementAt(jf_array_t * pja, u32 u32Index, jf_array_element_t **
     if (u32Index >= pija->ija_u32ArraySize)
         u32Ret = JF_ERR_OUT_OF_RANGE;
     else
-        u32Ret = _getElementAt(pija, u32Index, ppjae);
+        *ppjae = pija->ija_ppjaeElements[u32Index];
 
     return u32Ret;
 }
@@ -219,77 +230,67 @@ u32 jf_array_removeElementAt(jf_array_t * pja, u32 u32Index)
     if (u32Index >= pija->ija_u32ArraySize)
         u32Ret = JF_ERR_OUT_OF_RANGE;
     else
-        u32Ret = _removeElementAt(pija, u32Index, NULL);
+        _removeElementAt(pija, u32Index);
 
     return u32Ret;
 }
 
-u32 jf_array_removeElement(jf_array_t * pja, jf_array_element_t * pjae)
+u32 jf_array_swapRemoveElementAt(jf_array_t * pja, u32 u32Index)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_jf_array_t * pija = pja;
-    internal_jf_array_node_t * pijan = NULL, * pijanPrevious = NULL;
-    u32 u32Index = 0, u32Size = 0;
-    boolean_t bFound = FALSE;
 
     assert(pja != NULL);
 
-    /*Find the node.*/
-    u32Size = pija->ija_u32ArraySize;
-    pijan = pija->ija_pijanElements;
-    while ((u32Index < u32Size) && (bFound == FALSE))
-    {
-        if (pijan->ijan_pjaeElement == pjae)
-        {
-            bFound = TRUE;
-        }
-        else
-        {
-            u32Index ++;
-            pijanPrevious = pijan;
-            pijan = pijan->ijan_pijanNext;
-        }
-    }
-
-    if (bFound == FALSE)
+    if (u32Index >= pija->ija_u32ArraySize)
     {
-        /*Not found.*/
-        u32Ret = JF_ERR_NOT_FOUND;
+        u32Ret = JF_ERR_OUT_OF_RANGE;
     }
     else
     {
-        /*Remove the node.*/
-        if (pijanPrevious != NULL)
-            pijanPrevious->ijan_pijanNext = pijan->ijan_pijanNext;
-        else
-            pija->ija_pijanElements = pijan->ijan_pijanNext;
+        /*Move the last element to the position.*/
         pija->ija_u32ArraySize --;
-        /*Free the node.*/
-        jf_jiukun_freeMemory((void **)&pijan);
+        pija->ija_ppjaeElements[u32Index] = pija->ija_ppjaeElements[pija->ija_u32ArraySize];
     }
 
     return u32Ret;
 }
 
-u32 jf_array_removeAllElements(jf_array_t * pja)
+u32 jf_array_removeElement(jf_array_t * pja, jf_array_element_t * pjae)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    u32 u32Index = 0, u32Size = 0;
+    u32 u32Ret = JF_ERR_NOT_FOUND;
     internal_jf_array_t * pija = pja;
+    u32 u32Index = 0;
 
     assert(pja != NULL);
 
-    u32Size = pija->ija_u32ArraySize;
-    while (u32Index < u32Size)
+    /*Find the element.*/
+    for (u32Index = 0; u32Index < pija->ija_u32ArraySize; u32Index ++)
     {
-        _removeElementAt(pija, 0, NULL);
-
-        u32Index ++;
+        if (pija->ija_ppjaeElements[u32Index] == pjae)
+        {
+            _removeElementAt(pija, u32Index);
+            u32Ret = JF_ERR_NO_ERROR;
+            break;
+        }
     }
 
     return u32Ret;
 }
 
+u32 jf_array_removeAllElements(jf_array_t * pja)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jf_array_t * pija = pja;
+
+    assert(pja != NULL);
+
+    /*The element array is kept for later use.*/
+    pija->ija_u32ArraySize = 0;
+
+    return u32Ret;
+}
+
 u32 jf_array_insertElementAt(jf_array_t * pja, u32 u32Index, jf_array_element_t * pjae)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -309,7 +310,14 @@ u32 jf_array_appendElementTo(jf_array_t * pja, jf_array_element_t * pjae)
 
     assert(pja != NULL);
 
-    u32Ret = _insertElementAt(pija, pija->ija_u32ArraySize, pjae);
+    if (pija->ija_u32ArraySize == pija->ija_u32Capacity)
+        u32Ret = _reserveArrayElements(pija, pija->ija_u32ArraySize + 1);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pija->ija_ppjaeElements[pija->ija_u32ArraySize] = pjae;
+        pija->ija_u32ArraySize ++;
+    }
 
     return u32Ret;
 }
@@ -317,19 +325,20 @@ u32 jf_array_appendElementTo(jf_array_t * pja, jf_array_element_t * pjae)
 u32 jf_array_destroyAllElements(jf_array_t * pja, jf_array_fnDestroyElement_t fnDestroyElement)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    u32 u32Index = 0, u32Size = 0;
+    u32 u32Index = 0;
     internal_jf_array_t * pija = pja;
 
     assert(pja != NULL);
 
-    u32Size = pija->ija_u32ArraySize;
-    while (u32Index < u32Size)
+    /*Destroy the elements by invoking the callback function.*/
+    for (u32Index = 0; u32Index < pija->ija_u32ArraySize; u32Index ++)
     {
-        _removeElementAt(pija, 0, fnDestroyElement);
-
-        u32Index ++;
+        if (fnDestroyElement != NULL)
+            fnDestroyElement(&pija->ija_ppjaeElements[u32Index]);
     }
 
+    pija->ija_u32ArraySize = 0;
+
     return u32Ret;
 }
 
@@ -345,7 +354,7 @@ u32 jf_array_destroyArrayAndElements(
     u32Ret = jf_array_destroyAllElements(pija, fnDestroyElement);
 
     /*Free the array.*/
-    jf_jiukun_freeMemory(ppja);
+    jf_array_destroy(ppja);
 
     return u32Ret;
 }
@@ -355,28 +364,21 @@ u32 jf_array_findElement(
     void * pKey)
 {
     u32 u32Ret = JF_ERR_NOT_FOUND;
-    u32 u32Index = 0, u32Size = 0;
+    u32 u32Index = 0;
     internal_jf_array_t * pija = NULL;
-    internal_jf_array_node_t * pijan = NULL;
 
     assert(pja != NULL);
 
     pija = (internal_jf_array_t *) pja;
-    pijan = pija->ija_pijanElements;
-    u32Size = pija->ija_u32ArraySize;
 
-    while (u32Index < u32Size)
+    for (u32Index = 0; u32Index < pija->ija_u32ArraySize; u32Index ++)
     {
-        if (fnFindElement(pijan->ijan_pjaeElement, pKey))
+        if (fnFindElement(pija->ija_ppjaeElements[u32Index], pKey))
         {
-            *ppElement = pijan->ijan_pjaeElement;
+            *ppElement = pija->ija_ppjaeElements[u32Index];
             u32Ret = JF_ERR_NO_ERROR;
             break;
         }
-
-        pijan = pijan->ijan_pijanNext;
-
-        u32Index ++;
     }
 
     return u32Ret;
@@ -386,20 +388,14 @@ u32 jf_array_traverse(
     jf_array_t * pja, jf_array_fnOpOnElement_t fnOpOnElement, void * pData)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    u32 u32Index = 0, u32Size = 0;
+    u32 u32Index = 0;
     internal_jf_array_t * pija = pja;
-    internal_jf_array_node_t * pijan = NULL;
 
     assert(pja != NULL);
 
-    pijan = pija->ija_pijanElements;
-    u32Size = pija->ija_u32ArraySize;
-
-    while ((u32Index < u32Size) && (u32Ret == JF_ERR_NO_ERROR))
+    while ((u32Index < pija->ija_u32ArraySize) && (u32Ret == JF_ERR_NO_ERROR))
     {
-        u32Ret = fnOpOnElement(pijan->ijan_pjaeElement, pData);
-
-        pijan = pijan->ijan_pijanNext;
+        u32Ret = fnOpOnElement(pija->ija_ppjaeElements[u32Index], pData);
 
         u32Index ++;
     }
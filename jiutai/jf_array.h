@@ -10,6 +10,10 @@
  *  -# It is NOT thread safe. The caller should provide synchronization for the array if necessary.
  *  -# Link with jf_jiukun library for memory allocation.
  *  -# The array element is a pointer to any type of data.
+ *  -# The elements are stored contiguously, accessing element at specified position is O(1),
+ *   appending element is amortised O(1). Inserting and removing element at specified position
+ *   move the following elements, use jf_array_swapRemoveElementAt() if the order of elements is
+ *   not important.
  */
 
 #ifndef JIUTAI_ARRAY_H
@@ -95,6 +99,17 @@ u32 jf_array_destroy(jf_array_t ** ppja);
  */
 u32 jf_array_getSize(jf_array_t * pja);
 
+/** Reserve memory so the array can hold the specified number of element without growing.
+ *
+ *  @param pja [in] The pointer to the array.
+ *  @param u32Capacity [in] The number of element.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_JIUKUN_OUT_OF_MEMORY Out of memory.
+ */
+u32 jf_array_reserve(jf_array_t * pja, u32 u32Capacity);
+
 /** Get element of array at specified position.
  *
  *  @param pja [in] The pointer to the array.
@@ -118,6 +133,20 @@ u32 jf_array_getElementAt(jf_array_t * pja, u32 u32Index, jf_array_element_t **
  */
 u32 jf_array_removeElementAt(jf_array_t * pja, u32 u32Index);
 
+/** Remove element from array at specified position by moving the last element to the position.
+ *
+ *  @note
+ *  -# The order of elements is changed, the routine is O(1).
+ *
+ *  @param pja [in] The pointer to the array.
+ *  @param u32Index [in] The position of the element.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OUT_OF_RANGE The index is out of range.
+ */
+u32 jf_array_swapRemoveElementAt(jf_array_t * pja, u32 u32Index);
+
 /** Remove element from array with specified element.
  *
  *  @param pja [in] The pointer to the array.
@@ -0,0 +1,271 @@
+/**
+ *  @file jf_atomic.h
+ *
+ *  @brief Header file which defines the atomic operations.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The routines are inline functions, no object file is needed.
+ *  -# Load has acquire semantic, store has release semantic, read-modify-write operations and
+ *   fence are sequentially consistent.
+ *  -# The variable must be naturally aligned.
+ */
+
+#ifndef JIUTAI_ATOMIC_H
+#define JIUTAI_ATOMIC_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(WINDOWS)
+    #include <intrin.h>
+#elif defined(LINUX)
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <immintrin.h>
+    #endif
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** The size of cache line, it's used to avoid false sharing.
+ */
+#define JF_ATOMIC_CACHE_LINE_SIZE        (64)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+#if defined(LINUX)
+
+static inline u32 jf_atomic_loadU32(u32 * pu32Var)
+{
+    return __atomic_load_n(pu32Var, __ATOMIC_ACQUIRE);
+}
+
+static inline u64 jf_atomic_loadU64(u64 * pu64Var)
+{
+    return __atomic_load_n(pu64Var, __ATOMIC_ACQUIRE);
+}
+
+static inline void * jf_atomic_loadPtr(void ** ppVar)
+{
+    return __atomic_load_n(ppVar, __ATOMIC_ACQUIRE);
+}
+
+static inline void jf_atomic_storeU32(u32 * pu32Var, u32 u32Value)
+{
+    __atomic_store_n(pu32Var, u32Value, __ATOMIC_RELEASE);
+}
+
+static inline void jf_atomic_storeU64(u64 * pu64Var, u64 u64Value)
+{
+    __atomic_store_n(pu64Var, u64Value, __ATOMIC_RELEASE);
+}
+
+static inline void jf_atomic_storePtr(void ** ppVar, void * pValue)
+{
+    __atomic_store_n(ppVar, pValue, __ATOMIC_RELEASE);
+}
+
+/** Add the value to the variable.
+ *
+ *  @return The value before the addition.
+ */
+static inline u32 jf_atomic_fetchAddU32(u32 * pu32Var, u32 u32Value)
+{
+    return __atomic_fetch_add(pu32Var, u32Value, __ATOMIC_SEQ_CST);
+}
+
+/** Add the value to the variable.
+ *
+ *  @return The value before the addition.
+ */
+static inline u64 jf_atomic_fetchAddU64(u64 * pu64Var, u64 u64Value)
+{
+    return __atomic_fetch_add(pu64Var, u64Value, __ATOMIC_SEQ_CST);
+}
+
+/** Set the variable to new value and return the old value.
+ */
+static inline u32 jf_atomic_exchangeU32(u32 * pu32Var, u32 u32Value)
+{
+    return __atomic_exchange_n(pu32Var, u32Value, __ATOMIC_SEQ_CST);
+}
+
+/** Set the pointer to new value and return the old value.
+ */
+static inline void * jf_atomic_exchangePtr(void ** ppVar, void * pValue)
+{
+    return __atomic_exchange_n(ppVar, pValue, __ATOMIC_SEQ_CST);
+}
+
+/** Set the variable to new value if the variable is equal to the expected value.
+ *
+ *  @return The status of the operation.
+ *  @retval TRUE The variable is set to new value.
+ *  @retval FALSE The variable is not equal to the expected value.
+ */
+static inline boolean_t jf_atomic_casU32(u32 * pu32Var, u32 u32Expected, u32 u32Value)
+{
+    return __atomic_compare_exchange_n(
+        pu32Var, &u32Expected, u32Value, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+/** Set the variable to new value if the variable is equal to the expected value.
+ */
+static inline boolean_t jf_atomic_casU64(u64 * pu64Var, u64 u64Expected, u64 u64Value)
+{
+    return __atomic_compare_exchange_n(
+        pu64Var, &u64Expected, u64Value, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+/** Set the variable to new value if the variable is equal to the expected value.
+ */
+static inline boolean_t jf_atomic_casPtr(void ** ppVar, void * pExpected, void * pValue)
+{
+    return __atomic_compare_exchange_n(
+        ppVar, &pExpected, pValue, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+/** Full memory barrier.
+ */
+static inline void jf_atomic_fence(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/** Acquire barrier, loads before the barrier are not reordered with loads and stores after it.
+ */
+static inline void jf_atomic_acquireFence(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+/** Hint to the CPU that the thread is spinning.
+ */
+static inline void jf_atomic_cpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+#elif defined(WINDOWS)
+
+static inline u32 jf_atomic_loadU32(u32 * pu32Var)
+{
+    u32 u32Value = *(volatile u32 *)pu32Var;
+
+    _ReadWriteBarrier();
+
+    return u32Value;
+}
+
+static inline u64 jf_atomic_loadU64(u64 * pu64Var)
+{
+    u64 u64Value = *(volatile u64 *)pu64Var;
+
+    _ReadWriteBarrier();
+
+    return u64Value;
+}
+
+static inline void * jf_atomic_loadPtr(void ** ppVar)
+{
+    void * pValue = *(void * volatile *)ppVar;
+
+    _ReadWriteBarrier();
+
+    return pValue;
+}
+
+static inline void jf_atomic_storeU32(u32 * pu32Var, u32 u32Value)
+{
+    _ReadWriteBarrier();
+    *(volatile u32 *)pu32Var = u32Value;
+}
+
+static inline void jf_atomic_storeU64(u64 * pu64Var, u64 u64Value)
+{
+    _ReadWriteBarrier();
+    *(volatile u64 *)pu64Var = u64Value;
+}
+
+static inline void jf_atomic_storePtr(void ** ppVar, void * pValue)
+{
+    _ReadWriteBarrier();
+    *(void * volatile *)ppVar = pValue;
+}
+
+static inline u32 jf_atomic_fetchAddU32(u32 * pu32Var, u32 u32Value)
+{
+    return (u32)InterlockedExchangeAdd((volatile LONG *)pu32Var, (LONG)u32Value);
+}
+
+static inline u64 jf_atomic_fetchAddU64(u64 * pu64Var, u64 u64Value)
+{
+    return (u64)InterlockedExchangeAdd64((volatile LONGLONG *)pu64Var, (LONGLONG)u64Value);
+}
+
+static inline u32 jf_atomic_exchangeU32(u32 * pu32Var, u32 u32Value)
+{
+    return (u32)InterlockedExchange((volatile LONG *)pu32Var, (LONG)u32Value);
+}
+
+static inline void * jf_atomic_exchangePtr(void ** ppVar, void * pValue)
+{
+    return InterlockedExchangePointer(ppVar, pValue);
+}
+
+static inline boolean_t jf_atomic_casU32(u32 * pu32Var, u32 u32Expected, u32 u32Value)
+{
+    return (InterlockedCompareExchange(
+        (volatile LONG *)pu32Var, (LONG)u32Value, (LONG)u32Expected) == (LONG)u32Expected) ?
+        TRUE : FALSE;
+}
+
+static inline boolean_t jf_atomic_casU64(u64 * pu64Var, u64 u64Expected, u64 u64Value)
+{
+    return (InterlockedCompareExchange64(
+        (volatile LONGLONG *)pu64Var, (LONGLONG)u64Value, (LONGLONG)u64Expected) ==
+        (LONGLONG)u64Expected) ? TRUE : FALSE;
+}
+
+static inline boolean_t jf_atomic_casPtr(void ** ppVar, void * pExpected, void * pValue)
+{
+    return (InterlockedCompareExchangePointer(ppVar, pValue, pExpected) == pExpected) ?
+        TRUE : FALSE;
+}
+
+static inline void jf_atomic_fence(void)
+{
+    MemoryBarrier();
+}
+
+static inline void jf_atomic_acquireFence(void)
+{
+#if defined(_M_ARM64) || defined(_M_ARM)
+    MemoryBarrier();
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+static inline void jf_atomic_cpuRelax(void)
+{
+    YieldProcessor();
+}
+
+#endif
+
+#endif /*JIUTAI_ATOMIC_H*/
+
+/*------------------------------------------------------------------------------------------------*/
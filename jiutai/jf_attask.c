@@ -6,7 +6,16 @@
  *  @author Min Zhang
  *
  *  @note
- *  
+ *  -# The items are saved in a hierarchical timer wheel with millisecond resolution. Level 0 has
+ *   256 buckets, each bucket is for 1 millisecond. Level 1 to 4 have 64 buckets, each bucket is
+ *   64 times of the bucket in lower level. The wheel covers 2^32 milliseconds.
+ *  -# When the bucket index of level 0 is wrapped, the current bucket of level 1 is cascaded, the
+ *   items are moved to lower levels according to the expire time. The higher level is cascaded in
+ *   the same way when the bucket index of the lower level is wrapped.
+ *  -# A bitmap is maintained for non-empty buckets, the empty buckets are skipped when checking the
+ *   items, and the next expire time is found by the first non-empty bucket of each level.
+ *  -# The items are also saved in a table, the handle of item is the index in table and a sequence
+ *   number, a stale handle is detected by the sequence number.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -19,6 +28,7 @@
 #include "jf_attask.h"
 #include "jf_time.h"
 #include "jf_jiukun.h"
+#include "jf_listhead.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -26,6 +36,49 @@
  */
 #define JF_ATTASK_DEF_BLOCK_TIME         (10 * JF_TIME_SECOND_TO_MILLISECOND);
 
+/** Number of bit for the bucket index of level 0.
+ */
+#define ATTASK_WHEEL_LEVEL0_BITS         (8)
+
+/** Number of bucket in level 0.
+ */
+#define ATTASK_WHEEL_LEVEL0_SIZE         (1 << ATTASK_WHEEL_LEVEL0_BITS)
+
+/** Number of bit for the bucket index of level 1 to 4.
+ */
+#define ATTASK_WHEEL_LEVELN_BITS         (6)
+
+/** Number of bucket in level 1 to 4.
+ */
+#define ATTASK_WHEEL_LEVELN_SIZE         (1 << ATTASK_WHEEL_LEVELN_BITS)
+
+/** Number of level in the wheel.
+ */
+#define ATTASK_WHEEL_LEVELS              (5)
+
+/** Number of bucket in the wheel.
+ */
+#define ATTASK_WHEEL_BUCKETS  \
+    (ATTASK_WHEEL_LEVEL0_SIZE + (ATTASK_WHEEL_LEVELS - 1) * ATTASK_WHEEL_LEVELN_SIZE)
+
+/** The maximum period the wheel covers in millisecond.
+ */
+#define ATTASK_WHEEL_MAX_PERIOD  \
+    ((1ULL << (ATTASK_WHEEL_LEVEL0_BITS +                      \
+               (ATTASK_WHEEL_LEVELS - 1) * ATTASK_WHEEL_LEVELN_BITS)) - 1)
+
+/** The bucket of item which is not in the wheel.
+ */
+#define ATTASK_ITEM_NOT_IN_WHEEL         (U16_MAX)
+
+/** The initial size of item table.
+ */
+#define ATTASK_INITIAL_ITEM_TABLE_SIZE   (64)
+
+/** The maximum size of item table.
+ */
+#define ATTASK_MAX_ITEM_TABLE_SIZE       (JF_JIUKUN_MAX_MEMORY_SIZE / sizeof(void *))
+
 /** Define the attask item data type.
  */
 typedef struct attask_item
@@ -38,48 +91,403 @@ typedef struct attask_item
     jf_attask_fnCallbackOfItem_t ai_fnCallback;
     /**The callback function to destroy user's data.*/
     jf_attask_fnDestroyItem_t ai_fnDestroy;
-    /**Previous item in the list.*/
-    struct attask_item * ai_paiPrev;
-    /**Next item in the list.*/
-    struct attask_item * ai_paiNext;
+    /**The list node in the bucket.*/
+    jf_listhead_t ai_jlList;
+    /**Index in the item table.*/
+    u32 ai_u32Index;
+    /**Sequence number of the item, it's part of the handle.*/
+    u32 ai_u32Seq;
+    /**The bucket of the item, ATTASK_ITEM_NOT_IN_WHEEL if the item is not in the wheel.*/
+    u16 ai_u16Bucket;
+    u16 ai_u16Reserved[3];
 } attask_item_t;
 
 /** Define the internal attask data type.
  */
 typedef struct attask
 {
-    /**The head of item list.*/
-    attask_item_t * ia_paiItems;
+    /**The time of the wheel in milli-second, the items expired before it are triggered.*/
+    u64 ia_u64Time;
+    /**The buckets of the wheel, level 0 is the first.*/
+    jf_listhead_t ia_jlBucket[ATTASK_WHEEL_BUCKETS];
+    /**The bitmap of non-empty buckets.*/
+    u64 ia_u64Bitmap[ATTASK_WHEEL_BUCKETS / 64];
+    /**The items expired before the wheel time when they are added.*/
+    jf_listhead_t ia_jlDue;
+
+    /**The item table, the index is part of the handle.*/
+    attask_item_t ** ia_ppaiTable;
+    /**The stack of free index in item table.*/
+    u32 * ia_pu32FreeIndex;
+    /**Size of the item table.*/
+    u32 ia_u32TableSize;
+    /**Number of free index.*/
+    u32 ia_u32NumOfFreeIndex;
+    /**Number of item.*/
+    u32 ia_u32NumOfItem;
+    /**The sequence number for the next item.*/
+    u32 ia_u32Seq;
 } internal_attask_t;
 
 /* --- private routine section ------------------------------------------------------------------ */
 
-/** Free attask item list.
+static u64 _getAttaskCurrentTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC_RAW, &jts);
+
+    return (jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND) +
+        (jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND);
+}
+
+/** Get index of the lowest bit set in the word, the word should not be 0.
+ */
+static inline u32 _getAttaskLowestBit(u64 u64Word)
+{
+#if defined(__GNUC__)
+    return (u32)__builtin_ctzll(u64Word);
+#else
+    u32 u32Index = 0;
+
+    while ((u64Word & 1) == 0)
+    {
+        u64Word >>= 1;
+        u32Index ++;
+    }
+
+    return u32Index;
+#endif
+}
+
+/** Get the first bucket of the level from the start index in circular order, the bucket must be
+ *  non-empty.
  *
- *  @param item [in] The attask item list.
- *  @param bCallback [in] Call the callback function if it's TRUE.
+ *  @return The index of bucket in the level, U32_MAX if all buckets are empty.
+ */
+static u32 _findAttaskWheelBucket(
+    internal_attask_t * pia, u32 u32First, u32 u32NumOfBucket, u32 u32Start)
+{
+    u32 u32Pos = u32Start, u32Left = u32NumOfBucket, u32Step = 0, u32Bit = 0;
+    u64 u64Word = 0;
+
+    while (u32Left > 0)
+    {
+        u32Bit = u32First + u32Pos;
+        u64Word = pia->ia_u64Bitmap[u32Bit / 64] >> (u32Bit % 64);
+        /*Level 1 to 4 don't occupy the whole word.*/
+        if (u32NumOfBucket < 64)
+            u64Word &= (1ULL << (u32NumOfBucket - u32Pos)) - 1;
+
+        if (u64Word != 0)
+            return u32Pos + _getAttaskLowestBit(u64Word);
+
+        u32Step = MIN(64 - (u32Bit % 64), u32NumOfBucket - u32Pos);
+        u32Left -= MIN(u32Step, u32Left);
+        u32Pos = (u32Pos + u32Step) % u32NumOfBucket;
+    }
+
+    return U32_MAX;
+}
+
+static inline u32 _getAttaskLevelFirstBucket(u32 u32Level)
+{
+    if (u32Level == 0)
+        return 0;
+
+    return ATTASK_WHEEL_LEVEL0_SIZE + (u32Level - 1) * ATTASK_WHEEL_LEVELN_SIZE;
+}
+
+static inline u32 _getAttaskLevelShift(u32 u32Level)
+{
+    if (u32Level == 0)
+        return 0;
+
+    return ATTASK_WHEEL_LEVEL0_BITS + (u32Level - 1) * ATTASK_WHEEL_LEVELN_BITS;
+}
+
+static void _addAttaskItemToWheel(internal_attask_t * pia, attask_item_t * pai)
+{
+    u64 u64Expire = pai->ai_u64Expire, u64Delta = 0;
+    u32 u32Level = 0, u32Shift = 0, u32Bucket = 0;
+
+    if (u64Expire < pia->ia_u64Time)
+    {
+        /*The item is triggered in the next check.*/
+        jf_listhead_addTail(&pia->ia_jlDue, &pai->ai_jlList);
+        pai->ai_u16Bucket = ATTASK_ITEM_NOT_IN_WHEEL;
+        return;
+    }
+
+    u64Delta = u64Expire - pia->ia_u64Time;
+    if (u64Delta > ATTASK_WHEEL_MAX_PERIOD)
+    {
+        /*The item is cascaded again when it's in level 0.*/
+        u64Delta = ATTASK_WHEEL_MAX_PERIOD;
+        u64Expire = pia->ia_u64Time + u64Delta;
+    }
+
+    if (u64Delta < ATTASK_WHEEL_LEVEL0_SIZE)
+    {
+        u32Bucket = (u32)(u64Expire & (ATTASK_WHEEL_LEVEL0_SIZE - 1));
+    }
+    else
+    {
+        u32Level = 1;
+        u32Shift = ATTASK_WHEEL_LEVEL0_BITS;
+        while (u64Delta >= (1ULL << (u32Shift + ATTASK_WHEEL_LEVELN_BITS)))
+        {
+            u32Level ++;
+            u32Shift += ATTASK_WHEEL_LEVELN_BITS;
+        }
+
+        u32Bucket = _getAttaskLevelFirstBucket(u32Level) +
+            (u32)((u64Expire >> u32Shift) & (ATTASK_WHEEL_LEVELN_SIZE - 1));
+    }
+
+    jf_listhead_addTail(&pia->ia_jlBucket[u32Bucket], &pai->ai_jlList);
+    pai->ai_u16Bucket = (u16)u32Bucket;
+    pia->ia_u64Bitmap[u32Bucket / 64] |= 1ULL << (u32Bucket % 64);
+}
+
+static void _removeAttaskItemFromWheel(internal_attask_t * pia, attask_item_t * pai)
+{
+    u32 u32Bucket = pai->ai_u16Bucket;
+
+    jf_listhead_del(&pai->ai_jlList);
+    pai->ai_u16Bucket = ATTASK_ITEM_NOT_IN_WHEEL;
+
+    if ((u32Bucket != ATTASK_ITEM_NOT_IN_WHEEL) &&
+        jf_listhead_isEmpty(&pia->ia_jlBucket[u32Bucket]))
+        pia->ia_u64Bitmap[u32Bucket / 64] &= ~(1ULL << (u32Bucket % 64));
+}
+
+/** Move all items in the bucket to the tail of the list.
+ */
+static void _moveAttaskBucketToList(internal_attask_t * pia, u32 u32Bucket, jf_listhead_t * pjl)
+{
+    jf_listhead_t * pos = NULL;
+    attask_item_t * pai = NULL;
+
+    if (jf_listhead_isEmpty(&pia->ia_jlBucket[u32Bucket]))
+        return;
+
+    jf_listhead_forEach(&pia->ia_jlBucket[u32Bucket], pos)
+    {
+        pai = jf_listhead_getEntry(pos, attask_item_t, ai_jlList);
+        pai->ai_u16Bucket = ATTASK_ITEM_NOT_IN_WHEEL;
+    }
+
+    jf_listhead_spliceTail(pjl, &pia->ia_jlBucket[u32Bucket]);
+    jf_listhead_init(&pia->ia_jlBucket[u32Bucket]);
+    pia->ia_u64Bitmap[u32Bucket / 64] &= ~(1ULL << (u32Bucket % 64));
+}
+
+/** Cascade the current bucket of higher levels to lower levels, it's called when the bucket index
+ *  of level 0 is wrapped.
+ */
+static void _cascadeAttaskWheel(internal_attask_t * pia)
+{
+    u32 u32Level = 0, u32Index = 0;
+    jf_listhead_t jlItem;
+    attask_item_t * pai = NULL;
+
+    for (u32Level = 1; u32Level < ATTASK_WHEEL_LEVELS; u32Level ++)
+    {
+        u32Index = (u32)((pia->ia_u64Time >> _getAttaskLevelShift(u32Level)) &
+                         (ATTASK_WHEEL_LEVELN_SIZE - 1));
+
+        jf_listhead_init(&jlItem);
+        _moveAttaskBucketToList(pia, _getAttaskLevelFirstBucket(u32Level) + u32Index, &jlItem);
+
+        while (! jf_listhead_isEmpty(&jlItem))
+        {
+            pai = jf_listhead_getEntry(jlItem.jl_pjlNext, attask_item_t, ai_jlList);
+            jf_listhead_del(&pai->ai_jlList);
+            _addAttaskItemToWheel(pia, pai);
+        }
+
+        /*The higher level is cascaded only if the bucket index of this level is wrapped.*/
+        if (u32Index != 0)
+            break;
+    }
+}
+
+/** Get the minimal expire time of items in the bucket, the bucket must be non-empty.
+ */
+static u64 _getAttaskBucketExpire(internal_attask_t * pia, u32 u32Bucket)
+{
+    u64 u64Expire = U64_MAX;
+    jf_listhead_t * pos = NULL;
+    attask_item_t * pai = NULL;
+
+    jf_listhead_forEach(&pia->ia_jlBucket[u32Bucket], pos)
+    {
+        pai = jf_listhead_getEntry(pos, attask_item_t, ai_jlList);
+        u64Expire = MIN(u64Expire, pai->ai_u64Expire);
+    }
+
+    return u64Expire;
+}
+
+/** Get the expire time of the first item in the wheel.
  *
- *  @return Void.
+ *  @note
+ *  -# For level 0, the first non-empty bucket from the wheel time has the first item.
+ *  -# For other levels, the current bucket may have the items for the current round or the items
+ *   for the next round, so both the current bucket and the first non-empty bucket after it are
+ *   checked.
+ */
+static u64 _getAttaskNextExpire(internal_attask_t * pia)
+{
+    u64 u64Expire = U64_MAX;
+    u32 u32Level = 0, u32First = 0, u32Current = 0, u32Index = 0;
+
+    u32Current = (u32)(pia->ia_u64Time & (ATTASK_WHEEL_LEVEL0_SIZE - 1));
+    u32Index = _findAttaskWheelBucket(pia, 0, ATTASK_WHEEL_LEVEL0_SIZE, u32Current);
+    if (u32Index != U32_MAX)
+        u64Expire = _getAttaskBucketExpire(pia, u32Index);
+
+    for (u32Level = 1; u32Level < ATTASK_WHEEL_LEVELS; u32Level ++)
+    {
+        u32First = _getAttaskLevelFirstBucket(u32Level);
+        u32Current = (u32)((pia->ia_u64Time >> _getAttaskLevelShift(u32Level)) &
+                           (ATTASK_WHEEL_LEVELN_SIZE - 1));
+
+        if (! jf_listhead_isEmpty(&pia->ia_jlBucket[u32First + u32Current]))
+            u64Expire = MIN(u64Expire, _getAttaskBucketExpire(pia, u32First + u32Current));
+
+        u32Index = _findAttaskWheelBucket(
+            pia, u32First, ATTASK_WHEEL_LEVELN_SIZE, (u32Current + 1) % ATTASK_WHEEL_LEVELN_SIZE);
+        if ((u32Index != U32_MAX) && (u32Index != u32Current))
+            u64Expire = MIN(u64Expire, _getAttaskBucketExpire(pia, u32First + u32Index));
+    }
+
+    return u64Expire;
+}
+
+/** Advance the wheel time to the current time, the expired items are moved to the list.
  */
-static void _freeAttaskItemList(attask_item_t * item, boolean_t bCallback)
+static void _advanceAttaskWheel(internal_attask_t * pia, u64 u64Current, jf_listhead_t * pjl)
 {
-    attask_item_t * pai = item, * temp = NULL;
+    u32 u32Index = 0, u32Next = 0;
+    u64 u64Next = 0;
 
-    while (pai != NULL)
+    while (pia->ia_u64Time <= u64Current)
     {
-        temp = pai->ai_paiNext;
+        u32Index = (u32)(pia->ia_u64Time & (ATTASK_WHEEL_LEVEL0_SIZE - 1));
+
+        if (u32Index == 0)
+            _cascadeAttaskWheel(pia);
+
+        _moveAttaskBucketToList(pia, u32Index, pjl);
+
+        /*Skip the empty buckets in level 0 until the index is wrapped.*/
+        u64Next = (pia->ia_u64Time | (ATTASK_WHEEL_LEVEL0_SIZE - 1)) + 1;
+        if (u32Index + 1 < ATTASK_WHEEL_LEVEL0_SIZE)
+        {
+            u32Next = _findAttaskWheelBucket(pia, 0, ATTASK_WHEEL_LEVEL0_SIZE, u32Index + 1);
+            if ((u32Next != U32_MAX) && (u32Next > u32Index))
+                u64Next = pia->ia_u64Time - u32Index + u32Next;
+        }
+
+        pia->ia_u64Time = MIN(u64Next, u64Current + 1);
+    }
+}
+
+static u32 _growAttaskItemTable(internal_attask_t * pia)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Size = pia->ia_u32TableSize * 2, u32Index = 0;
+    attask_item_t ** ppaiTable = NULL;
+    u32 * pu32FreeIndex = NULL;
+
+    if (u32Size == 0)
+        u32Size = ATTASK_INITIAL_ITEM_TABLE_SIZE;
+
+    if (u32Size > ATTASK_MAX_ITEM_TABLE_SIZE)
+        return JF_ERR_JIUKUN_OUT_OF_MEMORY;
 
-        if (bCallback)
-            pai->ai_fnCallback(pai->ai_pData);
+    u32Ret = jf_jiukun_allocMemory((void **)&ppaiTable, u32Size * sizeof(attask_item_t *));
 
-        if (pai->ai_fnDestroy != NULL)
-            pai->ai_fnDestroy(&pai->ai_pData);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_jiukun_allocMemory((void **)&pu32FreeIndex, u32Size * sizeof(u32));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(ppaiTable, u32Size * sizeof(attask_item_t *));
+        if (pia->ia_ppaiTable != NULL)
+        {
+            ol_memcpy(
+                ppaiTable, pia->ia_ppaiTable, pia->ia_u32TableSize * sizeof(attask_item_t *));
+            jf_jiukun_freeMemory((void **)&pia->ia_ppaiTable);
+            jf_jiukun_freeMemory((void **)&pia->ia_pu32FreeIndex);
+        }
 
-        jf_jiukun_freeMemory((void **)&pai);
+        /*The table is full when it grows, all new entries are free. The lower index is used
+          first.*/
+        for (u32Index = u32Size; u32Index > pia->ia_u32TableSize; u32Index --)
+            pu32FreeIndex[u32Size - u32Index] = u32Index - 1;
 
-        pai = temp;
+        pia->ia_ppaiTable = ppaiTable;
+        pia->ia_pu32FreeIndex = pu32FreeIndex;
+        pia->ia_u32NumOfFreeIndex = u32Size - pia->ia_u32TableSize;
+        pia->ia_u32TableSize = u32Size;
     }
+    else
+    {
+        if (ppaiTable != NULL)
+            jf_jiukun_freeMemory((void **)&ppaiTable);
+    }
+
+    return u32Ret;
+}
+
+static inline jf_attask_handle_t _getAttaskItemHandle(attask_item_t * pai)
+{
+    return ((u64)pai->ai_u32Seq << 32) | pai->ai_u32Index;
+}
+
+static attask_item_t * _getAttaskItemByHandle(internal_attask_t * pia, jf_attask_handle_t handle)
+{
+    u32 u32Index = (u32)(handle & U32_MAX);
+    attask_item_t * pai = NULL;
+
+    if (u32Index < pia->ia_u32TableSize)
+        pai = pia->ia_ppaiTable[u32Index];
+
+    if ((pai != NULL) && (pai->ai_u32Seq != (u32)(handle >> 32)))
+        pai = NULL;
+
+    return pai;
+}
+
+/** Remove the item from the item table, the handle of the item becomes invalid.
+ */
+static void _removeAttaskItemFromTable(internal_attask_t * pia, attask_item_t * pai)
+{
+    pia->ia_ppaiTable[pai->ai_u32Index] = NULL;
+    pia->ia_pu32FreeIndex[pia->ia_u32NumOfFreeIndex] = pai->ai_u32Index;
+    pia->ia_u32NumOfFreeIndex ++;
+    pia->ia_u32NumOfItem --;
+}
+
+/** Free attask item.
+ *
+ *  @param pai [in] The attask item which is removed from the wheel and the item table.
+ *  @param bCallback [in] Call the callback function if it's TRUE.
+ *
+ *  @return Void.
+ */
+static void _freeAttaskItem(attask_item_t * pai, boolean_t bCallback)
+{
+    if (bCallback)
+        pai->ai_fnCallback(pai->ai_pData);
+
+    if (pai->ai_fnDestroy != NULL)
+        pai->ai_fnDestroy(&pai->ai_pData);
 
+    jf_jiukun_freeMemory((void **)&pai);
 }
 
 /** Flushes all task from the attask.
@@ -88,19 +496,26 @@ static void _freeAttaskItemList(attask_item_t * item, boolean_t bCallback)
  *  -# Before destroying the attask item structure, the item data is destroyed by callback function
  *   if it's available.
  *
- *  @param piu [in] The internal attask object.
+ *  @param pia [in] The internal attask object.
  *
  *  @return The error code.
  */
-static u32 _flushAttask(internal_attask_t * piu)
+static u32 _flushAttask(internal_attask_t * pia)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    attask_item_t * temp = NULL;
+    u32 u32Index = 0;
+    attask_item_t * pai = NULL;
 
-    temp = piu->ia_paiItems;
-    piu->ia_paiItems = NULL;
+    for (u32Index = 0; u32Index < pia->ia_u32TableSize; u32Index ++)
+    {
+        pai = pia->ia_ppaiTable[u32Index];
+        if (pai == NULL)
+            continue;
 
-    _freeAttaskItemList(temp, FALSE);
+        _removeAttaskItemFromWheel(pia, pai);
+        _removeAttaskItemFromTable(pia, pai);
+        _freeAttaskItem(pai, FALSE);
+    }
 
     return u32Ret;
 }
@@ -110,62 +525,56 @@ static u32 _flushAttask(internal_attask_t * piu)
 u32 jf_attask_check(jf_attask_t * pAttask, u32 * pu32Blocktime)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_time_spec_t jts;
-    attask_item_t * temp = NULL, * evt = NULL, * last = NULL;
-    u64 current = 0;
+    jf_listhead_t jlExpired;
+    attask_item_t * pai = NULL;
+    u64 current = 0, u64Expire = 0;
     internal_attask_t * pia = (internal_attask_t *)pAttask;
 
     assert(pia != NULL);
 
     *pu32Blocktime = JF_ATTASK_DEF_BLOCK_TIME;
 
-    /*Return if the item list is empty.*/
-    if (pia->ia_paiItems == NULL)
-        return u32Ret;
-
     /*Get the current tick count for reference.*/
-    u32Ret = jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC_RAW, &jts);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    current = _getAttaskCurrentTime();
+
+    /*Return if there is no item.*/
+    if (pia->ia_u32NumOfItem == 0)
     {
-        /*Current tick in Millisecond.*/
-        current = (jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND) + 
-            (jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND);
-        temp = pia->ia_paiItems;
-        /*Keep looping until we find a node that doesn't need to be triggered.*/
-        while ((temp != NULL) && (temp->ai_u64Expire <= current))
-        {
-            /*Since these are in sorted order, evt will always point to the first node that needs to
-              be triggered. last will point to the last node that needs to be triggered. temp will
-              point to the first node that doesn't need to be triggered.*/
-            evt = pia->ia_paiItems;
-            last = temp;
-            temp = temp->ai_paiNext;
-        }
+        pia->ia_u64Time = current;
+        return u32Ret;
+    }
 
-        if (evt != NULL)
-        {
-            if (temp != NULL)
-            {
-                /*There are still nodes that will need to be triggered later, so reset it.
-                  temp point to the node that need to be triggered.*/
-                pia->ia_paiItems = temp;
-                pia->ia_paiItems->ai_paiPrev = NULL;
-                last->ai_paiNext = NULL;
-            }
-            else
-            {
-                /*There are no more nodes that will need to be triggered later.*/
-                pia->ia_paiItems = NULL;
-            }
-        }
+    /*Move the expired items to a temporary list, so the items added by callback functions are not
+      triggered in this round.*/
+    jf_listhead_init(&jlExpired);
+    jf_listhead_spliceTail(&jlExpired, &pia->ia_jlDue);
+    jf_listhead_init(&pia->ia_jlDue);
+    _advanceAttaskWheel(pia, current, &jlExpired);
 
-        /*Iterate through all the triggers that we need to fire*/
-        _freeAttaskItemList(evt, TRUE);
+    /*Iterate through all the triggers that we need to fire. The items can be removed by callback
+      functions, so get the first item each time.*/
+    while (! jf_listhead_isEmpty(&jlExpired))
+    {
+        pai = jf_listhead_getEntry(jlExpired.jl_pjlNext, attask_item_t, ai_jlList);
+        jf_listhead_del(&pai->ai_jlList);
+        _removeAttaskItemFromTable(pia, pai);
+        _freeAttaskItem(pai, TRUE);
+    }
 
-        /*If there are more triggers that need to be fired later, we need to recalculate what the
-          max block time for our select should be.*/
-        if (pia->ia_paiItems != NULL)
-            *pu32Blocktime = (u32)(pia->ia_paiItems->ai_u64Expire - current);
+    /*If there are more triggers that need to be fired later, we need to recalculate what the max
+      block time for our select should be.*/
+    if (! jf_listhead_isEmpty(&pia->ia_jlDue))
+    {
+        *pu32Blocktime = 0;
+    }
+    else if (pia->ia_u32NumOfItem > 0)
+    {
+        u64Expire = _getAttaskNextExpire(pia);
+        current = _getAttaskCurrentTime();
+        if (u64Expire <= current)
+            *pu32Blocktime = 0;
+        else
+            *pu32Blocktime = (u32)MIN(u64Expire - current, U32_MAX);
     }
 
     return u32Ret;
@@ -176,74 +585,56 @@ u32 jf_attask_addItem(
     jf_attask_fnCallbackOfItem_t fnCallback, jf_attask_fnDestroyItem_t fnDestroy)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_time_spec_t jts;
-    attask_item_t * pai = NULL, * temp = NULL;
+
+    u32Ret = jf_attask_addItemWithHandle(
+        pAttask, pData, u32Milliseconds, fnCallback, fnDestroy, NULL);
+
+    return u32Ret;
+}
+
+u32 jf_attask_addItemWithHandle(
+    jf_attask_t * pAttask, void * pData, u32 u32Milliseconds,
+    jf_attask_fnCallbackOfItem_t fnCallback, jf_attask_fnDestroyItem_t fnDestroy,
+    jf_attask_handle_t * pHandle)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    attask_item_t * pai = NULL;
     internal_attask_t * pia = (internal_attask_t *) pAttask;
 
-    u32Ret = jf_jiukun_allocMemory((void **)&pai, sizeof(attask_item_t));
+    assert((pia != NULL) && (fnCallback != NULL));
+
+    if (pia->ia_u32NumOfFreeIndex == 0)
+        u32Ret = _growAttaskItemTable(pia);
+
     if (u32Ret == JF_ERR_NO_ERROR)
-    {
-        /*Get the current time for reference.*/
-        u32Ret = jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC_RAW, &jts);
-    }
+        u32Ret = jf_jiukun_allocMemory((void **)&pai, sizeof(attask_item_t));
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(pai, sizeof(attask_item_t));
         /*Set the trigger time.*/
-        pai->ai_u64Expire = (jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND) +
-            (jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND) + u32Milliseconds;
+        pai->ai_u64Expire = _getAttaskCurrentTime() + u32Milliseconds;
         pai->ai_pData = pData;
 
         /*Set the callback handlers.*/
         pai->ai_fnCallback = fnCallback;
         pai->ai_fnDestroy = fnDestroy;
 
-        if (pia->ia_paiItems == NULL)
-        {
-            /*There are no current triggers, so this is the first, which also means, the select
-              timeout may not be short enough.*/
-            pia->ia_paiItems = pai;
-        }
-        else
-        {
-            /*There are already triggers, so we just insert this one in sorted order.*/
-            temp = pia->ia_paiItems;
-            while (temp != NULL)
-            {
-                if (pai->ai_u64Expire <= temp->ai_u64Expire)
-                {
-                    pai->ai_paiNext = temp;
-                    if (temp->ai_paiPrev == NULL)
-                    {
-                        /*This is the shortest trigger, so again, the select timeout may not be
-                          short enough, so we need to force unblock, to recalculate the timeout for
-                          the select.*/
-                        pia->ia_paiItems = pai;
-                        temp->ai_paiPrev = pai;
-                    }
-                    else
-                    {
-                        /*This isn't the shortest trigger, so we are gauranteed that the thread will 
-                          unblock in time to reset the timeouts.*/
-                        pai->ai_paiPrev = temp->ai_paiPrev;
-                        temp->ai_paiPrev->ai_paiNext = pai;
-                        temp->ai_paiPrev = pai;
-                    }
-                    break;
-                }
-                else if (temp->ai_paiNext == NULL)
-                {
-                    /*If there aren't any more triggers left, this means we have the largest
-                      trigger, so just tack it on the end.*/
-                    pai->ai_paiNext = NULL;
-                    pai->ai_paiPrev = temp;
-                    temp->ai_paiNext = pai;
-                    break;
-                }
-                temp = temp->ai_paiNext;
-            }
-        }
+        /*Sequence number 0 is not used so handle 0 is always invalid.*/
+        pia->ia_u32Seq ++;
+        if (pia->ia_u32Seq == 0)
+            pia->ia_u32Seq ++;
+        pai->ai_u32Seq = pia->ia_u32Seq;
+
+        pia->ia_u32NumOfFreeIndex --;
+        pai->ai_u32Index = pia->ia_pu32FreeIndex[pia->ia_u32NumOfFreeIndex];
+        pia->ia_ppaiTable[pai->ai_u32Index] = pai;
+        pia->ia_u32NumOfItem ++;
+
+        _addAttaskItemToWheel(pia, pai);
+
+        if (pHandle != NULL)
+            *pHandle = _getAttaskItemHandle(pai);
     }
 
     return u32Ret;
@@ -251,59 +642,40 @@ u32 jf_attask_addItem(
 
 u32 jf_attask_removeItem(jf_attask_t * pAttask, void * pData)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Ret = JF_ERR_ATTASK_ITEM_NOT_FOUND;
     internal_attask_t * pia = (internal_attask_t *) pAttask;
-    attask_item_t * first = NULL, * last = NULL, * evt = NULL;
-
-    evt = last = NULL;
+    u32 u32Index = 0;
+    attask_item_t * pai = NULL;
 
-    first = pia->ia_paiItems;
-    while (first != NULL)
+    for (u32Index = 0; u32Index < pia->ia_u32TableSize; u32Index ++)
     {
-        if (first->ai_pData == pData)
-        {
-            /*Found a match, now remove it from the list.*/
-            if (first->ai_paiPrev == NULL)
-            {
-                pia->ia_paiItems = first->ai_paiNext;
-                if (pia->ia_paiItems != NULL)
-                {
-                    pia->ia_paiItems->ai_paiPrev = NULL;
-                }
-            }
-            else
-            {
-                first->ai_paiPrev->ai_paiNext = first->ai_paiNext;
-                if (first->ai_paiNext != NULL)
-                {
-                    first->ai_paiNext->ai_paiPrev = first->ai_paiPrev;
-                }
-            }
-
-            /*Add the removed item to temporary item list.*/
-            if (evt == NULL)
-            {
-                /*If this is the first match, create a new list.*/
-                evt = last = first;
-                evt->ai_paiPrev = evt->ai_paiNext = NULL;
-            }
-            else
-            {
-                /*Attach this match to the end of the list of matches.*/
-                last->ai_paiNext = first;
-                first->ai_paiPrev = last;
-                first->ai_paiNext = NULL;
-                last = first;
-            }
-        }
-        first = first->ai_paiNext;
+        pai = pia->ia_ppaiTable[u32Index];
+        if ((pai == NULL) || (pai->ai_pData != pData))
+            continue;
+
+        _removeAttaskItemFromWheel(pia, pai);
+        _removeAttaskItemFromTable(pia, pai);
+        _freeAttaskItem(pai, FALSE);
+
+        u32Ret = JF_ERR_NO_ERROR;
     }
 
-    /*Iterate through each node that is to be removed.*/
-    if (evt == NULL)
-        u32Ret = JF_ERR_ATTASK_ITEM_NOT_FOUND;
-    else
-        _freeAttaskItemList(evt, FALSE);
+    return u32Ret;
+}
+
+u32 jf_attask_removeItemByHandle(jf_attask_t * pAttask, jf_attask_handle_t handle)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_attask_t * pia = (internal_attask_t *) pAttask;
+    attask_item_t * pai = NULL;
+
+    pai = _getAttaskItemByHandle(pia, handle);
+    if (pai == NULL)
+        return JF_ERR_ATTASK_ITEM_NOT_FOUND;
+
+    _removeAttaskItemFromWheel(pia, pai);
+    _removeAttaskItemFromTable(pia, pai);
+    _freeAttaskItem(pai, FALSE);
 
     return u32Ret;
 }
@@ -319,6 +691,12 @@ u32 jf_attask_destroy(jf_attask_t ** ppAttask)
 
     _flushAttask(pia);
 
+    if (pia->ia_ppaiTable != NULL)
+        jf_jiukun_freeMemory((void **)&pia->ia_ppaiTable);
+
+    if (pia->ia_pu32FreeIndex != NULL)
+        jf_jiukun_freeMemory((void **)&pia->ia_pu32FreeIndex);
+
     jf_jiukun_freeMemory(ppAttask);
 
     return u32Ret;
@@ -327,12 +705,19 @@ u32 jf_attask_destroy(jf_attask_t ** ppAttask)
 u32 jf_attask_create(jf_attask_t ** ppAttask)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_attask_t * pia;
+    internal_attask_t * pia = NULL;
+    u32 u32Index = 0;
 
     u32Ret = jf_jiukun_allocMemory((void **)&pia, sizeof(internal_attask_t));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(pia, sizeof(internal_attask_t));
+
+        for (u32Index = 0; u32Index < ATTASK_WHEEL_BUCKETS; u32Index ++)
+            jf_listhead_init(&pia->ia_jlBucket[u32Index]);
+        jf_listhead_init(&pia->ia_jlDue);
+
+        pia->ia_u64Time = _getAttaskCurrentTime();
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -344,4 +729,3 @@ u32 jf_attask_create(jf_attask_t ** ppAttask)
 }
 
 /*------------------------------------------------------------------------------------------------*/
-
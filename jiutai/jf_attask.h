@@ -8,6 +8,8 @@
  *  @note
  *  -# Routines declared in this file are included in jf_attask object.
  *  -# The attask object is NOT thread safe.
+ *  -# The items are saved in a hierarchical timer wheel, adding and removing item by handle are
+ *   O(1). The resolution is millisecond.
  *  -# Link with jf_time common object for time function.
  *  -# Link with jiukun library for memory allocation.
  */
@@ -38,6 +40,10 @@ typedef u32 (* jf_attask_fnCallbackOfItem_t)(void * pData);
  */
 typedef u32 (* jf_attask_fnDestroyItem_t)(void ** ppData);
 
+/** Define the handle data type of attask item, 0 is an invalid handle.
+ */
+typedef u64  jf_attask_handle_t;
+
 /* --- functional routines ---------------------------------------------------------------------- */
 
 /** Creates an attask object.
@@ -74,6 +80,28 @@ u32 jf_attask_addItem(
     jf_attask_t * pAttask, void * pData, u32 u32Milliseconds,
     jf_attask_fnCallbackOfItem_t fnCallback, jf_attask_fnDestroyItem_t fnDestroy);
 
+/** Add a timed callback task to attask object and return the handle of the task.
+ *
+ *  @note
+ *  -# The handle can be used to remove the task in O(1) time. The handle becomes invalid after the
+ *   task is triggered or removed.
+ *
+ *  @param pAttask [in] the pointer to attask object
+ *  @param pData [in] the data object to associate with the task
+ *  @param u32Milliseconds [in] the number of milliseconds for the task
+ *  @param fnCallback [in] the callback function when the task is triggerred
+ *  @param fnDestroy [in] the callback function to destroy the task
+ *  @param pHandle [out] the handle of the task, it can be NULL
+ *
+ *  @return the error code
+ *  @retval JF_ERR_NO_ERROR success
+ *  @retval JF_ERR_JIUKUN_OUT_OF_MEMORY out of memory
+ */
+u32 jf_attask_addItemWithHandle(
+    jf_attask_t * pAttask, void * pData, u32 u32Milliseconds,
+    jf_attask_fnCallbackOfItem_t fnCallback, jf_attask_fnDestroyItem_t fnDestroy,
+    jf_attask_handle_t * pHandle);
+
 /** Removes tasks specified by the parameter from an attask object.
  *
  *  @note If there are multiple items pertaining to task, all of them are removed.
@@ -84,9 +112,25 @@ u32 jf_attask_addItem(
  *
  *  @return the error code
  *  @retval JF_ERR_NO_ERROR success
+ *  @retval JF_ERR_ATTASK_ITEM_NOT_FOUND the task is not found
  */
 u32 jf_attask_removeItem(jf_attask_t * pAttask, void * pData);
 
+/** Removes the task specified by the handle from an attask object.
+ *
+ *  @note
+ *  -# Before destroying the task, fnDestroy() is called.
+ *  -# The task can be removed in the callback function of other task.
+ *
+ *  @param pAttask [in] the attask object to remove the task from
+ *  @param handle [in] the handle of the task
+ *
+ *  @return the error code
+ *  @retval JF_ERR_NO_ERROR success
+ *  @retval JF_ERR_ATTASK_ITEM_NOT_FOUND the task is not found, it may be triggered or removed
+ */
+u32 jf_attask_removeItemByHandle(jf_attask_t * pAttask, jf_attask_handle_t handle);
+
 /** Checks the attask item and get the block time.
  *
  *  @param pAttask [in] the pointer to attask object
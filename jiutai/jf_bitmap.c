@@ -0,0 +1,682 @@
+/**
+ *  @file jf_bitmap.c
+ *
+ *  @brief Implementation file for bitmap object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The AVX2 and POPCNT instructions are selected at run time with the CPU feature detection of
+ *   GCC, the object is compiled without any instruction set option.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+#include <stdlib.h>
+
+/* --- internal header files -------------------------------------------------------------------- */
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_bitmap.h"
+#include "jf_jiukun.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define BITMAP_X86_DISPATCH
+#endif
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Get number of words required to contain number of bits.
+ */
+#define BITMAP_BITS_TO_WORDS(bits)      \
+    (((bits) + JF_BITMAP_BITS_PER_WORD - 1) / JF_BITMAP_BITS_PER_WORD)
+
+/** Get array index for the word containing the bit.
+ */
+#define BITMAP_WORD_INDEX(pos)          ((pos) / JF_BITMAP_BITS_PER_WORD)
+
+/** Get position of the bit within the word.
+ */
+#define BITMAP_BIT_IN_WORD(pos)         ((pos) % JF_BITMAP_BITS_PER_WORD)
+
+/** Get the mask of the bit within the word.
+ */
+#define BITMAP_BIT_MASK(pos)            ((u64)1 << BITMAP_BIT_IN_WORD(pos))
+
+/** Minimum number of words for the AVX2 routines, the scalar routine is used for small bitmap.
+ */
+#define BITMAP_AVX2_MIN_WORDS           (8)
+
+/** The CPU features have been detected.
+ */
+#define BITMAP_CPU_FEATURE_DETECTED     (0x1)
+
+/** The CPU supports POPCNT instruction.
+ */
+#define BITMAP_CPU_FEATURE_POPCNT       (0x2)
+
+/** The CPU supports AVX2 instructions.
+ */
+#define BITMAP_CPU_FEATURE_AVX2         (0x4)
+
+/** Define the bulk operation data type.
+ */
+typedef enum
+{
+    BITMAP_OP_AND = 0,
+    BITMAP_OP_OR,
+    BITMAP_OP_XOR,
+    BITMAP_OP_ANDNOT,
+} bitmap_op_t;
+
+/** Define the internal bitmap data type.
+ */
+typedef struct
+{
+    /**Number of bits in the bitmap.*/
+    u32 ib_u32NumOfBit;
+    /**Number of words in the word array.*/
+    u32 ib_u32NumOfWord;
+    /**The word array.*/
+    u64 * ib_pu64Word;
+} internal_bitmap_t;
+
+/** The CPU features, it's detected when it's used for the first time.
+ */
+static u8 ls_u8BitmapCpuFeature = 0;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+/** Get the CPU features used by the bitmap routines.
+ *
+ *  @note
+ *  -# Several threads may detect the features at the same time, they get the same result.
+ */
+static u8 _getBitmapCpuFeature(void)
+{
+    u8 u8Feature = ls_u8BitmapCpuFeature;
+
+    if (u8Feature == 0)
+    {
+        u8Feature = BITMAP_CPU_FEATURE_DETECTED;
+#if defined(BITMAP_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("popcnt"))
+            u8Feature |= BITMAP_CPU_FEATURE_POPCNT;
+        if (__builtin_cpu_supports("avx2"))
+            u8Feature |= BITMAP_CPU_FEATURE_AVX2;
+#endif
+        ls_u8BitmapCpuFeature = u8Feature;
+    }
+
+    return u8Feature;
+}
+
+/** Get number of bits set in the word.
+ */
+static inline u32 _countWordSetBit(u64 u64Word)
+{
+#if defined(__GNUC__)
+    return (u32)__builtin_popcountll(u64Word);
+#else
+    u64Word = u64Word - ((u64Word >> 1) & 0x5555555555555555ULL);
+    u64Word = (u64Word & 0x3333333333333333ULL) + ((u64Word >> 2) & 0x3333333333333333ULL);
+    u64Word = (u64Word + (u64Word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return (u32)((u64Word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/** Get position of the lowest bit set in the word, the word must not be 0.
+ */
+static inline u32 _findWordFirstSetBit(u64 u64Word)
+{
+#if defined(__GNUC__)
+    return (u32)__builtin_ctzll(u64Word);
+#else
+    u32 u32Pos = 0;
+
+    while ((u64Word & 0xFF) == 0)
+    {
+        u64Word >>= 8;
+        u32Pos += 8;
+    }
+
+    while ((u64Word & 0x1) == 0)
+    {
+        u64Word >>= 1;
+        u32Pos ++;
+    }
+
+    return u32Pos;
+#endif
+}
+
+/** Get number of bits set in the word array.
+ */
+static u32 _countWordsSetBit(const u64 * pu64Word, u32 u32NumOfWord)
+{
+    u32 u32Count = 0;
+    u32 u32Index;
+
+    for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+        u32Count += _countWordSetBit(pu64Word[u32Index]);
+
+    return u32Count;
+}
+
+/** Do the bulk operation one word at a time.
+ */
+static void _opWords(
+    u64 * pu64Dest, const u64 * pu64Src1, const u64 * pu64Src2, u32 u32NumOfWord, bitmap_op_t op)
+{
+    u32 u32Index;
+
+    switch (op)
+    {
+    case BITMAP_OP_AND:
+        for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+            pu64Dest[u32Index] = pu64Src1[u32Index] & pu64Src2[u32Index];
+        break;
+    case BITMAP_OP_OR:
+        for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+            pu64Dest[u32Index] = pu64Src1[u32Index] | pu64Src2[u32Index];
+        break;
+    case BITMAP_OP_XOR:
+        for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+            pu64Dest[u32Index] = pu64Src1[u32Index] ^ pu64Src2[u32Index];
+        break;
+    case BITMAP_OP_ANDNOT:
+        for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+            pu64Dest[u32Index] = pu64Src1[u32Index] & ~pu64Src2[u32Index];
+        break;
+    }
+}
+
+#if defined(BITMAP_X86_DISPATCH)
+
+/** Get number of bits set in the word array with POPCNT instruction.
+ */
+__attribute__((target("popcnt")))
+static u32 _countWordsSetBitPopcnt(const u64 * pu64Word, u32 u32NumOfWord)
+{
+    u32 u32Count = 0;
+    u32 u32Index;
+
+    for (u32Index = 0; u32Index < u32NumOfWord; u32Index ++)
+        u32Count += (u32)__builtin_popcountll(pu64Word[u32Index]);
+
+    return u32Count;
+}
+
+/** Get number of bits set in the word array with AVX2 instructions.
+ *
+ *  @note
+ *  -# The number of bits in each nibble is looked up with shuffle, the byte counts are summed up
+ *   with SAD to four 64-bit counters.
+ */
+__attribute__((target("avx2,popcnt")))
+static u32 _countWordsSetBitAvx2(const u64 * pu64Word, u32 u32NumOfWord)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    __m256i data, lo, hi, cnt;
+    u64 u64Lane[4];
+    u32 u32Count = 0;
+    u32 u32Index = 0;
+
+    for (; u32Index + 4 <= u32NumOfWord; u32Index += 4)
+    {
+        data = _mm256_loadu_si256((const __m256i *)&pu64Word[u32Index]);
+        lo = _mm256_and_si256(data, lowMask);
+        hi = _mm256_and_si256(_mm256_srli_epi16(data, 4), lowMask);
+        cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+
+    _mm256_storeu_si256((__m256i *)u64Lane, acc);
+    u32Count = (u32)(u64Lane[0] + u64Lane[1] + u64Lane[2] + u64Lane[3]);
+
+    for (; u32Index < u32NumOfWord; u32Index ++)
+        u32Count += (u32)__builtin_popcountll(pu64Word[u32Index]);
+
+    return u32Count;
+}
+
+/** Do the bulk operation with AVX2 instructions, 4 words at a time.
+ */
+__attribute__((target("avx2")))
+static void _opWordsAvx2(
+    u64 * pu64Dest, const u64 * pu64Src1, const u64 * pu64Src2, u32 u32NumOfWord, bitmap_op_t op)
+{
+    __m256i a, b, r;
+    u32 u32Index = 0;
+
+    for (; u32Index + 4 <= u32NumOfWord; u32Index += 4)
+    {
+        a = _mm256_loadu_si256((const __m256i *)&pu64Src1[u32Index]);
+        b = _mm256_loadu_si256((const __m256i *)&pu64Src2[u32Index]);
+
+        switch (op)
+        {
+        case BITMAP_OP_AND:
+            r = _mm256_and_si256(a, b);
+            break;
+        case BITMAP_OP_OR:
+            r = _mm256_or_si256(a, b);
+            break;
+        case BITMAP_OP_XOR:
+            r = _mm256_xor_si256(a, b);
+            break;
+        default:
+            /*_mm256_andnot_si256() complements the first operand.*/
+            r = _mm256_andnot_si256(b, a);
+            break;
+        }
+
+        _mm256_storeu_si256((__m256i *)&pu64Dest[u32Index], r);
+    }
+
+    _opWords(
+        &pu64Dest[u32Index], &pu64Src1[u32Index], &pu64Src2[u32Index], u32NumOfWord - u32Index,
+        op);
+}
+
+#endif
+
+/** Allocate memory for the word array.
+ */
+static u32 _allocBitmapWords(u32 u32NumOfWord, u64 ** ppu64Word)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olsize_t size = (olsize_t)u32NumOfWord * sizeof(u64);
+
+    u32Ret = jf_jiukun_allocLargeMemory((void **)ppu64Word, size);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_bzero(*ppu64Word, size);
+
+    return u32Ret;
+}
+
+/** Free the word array.
+ */
+static void _freeBitmapWords(u32 u32NumOfWord, u64 ** ppu64Word)
+{
+    jf_jiukun_freeLargeMemory((void **)ppu64Word, (olsize_t)u32NumOfWord * sizeof(u64));
+}
+
+/** Clear the bits beyond the size of bitmap in the last word.
+ */
+static void _clearBitmapTailBits(internal_bitmap_t * pib)
+{
+    u32 u32Remain = BITMAP_BIT_IN_WORD(pib->ib_u32NumOfBit);
+
+    if (u32Remain != 0)
+        pib->ib_pu64Word[pib->ib_u32NumOfWord - 1] &= ((u64)1 << u32Remain) - 1;
+}
+
+/** Get the mask of bits from "u32Start" to the end of the word, "u32Start" is the position within
+ *  the word.
+ */
+static inline u64 _getWordMaskFrom(u32 u32Start)
+{
+    return U64_MAX << u32Start;
+}
+
+/** Get the mask of bits from the beginning of the word to "u32End", "u32End" is the position
+ *  within the word and is not included.
+ */
+static inline u64 _getWordMaskTo(u32 u32End)
+{
+    return (u32End == 0) ? U64_MAX : (((u64)1 << u32End) - 1);
+}
+
+/** Do the bulk operation on bitmaps.
+ */
+static u32 _opBitmap(
+    jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2, bitmap_op_t op)
+{
+    internal_bitmap_t * pibDest = (internal_bitmap_t *) pDest;
+    internal_bitmap_t * pibSrc1 = (internal_bitmap_t *) pSrc1;
+    internal_bitmap_t * pibSrc2 = (internal_bitmap_t *) pSrc2;
+
+    assert((pDest != NULL) && (pSrc1 != NULL) && (pSrc2 != NULL));
+
+    if ((pibDest->ib_u32NumOfBit != pibSrc1->ib_u32NumOfBit) ||
+        (pibDest->ib_u32NumOfBit != pibSrc2->ib_u32NumOfBit))
+        return JF_ERR_INVALID_PARAM;
+
+#if defined(BITMAP_X86_DISPATCH)
+    if ((pibDest->ib_u32NumOfWord >= BITMAP_AVX2_MIN_WORDS) &&
+        (_getBitmapCpuFeature() & BITMAP_CPU_FEATURE_AVX2))
+    {
+        _opWordsAvx2(
+            pibDest->ib_pu64Word, pibSrc1->ib_pu64Word, pibSrc2->ib_pu64Word,
+            pibDest->ib_u32NumOfWord, op);
+        return JF_ERR_NO_ERROR;
+    }
+#endif
+
+    _opWords(
+        pibDest->ib_pu64Word, pibSrc1->ib_pu64Word, pibSrc2->ib_pu64Word,
+        pibDest->ib_u32NumOfWord, op);
+
+    return JF_ERR_NO_ERROR;
+}
+
+/** Find the next bit starting from "u32Start", the bit is set if "bZero" is FALSE, otherwise the
+ *  bit is cleared.
+ */
+static u32 _findBitmapNextBit(
+    internal_bitmap_t * pib, u32 u32Start, boolean_t bZero, u32 * pu32Pos)
+{
+    u32 u32Index = BITMAP_WORD_INDEX(u32Start);
+    u64 u64Flip = bZero ? U64_MAX : 0;
+    u64 u64Word;
+    u32 u32Pos;
+
+    if (u32Start >= pib->ib_u32NumOfBit)
+        return JF_ERR_NOT_FOUND;
+
+    /*Ignore the bits before the start position in the first word.*/
+    u64Word = (pib->ib_pu64Word[u32Index] ^ u64Flip) &
+        _getWordMaskFrom(BITMAP_BIT_IN_WORD(u32Start));
+
+    while (u64Word == 0)
+    {
+        u32Index ++;
+        if (u32Index == pib->ib_u32NumOfWord)
+            return JF_ERR_NOT_FOUND;
+
+        u64Word = pib->ib_pu64Word[u32Index] ^ u64Flip;
+    }
+
+    u32Pos = u32Index * JF_BITMAP_BITS_PER_WORD + _findWordFirstSetBit(u64Word);
+
+    /*The tail bits in the last word are 0, they are found when searching zero bit.*/
+    if (u32Pos >= pib->ib_u32NumOfBit)
+        return JF_ERR_NOT_FOUND;
+
+    *pu32Pos = u32Pos;
+
+    return JF_ERR_NO_ERROR;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_bitmap_create(jf_bitmap_t ** ppBitmap, u32 u32NumOfBit)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_bitmap_t * pib = NULL;
+
+    assert(ppBitmap != NULL);
+
+    if (u32NumOfBit == 0)
+        return JF_ERR_INVALID_PARAM;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pib, sizeof(*pib));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pib, sizeof(*pib));
+        pib->ib_u32NumOfBit = u32NumOfBit;
+        pib->ib_u32NumOfWord = BITMAP_BITS_TO_WORDS(u32NumOfBit);
+
+        u32Ret = _allocBitmapWords(pib->ib_u32NumOfWord, &pib->ib_pu64Word);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        *ppBitmap = pib;
+    else if (pib != NULL)
+        jf_bitmap_destroy((jf_bitmap_t **)&pib);
+
+    return u32Ret;
+}
+
+u32 jf_bitmap_destroy(jf_bitmap_t ** ppBitmap)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_bitmap_t * pib = NULL;
+
+    assert((ppBitmap != NULL) && (*ppBitmap != NULL));
+
+    pib = (internal_bitmap_t *) *ppBitmap;
+
+    if (pib->ib_pu64Word != NULL)
+        _freeBitmapWords(pib->ib_u32NumOfWord, &pib->ib_pu64Word);
+
+    jf_jiukun_freeMemory(ppBitmap);
+
+    return u32Ret;
+}
+
+u32 jf_bitmap_resize(jf_bitmap_t * pBitmap, u32 u32NumOfBit)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+    u32 u32NumOfWord = BITMAP_BITS_TO_WORDS(u32NumOfBit);
+    u64 * pu64Word = NULL;
+
+    assert(pBitmap != NULL);
+
+    if (u32NumOfBit == 0)
+        return JF_ERR_INVALID_PARAM;
+
+    if (u32NumOfWord != pib->ib_u32NumOfWord)
+    {
+        u32Ret = _allocBitmapWords(u32NumOfWord, &pu64Word);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ol_memcpy(
+                pu64Word, pib->ib_pu64Word,
+                (olsize_t)MIN(u32NumOfWord, pib->ib_u32NumOfWord) * sizeof(u64));
+
+            _freeBitmapWords(pib->ib_u32NumOfWord, &pib->ib_pu64Word);
+
+            pib->ib_pu64Word = pu64Word;
+            pib->ib_u32NumOfWord = u32NumOfWord;
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pib->ib_u32NumOfBit = u32NumOfBit;
+        _clearBitmapTailBits(pib);
+    }
+
+    return u32Ret;
+}
+
+u32 jf_bitmap_getSize(jf_bitmap_t * pBitmap)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert(pBitmap != NULL);
+
+    return pib->ib_u32NumOfBit;
+}
+
+void jf_bitmap_setBit(jf_bitmap_t * pBitmap, u32 u32Pos)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert((pBitmap != NULL) && (u32Pos < pib->ib_u32NumOfBit));
+
+    pib->ib_pu64Word[BITMAP_WORD_INDEX(u32Pos)] |= BITMAP_BIT_MASK(u32Pos);
+}
+
+void jf_bitmap_clearBit(jf_bitmap_t * pBitmap, u32 u32Pos)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert((pBitmap != NULL) && (u32Pos < pib->ib_u32NumOfBit));
+
+    pib->ib_pu64Word[BITMAP_WORD_INDEX(u32Pos)] &= ~BITMAP_BIT_MASK(u32Pos);
+}
+
+boolean_t jf_bitmap_testBit(jf_bitmap_t * pBitmap, u32 u32Pos)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert((pBitmap != NULL) && (u32Pos < pib->ib_u32NumOfBit));
+
+    return ((pib->ib_pu64Word[BITMAP_WORD_INDEX(u32Pos)] & BITMAP_BIT_MASK(u32Pos)) != 0);
+}
+
+void jf_bitmap_setAll(jf_bitmap_t * pBitmap)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert(pBitmap != NULL);
+
+    ol_memset(pib->ib_pu64Word, 0xFF, (olsize_t)pib->ib_u32NumOfWord * sizeof(u64));
+    _clearBitmapTailBits(pib);
+}
+
+void jf_bitmap_clearAll(jf_bitmap_t * pBitmap)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert(pBitmap != NULL);
+
+    ol_bzero(pib->ib_pu64Word, (olsize_t)pib->ib_u32NumOfWord * sizeof(u64));
+}
+
+u32 jf_bitmap_setRange(jf_bitmap_t * pBitmap, u32 u32Start, u32 u32Count)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+    u32 u32First, u32Last;
+    u64 u64FirstMask, u64LastMask;
+
+    assert(pBitmap != NULL);
+
+    if ((u32Start > pib->ib_u32NumOfBit) || (u32Count > pib->ib_u32NumOfBit - u32Start))
+        return JF_ERR_OUT_OF_RANGE;
+
+    if (u32Count == 0)
+        return JF_ERR_NO_ERROR;
+
+    u32First = BITMAP_WORD_INDEX(u32Start);
+    u32Last = BITMAP_WORD_INDEX(u32Start + u32Count - 1);
+    u64FirstMask = _getWordMaskFrom(BITMAP_BIT_IN_WORD(u32Start));
+    u64LastMask = _getWordMaskTo(BITMAP_BIT_IN_WORD(u32Start + u32Count));
+
+    if (u32First == u32Last)
+    {
+        pib->ib_pu64Word[u32First] |= u64FirstMask & u64LastMask;
+    }
+    else
+    {
+        pib->ib_pu64Word[u32First] |= u64FirstMask;
+        ol_memset(
+            &pib->ib_pu64Word[u32First + 1], 0xFF,
+            (olsize_t)(u32Last - u32First - 1) * sizeof(u64));
+        pib->ib_pu64Word[u32Last] |= u64LastMask;
+    }
+
+    return JF_ERR_NO_ERROR;
+}
+
+u32 jf_bitmap_clearRange(jf_bitmap_t * pBitmap, u32 u32Start, u32 u32Count)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+    u32 u32First, u32Last;
+    u64 u64FirstMask, u64LastMask;
+
+    assert(pBitmap != NULL);
+
+    if ((u32Start > pib->ib_u32NumOfBit) || (u32Count > pib->ib_u32NumOfBit - u32Start))
+        return JF_ERR_OUT_OF_RANGE;
+
+    if (u32Count == 0)
+        return JF_ERR_NO_ERROR;
+
+    u32First = BITMAP_WORD_INDEX(u32Start);
+    u32Last = BITMAP_WORD_INDEX(u32Start + u32Count - 1);
+    u64FirstMask = _getWordMaskFrom(BITMAP_BIT_IN_WORD(u32Start));
+    u64LastMask = _getWordMaskTo(BITMAP_BIT_IN_WORD(u32Start + u32Count));
+
+    if (u32First == u32Last)
+    {
+        pib->ib_pu64Word[u32First] &= ~(u64FirstMask & u64LastMask);
+    }
+    else
+    {
+        pib->ib_pu64Word[u32First] &= ~u64FirstMask;
+        ol_bzero(&pib->ib_pu64Word[u32First + 1], (olsize_t)(u32Last - u32First - 1) * sizeof(u64));
+        pib->ib_pu64Word[u32Last] &= ~u64LastMask;
+    }
+
+    return JF_ERR_NO_ERROR;
+}
+
+u32 jf_bitmap_and(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2)
+{
+    return _opBitmap(pDest, pSrc1, pSrc2, BITMAP_OP_AND);
+}
+
+u32 jf_bitmap_or(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2)
+{
+    return _opBitmap(pDest, pSrc1, pSrc2, BITMAP_OP_OR);
+}
+
+u32 jf_bitmap_xor(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2)
+{
+    return _opBitmap(pDest, pSrc1, pSrc2, BITMAP_OP_XOR);
+}
+
+u32 jf_bitmap_andNot(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2)
+{
+    return _opBitmap(pDest, pSrc1, pSrc2, BITMAP_OP_ANDNOT);
+}
+
+u32 jf_bitmap_countSetBit(jf_bitmap_t * pBitmap)
+{
+    internal_bitmap_t * pib = (internal_bitmap_t *) pBitmap;
+
+    assert(pBitmap != NULL);
+
+#if defined(BITMAP_X86_DISPATCH)
+    if ((pib->ib_u32NumOfWord >= BITMAP_AVX2_MIN_WORDS) &&
+        (_getBitmapCpuFeature() & BITMAP_CPU_FEATURE_AVX2))
+        return _countWordsSetBitAvx2(pib->ib_pu64Word, pib->ib_u32NumOfWord);
+
+    if (_getBitmapCpuFeature() & BITMAP_CPU_FEATURE_POPCNT)
+        return _countWordsSetBitPopcnt(pib->ib_pu64Word, pib->ib_u32NumOfWord);
+#endif
+
+    return _countWordsSetBit(pib->ib_pu64Word, pib->ib_u32NumOfWord);
+}
+
+u32 jf_bitmap_findFirstSetBit(jf_bitmap_t * pBitmap, u32 * pu32Pos)
+{
+    assert((pBitmap != NULL) && (pu32Pos != NULL));
+
+    return _findBitmapNextBit((internal_bitmap_t *) pBitmap, 0, FALSE, pu32Pos);
+}
+
+u32 jf_bitmap_findNextSetBit(jf_bitmap_t * pBitmap, u32 u32Start, u32 * pu32Pos)
+{
+    assert((pBitmap != NULL) && (pu32Pos != NULL));
+
+    return _findBitmapNextBit((internal_bitmap_t *) pBitmap, u32Start, FALSE, pu32Pos);
+}
+
+u32 jf_bitmap_findFirstZeroBit(jf_bitmap_t * pBitmap, u32 * pu32Pos)
+{
+    assert((pBitmap != NULL) && (pu32Pos != NULL));
+
+    return _findBitmapNextBit((internal_bitmap_t *) pBitmap, 0, TRUE, pu32Pos);
+}
+
+u32 jf_bitmap_findNextZeroBit(jf_bitmap_t * pBitmap, u32 u32Start, u32 * pu32Pos)
+{
+    assert((pBitmap != NULL) && (pu32Pos != NULL));
+
+    return _findBitmapNextBit((internal_bitmap_t *) pBitmap, u32Start, TRUE, pu32Pos);
+}
+
+/*------------------------------------------------------------------------------------------------*/
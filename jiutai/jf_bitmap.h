@@ -0,0 +1,264 @@
+/**
+ *  @file jf_bitmap.h
+ *
+ *  @brief Header file which defines the dynamically sized bitmap.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_bitmap object.
+ *  -# The bits are stored in an array of u64 word. Bit 0 is the least significant bit of word 0,
+ *   this is different from jf_bitarray where bit 0 is the most significant bit of the first char.
+ *  -# The bulk operations work one word at a time, they use AVX2 if the CPU supports it. The
+ *   population count and bit scan use the builtin of compiler.
+ *  -# The bits beyond the size of the bitmap in the last word are always 0.
+ *  -# The bitmap can be used as allocation map, eg, find the first zero bit and set it to allocate
+ *   an ID.
+ *  -# Link with jf_jiukun library for memory allocation.
+ */
+
+#ifndef JIUTAI_BITMAP_H
+#define JIUTAI_BITMAP_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Define the bitmap data type.
+ */
+typedef void  jf_bitmap_t;
+
+/** Number of bits in a word of bitmap.
+ */
+#define JF_BITMAP_BITS_PER_WORD          (64)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Create the bitmap, all bits are cleared.
+ *
+ *  @param ppBitmap [out] The bitmap to be created and returned.
+ *  @param u32NumOfBit [in] Number of bits in the bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM Number of bits is 0.
+ */
+u32 jf_bitmap_create(jf_bitmap_t ** ppBitmap, u32 u32NumOfBit);
+
+/** Destroy the bitmap.
+ *
+ *  @param ppBitmap [in/out] The bitmap to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_bitmap_destroy(jf_bitmap_t ** ppBitmap);
+
+/** Change the number of bits in the bitmap.
+ *
+ *  @note
+ *  -# The new bits are cleared if the bitmap is enlarged.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32NumOfBit [in] Number of bits in the bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM Number of bits is 0.
+ */
+u32 jf_bitmap_resize(jf_bitmap_t * pBitmap, u32 u32NumOfBit);
+
+/** Get number of bits in the bitmap.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *
+ *  @return Number of bits.
+ */
+u32 jf_bitmap_getSize(jf_bitmap_t * pBitmap);
+
+/** Set the bit specified by "u32Pos" to 1.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Pos [in] The position.
+ *
+ *  @return Void.
+ */
+void jf_bitmap_setBit(jf_bitmap_t * pBitmap, u32 u32Pos);
+
+/** Clear the bit specified by "u32Pos" to 0.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Pos [in] The position.
+ *
+ *  @return Void.
+ */
+void jf_bitmap_clearBit(jf_bitmap_t * pBitmap, u32 u32Pos);
+
+/** Test the bit specified by "u32Pos".
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Pos [in] The position.
+ *
+ *  @return The bit status.
+ *  @retval TRUE The bit is set.
+ *  @retval FALSE The bit is cleared.
+ */
+boolean_t jf_bitmap_testBit(jf_bitmap_t * pBitmap, u32 u32Pos);
+
+/** Set all bits to 1.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *
+ *  @return Void.
+ */
+void jf_bitmap_setAll(jf_bitmap_t * pBitmap);
+
+/** Clear all bits to 0.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *
+ *  @return Void.
+ */
+void jf_bitmap_clearAll(jf_bitmap_t * pBitmap);
+
+/** Set "u32Count" bits starting from "u32Start" to 1.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Start [in] The first bit to set.
+ *  @param u32Count [in] Number of bits to set.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OUT_OF_RANGE The range is out of the bitmap.
+ */
+u32 jf_bitmap_setRange(jf_bitmap_t * pBitmap, u32 u32Start, u32 u32Count);
+
+/** Clear "u32Count" bits starting from "u32Start" to 0.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Start [in] The first bit to clear.
+ *  @param u32Count [in] Number of bits to clear.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OUT_OF_RANGE The range is out of the bitmap.
+ */
+u32 jf_bitmap_clearRange(jf_bitmap_t * pBitmap, u32 u32Start, u32 u32Count);
+
+/** And the bitmap "pSrc1" with "pSrc2", the result saves to "pDest".
+ *
+ *  @note
+ *  -# The bitmaps must have the same size. The destination can be one of the sources.
+ *
+ *  @param pDest [out] The destination bitmap.
+ *  @param pSrc1 [in] The first source bitmap.
+ *  @param pSrc2 [in] The second source bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM The bitmaps have different size.
+ */
+u32 jf_bitmap_and(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2);
+
+/** Or the bitmap "pSrc1" with "pSrc2", the result saves to "pDest".
+ *
+ *  @param pDest [out] The destination bitmap.
+ *  @param pSrc1 [in] The first source bitmap.
+ *  @param pSrc2 [in] The second source bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM The bitmaps have different size.
+ */
+u32 jf_bitmap_or(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2);
+
+/** XOR the bitmap "pSrc1" with "pSrc2", the result saves to "pDest".
+ *
+ *  @param pDest [out] The destination bitmap.
+ *  @param pSrc1 [in] The first source bitmap.
+ *  @param pSrc2 [in] The second source bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM The bitmaps have different size.
+ */
+u32 jf_bitmap_xor(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2);
+
+/** Clear the bits in "pSrc1" which are set in "pSrc2", the result saves to "pDest".
+ *
+ *  @param pDest [out] The destination bitmap.
+ *  @param pSrc1 [in] The first source bitmap.
+ *  @param pSrc2 [in] The second source bitmap.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM The bitmaps have different size.
+ */
+u32 jf_bitmap_andNot(jf_bitmap_t * pDest, jf_bitmap_t * pSrc1, jf_bitmap_t * pSrc2);
+
+/** Get number of bits set to 1.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *
+ *  @return Number of bits set.
+ */
+u32 jf_bitmap_countSetBit(jf_bitmap_t * pBitmap);
+
+/** Find the first bit set to 1.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param pu32Pos [out] The position of the bit.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_NOT_FOUND No bit is set.
+ */
+u32 jf_bitmap_findFirstSetBit(jf_bitmap_t * pBitmap, u32 * pu32Pos);
+
+/** Find the next bit set to 1 starting from "u32Start", the bit at "u32Start" is included.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Start [in] The position to start with.
+ *  @param pu32Pos [out] The position of the bit.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_NOT_FOUND No bit is set.
+ */
+u32 jf_bitmap_findNextSetBit(jf_bitmap_t * pBitmap, u32 u32Start, u32 * pu32Pos);
+
+/** Find the first bit cleared to 0.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param pu32Pos [out] The position of the bit.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_NOT_FOUND All bits are set.
+ */
+u32 jf_bitmap_findFirstZeroBit(jf_bitmap_t * pBitmap, u32 * pu32Pos);
+
+/** Find the next bit cleared to 0 starting from "u32Start", the bit at "u32Start" is included.
+ *
+ *  @param pBitmap [in] The bitmap.
+ *  @param u32Start [in] The position to start with.
+ *  @param pu32Pos [out] The position of the bit.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_NOT_FOUND All bits are set.
+ */
+u32 jf_bitmap_findNextZeroBit(jf_bitmap_t * pBitmap, u32 u32Start, u32 * pu32Pos);
+
+#endif /*JIUTAI_BITMAP_H*/
+
+/*------------------------------------------------------------------------------------------------*/
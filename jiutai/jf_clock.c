@@ -0,0 +1,348 @@
+/**
+ *  @file jf_clock.c
+ *
+ *  @brief Implementation file for cached clock source.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The ticker thread is the only writer of the cached clock, the readers load it with acquire
+ *   semantic. The running flag is set after the clock is published for the first time.
+ *  -# The nanosecond per TSC tick is saved as 32.32 fixed point number, the tick and the number
+ *   are split into high and low 32 bits for conversion, so the multiplication doesn't overflow.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define JF_CLOCK_TSC_SUPPORTED
+    #if defined(WINDOWS)
+        #include <intrin.h>
+    #elif defined(LINUX)
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_clock.h"
+#include "jf_time.h"
+#include "jf_thread.h"
+#include "jf_atomic.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** The time in millisecond for TSC calibration.
+ */
+#define CLOCK_TSC_CALIBRATION_TIME            (20)
+
+/** The name of the ticker thread.
+ */
+#define CLOCK_TICKER_THREAD_NAME              "jf-clock"
+
+/** The cached clock published by the ticker thread.
+ */
+typedef struct
+{
+    /**Monotonic clock in millisecond.*/
+    u64 cc_u64Monotonic;
+    /**Real time clock in millisecond.*/
+    u64 cc_u64Realtime;
+    u8 cc_u8Reserved[JF_ATOMIC_CACHE_LINE_SIZE - 16];
+} clock_cache_t;
+
+/** The cached clock, it's on its own cache line as it's read by all threads.
+ */
+static clock_cache_t ls_ccClockCache;
+
+/** The clock is initialized if it's TRUE.
+ */
+static boolean_t ls_bClockInitialized = FALSE;
+
+/** The ticker is running if it's not 0.
+ */
+static u32 ls_u32ClockTickerRunning = 0;
+
+/** The ticker thread quits if it's not 0.
+ */
+static u32 ls_u32ClockToTerminateTicker = 0;
+
+/** Interval of the ticker in millisecond.
+ */
+static u32 ls_u32ClockTickerInterval = JF_CLOCK_DEF_TICKER_INTERVAL;
+
+/** Thread id of the ticker.
+ */
+static jf_thread_id_t ls_jtiClockTicker;
+
+/** TSC is used for tick if it's TRUE.
+ */
+static boolean_t ls_bClockTsc = FALSE;
+
+/** Nanosecond per TSC tick in 32.32 fixed point.
+ */
+static u64 ls_u64ClockTscMult = 0;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static u64 _getClockMilliSecond(jf_time_clock_t clkid)
+{
+    jf_time_spec_t jts;
+
+    ol_bzero(&jts, sizeof(jts));
+    jf_time_getClockTime(clkid, &jts);
+
+    return jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND +
+        jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND;
+}
+
+static u64 _getClockNanoSecond(jf_time_clock_t clkid)
+{
+    jf_time_spec_t jts;
+
+    ol_bzero(&jts, sizeof(jts));
+    jf_time_getClockTime(clkid, &jts);
+
+    return jts.jts_u64Second * JF_TIME_MILLISECOND_TO_NANOSECOND * JF_TIME_SECOND_TO_MILLISECOND +
+        jts.jts_u64NanoSecond;
+}
+
+#if defined(WINDOWS)
+
+static u64 _getClockRealtimeMilliSecond(void)
+{
+    jf_time_val_t jtv;
+
+    ol_bzero(&jtv, sizeof(jtv));
+    jf_time_getTimeOfDay(&jtv);
+
+    return jtv.jtv_u64Second * JF_TIME_SECOND_TO_MILLISECOND + jtv.jtv_u64MicroSecond / 1000;
+}
+
+#endif
+
+static u64 _getClockCoarseRealtimeMilliSecond(void)
+{
+#if defined(LINUX)
+    return _getClockMilliSecond(JF_TIME_CLOCK_REALTIME_COARSE);
+#elif defined(WINDOWS)
+    return _getClockRealtimeMilliSecond();
+#endif
+}
+
+/** Publish the clock read by the readers.
+ *
+ *  @note
+ *  -# The coarse clock is published, it's the clock read by the readers without the ticker. The
+ *   precise clock may be ahead of the coarse clock, the clock would step back after the ticker is
+ *   stopped if the precise clock is published.
+ */
+static void _publishClock(void)
+{
+    jf_atomic_storeU64(
+        &ls_ccClockCache.cc_u64Monotonic, _getClockMilliSecond(JF_TIME_CLOCK_MONOTONIC_COARSE));
+    jf_atomic_storeU64(&ls_ccClockCache.cc_u64Realtime, _getClockCoarseRealtimeMilliSecond());
+}
+
+static JF_THREAD_RETURN_VALUE _clockTickerThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    while (jf_atomic_loadU32(&ls_u32ClockToTerminateTicker) == 0)
+    {
+        jf_time_milliSleep(ls_u32ClockTickerInterval);
+        _publishClock();
+    }
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _startClockTicker(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_attr_t jta;
+
+    ol_bzero(&jta, sizeof(jta));
+    jta.jta_pstrName = CLOCK_TICKER_THREAD_NAME;
+
+    /*Publish the clock before the running flag is set, so the readers never see 0.*/
+    _publishClock();
+    jf_atomic_storeU32(&ls_u32ClockToTerminateTicker, 0);
+
+    u32Ret = jf_thread_create(&ls_jtiClockTicker, &jta, _clockTickerThread, NULL);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        jf_atomic_storeU32(&ls_u32ClockTickerRunning, 1);
+
+    return u32Ret;
+}
+
+static u32 _stopClockTicker(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    /*The readers fall back to the coarse clock before the ticker quits.*/
+    jf_atomic_storeU32(&ls_u32ClockTickerRunning, 0);
+    jf_atomic_storeU32(&ls_u32ClockToTerminateTicker, 1);
+
+    u32Ret = jf_thread_waitForThreadTermination(ls_jtiClockTicker, NULL);
+    jf_thread_initId(&ls_jtiClockTicker);
+
+    return u32Ret;
+}
+
+#if defined(JF_CLOCK_TSC_SUPPORTED)
+
+static inline u64 _readTsc(void)
+{
+    return (u64)__rdtsc();
+}
+
+static boolean_t _isInvariantTsc(void)
+{
+    boolean_t bRet = FALSE;
+#if defined(LINUX)
+    u32 u32Eax = 0, u32Ebx = 0, u32Ecx = 0, u32Edx = 0;
+
+    /*Bit 8 of EDX of the extended leaf 0x80000007 is the invariant TSC flag.*/
+    if ((__get_cpuid(0x80000007, &u32Eax, &u32Ebx, &u32Ecx, &u32Edx) != 0) &&
+        ((u32Edx & (1 << 8)) != 0))
+        bRet = TRUE;
+#elif defined(WINDOWS)
+    olint_t nInfo[4];
+
+    __cpuid(nInfo, 0x80000000);
+    if ((u32)nInfo[0] >= 0x80000007)
+    {
+        __cpuid(nInfo, 0x80000007);
+        if ((nInfo[3] & (1 << 8)) != 0)
+            bRet = TRUE;
+    }
+#endif
+
+    return bRet;
+}
+
+static void _calibrateTsc(void)
+{
+    u64 u64Tsc1 = 0, u64Tsc2 = 0, u64Ns1 = 0, u64Ns2 = 0;
+
+    if (! _isInvariantTsc())
+        return;
+
+    u64Ns1 = _getClockNanoSecond(JF_TIME_CLOCK_MONOTONIC_RAW);
+    u64Tsc1 = _readTsc();
+
+    jf_time_milliSleep(CLOCK_TSC_CALIBRATION_TIME);
+
+    u64Ns2 = _getClockNanoSecond(JF_TIME_CLOCK_MONOTONIC_RAW);
+    u64Tsc2 = _readTsc();
+
+    if ((u64Tsc2 > u64Tsc1) && (u64Ns2 > u64Ns1))
+    {
+        ls_u64ClockTscMult = ((u64Ns2 - u64Ns1) << 32) / (u64Tsc2 - u64Tsc1);
+        if (ls_u64ClockTscMult != 0)
+            ls_bClockTsc = TRUE;
+    }
+}
+
+#endif
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_clock_init(jf_clock_init_param_t * pjcip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    if (ls_bClockInitialized)
+        return u32Ret;
+
+#if defined(JF_CLOCK_TSC_SUPPORTED)
+    if (pjcip->jcip_bTsc)
+        _calibrateTsc();
+#endif
+
+    if (pjcip->jcip_bTicker)
+    {
+        ls_u32ClockTickerInterval = pjcip->jcip_u32TickerInterval;
+        if (ls_u32ClockTickerInterval == 0)
+            ls_u32ClockTickerInterval = JF_CLOCK_DEF_TICKER_INTERVAL;
+
+        u32Ret = _startClockTicker();
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ls_bClockInitialized = TRUE;
+    else
+        jf_clock_fini();
+
+    return u32Ret;
+}
+
+u32 jf_clock_fini(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    if (jf_clock_isTickerRunning())
+        u32Ret = _stopClockTicker();
+
+    ls_bClockTsc = FALSE;
+    ls_u64ClockTscMult = 0;
+    ls_bClockInitialized = FALSE;
+
+    return u32Ret;
+}
+
+u64 jf_clock_getMonotonicMilliSecond(void)
+{
+    if (jf_atomic_loadU32(&ls_u32ClockTickerRunning) != 0)
+        return jf_atomic_loadU64(&ls_ccClockCache.cc_u64Monotonic);
+
+    return _getClockMilliSecond(JF_TIME_CLOCK_MONOTONIC_COARSE);
+}
+
+u64 jf_clock_getRealtimeMilliSecond(void)
+{
+    if (jf_atomic_loadU32(&ls_u32ClockTickerRunning) != 0)
+        return jf_atomic_loadU64(&ls_ccClockCache.cc_u64Realtime);
+
+    return _getClockCoarseRealtimeMilliSecond();
+}
+
+boolean_t jf_clock_isTickerRunning(void)
+{
+    return (jf_atomic_loadU32(&ls_u32ClockTickerRunning) != 0);
+}
+
+u64 jf_clock_getTick(void)
+{
+#if defined(JF_CLOCK_TSC_SUPPORTED)
+    if (ls_bClockTsc)
+        return _readTsc();
+#endif
+
+    return _getClockNanoSecond(JF_TIME_CLOCK_MONOTONIC);
+}
+
+u64 jf_clock_getNanoSecondFromTick(u64 u64Tick)
+{
+    u64 u64TickHigh = u64Tick >> 32, u64TickLow = u64Tick & U32_MAX;
+    u64 u64MultHigh = ls_u64ClockTscMult >> 32, u64MultLow = ls_u64ClockTscMult & U32_MAX;
+
+    if (! ls_bClockTsc)
+        return u64Tick;
+
+    return ((u64TickHigh * u64MultHigh) << 32) + u64TickHigh * u64MultLow +
+        u64TickLow * u64MultHigh + ((u64TickLow * u64MultLow) >> 32);
+}
+
+boolean_t jf_clock_isTscUsed(void)
+{
+    return ls_bClockTsc;
+}
+
+/*------------------------------------------------------------------------------------------------*/
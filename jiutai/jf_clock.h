@@ -0,0 +1,120 @@
+/**
+ *  @file jf_clock.h
+ *
+ *  @brief Header file defines the interface for cached clock source used in hot path.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_clock object.
+ *  -# The millisecond clock is read from the coarse clock by default. If the ticker is enabled, a
+ *   ticker thread publishes the coarse clock periodically and the clock is read with an
+ *   atomic load. The clock may lag behind the real clock for the ticker interval.
+ *  -# The tick is for interval measurement, only the difference of 2 ticks is meaningful. If TSC
+ *   is enabled and the CPU has invariant TSC, the tick is read by rdtsc and converted to nanosecond
+ *   with the frequency calibrated against the monotonic raw clock, otherwise the tick is the
+ *   monotonic clock in nanosecond.
+ *  -# Link with jf_time, jf_thread common objects.
+ */
+
+#ifndef JIUTAI_CLOCK_H
+#define JIUTAI_CLOCK_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Default interval of the ticker in millisecond.
+ */
+#define JF_CLOCK_DEF_TICKER_INTERVAL          (1)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** The parameter for initializing the clock.
+ */
+typedef struct
+{
+    /**Start the ticker thread if it's TRUE.*/
+    boolean_t jcip_bTicker;
+    /**Use TSC for tick if it's TRUE and the CPU has invariant TSC.*/
+    boolean_t jcip_bTsc;
+    u8 jcip_u8Reserved[6];
+    /**Interval of the ticker in millisecond, JF_CLOCK_DEF_TICKER_INTERVAL is used if it's 0.*/
+    u32 jcip_u32TickerInterval;
+    u32 jcip_u32Reserved[7];
+} jf_clock_init_param_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Initialize the clock.
+ *
+ *  @note
+ *  -# The TSC is calibrated in this function, it takes about 20 milliseconds.
+ *  -# The clock can be used without initialization, the coarse clock and monotonic clock are used.
+ *  -# The function does nothing if the clock is already initialized.
+ *
+ *  @param pjcip [in] The parameter for initializing the clock.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_CREATE_THREAD Failed to create the ticker thread.
+ */
+u32 jf_clock_init(jf_clock_init_param_t * pjcip);
+
+/** Finalize the clock, the ticker thread is stopped.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_clock_fini(void);
+
+/** Get the monotonic clock in millisecond.
+ *
+ *  @return The monotonic clock in millisecond.
+ */
+u64 jf_clock_getMonotonicMilliSecond(void);
+
+/** Get the real time clock in millisecond since Epoch.
+ *
+ *  @return The real time clock in millisecond.
+ */
+u64 jf_clock_getRealtimeMilliSecond(void);
+
+/** Check if the ticker thread is running.
+ *
+ *  @return The status of the ticker.
+ *  @retval TRUE The ticker is running.
+ *  @retval FALSE The ticker is not running.
+ */
+boolean_t jf_clock_isTickerRunning(void);
+
+/** Get the tick for interval measurement.
+ *
+ *  @return The tick.
+ */
+u64 jf_clock_getTick(void);
+
+/** Convert the difference of 2 ticks to nanosecond.
+ *
+ *  @param u64Tick [in] The difference of 2 ticks.
+ *
+ *  @return The time in nanosecond.
+ */
+u64 jf_clock_getNanoSecondFromTick(u64 u64Tick);
+
+/** Check if the TSC is used for tick.
+ *
+ *  @return The status of the TSC.
+ *  @retval TRUE The TSC is used.
+ *  @retval FALSE The TSC is not used.
+ */
+boolean_t jf_clock_isTscUsed(void);
+
+#endif /*JIUTAI_CLOCK_H*/
+
+/*------------------------------------------------------------------------------------------------*/
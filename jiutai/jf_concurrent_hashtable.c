@@ -0,0 +1,705 @@
+/**
+ *  @file jf_concurrent_hashtable.c
+ *
+ *  @brief Implementation file for concurrent hash table.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The number of bucket is power of 2 and multiple of the number of stripe, so the stripe of a
+ *   key is the same after the bucket array is resized.
+ *  -# The writer publishes the node with release store, the node is never modified after it's
+ *   published except the next pointer. The reader traverses the bucket list with acquire load.
+ *  -# The reader increases the counter of current epoch in its slot. The reclaimer flips the epoch
+ *   and waits until the counters of the old epoch in all slots are 0, all nodes removed before the
+ *   flip can be freed after that.
+ *  -# The bucket array is resized by copying the nodes to the new array with all stripes locked,
+ *   the readers which are using the old array still see a consistent table. The old array and
+ *   nodes are freed after the readers end.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(LINUX)
+    #include <sched.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_concurrent_hashtable.h"
+#include "jf_atomic.h"
+#include "jf_hashfunc.h"
+#include "jf_mutex.h"
+#include "jf_jiukun.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Number of lock stripe, power of 2.
+ */
+#define CONCURRENT_HASHTABLE_NUM_OF_STRIPE         (64)
+
+/** Number of reader slot, power of 2.
+ */
+#define CONCURRENT_HASHTABLE_NUM_OF_READER_SLOT    (64)
+
+/** Minimum number of bucket, it must be multiple of the number of stripe.
+ */
+#define CONCURRENT_HASHTABLE_MIN_BUCKET            (CONCURRENT_HASHTABLE_NUM_OF_STRIPE)
+
+/** Maximum number of bucket.
+ */
+#define CONCURRENT_HASHTABLE_MAX_BUCKET            \
+    (JF_JIUKUN_MAX_MEMORY_SIZE / BYTES_PER_POINTER / 2)
+
+/** The removed nodes are reclaimed when the number of them reaches the threshold.
+ */
+#define CONCURRENT_HASHTABLE_RECLAIM_THRESHOLD     (64)
+
+/** Number of spin before yielding the CPU when waiting for readers.
+ */
+#define CONCURRENT_HASHTABLE_WAIT_SPIN             (1000)
+
+/** Define the concurrent hash table node data type.
+ */
+typedef struct concurrent_hashtable_node
+{
+    /**Entry from user.*/
+    void * chn_pEntry;
+    /**Next node in bucket, it's accessed atomically.*/
+    struct concurrent_hashtable_node * chn_pchnNext;
+    /**Next node in the retired list.*/
+    struct concurrent_hashtable_node * chn_pchnRetireNext;
+    /**Hash value of the key.*/
+    u32 chn_u32Hash;
+    /**Free the entry when the node is reclaimed.*/
+    boolean_t chn_bFreeEntry;
+    u8 chn_u8Reserved[3];
+} concurrent_hashtable_node_t;
+
+/** Define the bucket array data type, the buckets follow the header.
+ */
+typedef struct
+{
+    /**Number of bucket.*/
+    u32 cha_u32NumOfBucket;
+    u32 cha_u32Reserved;
+    /**The bucket array.*/
+    concurrent_hashtable_node_t ** cha_ppchnBucket;
+} concurrent_hashtable_array_t;
+
+/** Define the lock stripe data type, it occupies one cache line.
+ */
+typedef union
+{
+    /**The lock for the stripe.*/
+    jf_mutex_t chs_jmLock;
+    u8 chs_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE];
+} concurrent_hashtable_stripe_t;
+
+/** Define the reader slot data type, it occupies one cache line.
+ */
+typedef struct
+{
+    /**Number of reader for odd and even epoch.*/
+    u32 chrs_u32Count[2];
+    u8 chrs_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE - 2 * sizeof(u32)];
+} concurrent_hashtable_reader_slot_t;
+
+/** Define the internal concurrent hash table data type.
+ */
+typedef struct
+{
+    /**The bucket array, it's accessed atomically.*/
+    concurrent_hashtable_array_t * ijch_pchaArray;
+    /**Number of entry in the table, it's accessed atomically.*/
+    u32 ijch_u32NumOfEntry;
+    /**The epoch, it's accessed atomically.*/
+    u32 ijch_u32Epoch;
+
+    /**Number of node in the retired list.*/
+    u32 ijch_u32NumOfRetired;
+    u32 ijch_u32Reserved;
+    /**The retired list, the nodes are removed from the table but may be used by readers.*/
+    concurrent_hashtable_node_t * ijch_pchnRetired;
+    /**The lock for the retired list.*/
+    jf_mutex_t ijch_jmRetire;
+    /**The lock for waiting the readers.*/
+    jf_mutex_t ijch_jmReclaim;
+
+    /**Callback function for comparing keys.*/
+    jf_hashtable_fnCmpKeys_t ijch_fnCmpKeys;
+    /**Callback function for hashing key to integer.*/
+    jf_hashtable_fnHashKey_t ijch_fnHashKey;
+    /**Callback function for getting key from entry.*/
+    jf_hashtable_fnGetKeyFromEntry_t ijch_fnGetKeyFromEntry;
+    /**Callback function for freeing entry.*/
+    jf_hashtable_fnFreeEntry_t ijch_fnFreeEntry;
+
+    /**The lock stripes.*/
+    concurrent_hashtable_stripe_t ijch_chsStripe[CONCURRENT_HASHTABLE_NUM_OF_STRIPE];
+    /**The reader slots.*/
+    concurrent_hashtable_reader_slot_t ijch_chrsReader[CONCURRENT_HASHTABLE_NUM_OF_READER_SLOT];
+} internal_concurrent_hashtable_t;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static olint_t _default_fnChtCmpKeys(void * pKey1, void * pKey2)
+{
+    return (pKey1 == pKey2) ? 0 : 1;
+}
+
+static olint_t _default_fnChtHashKey(void * pKey)
+{
+    return (olint_t)(ulong)pKey;
+}
+
+static void * _default_fnChtGetKeyFromEntry(void * pEntry)
+{
+    return pEntry;
+}
+
+static u32 _default_fnChtFreeEntry(void ** ppEntry)
+{
+    return JF_ERR_NO_ERROR;
+}
+
+/** Hash the key, the hash value from user is mixed as the low bits are used for bucket index.
+ */
+static inline u32 _hashConcurrentHashtableKey(internal_concurrent_hashtable_t * pijch, void * pKey)
+{
+    return (u32)jf_hashfunc_hashU64((u32)pijch->ijch_fnHashKey(pKey));
+}
+
+static inline jf_mutex_t * _getConcurrentHashtableStripeLock(
+    internal_concurrent_hashtable_t * pijch, u32 u32Hash)
+{
+    return &pijch->ijch_chsStripe[u32Hash & (CONCURRENT_HASHTABLE_NUM_OF_STRIPE - 1)].chs_jmLock;
+}
+
+static inline void _yieldConcurrentHashtable(void)
+{
+#if defined(LINUX)
+    sched_yield();
+#elif defined(WINDOWS)
+    SwitchToThread();
+#endif
+}
+
+static u32 _getConcurrentHashtableReaderSlot(void)
+{
+#if defined(LINUX)
+    u64 u64Id = (u64)(ulong)pthread_self();
+#elif defined(WINDOWS)
+    u64 u64Id = (u64)GetCurrentThreadId();
+#endif
+
+    return (u32)jf_hashfunc_hashU64(u64Id) & (CONCURRENT_HASHTABLE_NUM_OF_READER_SLOT - 1);
+}
+
+static u32 _allocConcurrentHashtableArray(u32 u32NumOfBucket, concurrent_hashtable_array_t ** ppcha)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olsize_t size = sizeof(concurrent_hashtable_array_t) +
+        u32NumOfBucket * sizeof(concurrent_hashtable_node_t *);
+
+    u32Ret = jf_jiukun_allocMemory((void **)ppcha, size);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(*ppcha, size);
+        (*ppcha)->cha_u32NumOfBucket = u32NumOfBucket;
+        (*ppcha)->cha_ppchnBucket = (concurrent_hashtable_node_t **)(*ppcha + 1);
+    }
+
+    return u32Ret;
+}
+
+/** Free the bucket array and all nodes in it.
+ *
+ *  @param pijch [in] The concurrent hash table.
+ *  @param ppcha [in/out] The bucket array.
+ *  @param bFreeEntry [in] Free the entries if it's TRUE.
+ *
+ *  @return Void.
+ */
+static void _freeConcurrentHashtableArray(
+    internal_concurrent_hashtable_t * pijch, concurrent_hashtable_array_t ** ppcha,
+    boolean_t bFreeEntry)
+{
+    concurrent_hashtable_array_t * pcha = *ppcha;
+    concurrent_hashtable_node_t * pchn = NULL, * pchnNext = NULL;
+    u32 u32Index = 0;
+
+    for (u32Index = 0; u32Index < pcha->cha_u32NumOfBucket; u32Index ++)
+    {
+        for (pchn = pcha->cha_ppchnBucket[u32Index]; pchn != NULL; pchn = pchnNext)
+        {
+            pchnNext = pchn->chn_pchnNext;
+            if (bFreeEntry)
+                pijch->ijch_fnFreeEntry(&pchn->chn_pEntry);
+            jf_jiukun_freeMemory((void **)&pchn);
+        }
+    }
+
+    jf_jiukun_freeMemory((void **)ppcha);
+}
+
+/** Find the node with the key in bucket, the stripe lock must be held.
+ *
+ *  @return The address of the link to the node, or the address of the NULL link at the end of the
+ *   bucket if the key is not found.
+ */
+static concurrent_hashtable_node_t ** _findConcurrentHashtableNode(
+    internal_concurrent_hashtable_t * pijch, concurrent_hashtable_array_t * pcha, u32 u32Hash,
+    void * pKey)
+{
+    concurrent_hashtable_node_t ** ppchn =
+        &pcha->cha_ppchnBucket[u32Hash & (pcha->cha_u32NumOfBucket - 1)];
+
+    while (*ppchn != NULL)
+    {
+        if (((*ppchn)->chn_u32Hash == u32Hash) &&
+            (pijch->ijch_fnCmpKeys(pKey, pijch->ijch_fnGetKeyFromEntry((*ppchn)->chn_pEntry)) == 0))
+            break;
+
+        ppchn = &(*ppchn)->chn_pchnNext;
+    }
+
+    return ppchn;
+}
+
+/** Wait until all readers which started before this routine have ended.
+ */
+static void _waitForConcurrentHashtableReader(internal_concurrent_hashtable_t * pijch)
+{
+    u32 u32Index = 0, u32Slot = 0, u32Spin = 0;
+
+    jf_mutex_acquire(&pijch->ijch_jmReclaim);
+
+    /*Flip the epoch, the new readers use the counter of new epoch.*/
+    u32Index = jf_atomic_fetchAddU32(&pijch->ijch_u32Epoch, 1) & 1;
+    jf_atomic_fence();
+
+    for (u32Slot = 0; u32Slot < CONCURRENT_HASHTABLE_NUM_OF_READER_SLOT; u32Slot ++)
+    {
+        u32Spin = 0;
+        while (jf_atomic_loadU32(&pijch->ijch_chrsReader[u32Slot].chrs_u32Count[u32Index]) != 0)
+        {
+            if (u32Spin < CONCURRENT_HASHTABLE_WAIT_SPIN)
+            {
+                jf_atomic_cpuRelax();
+                u32Spin ++;
+            }
+            else
+            {
+                _yieldConcurrentHashtable();
+            }
+        }
+    }
+
+    jf_mutex_release(&pijch->ijch_jmReclaim);
+}
+
+static void _freeConcurrentHashtableRetiredList(
+    internal_concurrent_hashtable_t * pijch, concurrent_hashtable_node_t * pchn)
+{
+    concurrent_hashtable_node_t * pchnNext = NULL;
+
+    for (; pchn != NULL; pchn = pchnNext)
+    {
+        pchnNext = pchn->chn_pchnRetireNext;
+        if (pchn->chn_bFreeEntry)
+            pijch->ijch_fnFreeEntry(&pchn->chn_pEntry);
+        jf_jiukun_freeMemory((void **)&pchn);
+    }
+}
+
+static u32 _reclaimConcurrentHashtable(internal_concurrent_hashtable_t * pijch)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    concurrent_hashtable_node_t * pchn = NULL;
+
+    /*Only the nodes retired before the epoch is flipped are freed.*/
+    jf_mutex_acquire(&pijch->ijch_jmRetire);
+    pchn = pijch->ijch_pchnRetired;
+    pijch->ijch_pchnRetired = NULL;
+    pijch->ijch_u32NumOfRetired = 0;
+    jf_mutex_release(&pijch->ijch_jmRetire);
+
+    if (pchn != NULL)
+    {
+        _waitForConcurrentHashtableReader(pijch);
+        _freeConcurrentHashtableRetiredList(pijch, pchn);
+    }
+
+    return u32Ret;
+}
+
+/** Add the node removed from table to retired list, the stripe lock should not be held.
+ */
+static void _retireConcurrentHashtableNode(
+    internal_concurrent_hashtable_t * pijch, concurrent_hashtable_node_t * pchn)
+{
+    boolean_t bReclaim = FALSE;
+
+    pchn->chn_bFreeEntry = TRUE;
+
+    jf_mutex_acquire(&pijch->ijch_jmRetire);
+    pchn->chn_pchnRetireNext = pijch->ijch_pchnRetired;
+    pijch->ijch_pchnRetired = pchn;
+    pijch->ijch_u32NumOfRetired ++;
+    if (pijch->ijch_u32NumOfRetired >= CONCURRENT_HASHTABLE_RECLAIM_THRESHOLD)
+        bReclaim = TRUE;
+    jf_mutex_release(&pijch->ijch_jmRetire);
+
+    if (bReclaim)
+        _reclaimConcurrentHashtable(pijch);
+}
+
+static void _lockAllConcurrentHashtableStripe(internal_concurrent_hashtable_t * pijch)
+{
+    u32 u32Index = 0;
+
+    for (u32Index = 0; u32Index < CONCURRENT_HASHTABLE_NUM_OF_STRIPE; u32Index ++)
+        jf_mutex_acquire(&pijch->ijch_chsStripe[u32Index].chs_jmLock);
+}
+
+static void _unlockAllConcurrentHashtableStripe(internal_concurrent_hashtable_t * pijch)
+{
+    u32 u32Index = 0;
+
+    for (u32Index = 0; u32Index < CONCURRENT_HASHTABLE_NUM_OF_STRIPE; u32Index ++)
+        jf_mutex_release(&pijch->ijch_chsStripe[u32Index].chs_jmLock);
+}
+
+/** Copy the nodes in the bucket array to the new bucket array.
+ */
+static u32 _copyConcurrentHashtableArray(
+    concurrent_hashtable_array_t * pcha, concurrent_hashtable_array_t * pchaNew)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    concurrent_hashtable_node_t * pchn = NULL, * pchnNew = NULL, ** ppchnBucket = NULL;
+    u32 u32Index = 0;
+
+    for (u32Index = 0; (u32Index < pcha->cha_u32NumOfBucket) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        for (pchn = pcha->cha_ppchnBucket[u32Index]; pchn != NULL; pchn = pchn->chn_pchnNext)
+        {
+            u32Ret = jf_jiukun_allocMemory((void **)&pchnNew, sizeof(*pchnNew));
+            if (u32Ret != JF_ERR_NO_ERROR)
+                break;
+
+            ol_memcpy(pchnNew, pchn, sizeof(*pchnNew));
+
+            ppchnBucket = &pchaNew->cha_ppchnBucket[
+                pchn->chn_u32Hash & (pchaNew->cha_u32NumOfBucket - 1)];
+            pchnNew->chn_pchnNext = *ppchnBucket;
+            *ppchnBucket = pchnNew;
+        }
+    }
+
+    return u32Ret;
+}
+
+/** Double the number of bucket.
+ */
+static u32 _resizeConcurrentHashtable(internal_concurrent_hashtable_t * pijch)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    concurrent_hashtable_array_t * pcha = NULL, * pchaNew = NULL;
+
+    _lockAllConcurrentHashtableStripe(pijch);
+
+    /*Check again, the table may be resized by other thread.*/
+    pcha = pijch->ijch_pchaArray;
+    if ((jf_atomic_loadU32(&pijch->ijch_u32NumOfEntry) > pcha->cha_u32NumOfBucket) &&
+        (pcha->cha_u32NumOfBucket < CONCURRENT_HASHTABLE_MAX_BUCKET))
+    {
+        u32Ret = _allocConcurrentHashtableArray(pcha->cha_u32NumOfBucket * 2, &pchaNew);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _copyConcurrentHashtableArray(pcha, pchaNew);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            jf_atomic_storePtr((void **)&pijch->ijch_pchaArray, pchaNew);
+        else if (pchaNew != NULL)
+            _freeConcurrentHashtableArray(pijch, &pchaNew, FALSE);
+    }
+    else
+    {
+        pcha = NULL;
+    }
+
+    _unlockAllConcurrentHashtableStripe(pijch);
+
+    /*Free the old array after the readers which may use it have ended.*/
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pcha != NULL))
+    {
+        _waitForConcurrentHashtableReader(pijch);
+        _freeConcurrentHashtableArray(pijch, &pcha, FALSE);
+    }
+
+    return u32Ret;
+}
+
+/** Insert or overwrite the entry.
+ */
+static u32 _putConcurrentHashtableEntry(
+    internal_concurrent_hashtable_t * pijch, void * pEntry, boolean_t bOverwrite)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    concurrent_hashtable_node_t * pchn = NULL, * pchnOld = NULL, ** ppchn = NULL;
+    concurrent_hashtable_array_t * pcha = NULL;
+    u32 u32Hash = _hashConcurrentHashtableKey(pijch, pijch->ijch_fnGetKeyFromEntry(pEntry));
+    jf_mutex_t * pjm = _getConcurrentHashtableStripeLock(pijch, u32Hash);
+    boolean_t bResize = FALSE;
+
+    /*Allocate the node before locking.*/
+    u32Ret = jf_jiukun_allocMemory((void **)&pchn, sizeof(*pchn));
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    ol_bzero(pchn, sizeof(*pchn));
+    pchn->chn_pEntry = pEntry;
+    pchn->chn_u32Hash = u32Hash;
+
+    jf_mutex_acquire(pjm);
+
+    /*The array is not changed as the stripe lock is held.*/
+    pcha = pijch->ijch_pchaArray;
+    ppchn = _findConcurrentHashtableNode(
+        pijch, pcha, u32Hash, pijch->ijch_fnGetKeyFromEntry(pEntry));
+    pchnOld = *ppchn;
+
+    if ((pchnOld != NULL) && ! bOverwrite)
+    {
+        u32Ret = JF_ERR_HASH_ENTRY_ALREADY_EXIST;
+    }
+    else
+    {
+        /*Replace the old node or append to the bucket, the node is published by release store.*/
+        if (pchnOld != NULL)
+            pchn->chn_pchnNext = pchnOld->chn_pchnNext;
+        jf_atomic_storePtr((void **)ppchn, pchn);
+
+        if ((pchnOld == NULL) &&
+            (jf_atomic_fetchAddU32(&pijch->ijch_u32NumOfEntry, 1) + 1 > pcha->cha_u32NumOfBucket) &&
+            (pcha->cha_u32NumOfBucket < CONCURRENT_HASHTABLE_MAX_BUCKET))
+            bResize = TRUE;
+    }
+
+    jf_mutex_release(pjm);
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+        jf_jiukun_freeMemory((void **)&pchn);
+    else if (pchnOld != NULL)
+        _retireConcurrentHashtableNode(pijch, pchnOld);
+
+    /*Failure of resizing is ignored, the entry is inserted.*/
+    if (bResize)
+        _resizeConcurrentHashtable(pijch);
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_concurrent_hashtable_create(
+    jf_concurrent_hashtable_t ** ppjch, jf_concurrent_hashtable_create_param_t * pjchcp)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_concurrent_hashtable_t * pijch = NULL;
+    u32 u32NumOfBucket = CONCURRENT_HASHTABLE_MIN_BUCKET, u32Index = 0;
+
+    assert((ppjch != NULL) && (pjchcp != NULL));
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pijch, sizeof(*pijch));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pijch, sizeof(*pijch));
+
+        pijch->ijch_fnCmpKeys = pjchcp->jchcp_fnCmpKeys ?
+            pjchcp->jchcp_fnCmpKeys : _default_fnChtCmpKeys;
+        pijch->ijch_fnHashKey = pjchcp->jchcp_fnHashKey ?
+            pjchcp->jchcp_fnHashKey : _default_fnChtHashKey;
+        pijch->ijch_fnGetKeyFromEntry = pjchcp->jchcp_fnGetKeyFromEntry ?
+            pjchcp->jchcp_fnGetKeyFromEntry : _default_fnChtGetKeyFromEntry;
+        pijch->ijch_fnFreeEntry = pjchcp->jchcp_fnFreeEntry ?
+            pjchcp->jchcp_fnFreeEntry : _default_fnChtFreeEntry;
+
+        for (u32Index = 0; u32Index < CONCURRENT_HASHTABLE_NUM_OF_STRIPE; u32Index ++)
+            jf_mutex_init(&pijch->ijch_chsStripe[u32Index].chs_jmLock);
+        jf_mutex_init(&pijch->ijch_jmRetire);
+        jf_mutex_init(&pijch->ijch_jmReclaim);
+
+        while ((u32NumOfBucket < pjchcp->jchcp_u32MinSize) &&
+               (u32NumOfBucket < CONCURRENT_HASHTABLE_MAX_BUCKET))
+            u32NumOfBucket *= 2;
+
+        u32Ret = _allocConcurrentHashtableArray(u32NumOfBucket, &pijch->ijch_pchaArray);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        *ppjch = pijch;
+    else if (pijch != NULL)
+        jf_concurrent_hashtable_destroy((jf_concurrent_hashtable_t **)&pijch);
+
+    return u32Ret;
+}
+
+u32 jf_concurrent_hashtable_destroy(jf_concurrent_hashtable_t ** ppjch)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_concurrent_hashtable_t * pijch = NULL;
+    u32 u32Index = 0;
+
+    assert((ppjch != NULL) && (*ppjch != NULL));
+
+    pijch = (internal_concurrent_hashtable_t *) *ppjch;
+
+    _freeConcurrentHashtableRetiredList(pijch, pijch->ijch_pchnRetired);
+
+    if (pijch->ijch_pchaArray != NULL)
+        _freeConcurrentHashtableArray(pijch, &pijch->ijch_pchaArray, TRUE);
+
+    for (u32Index = 0; u32Index < CONCURRENT_HASHTABLE_NUM_OF_STRIPE; u32Index ++)
+        jf_mutex_fini(&pijch->ijch_chsStripe[u32Index].chs_jmLock);
+    jf_mutex_fini(&pijch->ijch_jmRetire);
+    jf_mutex_fini(&pijch->ijch_jmReclaim);
+
+    jf_jiukun_freeMemory(ppjch);
+
+    return u32Ret;
+}
+
+u32 jf_concurrent_hashtable_insertEntry(jf_concurrent_hashtable_t * pjch, void * pEntry)
+{
+    return _putConcurrentHashtableEntry(pjch, pEntry, FALSE);
+}
+
+u32 jf_concurrent_hashtable_overwriteEntry(jf_concurrent_hashtable_t * pjch, void * pEntry)
+{
+    return _putConcurrentHashtableEntry(pjch, pEntry, TRUE);
+}
+
+u32 jf_concurrent_hashtable_removeEntry(jf_concurrent_hashtable_t * pjch, void * pKey)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_concurrent_hashtable_t * pijch = (internal_concurrent_hashtable_t *)pjch;
+    concurrent_hashtable_node_t * pchn = NULL, ** ppchn = NULL;
+    u32 u32Hash = _hashConcurrentHashtableKey(pijch, pKey);
+    jf_mutex_t * pjm = _getConcurrentHashtableStripeLock(pijch, u32Hash);
+
+    jf_mutex_acquire(pjm);
+
+    ppchn = _findConcurrentHashtableNode(pijch, pijch->ijch_pchaArray, u32Hash, pKey);
+    pchn = *ppchn;
+    if (pchn != NULL)
+    {
+        /*Unlink the node, the next pointer of the node is kept for the readers.*/
+        jf_atomic_storePtr((void **)ppchn, pchn->chn_pchnNext);
+        jf_atomic_fetchAddU32(&pijch->ijch_u32NumOfEntry, (u32)-1);
+    }
+    else
+    {
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+    }
+
+    jf_mutex_release(pjm);
+
+    if (pchn != NULL)
+        _retireConcurrentHashtableNode(pijch, pchn);
+
+    return u32Ret;
+}
+
+void jf_concurrent_hashtable_beginRead(
+    jf_concurrent_hashtable_t * pjch, jf_concurrent_hashtable_reader_t * pReader)
+{
+    internal_concurrent_hashtable_t * pijch = (internal_concurrent_hashtable_t *)pjch;
+    concurrent_hashtable_reader_slot_t * pchrs = NULL;
+    u32 u32Index = 0;
+
+    pReader->jchr_u32Slot = _getConcurrentHashtableReaderSlot();
+    pchrs = &pijch->ijch_chrsReader[pReader->jchr_u32Slot];
+
+    for ( ; ; )
+    {
+        u32Index = jf_atomic_loadU32(&pijch->ijch_u32Epoch) & 1;
+        jf_atomic_fetchAddU32(&pchrs->chrs_u32Count[u32Index], 1);
+        jf_atomic_fence();
+
+        /*If the epoch is flipped, the reclaimer may have checked the counter, try again.*/
+        if ((jf_atomic_loadU32(&pijch->ijch_u32Epoch) & 1) == u32Index)
+            break;
+
+        jf_atomic_fetchAddU32(&pchrs->chrs_u32Count[u32Index], (u32)-1);
+    }
+
+    pReader->jchr_u32Index = u32Index;
+}
+
+void jf_concurrent_hashtable_endRead(
+    jf_concurrent_hashtable_t * pjch, jf_concurrent_hashtable_reader_t * pReader)
+{
+    internal_concurrent_hashtable_t * pijch = (internal_concurrent_hashtable_t *)pjch;
+
+    jf_atomic_fetchAddU32(
+        &pijch->ijch_chrsReader[pReader->jchr_u32Slot].chrs_u32Count[pReader->jchr_u32Index],
+        (u32)-1);
+}
+
+u32 jf_concurrent_hashtable_getEntry(
+    jf_concurrent_hashtable_t * pjch, void * pKey, void ** ppEntry)
+{
+    u32 u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+    internal_concurrent_hashtable_t * pijch = (internal_concurrent_hashtable_t *)pjch;
+    u32 u32Hash = _hashConcurrentHashtableKey(pijch, pKey);
+    concurrent_hashtable_array_t * pcha = jf_atomic_loadPtr((void **)&pijch->ijch_pchaArray);
+    concurrent_hashtable_node_t * pchn = jf_atomic_loadPtr(
+        (void **)&pcha->cha_ppchnBucket[u32Hash & (pcha->cha_u32NumOfBucket - 1)]);
+
+    while (pchn != NULL)
+    {
+        if ((pchn->chn_u32Hash == u32Hash) &&
+            (pijch->ijch_fnCmpKeys(pKey, pijch->ijch_fnGetKeyFromEntry(pchn->chn_pEntry)) == 0))
+        {
+            *ppEntry = pchn->chn_pEntry;
+            u32Ret = JF_ERR_NO_ERROR;
+            break;
+        }
+
+        pchn = jf_atomic_loadPtr((void **)&pchn->chn_pchnNext);
+    }
+
+    return u32Ret;
+}
+
+boolean_t jf_concurrent_hashtable_isKeyInTable(jf_concurrent_hashtable_t * pjch, void * pKey)
+{
+    jf_concurrent_hashtable_reader_t jchr;
+    void * pEntry = NULL;
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    jf_concurrent_hashtable_beginRead(pjch, &jchr);
+    u32Ret = jf_concurrent_hashtable_getEntry(pjch, pKey, &pEntry);
+    jf_concurrent_hashtable_endRead(pjch, &jchr);
+
+    return (u32Ret == JF_ERR_NO_ERROR) ? TRUE : FALSE;
+}
+
+u32 jf_concurrent_hashtable_getSize(jf_concurrent_hashtable_t * pjch)
+{
+    internal_concurrent_hashtable_t * pijch = (internal_concurrent_hashtable_t *)pjch;
+
+    return jf_atomic_loadU32(&pijch->ijch_u32NumOfEntry);
+}
+
+u32 jf_concurrent_hashtable_reclaim(jf_concurrent_hashtable_t * pjch)
+{
+    return _reclaimConcurrentHashtable((internal_concurrent_hashtable_t *)pjch);
+}
+
+/*------------------------------------------------------------------------------------------------*/
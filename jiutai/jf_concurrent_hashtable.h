@@ -0,0 +1,206 @@
+/**
+ *  @file jf_concurrent_hashtable.h
+ *
+ *  @brief Header file for concurrent hash table common object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_concurrent_hashtable object.
+ *  -# The hash table can be accessed by multiple threads without external lock. The writers
+ *   (insert, overwrite and remove) are serialized by striped locks, writers to different stripes
+ *   run in parallel. The readers don't take any lock.
+ *  -# The reader must enclose the search and the access to the returned entry with
+ *   jf_concurrent_hashtable_beginRead() and jf_concurrent_hashtable_endRead(). The removed or
+ *   overwritten entry is freed after all readers which may see it have ended, the scheme is
+ *   similar to RCU with epoch based reclamation.
+ *  -# The read section should be short, the writer may wait for the readers when it reclaims the
+ *   removed entries.
+ *  -# The callback functions have the same definitions as jf_hashtable.
+ *  -# Link with jf_jiukun library for memory allocation, jf_mutex object for lock.
+ */
+
+#ifndef JIUTAI_CONCURRENT_HASHTABLE_H
+#define JIUTAI_CONCURRENT_HASHTABLE_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_hashtable.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Define the concurrent hash table data type.
+ */
+typedef void  jf_concurrent_hashtable_t;
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the parameter data type for creating concurrent hash table.
+ */
+typedef struct
+{
+    /**Minimal number of entry by estimation.*/
+    u32 jchcp_u32MinSize;
+    u32 jchcp_u32Reserved;
+    /**Callback function to compare key.*/
+    jf_hashtable_fnCmpKeys_t jchcp_fnCmpKeys;
+    /**Callback function to hash key.*/
+    jf_hashtable_fnHashKey_t jchcp_fnHashKey;
+    /**Callback function to get key from entry.*/
+    jf_hashtable_fnGetKeyFromEntry_t jchcp_fnGetKeyFromEntry;
+    /**Callback function of deallocator to free the entry.*/
+    jf_hashtable_fnFreeEntry_t jchcp_fnFreeEntry;
+    u32 jchcp_u32Reserved2[4];
+} jf_concurrent_hashtable_create_param_t;
+
+/** Define the read section data type of concurrent hash table.
+ */
+typedef struct
+{
+    /**Index of the reader slot.*/
+    u32 jchr_u32Slot;
+    /**Index of the epoch counter.*/
+    u32 jchr_u32Index;
+} jf_concurrent_hashtable_reader_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Create concurrent hash table.
+ *
+ *  @param ppjch [out] The concurrent hash table to be created and returned.
+ *  @param pjchcp [in] The parameter for creating concurrent hash table.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_concurrent_hashtable_create(
+    jf_concurrent_hashtable_t ** ppjch, jf_concurrent_hashtable_create_param_t * pjchcp);
+
+/** Destroy the concurrent hash table, all entries are freed.
+ *
+ *  @note
+ *  -# No thread should access the table when it's destroyed.
+ *
+ *  @param ppjch [in/out] The concurrent hash table to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_concurrent_hashtable_destroy(jf_concurrent_hashtable_t ** ppjch);
+
+/** Insert an entry into the concurrent hash table.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pEntry [in] The entry to be inserted.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_HASH_ENTRY_ALREADY_EXIST The entry with the same key is existing, the new entry
+ *   is not inserted.
+ */
+u32 jf_concurrent_hashtable_insertEntry(jf_concurrent_hashtable_t * pjch, void * pEntry);
+
+/** Overwrite the entry with the same key, the entry is inserted if the key is not existing.
+ *
+ *  @note
+ *  -# The old entry is freed after all readers which may see it have ended.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pEntry [in] The entry to be overwritten.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_concurrent_hashtable_overwriteEntry(jf_concurrent_hashtable_t * pjch, void * pEntry);
+
+/** Remove the entry with the key.
+ *
+ *  @note
+ *  -# The entry is freed after all readers which may see it have ended.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pKey [in] The key of the entry to be removed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_HASH_ENTRY_NOT_FOUND Entry is not found.
+ */
+u32 jf_concurrent_hashtable_removeEntry(jf_concurrent_hashtable_t * pjch, void * pKey);
+
+/** Begin the read section.
+ *
+ *  @note
+ *  -# The read section cannot be nested, the writer routines cannot be called in read section.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pReader [out] The read section.
+ *
+ *  @return Void.
+ */
+void jf_concurrent_hashtable_beginRead(
+    jf_concurrent_hashtable_t * pjch, jf_concurrent_hashtable_reader_t * pReader);
+
+/** End the read section, the entry got in the read section should not be accessed any more.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pReader [in] The read section.
+ *
+ *  @return Void.
+ */
+void jf_concurrent_hashtable_endRead(
+    jf_concurrent_hashtable_t * pjch, jf_concurrent_hashtable_reader_t * pReader);
+
+/** Search for entry with the key, the routine must be called in read section.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pKey [in] The key.
+ *  @param ppEntry [out] The entry found, it's valid until the read section ends.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_HASH_ENTRY_NOT_FOUND Entry is not found.
+ */
+u32 jf_concurrent_hashtable_getEntry(
+    jf_concurrent_hashtable_t * pjch, void * pKey, void ** ppEntry);
+
+/** Check if the key is in the concurrent hash table, the routine has its own read section.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *  @param pKey [in] The key.
+ *
+ *  @return The status.
+ *  @retval TRUE The key is in hash table.
+ *  @retval FALSE The key is not in hash table.
+ */
+boolean_t jf_concurrent_hashtable_isKeyInTable(jf_concurrent_hashtable_t * pjch, void * pKey);
+
+/** Return the number of entry in the concurrent hash table.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *
+ *  @return The number of entry.
+ */
+u32 jf_concurrent_hashtable_getSize(jf_concurrent_hashtable_t * pjch);
+
+/** Wait for the readers and free the removed entries.
+ *
+ *  @note
+ *  -# The removed entries are reclaimed automatically when there are enough of them, the routine
+ *   can be called to reclaim them immediately.
+ *  -# The routine cannot be called in read section.
+ *
+ *  @param pjch [in] The concurrent hash table.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_concurrent_hashtable_reclaim(jf_concurrent_hashtable_t * pjch);
+
+#endif /*JIUTAI_CONCURRENT_HASHTABLE_H*/
+
+/*------------------------------------------------------------------------------------------------*/
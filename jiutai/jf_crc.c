@@ -6,7 +6,14 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The CRC register used internally is the reflected CRC without the final XOR. The byte order
+ *   conversion and the final XOR are done only when the result is returned.
+ *  -# If the CPU supports SSE4.2, the crc32 instruction processes 8 bytes at a time. Large buffer
+ *   is split into 3 streams which are calculated at the same time to hide the latency of the
+ *   instruction, the CRCs of the streams are combined by multiplying with x^(8n) modulo the
+ *   polynomial. The multiplication is done with PCLMULQDQ if the CPU supports it.
+ *  -# Otherwise slice-by-8 tables are used. The tables are generated from the 256-entry table when
+ *   they are used for the first time, the byte-wise table lookup is used before they are ready.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -16,9 +23,17 @@
 
 #include "jf_basic.h"
 #include "jf_crc.h"
+#include "jf_atomic.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    #include <immintrin.h>
+    #define CRC_X86_DISPATCH
+#endif
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** The table for byte-wise lookup, it's the first table of slice-by-8.
+ */
 static u32 ls_u32CrcTable[256] =
 {
     0x00000000L, 0xF26B8303L, 0xE13B70F7L, 0x1350F3F4L,
@@ -91,8 +106,358 @@ static u32 ls_u32CrcTable[256] =
 #define TB_INIT_REFLECTED          (0xFFFFFFFF)
 #define TB_XOROT                   (0xFFFFFFFF)
 
+/** The reflected CRC32C polynomial.
+ */
+#define CRC32C_POLY_REFLECTED      (0x82F63B78)
+
+/** The polynomial x^0 in reflected representation.
+ */
+#define CRC32C_X0                  (0x80000000)
+
+/** Length of each stream when large buffer is split into 3 streams.
+ */
+#define CRC32C_LONG_BLOCK          (8192)
+
+/** Length of each stream when medium buffer is split into 3 streams.
+ */
+#define CRC32C_SHORT_BLOCK         (256)
+
+/** The initialization state.
+ */
+#define CRC32C_STATE_NONE          (0)
+#define CRC32C_STATE_INITIALIZING  (1)
+#define CRC32C_STATE_READY         (2)
+
+/** The CPU features.
+ */
+#define CRC32C_CPU_FEATURE_SSE42   (0x1)
+#define CRC32C_CPU_FEATURE_PCLMUL  (0x2)
+
+/** Index of the constants used to combine the CRCs of streams.
+ */
+enum crc32c_shift_index
+{
+    CRC32C_SHIFT_LONG = 0,
+    CRC32C_SHIFT_LONG2,
+    CRC32C_SHIFT_SHORT,
+    CRC32C_SHIFT_SHORT2,
+    CRC32C_SHIFT_MAX,
+};
+
+/** Slice-by-8 tables, table 0 is ls_u32CrcTable.
+ */
+static u32 ls_u32CrcSliceTable[7][256];
+
+/** x^(8n) modulo the polynomial, n is the length of stream and double of the length.
+ */
+static u32 ls_u32CrcShift[CRC32C_SHIFT_MAX];
+
+/** x^(8n-33) modulo the polynomial, used with PCLMULQDQ and crc32 instruction.
+ */
+static u32 ls_u32CrcShiftClmul[CRC32C_SHIFT_MAX];
+
+#if defined(CRC_X86_DISPATCH)
+/** The CPU features.
+ */
+static u32 ls_u32CrcCpuFeature;
+#endif
+
+/** The initialization state, the tables and constants are valid only if it's ready.
+ */
+static u32 ls_u32CrcState = CRC32C_STATE_NONE;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+/** Multiply 2 polynomials modulo the CRC32C polynomial, all in reflected representation.
+ */
+static u32 _multiplyCrc32cModP(u32 u32A, u32 u32B)
+{
+    u32 u32Mask = CRC32C_X0, u32Product = 0;
+
+    while (u32Mask != 0)
+    {
+        if (u32A & u32Mask)
+            u32Product ^= u32B;
+
+        u32Mask >>= 1;
+        u32B = (u32B & 1) ? (u32B >> 1) ^ CRC32C_POLY_REFLECTED : u32B >> 1;
+    }
+
+    return u32Product;
+}
+
+/** Get x^n modulo the CRC32C polynomial in reflected representation.
+ */
+static u32 _getCrc32cXPowerModP(u64 u64Power)
+{
+    /*x^1 in reflected representation.*/
+    u32 u32Base = CRC32C_X0 >> 1, u32Result = CRC32C_X0;
+
+    while (u64Power != 0)
+    {
+        if (u64Power & 1)
+            u32Result = _multiplyCrc32cModP(u32Result, u32Base);
+
+        u32Base = _multiplyCrc32cModP(u32Base, u32Base);
+        u64Power >>= 1;
+    }
+
+    return u32Result;
+}
+
+/** Shift the CRC register as if "u64Len" zero bytes are appended.
+ */
+static inline u32 _shiftCrc32c(u32 u32Crc, u64 u64Len)
+{
+    return _multiplyCrc32cModP(u32Crc, _getCrc32cXPowerModP(u64Len * 8));
+}
+
+/** Calculate with byte-wise table lookup.
+ */
+static u32 _crc32cByte(u32 u32Crc, const u8 * pu8Data, u32 u32Len)
+{
+    while (u32Len-- > 0)
+        u32Crc = ls_u32CrcTable[(u32Crc ^ *pu8Data++) & 0xFFL] ^ (u32Crc >> 8);
+
+    return u32Crc;
+}
+
+/** Calculate with slice-by-8 tables.
+ */
+static u32 _crc32cSlice8(u32 u32Crc, const u8 * pu8Data, u32 u32Len)
+{
+    u32 u32Low, u32High;
+
+    while (u32Len >= 8)
+    {
+        u32Low = u32Crc ^ ((u32)pu8Data[0] | ((u32)pu8Data[1] << 8) |
+                           ((u32)pu8Data[2] << 16) | ((u32)pu8Data[3] << 24));
+        u32High = (u32)pu8Data[4] | ((u32)pu8Data[5] << 8) | ((u32)pu8Data[6] << 16) |
+            ((u32)pu8Data[7] << 24);
+
+        u32Crc = ls_u32CrcSliceTable[6][u32Low & 0xFF] ^
+            ls_u32CrcSliceTable[5][(u32Low >> 8) & 0xFF] ^
+            ls_u32CrcSliceTable[4][(u32Low >> 16) & 0xFF] ^
+            ls_u32CrcSliceTable[3][u32Low >> 24] ^
+            ls_u32CrcSliceTable[2][u32High & 0xFF] ^
+            ls_u32CrcSliceTable[1][(u32High >> 8) & 0xFF] ^
+            ls_u32CrcSliceTable[0][(u32High >> 16) & 0xFF] ^
+            ls_u32CrcTable[u32High >> 24];
+
+        pu8Data += 8;
+        u32Len -= 8;
+    }
+
+    return _crc32cByte(u32Crc, pu8Data, u32Len);
+}
+
+#if defined(CRC_X86_DISPATCH)
+
+/** Calculate 1 stream with crc32 instruction.
+ */
+__attribute__((target("sse4.2")))
+static u32 _crc32cSse42(u32 u32Crc, const u8 * pu8Data, u32 u32Len)
+{
+    u64 u64Crc = u32Crc, u64Data;
+
+    /*Align the data to 8 bytes.*/
+    while ((u32Len > 0) && (((size_t)pu8Data & 7) != 0))
+    {
+        u64Crc = _mm_crc32_u8((u32)u64Crc, *pu8Data++);
+        u32Len --;
+    }
+
+    while (u32Len >= 8)
+    {
+        ol_memcpy(&u64Data, pu8Data, 8);
+        u64Crc = _mm_crc32_u64(u64Crc, u64Data);
+        pu8Data += 8;
+        u32Len -= 8;
+    }
+
+    while (u32Len-- > 0)
+        u64Crc = _mm_crc32_u8((u32)u64Crc, *pu8Data++);
+
+    return (u32)u64Crc;
+}
+
+/** Shift the CRCs of the first 2 streams with PCLMULQDQ and combine them with the third one.
+ *
+ *  @note
+ *  -# Carry-less multiplication of 2 reflected 32-bit polynomials gives the product multiplied
+ *   by x, crc32 instruction of the product multiplies it by x^32 and reduces it. So the constant
+ *   is x^(8n-33) to shift the CRC by n bytes.
+ */
+__attribute__((target("sse4.2,pclmul")))
+static u32 _combineCrc32cStreamClmul(
+    u32 u32Crc0, u32 u32Crc1, u32 u32Crc2, u32 u32Shift2, u32 u32Shift1)
+{
+    __m128i m0 = _mm_clmulepi64_si128(
+        _mm_cvtsi32_si128((olint_t)u32Crc0), _mm_cvtsi32_si128((olint_t)u32Shift2), 0);
+    __m128i m1 = _mm_clmulepi64_si128(
+        _mm_cvtsi32_si128((olint_t)u32Crc1), _mm_cvtsi32_si128((olint_t)u32Shift1), 0);
+
+    return (u32)_mm_crc32_u64(0, (u64)_mm_cvtsi128_si64(_mm_xor_si128(m0, m1))) ^ u32Crc2;
+}
+
+/** Calculate 3 streams of "u32Block" bytes at the same time.
+ *
+ *  @return The CRC register after the 3 blocks.
+ */
+__attribute__((target("sse4.2")))
+static u32 _crc32cSse42Triple(
+    u32 u32Crc, const u8 * pu8Data, u32 u32Block, u32 u32Shift2, u32 u32Shift1)
+{
+    u64 u64Crc0 = u32Crc, u64Crc1 = 0, u64Crc2 = 0, u64Data0, u64Data1, u64Data2;
+    const u8 * pu8End = pu8Data + u32Block;
+
+    while (pu8Data < pu8End)
+    {
+        ol_memcpy(&u64Data0, pu8Data, 8);
+        ol_memcpy(&u64Data1, pu8Data + u32Block, 8);
+        ol_memcpy(&u64Data2, pu8Data + 2 * u32Block, 8);
+        u64Crc0 = _mm_crc32_u64(u64Crc0, u64Data0);
+        u64Crc1 = _mm_crc32_u64(u64Crc1, u64Data1);
+        u64Crc2 = _mm_crc32_u64(u64Crc2, u64Data2);
+        pu8Data += 8;
+    }
+
+    if (ls_u32CrcCpuFeature & CRC32C_CPU_FEATURE_PCLMUL)
+        return _combineCrc32cStreamClmul(
+            (u32)u64Crc0, (u32)u64Crc1, (u32)u64Crc2, u32Shift2, u32Shift1);
+
+    return _multiplyCrc32cModP((u32)u64Crc0, u32Shift2) ^
+        _multiplyCrc32cModP((u32)u64Crc1, u32Shift1) ^ (u32)u64Crc2;
+}
+
+/** Calculate with crc32 instruction, large buffer is split into 3 streams.
+ */
+static u32 _crc32cHardware(u32 u32Crc, const u8 * pu8Data, u32 u32Len)
+{
+    const u32 * pu32Shift = (ls_u32CrcCpuFeature & CRC32C_CPU_FEATURE_PCLMUL) ?
+        ls_u32CrcShiftClmul : ls_u32CrcShift;
+    u32 u32Align = (8 - ((size_t)pu8Data & 7)) & 7;
+
+    if (u32Len >= 3 * CRC32C_SHORT_BLOCK + u32Align)
+    {
+        u32Crc = _crc32cSse42(u32Crc, pu8Data, u32Align);
+        pu8Data += u32Align;
+        u32Len -= u32Align;
+
+        while (u32Len >= 3 * CRC32C_LONG_BLOCK)
+        {
+            u32Crc = _crc32cSse42Triple(
+                u32Crc, pu8Data, CRC32C_LONG_BLOCK, pu32Shift[CRC32C_SHIFT_LONG2],
+                pu32Shift[CRC32C_SHIFT_LONG]);
+            pu8Data += 3 * CRC32C_LONG_BLOCK;
+            u32Len -= 3 * CRC32C_LONG_BLOCK;
+        }
+
+        while (u32Len >= 3 * CRC32C_SHORT_BLOCK)
+        {
+            u32Crc = _crc32cSse42Triple(
+                u32Crc, pu8Data, CRC32C_SHORT_BLOCK, pu32Shift[CRC32C_SHIFT_SHORT2],
+                pu32Shift[CRC32C_SHIFT_SHORT]);
+            pu8Data += 3 * CRC32C_SHORT_BLOCK;
+            u32Len -= 3 * CRC32C_SHORT_BLOCK;
+        }
+    }
+
+    return _crc32cSse42(u32Crc, pu8Data, u32Len);
+}
+
+#endif
+
+/** Generate the tables and constants, detect the CPU features.
+ *
+ *  @note
+ *  -# Only one thread does the initialization, other threads use the byte-wise lookup until the
+ *   state is ready.
+ *
+ *  @return The status.
+ *  @retval TRUE The tables and constants are ready.
+ *  @retval FALSE The tables and constants are not ready.
+ */
+static boolean_t _initCrc32c(void)
+{
+    u32 u32Table, u32Index, u32Crc;
+
+    if (jf_atomic_loadU32(&ls_u32CrcState) == CRC32C_STATE_READY)
+        return TRUE;
+
+    if (! jf_atomic_casU32(&ls_u32CrcState, CRC32C_STATE_NONE, CRC32C_STATE_INITIALIZING))
+        return FALSE;
+
+    for (u32Index = 0; u32Index < 256; u32Index ++)
+    {
+        u32Crc = ls_u32CrcTable[u32Index];
+        for (u32Table = 0; u32Table < 7; u32Table ++)
+        {
+            u32Crc = (u32Crc >> 8) ^ ls_u32CrcTable[u32Crc & 0xFF];
+            ls_u32CrcSliceTable[u32Table][u32Index] = u32Crc;
+        }
+    }
+
+    ls_u32CrcShift[CRC32C_SHIFT_LONG] = _getCrc32cXPowerModP(8 * CRC32C_LONG_BLOCK);
+    ls_u32CrcShift[CRC32C_SHIFT_LONG2] = _getCrc32cXPowerModP(16 * CRC32C_LONG_BLOCK);
+    ls_u32CrcShift[CRC32C_SHIFT_SHORT] = _getCrc32cXPowerModP(8 * CRC32C_SHORT_BLOCK);
+    ls_u32CrcShift[CRC32C_SHIFT_SHORT2] = _getCrc32cXPowerModP(16 * CRC32C_SHORT_BLOCK);
+
+    ls_u32CrcShiftClmul[CRC32C_SHIFT_LONG] = _getCrc32cXPowerModP(8 * CRC32C_LONG_BLOCK - 33);
+    ls_u32CrcShiftClmul[CRC32C_SHIFT_LONG2] = _getCrc32cXPowerModP(16 * CRC32C_LONG_BLOCK - 33);
+    ls_u32CrcShiftClmul[CRC32C_SHIFT_SHORT] = _getCrc32cXPowerModP(8 * CRC32C_SHORT_BLOCK - 33);
+    ls_u32CrcShiftClmul[CRC32C_SHIFT_SHORT2] = _getCrc32cXPowerModP(16 * CRC32C_SHORT_BLOCK - 33);
+
+#if defined(CRC_X86_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        ls_u32CrcCpuFeature |= CRC32C_CPU_FEATURE_SSE42;
+        if (__builtin_cpu_supports("pclmul"))
+            ls_u32CrcCpuFeature |= CRC32C_CPU_FEATURE_PCLMUL;
+    }
+#endif
+
+    jf_atomic_storeU32(&ls_u32CrcState, CRC32C_STATE_READY);
+
+    return TRUE;
+}
+
+/** Update the CRC register with the data.
+ */
+static u32 _updateCrc32c(u32 u32Crc, const u8 * pu8Data, u32 u32Len)
+{
+    if (! _initCrc32c())
+        return _crc32cByte(u32Crc, pu8Data, u32Len);
+
+#if defined(CRC_X86_DISPATCH)
+    if (ls_u32CrcCpuFeature & CRC32C_CPU_FEATURE_SSE42)
+        return _crc32cHardware(u32Crc, pu8Data, u32Len);
+#endif
+
+    return _crc32cSlice8(u32Crc, pu8Data, u32Len);
+}
+
+/** Get the CRC register from the result of previous calculation.
+ */
+static inline u32 _getCrc32cRegister(u32 u32Result, u32 u32Flags)
+{
+    if (u32Flags & JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER)
+        return u32Result ^ TB_XOROT;
+
+    return ol_htonl(u32Result) ^ TB_XOROT;
+}
+
+/** Convert the CRC register to result.
+ */
+static inline u32 _getCrc32cResult(u32 u32Crc, u32 u32Flags)
+{
+    if (u32Flags & JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER)
+        return u32Crc ^ TB_XOROT;
+
+    return ol_ntohl(u32Crc ^ TB_XOROT);
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 void jf_crc_crc32c(u8 *pu8Data, u32 u32Len, u32 u32Flags, u32 * pu32Result)
@@ -102,15 +467,11 @@ void jf_crc_crc32c(u8 *pu8Data, u32 u32Len, u32 u32Flags, u32 * pu32Result)
     if (u32Flags & JF_CRC_CRC32C_FLAG_INIT_RESULT)
         u32Crc = TB_INIT_REFLECTED;
     else
-        u32Crc = ol_htonl(*pu32Result) ^ TB_XOROT;
+        u32Crc = _getCrc32cRegister(*pu32Result, u32Flags);
 
-    while (u32Len-- > 0)
-        u32Crc = ls_u32CrcTable[(u32Crc ^ *pu8Data++) & 0xFFL] ^ (u32Crc >> 8);
+    u32Crc = _updateCrc32c(u32Crc, pu8Data, u32Len);
 
-    if (u32Flags & JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER)
-        *pu32Result = (u32Crc ^ TB_XOROT);
-    else
-        *pu32Result = ol_ntohl(u32Crc ^ TB_XOROT);
+    *pu32Result = _getCrc32cResult(u32Crc, u32Flags);
 }
 
 void jf_crc_crc32cVec(
@@ -121,14 +482,30 @@ void jf_crc_crc32cVec(
 
     assert((pjccv != NULL) && (u32Count > 0));
 
-    jf_crc_crc32c(pjccv[0].jccv_pu8Buffer, pjccv[0].jccv_u32Len, u32Flags, &u32Crc);
-    u32Flags &= ~JF_CRC_CRC32C_FLAG_INIT_RESULT;
+    if (u32Flags & JF_CRC_CRC32C_FLAG_INIT_RESULT)
+        u32Crc = TB_INIT_REFLECTED;
+    else
+        u32Crc = _getCrc32cRegister(*pu32Result, u32Flags);
 
-    for (index = 1; index < u32Count; index ++)
+    /*The register is passed from segment to segment, no conversion in between.*/
+    for (index = 0; index < u32Count; index ++)
     {
-        jf_crc_crc32c(pjccv[index].jccv_pu8Buffer, pjccv[index].jccv_u32Len, u32Flags, &u32Crc);
+        u32Crc = _updateCrc32c(u32Crc, pjccv[index].jccv_pu8Buffer, pjccv[index].jccv_u32Len);
     }
 
+    *pu32Result = _getCrc32cResult(u32Crc, u32Flags);
+}
+
+void jf_crc_crc32cCombine(u32 u32Crc1, u32 u32Crc2, u64 u64Len2, u32 u32Flags, u32 * pu32Result)
+{
+    u32 u32Crc;
+
+    /*The initial value and the final XOR of the 2 CRCs cancel each other.*/
+    if (u32Flags & JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER)
+        u32Crc = _shiftCrc32c(u32Crc1, u64Len2) ^ u32Crc2;
+    else
+        u32Crc = ol_ntohl(_shiftCrc32c(ol_htonl(u32Crc1), u64Len2) ^ ol_htonl(u32Crc2));
+
     *pu32Result = u32Crc;
 }
 
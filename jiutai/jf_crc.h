@@ -11,6 +11,8 @@
  *  -# Cyclic redundancy check (CRC) is a type of function that takes as input a data stream of
  *   any length, and produces as output a value of a certain space, commonly a 32-bit integer.
  *  -# Link with ws2_32.lib for byte ordering on Windows platform.
+ *  -# The crc32 instruction of SSE4.2 is used if the CPU supports it, otherwise slice-by-8 table
+ *   lookup is used.
  */
 
 #ifndef JIUTAI_CRC_H
@@ -47,6 +49,10 @@ typedef struct
 /* --- functional routines ---------------------------------------------------------------------- */
 
 /** Calculate the crc32c.
+ *
+ *  @note
+ *  -# If JF_CRC_CRC32C_FLAG_INIT_RESULT is not set, the crc32c continues from the result, the
+ *   result must be returned with the same byte order flag.
  *
  *  @param pu8Data [in] The data to be calculated.
  *  @param u32Len [in] The length of the data.
@@ -58,6 +64,9 @@ typedef struct
 void jf_crc_crc32c(u8 * pu8Data, u32 u32Len, u32 u32Flags, u32 * pu32Result);
 
 /** Calculate the crc32c vector.
+ *
+ *  @note
+ *  -# The result is the same as calculating the crc32c of the concatenated buffers.
  *
  *  @param pjccv [in] The data vector to be calculated.
  *  @param u32Count [in] Number of entry in the vector.
@@ -68,6 +77,24 @@ void jf_crc_crc32c(u8 * pu8Data, u32 u32Len, u32 u32Flags, u32 * pu32Result);
  */
 void jf_crc_crc32cVec(jf_crc_crc32c_vec_t * pjccv, u32 u32Count, u32 u32Flags, u32 * pu32Result);
 
+/** Combine the crc32c of 2 segments which are calculated independently.
+ *
+ *  @note
+ *  -# Both CRCs must be calculated with JF_CRC_CRC32C_FLAG_INIT_RESULT and the same byte order.
+ *  -# The result is the crc32c of the first segment followed by the second segment. The
+ *   segments can be calculated in different threads and combined later.
+ *
+ *  @param u32Crc1 [in] The crc32c of the first segment.
+ *  @param u32Crc2 [in] The crc32c of the second segment.
+ *  @param u64Len2 [in] The length of the second segment.
+ *  @param u32Flags [in] The flag for the byte order of CRCs, JF_CRC_CRC32C_FLAG_INIT_RESULT is
+ *   ignored.
+ *  @param pu32Result [out] The result.
+ *
+ *  @return Void.
+ */
+void jf_crc_crc32cCombine(u32 u32Crc1, u32 u32Crc2, u64 u64Len2, u32 u32Flags, u32 * pu32Result);
+
 #endif /*JIUTAI_CRC_H*/
 
 /*------------------------------------------------------------------------------------------------*/
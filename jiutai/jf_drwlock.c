@@ -0,0 +1,307 @@
+/**
+ *  @file jf_drwlock.c
+ *
+ *  @brief The implementation file for distributed read-write lock object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The reader increases the counter of the CPU, then checks the writer state. If a writer is
+ *   there, the reader decreases the same counter and waits. The writer sets the writer state, then
+ *   sums up the counters. Since both sides use sequentially consistent operations, either the
+ *   reader sees the writer or the writer sees the reader.
+ *  -# The read lock may be released on another CPU, the counter of a slot can be negative, only the
+ *   sum of all counters is meaningful.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(LINUX)
+    #include <limits.h>
+    #include <sched.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_drwlock.h"
+#include "jf_atomic.h"
+#include "jf_jiukun.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** The writer state of the lock.
+ */
+#define DRWLOCK_WRITER_UNLOCKED             (0)
+#define DRWLOCK_WRITER_LOCKED               (1)
+#define DRWLOCK_WRITER_CONTENDED            (2)
+
+/** Number of spins before the writer yields the CPU when waiting for readers.
+ */
+#define DRWLOCK_WRITER_SPIN_COUNT           (128)
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+/** Get number of reader slots, it's number of CPUs rounded up to power of 2.
+ */
+static u32 _getDrwlockNumOfSlot(void)
+{
+    u32 u32NumOfCpu = 1, u32NumOfSlot = 1;
+#if defined(LINUX)
+    long lRet = sysconf(_SC_NPROCESSORS_CONF);
+
+    if (lRet > 0)
+        u32NumOfCpu = (u32)lRet;
+#elif defined(WINDOWS)
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    u32NumOfCpu = (u32)si.dwNumberOfProcessors;
+#endif
+
+    while ((u32NumOfSlot < u32NumOfCpu) && (u32NumOfSlot < JF_DRWLOCK_MAX_READER_SLOT))
+        u32NumOfSlot <<= 1;
+
+    return u32NumOfSlot;
+}
+
+/** Get the reader counter of the CPU the calling thread runs on.
+ */
+static inline u32 * _getDrwlockReaderCount(jf_drwlock_t * pLock)
+{
+    u32 u32Cpu = 0;
+#if defined(LINUX)
+    olint_t nCpu = sched_getcpu();
+
+    if (nCpu > 0)
+        u32Cpu = (u32)nCpu;
+#elif defined(WINDOWS)
+    u32Cpu = (u32)GetCurrentProcessorNumber();
+#endif
+
+    return (u32 *)(pLock->jd_pu8Slot +
+                   (u32Cpu & (pLock->jd_u32NumOfSlot - 1)) * JF_ATOMIC_CACHE_LINE_SIZE);
+}
+
+/** Wait on the writer state if its value is still the expected value.
+ */
+static void _waitDrwlockWriter(jf_drwlock_t * pLock, u32 u32Value)
+{
+#if defined(LINUX)
+    syscall(SYS_futex, &pLock->jd_u32Writer, FUTEX_WAIT_PRIVATE, u32Value, NULL, NULL, 0);
+#elif defined(WINDOWS)
+    WaitOnAddress(&pLock->jd_u32Writer, &u32Value, sizeof(u32), INFINITE);
+#endif
+}
+
+/** Wake up all threads waiting on the writer state.
+ */
+static void _wakeDrwlockWriter(jf_drwlock_t * pLock)
+{
+#if defined(LINUX)
+    syscall(SYS_futex, &pLock->jd_u32Writer, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#elif defined(WINDOWS)
+    WakeByAddressAll(&pLock->jd_u32Writer);
+#endif
+}
+
+/** Mark the writer state as contended and wait until it's changed.
+ */
+static void _waitDrwlockUnlocked(jf_drwlock_t * pLock)
+{
+    u32 u32Writer = jf_atomic_loadU32(&pLock->jd_u32Writer);
+
+    if (u32Writer == DRWLOCK_WRITER_UNLOCKED)
+        return;
+
+    if ((u32Writer == DRWLOCK_WRITER_CONTENDED) ||
+        jf_atomic_casU32(&pLock->jd_u32Writer, DRWLOCK_WRITER_LOCKED, DRWLOCK_WRITER_CONTENDED))
+        _waitDrwlockWriter(pLock, DRWLOCK_WRITER_CONTENDED);
+}
+
+/** Register the calling thread as reader if there is no writer.
+ *
+ *  @return The status.
+ *  @retval TRUE The read lock is acquired.
+ *  @retval FALSE A writer holds or waits for the lock.
+ */
+static inline boolean_t _tryEnterDrwlockRead(jf_drwlock_t * pLock)
+{
+    u32 * pu32Count = _getDrwlockReaderCount(pLock);
+
+    jf_atomic_fetchAddU32(pu32Count, 1);
+
+    if (jf_atomic_loadU32(&pLock->jd_u32Writer) == DRWLOCK_WRITER_UNLOCKED)
+        return TRUE;
+
+    /*Back off with the same counter, the writer never sees the sum less than the holders.*/
+    jf_atomic_fetchAddU32(pu32Count, (u32)-1);
+
+    return FALSE;
+}
+
+/** Get the sum of all reader counters.
+ */
+static u32 _sumDrwlockReader(jf_drwlock_t * pLock)
+{
+    u32 u32Sum = 0, u32Index;
+
+    for (u32Index = 0; u32Index < pLock->jd_u32NumOfSlot; u32Index ++)
+        u32Sum += jf_atomic_loadU32(
+            (u32 *)(pLock->jd_pu8Slot + u32Index * JF_ATOMIC_CACHE_LINE_SIZE));
+
+    return u32Sum;
+}
+
+/** Wait until all readers release the lock, the writer state is already set.
+ */
+static void _waitDrwlockReaders(jf_drwlock_t * pLock)
+{
+    u32 u32Spin = 0;
+
+    jf_atomic_fence();
+
+    while (_sumDrwlockReader(pLock) != 0)
+    {
+        if (++ u32Spin < DRWLOCK_WRITER_SPIN_COUNT)
+        {
+            jf_atomic_cpuRelax();
+        }
+        else
+        {
+#if defined(LINUX)
+            sched_yield();
+#elif defined(WINDOWS)
+            SwitchToThread();
+#endif
+        }
+    }
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_drwlock_init(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    ol_bzero(pLock, sizeof(jf_drwlock_t));
+    pLock->jd_u32NumOfSlot = _getDrwlockNumOfSlot();
+
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pLock->jd_pu8Slot, pLock->jd_u32NumOfSlot * JF_ATOMIC_CACHE_LINE_SIZE);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_bzero(pLock->jd_pu8Slot, pLock->jd_u32NumOfSlot * JF_ATOMIC_CACHE_LINE_SIZE);
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_fini(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    if (pLock->jd_pu8Slot != NULL)
+        jf_jiukun_freeMemory((void **)&pLock->jd_pu8Slot);
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_acquireReadlock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    while (! _tryEnterDrwlockRead(pLock))
+        _waitDrwlockUnlocked(pLock);
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_tryAcquireReadlock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    if (! _tryEnterDrwlockRead(pLock))
+        u32Ret = JF_ERR_FAIL_ACQUIRE_RWLOCK;
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_releaseReadlock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    jf_atomic_fetchAddU32(_getDrwlockReaderCount(pLock), (u32)-1);
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_acquireWritelock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    /*Lock the writer state like a mutex, the state is contended once the writer has waited.*/
+    if (! jf_atomic_casU32(
+            &pLock->jd_u32Writer, DRWLOCK_WRITER_UNLOCKED, DRWLOCK_WRITER_LOCKED))
+    {
+        while (jf_atomic_exchangeU32(&pLock->jd_u32Writer, DRWLOCK_WRITER_CONTENDED) !=
+               DRWLOCK_WRITER_UNLOCKED)
+            _waitDrwlockWriter(pLock, DRWLOCK_WRITER_CONTENDED);
+    }
+
+    /*New readers back off now, wait for the current readers.*/
+    _waitDrwlockReaders(pLock);
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_tryAcquireWritelock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    if (! jf_atomic_casU32(
+            &pLock->jd_u32Writer, DRWLOCK_WRITER_UNLOCKED, DRWLOCK_WRITER_LOCKED))
+        return JF_ERR_FAIL_ACQUIRE_RWLOCK;
+
+    jf_atomic_fence();
+
+    if (_sumDrwlockReader(pLock) != 0)
+    {
+        /*Readers hold the lock, give up.*/
+        jf_drwlock_releaseWritelock(pLock);
+        u32Ret = JF_ERR_FAIL_ACQUIRE_RWLOCK;
+    }
+
+    return u32Ret;
+}
+
+u32 jf_drwlock_releaseWritelock(jf_drwlock_t * pLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pLock != NULL);
+
+    if (jf_atomic_exchangeU32(&pLock->jd_u32Writer, DRWLOCK_WRITER_UNLOCKED) ==
+        DRWLOCK_WRITER_CONTENDED)
+        _wakeDrwlockWriter(pLock);
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
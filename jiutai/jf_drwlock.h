@@ -0,0 +1,130 @@
+/**
+ *  @file jf_drwlock.h
+ *
+ *  @brief Header file defines the interface for distributed read-write lock.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_drwlock object.
+ *  -# The lock is for read-mostly data. Each CPU has a reader counter in its own cache line, the
+ *   reader only changes the counter of the CPU it runs on, so readers on different CPUs don't
+ *   share any cache line which is written.
+ *  -# The writer marks the lock, then sweeps all reader counters and waits until the sum is 0. The
+ *   writer is more expensive than the writer of jf_rwlock.
+ *  -# The new reader backs off if a writer holds or waits for the lock, writers have priority.
+ *  -# The lock is not recursive. The read lock can be released by a thread on a different CPU.
+ *  -# The waiting thread is parked on a futex (WaitOnAddress on Windows).
+ *  -# Link with jf_jiukun library for memory allocation.
+ */
+
+#ifndef JIUTAI_DRWLOCK_H
+#define JIUTAI_DRWLOCK_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+/* --- internal header files -------------------------------------------------------------------- */
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Maximum number of reader counters, CPUs beyond it share the counters.
+ */
+#define JF_DRWLOCK_MAX_READER_SLOT        (256)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the distributed read-write lock data type.
+ */
+typedef struct
+{
+    /**The writer state, 0: unlocked, 1: locked, 2: locked and there are waiting threads.*/
+    u32 jd_u32Writer;
+    /**Number of reader slots, it's power of 2.*/
+    u32 jd_u32NumOfSlot;
+    /**The reader slots, each slot occupies a cache line.*/
+    u8 * jd_pu8Slot;
+} jf_drwlock_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Initialize the distributed read-write lock.
+ *
+ *  @param pLock [in] The lock to be initialized.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OUT_OF_MEMORY Out of memory.
+ */
+u32 jf_drwlock_init(jf_drwlock_t * pLock);
+
+/** Finalize the distributed read-write lock.
+ *
+ *  @param pLock [in] The lock to be finalized.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_drwlock_fini(jf_drwlock_t * pLock);
+
+/** Acquire a read lock, the calling thread is blocked if a writer holds or waits for the lock.
+ *
+ *  @param pLock [in] The lock to be acquired.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_drwlock_acquireReadlock(jf_drwlock_t * pLock);
+
+/** Try to acquire a read lock, the calling thread is not blocked.
+ *
+ *  @param pLock [in] The lock to be acquired.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_ACQUIRE_RWLOCK A writer holds or waits for the lock.
+ */
+u32 jf_drwlock_tryAcquireReadlock(jf_drwlock_t * pLock);
+
+/** Release a read lock.
+ *
+ *  @param pLock [in] The lock to be released.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_drwlock_releaseReadlock(jf_drwlock_t * pLock);
+
+/** Acquire a write lock, the calling thread is blocked until other writer releases the lock and all
+ *  readers release the lock.
+ *
+ *  @param pLock [in] The lock to be acquired.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_drwlock_acquireWritelock(jf_drwlock_t * pLock);
+
+/** Try to acquire a write lock, the calling thread is not blocked.
+ *
+ *  @param pLock [in] The lock to be acquired.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_ACQUIRE_RWLOCK The lock is held by other thread.
+ */
+u32 jf_drwlock_tryAcquireWritelock(jf_drwlock_t * pLock);
+
+/** Release a write lock.
+ *
+ *  @param pLock [in] The lock to be released.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_drwlock_releaseWritelock(jf_drwlock_t * pLock);
+
+#endif /*JIUTAI_DRWLOCK_H*/
+
+/*------------------------------------------------------------------------------------------------*/
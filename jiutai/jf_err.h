@@ -166,6 +166,8 @@
 /* queue error */
 #define JF_ERR_QUEUE_ERROR_START            (JF_ERR_QUEUE_ERROR << JF_ERR_CODE_MODULE_SHIFT)
 #define JF_ERR_FAIL_CREATE_QUEUE            (JF_ERR_QUEUE_ERROR_START + 0x0)
+#define JF_ERR_QUEUE_FULL                   (JF_ERR_QUEUE_ERROR_START + 0x1)
+#define JF_ERR_QUEUE_EMPTY                  (JF_ERR_QUEUE_ERROR_START + 0x2)
 
 /* hashtree error */
 #define JF_ERR_HASHTREE_ERROR_START         (JF_ERR_HASHTREE_ERROR << JF_ERR_CODE_MODULE_SHIFT)
@@ -198,6 +200,7 @@
 #define JF_ERR_HASHTABLE_ERROR_START        (JF_ERR_HASHTABLE_ERROR << JF_ERR_CODE_MODULE_SHIFT)
 
 #define JF_ERR_HASH_ENTRY_NOT_FOUND         (JF_ERR_HASHTABLE_ERROR_START + 0x0)
+#define JF_ERR_HASH_ENTRY_ALREADY_EXIST     (JF_ERR_HASHTABLE_ERROR_START + 0x1)
 
 /* conffile error */
 #define JF_ERR_CONFFILE_ERROR_START         (JF_ERR_CONFFILE_ERROR << JF_ERR_CODE_MODULE_SHIFT)
@@ -232,6 +235,8 @@
 /* thread error */
 #define JF_ERR_THREAD_ERROR_START           (JF_ERR_THREAD_ERROR << JF_ERR_CODE_MODULE_SHIFT)
 
+#define JF_ERR_THREADPOOL_TERMINATED        (JF_ERR_THREAD_ERROR_START + 0x0)
+
 #define JF_ERR_FAIL_CREATE_THREAD           (JF_ERR_THREAD_ERROR_START + JF_ERR_CODE_FLAG_SYSTEM + 0x0)
 #define JF_ERR_FAIL_STOP_THREAD             (JF_ERR_THREAD_ERROR_START + JF_ERR_CODE_FLAG_SYSTEM + 0x1)
 #define JF_ERR_FAIL_WAIT_THREAD_TERMINATION (JF_ERR_THREAD_ERROR_START + JF_ERR_CODE_FLAG_SYSTEM + 0x2)
@@ -511,6 +516,7 @@
 #define JF_ERR_JIUKUN_MEMORY_LEAK           (JF_ERR_JIUKUN_ERROR_START + 0xC)
 #define JF_ERR_JIUKUN_MEMORY_CORRUPTED      (JF_ERR_JIUKUN_ERROR_START + 0xD)
 #define JF_ERR_JIUKUN_MEMORY_OUT_OF_BOUND   (JF_ERR_JIUKUN_ERROR_START + 0xE)
+#define JF_ERR_FAIL_EXTEND_JIUKUN_PAGE      (JF_ERR_JIUKUN_ERROR_START + 0xF)
 
 /* ifmgmt error */
 #define JF_ERR_IFMGMT_ERROR_START           (JF_ERR_IFMGMT_ERROR << JF_ERR_CODE_MODULE_SHIFT)
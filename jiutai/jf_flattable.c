@@ -0,0 +1,786 @@
+/**
+ *  @file jf_flattable.c
+ *
+ *  @brief Implementation file for flat hash table.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The hash value is split into 2 parts, the high bits (H1) select the first group to probe,
+ *   the low 7 bits (H2) are saved in the control byte.
+ *  -# The groups are aligned to 16 slots and probed with triangular sequence, all groups are
+ *   visited as the number of groups is power of 2. The probing stops at the group with empty
+ *   slot.
+ *  -# The slot is marked as empty when the entry is removed if its group has empty slot, no
+ *   probing can pass the group. Otherwise it's marked as deleted (tombstone).
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define FLATTABLE_SSE2
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_flattable.h"
+#include "jf_hashfunc.h"
+#include "jf_jiukun.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Number of control bytes in a group.
+ */
+#define FLATTABLE_GROUP_WIDTH           (16)
+
+/** Control byte of empty slot.
+ */
+#define FLATTABLE_CTRL_EMPTY            (0x80)
+
+/** Control byte of deleted slot.
+ */
+#define FLATTABLE_CTRL_DELETED          (0xFE)
+
+/** Get the H2 from hash value, it's saved in the control byte of full slot.
+ */
+#define FLATTABLE_H2(hash)              ((u8)((hash) & 0x7F))
+
+/** Get the H1 from hash value, it's used to select the group.
+ */
+#define FLATTABLE_H1(hash)              ((u32)((hash) >> 7))
+
+/** Get maximum number of entry for the capacity, 7/8 of the slots.
+ */
+#define FLATTABLE_MAX_LOAD(cap)         ((cap) - ((cap) >> 3))
+
+/** Define the internal flat hash table data type.
+ */
+typedef struct
+{
+    /**Control bytes, one byte per slot.*/
+    u8 * ift_pu8Ctrl;
+    /**Slot array, the key is followed by the value in the slot.*/
+    u8 * ift_pu8Slot;
+    /**Number of slots, power of 2 and multiple of group width.*/
+    u32 ift_u32Capacity;
+    /**Number of entry in the table.*/
+    u32 ift_u32Size;
+    /**Number of entry can be inserted before the table is resized, the deleted slot is counted as
+       used.*/
+    u32 ift_u32GrowthLeft;
+    /**Size of the slot.*/
+    u16 ift_u16SlotSize;
+    /**Size of the key in slot.*/
+    u16 ift_u16KeySize;
+    /**Size of the value.*/
+    u16 ift_u16ValueSize;
+    /**Offset of the value in slot.*/
+    u16 ift_u16ValueOffset;
+    /**Key type.*/
+    u8 ift_u8KeyType;
+    u8 ift_u8Reserved[3];
+} internal_flattable_t;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+/** Match the control bytes of a group with the byte.
+ *
+ *  @return The bit mask, bit n is set if the control byte n matches.
+ */
+static inline u32 _matchFlattableGroup(const u8 * pu8Ctrl, u8 u8Byte)
+{
+#if defined(FLATTABLE_SSE2)
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)pu8Ctrl);
+
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((olchar_t)u8Byte)));
+#else
+    u32 u32Mask = 0, u32Index = 0;
+
+    for (u32Index = 0; u32Index < FLATTABLE_GROUP_WIDTH; u32Index ++)
+        if (pu8Ctrl[u32Index] == u8Byte)
+            u32Mask |= 1U << u32Index;
+
+    return u32Mask;
+#endif
+}
+
+/** Match the empty or deleted slot of a group, the high bit of control byte is set.
+ */
+static inline u32 _matchFlattableGroupEmptyOrDeleted(const u8 * pu8Ctrl)
+{
+#if defined(FLATTABLE_SSE2)
+    return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)pu8Ctrl));
+#else
+    u32 u32Mask = 0, u32Index = 0;
+
+    for (u32Index = 0; u32Index < FLATTABLE_GROUP_WIDTH; u32Index ++)
+        if (pu8Ctrl[u32Index] & 0x80)
+            u32Mask |= 1U << u32Index;
+
+    return u32Mask;
+#endif
+}
+
+/** Get index of the lowest bit set in the mask, the mask should not be 0.
+ */
+static inline u32 _getFlattableLowestBit(u32 u32Mask)
+{
+#if defined(__GNUC__)
+    return (u32)__builtin_ctz(u32Mask);
+#else
+    u32 u32Index = 0;
+
+    while ((u32Mask & 1) == 0)
+    {
+        u32Mask >>= 1;
+        u32Index ++;
+    }
+
+    return u32Index;
+#endif
+}
+
+static inline u8 * _getFlattableSlot(internal_flattable_t * pift, u32 u32Pos)
+{
+    return pift->ift_pu8Slot + (olsize_t)u32Pos * pift->ift_u16SlotSize;
+}
+
+static inline u64 _hashFlattableU64(u64 u64Key)
+{
+    return jf_hashfunc_hashU64(u64Key);
+}
+
+/** Hash the key passed by user.
+ */
+static u64 _hashFlattableKey(internal_flattable_t * pift, const void * pKey)
+{
+    u64 u64Hash = 0, u64Key = 0;
+    u32 u32Key = 0;
+
+    switch (pift->ift_u8KeyType)
+    {
+    case JF_FLATTABLE_KEY_TYPE_U32:
+        ol_memcpy(&u32Key, pKey, sizeof(u32Key));
+        u64Hash = _hashFlattableU64(u32Key);
+        break;
+    case JF_FLATTABLE_KEY_TYPE_U64:
+    case JF_FLATTABLE_KEY_TYPE_PTR:
+        /*The pointer key is saved as u64 in slot.*/
+        ol_memcpy(&u64Key, pKey, sizeof(u64Key));
+        u64Hash = _hashFlattableU64(u64Key);
+        break;
+    case JF_FLATTABLE_KEY_TYPE_STRING:
+        u64Hash = jf_hashfunc_hashString(pKey);
+        break;
+    default:
+        u64Hash = jf_hashfunc_hashData(pKey, pift->ift_u16KeySize, JF_HASHFUNC_DEFAULT_SEED);
+        break;
+    }
+
+    return u64Hash;
+}
+
+/** Hash the key stored in slot.
+ */
+static inline u64 _hashFlattableSlotKey(internal_flattable_t * pift, u8 * pu8Slot)
+{
+    if (pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_STRING)
+        return jf_hashfunc_hashString(*(olchar_t **)pu8Slot);
+
+    return _hashFlattableKey(pift, pu8Slot);
+}
+
+static inline boolean_t _isFlattableKeyEqual(
+    internal_flattable_t * pift, u8 * pu8Slot, const void * pKey)
+{
+    if (pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_STRING)
+        return (ol_strcmp(*(olchar_t **)pu8Slot, pKey) == 0);
+
+    return (ol_memcmp(pu8Slot, pKey, pift->ift_u16KeySize) == 0);
+}
+
+/** Get the next group in probing sequence.
+ */
+static inline u32 _getFlattableNextGroup(internal_flattable_t * pift, u32 u32Group, u32 u32Probe)
+{
+    return (u32Group + u32Probe) & ((pift->ift_u32Capacity / FLATTABLE_GROUP_WIDTH) - 1);
+}
+
+static inline u32 _getFlattableFirstGroup(internal_flattable_t * pift, u64 u64Hash)
+{
+    return FLATTABLE_H1(u64Hash) & ((pift->ift_u32Capacity / FLATTABLE_GROUP_WIDTH) - 1);
+}
+
+/** Find the slot with the key.
+ *
+ *  @return The position of the slot, or capacity if the key is not found.
+ */
+static u32 _findFlattableSlot(internal_flattable_t * pift, u64 u64Hash, const void * pKey)
+{
+    u32 u32Group = _getFlattableFirstGroup(pift, u64Hash), u32Probe = 0, u32Mask = 0, u32Pos = 0;
+    const u8 * pu8Ctrl = NULL;
+
+    while (u32Probe * FLATTABLE_GROUP_WIDTH < pift->ift_u32Capacity)
+    {
+        pu8Ctrl = pift->ift_pu8Ctrl + u32Group * FLATTABLE_GROUP_WIDTH;
+
+        u32Mask = _matchFlattableGroup(pu8Ctrl, FLATTABLE_H2(u64Hash));
+        while (u32Mask != 0)
+        {
+            u32Pos = u32Group * FLATTABLE_GROUP_WIDTH + _getFlattableLowestBit(u32Mask);
+            if (_isFlattableKeyEqual(pift, _getFlattableSlot(pift, u32Pos), pKey))
+                return u32Pos;
+            u32Mask &= u32Mask - 1;
+        }
+
+        if (_matchFlattableGroup(pu8Ctrl, FLATTABLE_CTRL_EMPTY) != 0)
+            break;
+
+        u32Probe ++;
+        u32Group = _getFlattableNextGroup(pift, u32Group, u32Probe);
+    }
+
+    return pift->ift_u32Capacity;
+}
+
+/** Find the slot with u32 key, the key is compared as integer.
+ */
+static u32 _findFlattableSlotU32(internal_flattable_t * pift, u64 u64Hash, u32 u32Key)
+{
+    u32 u32Group = _getFlattableFirstGroup(pift, u64Hash), u32Probe = 0, u32Mask = 0, u32Pos = 0;
+    const u8 * pu8Ctrl = NULL;
+
+    while (u32Probe * FLATTABLE_GROUP_WIDTH < pift->ift_u32Capacity)
+    {
+        pu8Ctrl = pift->ift_pu8Ctrl + u32Group * FLATTABLE_GROUP_WIDTH;
+
+        u32Mask = _matchFlattableGroup(pu8Ctrl, FLATTABLE_H2(u64Hash));
+        while (u32Mask != 0)
+        {
+            u32Pos = u32Group * FLATTABLE_GROUP_WIDTH + _getFlattableLowestBit(u32Mask);
+            if (*(u32 *)_getFlattableSlot(pift, u32Pos) == u32Key)
+                return u32Pos;
+            u32Mask &= u32Mask - 1;
+        }
+
+        if (_matchFlattableGroup(pu8Ctrl, FLATTABLE_CTRL_EMPTY) != 0)
+            break;
+
+        u32Probe ++;
+        u32Group = _getFlattableNextGroup(pift, u32Group, u32Probe);
+    }
+
+    return pift->ift_u32Capacity;
+}
+
+/** Find the slot with u64 key, the key is compared as integer.
+ */
+static u32 _findFlattableSlotU64(internal_flattable_t * pift, u64 u64Hash, u64 u64Key)
+{
+    u32 u32Group = _getFlattableFirstGroup(pift, u64Hash), u32Probe = 0, u32Mask = 0, u32Pos = 0;
+    const u8 * pu8Ctrl = NULL;
+
+    while (u32Probe * FLATTABLE_GROUP_WIDTH < pift->ift_u32Capacity)
+    {
+        pu8Ctrl = pift->ift_pu8Ctrl + u32Group * FLATTABLE_GROUP_WIDTH;
+
+        u32Mask = _matchFlattableGroup(pu8Ctrl, FLATTABLE_H2(u64Hash));
+        while (u32Mask != 0)
+        {
+            u32Pos = u32Group * FLATTABLE_GROUP_WIDTH + _getFlattableLowestBit(u32Mask);
+            if (*(u64 *)_getFlattableSlot(pift, u32Pos) == u64Key)
+                return u32Pos;
+            u32Mask &= u32Mask - 1;
+        }
+
+        if (_matchFlattableGroup(pu8Ctrl, FLATTABLE_CTRL_EMPTY) != 0)
+            break;
+
+        u32Probe ++;
+        u32Group = _getFlattableNextGroup(pift, u32Group, u32Probe);
+    }
+
+    return pift->ift_u32Capacity;
+}
+
+/** Find an empty or deleted slot for the new entry.
+ */
+static u32 _findFlattableFreeSlot(internal_flattable_t * pift, u64 u64Hash)
+{
+    u32 u32Group = _getFlattableFirstGroup(pift, u64Hash), u32Probe = 0, u32Mask = 0;
+
+    /*There is always a free slot as the table is never full.*/
+    while ((u32Mask = _matchFlattableGroupEmptyOrDeleted(
+                pift->ift_pu8Ctrl + u32Group * FLATTABLE_GROUP_WIDTH)) == 0)
+    {
+        u32Probe ++;
+        u32Group = _getFlattableNextGroup(pift, u32Group, u32Probe);
+    }
+
+    return u32Group * FLATTABLE_GROUP_WIDTH + _getFlattableLowestBit(u32Mask);
+}
+
+static inline olsize_t _getFlattableArraySize(internal_flattable_t * pift, u32 u32Capacity)
+{
+    return (olsize_t)u32Capacity * (1 + pift->ift_u16SlotSize);
+}
+
+/** Allocate memory for the control bytes and slot array.
+ */
+static u32 _allocFlattableArray(internal_flattable_t * pift, u32 u32Capacity, u8 ** ppu8Array)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = jf_jiukun_allocLargeMemory(
+        (void **)ppu8Array, _getFlattableArraySize(pift, u32Capacity));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_memset(*ppu8Array, FLATTABLE_CTRL_EMPTY, u32Capacity);
+
+    return u32Ret;
+}
+
+static void _freeFlattableArray(internal_flattable_t * pift, u32 u32Capacity, u8 ** ppu8Array)
+{
+    jf_jiukun_freeLargeMemory((void **)ppu8Array, _getFlattableArraySize(pift, u32Capacity));
+}
+
+static inline void _setFlattableArray(
+    internal_flattable_t * pift, u32 u32Capacity, u8 * pu8Array)
+{
+    pift->ift_pu8Ctrl = pu8Array;
+    pift->ift_pu8Slot = pu8Array + u32Capacity;
+    pift->ift_u32Capacity = u32Capacity;
+    pift->ift_u32GrowthLeft = FLATTABLE_MAX_LOAD(u32Capacity) - pift->ift_u32Size;
+}
+
+/** Resize the table when there is no growth left.
+ *
+ *  @note
+ *  -# If most of the used slots are deleted, the table is rehashed with the same capacity to clear
+ *   the deleted slots, otherwise the capacity is doubled.
+ */
+static u32 _resizeFlattable(internal_flattable_t * pift)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Ctrl = pift->ift_pu8Ctrl, * pu8Slot = pift->ift_pu8Slot, * pu8Array = NULL;
+    u32 u32Capacity = pift->ift_u32Capacity, u32NewCapacity = pift->ift_u32Capacity;
+    u32 u32Index = 0, u32Pos = 0;
+    u64 u64Hash = 0;
+
+    if (pift->ift_u32Size >= FLATTABLE_MAX_LOAD(u32Capacity) / 2)
+        u32NewCapacity = u32Capacity * 2;
+
+    u32Ret = _allocFlattableArray(pift, u32NewCapacity, &pu8Array);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        _setFlattableArray(pift, u32NewCapacity, pu8Array);
+
+        /*Move all entries to the new array.*/
+        for (u32Index = 0; u32Index < u32Capacity; u32Index ++)
+        {
+            if (pu8Ctrl[u32Index] & 0x80)
+                continue;
+
+            u64Hash = _hashFlattableSlotKey(pift, pu8Slot + u32Index * pift->ift_u16SlotSize);
+            u32Pos = _findFlattableFreeSlot(pift, u64Hash);
+            pift->ift_pu8Ctrl[u32Pos] = FLATTABLE_H2(u64Hash);
+            ol_memcpy(
+                _getFlattableSlot(pift, u32Pos), pu8Slot + u32Index * pift->ift_u16SlotSize,
+                pift->ift_u16SlotSize);
+        }
+
+        _freeFlattableArray(pift, u32Capacity, &pu8Ctrl);
+    }
+
+    return u32Ret;
+}
+
+/** Save the value to slot.
+ */
+static inline void _setFlattableValue(internal_flattable_t * pift, u32 u32Pos, const void * pValue)
+{
+    if ((pift->ift_u16ValueSize > 0) && (pValue != NULL))
+        ol_memcpy(
+            _getFlattableSlot(pift, u32Pos) + pift->ift_u16ValueOffset, pValue,
+            pift->ift_u16ValueSize);
+}
+
+static inline void _getFlattableValue(internal_flattable_t * pift, u32 u32Pos, void ** ppValue)
+{
+    if (ppValue != NULL)
+        *ppValue = _getFlattableSlot(pift, u32Pos) + pift->ift_u16ValueOffset;
+}
+
+/** Add new entry to the table, the key must not be in the table.
+ */
+static u32 _addFlattableEntry(
+    internal_flattable_t * pift, u64 u64Hash, const void * pKey, const void * pValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Pos = 0;
+
+    if (pift->ift_u32GrowthLeft == 0)
+        u32Ret = _resizeFlattable(pift);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Pos = _findFlattableFreeSlot(pift, u64Hash);
+        if (pift->ift_pu8Ctrl[u32Pos] == FLATTABLE_CTRL_EMPTY)
+            pift->ift_u32GrowthLeft --;
+        pift->ift_pu8Ctrl[u32Pos] = FLATTABLE_H2(u64Hash);
+        pift->ift_u32Size ++;
+
+        /*For string key, the pointer to the string is saved.*/
+        if (pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_STRING)
+            ol_memcpy(_getFlattableSlot(pift, u32Pos), &pKey, sizeof(pKey));
+        else
+            ol_memcpy(_getFlattableSlot(pift, u32Pos), pKey, pift->ift_u16KeySize);
+
+        _setFlattableValue(pift, u32Pos, pValue);
+    }
+
+    return u32Ret;
+}
+
+/** Remove the entry in the slot.
+ */
+static void _removeFlattableEntry(internal_flattable_t * pift, u32 u32Pos)
+{
+    u8 * pu8Group = pift->ift_pu8Ctrl + (u32Pos & ~(FLATTABLE_GROUP_WIDTH - 1));
+
+    /*If the group has empty slot, the probing stops at this group, the slot can be empty.*/
+    if (_matchFlattableGroup(pu8Group, FLATTABLE_CTRL_EMPTY) != 0)
+    {
+        pift->ift_pu8Ctrl[u32Pos] = FLATTABLE_CTRL_EMPTY;
+        pift->ift_u32GrowthLeft ++;
+    }
+    else
+    {
+        pift->ift_pu8Ctrl[u32Pos] = FLATTABLE_CTRL_DELETED;
+    }
+
+    pift->ift_u32Size --;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_flattable_create(jf_flattable_t ** ppjf, jf_flattable_create_param_t * pjfcp)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = NULL;
+    u32 u32Capacity = FLATTABLE_GROUP_WIDTH;
+    u8 * pu8Array = NULL;
+    u16 u16Align = 1;
+
+    assert((ppjf != NULL) && (pjfcp != NULL));
+    assert(pjfcp->jfcp_u8KeyType <= JF_FLATTABLE_KEY_TYPE_DATA);
+    assert((pjfcp->jfcp_u8KeyType != JF_FLATTABLE_KEY_TYPE_DATA) || (pjfcp->jfcp_u16KeySize > 0));
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pift, sizeof(internal_flattable_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pift, sizeof(internal_flattable_t));
+
+        pift->ift_u8KeyType = pjfcp->jfcp_u8KeyType;
+        switch (pift->ift_u8KeyType)
+        {
+        case JF_FLATTABLE_KEY_TYPE_U32:
+            pift->ift_u16KeySize = sizeof(u32);
+            break;
+        case JF_FLATTABLE_KEY_TYPE_U64:
+        case JF_FLATTABLE_KEY_TYPE_PTR:
+            /*Pointer is saved as u64 so the same fast path is used on 32-bit system.*/
+            pift->ift_u16KeySize = sizeof(u64);
+            break;
+        case JF_FLATTABLE_KEY_TYPE_STRING:
+            pift->ift_u16KeySize = sizeof(olchar_t *);
+            break;
+        default:
+            pift->ift_u16KeySize = pjfcp->jfcp_u16KeySize;
+            break;
+        }
+        pift->ift_u16ValueSize = pjfcp->jfcp_u16ValueSize;
+
+        /*The integer key is aligned in slot, the value which may hold a pointer is aligned to 8
+          bytes.*/
+        if (pift->ift_u8KeyType != JF_FLATTABLE_KEY_TYPE_DATA)
+            u16Align = pift->ift_u16KeySize;
+        pift->ift_u16ValueOffset = pift->ift_u16KeySize;
+        if (pift->ift_u16ValueSize >= sizeof(u64))
+        {
+            u16Align = sizeof(u64);
+            pift->ift_u16ValueOffset = ALIGN_CEIL(pift->ift_u16KeySize, sizeof(u64));
+        }
+        pift->ift_u16SlotSize = ALIGN_CEIL(
+            pift->ift_u16ValueOffset + pift->ift_u16ValueSize, u16Align);
+
+        /*Get the capacity to hold the minimal number of entry without resizing.*/
+        while (FLATTABLE_MAX_LOAD(u32Capacity) < pjfcp->jfcp_u32MinSize)
+            u32Capacity *= 2;
+
+        u32Ret = _allocFlattableArray(pift, u32Capacity, &pu8Array);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        _setFlattableArray(pift, u32Capacity, pu8Array);
+        *ppjf = pift;
+    }
+    else if (pift != NULL)
+    {
+        jf_flattable_destroy((jf_flattable_t **)&pift);
+    }
+
+    return u32Ret;
+}
+
+u32 jf_flattable_destroy(jf_flattable_t ** ppjf)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = NULL;
+
+    assert((ppjf != NULL) && (*ppjf != NULL));
+
+    pift = (internal_flattable_t *) *ppjf;
+
+    if (pift->ift_pu8Ctrl != NULL)
+        _freeFlattableArray(pift, pift->ift_u32Capacity, &pift->ift_pu8Ctrl);
+
+    jf_jiukun_freeMemory(ppjf);
+
+    return u32Ret;
+}
+
+void jf_flattable_clear(jf_flattable_t * pjf)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+
+    ol_memset(pift->ift_pu8Ctrl, FLATTABLE_CTRL_EMPTY, pift->ift_u32Capacity);
+    pift->ift_u32Size = 0;
+    pift->ift_u32GrowthLeft = FLATTABLE_MAX_LOAD(pift->ift_u32Capacity);
+}
+
+u32 jf_flattable_getSize(jf_flattable_t * pjf)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+
+    return pift->ift_u32Size;
+}
+
+u32 jf_flattable_insert(jf_flattable_t * pjf, const void * pKey, const void * pValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u64 u64Hash = _hashFlattableKey(pift, pKey);
+    u32 u32Pos = _findFlattableSlot(pift, u64Hash, pKey);
+
+    assert(pift->ift_u8KeyType != JF_FLATTABLE_KEY_TYPE_PTR);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _setFlattableValue(pift, u32Pos, pValue);
+    else
+        u32Ret = _addFlattableEntry(pift, u64Hash, pKey, pValue);
+
+    return u32Ret;
+}
+
+u32 jf_flattable_get(jf_flattable_t * pjf, const void * pKey, void ** ppValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlot(pift, _hashFlattableKey(pift, pKey), pKey);
+
+    assert(pift->ift_u8KeyType != JF_FLATTABLE_KEY_TYPE_PTR);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _getFlattableValue(pift, u32Pos, ppValue);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_remove(jf_flattable_t * pjf, const void * pKey)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlot(pift, _hashFlattableKey(pift, pKey), pKey);
+
+    assert(pift->ift_u8KeyType != JF_FLATTABLE_KEY_TYPE_PTR);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _removeFlattableEntry(pift, u32Pos);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_insertU32(jf_flattable_t * pjf, u32 u32Key, const void * pValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u64 u64Hash = _hashFlattableU64(u32Key);
+    u32 u32Pos = _findFlattableSlotU32(pift, u64Hash, u32Key);
+
+    assert(pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_U32);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _setFlattableValue(pift, u32Pos, pValue);
+    else
+        u32Ret = _addFlattableEntry(pift, u64Hash, &u32Key, pValue);
+
+    return u32Ret;
+}
+
+u32 jf_flattable_getU32(jf_flattable_t * pjf, u32 u32Key, void ** ppValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlotU32(pift, _hashFlattableU64(u32Key), u32Key);
+
+    assert(pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_U32);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _getFlattableValue(pift, u32Pos, ppValue);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_removeU32(jf_flattable_t * pjf, u32 u32Key)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlotU32(pift, _hashFlattableU64(u32Key), u32Key);
+
+    assert(pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_U32);
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _removeFlattableEntry(pift, u32Pos);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_insertU64(jf_flattable_t * pjf, u64 u64Key, const void * pValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u64 u64Hash = _hashFlattableU64(u64Key);
+    u32 u32Pos = _findFlattableSlotU64(pift, u64Hash, u64Key);
+
+    assert(pift->ift_u16KeySize == sizeof(u64));
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _setFlattableValue(pift, u32Pos, pValue);
+    else
+        u32Ret = _addFlattableEntry(pift, u64Hash, &u64Key, pValue);
+
+    return u32Ret;
+}
+
+u32 jf_flattable_getU64(jf_flattable_t * pjf, u64 u64Key, void ** ppValue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlotU64(pift, _hashFlattableU64(u64Key), u64Key);
+
+    assert(pift->ift_u16KeySize == sizeof(u64));
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _getFlattableValue(pift, u32Pos, ppValue);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_removeU64(jf_flattable_t * pjf, u64 u64Key)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+    u32 u32Pos = _findFlattableSlotU64(pift, _hashFlattableU64(u64Key), u64Key);
+
+    assert(pift->ift_u16KeySize == sizeof(u64));
+
+    if (u32Pos < pift->ift_u32Capacity)
+        _removeFlattableEntry(pift, u32Pos);
+    else
+        u32Ret = JF_ERR_HASH_ENTRY_NOT_FOUND;
+
+    return u32Ret;
+}
+
+u32 jf_flattable_insertPtr(jf_flattable_t * pjf, const void * pKey, const void * pValue)
+{
+    return jf_flattable_insertU64(pjf, (u64)(ulong)pKey, pValue);
+}
+
+u32 jf_flattable_getPtr(jf_flattable_t * pjf, const void * pKey, void ** ppValue)
+{
+    return jf_flattable_getU64(pjf, (u64)(ulong)pKey, ppValue);
+}
+
+u32 jf_flattable_removePtr(jf_flattable_t * pjf, const void * pKey)
+{
+    return jf_flattable_removeU64(pjf, (u64)(ulong)pKey);
+}
+
+void jf_flattable_setupIterator(jf_flattable_t * pjf, jf_flattable_iterator_t * pIterator)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pjf;
+
+    ol_bzero(pIterator, sizeof(*pIterator));
+    pIterator->jfi_pjfTable = pjf;
+
+    /*Move to the first full slot.*/
+    while ((pIterator->jfi_u32Pos < pift->ift_u32Capacity) &&
+           (pift->ift_pu8Ctrl[pIterator->jfi_u32Pos] & 0x80))
+        pIterator->jfi_u32Pos ++;
+}
+
+void jf_flattable_incrementIterator(jf_flattable_iterator_t * pIterator)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pIterator->jfi_pjfTable;
+
+    if (pIterator->jfi_u32Pos < pift->ift_u32Capacity)
+        pIterator->jfi_u32Pos ++;
+
+    while ((pIterator->jfi_u32Pos < pift->ift_u32Capacity) &&
+           (pift->ift_pu8Ctrl[pIterator->jfi_u32Pos] & 0x80))
+        pIterator->jfi_u32Pos ++;
+}
+
+boolean_t jf_flattable_isEndOfIterator(jf_flattable_iterator_t * pIterator)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pIterator->jfi_pjfTable;
+
+    return (pIterator->jfi_u32Pos >= pift->ift_u32Capacity) ? TRUE : FALSE;
+}
+
+void * jf_flattable_getKeyFromIterator(jf_flattable_iterator_t * pIterator)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pIterator->jfi_pjfTable;
+    u8 * pu8Slot = _getFlattableSlot(pift, pIterator->jfi_u32Pos);
+
+    if (pift->ift_u8KeyType == JF_FLATTABLE_KEY_TYPE_STRING)
+        return *(olchar_t **)pu8Slot;
+
+    return pu8Slot;
+}
+
+void * jf_flattable_getValueFromIterator(jf_flattable_iterator_t * pIterator)
+{
+    internal_flattable_t * pift = (internal_flattable_t *)pIterator->jfi_pjfTable;
+
+    return _getFlattableSlot(pift, pIterator->jfi_u32Pos) + pift->ift_u16ValueOffset;
+}
+
+/*------------------------------------------------------------------------------------------------*/
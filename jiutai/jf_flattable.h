@@ -0,0 +1,250 @@
+/**
+ *  @file jf_flattable.h
+ *
+ *  @brief Header file for flat hash table common object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_flattable object.
+ *  -# The flat hash table is an open addressing hash table. The key and value are stored inline in
+ *   the slot array, no memory is allocated for each entry.
+ *  -# Each slot has a control byte which is empty, deleted, or the 7 low bits of the hash value if
+ *   the slot is full. The control bytes are probed in group of 16 bytes, with SSE2 a group is
+ *   matched in a few instructions, the key is compared only if the control byte matches.
+ *  -# The key type is specified when the table is created, no callback function is called when
+ *   searching. The typed routines for u32, u64 and pointer key are fast paths.
+ *  -# The slot array is resized when 7/8 of slots are used, the resizing rehashes all entries.
+ *   The pointer to value returned by the table is invalid after the table is modified.
+ *  -# Link with jf_jiukun library for memory allocation.
+ *  -# This object is not thread safe.
+ */
+
+#ifndef JIUTAI_FLATTABLE_H
+#define JIUTAI_FLATTABLE_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Define the flat hash table data type.
+ */
+typedef void  jf_flattable_t;
+
+/** Define the key type of flat hash table.
+ */
+typedef enum jf_flattable_key_type
+{
+    /**Unsigned 32-bit integer.*/
+    JF_FLATTABLE_KEY_TYPE_U32 = 0,
+    /**Unsigned 64-bit integer.*/
+    JF_FLATTABLE_KEY_TYPE_U64,
+    /**Pointer.*/
+    JF_FLATTABLE_KEY_TYPE_PTR,
+    /**Null-terminated string. The string is not copied, only the pointer is stored in the table,
+       the string must be valid until the entry is removed.*/
+    JF_FLATTABLE_KEY_TYPE_STRING,
+    /**Data with fixed size, the data is copied to the table.*/
+    JF_FLATTABLE_KEY_TYPE_DATA,
+} jf_flattable_key_type_t;
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the parameter data type for creating flat hash table.
+ */
+typedef struct
+{
+    /**Minimal number of entry by estimation.*/
+    u32 jfcp_u32MinSize;
+    /**Key type, refer to jf_flattable_key_type_t.*/
+    u8 jfcp_u8KeyType;
+    u8 jfcp_u8Reserved;
+    /**Size of key, it's only used for key type JF_FLATTABLE_KEY_TYPE_DATA.*/
+    u16 jfcp_u16KeySize;
+    /**Size of value stored inline, the table is a set if it's 0.*/
+    u16 jfcp_u16ValueSize;
+    u16 jfcp_u16Reserved[3];
+    u32 jfcp_u32Reserved2[4];
+} jf_flattable_create_param_t;
+
+/** Define the flat hash table iterator.
+ */
+typedef struct
+{
+    /**The flat hash table this iterator attached to.*/
+    jf_flattable_t * jfi_pjfTable;
+    /**The index of the slot.*/
+    u32 jfi_u32Pos;
+    u32 jfi_u32Reserved;
+} jf_flattable_iterator_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Create flat hash table.
+ *
+ *  @param ppjf [out] The flat hash table to be created and returned.
+ *  @param pjfcp [in] The parameter for creating flat hash table.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_flattable_create(jf_flattable_t ** ppjf, jf_flattable_create_param_t * pjfcp);
+
+/** Destroy flat hash table.
+ *
+ *  @param ppjf [in/out] The flat hash table to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_flattable_destroy(jf_flattable_t ** ppjf);
+
+/** Remove all entries from the flat hash table, the memory of slot array is kept.
+ *
+ *  @param pjf [in] The flat hash table.
+ *
+ *  @return Void.
+ */
+void jf_flattable_clear(jf_flattable_t * pjf);
+
+/** Return the number of entries in the flat hash table.
+ *
+ *  @param pjf [in] The flat hash table.
+ *
+ *  @return The number of entries.
+ */
+u32 jf_flattable_getSize(jf_flattable_t * pjf);
+
+/** Insert an entry to the flat hash table, the value is overwritten if the key is existing.
+ *
+ *  @note
+ *  -# The key is the address of the key data, except for JF_FLATTABLE_KEY_TYPE_STRING which is the
+ *   string itself.
+ *  -# For JF_FLATTABLE_KEY_TYPE_PTR, use the typed routines jf_flattable_xxxPtr().
+ *  -# The value is copied to the table, the size is the value size of the table. It can be NULL
+ *   if the table is a set.
+ *
+ *  @param pjf [in] The flat hash table.
+ *  @param pKey [in] The key.
+ *  @param pValue [in] The value.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OUT_OF_MEMORY Out of memory when the table is resized.
+ */
+u32 jf_flattable_insert(jf_flattable_t * pjf, const void * pKey, const void * pValue);
+
+/** Search the entry with the key.
+ *
+ *  @param pjf [in] The flat hash table.
+ *  @param pKey [in] The key.
+ *  @param ppValue [out] The address of value in the table, it can be NULL.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_HASH_ENTRY_NOT_FOUND Entry is not found.
+ */
+u32 jf_flattable_get(jf_flattable_t * pjf, const void * pKey, void ** ppValue);
+
+/** Remove the entry with the key.
+ *
+ *  @param pjf [in] The flat hash table.
+ *  @param pKey [in] The key.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_HASH_ENTRY_NOT_FOUND Entry is not found.
+ */
+u32 jf_flattable_remove(jf_flattable_t * pjf, const void * pKey);
+
+/** Insert an entry with u32 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U32.
+ */
+u32 jf_flattable_insertU32(jf_flattable_t * pjf, u32 u32Key, const void * pValue);
+
+/** Search the entry with u32 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U32.
+ */
+u32 jf_flattable_getU32(jf_flattable_t * pjf, u32 u32Key, void ** ppValue);
+
+/** Remove the entry with u32 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U32.
+ */
+u32 jf_flattable_removeU32(jf_flattable_t * pjf, u32 u32Key);
+
+/** Insert an entry with u64 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U64.
+ */
+u32 jf_flattable_insertU64(jf_flattable_t * pjf, u64 u64Key, const void * pValue);
+
+/** Search the entry with u64 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U64.
+ */
+u32 jf_flattable_getU64(jf_flattable_t * pjf, u64 u64Key, void ** ppValue);
+
+/** Remove the entry with u64 key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_U64.
+ */
+u32 jf_flattable_removeU64(jf_flattable_t * pjf, u64 u64Key);
+
+/** Insert an entry with pointer key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_PTR.
+ */
+u32 jf_flattable_insertPtr(jf_flattable_t * pjf, const void * pKey, const void * pValue);
+
+/** Search the entry with pointer key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_PTR.
+ */
+u32 jf_flattable_getPtr(jf_flattable_t * pjf, const void * pKey, void ** ppValue);
+
+/** Remove the entry with pointer key, the key type of the table must be JF_FLATTABLE_KEY_TYPE_PTR.
+ */
+u32 jf_flattable_removePtr(jf_flattable_t * pjf, const void * pKey);
+
+/** Setup an iterator, the iterator points to the first entry.
+ *
+ *  @note
+ *  -# The iterator is invalid after the table is modified.
+ *
+ *  @param pjf [in] The flat hash table.
+ *  @param pIterator [out] The iterator to be setup.
+ *
+ *  @return Void.
+ */
+void jf_flattable_setupIterator(jf_flattable_t * pjf, jf_flattable_iterator_t * pIterator);
+
+/** Increment an iterator to the next entry.
+ *
+ *  @param pIterator [in] The iterator.
+ *
+ *  @return Void.
+ */
+void jf_flattable_incrementIterator(jf_flattable_iterator_t * pIterator);
+
+/** Check if end of iterator is reached.
+ *
+ *  @param pIterator [in] The iterator.
+ *
+ *  @return The end status.
+ *  @retval TRUE The end of iterator is reached.
+ *  @retval FALSE The end of iterator is not reached.
+ */
+boolean_t jf_flattable_isEndOfIterator(jf_flattable_iterator_t * pIterator);
+
+/** Get key of the entry from iterator.
+ *
+ *  @param pIterator [in] The iterator.
+ *
+ *  @return The address of the key in the table, or the string for JF_FLATTABLE_KEY_TYPE_STRING.
+ */
+void * jf_flattable_getKeyFromIterator(jf_flattable_iterator_t * pIterator);
+
+/** Get value of the entry from iterator.
+ *
+ *  @param pIterator [in] The iterator.
+ *
+ *  @return The address of the value in the table.
+ */
+void * jf_flattable_getValueFromIterator(jf_flattable_iterator_t * pIterator);
+
+#endif /*JIUTAI_FLATTABLE_H*/
+
+/*------------------------------------------------------------------------------------------------*/
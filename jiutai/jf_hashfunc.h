@@ -0,0 +1,184 @@
+/**
+ *  @file jf_hashfunc.h
+ *
+ *  @brief Header file which defines the hash functions for hash based containers.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The routines are inline functions, no object file is needed.
+ *  -# The data hash function is wyhash (final version 4), it's fast for short keys and has good
+ *   distribution in both low bits and high bits. Public domain, https://github.com/wangyi-fudan.
+ *  -# The hash value is not stable across different architectures with different byte order, do
+ *   not persist it.
+ */
+
+#ifndef JIUTAI_HASHFUNC_H
+#define JIUTAI_HASHFUNC_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+/* --- internal header files -------------------------------------------------------------------- */
+#include "jf_basic.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** The default seed of hash function.
+ */
+#define JF_HASHFUNC_DEFAULT_SEED          (0x9E3779B97F4A7C15ULL)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Multiply two 64-bit integers, the low 64 bits of the 128-bit product is returned in A and the
+ *  high 64 bits in B.
+ */
+static inline void _jf_hashfunc_mum(u64 * pu64A, u64 * pu64B)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = *pu64A;
+
+    r *= *pu64B;
+    *pu64A = (u64)r;
+    *pu64B = (u64)(r >> 64);
+#else
+    u64 ha = *pu64A >> 32, hb = *pu64B >> 32, la = (u32)*pu64A, lb = (u32)*pu64B;
+    u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    u64 lo = t + (rm1 << 32);
+
+    c += lo < t;
+    *pu64A = lo;
+    *pu64B = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline u64 _jf_hashfunc_mix(u64 u64A, u64 u64B)
+{
+    _jf_hashfunc_mum(&u64A, &u64B);
+
+    return u64A ^ u64B;
+}
+
+static inline u64 _jf_hashfunc_read8(const u8 * pu8Data)
+{
+    u64 u64Value;
+
+    ol_memcpy(&u64Value, pu8Data, sizeof(u64Value));
+
+    return u64Value;
+}
+
+static inline u64 _jf_hashfunc_read4(const u8 * pu8Data)
+{
+    u32 u32Value;
+
+    ol_memcpy(&u32Value, pu8Data, sizeof(u32Value));
+
+    return u32Value;
+}
+
+/** Hash the data to 64-bit integer.
+ *
+ *  @param pData [in] The data to hash.
+ *  @param sData [in] The size of the data.
+ *  @param u64Seed [in] The seed of hash, use JF_HASHFUNC_DEFAULT_SEED if no special requirement.
+ *
+ *  @return The hash value.
+ */
+static inline u64 jf_hashfunc_hashData(const void * pData, olsize_t sData, u64 u64Seed)
+{
+    static const u64 u64Secret[4] = {
+        0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+    const u8 * p = (const u8 *)pData;
+    u64 a = 0, b = 0, see1 = 0, see2 = 0;
+    olsize_t i = sData;
+
+    u64Seed ^= _jf_hashfunc_mix(u64Seed ^ u64Secret[0], u64Secret[1]);
+
+    if (sData <= 16)
+    {
+        if (sData >= 4)
+        {
+            a = (_jf_hashfunc_read4(p) << 32) | _jf_hashfunc_read4(p + ((sData >> 3) << 2));
+            b = (_jf_hashfunc_read4(p + sData - 4) << 32) |
+                _jf_hashfunc_read4(p + sData - 4 - ((sData >> 3) << 2));
+        }
+        else if (sData > 0)
+        {
+            a = ((u64)p[0] << 16) | ((u64)p[sData >> 1] << 8) | p[sData - 1];
+        }
+    }
+    else
+    {
+        if (i >= 48)
+        {
+            see1 = see2 = u64Seed;
+            do
+            {
+                u64Seed = _jf_hashfunc_mix(
+                    _jf_hashfunc_read8(p) ^ u64Secret[1], _jf_hashfunc_read8(p + 8) ^ u64Seed);
+                see1 = _jf_hashfunc_mix(
+                    _jf_hashfunc_read8(p + 16) ^ u64Secret[2], _jf_hashfunc_read8(p + 24) ^ see1);
+                see2 = _jf_hashfunc_mix(
+                    _jf_hashfunc_read8(p + 32) ^ u64Secret[3], _jf_hashfunc_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            u64Seed ^= see1 ^ see2;
+        }
+
+        while (i > 16)
+        {
+            u64Seed = _jf_hashfunc_mix(
+                _jf_hashfunc_read8(p) ^ u64Secret[1], _jf_hashfunc_read8(p + 8) ^ u64Seed);
+            i -= 16;
+            p += 16;
+        }
+
+        a = _jf_hashfunc_read8(p + i - 16);
+        b = _jf_hashfunc_read8(p + i - 8);
+    }
+
+    a ^= u64Secret[1];
+    b ^= u64Seed;
+    _jf_hashfunc_mum(&a, &b);
+
+    return _jf_hashfunc_mix(a ^ u64Secret[0] ^ sData, b ^ u64Secret[1]);
+}
+
+/** Hash the string to 64-bit integer.
+ *
+ *  @param pstrKey [in] The null-terminated string.
+ *
+ *  @return The hash value.
+ */
+static inline u64 jf_hashfunc_hashString(const olchar_t * pstrKey)
+{
+    return jf_hashfunc_hashData(pstrKey, ol_strlen(pstrKey), JF_HASHFUNC_DEFAULT_SEED);
+}
+
+/** Hash the 64-bit integer to 64-bit integer.
+ *
+ *  @note
+ *  -# The function is the finalizer of murmur3, all bits of the integer affect all bits of the
+ *   hash value, the integer key like pointer or sequence number can be hashed with it.
+ *
+ *  @param u64Key [in] The integer to hash.
+ *
+ *  @return The hash value.
+ */
+static inline u64 jf_hashfunc_hashU64(u64 u64Key)
+{
+    u64Key ^= u64Key >> 33;
+    u64Key *= 0xff51afd7ed558ccdULL;
+    u64Key ^= u64Key >> 33;
+    u64Key *= 0xc4ceb9fe1a85ec53ULL;
+    u64Key ^= u64Key >> 33;
+
+    return u64Key;
+}
+
+#endif /*JIUTAI_HASHFUNC_H*/
+
+/*------------------------------------------------------------------------------------------------*/
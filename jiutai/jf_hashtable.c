@@ -7,6 +7,11 @@
  *
  *  @note
  *  -# The position in the hash array is not the key. Different keys may at the same position.
+ *  -# The hash array is resized incrementally. When the threshold is reached, a new hash array is
+ *   allocated and the old one is kept, each insert, overwrite and remove operation moves a few
+ *   array entries from the old array to the new one. The new entry is always added to the new
+ *   array, the search checks both arrays until the old array is empty.
+ *  -# Search operation doesn't move the entries, so it's safe to search the table while iterating.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -21,6 +26,10 @@
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Number of hash array entries moved from the old array in one rehash step.
+ */
+#define HASH_TABLE_REHASH_STEP                (4)
+
 /** Define the hash table bucket data type.
  */
 typedef struct hash_table_bucket
@@ -50,6 +59,13 @@ typedef struct _hash_table
     /*The hash array for buckets.*/
     hash_table_bucket_t ** iht_phtbBucket;
 
+    /**The old hash array during rehashing, NULL if the table is not rehashing.*/
+    hash_table_bucket_t ** iht_phtbOldBucket;
+    /**Size of the old hash array.*/
+    u32 iht_u32OldSize;
+    /**Index of the next entry in old hash array to be moved.*/
+    u32 iht_u32RehashIndex;
+
     /**Callback function for comparing keys.*/
     jf_hashtable_fnCmpKeys_t iht_fnCmpKeys;
     /**Callback function for hashing key to integer.*/
@@ -120,18 +136,20 @@ static u32 _default_fnHtFreeEntry(void ** ppEntry)
     return u32Ret;
 }
 
-static hash_table_bucket_t ** _getPositionOfKey(internal_hash_table_t * piht, void * pKey)
+static inline u32 _getHashTableIndex(olint_t h, u32 u32Size)
 {
-    olint_t h = piht->iht_fnHashKey(pKey);
-    hash_table_bucket_t ** p = NULL;
-    jf_hashtable_fnCmpKeys_t fnCmpKeys = piht->iht_fnCmpKeys;
-    jf_hashtable_fnGetKeyFromEntry_t fnGetKeyFromEntry = piht->iht_fnGetKeyFromEntry;
-
-    /*Locate hash array entry.*/
     if (h < 0)
         h = -h;
-    h %= piht->iht_u32Size;
-    p = &(piht->iht_phtbBucket[h]);
+
+    return (u32)h % u32Size;
+}
+
+static hash_table_bucket_t ** _searchHashTableArray(
+    internal_hash_table_t * piht, hash_table_bucket_t ** phtbBucket, u32 u32Index, void * pKey)
+{
+    hash_table_bucket_t ** p = &(phtbBucket[u32Index]);
+    jf_hashtable_fnCmpKeys_t fnCmpKeys = piht->iht_fnCmpKeys;
+    jf_hashtable_fnGetKeyFromEntry_t fnGetKeyFromEntry = piht->iht_fnGetKeyFromEntry;
 
     /*Iterate through the buckets.*/
     while (*p != NULL)
@@ -149,76 +167,174 @@ static hash_table_bucket_t ** _getPositionOfKey(internal_hash_table_t * piht, vo
     return p;
 }
 
-static u32 _createHashTableArray(internal_hash_table_t * piht)
+/** Get the position of the key.
+ *
+ *  @note
+ *  -# If the key is found, the returned position points to the bucket with the key, the bucket may
+ *   be in the old hash array during rehashing.
+ *  -# If the key is not found, the returned position is at the end of the bucket list in the new
+ *   hash array, the new entry can be added there.
+ */
+static hash_table_bucket_t ** _getPositionOfKey(internal_hash_table_t * piht, void * pKey)
+{
+    olint_t h = piht->iht_fnHashKey(pKey);
+    hash_table_bucket_t ** p = NULL;
+
+    /*Search the old hash array if the table is rehashing.*/
+    if (piht->iht_phtbOldBucket != NULL)
+    {
+        p = _searchHashTableArray(
+            piht, piht->iht_phtbOldBucket, _getHashTableIndex(h, piht->iht_u32OldSize), pKey);
+        if (*p != NULL)
+            return p;
+    }
+
+    return _searchHashTableArray(
+        piht, piht->iht_phtbBucket, _getHashTableIndex(h, piht->iht_u32Size), pKey);
+}
+
+static inline olsize_t _getHashTableArraySize(u32 u32Size)
+{
+    return (olsize_t)u32Size * sizeof(hash_table_bucket_t *);
+}
+
+/** Allocate the hash array.
+ */
+static u32 _allocHashTableArray(u32 u32Size, hash_table_bucket_t *** pppBucket)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    olsize_t size = _getHashTableArraySize(u32Size);
 
-    u32Ret = jf_jiukun_allocMemory(
-        (void **)&piht->iht_phtbBucket, piht->iht_u32Size * sizeof(hash_table_bucket_t *));
+    u32Ret = jf_jiukun_allocLargeMemory((void **)pppBucket, size);
 
     if (u32Ret == JF_ERR_NO_ERROR)
-    {
-        ol_bzero(piht->iht_phtbBucket, piht->iht_u32Size * sizeof(hash_table_bucket_t *));
-    }
+        ol_bzero(*pppBucket, size);
 
     return u32Ret;
 }
 
+static void _freeHashTableArray(u32 u32Size, hash_table_bucket_t *** pppBucket)
+{
+    jf_jiukun_freeLargeMemory((void **)pppBucket, _getHashTableArraySize(u32Size));
+}
+
 static void _setHashTableThreshold(internal_hash_table_t * piht)
 {
     /* ceil(0.8 * piht->iht_u32Size) */
     piht->iht_u32Threshold = (((piht->iht_u32Size) << 2) + 4) / 5;
 }
 
-static u32 _resizeHashTable(internal_hash_table_t * piht)
+/** Move the buckets in one entry of old hash array to the new hash array.
+ */
+static void _rehashHashTableEntry(internal_hash_table_t * piht, u32 u32Index)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    olint_t i = 0;
     jf_hashtable_fnGetKeyFromEntry_t fnGetKeyFromEntry = piht->iht_fnGetKeyFromEntry;
-    /*Save the hash array and size.*/
-    u32 u32Size = piht->iht_u32Size;
-    hash_table_bucket_t ** phtbBucket = piht->iht_phtbBucket;
+    hash_table_bucket_t * p = NULL, * tmp = NULL, ** position = NULL;
 
-    /*Set the new size.*/
-    piht->iht_u32Size = ls_nHashTablePrimes[piht->iht_u32PrimesIndex + 1];
+    for (p = piht->iht_phtbOldBucket[u32Index]; p != NULL; p = tmp)
+    {
+        tmp = p->htb_phtbNext;
 
-    /*Create a new hash array with new size from prime array.*/
-    u32Ret = _createHashTableArray(piht);
+        position = &(piht->iht_phtbBucket[_getHashTableIndex(
+            piht->iht_fnHashKey(fnGetKeyFromEntry(p->htb_pEntry)), piht->iht_u32Size)]);
 
-    if (u32Ret == JF_ERR_NO_ERROR)
+        p->htb_phtbNext = *position;
+        *position = p;
+    }
+
+    piht->iht_phtbOldBucket[u32Index] = NULL;
+}
+
+static void _finishHashTableRehash(internal_hash_table_t * piht)
+{
+    _freeHashTableArray(piht->iht_u32OldSize, &piht->iht_phtbOldBucket);
+    piht->iht_u32OldSize = 0;
+    piht->iht_u32RehashIndex = 0;
+}
+
+/** Do one rehash step, a bounded number of entries in old hash array are moved.
+ *
+ *  @note
+ *  -# At most 10 times of the step empty entries are visited to bound the time.
+ *
+ *  @param piht [in] The hash table.
+ *  @param u32Step [in] Number of non-empty entries to move.
+ *
+ *  @return Void.
+ */
+static void _rehashHashTableStep(internal_hash_table_t * piht, u32 u32Step)
+{
+    u32 u32EmptyVisit = u32Step * 10;
+
+    if (piht->iht_phtbOldBucket == NULL)
+        return;
+
+    while ((u32Step > 0) && (piht->iht_u32RehashIndex < piht->iht_u32OldSize))
     {
-        /*Add all buckets in the saved hash array to new hash table.*/
-        for (i = 0; i < u32Size; i++)
+        if (piht->iht_phtbOldBucket[piht->iht_u32RehashIndex] != NULL)
+        {
+            _rehashHashTableEntry(piht, piht->iht_u32RehashIndex);
+            u32Step --;
+        }
+        else if (u32EmptyVisit > 0)
         {
-            hash_table_bucket_t * p = NULL, * tmp = NULL;
+            u32EmptyVisit --;
+        }
+        else
+        {
+            /*Too many empty entries.*/
+            break;
+        }
 
-            for (p = phtbBucket[i]; p != NULL; p = tmp)
-            {
-                hash_table_bucket_t **position = (hash_table_bucket_t **)
-                    _getPositionOfKey(piht, fnGetKeyFromEntry(p->htb_pEntry));
+        piht->iht_u32RehashIndex ++;
+    }
 
-                tmp = p->htb_phtbNext;
+    if (piht->iht_u32RehashIndex >= piht->iht_u32OldSize)
+        _finishHashTableRehash(piht);
+}
 
-                p->htb_phtbNext = NULL;
-                *position = p;
-            }
-        }
+/** Move all entries from the old hash array, it's called only if the table needs to be resized
+ *  again before the rehashing is finished.
+ */
+static void _rehashHashTable(internal_hash_table_t * piht)
+{
+    while (piht->iht_phtbOldBucket != NULL)
+        _rehashHashTableStep(piht, piht->iht_u32OldSize);
+}
+
+/** Start to resize the hash table with the prime index, the entries are moved incrementally.
+ */
+static u32 _resizeHashTable(internal_hash_table_t * piht, u32 u32PrimesIndex)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    hash_table_bucket_t ** phtbBucket = NULL;
+    u32 u32Size = ls_nHashTablePrimes[u32PrimesIndex];
+
+    /*Only one resizing at a time, finish the previous one.*/
+    _rehashHashTable(piht);
+
+    /*Create a new hash array with new size from prime array.*/
+    u32Ret = _allocHashTableArray(u32Size, &phtbBucket);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Keep the current hash array as old array.*/
+        piht->iht_phtbOldBucket = piht->iht_phtbBucket;
+        piht->iht_u32OldSize = piht->iht_u32Size;
+        piht->iht_u32RehashIndex = 0;
 
         /*Update hash table.*/
-        piht->iht_u32PrimesIndex ++;
+        piht->iht_phtbBucket = phtbBucket;
+        piht->iht_u32Size = u32Size;
+        piht->iht_u32PrimesIndex = u32PrimesIndex;
         _setHashTableThreshold(piht);
 
         /*Collect statistics.*/
         piht->iht_u32Resizes ++;
 
-        /*Free the old hash array.*/
-        jf_jiukun_freeMemory((void **)&phtbBucket);
-    }
-    else
-    {
-        /*Restore the saved values if error.*/
-        piht->iht_u32Size = u32Size;
-        piht->iht_phtbBucket = phtbBucket;
+        /*Nothing to move for empty table.*/
+        if (piht->iht_u32NumOfEntry == 0)
+            _finishHashTableRehash(piht);
     }
 
     return u32Ret;
@@ -233,9 +349,10 @@ static u32 _insertAtPosition(
     assert(ppPosition != NULL);
 
     /*Check if resize is required.*/
-    if (piht->iht_u32NumOfEntry >= piht->iht_u32Threshold)
+    if ((piht->iht_u32NumOfEntry >= piht->iht_u32Threshold) &&
+        (piht->iht_u32PrimesIndex + 1 < ARRAY_SIZE(ls_nHashTablePrimes)))
     {
-        u32Ret = _resizeHashTable(piht);
+        u32Ret = _resizeHashTable(piht, piht->iht_u32PrimesIndex + 1);
 
         /*Need to get position again after resize.*/
         if (u32Ret == JF_ERR_NO_ERROR)
@@ -280,6 +397,38 @@ static u32 _overwriteAtPosition(
     return u32Ret;
 }
 
+/** Free all buckets and entries in the hash array, and then free the hash array.
+ */
+static void _freeHashTableBuckets(
+    internal_hash_table_t * piht, hash_table_bucket_t ** phtbBucket, u32 u32Size)
+{
+    u32 i;
+    hash_table_bucket_t * phtb, * tmp;
+
+    for (i = 0; i < u32Size; i++)
+    {
+        for (phtb = phtbBucket[i]; phtb != NULL; phtb = tmp)
+        {
+            tmp = phtb->htb_phtbNext;
+            piht->iht_fnFreeEntry(&(phtb->htb_pEntry));
+            jf_jiukun_freeMemory((void **)&phtb);
+        }
+    }
+
+    _freeHashTableArray(u32Size, &phtbBucket);
+}
+
+/** Get the head of bucket list in hash array by iterator position. The position covers the new
+ *  hash array and then the old hash array.
+ */
+static hash_table_bucket_t * _getHashTableBucketByPos(internal_hash_table_t * piht, u32 u32Pos)
+{
+    if (u32Pos < piht->iht_u32Size)
+        return piht->iht_phtbBucket[u32Pos];
+
+    return piht->iht_phtbOldBucket[u32Pos - piht->iht_u32Size];
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 u32 jf_hashtable_create(jf_hashtable_t ** ppht, jf_hashtable_create_param_t * pjhcp)
@@ -314,7 +463,7 @@ u32 jf_hashtable_create(jf_hashtable_t ** ppht, jf_hashtable_create_param_t * pj
 
         _setHashTableThreshold(piht);
 
-        u32Ret = _createHashTableArray(piht);
+        u32Ret = _allocHashTableArray(piht->iht_u32Size, &piht->iht_phtbBucket);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -329,30 +478,16 @@ u32 jf_hashtable_destroy(jf_hashtable_t ** ppht)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hash_table_t * piht;
-    olint_t i;
-    jf_hashtable_fnFreeEntry_t fnFreeEntry;
 
     assert((ppht != NULL) && (*ppht != NULL));
 
     piht = (internal_hash_table_t *)*ppht;
-    fnFreeEntry = piht->iht_fnFreeEntry;
 
-    if (piht->iht_phtbBucket != NULL)
-    {
-        for (i = 0; i < piht->iht_u32Size; i++)
-        {
-            hash_table_bucket_t * phtb, * tmp;
-
-            for (phtb = piht->iht_phtbBucket[i]; phtb != NULL; phtb = tmp)
-            {
-                tmp = phtb->htb_phtbNext;
-                fnFreeEntry(&(phtb->htb_pEntry));
-                jf_jiukun_freeMemory((void **)&phtb);
-            }
-        }
+    if (piht->iht_phtbOldBucket != NULL)
+        _freeHashTableBuckets(piht, piht->iht_phtbOldBucket, piht->iht_u32OldSize);
 
-        jf_jiukun_freeMemory((void **)&(piht->iht_phtbBucket));
-    }
+    if (piht->iht_phtbBucket != NULL)
+        _freeHashTableBuckets(piht, piht->iht_phtbBucket, piht->iht_u32Size);
 
     jf_jiukun_freeMemory((void **)ppht);
 
@@ -363,11 +498,15 @@ u32 jf_hashtable_insertEntry(jf_hashtable_t * pht, void * pEntry)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hash_table_t * piht = (internal_hash_table_t *)pht;
-    hash_table_bucket_t **position =
-        _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
+    hash_table_bucket_t ** position = NULL;
+
+    /*Move some entries if the table is rehashing, it must be done before searching.*/
+    _rehashHashTableStep(piht, HASH_TABLE_REHASH_STEP);
+
+    position = _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
 
     if (*position == NULL)
-        u32Ret = _insertAtPosition(pht, position, pEntry);
+        u32Ret = _insertAtPosition(piht, position, pEntry);
 
     return u32Ret;
 }
@@ -377,8 +516,12 @@ u32 jf_hashtable_removeEntry(jf_hashtable_t * pht, void * pEntry)
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hash_table_t * piht = (internal_hash_table_t *)pht;
     hash_table_bucket_t * tmp;
-    hash_table_bucket_t ** position =
-        _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
+    hash_table_bucket_t ** position = NULL;
+
+    /*Move some entries if the table is rehashing, it must be done before searching.*/
+    _rehashHashTableStep(piht, HASH_TABLE_REHASH_STEP);
+
+    position = _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
 
     tmp = *position;
     if (tmp != NULL)
@@ -400,8 +543,12 @@ u32 jf_hashtable_overwriteEntry(jf_hashtable_t * pht, void * pEntry)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hash_table_t * piht = (internal_hash_table_t *)pht;
-    hash_table_bucket_t ** position =
-        _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
+    hash_table_bucket_t ** position = NULL;
+
+    /*Move some entries if the table is rehashing, it must be done before searching.*/
+    _rehashHashTableStep(piht, HASH_TABLE_REHASH_STEP);
+
+    position = _getPositionOfKey(piht, (piht->iht_fnGetKeyFromEntry) (pEntry));
 
     if (*position)
     {
@@ -454,6 +601,23 @@ boolean_t jf_hashtable_isEntryInTable(jf_hashtable_t * pht, void * pEntry)
     return bRet;
 }
 
+u32 jf_hashtable_reserve(jf_hashtable_t * pht, u32 u32NumOfEntry)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_hash_table_t * piht = (internal_hash_table_t *)pht;
+    u32 u32PrimesIndex = piht->iht_u32PrimesIndex;
+
+    /*Get the prime index which can hold the entries without reaching the threshold.*/
+    while ((u32PrimesIndex + 1 < ARRAY_SIZE(ls_nHashTablePrimes)) &&
+           ((((u32)ls_nHashTablePrimes[u32PrimesIndex] << 2) + 4) / 5 < u32NumOfEntry))
+        u32PrimesIndex ++;
+
+    if (u32PrimesIndex > piht->iht_u32PrimesIndex)
+        u32Ret = _resizeHashTable(piht, u32PrimesIndex);
+
+    return u32Ret;
+}
+
 u32 jf_hashtable_getSize(jf_hashtable_t * pht)
 {
     internal_hash_table_t * piht = (internal_hash_table_t *)pht;
@@ -464,11 +628,15 @@ u32 jf_hashtable_getSize(jf_hashtable_t * pht)
 void jf_hashtable_getStat(jf_hashtable_t * pht, jf_hashtable_stat_t * stat)
 {
     internal_hash_table_t * piht = (internal_hash_table_t *)pht;
-    olint_t collisions = 0, maxentries = 0, i = 0;
+    olint_t collisions = 0, maxentries = 0;
+    u32 i = 0, u32NumOfPos = piht->iht_u32Size;
 
-    for (i = 0; i < piht->iht_u32Size; i++)
+    if (piht->iht_phtbOldBucket != NULL)
+        u32NumOfPos += piht->iht_u32OldSize;
+
+    for (i = 0; i < u32NumOfPos; i++)
     {
-        hash_table_bucket_t *p = piht->iht_phtbBucket[i];
+        hash_table_bucket_t *p = _getHashTableBucketByPos(piht, i);
 
         if (p)
         {
@@ -493,6 +661,7 @@ void jf_hashtable_getStat(jf_hashtable_t * pht, jf_hashtable_stat_t * stat)
     stat->jhs_u32Collisions = collisions;
     stat->jhs_u32MaxEntries = maxentries;
     stat->jhs_u32CountOfResizeOp = piht->iht_u32Resizes;
+    stat->jhs_u32OldSize = piht->iht_u32OldSize;
 }
 
 /* iterator routines */
@@ -521,18 +690,23 @@ void jf_hashtable_incrementIterator(jf_hashtable_iterator_t * pIterator)
     else
     {
         /*Next bucket is not available. Let's move to the next bucket in the array.*/
+        internal_hash_table_t * piht = (internal_hash_table_t *)pIterator->jhi_htTable;
         olint_t i = pIterator->jhi_nPos + 1;
-        u32 sz = ((internal_hash_table_t *)(pIterator->jhi_htTable))->iht_u32Size;
-        hash_table_bucket_t ** table =
-            ((internal_hash_table_t *)(pIterator->jhi_htTable))->iht_phtbBucket;
+        u32 sz = piht->iht_u32Size;
+        hash_table_bucket_t * phtb = NULL;
+
+        /*Iterate the old hash array after the new one if the table is rehashing.*/
+        if (piht->iht_phtbOldBucket != NULL)
+            sz += piht->iht_u32OldSize;
 
         while (i < sz)
         {
-            if (table[i] != NULL)
+            phtb = _getHashTableBucketByPos(piht, i);
+            if (phtb != NULL)
             {
                 /*Find a bucket.*/
                 pIterator->jhi_nPos = i;
-                pIterator->jhi_pCursor = table[i];
+                pIterator->jhi_pCursor = phtb;
                 return;
             }
             else
@@ -12,6 +12,9 @@
  *  -# There is only one entry with the same key in hash table. In the case the new entry has the
  *   same key, for insert operation, the old entry is kept; for overwrite operation, the old entry
  *   is replaced.
+ *  -# The hash array is resized incrementally, the entries are moved to the new array a few at a
+ *   time in insert, overwrite and remove operations, no single operation moves all entries. Use
+ *   jf_hashtable_reserve() to pre-size the table if the number of entry is known.
  *  -# Link with jf_jiukun library for memory allocation.
  */
 
@@ -102,6 +105,8 @@ typedef struct
     u32 jhs_u32MaxEntries;
     /**Count of resize operation.*/
     u32 jhs_u32CountOfResizeOp;
+    /**Size of old hash array if the table is rehashing, 0 if not.*/
+    u32 jhs_u32OldSize;
 } jf_hashtable_stat_t;
 
 /** Define the hash table iterator.
@@ -220,6 +225,21 @@ boolean_t jf_hashtable_isEntryInTable(jf_hashtable_t * pjh, void * pEntry);
  */
 boolean_t jf_hashtable_isKeyInTable(jf_hashtable_t * pjh, void * pKey);
 
+/** Reserve the hash array for the number of entry, so the table is not resized until the number
+ *  of entry is reached.
+ *
+ *  @note
+ *  -# The hash array is never shrunk, nothing is done if the table is large enough.
+ *  -# The entries in table are moved to the new hash array incrementally.
+ *
+ *  @param pjh [in] The hash table.
+ *  @param u32NumOfEntry [in] The number of entry.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_hashtable_reserve(jf_hashtable_t * pjh, u32 u32NumOfEntry);
+
 /** Return the number of stored key/entry pairs.
  *
  *  @param pjh [in] The hash table.
@@ -242,7 +262,9 @@ void jf_hashtable_getStat(jf_hashtable_t * pjh, jf_hashtable_stat_t * stat);
  *  traverse the hash table in parallel.
  *
  *  @note
- *  -# These iterators are not safe with respect to 'remove' operations on the traversed hash table.
+ *  -# These iterators are not safe with respect to 'insert', 'overwrite' and 'remove' operations on
+ *   the traversed hash table, the operations may move entries between hash arrays. They are safe
+ *   with search operations.
  *
  *  @param pjh [in] The hash table.
  *  @param pIterator [out] The iterator to be setup.
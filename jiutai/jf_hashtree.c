@@ -19,60 +19,198 @@
 #include "jf_jiukun.h"
 #include "jf_err.h"
 #include "jf_hashtree.h"
+#include "jf_hashfunc.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Initial number of buckets.
+ */
+#define HASHTREE_INITIAL_NUM_OF_BUCKET     (16)
 
+/** Maximum number of buckets, the bucket array is allocated from jiukun, it cannot be larger than
+ *  the maximum memory size of jiukun.
+ */
+#define HASHTREE_MAX_NUM_OF_BUCKET         \
+    (JF_JIUKUN_MAX_MEMORY_SIZE / sizeof(jf_hashtree_node_t *))
+
+/** Number of buckets moved from old bucket array in one operation.
+ */
+#define HASHTREE_REHASH_STEP               (8)
 
 /* --- private routine section ------------------------------------------------------------------ */
 
 /** Calculate a numeric hash from a given string.
  *
  *  @param pKey [in] The string to hash.
- *  @param u32KeyLen [in] The length of the string to hash.
+ *  @param sKey [in] The length of the string to hash.
  
  *  @return The hash value.
  */
-static olint_t _getHashValue(void * pKey, u32 u32KeyLen)
+static inline u64 _getHashValue(void * pKey, olsize_t sKey)
+{
+    return jf_hashfunc_hashData(pKey, sKey, JF_HASHFUNC_DEFAULT_SEED);
+}
+
+static u32 _allocHashtreeBucket(jf_hashtree_node_t *** pppBucket, u32 u32NumOfBucket)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olsize_t size = u32NumOfBucket * sizeof(jf_hashtree_node_t *);
+
+    u32Ret = jf_jiukun_allocMemory((void **)pppBucket, size);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_bzero(*pppBucket, size);
+
+    return u32Ret;
+}
+
+static void _freeHashtreeBucket(jf_hashtree_t * pHashtree)
 {
-    olint_t value = 0;
-    olchar_t temp[4];
+    if (pHashtree->jh_ppjhnBucket != NULL)
+        jf_jiukun_freeMemory((void **)&pHashtree->jh_ppjhnBucket);
 
-    if (u32KeyLen <= 4)
+    if (pHashtree->jh_ppjhnOldBucket != NULL)
+        jf_jiukun_freeMemory((void **)&pHashtree->jh_ppjhnOldBucket);
+}
+
+/** Move nodes in some buckets from old bucket array to the new one.
+ *
+ *  @param pHashtree [in] The hash tree.
+ *  @param u32Step [in] Number of buckets to move.
+ *
+ *  @return Void.
+ */
+static void _rehashHashtree(jf_hashtree_t * pHashtree, u32 u32Step)
+{
+    jf_hashtree_node_t * pjhn = NULL, * pNext = NULL, ** ppBucket = NULL;
+    u32 mask = pHashtree->jh_u32NumOfBucket - 1;
+
+    while ((u32Step > 0) && (pHashtree->jh_u32RehashIndex < pHashtree->jh_u32NumOfOldBucket))
+    {
+        pjhn = pHashtree->jh_ppjhnOldBucket[pHashtree->jh_u32RehashIndex];
+        while (pjhn != NULL)
+        {
+            pNext = pjhn->jhn_pjhnBucketNext;
+            ppBucket = &pHashtree->jh_ppjhnBucket[pjhn->jhn_u64Key & mask];
+            pjhn->jhn_pjhnBucketNext = *ppBucket;
+            *ppBucket = pjhn;
+            pjhn = pNext;
+        }
+        pHashtree->jh_ppjhnOldBucket[pHashtree->jh_u32RehashIndex] = NULL;
+
+        pHashtree->jh_u32RehashIndex ++;
+        u32Step --;
+    }
+
+    /*All nodes are moved, free the old bucket array.*/
+    if (pHashtree->jh_u32RehashIndex == pHashtree->jh_u32NumOfOldBucket)
     {
-        /*If the key length is <= 4, the hash is just the key expressed as an integer.*/
-        ol_memset(temp, 0, 4);
-        ol_memcpy(temp, pKey, u32KeyLen);
-        value = *((olint_t *) temp);
+        jf_jiukun_freeMemory((void **)&pHashtree->jh_ppjhnOldBucket);
+        pHashtree->jh_u32NumOfOldBucket = 0;
+        pHashtree->jh_u32RehashIndex = 0;
+    }
+}
+
+/** Allocate the bucket array if the hash tree is empty, or start resizing if the number of node
+ *  reaches the number of buckets.
+ *
+ *  @note
+ *  -# Failing to allocate the new bucket array for resizing is not an error, the nodes are still
+ *   chained in the old buckets.
+ */
+static u32 _growHashtree(jf_hashtree_t * pHashtree)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_hashtree_node_t ** ppBucket = NULL;
+
+    if (pHashtree->jh_ppjhnBucket == NULL)
+    {
+        u32Ret = _allocHashtreeBucket(&pHashtree->jh_ppjhnBucket, HASHTREE_INITIAL_NUM_OF_BUCKET);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            pHashtree->jh_u32NumOfBucket = HASHTREE_INITIAL_NUM_OF_BUCKET;
     }
-    else
+    else if ((pHashtree->jh_u32NumOfNode >= pHashtree->jh_u32NumOfBucket) &&
+             (pHashtree->jh_u32NumOfBucket < HASHTREE_MAX_NUM_OF_BUCKET))
     {
-        /*If the key length is >4, the hash is the first 4 bytes XOR with the last 4.*/
-        ol_memcpy(temp, pKey, 4);
-        value = *((olint_t *) temp);
-        ol_memcpy(temp, (olchar_t *) pKey + (u32KeyLen - 4), 4);
-        value = value ^ (*((olint_t *) temp));
-
-        /*If the key length is >= 10, the hash is also XOR with the middle 4 bytes.*/
-        if (u32KeyLen >= 10)
+        /*Finish the last resizing before starting a new one.*/
+        if (pHashtree->jh_ppjhnOldBucket != NULL)
+            _rehashHashtree(pHashtree, pHashtree->jh_u32NumOfOldBucket);
+
+        if (_allocHashtreeBucket(&ppBucket, pHashtree->jh_u32NumOfBucket * 2) == JF_ERR_NO_ERROR)
         {
-            ol_memcpy(temp, (olchar_t *) pKey + (u32KeyLen / 2), 4);
-            value = value ^ (*((olint_t *) temp));
+            pHashtree->jh_ppjhnOldBucket = pHashtree->jh_ppjhnBucket;
+            pHashtree->jh_u32NumOfOldBucket = pHashtree->jh_u32NumOfBucket;
+            pHashtree->jh_u32RehashIndex = 0;
+            pHashtree->jh_ppjhnBucket = ppBucket;
+            pHashtree->jh_u32NumOfBucket *= 2;
         }
     }
 
-    return value;
+    return u32Ret;
+}
+
+/** Search the bucket for the node with the key.
+ *
+ *  @return The slot pointing to the node, or the slot at the end of the bucket if the node is not
+ *   found.
+ */
+static inline jf_hashtree_node_t ** _searchHashtreeBucket(
+    jf_hashtree_node_t ** ppjhn, void * pKey, olsize_t sKey, u64 u64Key)
+{
+    /*Integer compares are very fast, this will weed out most non-matches.*/
+    while ((*ppjhn != NULL) &&
+           (((*ppjhn)->jhn_u64Key != u64Key) || ((*ppjhn)->jhn_sKey != sKey) ||
+            (ol_memcmp((*ppjhn)->jhn_pstrKey, pKey, sKey) != 0)))
+        ppjhn = &(*ppjhn)->jhn_pjhnBucketNext;
+
+    return ppjhn;
+}
+
+/** Find the bucket slot pointing to the node with the key.
+ *
+ *  @param pHashtree [in] The hash tree.
+ *  @param pKey [in] The key.
+ *  @param sKey [in] The length of the key.
+ *  @param u64Key [in] The hash value of the key.
+ *
+ *  @return The bucket slot pointing to the node, NULL if the node is not found.
+ */
+static jf_hashtree_node_t ** _findHashtreeBucketSlot(
+    jf_hashtree_t * pHashtree, void * pKey, olsize_t sKey, u64 u64Key)
+{
+    jf_hashtree_node_t ** ppjhn = NULL;
+
+    if (pHashtree->jh_ppjhnBucket == NULL)
+        return NULL;
+
+    ppjhn = _searchHashtreeBucket(
+        &pHashtree->jh_ppjhnBucket[u64Key & (pHashtree->jh_u32NumOfBucket - 1)], pKey, sKey,
+        u64Key);
+
+    /*Search the old bucket if the node is not found and it's resizing.*/
+    if ((*ppjhn == NULL) && (pHashtree->jh_ppjhnOldBucket != NULL))
+        ppjhn = _searchHashtreeBucket(
+            &pHashtree->jh_ppjhnOldBucket[u64Key & (pHashtree->jh_u32NumOfOldBucket - 1)], pKey,
+            sKey, u64Key);
+
+    if (*ppjhn == NULL)
+        ppjhn = NULL;
+
+    return ppjhn;
 }
 
 static u32 _newHashtreeEntry(
-    jf_hashtree_t * pHashtree, void * pKey, olsize_t sKey, olint_t value,
+    jf_hashtree_t * pHashtree, void * pKey, olsize_t sKey, u64 value,
     jf_hashtree_node_t ** ppNode)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_hashtree_node_t * node = NULL;
+    jf_hashtree_node_t * node = NULL, ** ppBucket = NULL;
+
+    u32Ret = _growHashtree(pHashtree);
 
     /*Allocate memory for hashtree node.*/
-    u32Ret = jf_jiukun_allocMemory((void **)&node, sizeof(jf_hashtree_node_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_jiukun_allocMemory((void **)&node, sizeof(jf_hashtree_node_t));
+
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(node, sizeof(jf_hashtree_node_t));
@@ -81,7 +219,7 @@ static u32 _newHashtreeEntry(
         u32Ret = jf_jiukun_cloneMemory((void **)&node->jhn_pstrKey, pKey, sKey);
         if (u32Ret == JF_ERR_NO_ERROR)
         {
-            node->jhn_nKey = value;
+            node->jhn_u64Key = value;
             node->jhn_sKey = sKey;
 
             node->jhn_pjhnNext = pHashtree->jh_pjhnRoot;
@@ -89,6 +227,12 @@ static u32 _newHashtreeEntry(
             if (node->jhn_pjhnNext != NULL)
                 node->jhn_pjhnNext->jhn_pjhnPrev = node;
 
+            /*New node is always added to the new bucket array.*/
+            ppBucket = &pHashtree->jh_ppjhnBucket[value & (pHashtree->jh_u32NumOfBucket - 1)];
+            node->jhn_pjhnBucketNext = *ppBucket;
+            *ppBucket = node;
+            pHashtree->jh_u32NumOfNode ++;
+
             *ppNode = node;
         }
         else
@@ -115,32 +259,24 @@ static u32 _findHashtreeEntry(
     jf_hashtree_node_t ** ppNode)
 {
     u32 u32Ret = JF_ERR_HASHTREE_ENTRY_NOT_FOUND;
-    jf_hashtree_node_t * current = pHashtree->jh_pjhnRoot;
-    olint_t value = _getHashValue(pKey, sKey);
+    u64 value = _getHashValue(pKey, sKey);
+    jf_hashtree_node_t ** ppjhn = NULL;
 
     *ppNode = NULL;
-    /*Iterate through our tree to see if we can find this key entry*/
-    while (current != NULL)
+
+    /*Move some nodes to the new bucket array if it's resizing.*/
+    if (bCreate && (pHashtree->jh_ppjhnOldBucket != NULL))
+        _rehashHashtree(pHashtree, HASHTREE_REHASH_STEP);
+
+    ppjhn = _findHashtreeBucketSlot(pHashtree, pKey, sKey, value);
+    if (ppjhn != NULL)
     {
-        /*Integer compares are very fast, this will weed out most non-matches*/
-        if (current->jhn_nKey == value)
-        {
-            /*Verify this is really a match*/
-            if (current->jhn_sKey == sKey &&
-                ol_memcmp(current->jhn_pstrKey, pKey, sKey) == 0)
-            {
-                *ppNode = current;
-                u32Ret = JF_ERR_NO_ERROR;
-                break;
-            }
-        }
-        current = current->jhn_pjhnNext;
+        *ppNode = *ppjhn;
+        u32Ret = JF_ERR_NO_ERROR;
     }
-
-    if (*ppNode == NULL)
+    else if (bCreate)
     {
-        if (bCreate)
-            u32Ret = _newHashtreeEntry(pHashtree, pKey, sKey, value, ppNode);
+        u32Ret = _newHashtreeEntry(pHashtree, pKey, sKey, value, ppNode);
     }
 
     return u32Ret;
@@ -166,6 +302,7 @@ void jf_hashtree_fini(jf_hashtree_t * pHashtree)
         pjhn = pNode;
     }
 
+    _freeHashtreeBucket(pHashtree);
     jf_hashtree_init(pHashtree);
 }
 
@@ -193,6 +330,7 @@ void jf_hashtree_finiHashtreeAndData(
         pjhn = pNode;
     }
 
+    _freeHashtreeBucket(pHashtree);
     jf_hashtree_init(pHashtree);
 }
 
@@ -245,12 +383,19 @@ u32 jf_hashtree_getEntry(
 
 u32 jf_hashtree_deleteEntry(jf_hashtree_t * pHashtree, olchar_t * pstrKey, olsize_t sKey)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_hashtree_node_t * pjhn = NULL;
+    u32 u32Ret = JF_ERR_HASHTREE_ENTRY_NOT_FOUND;
+    jf_hashtree_node_t * pjhn = NULL, ** ppjhn = NULL;
 
-    u32Ret = _findHashtreeEntry(pHashtree, pstrKey, sKey, FALSE, &pjhn);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    if (pHashtree->jh_ppjhnOldBucket != NULL)
+        _rehashHashtree(pHashtree, HASHTREE_REHASH_STEP);
+
+    ppjhn = _findHashtreeBucketSlot(pHashtree, pstrKey, sKey, _getHashValue(pstrKey, sKey));
+    if (ppjhn != NULL)
     {
+        pjhn = *ppjhn;
+        /*Remove it from the bucket.*/
+        *ppjhn = pjhn->jhn_pjhnBucketNext;
+
         /*Then remove it from the tree.*/
         if (pjhn == pHashtree->jh_pjhnRoot)
         {
@@ -264,8 +409,11 @@ u32 jf_hashtree_deleteEntry(jf_hashtree_t * pHashtree, olchar_t * pstrKey, olsiz
             if (pjhn->jhn_pjhnNext != NULL)
                 pjhn->jhn_pjhnNext->jhn_pjhnPrev = pjhn->jhn_pjhnPrev;
         }
+        pHashtree->jh_u32NumOfNode --;
+
         jf_jiukun_freeMemory((void **)&pjhn->jhn_pstrKey);
         jf_jiukun_freeMemory((void **)&pjhn);
+        u32Ret = JF_ERR_NO_ERROR;
     }
 
     return u32Ret;
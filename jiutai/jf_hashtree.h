@@ -8,12 +8,17 @@
  *  @note
  *  -# Routines declared in this file are included in jf_hashtree object.
  *  -# Link with jiukun library for memory allocation.
- *  -# The simple hash tree, suitable for items less than 50. For large amount of items, uses
- *   hash table in jf_hashtable.h.
+ *  -# The hash tree is a hash map with string key. The nodes are chained in buckets, the bucket
+ *   array is allocated when the first item is added.
+ *  -# The bucket array is doubled when the number of items reaches the number of buckets. The
+ *   nodes are moved to the new array incrementally, a few buckets are moved each time an item is
+ *   added or deleted, so no single operation pays for the whole resize.
+ *  -# All nodes are also chained in a list for enumeration, the new node is added to the head of
+ *   the list. The enumerator is not affected by resizing.
  *  -# This object is not thread safe.
- *  -# The hash tree will hash string key to integer key when adding application data. When
- *   seaching, the integer key is compared firstly and then the string key, this will speed up the
- *   finding of data.
+ *  -# The hash tree will hash string key to 64-bit integer with the hash function in
+ *   jf_hashfunc.h. When seaching, the integer key is compared firstly and then the string key,
+ *   this will speed up the finding of data.
  */
 
 #ifndef JIUTAI_HASHTREE_H
@@ -39,8 +44,10 @@ typedef struct jf_hashtree_node
     struct jf_hashtree_node * jhn_pjhnNext;
     /**The previous node.*/
     struct jf_hashtree_node * jhn_pjhnPrev;
+    /**The next node in the same bucket.*/
+    struct jf_hashtree_node * jhn_pjhnBucketNext;
     /**The key after hash.*/
-    olint_t jhn_nKey;
+    u64 jhn_u64Key;
     /**The key string.*/
     olchar_t * jhn_pstrKey;
     /**The length of the key string.*/
@@ -63,6 +70,18 @@ typedef struct jf_hashtree
 {
     /**The root node of the hash tree.*/
     jf_hashtree_node_t * jh_pjhnRoot;
+    /**The bucket array, the size is power of 2.*/
+    jf_hashtree_node_t ** jh_ppjhnBucket;
+    /**The old bucket array, it's not NULL when the nodes are being moved to the new array.*/
+    jf_hashtree_node_t ** jh_ppjhnOldBucket;
+    /**Number of buckets.*/
+    u32 jh_u32NumOfBucket;
+    /**Number of buckets in old bucket array.*/
+    u32 jh_u32NumOfOldBucket;
+    /**Number of nodes.*/
+    u32 jh_u32NumOfNode;
+    /**Index of the next bucket in old bucket array to be moved.*/
+    u32 jh_u32RehashIndex;
 } jf_hashtree_t;
 
 /** Callback function for freeing data in hash tree node.
@@ -79,7 +98,7 @@ typedef u32 (* jf_hashtree_fnFreeData_t)(void ** ppData);
  */
 static inline void jf_hashtree_init(jf_hashtree_t * pHashtree)
 {
-    pHashtree->jh_pjhnRoot = NULL;
+    ol_bzero(pHashtree, sizeof(jf_hashtree_t));
 }
 
 /** Free resources associated with a hash tree.
@@ -111,6 +130,17 @@ static inline boolean_t jf_hashtree_isEmpty(jf_hashtree_t * pHashtree)
     return ((pHashtree->jh_pjhnRoot == NULL) ? TRUE : FALSE);
 }
 
+/** Get number of items in the hash tree.
+ *
+ *  @param pHashtree [in] The hash tree.
+ *
+ *  @return The number of items.
+ */
+static inline u32 jf_hashtree_getSize(jf_hashtree_t * pHashtree)
+{
+    return pHashtree->jh_u32NumOfNode;
+}
+
 /** Determines if a key entry exists in a hash tree.
  *
  *  @param pHashtree [in] The hash tree to operate on.
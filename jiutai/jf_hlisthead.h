@@ -131,6 +131,27 @@ static inline void jf_hlisthead_addHead(jf_hlisthead_t * h, jf_hlisthead_node_t
     n->jhn_ppjhnPrev = &h->jh_pjhnFirst;
 }
 
+/** Add node "n" before node "next" which is in the list.
+ */
+static inline void jf_hlisthead_addBefore(jf_hlisthead_node_t * n, jf_hlisthead_node_t * next)
+{
+    n->jhn_ppjhnPrev = next->jhn_ppjhnPrev;
+    n->jhn_pjhnNext = next;
+    next->jhn_ppjhnPrev = &n->jhn_pjhnNext;
+    *(n->jhn_ppjhnPrev) = n;
+}
+
+/** Add node "n" after node "prev" which is in the list.
+ */
+static inline void jf_hlisthead_addAfter(jf_hlisthead_node_t * prev, jf_hlisthead_node_t * n)
+{
+    n->jhn_pjhnNext = prev->jhn_pjhnNext;
+    prev->jhn_pjhnNext = n;
+    n->jhn_ppjhnPrev = &prev->jhn_pjhnNext;
+    if (n->jhn_pjhnNext)
+        n->jhn_pjhnNext->jhn_ppjhnPrev = &n->jhn_pjhnNext;
+}
+
 #endif /*JIUTAI_HLISTHEAD_H*/
 
 /*------------------------------------------------------------------------------------------------*/
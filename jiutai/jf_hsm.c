@@ -6,6 +6,12 @@
  *  @author Min Zhang
  *
  *  @note
+ *  -# The transition table is compiled to an index when it's created. If the state id and event
+ *   id in the table are small, the index is a dense [state][event] array, otherwise it's a hash
+ *   table with open addressing. The entries with the same state id and event id are chained in
+ *   table order so the guard functions are checked in the same order as the table.
+ *  -# The sub-state transition table and the callbacks of a state are found with a state index
+ *   which is a hash table with open addressing.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -21,6 +27,24 @@
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** The index value for no transition.
+ */
+#define HSM_INDEX_NONE                           (U32_MAX)
+
+/** The maximum number of cells of dense [state][event] index, hash index is used if the state id
+ *  or event id is too large.
+ */
+#define HSM_MAX_DENSE_INDEX_CELLS                (2048)
+
+/** The initial size of the state index, must be power of 2.
+ */
+#define HSM_INITIAL_STATE_INDEX_SIZE             (16)
+
+/** The multiplier for hashing state id and event id.
+ */
+#define HSM_HASH_MULTIPLIER_STATE                (0x9E3779B1)
+#define HSM_HASH_MULTIPLIER_EVENT                (0x85EBCA77)
+
 /** Define the internal HSM state transition table data type.
  */
 typedef struct internal_hsm_state_transition_table
@@ -34,6 +58,16 @@ typedef struct internal_hsm_state_transition_table
     jf_listhead_t ihstt_jlList;
     /**Current state id.*/
     jf_hsm_state_id_t ihstt_jhsiCurrentStateId;
+    /**Number of transition in the table.*/
+    u32 ihstt_u32NumOfTransition;
+    /**Number of event column in dense index, 0 if the index is hash table.*/
+    u32 ihstt_u32NumOfEvent;
+    /**Number of state row in dense index, or the mask of hash index.*/
+    u32 ihstt_u32NumOfState;
+    /**The index of the first transition for state id and event id.*/
+    u32 * ihstt_pu32Index;
+    /**The index of next transition with the same state id and event id.*/
+    u32 * ihstt_pu32Next;
     /**State transition table.*/
     jf_hsm_transition_t ihstt_jhtTransition[];
 } internal_hsm_state_transition_table_t;
@@ -52,6 +86,19 @@ typedef struct internal_hsm_state_callback
     jf_listhead_t ihsc_jlList;
 } internal_hsm_state_callback_t;
 
+/** Define the internal HSM state index entry data type.
+ */
+typedef struct
+{
+    /**The state id, JF_HSM_LAST_STATE_ID if the entry is not used.*/
+    jf_hsm_state_id_t ihsie_jhsiStateId;
+    u32 ihsie_u32Reserved;
+    /**The sub-state transition table of the state.*/
+    internal_hsm_state_transition_table_t * ihsie_pihsttTable;
+    /**The callbacks of the state.*/
+    internal_hsm_state_callback_t * ihsie_pihscCallback;
+} internal_hsm_state_index_entry_t;
+
 /** Define the internal HSM data type.
  */
 typedef struct
@@ -60,7 +107,14 @@ typedef struct
     jf_listhead_t ih_jlStateTransitionTable;
     /**The state callback list.*/
     jf_listhead_t ih_jlStateCallback;
-
+    /**The top level state transition table, it's also the first table in the list.*/
+    internal_hsm_state_transition_table_t * ih_pihsttTop;
+    /**Number of entry in state index, it's power of 2.*/
+    u32 ih_u32StateIndexSize;
+    /**Number of used entry in state index.*/
+    u32 ih_u32NumOfIndexedState;
+    /**The state index for sub-state transition table and callbacks.*/
+    internal_hsm_state_index_entry_t * ih_pihsieStateIndex;
 } internal_hsm_t;
 
 /* --- private routine section ------------------------------------------------------------------ */
@@ -100,6 +154,116 @@ static u32 _destroyInternalHsmStateTransitionTable(internal_hsm_state_transition
     return u32Ret;
 }
 
+static u32 _getHsmTransitionCount(jf_hsm_transition_t * pTransition)
+{
+    u32 u32Count = 0;
+
+    while ((pTransition->jht_jhsiCurrentStateId != JF_HSM_LAST_STATE_ID) &&
+           (pTransition->jht_jheiEventId != JF_HSM_LAST_EVENT_ID))
+    {
+        u32Count ++;
+        pTransition ++;
+    }
+
+    return u32Count;
+}
+
+static u32 _getHsmTransitionIndexSize(
+    jf_hsm_transition_t * pTransition, u32 u32Count, u32 * pu32NumOfState, u32 * pu32NumOfEvent)
+{
+    u32 u32Index = 0, u32Size = 0;
+    jf_hsm_state_id_t maxStateId = 0;
+    jf_hsm_event_id_t maxEventId = 0;
+
+    for (u32Index = 0; u32Index < u32Count; u32Index ++)
+    {
+        maxStateId = MAX(maxStateId, pTransition[u32Index].jht_jhsiCurrentStateId);
+        maxEventId = MAX(maxEventId, pTransition[u32Index].jht_jheiEventId);
+    }
+
+    if ((u32Count > 0) && (maxStateId < HSM_MAX_DENSE_INDEX_CELLS) &&
+        (maxEventId < HSM_MAX_DENSE_INDEX_CELLS) &&
+        ((maxStateId + 1) * (maxEventId + 1) <= HSM_MAX_DENSE_INDEX_CELLS))
+    {
+        /*The id are small, use dense [state][event] index.*/
+        *pu32NumOfState = maxStateId + 1;
+        *pu32NumOfEvent = maxEventId + 1;
+        u32Size = *pu32NumOfState * *pu32NumOfEvent;
+    }
+    else
+    {
+        /*Use hash index, the size is power of 2 and the load factor is less than 0.5.*/
+        u32Size = 8;
+        while (u32Size < u32Count * 2)
+            u32Size <<= 1;
+
+        *pu32NumOfState = u32Size - 1;
+        *pu32NumOfEvent = 0;
+    }
+
+    return u32Size;
+}
+
+/** Get the slot in the index for the state id and event id.
+ *
+ *  @note
+ *  -# For hash index, the slot returned is either the slot for the state id and event id or an
+ *   empty slot.
+ *  -# NULL is returned if the ids are out of range of the dense index.
+ */
+static u32 * _getHsmTransitionIndexSlot(
+    internal_hsm_state_transition_table_t * pihstt, jf_hsm_state_id_t stateId,
+    jf_hsm_event_id_t eventId)
+{
+    u32 * pu32Slot = NULL;
+    u32 u32Hash = 0;
+    jf_hsm_transition_t * pjht = NULL;
+
+    if (pihstt->ihstt_u32NumOfEvent != 0)
+    {
+        /*Dense index.*/
+        if ((stateId < pihstt->ihstt_u32NumOfState) && (eventId < pihstt->ihstt_u32NumOfEvent))
+            pu32Slot = &pihstt->ihstt_pu32Index[stateId * pihstt->ihstt_u32NumOfEvent + eventId];
+    }
+    else
+    {
+        /*Hash index with linear probing.*/
+        u32Hash = (stateId * HSM_HASH_MULTIPLIER_STATE) ^ (eventId * HSM_HASH_MULTIPLIER_EVENT);
+        u32Hash = (u32Hash ^ (u32Hash >> 16)) & pihstt->ihstt_u32NumOfState;
+
+        while (pihstt->ihstt_pu32Index[u32Hash] != HSM_INDEX_NONE)
+        {
+            pjht = &pihstt->ihstt_jhtTransition[pihstt->ihstt_pu32Index[u32Hash]];
+            if ((pjht->jht_jhsiCurrentStateId == stateId) && (pjht->jht_jheiEventId == eventId))
+                break;
+
+            u32Hash = (u32Hash + 1) & pihstt->ihstt_u32NumOfState;
+        }
+
+        pu32Slot = &pihstt->ihstt_pu32Index[u32Hash];
+    }
+
+    return pu32Slot;
+}
+
+static void _compileHsmTransitionIndex(internal_hsm_state_transition_table_t * pihstt)
+{
+    u32 u32Index = 0;
+    u32 * pu32Slot = NULL;
+    jf_hsm_transition_t * pjht = NULL;
+
+    /*Add the transition in reverse order, so the chain is in table order.*/
+    for (u32Index = pihstt->ihstt_u32NumOfTransition; u32Index > 0; u32Index --)
+    {
+        pjht = &pihstt->ihstt_jhtTransition[u32Index - 1];
+        pu32Slot = _getHsmTransitionIndexSlot(
+            pihstt, pjht->jht_jhsiCurrentStateId, pjht->jht_jheiEventId);
+
+        pihstt->ihstt_pu32Next[u32Index - 1] = *pu32Slot;
+        *pu32Slot = u32Index - 1;
+    }
+}
+
 static u32 _createInternalHsmStateTransitionTable(
     internal_hsm_state_transition_table_t ** ppState, jf_hsm_state_id_t stateId,
     jf_hsm_transition_t * pTransition, jf_hsm_event_id_t initialStateId)
@@ -107,10 +271,16 @@ static u32 _createInternalHsmStateTransitionTable(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hsm_state_transition_table_t * pihstt = NULL;
     olsize_t tsize = 0;
+    u32 u32Count = 0, u32IndexSize = 0, u32NumOfState = 0, u32NumOfEvent = 0;
 
     tsize = _getJfHsmTransitionTableSize(pTransition);
+    u32Count = _getHsmTransitionCount(pTransition);
+    u32IndexSize = _getHsmTransitionIndexSize(
+        pTransition, u32Count, &u32NumOfState, &u32NumOfEvent);
 
-    u32Ret = jf_jiukun_allocMemory((void **)&pihstt, sizeof(*pihstt) + tsize);
+    /*The index and the next array are allocated after the transition table.*/
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pihstt, sizeof(*pihstt) + tsize + (u32Count + u32IndexSize) * sizeof(u32));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         pihstt->ihstt_jhsiStateId = stateId;
@@ -118,6 +288,15 @@ static u32 _createInternalHsmStateTransitionTable(
         pihstt->ihstt_jhsiCurrentStateId = initialStateId;
         ol_memcpy(pihstt->ihstt_jhtTransition, pTransition, tsize);
         jf_listhead_init(&pihstt->ihstt_jlList);
+
+        pihstt->ihstt_u32NumOfTransition = u32Count;
+        pihstt->ihstt_u32NumOfState = u32NumOfState;
+        pihstt->ihstt_u32NumOfEvent = u32NumOfEvent;
+        pihstt->ihstt_pu32Next = (u32 *)((u8 *)pihstt->ihstt_jhtTransition + tsize);
+        pihstt->ihstt_pu32Index = pihstt->ihstt_pu32Next + u32Count;
+        ol_memset(pihstt->ihstt_pu32Index, 0xFF, u32IndexSize * sizeof(u32));
+
+        _compileHsmTransitionIndex(pihstt);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -128,12 +307,103 @@ static u32 _createInternalHsmStateTransitionTable(
     return u32Ret;
 }
 
+/** Get the entry in state index for the state id.
+ *
+ *  @note
+ *  -# The entry returned is either the entry for the state id or an empty entry.
+ */
+static internal_hsm_state_index_entry_t * _getHsmStateIndexEntry(
+    internal_hsm_t * pih, jf_hsm_state_id_t stateId)
+{
+    u32 u32Mask = pih->ih_u32StateIndexSize - 1;
+    u32 u32Hash = stateId * HSM_HASH_MULTIPLIER_STATE;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
+
+    u32Hash = (u32Hash ^ (u32Hash >> 16)) & u32Mask;
+    pihsie = &pih->ih_pihsieStateIndex[u32Hash];
+
+    while ((pihsie->ihsie_jhsiStateId != stateId) &&
+           (pihsie->ihsie_jhsiStateId != JF_HSM_LAST_STATE_ID))
+    {
+        u32Hash = (u32Hash + 1) & u32Mask;
+        pihsie = &pih->ih_pihsieStateIndex[u32Hash];
+    }
+
+    return pihsie;
+}
+
+static u32 _resizeHsmStateIndex(internal_hsm_t * pih, u32 u32Size)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_hsm_state_index_entry_t * pOld = pih->ih_pihsieStateIndex;
+    u32 u32Index = 0, u32OldSize = pih->ih_u32StateIndexSize;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
+
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pih->ih_pihsieStateIndex, u32Size * sizeof(internal_hsm_state_index_entry_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pih->ih_pihsieStateIndex, u32Size * sizeof(internal_hsm_state_index_entry_t));
+        for (u32Index = 0; u32Index < u32Size; u32Index ++)
+            pih->ih_pihsieStateIndex[u32Index].ihsie_jhsiStateId = JF_HSM_LAST_STATE_ID;
+        pih->ih_u32StateIndexSize = u32Size;
+
+        /*Rehash the entries in old index.*/
+        for (u32Index = 0; u32Index < u32OldSize; u32Index ++)
+        {
+            if (pOld[u32Index].ihsie_jhsiStateId == JF_HSM_LAST_STATE_ID)
+                continue;
+
+            pihsie = _getHsmStateIndexEntry(pih, pOld[u32Index].ihsie_jhsiStateId);
+            ol_memcpy(pihsie, &pOld[u32Index], sizeof(*pihsie));
+        }
+
+        if (pOld != NULL)
+            jf_jiukun_freeMemory((void **)&pOld);
+    }
+    else
+    {
+        pih->ih_pihsieStateIndex = pOld;
+    }
+
+    return u32Ret;
+}
+
+static u32 _addHsmStateIndexEntry(
+    internal_hsm_t * pih, jf_hsm_state_id_t stateId, internal_hsm_state_index_entry_t ** ppEntry)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
+
+    pihsie = _getHsmStateIndexEntry(pih, stateId);
+    if (pihsie->ihsie_jhsiStateId == JF_HSM_LAST_STATE_ID)
+    {
+        /*Keep the load factor less than 0.5.*/
+        if ((pih->ih_u32NumOfIndexedState + 1) * 2 > pih->ih_u32StateIndexSize)
+        {
+            u32Ret = _resizeHsmStateIndex(pih, pih->ih_u32StateIndexSize * 2);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                pihsie = _getHsmStateIndexEntry(pih, stateId);
+        }
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            pihsie->ihsie_jhsiStateId = stateId;
+            pih->ih_u32NumOfIndexedState ++;
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        *ppEntry = pihsie;
+
+    return u32Ret;
+}
+
 static u32 _getInternalHsmStateTransitionTable(
     internal_hsm_t * pih, jf_hsm_state_id_t stateId, internal_hsm_state_transition_table_t ** ppState)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_listhead_t * pos = NULL;
-    internal_hsm_state_transition_table_t * pihstt = NULL;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
 
     *ppState = NULL;
 
@@ -142,19 +412,12 @@ static u32 _getInternalHsmStateTransitionTable(
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        u32Ret = JF_ERR_HSM_STATE_NOT_FOUND;
+        pihsie = _getHsmStateIndexEntry(pih, stateId);
 
-        jf_listhead_forEach(&pih->ih_jlStateTransitionTable, pos)
-        {
-            pihstt = jf_listhead_getEntry(pos, internal_hsm_state_transition_table_t, ihstt_jlList);
-
-            if (pihstt->ihstt_jhsiStateId == stateId)
-            {
-                u32Ret = JF_ERR_NO_ERROR;
-                *ppState = pihstt;
-                break;
-            }
-        }
+        if (pihsie->ihsie_pihsttTable != NULL)
+            *ppState = pihsie->ihsie_pihsttTable;
+        else
+            u32Ret = JF_ERR_HSM_STATE_NOT_FOUND;
     }
 
     return u32Ret;
@@ -189,8 +452,7 @@ static u32 _getInternalHsmStateCallback(
     internal_hsm_t * pih, jf_hsm_state_id_t stateId, internal_hsm_state_callback_t ** ppCallback)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_listhead_t * pos = NULL;
-    internal_hsm_state_callback_t * pihsc = NULL;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
 
     *ppCallback = NULL;
 
@@ -199,18 +461,12 @@ static u32 _getInternalHsmStateCallback(
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        u32Ret = JF_ERR_HSM_STATE_NOT_FOUND;
-        jf_listhead_forEach(&pih->ih_jlStateCallback, pos)
-        {
-            pihsc = jf_listhead_getEntry(pos, internal_hsm_state_callback_t, ihsc_jlList);
+        pihsie = _getHsmStateIndexEntry(pih, stateId);
 
-            if (pihsc->ihsc_jhsiStateId == stateId)
-            {
-                u32Ret = JF_ERR_NO_ERROR;
-                *ppCallback = pihsc;
-                break;
-            }
-        }
+        if (pihsie->ihsie_pihscCallback != NULL)
+            *ppCallback = pihsie->ihsie_pihscCallback;
+        else
+            u32Ret = JF_ERR_HSM_STATE_NOT_FOUND;
     }
 
     return u32Ret;
@@ -266,28 +522,32 @@ static u32 _processHsmEvent(
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     jf_hsm_transition_t * pjht = NULL;
+    u32 * pu32Slot = NULL;
+    u32 u32Index = HSM_INDEX_NONE;
 
-    /*Check the entry one by one in the state transition table.*/
-    pjht = pihstt->ihstt_jhtTransition;
-    while (pjht->jht_jheiEventId != JF_HSM_LAST_EVENT_ID)
+    /*Find the first entry for current state and the event in the index.*/
+    pu32Slot = _getHsmTransitionIndexSlot(
+        pihstt, pihstt->ihstt_jhsiCurrentStateId, pEvent->jhe_jheiEventId);
+    if (pu32Slot != NULL)
+        u32Index = *pu32Slot;
+
+    /*Check the entries with the same state id and event id in table order.*/
+    while (u32Index != HSM_INDEX_NONE)
     {
-        if ((pjht->jht_jhsiCurrentStateId == pihstt->ihstt_jhsiCurrentStateId) &&
-            (pjht->jht_jheiEventId == pEvent->jhe_jheiEventId))
-        {
-            *pbHit = TRUE;
+        pjht = &pihstt->ihstt_jhtTransition[u32Index];
+        *pbHit = TRUE;
 
-            if ((pjht->jht_fnGuard == NULL) || pjht->jht_fnGuard(pEvent))
-            {
-                /*Execute the callback action function.*/
-                u32Ret = _executeHsmStateAction(pjht, pEvent);
+        if ((pjht->jht_fnGuard == NULL) || pjht->jht_fnGuard(pEvent))
+        {
+            /*Execute the callback action function.*/
+            u32Ret = _executeHsmStateAction(pjht, pEvent);
 
-                _postHsmStateTransition(pih, pihstt, pEvent, pjht);
+            _postHsmStateTransition(pih, pihstt, pEvent, pjht);
 
-                break;
-            }
+            break;
         }
 
-        pjht ++;
+        u32Index = pihstt->ihstt_pu32Next[u32Index];
     }
 
     return u32Ret;
@@ -319,6 +579,9 @@ u32 jf_hsm_destroy(jf_hsm_t ** ppHsm)
         _destroyInternalHsmStateCallback(&pihsc);
     }
 
+    if (pih->ih_pihsieStateIndex != NULL)
+        jf_jiukun_freeMemory((void **)&pih->ih_pihsieStateIndex);
+
     jf_jiukun_freeMemory(ppHsm);
 
     return u32Ret;
@@ -334,9 +597,15 @@ u32 jf_hsm_create(
     u32Ret = jf_jiukun_allocMemory((void **)&pih, sizeof(*pih));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
+        ol_bzero(pih, sizeof(*pih));
         jf_listhead_init(&pih->ih_jlStateTransitionTable);
         jf_listhead_init(&pih->ih_jlStateCallback);
 
+        u32Ret = _resizeHsmStateIndex(pih, HSM_INITIAL_STATE_INDEX_SIZE);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
         /*Create top level state transition table.*/
         u32Ret = _createInternalHsmStateTransitionTable(
             &pihstt, JF_HSM_LAST_STATE_ID, pTransition, initialStateId);
@@ -345,6 +614,7 @@ u32 jf_hsm_create(
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         jf_listhead_add(&pih->ih_jlStateTransitionTable, &pihstt->ihstt_jlList);
+        pih->ih_pihsttTop = pihstt;
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -362,12 +632,10 @@ jf_hsm_state_id_t jf_hsm_getCurrentStateId(jf_hsm_t * pjh)
     internal_hsm_state_transition_table_t * pihstt = NULL;
     jf_hsm_state_id_t stateId = JF_HSM_LAST_STATE_ID;
 
-    assert(! jf_listhead_isEmpty(&pih->ih_jlStateTransitionTable));
+    assert(pih->ih_pihsttTop != NULL);
 
     /*Get current state in top level state transition table.*/
-    pihstt = jf_listhead_getEntry(
-        pih->ih_jlStateTransitionTable.jl_pjlNext, internal_hsm_state_transition_table_t, ihstt_jlList);
-    stateId = pihstt->ihstt_jhsiCurrentStateId;
+    stateId = pih->ih_pihsttTop->ihstt_jhsiCurrentStateId;
 
     /*If the state has transition table, return the current state in lower level transiton table.*/
     u32Ret = _getInternalHsmStateTransitionTable(pih, stateId, &pihstt);
@@ -384,38 +652,16 @@ u32 jf_hsm_processEvent(jf_hsm_t * pjh, jf_hsm_event_t * pEvent)
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hsm_t * pih = (internal_hsm_t *)pjh;
     boolean_t bHit = FALSE;
-    jf_listhead_t * pos = NULL;
-    internal_hsm_state_transition_table_t * pihstt = NULL;
-    jf_hsm_state_id_t stateId = JF_HSM_LAST_STATE_ID;
+    internal_hsm_state_transition_table_t * pihstt = pih->ih_pihsttTop;
+    jf_hsm_state_id_t stateId = pihstt->ihstt_jhsiCurrentStateId;
 
-    /*The top level state transition table is the first table in the list.*/
-    jf_listhead_forEach(&pih->ih_jlStateTransitionTable, pos)
-    {
-        pihstt = jf_listhead_getEntry(pos, internal_hsm_state_transition_table_t, ihstt_jlList);
+    /*Top level state transition table.*/
+    _processHsmEvent(pih, pihstt, pEvent, &bHit);
 
-        if (pihstt->ihstt_jhsiStateId == JF_HSM_LAST_STATE_ID)
-        {
-            /*Top level state transition table.*/
-            stateId = pihstt->ihstt_jhsiCurrentStateId;
-            _processHsmEvent(pih, pihstt, pEvent, &bHit);
-            /*Hit, we can quit. The state id and event id are match with one entry in state
-              transition table.*/
-            if (bHit)
-                break;
-        }
-        else
-        {
-            /*Lower level state transition table. The state id must be the same.*/
-            if (pihstt->ihstt_jhsiStateId == stateId)
-            {
-                _processHsmEvent(pih, pihstt, pEvent, &bHit);
-                /*Hit, we can quit. The state id and event id are match with one entry in state
-                  transition table.*/
-                if (bHit)
-                    break;
-            }
-        }
-    }
+    /*Not hit, try the lower level state transition table of the state.*/
+    if ((! bHit) &&
+        (_getInternalHsmStateTransitionTable(pih, stateId, &pihstt) == JF_ERR_NO_ERROR))
+        _processHsmEvent(pih, pihstt, pEvent, &bHit);
 
     return u32Ret;
 }
@@ -427,19 +673,20 @@ u32 jf_hsm_addStateTransition(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hsm_t * pih = (internal_hsm_t *)pHsm;
     internal_hsm_state_transition_table_t * pihstt = NULL;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
 
     assert(stateId != JF_HSM_LAST_STATE_ID);
     
-    /*Get state transition table for the state.*/
-    u32Ret = _getInternalHsmStateTransitionTable(pih, stateId, &pihstt);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    /*Get the entry of state index for the state.*/
+    u32Ret = _addHsmStateIndexEntry(pih, stateId, &pihsie);
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pihsie->ihsie_pihsttTable != NULL))
     {
         /*Free the old state transition table.*/
-        jf_listhead_del(&pihstt->ihstt_jlList);
-        _destroyInternalHsmStateTransitionTable(&pihstt);
+        jf_listhead_del(&pihsie->ihsie_pihsttTable->ihstt_jlList);
+        _destroyInternalHsmStateTransitionTable(&pihsie->ihsie_pihsttTable);
     }
 
-    if ((u32Ret == JF_ERR_NO_ERROR) || (u32Ret == JF_ERR_HSM_STATE_NOT_FOUND))
+    if (u32Ret == JF_ERR_NO_ERROR)
     {
         /*Create state transition table and add to the list.*/
         u32Ret = _createInternalHsmStateTransitionTable(
@@ -447,6 +694,7 @@ u32 jf_hsm_addStateTransition(
         if (u32Ret == JF_ERR_NO_ERROR)
         {
             jf_listhead_addTail(&pih->ih_jlStateTransitionTable, &pihstt->ihstt_jlList);
+            pihsie->ihsie_pihsttTable = pihstt;
         }
     }
 
@@ -460,6 +708,7 @@ u32 jf_hsm_addStateCallback(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_hsm_t * pih = (internal_hsm_t *)pHsm;
     internal_hsm_state_callback_t * pihsc = NULL;
+    internal_hsm_state_index_entry_t * pihsie = NULL;
 
     assert((fnOnEntry != NULL) && (fnOnEntry != NULL));
 
@@ -474,10 +723,15 @@ u32 jf_hsm_addStateCallback(
     else if (u32Ret == JF_ERR_HSM_STATE_NOT_FOUND)
     {
         /*The callback is not found, create one and add to the list.*/
-        u32Ret = _createInternalHsmStateCallback(&pihsc, stateId, fnOnEntry, fnOnExit);
+        u32Ret = _addHsmStateIndexEntry(pih, stateId, &pihsie);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _createInternalHsmStateCallback(&pihsc, stateId, fnOnEntry, fnOnExit);
+
         if (u32Ret == JF_ERR_NO_ERROR)
         {
             jf_listhead_addTail(&pih->ih_jlStateCallback, &pihsc->ihsc_jlList);
+            pihsie->ihsie_pihscCallback = pihsc;
         }
     }
 
@@ -10,6 +10,9 @@
  *  -# This object is NOT thread safe.
  *  -# Do not call jf_hsm_processEvent() to transit state in fnEventAction() as jf_hsm_processEvent()
  *     cannot be called recursively.
+ *  -# The transition table is compiled to an index when it's added, the cost to find the
+ *     transition for an event is O(1). The index is a dense array if the state id and event id are
+ *     small, so use small consecutive id for state machine driven at high rate.
  *
  *  <HR>
  *
@@ -77,6 +77,15 @@
 
 /* --- data structures -------------------------------------------------------------------------- */
 
+/** Callback function to notify the memory pressure, it's called by the reclaimer thread.
+ *
+ *  @param u32FreePercent [in] The percentage of free memory in the pool.
+ *  @param pArg [in] The argument specified when jiukun is initialized.
+ *
+ *  @return Void.
+ */
+typedef void (* jf_jiukun_fnNotifyPressure_t)(u32 u32FreePercent, void * pArg);
+
 /** Define the parameters for initializing jiukun.
  */
 typedef struct
@@ -87,8 +96,28 @@ typedef struct
     olsize_t jjip_sPool;
     /**No grow when the initial pool is full.*/
     boolean_t jjip_bNoGrow;
+    /**Back the pool with 2MB huge pages, transparent huge page is used if no huge page is
+       reserved in the system. Linux only.*/
+    boolean_t jjip_bHugePage;
+    /**Bind the pool to NUMA node, memory is allocated from the pool on the local node of the
+       calling thread. Linux only.*/
+    boolean_t jjip_bNumaNode;
+    /**Start a reclaimer thread which gives the free memory back periodically. The free slabs are
+       reaped and the free pages are returned to the kernel.*/
+    boolean_t jjip_bReclaimer;
+    /**Interval of the reclaimer in millisecond, 1 second if it's 0.*/
+    u32 jjip_u32ReclaimInterval;
+    /**Reap the free slabs when the memory held by them is more than the threshold in byte, 4MB if
+       it's 0.*/
+    olsize_t jjip_sReclaimThreshold;
+    /**Notify the memory pressure when the free memory in the pool is less than the percentage,
+       10% if it's 0.*/
+    u8 jjip_u8PressurePercent;
     u8 jjip_u8Reserved[3];
-    u32 jjip_u32Reserved[7];
+    /**Callback function to notify the memory pressure, it's optional.*/
+    jf_jiukun_fnNotifyPressure_t jjip_fnNotifyPressure;
+    /**Argument of the callback function.*/
+    void * jjip_pPressureArg;
 } jf_jiukun_init_param_t;
 
 /** Define the jiukun cache data type.
@@ -112,6 +141,9 @@ typedef enum jf_jiukun_cache_create_flag
     JF_JIUKUN_CACHE_CREATE_FLAG_ZERO,
     /**Wait if memory fails to be allocated.*/
     JF_JIUKUN_CACHE_CREATE_FLAG_WAIT,
+    /**Align the object to CPU cache line (64 bytes), the object written frequently by different
+       threads does not share cache line with others.*/
+    JF_JIUKUN_CACHE_CREATE_FLAG_HWCACHE_ALIGN,
 } jf_jiukun_cache_create_flag_t;
 
 /** Parameters for creating jiukun cache.
@@ -181,6 +213,32 @@ JIUKUNAPI u32 JIUKUNCALL jf_jiukun_allocPage(void ** pptr, u32 u32Order, jf_flag
  */
 JIUKUNAPI void JIUKUNCALL jf_jiukun_freePage(void ** pptr);
 
+/** Allocate large memory.
+ *
+ *  @note
+ *  -# The memory is allocated from jiukun slab if the size is not larger than the maximum memory
+ *   size of jiukun, otherwise it's allocated from jiukun page allocator.
+ *  -# The memory must be freed by jf_jiukun_freeLargeMemory() with the same size.
+ *
+ *  @param pptr [out] A pointer to the memory address allocated.
+ *  @param size [in] Bytes of memory are required.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_JIUKUN_OUT_OF_MEMORY Out of memory.
+ *  @retval JF_ERR_INVALID_JIUKUN_PAGE_ORDER The size is too large.
+ */
+JIUKUNAPI u32 JIUKUNCALL jf_jiukun_allocLargeMemory(void ** pptr, olsize_t size);
+
+/** Free large memory allocated by jf_jiukun_allocLargeMemory().
+ *
+ *  @param pptr [in/out] A pointer to the memory address.
+ *  @param size [in] Bytes of memory used for allocation.
+ *
+ *  @return Void.
+ */
+JIUKUNAPI void JIUKUNCALL jf_jiukun_freeLargeMemory(void ** pptr, olsize_t size);
+
 /* jiukun cache */
 
 /** Create a jiukun cache.
@@ -240,6 +298,23 @@ JIUKUNAPI u32 JIUKUNCALL jf_jiukun_allocMemory(void ** pptr, olsize_t size);
  */
 JIUKUNAPI void JIUKUNCALL jf_jiukun_freeMemory(void ** pptr);
 
+/** Reallocate memory.
+ *
+ *  @note
+ *  -# The memory is not changed if the size is less than the size of the memory allocated.
+ *  -# The memory is extended in place if the adjacent pages are free, otherwise new memory is
+ *   allocated and the data is copied.
+ *  -# The original memory is not changed if the reallocation fails.
+ *  -# New memory is allocated if the original memory is NULL.
+ *
+ *  @param pptr [in/out] Pointer to memory.
+ *  @param size [in] Bytes of memory are required.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+JIUKUNAPI u32 JIUKUNCALL jf_jiukun_reallocMemory(void ** pptr, olsize_t size);
+
 /** Clone memory.
  *
  *  @param pptr [out] Pointer to memory cloned.
@@ -6,11 +6,24 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The contention profiler keeps the acquire sites in a fixed size open addressing table, the
+ *   site is added to the table with a lock when it's seen for the first time. The statistic is
+ *   updated with atomic operations.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#if defined(LINUX) && ! defined(_GNU_SOURCE)
+    /*The object is also built by libraries without _GNU_SOURCE, pthread_mutex_clocklock()
+      requires it.*/
+    #define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#if defined(LINUX)
+    #include <errno.h>
+    #include <time.h>
+#endif
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -18,12 +31,223 @@
 #include "jf_mutex.h"
 #include "jf_err.h"
 #include "jf_time.h"
+#include "jf_atomic.h"
+
+/*The real routines are defined in this file.*/
+#undef jf_mutex_acquire
+#undef jf_mutex_tryAcquire
+#undef jf_mutex_acquireWithTimeout
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+#if defined(JF_MUTEX_PROFILE)
+
+/** Maximum number of acquire sites, it must be power of 2.
+ */
+#define MAX_MUTEX_PROFILE_SITE          (1024)
+
+/** The acquire site in profiler.
+ */
+typedef struct
+{
+    /**The site is ready to use if it's TRUE.*/
+    u32 mps_u32Ready;
+    /**The line of the site.*/
+    u32 mps_u32Line;
+    /**The file of the site.*/
+    const olchar_t * mps_pstrFile;
+    /**Number of successful acquire.*/
+    u64 mps_u64Acquire;
+    /**Number of acquire which has to wait.*/
+    u64 mps_u64Contended;
+    /**Number of failed acquire.*/
+    u64 mps_u64Fail;
+    /**Total wait time in nanoseconds.*/
+    u64 mps_u64WaitTime;
+    /**Maximum wait time in nanoseconds.*/
+    u64 mps_u64MaxWaitTime;
+    /**Total hold time in nanoseconds.*/
+    u64 mps_u64HoldTime;
+    /**Maximum hold time in nanoseconds.*/
+    u64 mps_u64MaxHoldTime;
+} mutex_profile_site_t;
+
+/** The acquire sites.
+ */
+static mutex_profile_site_t ls_mpsMutexProfileSite[MAX_MUTEX_PROFILE_SITE];
+
+/** Number of acquire sites which can't be added as the table is full.
+ */
+static u64 ls_u64MutexProfileOverflow;
+
+/** The lock for adding acquire site, the mutex is not used to avoid recursion.
+ */
+static u32 ls_u32MutexProfileSiteLock;
+
+/** The result is printed when the process exits if it's TRUE.
+ */
+static u32 ls_u32MutexProfileAtExit;
+
+#endif
 
 /* --- private routine section ------------------------------------------------------------------ */
 
+#if defined(LINUX)
+
+/** Get the absolute deadline of the clock.
+ */
+static void _getMutexDeadline(clockid_t clockId, u32 u32Timeout, struct timespec * ptsDeadline)
+{
+    clock_gettime(clockId, ptsDeadline);
+    ptsDeadline->tv_sec += u32Timeout / 1000;
+    ptsDeadline->tv_nsec += (u32Timeout % 1000) * 1000000;
+    if (ptsDeadline->tv_nsec >= 1000000000)
+    {
+        ptsDeadline->tv_sec ++;
+        ptsDeadline->tv_nsec -= 1000000000;
+    }
+}
+
+#endif
+
+#if defined(JF_MUTEX_PROFILE)
+
+static u64 _getMutexProfileTime(void)
+{
+#if defined(LINUX)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+#elif defined(WINDOWS)
+    LARGE_INTEGER liCounter, liFreq;
+
+    QueryPerformanceCounter(&liCounter);
+    QueryPerformanceFrequency(&liFreq);
+
+    return (u64)((double)liCounter.QuadPart * 1000000000.0 / (double)liFreq.QuadPart);
+#endif
+}
+
+static void _updateMutexProfileMax(u64 * pu64Max, u64 u64Value)
+{
+    u64 u64Max = jf_atomic_loadU64(pu64Max);
+
+    while ((u64Value > u64Max) && (! jf_atomic_casU64(pu64Max, u64Max, u64Value)))
+        u64Max = jf_atomic_loadU64(pu64Max);
+}
+
+static void _printMutexProfileAtExit(void)
+{
+    jf_mutex_printProfile();
+}
+
+/** Find the acquire site, add it if it's not found.
+ *
+ *  @return The acquire site, NULL if the table is full.
+ */
+static mutex_profile_site_t * _getMutexProfileSite(const olchar_t * pstrFile, u32 u32Line)
+{
+    mutex_profile_site_t * pSite = NULL;
+    u32 u32Hash = (u32)((((u64)(size_t)pstrFile >> 3) * 31 + u32Line) * 2654435761U);
+    u32 u32Index, u32Count;
+
+    for (u32Count = 0; u32Count < MAX_MUTEX_PROFILE_SITE; u32Count ++)
+    {
+        u32Index = (u32Hash + u32Count) & (MAX_MUTEX_PROFILE_SITE - 1);
+        pSite = &ls_mpsMutexProfileSite[u32Index];
+
+        if (! jf_atomic_loadU32(&pSite->mps_u32Ready))
+        {
+            /*Add the site with lock, the slot may be taken by other thread.*/
+            while (! jf_atomic_casU32(&ls_u32MutexProfileSiteLock, 0, 1))
+                jf_atomic_cpuRelax();
+
+            if (! jf_atomic_loadU32(&pSite->mps_u32Ready))
+            {
+                pSite->mps_pstrFile = pstrFile;
+                pSite->mps_u32Line = u32Line;
+                jf_atomic_storeU32(&pSite->mps_u32Ready, TRUE);
+            }
+
+            jf_atomic_storeU32(&ls_u32MutexProfileSiteLock, 0);
+
+            if (jf_atomic_casU32(&ls_u32MutexProfileAtExit, 0, 1))
+                atexit(_printMutexProfileAtExit);
+        }
+
+        if ((pSite->mps_pstrFile == pstrFile) && (pSite->mps_u32Line == u32Line))
+            return pSite;
+    }
+
+    jf_atomic_fetchAddU64(&ls_u64MutexProfileOverflow, 1);
+
+    return NULL;
+}
+
+/** Record the acquire for the site.
+ */
+static void _recordMutexProfileAcquire(
+    jf_mutex_t * pMutex, u32 u32Ret, const olchar_t * pstrFile, u32 u32Line, u64 u64WaitTime,
+    boolean_t bContended)
+{
+    mutex_profile_site_t * pSite = _getMutexProfileSite(pstrFile, u32Line);
+
+    if (pSite == NULL)
+        return;
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        jf_atomic_fetchAddU64(&pSite->mps_u64Fail, 1);
+        return;
+    }
+
+    jf_atomic_fetchAddU64(&pSite->mps_u64Acquire, 1);
+    if (bContended)
+    {
+        jf_atomic_fetchAddU64(&pSite->mps_u64Contended, 1);
+        jf_atomic_fetchAddU64(&pSite->mps_u64WaitTime, u64WaitTime);
+        _updateMutexProfileMax(&pSite->mps_u64MaxWaitTime, u64WaitTime);
+    }
+
+    /*The holder owns these fields until the mutex is released.*/
+    pMutex->jm_pSite = pSite;
+    pMutex->jm_u64AcquireTime = _getMutexProfileTime();
+}
+
+/** Record the hold time for the site which acquired the mutex.
+ */
+static void _recordMutexProfileRelease(jf_mutex_t * pMutex)
+{
+    mutex_profile_site_t * pSite = pMutex->jm_pSite;
+    u64 u64HoldTime;
+
+    if (pSite == NULL)
+        return;
+
+    pMutex->jm_pSite = NULL;
+    u64HoldTime = _getMutexProfileTime() - pMutex->jm_u64AcquireTime;
+
+    jf_atomic_fetchAddU64(&pSite->mps_u64HoldTime, u64HoldTime);
+    _updateMutexProfileMax(&pSite->mps_u64MaxHoldTime, u64HoldTime);
+}
+
+static olint_t _compareMutexProfileSite(const void * pA, const void * pB)
+{
+    const mutex_profile_site_t * pSiteA = *(const mutex_profile_site_t **)pA;
+    const mutex_profile_site_t * pSiteB = *(const mutex_profile_site_t **)pB;
+
+    if (pSiteA->mps_u64WaitTime != pSiteB->mps_u64WaitTime)
+        return (pSiteA->mps_u64WaitTime < pSiteB->mps_u64WaitTime) ? 1 : -1;
+
+    if (pSiteA->mps_u64HoldTime != pSiteB->mps_u64HoldTime)
+        return (pSiteA->mps_u64HoldTime < pSiteB->mps_u64HoldTime) ? 1 : -1;
+
+    return 0;
+}
+
+#endif
 
 /* --- public routine section ------------------------------------------------------------------- */
 
@@ -58,6 +282,35 @@ u32 jf_mutex_init(jf_mutex_t * pMutex)
     return u32Ret;
 }
 
+u32 jf_mutex_initAdaptive(jf_mutex_t * pMutex)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert(pMutex != NULL);
+
+#if defined(WINDOWS)
+    u32Ret = jf_mutex_init(pMutex);
+#elif defined(LINUX)
+    olint_t nRet;
+    pthread_mutexattr_t attr;
+
+    memset(pMutex, 0, sizeof(jf_mutex_t));
+
+    pthread_mutexattr_init(&attr);
+  #if defined(PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP)
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+  #endif
+    nRet = pthread_mutex_init(&(pMutex->jm_ptmMutex), &attr);
+    if (nRet != 0)
+    {
+        u32Ret = JF_ERR_FAIL_CREATE_MUTEX;
+    }
+    pthread_mutexattr_destroy(&attr);
+#endif
+
+    return u32Ret;
+}
+
 u32 jf_mutex_fini(jf_mutex_t * pMutex)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -174,17 +427,27 @@ u32 jf_mutex_acquireWithTimeout(jf_mutex_t * pMutex, u32 u32Timeout)
     }
 #elif defined(LINUX)
     olint_t nRet = 0;
+    struct timespec tsDeadline;
 
     assert(pMutex != NULL);
 
     nRet = pthread_mutex_trylock(&(pMutex->jm_ptmMutex));
-    if (nRet != 0)
+    if (nRet == EBUSY)
     {
-        usleep(u32Timeout * 1000);
-        nRet = pthread_mutex_trylock(&(pMutex->jm_ptmMutex));
-        if (nRet != 0)
-            u32Ret = JF_ERR_FAIL_ACQUIRE_MUTEX;
+  #if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 30))
+        _getMutexDeadline(CLOCK_MONOTONIC, u32Timeout, &tsDeadline);
+        nRet = pthread_mutex_clocklock(&(pMutex->jm_ptmMutex), CLOCK_MONOTONIC, &tsDeadline);
+  #else
+        /*The timed lock only supports realtime clock.*/
+        _getMutexDeadline(CLOCK_REALTIME, u32Timeout, &tsDeadline);
+        nRet = pthread_mutex_timedlock(&(pMutex->jm_ptmMutex), &tsDeadline);
+  #endif
     }
+
+    if (nRet == ETIMEDOUT)
+        u32Ret = JF_ERR_TIMEOUT;
+    else if (nRet != 0)
+        u32Ret = JF_ERR_FAIL_ACQUIRE_MUTEX;
 #endif
     
     return u32Ret;
@@ -202,7 +465,11 @@ u32 jf_mutex_release(jf_mutex_t * pMutex)
     BOOL bRet = TRUE;
 
     assert(pMutex != NULL);
-    
+
+  #if defined(JF_MUTEX_PROFILE)
+    _recordMutexProfileRelease(pMutex);
+  #endif
+
     bRet = ReleaseMutex(pMutex->jm_hMutex);
     if (bRet == FALSE)
     {
@@ -213,6 +480,10 @@ u32 jf_mutex_release(jf_mutex_t * pMutex)
 
     assert(pMutex != NULL);
 
+  #if defined(JF_MUTEX_PROFILE)
+    _recordMutexProfileRelease(pMutex);
+  #endif
+
     nRet = pthread_mutex_unlock(&(pMutex->jm_ptmMutex));
     if (nRet != 0)
     {
@@ -223,6 +494,119 @@ u32 jf_mutex_release(jf_mutex_t * pMutex)
     return u32Ret;
 }
 
+void jf_mutex_printProfile(void)
+{
+#if defined(JF_MUTEX_PROFILE)
+    mutex_profile_site_t * pSite[MAX_MUTEX_PROFILE_SITE];
+    u32 u32Index, u32NumOfSite = 0;
+
+    for (u32Index = 0; u32Index < MAX_MUTEX_PROFILE_SITE; u32Index ++)
+    {
+        if (jf_atomic_loadU32(&ls_mpsMutexProfileSite[u32Index].mps_u32Ready))
+            pSite[u32NumOfSite ++] = &ls_mpsMutexProfileSite[u32Index];
+    }
+
+    qsort(pSite, u32NumOfSite, sizeof(pSite[0]), _compareMutexProfileSite);
+
+    fprintf(
+        stderr, "mutex contention profile, %u sites, %llu sites dropped\n", u32NumOfSite,
+        jf_atomic_loadU64(&ls_u64MutexProfileOverflow));
+    fprintf(
+        stderr, "%10s %10s %6s %12s %10s %10s %12s %10s %10s  %s\n", "acquire", "contended", "fail",
+        "wait(us)", "avg(ns)", "max(us)", "hold(us)", "avg(ns)", "max(us)", "site");
+
+    for (u32Index = 0; u32Index < u32NumOfSite; u32Index ++)
+    {
+        fprintf(
+            stderr, "%10llu %10llu %6llu %12llu %10llu %10llu %12llu %10llu %10llu  %s:%u\n",
+            pSite[u32Index]->mps_u64Acquire, pSite[u32Index]->mps_u64Contended,
+            pSite[u32Index]->mps_u64Fail, pSite[u32Index]->mps_u64WaitTime / 1000,
+            pSite[u32Index]->mps_u64WaitTime / MAX(pSite[u32Index]->mps_u64Contended, 1),
+            pSite[u32Index]->mps_u64MaxWaitTime / 1000, pSite[u32Index]->mps_u64HoldTime / 1000,
+            pSite[u32Index]->mps_u64HoldTime / MAX(pSite[u32Index]->mps_u64Acquire, 1),
+            pSite[u32Index]->mps_u64MaxHoldTime / 1000, pSite[u32Index]->mps_pstrFile,
+            pSite[u32Index]->mps_u32Line);
+    }
+#endif
+}
+
+void jf_mutex_resetProfile(void)
+{
+#if defined(JF_MUTEX_PROFILE)
+    u32 u32Index;
+    mutex_profile_site_t * pSite;
+
+    /*The sites are kept, only the statistic is cleared.*/
+    for (u32Index = 0; u32Index < MAX_MUTEX_PROFILE_SITE; u32Index ++)
+    {
+        pSite = &ls_mpsMutexProfileSite[u32Index];
+
+        jf_atomic_storeU64(&pSite->mps_u64Acquire, 0);
+        jf_atomic_storeU64(&pSite->mps_u64Contended, 0);
+        jf_atomic_storeU64(&pSite->mps_u64Fail, 0);
+        jf_atomic_storeU64(&pSite->mps_u64WaitTime, 0);
+        jf_atomic_storeU64(&pSite->mps_u64MaxWaitTime, 0);
+        jf_atomic_storeU64(&pSite->mps_u64HoldTime, 0);
+        jf_atomic_storeU64(&pSite->mps_u64MaxHoldTime, 0);
+    }
+    jf_atomic_storeU64(&ls_u64MutexProfileOverflow, 0);
+#endif
+}
+
+#if defined(JF_MUTEX_PROFILE)
+
+u32 jf_mutex_acquireProfiled(jf_mutex_t * pMutex, const olchar_t * pstrFile, u32 u32Line)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Time = 0;
+    boolean_t bContended = FALSE;
+
+    if (jf_mutex_tryAcquire(pMutex) != JF_ERR_NO_ERROR)
+    {
+        bContended = TRUE;
+        u64Time = _getMutexProfileTime();
+        u32Ret = jf_mutex_acquire(pMutex);
+        u64Time = _getMutexProfileTime() - u64Time;
+    }
+
+    _recordMutexProfileAcquire(pMutex, u32Ret, pstrFile, u32Line, u64Time, bContended);
+
+    return u32Ret;
+}
+
+u32 jf_mutex_tryAcquireProfiled(jf_mutex_t * pMutex, const olchar_t * pstrFile, u32 u32Line)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = jf_mutex_tryAcquire(pMutex);
+
+    _recordMutexProfileAcquire(pMutex, u32Ret, pstrFile, u32Line, 0, FALSE);
+
+    return u32Ret;
+}
+
+u32 jf_mutex_acquireWithTimeoutProfiled(
+    jf_mutex_t * pMutex, u32 u32Timeout, const olchar_t * pstrFile, u32 u32Line)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Time = 0;
+    boolean_t bContended = FALSE;
+
+    if (jf_mutex_tryAcquire(pMutex) != JF_ERR_NO_ERROR)
+    {
+        bContended = TRUE;
+        u64Time = _getMutexProfileTime();
+        u32Ret = jf_mutex_acquireWithTimeout(pMutex, u32Timeout);
+        u64Time = _getMutexProfileTime() - u64Time;
+    }
+
+    _recordMutexProfileAcquire(pMutex, u32Ret, pstrFile, u32Line, u64Time, bContended);
+
+    return u32Ret;
+}
+
+#endif
+
 /*------------------------------------------------------------------------------------------------*/
 
 
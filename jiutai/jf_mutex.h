@@ -7,7 +7,13 @@
  *
  *  @note
  *  -# Routines declared in this file are included in jf_mutex object.
- *
+ *  -# On Linux, the timeout of jf_mutex_acquireWithTimeout() is measured with monotonic clock.
+ *  -# The adaptive mutex spins for a while before sleeping if the mutex is locked, it's for lock
+ *   with short critical section. On Windows, it's the same as the normal mutex.
+ *  -# Define JF_MUTEX_PROFILE (build with PROFILE_MUTEX=yes) to enable the contention profiler.
+ *   The acquire routines are replaced by macros which record the source file and line of the
+ *   caller, the profiler records the wait time and hold time for each acquire site. The result is
+ *   printed to stderr when the process exits, or by jf_mutex_printProfile().
  */
 
 #ifndef JIUTAI_MUTEX_H
@@ -34,6 +40,12 @@ typedef struct
     /**The mutex handle.*/
     HANDLE jm_hMutex;
 #endif
+#if defined(JF_MUTEX_PROFILE)
+    /**The time when the mutex is acquired in nanoseconds.*/
+    u64 jm_u64AcquireTime;
+    /**The acquire site of the holder.*/
+    void * jm_pSite;
+#endif
 } jf_mutex_t;
 
 /* --- functional routines ---------------------------------------------------------------------- */
@@ -48,6 +60,19 @@ typedef struct
  */
 u32 jf_mutex_init(jf_mutex_t * pMutex);
 
+/** Initialize the adaptive mutex.
+ *
+ *  @note
+ *  -# The calling thread spins before sleeping if the mutex is locked by another thread.
+ *
+ *  @param pMutex [in] The mutex to be initialized.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_CREATE_MUTEX Failed to create mutex.
+ */
+u32 jf_mutex_initAdaptive(jf_mutex_t * pMutex);
+
 /** Finalize a mutex.
  *
  *  @param pMutex [in] The mutex to be finalized.
@@ -108,6 +133,46 @@ u32 jf_mutex_acquireWithTimeout(jf_mutex_t * pMutex, u32 u32Timeout);
  */
 u32 jf_mutex_release(jf_mutex_t * pMutex);
 
+/** Print the result of contention profiler to stderr.
+ *
+ *  @note
+ *  -# The acquire sites are sorted by the total wait time.
+ *  -# Nothing is printed if the profiler is not enabled.
+ *
+ *  @return Void.
+ */
+void jf_mutex_printProfile(void);
+
+/** Clear the result of contention profiler.
+ *
+ *  @return Void.
+ */
+void jf_mutex_resetProfile(void);
+
+#if defined(JF_MUTEX_PROFILE)
+
+/** Acquire a mutex and record the wait time for the acquire site.
+ */
+u32 jf_mutex_acquireProfiled(jf_mutex_t * pMutex, const olchar_t * pstrFile, u32 u32Line);
+
+/** Try to acquire a mutex and record it for the acquire site.
+ */
+u32 jf_mutex_tryAcquireProfiled(jf_mutex_t * pMutex, const olchar_t * pstrFile, u32 u32Line);
+
+/** Acquire a mutex with time out and record the wait time for the acquire site.
+ */
+u32 jf_mutex_acquireWithTimeoutProfiled(
+    jf_mutex_t * pMutex, u32 u32Timeout, const olchar_t * pstrFile, u32 u32Line);
+
+#define jf_mutex_acquire(pMutex)  jf_mutex_acquireProfiled((pMutex), __FILE__, __LINE__)
+
+#define jf_mutex_tryAcquire(pMutex)  jf_mutex_tryAcquireProfiled((pMutex), __FILE__, __LINE__)
+
+#define jf_mutex_acquireWithTimeout(pMutex, u32Timeout)  \
+    jf_mutex_acquireWithTimeoutProfiled((pMutex), (u32Timeout), __FILE__, __LINE__)
+
+#endif
+
 #endif /*JIUTAI_MUTEX_H*/
 
 /*------------------------------------------------------------------------------------------------*/
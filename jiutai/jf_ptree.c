@@ -6,7 +6,16 @@
  *  @author Min Zhang
  *  
  *  @note
- *
+ *  -# The key is split by a tokenizer which doesn't allocate memory. Without path index, the
+ *   nodes are found by descending from the root and only the children matching the token are
+ *   visited.
+ *  -# With path index, the hash of the full path is saved in node, the nodes with the same hash are
+ *   in the same bucket of the index. The nodes with the same path are kept in tree order in the
+ *   bucket, so the result is the same as searching the tree.
+ *  -# With arena mode, the memory is bumped from chunks of the arena. A request larger than a
+ *   quarter of the chunk size gets a dedicated chunk so the current chunk is not wasted. The
+ *   names are interned with an open addressing hash table, the values are copied to arena but not
+ *   interned as they can be changed in place.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -18,18 +27,102 @@
 #include "jf_jiukun.h"
 #include "jf_err.h"
 #include "jf_ptree.h"
-#include "jf_linklist.h"
 #include "jf_hashtree.h"
+#include "jf_hlisthead.h"
 #include "jf_string.h"
 #include "jf_stack.h"
 #include "jf_data.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** The seed of path hash, it's the hash of the parent of the root node.
+ */
+#define PTREE_PATH_HASH_SEED                     (0x811C9DC5)
+
+/** The prime of FNV-1a hash for path.
+ */
+#define PTREE_PATH_HASH_PRIME                    (0x01000193)
+
+/** The initial number of bucket in path index, must be power of 2.
+ */
+#define PTREE_PATH_INDEX_INITIAL_BUCKET          (64)
+
+/** The maximum number of bucket in path index.
+ */
+#define PTREE_PATH_INDEX_MAX_BUCKET  \
+    (JF_JIUKUN_MAX_MEMORY_SIZE / sizeof(jf_hlisthead_t))
+
+/** The default size of chunk in arena.
+ */
+#define PTREE_ARENA_DEFAULT_CHUNK_SIZE           (64 * 1024)
+
+/** The minimal size of chunk in arena.
+ */
+#define PTREE_ARENA_MIN_CHUNK_SIZE               (1024)
+
+/** The alignment of memory allocated from arena.
+ */
+#define PTREE_ARENA_ALIGNMENT                    (8)
+
+/** The initial number of slot in intern table, must be power of 2.
+ */
+#define PTREE_INTERN_INITIAL_SLOT                (256)
+
+/** The maximum number of slot in intern table.
+ */
+#define PTREE_INTERN_MAX_SLOT  \
+    (JF_JIUKUN_MAX_MEMORY_SIZE / sizeof(ptree_intern_slot_t))
+
+/** Define the chunk data type of arena, the memory for allocation follows the header.
+ */
+typedef struct ptree_arena_chunk
+{
+    /**The next chunk.*/
+    struct ptree_arena_chunk * pac_ppacNext;
+    /**Size of memory for allocation.*/
+    olsize_t pac_sSize;
+    /**Offset of the free memory.*/
+    olsize_t pac_sOffset;
+} ptree_arena_chunk_t;
+
+/** Define the slot data type of intern table.
+ */
+typedef struct
+{
+    /**The interned string, it's NULL if the slot is empty.*/
+    olchar_t * pis_pstrStr;
+    /**Size of the string.*/
+    olsize_t pis_sStr;
+    /**The hash of the string.*/
+    u32 pis_u32Hash;
+} ptree_intern_slot_t;
+
+/** Define the arena data type.
+ */
+typedef struct
+{
+    /**The chunk list, memory is allocated from the first chunk.*/
+    ptree_arena_chunk_t * pa_ppacChunk;
+    /**Size of chunk.*/
+    olsize_t pa_sChunk;
+    /**Number of string in intern table.*/
+    u32 pa_u32NumOfInternStr;
+    /**The slots of intern table.*/
+    ptree_intern_slot_t * pa_ppisIntern;
+    /**Number of slot in intern table, it's power of 2.*/
+    u32 pa_u32NumOfInternSlot;
+    u32 pa_u32Reserved;
+} ptree_arena_t;
+
 /** Define property tree node attribute data type.
  */
 typedef struct internal_ptree_node_attribute
 {
+    /**The next attribute in the list.*/
+    struct internal_ptree_node_attribute * ipna_pipnaNext;
+    /**The arena of the attribute, it's NULL if the attribute is not in arena.*/
+    ptree_arena_t * ipna_ppaArena;
+
     /**The prefix string of name space.*/
     olchar_t * ipna_pstrPrefix;
     /**Size of name space string.*/
@@ -44,6 +137,8 @@ typedef struct internal_ptree_node_attribute
     olchar_t * ipna_pstrValue;
     /**Size of value string.*/
     olsize_t ipna_sValue;
+    /**Capacity of value string in arena, the value not longer than it is overwritten in place.*/
+    olsize_t ipna_sValueCapacity;
 } internal_ptree_node_attribute_t;
 
 /** Define property tree node data type.
@@ -64,11 +159,17 @@ typedef struct internal_ptree_node
     olchar_t * ipn_pstrValue;
     /**Size of value string.*/
     olsize_t ipn_sValue;
+    /**Capacity of value string in arena, the value not longer than it is overwritten in place.*/
+    olsize_t ipn_sValueCapacity;
 
     /**Hash tree for name space.*/
     jf_hashtree_t ipn_jhNameSpace;
-    /**Linked list for attribute.*/
-    jf_linklist_t ipn_jlAttribute;
+    /**The attribute list.*/
+    internal_ptree_node_attribute_t * ipn_pipnaAttribute;
+    /**The arena of the node, it's NULL if the node is not in arena.*/
+    ptree_arena_t * ipn_ppaArena;
+    /**The next node with name space table, for arena mode only.*/
+    struct internal_ptree_node * ipn_pipnNextNameSpace;
 
     /**The parent ptree node.*/
     struct internal_ptree_node * ipn_pipnParent;
@@ -79,14 +180,19 @@ typedef struct internal_ptree_node
 
     /**The private data for application.*/
     void * ipn_pPrivate;
+
+    /**The hash of the full path.*/
+    u32 ipn_u32PathHash;
+    /**The list node in the bucket of path index.*/
+    jf_hlisthead_node_t ipn_jhnPathIndex;
 } internal_ptree_node_t;
 
 /** Define the internal property tree data type.
  */
 typedef struct
 {
-    /**The declaration of the tree.*/
-    jf_linklist_t ip_jlDeclaration;
+    /**The declaration attribute list of the tree.*/
+    internal_ptree_node_attribute_t * ip_pipnaDeclaration;
     /**The property tree node.*/
     internal_ptree_node_t * ip_pipnRoot;
     /**The separator of the key when finding nodes.*/
@@ -98,36 +204,302 @@ typedef struct
     /**The length of the namespace separator.*/
     olsize_t ip_sNsSeparator;
 
+    /**The buckets of path index, it's NULL if path index is not enabled.*/
+    jf_hlisthead_t * ip_pjhPathIndex;
+    /**Number of bucket in path index, it's power of 2.*/
+    u32 ip_u32NumOfPathIndexBucket;
+    /**Number of node added to path index.*/
+    u32 ip_u32NumOfIndexedNode;
+    u32 ip_u32Reserved;
+
+    /**The arena, it's NULL if arena mode is not enabled.*/
+    ptree_arena_t * ip_ppaArena;
+    /**The nodes with name space table in arena mode, the tables are finalized when the tree is
+       destroyed.*/
+    internal_ptree_node_t * ip_pipnNameSpace;
+    /**The storage of arena.*/
+    ptree_arena_t ip_paArena;
 } internal_ptree_t;
 
+/** Define the key tokenizer data type, the tokenizer doesn't allocate memory.
+ */
+typedef struct
+{
+    /**The key to split.*/
+    const olchar_t * pkt_pstrKey;
+    /**Length of the key.*/
+    olsize_t pkt_sKey;
+    /**Offset of the next token.*/
+    olsize_t pkt_sOffset;
+    /**The separator.*/
+    const olchar_t * pkt_pstrSeparator;
+    /**Length of the separator.*/
+    olsize_t pkt_sSeparator;
+    /**No more token if it's TRUE.*/
+    boolean_t pkt_bEnd;
+    u8 pkt_u8Reserved[7];
+} ptree_key_tokenizer_t;
+
 /** Parameter for finding property node.
  */
 typedef struct
 {
-    jf_string_parse_result_t * fpnp_pjsprKey;
     jf_ptree_node_t ** fpnp_ppNode;
     u16 fpnp_u16MaxNode;
     u16 fpnp_u16NumOfNode;
 } find_ptree_node_param_t;
 
-/** Parameter for finding property node attribute.
+/* --- private routine section ------------------------------------------------------------------ */
+
+static u32 _hashPtreePathToken(u32 u32Hash, const olchar_t * pstrToken, olsize_t sToken)
+{
+    /*Mix a separator so "a.bc" and "ab.c" have different hash.*/
+    u32Hash = (u32Hash ^ 0xFF) * PTREE_PATH_HASH_PRIME;
+
+    while (sToken-- > 0)
+        u32Hash = (u32Hash ^ (u8)*pstrToken++) * PTREE_PATH_HASH_PRIME;
+
+    return u32Hash;
+}
+
+static void _finiPtreeArena(ptree_arena_t * ppa)
+{
+    ptree_arena_chunk_t * ppac = NULL;
+
+    while (ppa->pa_ppacChunk != NULL)
+    {
+        ppac = ppa->pa_ppacChunk;
+        ppa->pa_ppacChunk = ppac->pac_ppacNext;
+        jf_jiukun_freeMemory((void **)&ppac);
+    }
+
+    if (ppa->pa_ppisIntern != NULL)
+        jf_jiukun_freeMemory((void **)&ppa->pa_ppisIntern);
+
+    ol_bzero(ppa, sizeof(*ppa));
+}
+
+static u32 _allocPtreeArenaMemory(ptree_arena_t * ppa, olsize_t sMem, void ** ppMem)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    ptree_arena_chunk_t * ppac = ppa->pa_ppacChunk;
+    olsize_t sChunk = ppa->pa_sChunk;
+
+    sMem = (sMem + PTREE_ARENA_ALIGNMENT - 1) & ~(PTREE_ARENA_ALIGNMENT - 1);
+
+    if ((ppac == NULL) || (ppac->pac_sSize - ppac->pac_sOffset < sMem))
+    {
+        /*Large memory gets a dedicated chunk.*/
+        if (sMem > sChunk / 4)
+            sChunk = sizeof(*ppac) + sMem;
+
+        u32Ret = jf_jiukun_allocMemory((void **)&ppac, sChunk);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ppac->pac_sSize = sChunk - sizeof(*ppac);
+            ppac->pac_sOffset = 0;
+
+            if ((sChunk != ppa->pa_sChunk) && (ppa->pa_ppacChunk != NULL))
+            {
+                /*Keep the current chunk at the head for the following allocation.*/
+                ppac->pac_ppacNext = ppa->pa_ppacChunk->pac_ppacNext;
+                ppa->pa_ppacChunk->pac_ppacNext = ppac;
+            }
+            else
+            {
+                ppac->pac_ppacNext = ppa->pa_ppacChunk;
+                ppa->pa_ppacChunk = ppac;
+            }
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        *ppMem = (u8 *)(ppac + 1) + ppac->pac_sOffset;
+        ppac->pac_sOffset += sMem;
+    }
+
+    return u32Ret;
+}
+
+/** Allocate memory from arena, or from jiukun if arena is NULL.
  */
-typedef struct
+static u32 _allocPtreeMemory(ptree_arena_t * ppa, void ** ppMem, olsize_t sMem)
 {
-    const olchar_t * fpnap_pstrPrefix;
-    olsize_t fpnap_sPrefix;
-    const olchar_t * fpnap_pstrName;
-    olsize_t fpnap_sName;
-    jf_ptree_node_attribute_t ** fpnap_ppjpnaAttr;
-} find_ptree_node_attribute_param_t;
+    u32 u32Ret = JF_ERR_NO_ERROR;
 
-/* --- private routine section ------------------------------------------------------------------ */
+    if (ppa == NULL)
+        u32Ret = jf_jiukun_allocMemory(ppMem, sMem);
+    else
+        u32Ret = _allocPtreeArenaMemory(ppa, sMem, ppMem);
+
+    return u32Ret;
+}
+
+/** Duplicate the string to arena, or to jiukun if arena is NULL. The string is terminated by '\0'.
+ */
+static u32 _duplicatePtreeString(
+    ptree_arena_t * ppa, olchar_t ** ppstrDest, const olchar_t * pstrSrc, olsize_t sSrc)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olchar_t * pstr = NULL;
+
+    if (ppa == NULL)
+        return jf_string_duplicateWithLen(ppstrDest, pstrSrc, sSrc);
+
+    u32Ret = _allocPtreeArenaMemory(ppa, sSrc + 1, (void **)&pstr);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_memcpy(pstr, pstrSrc, sSrc);
+        pstr[sSrc] = '\0';
+        *ppstrDest = pstr;
+    }
+
+    return u32Ret;
+}
+
+static u32 _growPtreeInternTable(ptree_arena_t * ppa)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    ptree_intern_slot_t * ppisOld = ppa->pa_ppisIntern, * ppisSlot = NULL;
+    u32 u32NumOfOldSlot = ppa->pa_u32NumOfInternSlot, u32NumOfSlot = PTREE_INTERN_INITIAL_SLOT;
+    u32 u32Index = 0, u32Pos = 0;
+
+    if (u32NumOfOldSlot != 0)
+        u32NumOfSlot = u32NumOfOldSlot * 2;
+
+    if (u32NumOfSlot > PTREE_INTERN_MAX_SLOT)
+        return JF_ERR_OUT_OF_MEMORY;
+
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&ppa->pa_ppisIntern, u32NumOfSlot * sizeof(ptree_intern_slot_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(ppa->pa_ppisIntern, u32NumOfSlot * sizeof(ptree_intern_slot_t));
+        ppa->pa_u32NumOfInternSlot = u32NumOfSlot;
+
+        for (u32Index = 0; u32Index < u32NumOfOldSlot; u32Index ++)
+        {
+            if (ppisOld[u32Index].pis_pstrStr == NULL)
+                continue;
+
+            u32Pos = ppisOld[u32Index].pis_u32Hash & (u32NumOfSlot - 1);
+            ppisSlot = &ppa->pa_ppisIntern[u32Pos];
+            while (ppisSlot->pis_pstrStr != NULL)
+            {
+                u32Pos = (u32Pos + 1) & (u32NumOfSlot - 1);
+                ppisSlot = &ppa->pa_ppisIntern[u32Pos];
+            }
+            ol_memcpy(ppisSlot, &ppisOld[u32Index], sizeof(*ppisSlot));
+        }
+
+        if (ppisOld != NULL)
+            jf_jiukun_freeMemory((void **)&ppisOld);
+    }
+    else
+    {
+        ppa->pa_ppisIntern = ppisOld;
+    }
+
+    return u32Ret;
+}
+
+/** Intern the string in arena, the same string is returned for the same content. The string is
+ *  duplicated to jiukun if arena is NULL.
+ */
+static u32 _internPtreeString(
+    ptree_arena_t * ppa, olchar_t ** ppstrDest, const olchar_t * pstrSrc, olsize_t sSrc)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    ptree_intern_slot_t * ppisSlot = NULL;
+    u32 u32Hash = 0, u32Pos = 0;
+
+    if (ppa == NULL)
+        return jf_string_duplicateWithLen(ppstrDest, pstrSrc, sSrc);
+
+    /*Keep the load factor under 1/2. The string is not interned if the table cannot grow.*/
+    if ((ppa->pa_u32NumOfInternStr + 1) * 2 > ppa->pa_u32NumOfInternSlot)
+        u32Ret = _growPtreeInternTable(ppa);
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return _duplicatePtreeString(ppa, ppstrDest, pstrSrc, sSrc);
+
+    u32Hash = _hashPtreePathToken(PTREE_PATH_HASH_SEED, pstrSrc, sSrc);
+    u32Pos = u32Hash & (ppa->pa_u32NumOfInternSlot - 1);
+    ppisSlot = &ppa->pa_ppisIntern[u32Pos];
+    while (ppisSlot->pis_pstrStr != NULL)
+    {
+        if ((ppisSlot->pis_u32Hash == u32Hash) && (ppisSlot->pis_sStr == sSrc) &&
+            (ol_memcmp(ppisSlot->pis_pstrStr, pstrSrc, sSrc) == 0))
+        {
+            *ppstrDest = ppisSlot->pis_pstrStr;
+            return u32Ret;
+        }
+
+        u32Pos = (u32Pos + 1) & (ppa->pa_u32NumOfInternSlot - 1);
+        ppisSlot = &ppa->pa_ppisIntern[u32Pos];
+    }
+
+    u32Ret = _duplicatePtreeString(ppa, ppstrDest, pstrSrc, sSrc);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ppisSlot->pis_pstrStr = *ppstrDest;
+        ppisSlot->pis_sStr = sSrc;
+        ppisSlot->pis_u32Hash = u32Hash;
+        ppa->pa_u32NumOfInternStr ++;
+    }
+
+    return u32Ret;
+}
+
+/** Replace the string with new one. The string in arena is overwritten if the new one is not
+ *  longer than the capacity, otherwise the new one is allocated and the old one is kept in arena
+ *  until the arena is released.
+ */
+static u32 _replacePtreeString(
+    ptree_arena_t * ppa, olchar_t ** ppstrDest, olsize_t * psDest, olsize_t * psCapacity,
+    const olchar_t * pstrSrc, olsize_t sSrc)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    if ((ppa != NULL) && (*ppstrDest != NULL) && (sSrc <= *psCapacity))
+    {
+        ol_memmove(*ppstrDest, pstrSrc, sSrc);
+        (*ppstrDest)[sSrc] = '\0';
+    }
+    else
+    {
+        if ((ppa == NULL) && (*ppstrDest != NULL))
+            jf_string_free(ppstrDest);
+
+        *ppstrDest = NULL;
+        u32Ret = _duplicatePtreeString(ppa, ppstrDest, pstrSrc, sSrc);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            *psCapacity = sSrc;
+        else
+            *psCapacity = 0;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        *psDest = sSrc;
+    else
+        *psDest = 0;
+
+    return u32Ret;
+}
 
 static u32 _destroyPtreeNodeAttribute(internal_ptree_node_attribute_t ** ppAttribute)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_attribute_t * pipna = *ppAttribute;
 
+    /*The memory is released with the arena.*/
+    if (pipna->ipna_ppaArena != NULL)
+    {
+        *ppAttribute = NULL;
+        return u32Ret;
+    }
+
     if (pipna->ipna_pstrPrefix != NULL)
         jf_jiukun_freeMemory((void **)&pipna->ipna_pstrPrefix);
 
@@ -143,32 +515,34 @@ static u32 _destroyPtreeNodeAttribute(internal_ptree_node_attribute_t ** ppAttri
 }
 
 static u32 _createPtreeNodeAttribute(
-    internal_ptree_node_attribute_t ** ppAttribute, const olchar_t * pstrPrefix,
-    const olsize_t sPrefix, const olchar_t * pstrName, const olsize_t sName,
-    const olchar_t * pstrValue, const olsize_t sValue)
+    ptree_arena_t * ppa, internal_ptree_node_attribute_t ** ppAttribute,
+    const olchar_t * pstrPrefix, const olsize_t sPrefix, const olchar_t * pstrName,
+    const olsize_t sName, const olchar_t * pstrValue, const olsize_t sValue)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_attribute_t * retval = NULL;
 
     *ppAttribute = NULL;
     
-    u32Ret = jf_jiukun_allocMemory((void **)&retval, sizeof(*retval));
+    u32Ret = _allocPtreeMemory(ppa, (void **)&retval, sizeof(*retval));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(retval, sizeof(*retval));
+        retval->ipna_ppaArena = ppa;
         retval->ipna_sPrefix = sPrefix;
         retval->ipna_sName = sName;
         retval->ipna_sValue = sValue;
+        retval->ipna_sValueCapacity = sValue;
 
         if (sPrefix > 0)
-            u32Ret = jf_string_duplicateWithLen(&retval->ipna_pstrPrefix, pstrPrefix, sPrefix);
+            u32Ret = _internPtreeString(ppa, &retval->ipna_pstrPrefix, pstrPrefix, sPrefix);
     }
 
     if ((u32Ret == JF_ERR_NO_ERROR) && (sName > 0))
-        u32Ret = jf_string_duplicateWithLen(&retval->ipna_pstrName, pstrName, sName);
+        u32Ret = _internPtreeString(ppa, &retval->ipna_pstrName, pstrName, sName);
 
     if ((u32Ret == JF_ERR_NO_ERROR) && (sValue > 0))
-        u32Ret = jf_string_duplicateWithLen(&retval->ipna_pstrValue, pstrValue, sValue);
+        u32Ret = _duplicatePtreeString(ppa, &retval->ipna_pstrValue, pstrValue, sValue);
 
     if (u32Ret == JF_ERR_NO_ERROR)
         *ppAttribute = retval;
@@ -178,29 +552,29 @@ static u32 _createPtreeNodeAttribute(
     return u32Ret;
 }
 
-static u32 _fnFreePtreeNodeAttribute(void ** ppData)
+static void _destroyPtreeNodeAttributeList(internal_ptree_node_attribute_t ** ppList)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_ptree_node_attribute_t * pipna = *ppList, * temp = NULL;
 
-    u32Ret = _destroyPtreeNodeAttribute((internal_ptree_node_attribute_t **) ppData);
+    *ppList = NULL;
 
-    return u32Ret;
+    while (pipna != NULL)
+    {
+        temp = pipna->ipna_pipnaNext;
+        _destroyPtreeNodeAttribute(&pipna);
+        pipna = temp;
+    }
 }
 
 #if defined(DEBUG_PTREE)
 
-static void _printPtreeNodeAttributeList(jf_linklist_t * pLinklist)
+static void _printPtreeNodeAttributeList(internal_ptree_node_attribute_t * pAttr)
 {
     olchar_t value[64];
-    jf_linklist_node_t * pNode = NULL;
-    internal_ptree_node_attribute_t * pAttr = NULL;
     ol_printf("(");
 
-    pNode = jf_linklist_getFirstNode(pLinklist);
-    while (pNode != NULL)
+    while (pAttr != NULL)
     {
-        pAttr = jf_linklist_getDataFromNode(pNode);
-
         if (pAttr->ipna_sPrefix > 0)
         {
             ol_memcpy(value, pAttr->ipna_pstrPrefix, pAttr->ipna_sPrefix);
@@ -216,7 +590,7 @@ static void _printPtreeNodeAttributeList(jf_linklist_t * pLinklist)
         value[pAttr->ipna_sValue] = '\0';
         ol_printf("%s ", value);
 
-        pNode = jf_linklist_getNextNode(pNode);
+        pAttr = pAttr->ipna_pipnaNext;
     }
     ol_printf(")");
 }
@@ -240,7 +614,7 @@ static void _printPtreeNodeList(internal_ptree_node_t * pixxn, u16 u16Indent)
         _printPtreeNodeIndentSpace(u16Indent);
 
         ol_printf("%s", temp->ipn_pstrName);
-        _printPtreeNodeAttributeList(&temp->ipn_jlAttribute);
+        _printPtreeNodeAttributeList(temp->ipn_pipnaAttribute);
         ol_printf(": ");
 
         if (temp->ipn_pipnChildren != NULL)
@@ -269,10 +643,21 @@ static u32 _destroyPtreeNode(internal_ptree_node_t ** ppNode)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_t * pipn = *ppNode;
+
+    /*Remove the node from path index.*/
+    jf_hlisthead_delInit(&pipn->ipn_jhnPathIndex);
     
     /*If there was a namespace table, delete it.*/
     jf_hashtree_fini(&pipn->ipn_jhNameSpace);
-    jf_linklist_finiListAndData(&pipn->ipn_jlAttribute, _fnFreePtreeNodeAttribute);
+
+    /*The memory is released with the arena.*/
+    if (pipn->ipn_ppaArena != NULL)
+    {
+        *ppNode = NULL;
+        return u32Ret;
+    }
+
+    _destroyPtreeNodeAttributeList(&pipn->ipn_pipnaAttribute);
 
     if (pipn->ipn_pstrNs != NULL)
         jf_string_free(&pipn->ipn_pstrNs);
@@ -289,36 +674,37 @@ static u32 _destroyPtreeNode(internal_ptree_node_t ** ppNode)
 }
 
 static u32 _createPtreeNode(
-    internal_ptree_node_t ** ppNode, const olchar_t * pstrNs, const olsize_t sNs,
-    const olchar_t * pstrName, const olsize_t sName, const olchar_t * pstrValue,
-    const olsize_t sValue)
+    ptree_arena_t * ppa, internal_ptree_node_t ** ppNode, const olchar_t * pstrNs,
+    const olsize_t sNs, const olchar_t * pstrName, const olsize_t sName,
+    const olchar_t * pstrValue, const olsize_t sValue)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_t * pipn = NULL;
     
     *ppNode = NULL;
 
-    u32Ret = jf_jiukun_allocMemory((void **)&pipn, sizeof(*pipn));
+    u32Ret = _allocPtreeMemory(ppa, (void **)&pipn, sizeof(*pipn));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(pipn, sizeof(*pipn));
 
         /*Init the namespace hash table.*/
         jf_hashtree_init(&pipn->ipn_jhNameSpace);
-        jf_linklist_init(&pipn->ipn_jlAttribute);
+        pipn->ipn_ppaArena = ppa;
         pipn->ipn_sNs = sNs;
         pipn->ipn_sName = sName;
         pipn->ipn_sValue = sValue;
+        pipn->ipn_sValueCapacity = sValue;
 
         if (sNs > 0)
-            u32Ret = jf_string_duplicateWithLen(&pipn->ipn_pstrNs, pstrNs, sNs);
+            u32Ret = _internPtreeString(ppa, &pipn->ipn_pstrNs, pstrNs, sNs);
     }
 
     if ((u32Ret == JF_ERR_NO_ERROR) && (sName > 0))
-        u32Ret = jf_string_duplicateWithLen(&pipn->ipn_pstrName, pstrName, sName);
+        u32Ret = _internPtreeString(ppa, &pipn->ipn_pstrName, pstrName, sName);
 
     if ((u32Ret == JF_ERR_NO_ERROR) && (sValue > 0))
-        u32Ret = jf_string_duplicateWithLen(&pipn->ipn_pstrValue, pstrValue, sValue);
+        u32Ret = _duplicatePtreeString(ppa, &pipn->ipn_pstrValue, pstrValue, sValue);
 
     if (u32Ret == JF_ERR_NO_ERROR)
         *ppNode = pipn;
@@ -360,13 +746,9 @@ static u32 _changePtreeNodeValue(
     u32 u32Ret = JF_ERR_NO_ERROR;
 
     if (pstrValue != NULL)
-    {
-        if (pipn->ipn_pstrValue != NULL)
-            jf_string_free(&pipn->ipn_pstrValue);
-
-        pipn->ipn_sValue = sValue;
-        u32Ret = jf_string_duplicateWithLen(&pipn->ipn_pstrValue, pstrValue, sValue);
-    }
+        u32Ret = _replacePtreeString(
+            pipn->ipn_ppaArena, &pipn->ipn_pstrValue, &pipn->ipn_sValue,
+            &pipn->ipn_sValueCapacity, pstrValue, sValue);
 
     return u32Ret;
 }
@@ -466,146 +848,405 @@ static u32 _deletePtreeNode(internal_ptree_node_t * pipn)
     return u32Ret;
 }
 
-static u32 _fnFindNodeAttribute(jf_linklist_node_t * pNode, void * pArg)
+static boolean_t _isPtreeNodeAttributeMatched(
+    internal_ptree_node_attribute_t * pipna, const olchar_t * pstrPrefix, const olsize_t sPrefix,
+    const olchar_t * pstrName, const olsize_t sName)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    find_ptree_node_attribute_param_t * pfpnap = (find_ptree_node_attribute_param_t *)pArg;
-    internal_ptree_node_attribute_t * pipna = (internal_ptree_node_attribute_t *)pNode->jln_pData;
+    if (pipna->ipna_sPrefix != sPrefix)
+        return FALSE;
 
-    if (pipna->ipna_sPrefix != pfpnap->fpnap_sPrefix)
-        return u32Ret;
-
-    if (pipna->ipna_sName != pfpnap->fpnap_sName)
-        return u32Ret;
+    if (pipna->ipna_sName != sName)
+        return FALSE;
 
     if ((pipna->ipna_sPrefix > 0) &&
-        (ol_memcmp(pipna->ipna_pstrPrefix, pfpnap->fpnap_pstrPrefix, pipna->ipna_sPrefix) != 0))
-        return u32Ret;
+        (ol_memcmp(pipna->ipna_pstrPrefix, pstrPrefix, pipna->ipna_sPrefix) != 0))
+        return FALSE;
 
-    if (ol_memcmp(pipna->ipna_pstrName, pfpnap->fpnap_pstrName, pipna->ipna_sName) != 0)
-        return u32Ret;
+    if (ol_memcmp(pipna->ipna_pstrName, pstrName, pipna->ipna_sName) != 0)
+        return FALSE;
 
-    *pfpnap->fpnap_ppjpnaAttr = pipna;
-
-    return JF_ERR_TERMINATED;
+    return TRUE;
 }
 
 static u32 _findPtreeNodeAttribute(
-    jf_linklist_t * pjl, const olchar_t * pstrPrefix, const olsize_t sPrefix,
+    internal_ptree_node_attribute_t * pipna, const olchar_t * pstrPrefix, const olsize_t sPrefix,
     const olchar_t * pstrName, const olsize_t sName, jf_ptree_node_attribute_t ** ppAttr)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    find_ptree_node_attribute_param_t fpnap;
+    u32 u32Ret = JF_ERR_PTREE_NODE_ATTR_NOT_FOUND;
 
     assert((sName > 0) && (pstrName != NULL));
 
-    ol_bzero(&fpnap, sizeof(fpnap));
-    fpnap.fpnap_pstrPrefix = pstrPrefix;
-    fpnap.fpnap_sPrefix = sPrefix;
-    fpnap.fpnap_pstrName = pstrName;
-    fpnap.fpnap_sName = sName;
-    fpnap.fpnap_ppjpnaAttr = ppAttr;
+    while (pipna != NULL)
+    {
+        if (_isPtreeNodeAttributeMatched(pipna, pstrPrefix, sPrefix, pstrName, sName))
+        {
+            *ppAttr = pipna;
+            u32Ret = JF_ERR_NO_ERROR;
+            break;
+        }
 
-    u32Ret = jf_linklist_iterate(pjl, _fnFindNodeAttribute, &fpnap);
-    if (u32Ret == JF_ERR_TERMINATED)
-        u32Ret = JF_ERR_NO_ERROR;
-    else
-        u32Ret = JF_ERR_PTREE_NODE_ATTR_NOT_FOUND;
+        pipna = pipna->ipna_pipnaNext;
+    }
 
     return u32Ret;
 }
 
-static u32 _getPtreeNodeLevel(internal_ptree_node_t * pipn)
+/** Push all the nodes in the path to stack. The path is from leaf node to root node.
+ */
+static u32 _pushPtreeNodePathToStack(jf_stack_t ** ppjsNode, internal_ptree_node_t * pipn)
 {
-    u32 u32Level = 0;
+    u32 u32Ret = JF_ERR_NO_ERROR;
 
-    while (pipn != NULL)
+    while ((pipn != NULL) && (u32Ret == JF_ERR_NO_ERROR))
     {
-        u32Level ++;
+        u32Ret = jf_stack_push(ppjsNode, pipn);
 
         pipn = pipn->ipn_pipnParent;
     }
 
-    return u32Level;
+    return u32Ret;
 }
 
-/** Push all the nodes in the path to stack. The path is from leaf node to root node.
+static void _initPtreeKeyTokenizer(
+    ptree_key_tokenizer_t * ppkt, const olchar_t * pstrKey, olsize_t sKey,
+    const olchar_t * pstrSeparator, olsize_t sSeparator)
+{
+    ol_bzero(ppkt, sizeof(*ppkt));
+
+    ppkt->pkt_pstrKey = pstrKey;
+    ppkt->pkt_sKey = sKey;
+    ppkt->pkt_pstrSeparator = pstrSeparator;
+    ppkt->pkt_sSeparator = sSeparator;
+}
+
+/** Get the next token from the key.
+ *
+ *  @note
+ *  -# The tokens are the same as jf_string_parse(), at least one token is returned even if the key
+ *   is empty, the token can be empty if there are continuous separators.
+ *
+ *  @return The status.
+ *  @retval TRUE The token is returned.
+ *  @retval FALSE No more token.
  */
-static u32 _pushPtreeNodePathToStack(jf_stack_t ** ppjsNode, internal_ptree_node_t * pipn)
+static boolean_t _getNextPtreeKeyToken(
+    ptree_key_tokenizer_t * ppkt, const olchar_t ** ppstrToken, olsize_t * psToken)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
+    olsize_t sStart = ppkt->pkt_sOffset, sOffset = ppkt->pkt_sOffset;
 
-    while ((pipn != NULL) && (u32Ret == JF_ERR_NO_ERROR))
+    if (ppkt->pkt_bEnd)
+        return FALSE;
+
+    while ((sOffset + ppkt->pkt_sSeparator <= ppkt->pkt_sKey) &&
+           (ol_memcmp(
+               ppkt->pkt_pstrKey + sOffset, ppkt->pkt_pstrSeparator, ppkt->pkt_sSeparator) != 0))
+        sOffset ++;
+
+    *ppstrToken = ppkt->pkt_pstrKey + sStart;
+
+    if (sOffset + ppkt->pkt_sSeparator <= ppkt->pkt_sKey)
     {
-        u32Ret = jf_stack_push(ppjsNode, pipn);
+        /*Separator is found.*/
+        *psToken = sOffset - sStart;
+        ppkt->pkt_sOffset = sOffset + ppkt->pkt_sSeparator;
+    }
+    else
+    {
+        /*This is the last token.*/
+        *psToken = ppkt->pkt_sKey - sStart;
+        ppkt->pkt_sOffset = ppkt->pkt_sKey;
+        ppkt->pkt_bEnd = TRUE;
+    }
+
+    return TRUE;
+}
+
+static inline boolean_t _isPtreeNodeNameEqual(
+    internal_ptree_node_t * pipn, const olchar_t * pstrName, olsize_t sName)
+{
+    return ((pipn->ipn_sName == sName) && (ol_memcmp(pipn->ipn_pstrName, pstrName, sName) == 0));
+}
+
+/** Check if the full path of the node is the same as the key.
+ *
+ *  @note
+ *  -# The key is compared from the last token as the node is compared from leaf to root.
+ */
+static boolean_t _isPtreeNodePathMatched(
+    internal_ptree_t * pip, internal_ptree_node_t * pipn, const olchar_t * pstrKey, olsize_t sKey)
+{
+    olsize_t sStart = 0;
+    boolean_t bSeparator = FALSE;
+
+    while (pipn != NULL)
+    {
+        /*Find the last separator.*/
+        bSeparator = FALSE;
+        sStart = sKey;
+        while (sStart >= pip->ip_sKeySeparator)
+        {
+            if (ol_memcmp(
+                    pstrKey + sStart - pip->ip_sKeySeparator, pip->ip_pstrKeySeparator,
+                    pip->ip_sKeySeparator) == 0)
+            {
+                bSeparator = TRUE;
+                break;
+            }
+            sStart --;
+        }
+        if (! bSeparator)
+            sStart = 0;
+
+        if (! _isPtreeNodeNameEqual(pipn, pstrKey + sStart, sKey - sStart))
+            return FALSE;
 
+        /*The node is root node, the key must have no more token.*/
+        if (! bSeparator)
+            return (pipn->ipn_pipnParent == NULL);
+
+        sKey = sStart - pip->ip_sKeySeparator;
         pipn = pipn->ipn_pipnParent;
     }
 
-    return u32Ret;
+    return FALSE;
+}
+
+static boolean_t _isPtreeNodePathEqual(
+    internal_ptree_node_t * pipn, internal_ptree_node_t * pipnOther)
+{
+    if (pipn->ipn_u32PathHash != pipnOther->ipn_u32PathHash)
+        return FALSE;
+
+    while ((pipn != NULL) && (pipnOther != NULL))
+    {
+        if (! _isPtreeNodeNameEqual(pipn, pipnOther->ipn_pstrName, pipnOther->ipn_sName))
+            return FALSE;
+
+        pipn = pipn->ipn_pipnParent;
+        pipnOther = pipnOther->ipn_pipnParent;
+    }
+
+    return ((pipn == NULL) && (pipnOther == NULL));
+}
+
+/** Check if the node is before the other node in tree order, both nodes are at the same level.
+ */
+static boolean_t _isPtreeNodeBefore(internal_ptree_node_t * pipn, internal_ptree_node_t * pipnOther)
+{
+    internal_ptree_node_t * temp = NULL;
+
+    /*Find the ancestors which are siblings.*/
+    while (pipn->ipn_pipnParent != pipnOther->ipn_pipnParent)
+    {
+        pipn = pipn->ipn_pipnParent;
+        pipnOther = pipnOther->ipn_pipnParent;
+    }
+
+    /*The node is before the other if the other is found in the following siblings.*/
+    temp = pipn->ipn_pipnSibling;
+    while ((temp != NULL) && (temp != pipnOther))
+        temp = temp->ipn_pipnSibling;
+
+    return (temp != NULL);
+}
+
+static void _addNodeToPtreePathIndex(internal_ptree_t * pip, internal_ptree_node_t * pipn)
+{
+    jf_hlisthead_t * pjh = &pip->ip_pjhPathIndex[
+        pipn->ipn_u32PathHash & (pip->ip_u32NumOfPathIndexBucket - 1)];
+    jf_hlisthead_node_t * pos = NULL, * pjhnLast = NULL;
+    internal_ptree_node_t * temp = NULL;
+
+    /*Keep the nodes with the same path in tree order.*/
+    jf_hlisthead_forEach(pjh, pos)
+    {
+        temp = jf_hlisthead_getEntry(pos, internal_ptree_node_t, ipn_jhnPathIndex);
+        if (! _isPtreeNodePathEqual(temp, pipn))
+            continue;
+
+        if (_isPtreeNodeBefore(pipn, temp))
+        {
+            jf_hlisthead_addBefore(&pipn->ipn_jhnPathIndex, pos);
+            return;
+        }
+
+        pjhnLast = pos;
+    }
+
+    if (pjhnLast != NULL)
+        jf_hlisthead_addAfter(pjhnLast, &pipn->ipn_jhnPathIndex);
+    else
+        jf_hlisthead_addHead(pjh, &pipn->ipn_jhnPathIndex);
 }
 
-/** Compare the key path and the nodes path.
+/** Move the nodes to the new buckets, the order of nodes with the same path is kept.
  */
-static u32 _comparePtreeNodePath(jf_stack_t ** ppjsNode, jf_string_parse_result_t * pjspr)
+static u32 _resizePtreePathIndex(internal_ptree_t * pip, u32 u32NumOfBucket)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_string_parse_result_field_t * field = pjspr->jspr_pjsprfFirst;
-    internal_ptree_node_t * pipn = NULL;
+    jf_hlisthead_t * pjhOld = pip->ip_pjhPathIndex, * pjh = NULL;
+    u32 u32Index = 0, u32NumOfOldBucket = pip->ip_u32NumOfPathIndexBucket;
+    jf_hlisthead_node_t * pos = NULL, * next = NULL, * last = NULL;
+    internal_ptree_node_t * temp = NULL;
 
-    while (field != NULL)
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pip->ip_pjhPathIndex, u32NumOfBucket * sizeof(jf_hlisthead_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
     {
-        pipn = jf_stack_pop(ppjsNode);
+        ol_bzero(pip->ip_pjhPathIndex, u32NumOfBucket * sizeof(jf_hlisthead_t));
+        pip->ip_u32NumOfPathIndexBucket = u32NumOfBucket;
 
-        if ((pipn->ipn_sName != field->jsprf_sData) ||
-            (ol_memcmp(pipn->ipn_pstrName, field->jsprf_pstrData, pipn->ipn_sName) != 0))
+        for (u32Index = 0; u32Index < u32NumOfOldBucket; u32Index ++)
         {
-            u32Ret = JF_ERR_NOT_MATCH;
-            break;
+            jf_hlisthead_forEachSafe(&pjhOld[u32Index], pos, next)
+            {
+                temp = jf_hlisthead_getEntry(pos, internal_ptree_node_t, ipn_jhnPathIndex);
+                pjh = &pip->ip_pjhPathIndex[temp->ipn_u32PathHash & (u32NumOfBucket - 1)];
+
+                /*Append to the tail of the bucket.*/
+                if (pjh->jh_pjhnFirst == NULL)
+                {
+                    jf_hlisthead_addHead(pjh, pos);
+                }
+                else
+                {
+                    last = pjh->jh_pjhnFirst;
+                    while (last->jhn_pjhnNext != NULL)
+                        last = last->jhn_pjhnNext;
+                    jf_hlisthead_addAfter(last, pos);
+                }
+            }
         }
 
-        field = field->jsprf_pjsprfNext;
+        if (pjhOld != NULL)
+            jf_jiukun_freeMemory((void **)&pjhOld);
+    }
+    else
+    {
+        pip->ip_pjhPathIndex = pjhOld;
     }
 
     return u32Ret;
 }
 
-static u32 _matchPtreeNode(jf_ptree_t * pPtree, jf_ptree_node_t * pNode, void * pArg)
+static void _indexPtreeNode(internal_ptree_t * pip, internal_ptree_node_t * pipn)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_ptree_node_t * pipn = (internal_ptree_node_t *)pNode;
-    find_ptree_node_param_t * param = (find_ptree_node_param_t *)pArg;
-    jf_string_parse_result_t * pjspr = param->fpnp_pjsprKey;
-    u32 u32NodeLevel = 0;
-    jf_stack_t * pjsNode = NULL;
+    if (pip->ip_pjhPathIndex == NULL)
+        return;
 
-    u32NodeLevel = _getPtreeNodeLevel(pipn);
-    if (u32NodeLevel == pjspr->jspr_u32NumOfResult)
+    /*Grow the index if the average length of bucket is more than 1. The index is still valid if
+      it failed to grow.*/
+    if ((pip->ip_u32NumOfIndexedNode >= pip->ip_u32NumOfPathIndexBucket) &&
+        (pip->ip_u32NumOfPathIndexBucket * 2 <= PTREE_PATH_INDEX_MAX_BUCKET))
+        _resizePtreePathIndex(pip, pip->ip_u32NumOfPathIndexBucket * 2);
+
+    _addNodeToPtreePathIndex(pip, pipn);
+    pip->ip_u32NumOfIndexedNode ++;
+}
+
+/** Remove the nodes and all their children from path index.
+ */
+static void _unindexPtreeNodeList(internal_ptree_t * pip, internal_ptree_node_t * pipn)
+{
+    while (pipn != NULL)
     {
-        /*Node level and key level are equal.*/
-        jf_stack_init(&pjsNode);
+        if (pipn->ipn_pipnChildren != NULL)
+            _unindexPtreeNodeList(pip, pipn->ipn_pipnChildren);
 
-        /*Compare the node path and key path.*/
-        u32Ret = _pushPtreeNodePathToStack(&pjsNode, pipn);
-        if (u32Ret == JF_ERR_NO_ERROR)
-            u32Ret = _comparePtreeNodePath(&pjsNode, pjspr);
+        /*The node is not in index if the pointer to previous node is NULL.*/
+        if (pipn->ipn_jhnPathIndex.jhn_ppjhnPrev != NULL)
+        {
+            jf_hlisthead_delInit(&pipn->ipn_jhnPathIndex);
+            pip->ip_u32NumOfIndexedNode --;
+        }
 
-        if (u32Ret == JF_ERR_NO_ERROR)
+        pipn = pipn->ipn_pipnSibling;
+    }
+}
+
+static u32 _fnIndexPtreeNode(jf_ptree_t * pPtree, jf_ptree_node_t * pNode, void * pArg)
+{
+    _indexPtreeNode((internal_ptree_t *)pPtree, (internal_ptree_node_t *)pNode);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _findPtreeNodeWithPathIndex(
+    internal_ptree_t * pip, olchar_t * pstrKey, olsize_t sKey, find_ptree_node_param_t * param)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    ptree_key_tokenizer_t tokenizer;
+    const olchar_t * pstrToken = NULL;
+    olsize_t sToken = 0;
+    u32 u32Hash = PTREE_PATH_HASH_SEED;
+    jf_hlisthead_node_t * pos = NULL;
+    internal_ptree_node_t * temp = NULL;
+
+    /*Hash the key.*/
+    _initPtreeKeyTokenizer(
+        &tokenizer, pstrKey, sKey, pip->ip_pstrKeySeparator, pip->ip_sKeySeparator);
+    while (_getNextPtreeKeyToken(&tokenizer, &pstrToken, &sToken))
+        u32Hash = _hashPtreePathToken(u32Hash, pstrToken, sToken);
+
+    jf_hlisthead_forEach(
+        &pip->ip_pjhPathIndex[u32Hash & (pip->ip_u32NumOfPathIndexBucket - 1)], pos)
+    {
+        temp = jf_hlisthead_getEntry(pos, internal_ptree_node_t, ipn_jhnPathIndex);
+
+        if ((temp->ipn_u32PathHash == u32Hash) &&
+            _isPtreeNodePathMatched(pip, temp, pstrKey, sKey))
         {
-            /*The node path and key path are equal. The node is found.*/
-            param->fpnp_ppNode[param->fpnp_u16NumOfNode] = pNode;
+            param->fpnp_ppNode[param->fpnp_u16NumOfNode] = temp;
             param->fpnp_u16NumOfNode ++;
             if (param->fpnp_u16NumOfNode == param->fpnp_u16MaxNode)
+                break;
+        }
+    }
+
+    return u32Ret;
+}
+
+/** Find the nodes matching the key by descending the tree, only the nodes matching the token are
+ *  visited.
+ *
+ *  @param pipn [in] The first node of this level.
+ *  @param ppkt [in] The tokenizer of the key, the next token is for this level.
+ *  @param param [in] The parameter for finding nodes.
+ */
+static u32 _findPtreeNodeByKey(
+    internal_ptree_node_t * pipn, ptree_key_tokenizer_t * ppkt, find_ptree_node_param_t * param)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    ptree_key_tokenizer_t tokenizer;
+    const olchar_t * pstrToken = NULL;
+    olsize_t sToken = 0;
+
+    _getNextPtreeKeyToken(ppkt, &pstrToken, &sToken);
+
+    while ((pipn != NULL) && (u32Ret == JF_ERR_NO_ERROR))
+    {
+        if (_isPtreeNodeNameEqual(pipn, pstrToken, sToken))
+        {
+            if (ppkt->pkt_bEnd)
+            {
+                /*This is the last token, the node is found.*/
+                param->fpnp_ppNode[param->fpnp_u16NumOfNode] = pipn;
+                param->fpnp_u16NumOfNode ++;
+                if (param->fpnp_u16NumOfNode == param->fpnp_u16MaxNode)
+                    u32Ret = JF_ERR_MAX_PTREE_NODE_FOUND;
+            }
+            else if (pipn->ipn_pipnChildren != NULL)
             {
-                /*Maximum node is reached, terminate the traverse.*/
-                return JF_ERR_MAX_PTREE_NODE_FOUND;
+                /*Each child level gets its own copy of the tokenizer.*/
+                ol_memcpy(&tokenizer, ppkt, sizeof(tokenizer));
+                u32Ret = _findPtreeNodeByKey(pipn->ipn_pipnChildren, &tokenizer, param);
             }
         }
 
-        jf_stack_clear(&pjsNode);
+        pipn = pipn->ipn_pipnSibling;
     }
 
-    return JF_ERR_NO_ERROR;
+    return u32Ret;
 }
 
 /** Build the namespace hash tree.
@@ -619,16 +1260,14 @@ static u32 _matchPtreeNode(jf_ptree_t * pPtree, jf_ptree_node_t * pNode, void *
 static u32 _buildXmlNamespaceTable(jf_ptree_t * pPtree, jf_ptree_node_t * pNode, void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_ptree_t * pip = (internal_ptree_t *)pPtree;
     internal_ptree_node_t * current = (internal_ptree_node_t *) pNode;
-    internal_ptree_node_attribute_t * attr = NULL;
-    jf_linklist_node_t * pjln = NULL;
+    internal_ptree_node_attribute_t * attr = current->ipn_pipnaAttribute;
+    boolean_t bEmpty = jf_hashtree_isEmpty(&current->ipn_jhNameSpace);
 
     /*Iterate through all the attributes to find namespace declarations.*/
-    pjln = jf_linklist_getFirstNode(&current->ipn_jlAttribute);
-    while (pjln != NULL)
+    while ((attr != NULL) && (u32Ret == JF_ERR_NO_ERROR))
     {
-        attr = jf_linklist_getDataFromNode(pjln);
-
         if ((attr->ipna_sName == 5) && (ol_strcmp(attr->ipna_pstrName, "xmlns") == 0))
         {
             /*Default namespace declaration. Eg. xmlns="http://a.b.c".*/
@@ -644,7 +1283,16 @@ static u32 _buildXmlNamespaceTable(jf_ptree_t * pPtree, jf_ptree_node_t * pNode,
                 attr->ipna_pstrValue);
         }
 
-        pjln = jf_linklist_getNextNode(pjln);
+        attr = attr->ipna_pipnaNext;
+    }
+
+    /*In arena mode, the node with name space table is saved so the table can be finalized when
+      the tree is destroyed.*/
+    if ((current->ipn_ppaArena != NULL) && bEmpty &&
+        ! jf_hashtree_isEmpty(&current->ipn_jhNameSpace))
+    {
+        current->ipn_pipnNextNameSpace = pip->ip_pipnNameSpace;
+        pip->ip_pipnNameSpace = current;
     }
 
     return u32Ret;
@@ -672,22 +1320,17 @@ static boolean_t _compareChildNode(
 }
 
 static u32 _iterateNodeAttribute(
-    jf_linklist_t * pjl, jf_ptree_fnOpAttribute_t fnOpAttribute, void * pArg)
+    internal_ptree_node_attribute_t * pipna, jf_ptree_fnOpAttribute_t fnOpAttribute, void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_linklist_node_t * pNode = NULL;
-    internal_ptree_node_attribute_t * pipna = NULL;
 
-    pNode = jf_linklist_getFirstNode(pjl);
-    while ((pNode != NULL) && (u32Ret == JF_ERR_NO_ERROR))
+    while ((pipna != NULL) && (u32Ret == JF_ERR_NO_ERROR))
     {
-        pipna = jf_linklist_getDataFromNode(pNode);
-
         u32Ret = fnOpAttribute(pipna, pArg);
 
         if (u32Ret == JF_ERR_NO_ERROR)
         {
-            pNode = jf_linklist_getNextNode(pNode);
+            pipna = pipna->ipna_pipnaNext;
         }
     }
 
@@ -695,37 +1338,34 @@ static u32 _iterateNodeAttribute(
 }
 
 static u32 _getNsAndNameFromString(
-    olchar_t * pstr, olsize_t sStr, olchar_t ** ppstrNs, olsize_t * psNs, olchar_t ** ppstrName,
-    olsize_t * psName)
+    const olchar_t * pstr, olsize_t sStr, const olchar_t ** ppstrNs, olsize_t * psNs,
+    const olchar_t ** ppstrName, olsize_t * psName)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_string_parse_result_t * pjspr = NULL;
+    ptree_key_tokenizer_t tokenizer;
+    const olchar_t * pstrToken = NULL;
+    olsize_t sToken = 0;
 
     /*Parse the key.*/
-    u32Ret = jf_string_parse(&pjspr, pstr, 0, sStr, ":", 1);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    _initPtreeKeyTokenizer(&tokenizer, pstr, sStr, ":", 1);
+    _getNextPtreeKeyToken(&tokenizer, &pstrToken, &sToken);
+
+    if (tokenizer.pkt_bEnd)
     {
-        if (pjspr->jspr_u32NumOfResult == 1)
-        {
-            /*If there is only one token, there was no namespace prefix. The whole token is the
-              attribute name.*/
-            *ppstrNs = NULL;
-            *psNs = 0;
-            *ppstrName = pjspr->jspr_pjsprfFirst->jsprf_pstrData;
-            *psName = pjspr->jspr_pjsprfFirst->jsprf_sData;
-        }
-        else
-        {
-            /*The first token is the namespace prefix, the second is the attribute name.*/
-            *ppstrNs = pjspr->jspr_pjsprfFirst->jsprf_pstrData;
-            *psNs = pjspr->jspr_pjsprfFirst->jsprf_sData;
-            *ppstrName = pjspr->jspr_pjsprfFirst->jsprf_pjsprfNext->jsprf_pstrData;
-            *psName = pjspr->jspr_pjsprfFirst->jsprf_pjsprfNext->jsprf_sData;
-        }
+        /*If there is only one token, there was no namespace prefix. The whole token is the
+          attribute name.*/
+        *ppstrNs = NULL;
+        *psNs = 0;
+        *ppstrName = pstrToken;
+        *psName = sToken;
+    }
+    else
+    {
+        /*The first token is the namespace prefix, the second is the attribute name.*/
+        *ppstrNs = pstrToken;
+        *psNs = sToken;
+        _getNextPtreeKeyToken(&tokenizer, ppstrName, psName);
     }
-
-    if (pjspr != NULL)
-        jf_string_destroyParseResult(&pjspr);
 
     return u32Ret;
 }
@@ -736,52 +1376,42 @@ static u32 _addPtreeNode(
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_t * pip = (internal_ptree_t *)pPtree;
-    jf_string_parse_result_t * pjspr = NULL;
-    jf_string_parse_result_field_t * field = NULL;
+    ptree_key_tokenizer_t tokenizer;
     jf_ptree_node_t * child = NULL, * parent = NULL;
-    olchar_t * pstrNs = NULL, * pstrName = NULL;
-    olsize_t sNs = 0, sName = 0;
+    const olchar_t * pstrToken = NULL, * pstrNs = NULL, * pstrName = NULL;
+    olsize_t sToken = 0, sNs = 0, sName = 0;
 
     /*Parse the key.*/
-    u32Ret = jf_string_parse(
-        &pjspr, pstrKey, 0, sKey, pip->ip_pstrKeySeparator, pip->ip_sKeySeparator);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    _initPtreeKeyTokenizer(
+        &tokenizer, pstrKey, sKey, pip->ip_pstrKeySeparator, pip->ip_sKeySeparator);
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && _getNextPtreeKeyToken(&tokenizer, &pstrToken, &sToken))
     {
-        field = pjspr->jspr_pjsprfFirst;
-        while (u32Ret == JF_ERR_NO_ERROR)
-        {
-            u32Ret = _getNsAndNameFromString(
-                field->jsprf_pstrData, field->jsprf_sData, &pstrNs, &sNs, &pstrName, &sName);
+        u32Ret = _getNsAndNameFromString(pstrToken, sToken, &pstrNs, &sNs, &pstrName, &sName);
 
-            /*Add the node if this is the last field.*/
-            if ((u32Ret == JF_ERR_NO_ERROR) && (field->jsprf_pjsprfNext == NULL))
-            {
-                u32Ret = jf_ptree_addChildNode(
-                    pPtree, parent, pstrNs, sNs, pstrName, sName, pstrValue, sValue, &child);
+        /*Add the node if this is the last field.*/
+        if ((u32Ret == JF_ERR_NO_ERROR) && tokenizer.pkt_bEnd)
+        {
+            u32Ret = jf_ptree_addChildNode(
+                pPtree, parent, pstrNs, sNs, pstrName, sName, pstrValue, sValue, &child);
 
-                break;
-            }
+            break;
+        }
 
-            /*Try to find the existing node.*/
-            if (u32Ret == JF_ERR_NO_ERROR)
-                u32Ret = jf_ptree_findChildNode(pPtree, parent, pstrNs, sNs, pstrName, sName, &child);
+        /*Try to find the existing node.*/
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_ptree_findChildNode(
+                pPtree, parent, (olchar_t *)pstrNs, sNs, (olchar_t *)pstrName, sName, &child);
 
-            /*Not found, create one.*/
-            if (u32Ret == JF_ERR_PTREE_NODE_NOT_FOUND)
-                u32Ret = jf_ptree_addChildNode(
-                    pPtree, parent, pstrNs, sNs, pstrName, sName, NULL, 0, &child);
+        /*Not found, create one.*/
+        if (u32Ret == JF_ERR_PTREE_NODE_NOT_FOUND)
+            u32Ret = jf_ptree_addChildNode(
+                pPtree, parent, pstrNs, sNs, pstrName, sName, NULL, 0, &child);
 
-            if (u32Ret == JF_ERR_NO_ERROR)
-            {
-                parent = child;
-                field = field->jsprf_pjsprfNext;
-            }
-        }
+        if (u32Ret == JF_ERR_NO_ERROR)
+            parent = child;
     }
 
-    if (pjspr != NULL)
-        jf_string_destroyParseResult(&pjspr);
-
     return u32Ret;
 }
 
@@ -807,15 +1437,16 @@ static u32 _mergePtree(jf_ptree_t * pPtree, jf_ptree_node_t * pNode, void * pArg
 }
 
 static u32 _addPtreeNodeAttribute(
-    jf_linklist_t * pjl, const olchar_t * pstrPrefix, olsize_t sPrefix,
-    const olchar_t * pstrName, olsize_t sName, const olchar_t * pstrValue, olsize_t sValue)
+    ptree_arena_t * ppa, internal_ptree_node_attribute_t ** ppList, const olchar_t * pstrPrefix,
+    olsize_t sPrefix, const olchar_t * pstrName, olsize_t sName, const olchar_t * pstrValue,
+    olsize_t sValue)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_attribute_t * pipna = NULL;
     jf_ptree_node_attribute_t * pAttr = NULL;
 
     /*Find the attribute.*/
-    u32Ret = _findPtreeNodeAttribute(pjl, pstrPrefix, sPrefix, pstrName, sName, &pAttr);
+    u32Ret = _findPtreeNodeAttribute(*ppList, pstrPrefix, sPrefix, pstrName, sName, &pAttr);
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
@@ -826,17 +1457,16 @@ static u32 _addPtreeNodeAttribute(
     {
         /*Create a new attribute.*/
         u32Ret = _createPtreeNodeAttribute(
-            &pipna, pstrPrefix, sPrefix, pstrName, sName, pstrValue, sValue);
+            ppa, &pipna, pstrPrefix, sPrefix, pstrName, sName, pstrValue, sValue);
 
-        /*Add to the attribute list of the declaration.*/
+        /*Add to the end of the attribute list.*/
         if (u32Ret == JF_ERR_NO_ERROR)
         {
-            u32Ret = jf_linklist_appendTo(pjl, pipna);
-        }
+            while (*ppList != NULL)
+                ppList = &(*ppList)->ipna_pipnaNext;
 
-        /*Destroy the attribute if there are errors.*/
-        if ((u32Ret != JF_ERR_NO_ERROR) && (pipna != NULL))
-            _destroyPtreeNodeAttribute(&pipna);
+            *ppList = pipna;
+        }
     }
     else
     {
@@ -853,11 +1483,28 @@ static u32 _addPtreeNodeAttribute(
 /*--------------------------------------------------------------------------*/
 
 u32 jf_ptree_create(jf_ptree_t ** ppPtree)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ptree_create_param_t jpcp;
+
+    ol_bzero(&jpcp, sizeof(jpcp));
+
+    u32Ret = jf_ptree_createWithParam(ppPtree, &jpcp);
+
+    return u32Ret;
+}
+
+u32 jf_ptree_createWithParam(jf_ptree_t ** ppPtree, jf_ptree_create_param_t * pjpcp)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_t * pip = NULL;
 
-    assert(ppPtree != NULL);
+    assert((ppPtree != NULL) && (pjpcp != NULL));
+
+    if ((pjpcp->jpcp_u32ArenaChunkSize != 0) &&
+        ((pjpcp->jpcp_u32ArenaChunkSize < PTREE_ARENA_MIN_CHUNK_SIZE) ||
+         (pjpcp->jpcp_u32ArenaChunkSize > JF_JIUKUN_MAX_MEMORY_SIZE)))
+        return JF_ERR_INVALID_PARAM;
 
     u32Ret = jf_jiukun_allocMemory((void **)&pip, sizeof(*pip));
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -867,6 +1514,14 @@ u32 jf_ptree_create(jf_ptree_t ** ppPtree)
         pip->ip_sKeySeparator = 1;
         pip->ip_pstrNsSeparator = ":";
         pip->ip_sNsSeparator = 1;
+
+        if (pjpcp->jpcp_bArena)
+        {
+            pip->ip_ppaArena = &pip->ip_paArena;
+            pip->ip_paArena.pa_sChunk = PTREE_ARENA_DEFAULT_CHUNK_SIZE;
+            if (pjpcp->jpcp_u32ArenaChunkSize != 0)
+                pip->ip_paArena.pa_sChunk = (olsize_t)pjpcp->jpcp_u32ArenaChunkSize;
+        }
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -886,8 +1541,28 @@ u32 jf_ptree_destroy(jf_ptree_t ** ppPtree)
 
     pip = (internal_ptree_t *) *ppPtree;
 
-    _destroyPtreeNodeList(&pip->ip_pipnRoot);
-    jf_linklist_finiListAndData(&pip->ip_jlDeclaration, _fnFreePtreeNodeAttribute);
+    if (pip->ip_ppaArena == NULL)
+    {
+        _destroyPtreeNodeList(&pip->ip_pipnRoot);
+        _destroyPtreeNodeAttributeList(&pip->ip_pipnaDeclaration);
+    }
+    else
+    {
+        /*Only the name space tables are not in arena.*/
+        while (pip->ip_pipnNameSpace != NULL)
+        {
+            jf_hashtree_fini(&pip->ip_pipnNameSpace->ipn_jhNameSpace);
+            pip->ip_pipnNameSpace = pip->ip_pipnNameSpace->ipn_pipnNextNameSpace;
+        }
+    }
+
+    /*Free the path index after all nodes are removed from the index.*/
+    if (pip->ip_pjhPathIndex != NULL)
+        jf_jiukun_freeMemory((void **)&pip->ip_pjhPathIndex);
+
+    /*Release all nodes, attributes and strings in arena.*/
+    if (pip->ip_ppaArena != NULL)
+        _finiPtreeArena(pip->ip_ppaArena);
 
     jf_jiukun_freeMemory(ppPtree);
 
@@ -904,6 +1579,36 @@ u32 jf_ptree_merge(jf_ptree_t * pPtreeDest, jf_ptree_t * pPtreeSource)
     return u32Ret;
 }
 
+u32 jf_ptree_enablePathIndex(jf_ptree_t * pPtree)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_ptree_t * pip = (internal_ptree_t *)pPtree;
+
+    if (pip->ip_pjhPathIndex != NULL)
+        return u32Ret;
+
+    u32Ret = _resizePtreePathIndex(pip, PTREE_PATH_INDEX_INITIAL_BUCKET);
+
+    /*Add the existing nodes to the index.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _traversePtree(pip, pip->ip_pipnRoot, _fnIndexPtreeNode, NULL);
+
+    return u32Ret;
+}
+
+void jf_ptree_getPathIndexStat(jf_ptree_t * pPtree, jf_ptree_path_index_stat_t * pStat)
+{
+    internal_ptree_t * pip = (internal_ptree_t *)pPtree;
+
+    ol_bzero(pStat, sizeof(*pStat));
+
+    if (pip->ip_pjhPathIndex == NULL)
+        return;
+
+    pStat->jppis_u32NumOfNode = pip->ip_u32NumOfIndexedNode;
+    pStat->jppis_u32NumOfBucket = pip->ip_u32NumOfPathIndexBucket;
+}
+
 u32 jf_ptree_traverse(jf_ptree_t * pPtree, jf_ptree_fnOpNode_t fnOpNode, void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -922,7 +1627,7 @@ u32 jf_ptree_dump(jf_ptree_t * pPtree)
 
     ol_printf("-----------------------------------------------------------------------\n");
 
-    _printPtreeNodeAttributeList(&pip->ip_jlDeclaration);
+    _printPtreeNodeAttributeList(pip->ip_pipnaDeclaration);
     ol_printf("\n");
     _printPtreeNodeList(pip->ip_pipnRoot, 0);
 #endif
@@ -975,7 +1680,7 @@ u32 jf_ptree_findAllNode(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_t * pip = (internal_ptree_t *)pPtree;
     internal_ptree_node_t * pipn = pip->ip_pipnRoot;
-    jf_string_parse_result_t * pjspr = NULL;
+    ptree_key_tokenizer_t tokenizer;
     find_ptree_node_param_t param;
 
     assert((ppNode != NULL) && (*pu16NumOfNode > 0));
@@ -988,26 +1693,25 @@ u32 jf_ptree_findAllNode(
         return u32Ret;
     }
 
-    /*Parse the key.*/
-    u32Ret = jf_string_parse(
-        &pjspr, pstrKey, 0, sKey, pip->ip_pstrKeySeparator, pip->ip_sKeySeparator);
-    if (u32Ret == JF_ERR_NO_ERROR)
-    {
-        ol_bzero(&param, sizeof(param));
-        param.fpnp_pjsprKey = pjspr;
-        param.fpnp_ppNode = ppNode;
-        param.fpnp_u16MaxNode = *pu16NumOfNode;
-        param.fpnp_u16NumOfNode = 0;
+    ol_bzero(&param, sizeof(param));
+    param.fpnp_ppNode = ppNode;
+    param.fpnp_u16MaxNode = *pu16NumOfNode;
+    param.fpnp_u16NumOfNode = 0;
 
-        _traversePtree(pip, pip->ip_pipnRoot, _matchPtreeNode, &param);
-
-        *pu16NumOfNode = param.fpnp_u16NumOfNode;
-        if (*pu16NumOfNode == 0)
-            u32Ret = JF_ERR_PTREE_NODE_NOT_FOUND;
+    if (pip->ip_pjhPathIndex != NULL)
+    {
+        _findPtreeNodeWithPathIndex(pip, pstrKey, sKey, &param);
+    }
+    else
+    {
+        _initPtreeKeyTokenizer(
+            &tokenizer, pstrKey, sKey, pip->ip_pstrKeySeparator, pip->ip_sKeySeparator);
+        _findPtreeNodeByKey(pipn, &tokenizer, &param);
     }
 
-    if (pjspr != NULL)
-        jf_string_destroyParseResult(&pjspr);
+    *pu16NumOfNode = param.fpnp_u16NumOfNode;
+    if (*pu16NumOfNode == 0)
+        u32Ret = JF_ERR_PTREE_NODE_NOT_FOUND;
 
     return u32Ret;
 }
@@ -1073,7 +1777,8 @@ u32 jf_ptree_addChildNode(
 
     assert(pPtree != NULL);
 
-    u32Ret = _createPtreeNode(&pipn, pstrNs, sNs, pstrName, sName, pstrValue, sValue);
+    u32Ret = _createPtreeNode(
+        pip->ip_ppaArena, &pipn, pstrNs, sNs, pstrName, sName, pstrValue, sValue);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         if (pNode == NULL)
@@ -1083,14 +1788,22 @@ u32 jf_ptree_addChildNode(
                 pip->ip_pipnRoot = pipn;
             else
                 _addPtreeSiblingNode(pip->ip_pipnRoot, pipn);
+
+            pipn->ipn_u32PathHash = _hashPtreePathToken(PTREE_PATH_HASH_SEED, pstrName, sName);
         }
         else
         {
             /*Add the created node as the child node.*/
             u32Ret = _addPtreeChildNode(pNode, pipn);
+
+            pipn->ipn_u32PathHash = _hashPtreePathToken(
+                ((internal_ptree_node_t *)pNode)->ipn_u32PathHash, pstrName, sName);
         }
     }
 
+    if (u32Ret == JF_ERR_NO_ERROR)
+        _indexPtreeNode(pip, pipn);
+
     if (u32Ret == JF_ERR_NO_ERROR)
         *ppChildNode = pipn;
     else if (pipn != NULL)
@@ -1210,11 +1923,14 @@ boolean_t jf_ptree_isLeafNode(jf_ptree_node_t * pNode)
     return bRet;
 }
 
-u32 jf_ptree_deleteNode(jf_ptree_node_t ** ppNode)
+u32 jf_ptree_deleteNode(jf_ptree_t * pPtree, jf_ptree_node_t ** ppNode)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_ptree_t * pip = (internal_ptree_t *)pPtree;
     internal_ptree_node_t * pipn = (internal_ptree_node_t *)*ppNode;
 
+    assert(pPtree != NULL);
+
     /*If parent is NULL, the node is root node, reject the operation.*/
     if (pipn->ipn_pipnParent == NULL)
         u32Ret = JF_ERR_INVALID_PARAM;
@@ -1225,6 +1941,8 @@ u32 jf_ptree_deleteNode(jf_ptree_node_t ** ppNode)
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         *ppNode = NULL;
+        /*The node is unlinked from siblings, only the node and its children are removed.*/
+        _unindexPtreeNodeList(pip, pipn);
         u32Ret = _destroyPtreeNodeList(&pipn);
     }
 
@@ -1268,7 +1986,8 @@ u32 jf_ptree_addNodeAttribute(
     internal_ptree_node_t * pipn = (internal_ptree_node_t *)pNode;
 
     u32Ret = _addPtreeNodeAttribute(
-        &pipn->ipn_jlAttribute, pstrPrefix, sPrefix, pstrName, sName, pstrValue, sValue);
+        pipn->ipn_ppaArena, &pipn->ipn_pipnaAttribute, pstrPrefix, sPrefix, pstrName, sName,
+        pstrValue, sValue);
 
     return u32Ret;
 }
@@ -1283,7 +2002,7 @@ u32 jf_ptree_findNodeAttribute(
     assert(pstrName != NULL);
 
     u32Ret = _findPtreeNodeAttribute(
-        &pipn->ipn_jlAttribute, pstrPrefix, sPrefix, pstrName, sName, ppAttr);
+        pipn->ipn_pipnaAttribute, pstrPrefix, sPrefix, pstrName, sName, ppAttr);
 
     return u32Ret;
 }
@@ -1333,12 +2052,21 @@ u32 jf_ptree_changeNodeAttributeValue(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_attribute_t * pipna = pAttr;
 
-    if (pipna->ipna_pstrValue != NULL)
-        jf_string_free(&pipna->ipna_pstrValue);
-
-    pipna->ipna_sValue = sValue;
     if (sValue > 0)
-        u32Ret = jf_string_duplicateWithLen(&pipna->ipna_pstrValue, pstrValue, sValue);
+    {
+        u32Ret = _replacePtreeString(
+            pipna->ipna_ppaArena, &pipna->ipna_pstrValue, &pipna->ipna_sValue,
+            &pipna->ipna_sValueCapacity, pstrValue, sValue);
+    }
+    else
+    {
+        if ((pipna->ipna_ppaArena == NULL) && (pipna->ipna_pstrValue != NULL))
+            jf_string_free(&pipna->ipna_pstrValue);
+
+        pipna->ipna_pstrValue = NULL;
+        pipna->ipna_sValue = 0;
+        pipna->ipna_sValueCapacity = 0;
+    }
 
     return u32Ret;
 }
@@ -1347,8 +2075,16 @@ u32 jf_ptree_deleteNodeAttribute(jf_ptree_node_t * pNode, jf_ptree_node_attribut
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_t * pipn = pNode;
+    internal_ptree_node_attribute_t ** ppipna = &pipn->ipn_pipnaAttribute;
 
-    u32Ret = jf_linklist_remove(&pipn->ipn_jlAttribute, pAttr);
+    while ((*ppipna != NULL) && (*ppipna != pAttr))
+        ppipna = &(*ppipna)->ipna_pipnaNext;
+
+    if (*ppipna != NULL)
+    {
+        *ppipna = (*ppipna)->ipna_pipnaNext;
+        _destroyPtreeNodeAttribute((internal_ptree_node_attribute_t **)&pAttr);
+    }
 
     return u32Ret;
 }
@@ -1359,7 +2095,7 @@ u32 jf_ptree_iterateNodeAttribute(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_node_t * pipn = (internal_ptree_node_t *)pNode;
 
-    u32Ret = _iterateNodeAttribute(&pipn->ipn_jlAttribute, fnOpAttribute, pArg);
+    u32Ret = _iterateNodeAttribute(pipn->ipn_pipnaAttribute, fnOpAttribute, pArg);
 
     return u32Ret;
 }
@@ -1423,7 +2159,8 @@ u32 jf_ptree_addDeclarationAttribute(
     internal_ptree_t * pip = (internal_ptree_t *)pPtree;
 
     u32Ret = _addPtreeNodeAttribute(
-        &pip->ip_jlDeclaration, pstrPrefix, sPrefix, pstrName, sName, pstrValue, sValue);
+        pip->ip_ppaArena, &pip->ip_pipnaDeclaration, pstrPrefix, sPrefix, pstrName, sName,
+        pstrValue, sValue);
 
     return u32Ret;
 }
@@ -1434,7 +2171,7 @@ u32 jf_ptree_iterateDeclarationAttribute(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_ptree_t * pip = (internal_ptree_t *)pPtree;
 
-    u32Ret = _iterateNodeAttribute(&pip->ip_jlDeclaration, fnOpAttribute, pArg);
+    u32Ret = _iterateNodeAttribute(pip->ip_pipnaDeclaration, fnOpAttribute, pArg);
 
     return u32Ret;
 }
@@ -10,11 +10,14 @@
  *  -# The property tree provides a tree structure to store key/value pairs.
  *  -# Link with jf_jiukun library for memory allocation.
  *  -# Link with jf_string library for string parse.
- *  -# Link with jf_linklist object for attribute linked list.
  *  -# Link with jf_hashtree object for name space hash.
  *  -# Link with jf_stack object for stack operation.
  *  -# This object is not thread safe.
  *  -# All strings in this header file should be with length. 
+ *  -# With arena mode, the nodes, attributes and strings are allocated from chunks owned by the
+ *   tree, the element and attribute names are interned so the same name is saved once. The
+ *   memory is released when the tree is destroyed, the memory of deleted nodes and old values is
+ *   not reused. The mode is for trees which are mostly built once and read, like XML document.
  */
 
 #ifndef JIUTAI_PTREE_H
@@ -69,6 +72,28 @@ typedef u32 (* jf_ptree_fnOpNode_t)(jf_ptree_t * pPtree, jf_ptree_node_t * pNode
  */
 typedef u32 (* jf_ptree_fnOpAttribute_t)(jf_ptree_node_attribute_t * pAttr, void * pArg);
 
+/** Define the parameter data type for creating property tree.
+ */
+typedef struct
+{
+    /**Allocate nodes, attributes and strings from the arena of the tree if it's TRUE.*/
+    boolean_t jpcp_bArena;
+    u8 jpcp_u8Reserved[3];
+    /**Size of chunk in arena, default size is used if it's 0.*/
+    u32 jpcp_u32ArenaChunkSize;
+    u32 jpcp_u32Reserved[6];
+} jf_ptree_create_param_t;
+
+/** Define the statistic data type of path index.
+ */
+typedef struct
+{
+    /**Number of node in path index.*/
+    u32 jppis_u32NumOfNode;
+    /**Number of bucket in path index.*/
+    u32 jppis_u32NumOfBucket;
+} jf_ptree_path_index_stat_t;
+
 /* --- functional routines ---------------------------------------------------------------------- */
 
 /*--------------------------------------------------------------------------*/
@@ -84,6 +109,19 @@ typedef u32 (* jf_ptree_fnOpAttribute_t)(jf_ptree_node_attribute_t * pAttr, void
  */
 u32 jf_ptree_create(jf_ptree_t ** ppPtree);
 
+/** Creates a property tree with parameter.
+ *
+ *  @note
+ *  -# The tree is the same as the one created by jf_ptree_create() if the parameter is all zero.
+ *
+ *  @param ppPtree [out] The property tree to create.
+ *  @param pjpcp [in] The parameter for creating the property tree.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_ptree_createWithParam(jf_ptree_t ** ppPtree, jf_ptree_create_param_t * pjpcp);
+
 /** Destroy property tree.
  *
  *  @param ppPtree [in/out] The property tree to destroy.
@@ -106,6 +144,35 @@ u32 jf_ptree_destroy(jf_ptree_t ** ppPtree);
  */
 u32 jf_ptree_merge(jf_ptree_t * pPtreeDest, jf_ptree_t * pPtreeSource);
 
+/** Enable the path index of property tree.
+ *
+ *  @note
+ *  -# The path index is a hash table from the full path to the nodes, it's maintained when nodes
+ *     are added and deleted. With the index, the cost of jf_ptree_findNode() depends on the length
+ *     of the key instead of the size of the tree.
+ *  -# The index is for tree with mostly unique paths like configuration tree. The cost to add a
+ *     node is high if many nodes have the same path.
+ *  -# The existing nodes are added to the index.
+ *
+ *  @param pPtree [in] The property tree.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_ptree_enablePathIndex(jf_ptree_t * pPtree);
+
+/** Get the statistic of path index.
+ *
+ *  @note
+ *  -# The statistic is all 0 if path index is not enabled.
+ *
+ *  @param pPtree [in] The property tree.
+ *  @param pStat [out] The statistic of path index.
+ *
+ *  @return Void.
+ */
+void jf_ptree_getPathIndexStat(jf_ptree_t * pPtree, jf_ptree_path_index_stat_t * pStat);
+
 /** Traverse property tree.
  *
  *  @note
@@ -327,12 +394,14 @@ boolean_t jf_ptree_isLeafNode(jf_ptree_node_t * pNode);
  *  @note
  *  -# The node to be deleted cannot be the root node.
  *  -# Use jf_ptree_destroy() to destroy the tree including the root node.
+ *  -# The node and all its children are removed from path index of the tree.
  *
+ *  @param pPtree [in] The property tree containing the node.
  *  @param ppNode [in/out] The node to be deleted.
  *
  *  @return The error code.
  */
-u32 jf_ptree_deleteNode(jf_ptree_node_t ** ppNode);
+u32 jf_ptree_deleteNode(jf_ptree_t * pPtree, jf_ptree_node_t ** ppNode);
 
 /*--------------------------------------------------------------------------*/
 /*Functions for travesing property tree by application itself.*/
@@ -456,6 +525,9 @@ u32 jf_ptree_changeNodeAttributeValue(
     jf_ptree_node_attribute_t * pAttr, const olchar_t * pstrValue, olsize_t sValue);
 
 /** Delete node attribute.
+ *
+ *  @note
+ *  -# The attribute is freed and it cannot be used after deletion.
  *
  *  @param pNode [in] The property tree node.
  *  @param pAttr [in] The node attribute.
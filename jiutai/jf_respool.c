@@ -6,7 +6,12 @@
  *  @author Min Zhang
  *
  *  @note
- *  
+ *  -# The free resources are in 2 singly linked lists, one for full time resource and one for
+ *   part time resource. The resource is pushed to and popped from the head of the list.
+ *  -# The resource put back is first stored in a cache slot selected by hash of thread ID with
+ *   atomic operation, the thread with the same slot gets it without lock.
+ *  -# The number of available resources is an atomic counter, it's negative if threads are waiting
+ *   for resource. The semaphore is used only when the counter is negative.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -17,12 +22,20 @@
 #include "jf_respool.h"
 #include "jf_logger.h"
 #include "jf_err.h"
-#include "jf_array.h"
+#include "jf_listhead.h"
 #include "jf_mutex.h"
+#include "jf_sem.h"
+#include "jf_thread.h"
+#include "jf_atomic.h"
+#include "jf_hashfunc.h"
 #include "jf_jiukun.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Number of cache slot in resource pool, it must be power of 2.
+ */
+#define RESPOOL_NUM_OF_CACHE_SLOT          (16)
+
 /** Define the internal resource state data type.
  */
 typedef enum
@@ -39,7 +52,7 @@ struct internal_resource_pool;
 
 /** Define the internal resource data type.
  */
-typedef struct
+typedef struct internal_resource
 {
     /**Full time resource if it's TRUE; otherwise part time resource.*/
     boolean_t ir_bFulltime;
@@ -50,8 +63,21 @@ typedef struct
     internal_resource_state_t ir_irsResourceState;
     /**The data of the resource.*/
     jf_respool_resource_data_t * ir_pjrrdData;
+    /**The next resource in the free list.*/
+    struct internal_resource * ir_pirNext;
+    /**The list of all resources in pool.*/
+    jf_listhead_t ir_jlResource;
 } internal_resource_t;
 
+/** Define the resource cache slot data type, the slot occupies a cache line.
+ */
+typedef struct
+{
+    /**The cached resource, NULL if the slot is empty.*/
+    internal_resource_t * rcs_pirResource;
+    u8 rcs_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE - sizeof(internal_resource_t *)];
+} respool_cache_slot_t;
+
 /** Define the internal respource pool data type.
  */
 typedef struct internal_resource_pool
@@ -64,19 +90,31 @@ typedef struct internal_resource_pool
     u32 irp_u32MaxResources;
     /**Release the parttime resource immediately after use.*/
     boolean_t irp_bImmediateRelease;
-    u8 irp_u8Reserved[7];
-    /**Synchronize the access to the resources.*/
+    u8 irp_u8Reserved[3];
+    /**Number of resources which can be got without waiting, it's negative if threads are waiting.*/
+    u32 irp_u32Available;
+    /**Number of full time resources.*/
+    u32 irp_u32NumOfFulltime;
+    /**Number of part time resources.*/
+    u32 irp_u32NumOfParttime;
+    /**Synchronize the access to the free lists and the resource list.*/
     jf_mutex_t irp_jmLock;
-    /**Array contains full time resources.*/
-    jf_array_t * irp_pjaFulltimeResources;
-    /**Array contains part time resources.*/    
-    jf_array_t * irp_pjaParttimeResources;
+    /**The thread waiting for resource is blocked on the semaphore.*/
+    jf_sem_t irp_jsWaiter;
+    /**The free full time resources.*/
+    internal_resource_t * irp_pirFreeFulltime;
+    /**The free part time resources.*/
+    internal_resource_t * irp_pirFreeParttime;
+    /**All resources in pool.*/
+    jf_listhead_t irp_jlResource;
 
     /**The callback function to create resource.*/
     jf_respool_fnCreateResource_t irp_fnCreateResource;
     /**The callback function to destroy resource.*/
     jf_respool_fnDestroyResource_t irp_fnDestroyResource;
 
+    /**The resources cached for threads.*/
+    respool_cache_slot_t irp_rcsCache[RESPOOL_NUM_OF_CACHE_SLOT];
 } internal_resource_pool_t;
 
 /* --- private routine section ------------------------------------------------------------------ */
@@ -93,7 +131,8 @@ static u32 _validateParam(jf_respool_create_param_t * pjrcp)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
 
-    if (pjrcp->jrcp_u32MinResources > pjrcp->jrcp_u32MaxResources)
+    if ((pjrcp->jrcp_u32MinResources > pjrcp->jrcp_u32MaxResources) ||
+        (pjrcp->jrcp_u32MaxResources == 0) || (pjrcp->jrcp_u32MaxResources > S32_MAX))
     {
         u32Ret = JF_ERR_INVALID_PARAM;
     }
@@ -110,7 +149,7 @@ static u32 _validateParam(jf_respool_create_param_t * pjrcp)
 
 /** Lock resource pool.
  *
- *  @param pirp [in] The pointer to the resource pool. 
+ *  @param pirp [in] The pointer to the resource pool.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
@@ -126,7 +165,7 @@ static u32 _lockResourcePool(internal_resource_pool_t * pirp)
 
 /** Unlock resource pool.
  *
- *  @param pirp [in] The pointer to the resource pool. 
+ *  @param pirp [in] The pointer to the resource pool.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
@@ -142,7 +181,10 @@ static u32 _unlockResourcePool(internal_resource_pool_t * pirp)
 
 /** Destroy a resource.
  *
- *  @param pirp [in] The pointer to the resource pool. 
+ *  @note
+ *  -# The resource should have been removed from the pool.
+ *
+ *  @param pirp [in] The pointer to the resource pool.
  *  @param ppir [in/out] The pointer to the resource to be destroyed. After destruction, it will be
  *   set to NULL.
  *
@@ -157,41 +199,12 @@ static u32 _destroyResourceInPool(internal_resource_pool_t * pirp, internal_reso
     JF_LOGGER_DEBUG("destroy resource");
 
     u32Ret = pirp->irp_fnDestroyResource((jf_respool_resource_t *)pir, &pir->ir_pjrrdData);
-    
-    jf_jiukun_freeMemory((void **)ppir);
 
-    return u32Ret;
-}
-
-static u32 _fnDestroyArrayResource(jf_array_element_t ** ppjae)
-{
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_resource_t * pir = (internal_resource_t *) *ppjae;
-    internal_resource_pool_t * pirp = pir->ir_pirpPool;
-
-    u32Ret = _destroyResourceInPool(pirp, (internal_resource_t **)ppjae);
+    jf_jiukun_freeMemory((void **)ppir);
 
     return u32Ret;
 }
 
-/** Check whether the resource is free.
- *
- *  @param pir [in] The pointer to the resource. 
- *
- *  @return The free state of the resource.
- *  @retval TRUE the resource is free.
- *  @retval FALSE the resource is not free.
- */
-static boolean_t _isPoolResourceFree(internal_resource_t * pir)
-{
-    boolean_t bFree = FALSE;
-
-    if (pir->ir_irsResourceState == IRS_FREE)
-        bFree = TRUE;
-
-    return bFree;
-}
-
 /** Set the state of the resource.
  *
  *  @param pir [in] The pointer to the resource.
@@ -210,176 +223,184 @@ static u32 _setPoolResourceState(
     return u32Ret;
 }
 
-static boolean_t _fnFindArrayResource(jf_array_element_t * pjae, void * pKey)
+/** Get the cache slot of the calling thread.
+ */
+static respool_cache_slot_t * _getResourceCacheSlot(internal_resource_pool_t * pirp)
+{
+    u64 u64Id = (u64)(ulong)jf_thread_getCurrentId();
+
+    return &pirp->irp_rcsCache[
+        (u32)jf_hashfunc_hashU64(u64Id) & (RESPOOL_NUM_OF_CACHE_SLOT - 1)];
+}
+
+/** Push the resource to the free list, the pool must be locked.
+ */
+static void _pushFreePoolResource(internal_resource_pool_t * pirp, internal_resource_t * pir)
+{
+    internal_resource_t ** ppirFree =
+        pir->ir_bFulltime ? &pirp->irp_pirFreeFulltime : &pirp->irp_pirFreeParttime;
+
+    pir->ir_pirNext = *ppirFree;
+    *ppirFree = pir;
+}
+
+/** Pop a resource from the free list, the full time resource is preferred. The pool must be
+ *  locked.
+ */
+static internal_resource_t * _popFreePoolResource(internal_resource_pool_t * pirp)
 {
-    boolean_t bFound = FALSE, bFree = FALSE;
-    internal_resource_t * pir = (internal_resource_t *) pjae;
+    internal_resource_t ** ppirFree = &pirp->irp_pirFreeFulltime;
+    internal_resource_t * pir = NULL;
 
-    JF_LOGGER_DEBUG("find array resource");
+    if (*ppirFree == NULL)
+        ppirFree = &pirp->irp_pirFreeParttime;
 
-    bFree = _isPoolResourceFree(pir);
-    if (bFree)
+    pir = *ppirFree;
+    if (pir != NULL)
     {
-        JF_LOGGER_DEBUG("from %s array", (pir->ir_bFulltime ? "fulltime" : "parttime"));
-        _setPoolResourceState(pir, IRS_BUSY);
-        bFound = TRUE;
+        *ppirFree = pir->ir_pirNext;
+        pir->ir_pirNext = NULL;
     }
 
-    return bFound;
+    return pir;
 }
 
-/** Check whether the maximum resources are reached in array.
- *
- *  @param pirp [in] The pointer to the resource pool.
- *  @param bFulltime [in] specify which array should be checked.
+/** Move the resources in cache slots to free list, the pool must be locked.
  *
- *  @return The error code.
- *  @retval JF_ERR_NO_ERROR Success.
- *  @retval JF_ERR_REACH_MAX_RESOURCES Reach maximum resources.
+ *  @return Number of resources moved.
  */
-static u32 _isMaxPoolResourcesReached(
-    internal_resource_pool_t * pirp, boolean_t bFulltime)
+static u32 _drainResourceCache(internal_resource_pool_t * pirp)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-    u32 u32Size;
+    u32 u32Index, u32Count = 0;
+    internal_resource_t * pir;
 
-    if (bFulltime)
-    {
-        u32Size = jf_array_getSize(pirp->irp_pjaFulltimeResources);
-        if (u32Size == pirp->irp_u32MinResources)
-        {
-            JF_LOGGER_DEBUG("max fulltime resource is reached");
-            u32Ret = JF_ERR_REACH_MAX_RESOURCES;
-        }
-    }
-    else
+    for (u32Index = 0; u32Index < RESPOOL_NUM_OF_CACHE_SLOT; u32Index ++)
     {
-        u32Size = jf_array_getSize(pirp->irp_pjaParttimeResources);
-        if (u32Size == pirp->irp_u32MaxResources - pirp->irp_u32MinResources)
+        pir = jf_atomic_exchangePtr(
+            (void **)&pirp->irp_rcsCache[u32Index].rcs_pirResource, NULL);
+        if (pir != NULL)
         {
-            JF_LOGGER_DEBUG("max parttime resource is reached");
-            u32Ret = JF_ERR_REACH_MAX_RESOURCES;
+            _pushFreePoolResource(pirp, pir);
+            u32Count ++;
         }
     }
 
-    return u32Ret;
+    return u32Count;
 }
 
-/** Create a resource and add it to the array.
+/** Acquire the right to get a resource.
+ *
+ *  @note
+ *  -# If no resource is available, the thread is blocked on semaphore when "bWait" is TRUE. The
+ *   right is handed over by the thread putting resource.
  *
  *  @param pirp [in] The pointer to the resource pool.
- *  @param bFulltime [in] specify if the resource is fulltime or parttime.
- *  @param state [in] The resource state.
- *  @param ppjrr [in/out] The pointer to the resource to be created and returned.
+ *  @param bWait [in] Wait for resource if it's TRUE.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_REACH_MAX_RESOURCES No resource is available and "bWait" is FALSE.
  */
-static u32 _createResourceInPoolArray(
-    internal_resource_pool_t * pirp, boolean_t bFulltime,
-    internal_resource_state_t state, jf_respool_resource_t ** ppjrr)
+static u32 _acquireResourcePermit(internal_resource_pool_t * pirp, boolean_t bWait)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    internal_resource_t * pir = NULL;
-    jf_array_t * pja;
-
-    if (bFulltime)
-        pja = pirp->irp_pjaFulltimeResources;
-    else
-        pja = pirp->irp_pjaParttimeResources;
+    s32 s32Available;
 
-    JF_LOGGER_DEBUG("%s array", (bFulltime ? "fulltime" : "parttime"));
-
-    if (u32Ret == JF_ERR_NO_ERROR)
+    if (bWait)
     {
-        _lockResourcePool(pirp);
-
-        if (u32Ret == JF_ERR_NO_ERROR)
-            u32Ret = _isMaxPoolResourcesReached(pirp, bFulltime);
-
-        if (u32Ret == JF_ERR_NO_ERROR)
-            u32Ret = jf_jiukun_allocMemory((void **)&pir, sizeof(internal_resource_t));
-
-        if (u32Ret == JF_ERR_NO_ERROR)
+        s32Available = (s32)jf_atomic_fetchAddU32(&pirp->irp_u32Available, (u32)-1);
+        if (s32Available <= 0)
         {
-            ol_bzero(pir, sizeof(internal_resource_t));
-
-            pir->ir_bFulltime = bFulltime;
-            pir->ir_pirpPool = pirp;
-            _setPoolResourceState(pir, state);
-
-            u32Ret = pirp->irp_fnCreateResource(pir, &pir->ir_pjrrdData);
+            JF_LOGGER_DEBUG("wait for resource");
+            u32Ret = jf_sem_down(&pirp->irp_jsWaiter);
         }
-    
-        if (u32Ret == JF_ERR_NO_ERROR)
+    }
+    else
+    {
+        /*Never make the counter negative, so no right will be handed over to this thread.*/
+        do
         {
-            /* append the resource to the array */
-            u32Ret = jf_array_appendElementTo(pja, (jf_array_element_t *)pir);
-        }
-
-        _unlockResourcePool(pirp);
+            s32Available = (s32)jf_atomic_loadU32(&pirp->irp_u32Available);
+            if (s32Available <= 0)
+                return JF_ERR_REACH_MAX_RESOURCES;
+        } while (! jf_atomic_casU32(
+                     &pirp->irp_u32Available, (u32)s32Available, (u32)(s32Available - 1)));
     }
 
-    if (u32Ret == JF_ERR_NO_ERROR)
-        *ppjrr = (jf_respool_resource_t *)pir;
-    else if (pir != NULL)
-        _destroyResourceInPool(pirp, &pir);
-
     return u32Ret;
 }
 
-/** Create resource.
- *
- *  @param pirp [in] The pointer to the resource pool.
- *  @param ppjrr [in/out] The pointer to the resource to be created.
- *
- *  @return The error code.
- *  @retval JF_ERR_NO_ERROR Success.
- *  @retval JF_ERR_OUT_OF_MEMORY Out of memeory.
- *  @retval JF_ERR_INVALID_PARAM Invalid parameter.
+/** Release the right to get a resource, the waiting thread is woken up.
  */
-static u32 _createResourceInPool(
-    internal_resource_pool_t * pirp, jf_respool_resource_t ** ppjrr)
+static void _releaseResourcePermit(internal_resource_pool_t * pirp)
 {
-    u32 u32Ret = JF_ERR_NO_ERROR;
-
-    /*Try to create a fulltime resource.*/
-    u32Ret = _createResourceInPoolArray(pirp, TRUE, IRS_BUSY, ppjrr);
-    if (u32Ret != JF_ERR_NO_ERROR)
-    {
-        /*Try to create a parttime resource if fulltime resource cannot be created.*/
-        u32Ret = _createResourceInPoolArray(pirp, FALSE, IRS_BUSY, ppjrr);
-    }
+    s32 s32Available = (s32)jf_atomic_fetchAddU32(&pirp->irp_u32Available, 1);
 
-    return u32Ret;    
+    if (s32Available < 0)
+        jf_sem_up(&pirp->irp_jsWaiter);
 }
 
-/** Destroy all resources in array
+/** Create a resource and add it to the pool.
+ *
+ *  @note
+ *  -# The resource is counted before this function is called, the create callback function is
+ *   called without lock.
  *
- *  @param pirp [in] The pointer to the resource pool to be destroyed. 
- *  @param ppja [in/out] The pointer to the array to be destroyed. 
+ *  @param pirp [in] The pointer to the resource pool.
+ *  @param bFulltime [in] specify if the resource is fulltime or parttime.
+ *  @param ppir [out] The pointer to the resource to be created and returned.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
  */
-static u32 _destroyResourceArray(internal_resource_pool_t * pirp, jf_array_t ** ppja)
+static u32 _createResourceInPool(
+    internal_resource_pool_t * pirp, boolean_t bFulltime, internal_resource_t ** ppir)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_resource_t * pir = NULL;
 
-    u32Ret = _lockResourcePool(pirp);
+    JF_LOGGER_DEBUG("create %s resource", (bFulltime ? "fulltime" : "parttime"));
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pir, sizeof(internal_resource_t));
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        jf_array_destroyArrayAndElements(ppja, _fnDestroyArrayResource);
+        ol_bzero(pir, sizeof(internal_resource_t));
 
-        _unlockResourcePool(pirp);
+        pir->ir_bFulltime = bFulltime;
+        pir->ir_pirpPool = pirp;
+        _setPoolResourceState(pir, IRS_BUSY);
+
+        u32Ret = pirp->irp_fnCreateResource(pir, &pir->ir_pjrrdData);
+        if (u32Ret != JF_ERR_NO_ERROR)
+            jf_jiukun_freeMemory((void **)&pir);
+    }
+
+    _lockResourcePool(pirp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_listhead_add(&pirp->irp_jlResource, &pir->ir_jlResource);
     }
+    else
+    {
+        /*Give up the count reserved for the resource.*/
+        if (bFulltime)
+            pirp->irp_u32NumOfFulltime --;
+        else
+            pirp->irp_u32NumOfParttime --;
+    }
+
+    _unlockResourcePool(pirp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        *ppir = pir;
 
     return u32Ret;
 }
 
 /** Destroy all resources in pool.
  *
- *  @param pirp [in] The pointer to the resource pool to be destroyed. 
+ *  @param pirp [in] The pointer to the resource pool to be destroyed.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
@@ -387,23 +408,26 @@ static u32 _destroyResourceArray(internal_resource_pool_t * pirp, jf_array_t **
 static u32 _destroyAllResources(internal_resource_pool_t * pirp)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_listhead_t * pos, * temp;
+    internal_resource_t * pir;
 
     JF_LOGGER_INFO("destroy all resources");
 
-    /*Destroy the full time resource.*/
-    u32Ret = _destroyResourceArray(pirp, &pirp->irp_pjaFulltimeResources);
-    if (u32Ret != JF_ERR_NO_ERROR)
+    jf_listhead_forEachSafe(&pirp->irp_jlResource, pos, temp)
     {
-        JF_LOGGER_ERR(u32Ret, "failed to destroy full time resource %s", pirp->irp_strName);
-    }
+        pir = jf_listhead_getEntry(pos, internal_resource_t, ir_jlResource);
+        jf_listhead_del(&pir->ir_jlResource);
 
-    /*Destroy the part time resource.*/
-    u32Ret = _destroyResourceArray(pirp, &pirp->irp_pjaParttimeResources);
-    if (u32Ret != JF_ERR_NO_ERROR)
-    {
-        JF_LOGGER_ERR(u32Ret, "failed to destroy part time resource %s", pirp->irp_strName);
+        u32Ret = _destroyResourceInPool(pirp, &pir);
+        if (u32Ret != JF_ERR_NO_ERROR)
+        {
+            JF_LOGGER_ERR(u32Ret, "failed to destroy resource %s", pirp->irp_strName);
+        }
     }
 
+    pirp->irp_pirFreeFulltime = pirp->irp_pirFreeParttime = NULL;
+    pirp->irp_u32NumOfFulltime = pirp->irp_u32NumOfParttime = 0;
+
     return u32Ret;
 }
 
@@ -429,18 +453,14 @@ static u32 _createResourcePool(
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_bzero(pirp, sizeof(internal_resource_pool_t));
+        jf_listhead_init(&pirp->irp_jlResource);
 
         u32Ret = jf_mutex_init(&pirp->irp_jmLock);
     }
 
-    /*Create full time resource array.*/
     if (u32Ret == JF_ERR_NO_ERROR)
-        u32Ret = jf_array_create(&pirp->irp_pjaFulltimeResources);
+        u32Ret = jf_sem_init(&pirp->irp_jsWaiter, 0, S32_MAX);
 
-    /*Create part time resource array.*/
-    if (u32Ret == JF_ERR_NO_ERROR)
-        u32Ret = jf_array_create(&pirp->irp_pjaParttimeResources);
-    
     /*Set the resource pool.*/
     if (u32Ret == JF_ERR_NO_ERROR)
     {
@@ -449,10 +469,11 @@ static u32 _createResourcePool(
 
         pirp->irp_u32MaxResources = pjrcp->jrcp_u32MaxResources;
         pirp->irp_u32MinResources = pjrcp->jrcp_u32MinResources;
+        pirp->irp_u32Available = pjrcp->jrcp_u32MaxResources;
+
+        /*Part time resource is released after use unless it's reaped later.*/
+        pirp->irp_bImmediateRelease = ! pjrcp->jrcp_bReapParttime;
 
-        /*Set to TRUE so part time resource is released after use.*/
-        pirp->irp_bImmediateRelease = TRUE;
-        
         ol_strncpy(pirp->irp_strName, pjrcp->jrcp_pstrName, sizeof(pirp->irp_strName) - 1);
     }
 
@@ -464,68 +485,91 @@ static u32 _createResourcePool(
     return u32Ret;
 }
 
-/** Get resource from array in resource pool.
+/** Get resource from resource pool.
+ *
+ *  @note
+ *  -# The cache slot of the thread is checked first without lock, then the free lists. A new
+ *   resource is created if no free resource is found.
  *
  *  @param pirp [in] The pointer to internal resource pool.
- *  @param pja [in] The array contains resources.
- *  @param ppRes [in/out] The pointer to the resource. 
+ *  @param bWait [in] Wait for resource if the maximum number of resources are in use.
+ *  @param ppRes [in/out] The pointer to the resource.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_REACH_MAX_RESOURCES No resource is available and "bWait" is FALSE.
  */
-static u32 _getResourceFromPoolArray(
-    internal_resource_pool_t * pirp, jf_array_t * pja, jf_respool_resource_t ** ppRes)
+static u32 _getResourceFromPool(
+    internal_resource_pool_t * pirp, boolean_t bWait, jf_respool_resource_t ** ppRes)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_resource_t * pir = NULL;
+    respool_cache_slot_t * prcs = NULL;
+    boolean_t bFulltime = FALSE, bCreate = FALSE;
 
     *ppRes = NULL;
 
-    u32Ret = _lockResourcePool(pirp);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    /*There is a free resource or a resource can be created after the permit is acquired.*/
+    u32Ret = _acquireResourcePermit(pirp, bWait);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    prcs = _getResourceCacheSlot(pirp);
+    pir = jf_atomic_exchangePtr((void **)&prcs->rcs_pirResource, NULL);
+
+    while ((pir == NULL) && (! bCreate))
     {
-        u32Ret = jf_array_findElement(
-            pja, (jf_array_element_t **)ppRes, _fnFindArrayResource, NULL);
+        _lockResourcePool(pirp);
+
+        pir = _popFreePoolResource(pirp);
+        if (pir == NULL)
+        {
+            if (pirp->irp_u32NumOfFulltime < pirp->irp_u32MinResources)
+            {
+                pirp->irp_u32NumOfFulltime ++;
+                bFulltime = bCreate = TRUE;
+            }
+            else if (pirp->irp_u32NumOfParttime <
+                     pirp->irp_u32MaxResources - pirp->irp_u32MinResources)
+            {
+                pirp->irp_u32NumOfParttime ++;
+                bCreate = TRUE;
+            }
+            else if (_drainResourceCache(pirp) > 0)
+            {
+                /*The free resources are in cache slots of other threads.*/
+                pir = _popFreePoolResource(pirp);
+            }
+        }
 
         _unlockResourcePool(pirp);
-    }
 
-    return u32Ret;
-}
+        /*The resource may be taken from a slot by other thread with permit, the thread owns
+          another free resource, retry.*/
+        if ((pir == NULL) && (! bCreate))
+            jf_atomic_cpuRelax();
+    }
 
-/** Get resource from resource pool.
- *
- *  @param pirp [in] The pointer to internal resource pool.
- *  @param ppRes [in/out] The pointer to the resource. 
- *
- *  @return The error code.
- *  @retval JF_ERR_NO_ERROR Success.
- */
-static u32 _getResourceFromPool(
-    internal_resource_pool_t * pirp, jf_respool_resource_t ** ppRes)
-{
-    u32 u32Ret = JF_ERR_NO_ERROR;
+    if (bCreate)
+        u32Ret = _createResourceInPool(pirp, bFulltime, &pir);
 
-    /*Get resource from full time array.*/
-    u32Ret = _getResourceFromPoolArray(pirp, pirp->irp_pjaFulltimeResources, ppRes);
-    if (u32Ret != JF_ERR_NO_ERROR)
+    if (u32Ret == JF_ERR_NO_ERROR)
     {
-        /*Get resource from partime time array.*/
-        u32Ret = _getResourceFromPoolArray(pirp, pirp->irp_pjaParttimeResources, ppRes);
+        _setPoolResourceState(pir, IRS_BUSY);
+        *ppRes = (jf_respool_resource_t *)pir;
     }
-
-    /*Create resource if no resource is available.*/
-    if (u32Ret != JF_ERR_NO_ERROR)
+    else
     {
-        u32Ret = _createResourceInPool(pirp, ppRes);
+        _releaseResourcePermit(pirp);
     }
-    
+
     return u32Ret;
 }
 
 /** Put resource in resource pool.
  *
  *  @param pirp [in] The pointer to internal resource pool.
- *  @param ppjrr [in/out] The pointer to the resource. 
+ *  @param ppjrr [in/out] The pointer to the resource.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
@@ -536,27 +580,35 @@ static u32 _putResourceInPool(
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_resource_t * pir = (internal_resource_t *)*ppjrr;
+    respool_cache_slot_t * prcs = NULL;
 
-    u32Ret = _lockResourcePool(pirp);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    _setPoolResourceState(pir, IRS_FREE);
+
+    if ((! pir->ir_bFulltime) && pirp->irp_bImmediateRelease)
     {
-        if (pir->ir_bFulltime)
-        {
-            /*Change the state to free for full time resource.*/
-            _setPoolResourceState(pir, IRS_FREE);
-        }
-        else if (pirp->irp_bImmediateRelease)
+        /*Destroy the resouce if it's part time.*/
+        _lockResourcePool(pirp);
+        jf_listhead_del(&pir->ir_jlResource);
+        pirp->irp_u32NumOfParttime --;
+        _unlockResourcePool(pirp);
+
+        u32Ret = _destroyResourceInPool(pirp, &pir);
+    }
+    else
+    {
+        /*Cache the resource for the thread, put it to free list if the slot is occupied.*/
+        prcs = _getResourceCacheSlot(pirp);
+        if (! jf_atomic_casPtr((void **)&prcs->rcs_pirResource, NULL, pir))
         {
-            /*Destroy the resouce if it's part time.*/
-            u32Ret = jf_array_removeElement(
-                pirp->irp_pjaParttimeResources, (jf_array_element_t *)pir);
-            if (u32Ret == JF_ERR_NO_ERROR)
-                _destroyResourceInPool(pirp, &pir);
+            _lockResourcePool(pirp);
+            _pushFreePoolResource(pirp, pir);
+            _unlockResourcePool(pirp);
         }
-
-        _unlockResourcePool(pirp);
     }
 
+    /*The resource must be available before the permit is released.*/
+    _releaseResourcePermit(pirp);
+
     *ppjrr = NULL;
 
     return u32Ret;
@@ -564,7 +616,7 @@ static u32 _putResourceInPool(
 
 /** Find the free part time resources, and release them.
  *
- *  @param pirp [in] The pointer to the internal resource pool. 
+ *  @param pirp [in] The pointer to the internal resource pool.
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
@@ -572,41 +624,35 @@ static u32 _putResourceInPool(
 static u32 _reapResourceInPool(internal_resource_pool_t * pirp)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_array_t * pja;
-    internal_resource_t * pir;
-    boolean_t bFree;
-    u32 u32Index = 0, u32Size = 0;
-    
+    internal_resource_t * pirFree = NULL, * pir = NULL;
+
     u32Ret = _lockResourcePool(pirp);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        /*The resource can be timed out.*/
-        pja = pirp->irp_pjaParttimeResources;
-        u32Index = 0;
-        u32Size = jf_array_getSize(pja);
-        while ((u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32Size))
+        _drainResourceCache(pirp);
+
+        /*Detach all free part time resources.*/
+        pirFree = pirp->irp_pirFreeParttime;
+        pirp->irp_pirFreeParttime = NULL;
+
+        for (pir = pirFree; pir != NULL; pir = pir->ir_pirNext)
         {
-            u32Ret = jf_array_getElementAt(pja, u32Index, (jf_array_element_t **)&pir);
-            if (u32Ret == JF_ERR_NO_ERROR)
-            {
-                /*Try to destroy it if it free.*/
-                bFree = _isPoolResourceFree(pir);
-                if (bFree)
-                {
-                    pirp->irp_fnDestroyResource(pir, &pir->ir_pjrrdData);
-                    jf_array_removeElementAt(pja, u32Index);
-                    u32Size --;
-                }
-                else
-                {
-                    u32Index ++;
-                }
-            }
+            jf_listhead_del(&pir->ir_jlResource);
+            pirp->irp_u32NumOfParttime --;
         }
 
         _unlockResourcePool(pirp);
     }
 
+    /*Destroy them without lock.*/
+    while (pirFree != NULL)
+    {
+        pir = pirFree;
+        pirFree = pirFree->ir_pirNext;
+
+        _destroyResourceInPool(pirp, &pir);
+    }
+
     return u32Ret;
 }
 
@@ -621,7 +667,7 @@ u32 jf_respool_create(jf_respool_t ** ppjr, jf_respool_create_param_t * pjrcp)
 
     JF_LOGGER_INFO(
         "pool: %s, min: %u, max: %u", pjrcp->jrcp_pstrName, pjrcp->jrcp_u32MinResources,
-        pjrcp->jrcp_u32MinResources);
+        pjrcp->jrcp_u32MaxResources);
 
     /*Validate the parameter.*/
     u32Ret = _validateParam(pjrcp);
@@ -642,7 +688,7 @@ u32 jf_respool_destroy(jf_respool_t ** ppjr)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_resource_pool_t * pirp = NULL;
-    
+
     assert(ppjr != NULL);
 
     pirp = (internal_resource_pool_t *)*ppjr;
@@ -653,7 +699,8 @@ u32 jf_respool_destroy(jf_respool_t ** ppjr)
     /*Destroy all resources.*/
     _destroyAllResources(pirp);
 
-    /*Destroy the mutex.*/
+    /*Destroy the semaphore and the mutex.*/
+    jf_sem_fini(&pirp->irp_jsWaiter);
     jf_mutex_fini(&(pirp->irp_jmLock));
 
     /*Free the resource pool.*/
@@ -670,15 +717,24 @@ u32 jf_respool_getResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes)
     assert((pjr != NULL) && (ppRes != NULL));
 
     JF_LOGGER_DEBUG("pool: %s", pirp->irp_strName);
-    
-    /*Get resource from pool.*/
-    u32Ret = _getResourceFromPool(pirp, ppRes);
-    if (u32Ret != JF_ERR_NO_ERROR)
-    {
-        /*Create resource if no resouce is available.*/
-        u32Ret = _createResourceInPool(pirp, ppRes);
-    }
-    
+
+    /*Get resource from pool, resource is created if no resouce is available.*/
+    u32Ret = _getResourceFromPool(pirp, FALSE, ppRes);
+
+    return u32Ret;
+}
+
+u32 jf_respool_waitForResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_resource_pool_t * pirp = (internal_resource_pool_t *)pjr;
+
+    assert((pjr != NULL) && (ppRes != NULL));
+
+    JF_LOGGER_DEBUG("pool: %s", pirp->irp_strName);
+
+    u32Ret = _getResourceFromPool(pirp, TRUE, ppRes);
+
     return u32Ret;
 }
 
@@ -690,7 +746,7 @@ u32 jf_respool_putResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes)
     assert((pjr != NULL) && (ppRes != NULL));
 
     JF_LOGGER_DEBUG("pool: %s", pirp->irp_strName);
-    
+
     u32Ret = _putResourceInPool(pirp, ppRes);
 
     return u32Ret;
@@ -700,7 +756,7 @@ u32 jf_respool_reapResource(jf_respool_t * pjr)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_resource_pool_t * pirp = (internal_resource_pool_t *)pjr;
-    
+
     assert(pjr != NULL);
 
     JF_LOGGER_DEBUG("pool: %s", pirp->irp_strName);
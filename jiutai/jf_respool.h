@@ -9,9 +9,14 @@
  *  @note
  *  -# Routines declared in this file are included in jf_respool object.
  *  -# Link with jf_mutex common object for mutex data type.
- *  -# Link with jf_array common object for array data type.
+ *  -# Link with jf_sem common object for semaphore data type.
  *  -# Link with jiukun library for memory allocation.
  *  -# The object is thread safe.
+ *  -# The free resources are kept in free lists, getting and putting resource are O(1). The
+ *   resource put by a thread is cached in a slot selected by the thread ID, the thread gets the
+ *   resource from the slot without lock next time.
+ *  -# jf_respool_getResource() returns error immediately if the maximum number of resources are
+ *   in use, the caller is blocked by jf_respool_waitForResource() in this case.
  *
  */
 
@@ -73,6 +78,8 @@ typedef u32 (* jf_respool_fnDestroyResource_t)(
  *  @note
  *  -# The minimum number of resources is full time resources which are not released after use.
  *   Other resources are part time resource which are released after use.
+ *  -# If jrcp_bReapParttime is TRUE, the part time resource is kept after use and it's released
+ *   by jf_respool_reapResource().
  */
 typedef struct
 {
@@ -82,7 +89,9 @@ typedef struct
     u32 jrcp_u32MinResources;
     /**Maximum number of resources that can co-exist at the same time.*/
     u32 jrcp_u32MaxResources;
-    u8 jrcp_u8Reserved[8];
+    /**Keep the part time resource after use until it's reaped.*/
+    boolean_t jrcp_bReapParttime;
+    u8 jrcp_u8Reserved[7];
     /**The callback function is to creat resource.*/
     jf_respool_fnCreateResource_t jrcp_fnCreateResource;
     /**The callback function is to destroy resource.*/
@@ -117,16 +126,30 @@ u32 jf_respool_create(jf_respool_t ** ppjr, jf_respool_create_param_t * pjrcp);
  */
 u32 jf_respool_destroy(jf_respool_t ** ppjr);
 
-/** Get resource from resource pool.
+/** Get resource from resource pool, the routine returns immediately if the maximum number of
+ *  resources are in use.
  *
  *  @param pjr [in] The pointer to resource pool.
  *  @param ppRes [in/out] The pointer to the resource. 
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_REACH_MAX_RESOURCES The maximum number of resources are in use.
  */
 u32 jf_respool_getResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes);
 
+/** Get resource from resource pool, the routine blocks until a resource is put back if the
+ *  maximum number of resources are in use.
+ *
+ *  @param pjr [in] The pointer to resource pool.
+ *  @param ppRes [in/out] The pointer to the resource. 
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_DOWN_SEM Failed to wait for the resource.
+ */
+u32 jf_respool_waitForResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes);
+
 /** Put resource in resource pool.
  *
  *  @note
@@ -140,6 +163,18 @@ u32 jf_respool_getResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes);
  */
 u32 jf_respool_putResource(jf_respool_t * pjr, jf_respool_resource_t ** ppRes);
 
+/** Release the free part time resources.
+ *
+ *  @note
+ *  -# The resources cached by threads are also released if they are part time.
+ *
+ *  @param pjr [in] The pointer to resource pool.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_respool_reapResource(jf_respool_t * pjr);
+
 #endif /*JIUTAI_RESPOOL_H*/
 
 /*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,461 @@
+/**
+ *  @file jf_ringqueue.c
+ *
+ *  @brief Implementation file for bounded ring queue.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Each slot has a sequence number. The slot for position N is free for producer if the
+ *   sequence is N, and it's ready for consumer if the sequence is N + 1. The consumer sets the
+ *   sequence to N + capacity after taking the item, so the slot is free for the next round.
+ *  -# The producers claim the position by compare-and-swap on the enqueue position. The consumers
+ *   of multiple consumer queue do the same on the dequeue position, the consumer of single
+ *   consumer queue updates the dequeue position with plain store.
+ *  -# The positions are 64-bit and never wrap around in practice.
+ *  -# The enqueue position, dequeue position and the waiting data are in different cache lines to
+ *   avoid false sharing between producers and consumers.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(LINUX)
+    #include <limits.h>
+    #include <time.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_ringqueue.h"
+#include "jf_atomic.h"
+#include "jf_jiukun.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Minimum capacity of the ring queue.
+ */
+#define RINGQUEUE_MIN_CAPACITY             (2)
+
+/** Define the slot data type of ring queue.
+ */
+typedef struct
+{
+    /**The sequence number, it's accessed atomically.*/
+    u64 rs_u64Sequence;
+    /**The item.*/
+    void * rs_pData;
+} ringqueue_slot_t;
+
+/** Define the position data type, it occupies one cache line.
+ */
+typedef struct
+{
+    /**The position, it's accessed atomically.*/
+    u64 rp_u64Pos;
+    u8 rp_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE - sizeof(u64)];
+} ringqueue_position_t;
+
+/** Define the internal ring queue data type.
+ */
+typedef struct
+{
+    /**Position for next enqueue, it's accessed by producers.*/
+    ringqueue_position_t ijr_rpEnqueue;
+    /**Position for next dequeue, it's accessed by consumers.*/
+    ringqueue_position_t ijr_rpDequeue;
+
+    /**The futex word, it's increased when waiting consumers are woken up.*/
+    u32 ijr_u32Signal;
+    /**Number of consumers waiting for item.*/
+    u32 ijr_u32Waiter;
+    /**It's increased when all consumers are woken up by jf_ringqueue_wakeupAll().*/
+    u32 ijr_u32Wakeup;
+    u8 ijr_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE - 3 * sizeof(u32)];
+
+    /**Number of slot, power of 2.*/
+    u32 ijr_u32Capacity;
+    /**Mask of the position.*/
+    u32 ijr_u32Mask;
+    /**Single consumer queue.*/
+    boolean_t ijr_bSingleConsumer;
+    u8 ijr_u8Reserved[7];
+    /**The slot array.*/
+    ringqueue_slot_t * ijr_prsSlot;
+} internal_jf_ringqueue_t;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static inline olsize_t _getRingqueueSlotArraySize(u32 u32Capacity)
+{
+    return (olsize_t)u32Capacity * sizeof(ringqueue_slot_t);
+}
+
+/** Allocate memory for the slot array.
+ */
+static u32 _allocRingqueueSlotArray(u32 u32Capacity, ringqueue_slot_t ** pprs)
+{
+    return jf_jiukun_allocLargeMemory((void **)pprs, _getRingqueueSlotArraySize(u32Capacity));
+}
+
+static void _freeRingqueueSlotArray(u32 u32Capacity, ringqueue_slot_t ** pprs)
+{
+    jf_jiukun_freeLargeMemory((void **)pprs, _getRingqueueSlotArraySize(u32Capacity));
+}
+
+/** Wait on the futex word if its value is still the expected value.
+ *
+ *  @param pu32Addr [in] The futex word.
+ *  @param u32Value [in] The expected value.
+ *  @param u32Timeout [in] The maximum waiting period in milliseconds, U32_MAX means no timeout.
+ */
+static void _waitRingqueueSignal(u32 * pu32Addr, u32 u32Value, u32 u32Timeout)
+{
+#if defined(LINUX)
+    struct timespec ts, * pts = NULL;
+
+    if (u32Timeout != U32_MAX)
+    {
+        ts.tv_sec = u32Timeout / 1000;
+        ts.tv_nsec = (u32Timeout % 1000) * 1000000;
+        pts = &ts;
+    }
+
+    syscall(SYS_futex, pu32Addr, FUTEX_WAIT_PRIVATE, u32Value, pts, NULL, 0);
+#elif defined(WINDOWS)
+    WaitOnAddress(
+        pu32Addr, &u32Value, sizeof(u32), (u32Timeout != U32_MAX) ? u32Timeout : INFINITE);
+#endif
+}
+
+static void _wakeRingqueueSignal(u32 * pu32Addr, boolean_t bAll)
+{
+#if defined(LINUX)
+    syscall(SYS_futex, pu32Addr, FUTEX_WAKE_PRIVATE, bAll ? INT_MAX : 1, NULL, NULL, 0);
+#elif defined(WINDOWS)
+    if (bAll)
+        WakeByAddressAll(pu32Addr);
+    else
+        WakeByAddressSingle(pu32Addr);
+#endif
+}
+
+/** Get the current time in milliseconds from a monotonic clock.
+ */
+static u64 _getRingqueueTime(void)
+{
+#if defined(LINUX)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (u64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#elif defined(WINDOWS)
+    return GetTickCount64();
+#endif
+}
+
+static u32 _dequeueRingqueueSingle(internal_jf_ringqueue_t * pijr, void ** ppData)
+{
+    u64 u64Pos = pijr->ijr_rpDequeue.rp_u64Pos;
+    ringqueue_slot_t * prs = &pijr->ijr_prsSlot[u64Pos & pijr->ijr_u32Mask];
+
+    if (jf_atomic_loadU64(&prs->rs_u64Sequence) != u64Pos + 1)
+        return JF_ERR_QUEUE_EMPTY;
+
+    *ppData = prs->rs_pData;
+    jf_atomic_storeU64(&pijr->ijr_rpDequeue.rp_u64Pos, u64Pos + 1);
+    /*Free the slot for the next round.*/
+    jf_atomic_storeU64(&prs->rs_u64Sequence, u64Pos + pijr->ijr_u32Capacity);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _dequeueRingqueueMulti(internal_jf_ringqueue_t * pijr, void ** ppData)
+{
+    u64 u64Pos = 0, u64Seq = 0;
+    ringqueue_slot_t * prs = NULL;
+    s64 s64Diff = 0;
+
+    u64Pos = jf_atomic_loadU64(&pijr->ijr_rpDequeue.rp_u64Pos);
+    while (TRUE)
+    {
+        prs = &pijr->ijr_prsSlot[u64Pos & pijr->ijr_u32Mask];
+        u64Seq = jf_atomic_loadU64(&prs->rs_u64Sequence);
+        s64Diff = (s64)(u64Seq - (u64Pos + 1));
+
+        if (s64Diff == 0)
+        {
+            /*The item is ready, claim the position.*/
+            if (jf_atomic_casU64(&pijr->ijr_rpDequeue.rp_u64Pos, u64Pos, u64Pos + 1))
+                break;
+            u64Pos = jf_atomic_loadU64(&pijr->ijr_rpDequeue.rp_u64Pos);
+        }
+        else if (s64Diff < 0)
+        {
+            /*The producer has not filled the slot.*/
+            return JF_ERR_QUEUE_EMPTY;
+        }
+        else
+        {
+            /*Other consumer has taken the position.*/
+            u64Pos = jf_atomic_loadU64(&pijr->ijr_rpDequeue.rp_u64Pos);
+        }
+    }
+
+    *ppData = prs->rs_pData;
+    jf_atomic_storeU64(&prs->rs_u64Sequence, u64Pos + pijr->ijr_u32Capacity);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static inline u32 _dequeueRingqueue(internal_jf_ringqueue_t * pijr, void ** ppData)
+{
+    if (pijr->ijr_bSingleConsumer)
+        return _dequeueRingqueueSingle(pijr, ppData);
+
+    return _dequeueRingqueueMulti(pijr, ppData);
+}
+
+/** Dequeue an item, wait on the futex if the queue is empty.
+ *
+ *  @note
+ *  -# The consumer registers itself as waiter and reads the futex word before checking the queue
+ *   again. The producer checks the waiter after the item is published, so either the consumer
+ *   sees the item, or the producer sees the waiter and changes the futex word, the wakeup is not
+ *   lost.
+ */
+static u32 _dequeueRingqueueWait(internal_jf_ringqueue_t * pijr, void ** ppData, u32 u32Timeout)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Wakeup = jf_atomic_loadU32(&pijr->ijr_u32Wakeup);
+    u32 u32Signal = 0, u32Remain = U32_MAX;
+    u64 u64Deadline = 0, u64Now = 0;
+
+    if (u32Timeout != U32_MAX)
+        u64Deadline = _getRingqueueTime() + u32Timeout;
+
+    while (TRUE)
+    {
+        u32Ret = _dequeueRingqueue(pijr, ppData);
+        if ((u32Ret == JF_ERR_NO_ERROR) || (jf_atomic_loadU32(&pijr->ijr_u32Wakeup) != u32Wakeup))
+            break;
+
+        if (u32Timeout != U32_MAX)
+        {
+            u64Now = _getRingqueueTime();
+            if (u64Now >= u64Deadline)
+            {
+                u32Ret = JF_ERR_TIMEOUT;
+                break;
+            }
+            u32Remain = (u32)(u64Deadline - u64Now);
+        }
+
+        jf_atomic_fetchAddU32(&pijr->ijr_u32Waiter, 1);
+        u32Signal = jf_atomic_loadU32(&pijr->ijr_u32Signal);
+        jf_atomic_fence();
+
+        u32Ret = _dequeueRingqueue(pijr, ppData);
+        if ((u32Ret != JF_ERR_NO_ERROR) &&
+            (jf_atomic_loadU32(&pijr->ijr_u32Wakeup) == u32Wakeup))
+            _waitRingqueueSignal(&pijr->ijr_u32Signal, u32Signal, u32Remain);
+
+        jf_atomic_fetchAddU32(&pijr->ijr_u32Waiter, (u32)-1);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            break;
+    }
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_ringqueue_create(jf_ringqueue_t ** ppQueue, jf_ringqueue_create_param_t * pjrcp)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jf_ringqueue_t * pijr = NULL;
+    u32 u32Capacity = RINGQUEUE_MIN_CAPACITY, u32Index = 0;
+
+    assert((ppQueue != NULL) && (pjrcp != NULL));
+
+    if ((pjrcp->jrcp_u32Capacity == 0) ||
+        (pjrcp->jrcp_u32Capacity > JF_RINGQUEUE_MAX_CAPACITY))
+        return JF_ERR_INVALID_PARAM;
+
+    while (u32Capacity < pjrcp->jrcp_u32Capacity)
+        u32Capacity <<= 1;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pijr, sizeof(*pijr));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pijr, sizeof(*pijr));
+        pijr->ijr_u32Capacity = u32Capacity;
+        pijr->ijr_u32Mask = u32Capacity - 1;
+        pijr->ijr_bSingleConsumer = pjrcp->jrcp_bSingleConsumer;
+
+        u32Ret = _allocRingqueueSlotArray(u32Capacity, &pijr->ijr_prsSlot);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The slot for position N is free when its sequence is N.*/
+        for (u32Index = 0; u32Index < u32Capacity; u32Index ++)
+        {
+            pijr->ijr_prsSlot[u32Index].rs_u64Sequence = u32Index;
+            pijr->ijr_prsSlot[u32Index].rs_pData = NULL;
+        }
+
+        *ppQueue = pijr;
+    }
+    else if (pijr != NULL)
+    {
+        jf_ringqueue_destroy((jf_ringqueue_t **)&pijr);
+    }
+
+    return u32Ret;
+}
+
+u32 jf_ringqueue_destroy(jf_ringqueue_t ** ppQueue)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_jf_ringqueue_t * pijr = NULL;
+
+    assert((ppQueue != NULL) && (*ppQueue != NULL));
+
+    pijr = (internal_jf_ringqueue_t *)*ppQueue;
+
+    if (pijr->ijr_prsSlot != NULL)
+        _freeRingqueueSlotArray(pijr->ijr_u32Capacity, &pijr->ijr_prsSlot);
+
+    jf_jiukun_freeMemory(ppQueue);
+
+    return u32Ret;
+}
+
+u32 jf_ringqueue_enqueue(jf_ringqueue_t * pQueue, void * pData)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+    u64 u64Pos = 0, u64Seq = 0;
+    ringqueue_slot_t * prs = NULL;
+    s64 s64Diff = 0;
+
+    assert(pQueue != NULL);
+
+    u64Pos = jf_atomic_loadU64(&pijr->ijr_rpEnqueue.rp_u64Pos);
+    while (TRUE)
+    {
+        prs = &pijr->ijr_prsSlot[u64Pos & pijr->ijr_u32Mask];
+        u64Seq = jf_atomic_loadU64(&prs->rs_u64Sequence);
+        s64Diff = (s64)(u64Seq - u64Pos);
+
+        if (s64Diff == 0)
+        {
+            /*The slot is free, claim the position.*/
+            if (jf_atomic_casU64(&pijr->ijr_rpEnqueue.rp_u64Pos, u64Pos, u64Pos + 1))
+                break;
+            u64Pos = jf_atomic_loadU64(&pijr->ijr_rpEnqueue.rp_u64Pos);
+        }
+        else if (s64Diff < 0)
+        {
+            /*The consumer has not taken the item of last round.*/
+            return JF_ERR_QUEUE_FULL;
+        }
+        else
+        {
+            /*Other producer has taken the position.*/
+            u64Pos = jf_atomic_loadU64(&pijr->ijr_rpEnqueue.rp_u64Pos);
+        }
+    }
+
+    /*Publish the item.*/
+    prs->rs_pData = pData;
+    jf_atomic_storeU64(&prs->rs_u64Sequence, u64Pos + 1);
+
+    /*Wake up the consumer only if someone is waiting.*/
+    jf_atomic_fence();
+    if (jf_atomic_loadU32(&pijr->ijr_u32Waiter) != 0)
+    {
+        jf_atomic_fetchAddU32(&pijr->ijr_u32Signal, 1);
+        _wakeRingqueueSignal(&pijr->ijr_u32Signal, FALSE);
+    }
+
+    return JF_ERR_NO_ERROR;
+}
+
+u32 jf_ringqueue_dequeue(jf_ringqueue_t * pQueue, void ** ppData)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+
+    assert((pQueue != NULL) && (ppData != NULL));
+
+    return _dequeueRingqueue(pijr, ppData);
+}
+
+u32 jf_ringqueue_dequeueWait(jf_ringqueue_t * pQueue, void ** ppData)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+
+    assert((pQueue != NULL) && (ppData != NULL));
+
+    return _dequeueRingqueueWait(pijr, ppData, U32_MAX);
+}
+
+u32 jf_ringqueue_dequeueWaitWithTimeout(jf_ringqueue_t * pQueue, void ** ppData, u32 u32Timeout)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+
+    assert((pQueue != NULL) && (ppData != NULL));
+
+    /*U32_MAX is reserved for waiting forever.*/
+    if (u32Timeout == U32_MAX)
+        u32Timeout --;
+
+    return _dequeueRingqueueWait(pijr, ppData, u32Timeout);
+}
+
+void jf_ringqueue_wakeupAll(jf_ringqueue_t * pQueue)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+
+    assert(pQueue != NULL);
+
+    jf_atomic_fetchAddU32(&pijr->ijr_u32Wakeup, 1);
+    jf_atomic_fetchAddU32(&pijr->ijr_u32Signal, 1);
+    _wakeRingqueueSignal(&pijr->ijr_u32Signal, TRUE);
+}
+
+u32 jf_ringqueue_getSize(jf_ringqueue_t * pQueue)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+    u64 u64Dequeue = 0, u64Enqueue = 0;
+
+    assert(pQueue != NULL);
+
+    u64Dequeue = jf_atomic_loadU64(&pijr->ijr_rpDequeue.rp_u64Pos);
+    u64Enqueue = jf_atomic_loadU64(&pijr->ijr_rpEnqueue.rp_u64Pos);
+
+    if (u64Enqueue <= u64Dequeue)
+        return 0;
+
+    if (u64Enqueue - u64Dequeue > pijr->ijr_u32Capacity)
+        return pijr->ijr_u32Capacity;
+
+    return (u32)(u64Enqueue - u64Dequeue);
+}
+
+u32 jf_ringqueue_getCapacity(jf_ringqueue_t * pQueue)
+{
+    internal_jf_ringqueue_t * pijr = (internal_jf_ringqueue_t *)pQueue;
+
+    assert(pQueue != NULL);
+
+    return pijr->ijr_u32Capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
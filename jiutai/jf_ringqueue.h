@@ -0,0 +1,160 @@
+/**
+ *  @file jf_ringqueue.h
+ *
+ *  @brief Header file which defines the bounded ring queue.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_ringqueue object.
+ *  -# The ring queue is a bounded, lock-free queue. The capacity is rounded up to power of 2, the
+ *   slots are allocated when the queue is created, no memory is allocated for enqueue.
+ *  -# Multiple producers can enqueue concurrently. The queue supports single consumer or multiple
+ *   consumers, the dequeue of single consumer queue is cheaper but only one thread can dequeue.
+ *  -# The item is first in, first out. The item is a pointer, NULL can be enqueued.
+ *  -# The blocking dequeue routine parks the consumer on a futex (WaitOnAddress on Windows) only
+ *   when the queue is empty, the producer wakes up the consumer only when someone is waiting.
+ *  -# Link with jf_jiukun library for memory allocation.
+ */
+
+#ifndef JIUTAI_RINGQUEUE_H
+#define JIUTAI_RINGQUEUE_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Define the ring queue data type.
+ */
+typedef void  jf_ringqueue_t;
+
+/** Maximum capacity of the ring queue.
+ */
+#define JF_RINGQUEUE_MAX_CAPACITY        (1 << 20)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the parameter data type for creating ring queue.
+ */
+typedef struct
+{
+    /**Number of items the queue can hold, it's rounded up to power of 2.*/
+    u32 jrcp_u32Capacity;
+    /**Only one thread dequeues if it's TRUE.*/
+    boolean_t jrcp_bSingleConsumer;
+    u8 jrcp_u8Reserved[3];
+    u32 jrcp_u32Reserved[6];
+} jf_ringqueue_create_param_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Create the ring queue.
+ *
+ *  @param ppQueue [out] The ring queue to be created and returned.
+ *  @param pjrcp [in] The parameter for creating the queue.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM Invalid capacity.
+ */
+u32 jf_ringqueue_create(jf_ringqueue_t ** ppQueue, jf_ringqueue_create_param_t * pjrcp);
+
+/** Destroy the ring queue.
+ *
+ *  @note
+ *  -# The items in queue are not freed.
+ *  -# No thread should access or wait on the queue when it's destroyed.
+ *
+ *  @param ppQueue [in/out] The ring queue to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_ringqueue_destroy(jf_ringqueue_t ** ppQueue);
+
+/** Enqueue an item, the consumer waiting for item is woken up.
+ *
+ *  @param pQueue [in] The ring queue.
+ *  @param pData [in] The item to be enqueued.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_QUEUE_FULL The queue is full.
+ */
+u32 jf_ringqueue_enqueue(jf_ringqueue_t * pQueue, void * pData);
+
+/** Dequeue an item, the routine returns immediately if the queue is empty.
+ *
+ *  @param pQueue [in] The ring queue.
+ *  @param ppData [out] The item dequeued.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_QUEUE_EMPTY The queue is empty.
+ */
+u32 jf_ringqueue_dequeue(jf_ringqueue_t * pQueue, void ** ppData);
+
+/** Dequeue an item, the routine blocks until an item is available.
+ *
+ *  @note
+ *  -# The routine returns JF_ERR_QUEUE_EMPTY if the consumer is woken up by
+ *   jf_ringqueue_wakeupAll() and the queue is empty.
+ *
+ *  @param pQueue [in] The ring queue.
+ *  @param ppData [out] The item dequeued.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_QUEUE_EMPTY The consumer is woken up and the queue is empty.
+ */
+u32 jf_ringqueue_dequeueWait(jf_ringqueue_t * pQueue, void ** ppData);
+
+/** Dequeue an item, the routine blocks until an item is available or timeout.
+ *
+ *  @param pQueue [in] The ring queue.
+ *  @param ppData [out] The item dequeued.
+ *  @param u32Timeout [in] The maximum waiting period in milliseconds.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_TIMEOUT Timeout.
+ *  @retval JF_ERR_QUEUE_EMPTY The consumer is woken up and the queue is empty.
+ */
+u32 jf_ringqueue_dequeueWaitWithTimeout(jf_ringqueue_t * pQueue, void ** ppData, u32 u32Timeout);
+
+/** Wake up all consumers waiting for item, it's usually used to stop the consumers.
+ *
+ *  @param pQueue [in] The ring queue.
+ *
+ *  @return Void.
+ */
+void jf_ringqueue_wakeupAll(jf_ringqueue_t * pQueue);
+
+/** Get the number of items in the queue.
+ *
+ *  @note
+ *  -# The number is approximate if the queue is being accessed by other threads.
+ *
+ *  @param pQueue [in] The ring queue.
+ *
+ *  @return The number of items.
+ */
+u32 jf_ringqueue_getSize(jf_ringqueue_t * pQueue);
+
+/** Get the capacity of the queue.
+ *
+ *  @param pQueue [in] The ring queue.
+ *
+ *  @return The capacity.
+ */
+u32 jf_ringqueue_getCapacity(jf_ringqueue_t * pQueue);
+
+#endif /*JIUTAI_RINGQUEUE_H*/
+
+/*------------------------------------------------------------------------------------------------*/
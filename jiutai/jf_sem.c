@@ -6,16 +6,26 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# On Linux, the intra-process semaphore is an atomic counter. Down decreases the counter with
+ *   CAS if it's not 0, otherwise the thread registers as waiter and waits on the counter with
+ *   futex.
+ *   Up increases the counter and wakes up one thread only if there is waiter.
+ *  -# The timed wait uses FUTEX_WAIT_BITSET with absolute deadline of monotonic clock, so the
+ *   deadline is not extended by spurious wakeup and not affected by the change of wall clock.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
 #include <string.h>
 #if defined(LINUX)
+    #include <errno.h>
+    #include <time.h>
+    #include <unistd.h>
     #include <sys/types.h>
     #include <sys/ipc.h>
     #include <sys/sem.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
 #endif
 
 /* --- internal header files -------------------------------------------------------------------- */
@@ -24,6 +34,7 @@
 #include "jf_sem.h"
 #include "jf_err.h"
 #include "jf_time.h"
+#include "jf_atomic.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -45,12 +56,125 @@ union semun
 
 /* --- private routine section ------------------------------------------------------------------ */
 
+#if defined(LINUX)
+
+/** Try to decrease the count of the futex semaphore.
+ *
+ *  @return The status.
+ *  @retval TRUE The count is decreased.
+ *  @retval FALSE The count is 0.
+ */
+static inline boolean_t _tryDownFutexSem(jf_sem_t * pSem)
+{
+    u32 u32Count = jf_atomic_loadU32(&pSem->js_u32Count);
+
+    while (u32Count != 0)
+    {
+        if (jf_atomic_casU32(&pSem->js_u32Count, u32Count, u32Count - 1))
+            return TRUE;
+
+        u32Count = jf_atomic_loadU32(&pSem->js_u32Count);
+    }
+
+    return FALSE;
+}
+
+/** Down the futex semaphore.
+ *
+ *  @param pSem [in] The semaphore.
+ *  @param ptsDeadline [in] The absolute deadline of monotonic clock, NULL for infinite waiting.
+ *
+ *  @return The error code.
+ */
+static u32 _downFutexSem(jf_sem_t * pSem, struct timespec * ptsDeadline)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    long lRet = 0;
+
+    /*Fast path, no system call.*/
+    if (_tryDownFutexSem(pSem))
+        return u32Ret;
+
+    /*Register as waiter before checking the count again, up wakes up thread only if it sees
+      waiter.*/
+    jf_atomic_fetchAddU32(&pSem->js_u32NumOfWaiter, 1);
+
+    while (! _tryDownFutexSem(pSem))
+    {
+        /*The kernel checks the count is still 0 before sleeping.*/
+        lRet = syscall(
+            SYS_futex, &pSem->js_u32Count, FUTEX_WAIT_BITSET_PRIVATE, 0, ptsDeadline, NULL,
+            FUTEX_BITSET_MATCH_ANY);
+        if (lRet == -1)
+        {
+            if (errno == ETIMEDOUT)
+            {
+                if (! _tryDownFutexSem(pSem))
+                    u32Ret = JF_ERR_TIMEOUT;
+                break;
+            }
+            else if ((errno != EAGAIN) && (errno != EINTR))
+            {
+                u32Ret = JF_ERR_FAIL_DOWN_SEM;
+                break;
+            }
+        }
+    }
+
+    jf_atomic_fetchAddU32(&pSem->js_u32NumOfWaiter, (u32)-1);
+
+    return u32Ret;
+}
+
+/** Up the futex semaphore.
+ */
+static u32 _upFutexSem(jf_sem_t * pSem)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Count;
+
+    do
+    {
+        u32Count = jf_atomic_loadU32(&pSem->js_u32Count);
+        /*The count saturates at the maximum count, up doesn't fail like the SysV semaphore.*/
+        if (u32Count >= pSem->js_u32MaxCount)
+            return u32Ret;
+    } while (! jf_atomic_casU32(&pSem->js_u32Count, u32Count, u32Count + 1));
+
+    /*Wake up one waiter, no system call if nobody is waiting.*/
+    if (jf_atomic_loadU32(&pSem->js_u32NumOfWaiter) != 0)
+        syscall(SYS_futex, &pSem->js_u32Count, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+
+    return u32Ret;
+}
+
+#endif
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 u32 jf_sem_init(jf_sem_t * pSem, u32 u32InitialCount, u32 u32MaxCount)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
 
+#if defined(LINUX)
+    assert(pSem != NULL);
+    assert(u32InitialCount <= u32MaxCount);
+
+    memset(pSem, 0, sizeof(jf_sem_t));
+
+    pSem->js_u32Count = u32InitialCount;
+    pSem->js_u32MaxCount = u32MaxCount;
+#elif defined(WINDOWS)
+    u32Ret = jf_sem_initShared(pSem, u32InitialCount, u32MaxCount);
+#endif
+
+    return u32Ret;
+}
+
+u32 jf_sem_initShared(jf_sem_t * pSem, u32 u32InitialCount, u32 u32MaxCount)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
 #if defined(WINDOWS)
     assert(pSem != NULL);
     assert(u32InitialCount <= u32MaxCount);
@@ -70,6 +194,8 @@ u32 jf_sem_init(jf_sem_t * pSem, u32 u32InitialCount, u32 u32MaxCount)
     assert(u32InitialCount <= u32MaxCount);
 
     memset(pSem, 0, sizeof(jf_sem_t));
+    pSem->js_bShared = TRUE;
+    pSem->js_u32MaxCount = u32MaxCount;
 
     /* create 1 semaphore */
     pSem->js_nSem = semget(IPC_PRIVATE, 1, SEM_FLAG);
@@ -114,7 +240,7 @@ u32 jf_sem_fini(jf_sem_t * pSem)
 
     assert(pSem != NULL);
 
-    if ((pSem->js_nSem != 0) && (pSem->js_nSem != -1))
+    if (pSem->js_bShared && (pSem->js_nSem != -1))
     {
         nRet = semctl(pSem->js_nSem, 0, IPC_RMID);
         if (nRet == -1)
@@ -151,6 +277,9 @@ u32 jf_sem_down(jf_sem_t * pSem)
 
     assert(pSem != NULL);
 
+    if (! pSem->js_bShared)
+        return _downFutexSem(pSem, NULL);
+
     semlock.sem_num = 0;
     semlock.sem_op = -1;
     semlock.sem_flg = SEM_UNDO;
@@ -188,6 +317,9 @@ u32 jf_sem_tryDown(jf_sem_t * pSem)
 
     assert(pSem != NULL);
 
+    if (! pSem->js_bShared)
+        return _tryDownFutexSem(pSem) ? JF_ERR_NO_ERROR : JF_ERR_FAIL_DOWN_SEM;
+
     semlock.sem_num = 0;
     semlock.sem_op = -1;
     semlock.sem_flg = SEM_UNDO | IPC_NOWAIT;
@@ -228,6 +360,21 @@ u32 jf_sem_downWithTimeout(jf_sem_t * pSem, u32 u32Timeout)
 
     memset(&timeout, 0, sizeof(struct timespec));
 
+    if (! pSem->js_bShared)
+    {
+        /*The deadline is absolute time of monotonic clock.*/
+        clock_gettime(CLOCK_MONOTONIC, &timeout);
+        timeout.tv_sec += u32Timeout / 1000;
+        timeout.tv_nsec += (u32Timeout % 1000) * 1000000;
+        if (timeout.tv_nsec >= 1000000000)
+        {
+            timeout.tv_sec ++;
+            timeout.tv_nsec -= 1000000000;
+        }
+
+        return _downFutexSem(pSem, &timeout);
+    }
+
     timeout.tv_sec = u32Timeout / 1000;
     timeout.tv_nsec = (u32Timeout % 1000) * 1000000;
 
@@ -264,6 +411,9 @@ u32 jf_sem_up(jf_sem_t * pSem)
 
     assert(pSem != NULL);
 
+    if (! pSem->js_bShared)
+        return _upFutexSem(pSem);
+
     semunlock.sem_num = 0;
     semunlock.sem_op = 1;
     semunlock.sem_flg = SEM_UNDO;
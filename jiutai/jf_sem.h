@@ -7,7 +7,13 @@
  *
  *  @note
  *  -# Routines declared in this file are included in jf_sem object.
- *
+ *  -# On Linux, the semaphore initialized by jf_sem_init() can only be used by threads in the same
+ *   process. It's an atomic counter with futex, down and up don't enter kernel if no thread has to
+ *   wait. The timeout is measured with monotonic clock.
+ *  -# The semaphore initialized by jf_sem_initShared() can be used by different processes, it's
+ *   SysV semaphore on Linux.
+ *  -# The count of intra-process semaphore never exceeds the maximum count, up succeeds without
+ *   changing the count if the count reaches the maximum count.
  */
 
 #ifndef JIUTAI_SEM_H
@@ -27,7 +33,17 @@
 typedef struct
 {
 #if defined(LINUX)
+    /**The count of the semaphore, it's the futex word.*/
+    u32 js_u32Count;
+    /**Number of threads waiting on the futex.*/
+    u32 js_u32NumOfWaiter;
+    /**The maximum count of the semaphore.*/
+    u32 js_u32MaxCount;
+    /**The SysV semaphore ID if the semaphore is shared by processes.*/
     olint_t js_nSem;
+    /**The semaphore is shared by processes if it's TRUE.*/
+    boolean_t js_bShared;
+    u8 js_u8Reserved[7];
 #elif defined(WINDOWS)
     HANDLE js_hSem;
 #endif
@@ -47,6 +63,22 @@ typedef struct
  */
 u32 jf_sem_init(jf_sem_t * pSem, u32 u32InitialCount, u32 u32MaxCount);
 
+/** Initialize a semaphore which can be shared by processes.
+ *
+ *  @note
+ *  -# The semaphore is slower than the one initialized by jf_sem_init(), use it only if the
+ *   semaphore is used by different processes.
+ *
+ *  @param pSem [in] The semaphore to be initiablized.
+ *  @param u32InitialCount [in] The initial value of the semaphore.
+ *  @param u32MaxCount [in] The maximum value of the semaphore.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_CREATE_SEM Failed to create semaphore.
+ */
+u32 jf_sem_initShared(jf_sem_t * pSem, u32 u32InitialCount, u32 u32MaxCount);
+
 /** Finalize a semaphore.
  *
  *  @param pSem [in] The semaphore to be finilized
@@ -89,6 +121,7 @@ u32 jf_sem_tryDown(jf_sem_t * pSem);
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_TIMEOUT The semaphore is still 0 when the timeout expires.
  *  @retval JF_ERR_FAIL_DOWN_SEM Failed to down a semaphore.
  */
 u32 jf_sem_downWithTimeout(jf_sem_t * pSem, u32 u32Timeout);
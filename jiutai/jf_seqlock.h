@@ -0,0 +1,134 @@
+/**
+ *  @file jf_seqlock.h
+ *
+ *  @brief Header file which defines the sequence lock.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The routines are inline functions, no object file is needed.
+ *  -# The sequence lock is for small data which is read frequently and written rarely, eg, cached
+ *   settings and statistics. The reader doesn't write anything shared, it copies the data and
+ *   retries if a writer changed the data during the copy.
+ *  -# The writer increases the sequence before and after the change, the sequence is odd when the
+ *   writer is changing the data.
+ *  -# The data protected must not contain pointer which is dereferenced by the reader, the reader
+ *   may see inconsistent data before the retry check.
+ *  -# Writers are serialized by a spin lock, the write side critical section should be short.
+ *
+ *  @code
+ *  u32 u32Seq;
+ *
+ *  do
+ *  {
+ *      u32Seq = jf_seqlock_beginRead(&lock);
+ *      ol_memcpy(&copy, &data, sizeof(data));
+ *  } while (jf_seqlock_retryRead(&lock, u32Seq));
+ *  @endcode
+ */
+
+#ifndef JIUTAI_SEQLOCK_H
+#define JIUTAI_SEQLOCK_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_atomic.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the sequence lock data type.
+ */
+typedef struct
+{
+    /**The sequence, it's odd if a writer is changing the data.*/
+    u32 js_u32Sequence;
+    /**The spin lock for writers.*/
+    u32 js_u32Lock;
+} jf_seqlock_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Initialize the sequence lock.
+ *
+ *  @param pLock [in] The lock to be initialized.
+ *
+ *  @return Void.
+ */
+static inline void jf_seqlock_init(jf_seqlock_t * pLock)
+{
+    pLock->js_u32Sequence = 0;
+    pLock->js_u32Lock = 0;
+}
+
+/** Begin to read the data, wait if a writer is changing the data.
+ *
+ *  @param pLock [in] The lock.
+ *
+ *  @return The sequence which should be passed to jf_seqlock_retryRead().
+ */
+static inline u32 jf_seqlock_beginRead(jf_seqlock_t * pLock)
+{
+    u32 u32Seq;
+
+    while ((u32Seq = jf_atomic_loadU32(&pLock->js_u32Sequence)) & 1)
+        jf_atomic_cpuRelax();
+
+    return u32Seq;
+}
+
+/** Check if the data read is consistent.
+ *
+ *  @param pLock [in] The lock.
+ *  @param u32Seq [in] The sequence returned by jf_seqlock_beginRead().
+ *
+ *  @return The status.
+ *  @retval TRUE The data is changed by writer, read it again.
+ *  @retval FALSE The data read is consistent.
+ */
+static inline boolean_t jf_seqlock_retryRead(jf_seqlock_t * pLock, u32 u32Seq)
+{
+    /*Make sure the data is read before the sequence.*/
+    jf_atomic_acquireFence();
+
+    return (jf_atomic_loadU32(&pLock->js_u32Sequence) != u32Seq);
+}
+
+/** Acquire the write lock, the sequence becomes odd.
+ *
+ *  @param pLock [in] The lock.
+ *
+ *  @return Void.
+ */
+static inline void jf_seqlock_acquireWritelock(jf_seqlock_t * pLock)
+{
+    while (! jf_atomic_casU32(&pLock->js_u32Lock, 0, 1))
+    {
+        while (jf_atomic_loadU32(&pLock->js_u32Lock) != 0)
+            jf_atomic_cpuRelax();
+    }
+
+    jf_atomic_fetchAddU32(&pLock->js_u32Sequence, 1);
+    /*Make sure the sequence is changed before the data.*/
+    jf_atomic_fence();
+}
+
+/** Release the write lock, the sequence becomes even.
+ *
+ *  @param pLock [in] The lock.
+ *
+ *  @return Void.
+ */
+static inline void jf_seqlock_releaseWritelock(jf_seqlock_t * pLock)
+{
+    jf_atomic_fetchAddU32(&pLock->js_u32Sequence, 1);
+    jf_atomic_storeU32(&pLock->js_u32Lock, 0);
+}
+
+#endif /*JIUTAI_SEQLOCK_H*/
+
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,417 @@
+/**
+ *  @file jf_shmring.c
+ *
+ *  @brief Implementation file for ring buffer in shared memory.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The write position and read position are 64-bit byte offsets which never wrap around in
+ *   practice, the offset in data area is the position masked by the capacity.
+ *  -# Each record starts with 32-bit length and is padded to 8 bytes. If the record doesn't fit in
+ *   the end of data area, a wrap marker is written and the record starts from the beginning.
+ *  -# The producer publishes the record by storing the write position with release semantic, the
+ *   consumer frees the space by storing the read position with release semantic.
+ *  -# The waiter registers itself and reads the futex word before checking the ring again, the
+ *   other side changes the futex word and wakes up the waiter only if it's registered.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(LINUX)
+    #include <time.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+#include "jf_shmring.h"
+#include "jf_atomic.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** The magic number of initialized ring.
+ */
+#define SHMRING_MAGIC                      (0x53524E47)
+
+/** The length in record header indicating the rest of data area is skipped.
+ */
+#define SHMRING_WRAP_MARKER                (U32_MAX)
+
+/** Size of the record header.
+ */
+#define SHMRING_RECORD_HEADER_SIZE         (sizeof(u32))
+
+/** Records are aligned to 8 bytes.
+ */
+#define SHMRING_RECORD_ALIGN               (8)
+
+/** Get the space occupied by the record with the length.
+ */
+#define SHMRING_RECORD_SIZE(len)           \
+    (((len) + SHMRING_RECORD_HEADER_SIZE + SHMRING_RECORD_ALIGN - 1) &  \
+     ~(SHMRING_RECORD_ALIGN - 1))
+
+/** Define the header of the ring, it's at the beginning of the memory.
+ */
+typedef struct
+{
+    /**The magic number, it's set after the ring is initialized.*/
+    u32 sh_u32Magic;
+    /**Size of the data area, power of 2.*/
+    u32 sh_u32Capacity;
+    /**Maximum length of record.*/
+    u32 sh_u32MaxRecordLen;
+    u8 sh_u8Pad[JF_ATOMIC_CACHE_LINE_SIZE - 3 * sizeof(u32)];
+
+    /**Position of next write, it's modified by producer.*/
+    u64 sh_u64WritePos;
+    /**The futex word for consumer, it's increased when a record is written.*/
+    u32 sh_u32DataSignal;
+    /**The consumer is waiting for record.*/
+    u32 sh_u32ConsumerWaiting;
+    u8 sh_u8Pad2[JF_ATOMIC_CACHE_LINE_SIZE - sizeof(u64) - 2 * sizeof(u32)];
+
+    /**Position of next read, it's modified by consumer.*/
+    u64 sh_u64ReadPos;
+    /**The futex word for producer, it's increased when a record is read.*/
+    u32 sh_u32SpaceSignal;
+    /**The producer is waiting for space.*/
+    u32 sh_u32ProducerWaiting;
+    u8 sh_u8Pad3[JF_ATOMIC_CACHE_LINE_SIZE - sizeof(u64) - 2 * sizeof(u32)];
+} shmring_header_t;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static inline u8 * _getShmringData(shmring_header_t * psh)
+{
+    return (u8 *)psh + JF_SHMRING_HEADER_SIZE;
+}
+
+/** Get the current time in milliseconds from a monotonic clock.
+ */
+static u64 _getShmringTime(void)
+{
+#if defined(LINUX)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (u64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#elif defined(WINDOWS)
+    return GetTickCount64();
+#endif
+}
+
+/** Wait on the futex word if its value is still the expected value.
+ *
+ *  @note
+ *  -# The futex is not private as the ring may be shared by processes.
+ */
+static void _waitShmringSignal(u32 * pu32Addr, u32 u32Value, u32 u32Timeout)
+{
+#if defined(LINUX)
+    struct timespec ts, * pts = NULL;
+
+    if (u32Timeout != JF_SHMRING_WAIT_FOREVER)
+    {
+        ts.tv_sec = u32Timeout / 1000;
+        ts.tv_nsec = (u32Timeout % 1000) * 1000000;
+        pts = &ts;
+    }
+
+    syscall(SYS_futex, pu32Addr, FUTEX_WAIT, u32Value, pts, NULL, 0);
+#elif defined(WINDOWS)
+    /*WaitOnAddress() doesn't work across processes, poll the ring.*/
+    Sleep(1);
+#endif
+}
+
+static void _wakeShmringSignal(u32 * pu32Addr)
+{
+#if defined(LINUX)
+    syscall(SYS_futex, pu32Addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+/** Compute the remaining time to deadline.
+ *
+ *  @return TRUE if the deadline is not reached.
+ */
+static boolean_t _getShmringRemainTime(u64 u64Deadline, u32 u32Timeout, u32 * pu32Remain)
+{
+    u64 u64Now = 0;
+
+    if (u32Timeout == JF_SHMRING_WAIT_FOREVER)
+    {
+        *pu32Remain = JF_SHMRING_WAIT_FOREVER;
+        return TRUE;
+    }
+
+    u64Now = _getShmringTime();
+    if (u64Now >= u64Deadline)
+        return FALSE;
+
+    *pu32Remain = (u32)(u64Deadline - u64Now);
+
+    return TRUE;
+}
+
+/** Notify the other side if it's waiting.
+ */
+static inline void _notifyShmring(u32 * pu32Waiting, u32 * pu32Signal)
+{
+    jf_atomic_fence();
+    if (jf_atomic_loadU32(pu32Waiting) != 0)
+    {
+        jf_atomic_fetchAddU32(pu32Signal, 1);
+        _wakeShmringSignal(pu32Signal);
+    }
+}
+
+static u32 _writeShmring(shmring_header_t * psh, const void * pData, u32 u32Len)
+{
+    u8 * pu8Data = _getShmringData(psh);
+    u64 u64Write = psh->sh_u64WritePos;
+    u64 u64Read = jf_atomic_loadU64(&psh->sh_u64ReadPos);
+    u32 u32Offset = (u32)(u64Write & (psh->sh_u32Capacity - 1));
+    u32 u32Contig = psh->sh_u32Capacity - u32Offset;
+    u32 u32Size = SHMRING_RECORD_SIZE(u32Len), u32Total = u32Size;
+
+    /*Skip the end of data area if the record doesn't fit.*/
+    if (u32Contig < u32Size)
+        u32Total += u32Contig;
+
+    if ((u64)psh->sh_u32Capacity - (u64Write - u64Read) < u32Total)
+        return JF_ERR_BUFFER_IS_FULL;
+
+    if (u32Contig < u32Size)
+    {
+        *(u32 *)(pu8Data + u32Offset) = SHMRING_WRAP_MARKER;
+        u64Write += u32Contig;
+        u32Offset = 0;
+    }
+
+    *(u32 *)(pu8Data + u32Offset) = u32Len;
+    if (u32Len > 0)
+        ol_memcpy(pu8Data + u32Offset + SHMRING_RECORD_HEADER_SIZE, pData, u32Len);
+
+    /*Publish the record.*/
+    jf_atomic_storeU64(&psh->sh_u64WritePos, u64Write + u32Size);
+
+    _notifyShmring(&psh->sh_u32ConsumerWaiting, &psh->sh_u32DataSignal);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _readShmring(shmring_header_t * psh, void * pBuf, u32 * pu32Len)
+{
+    u8 * pu8Data = _getShmringData(psh);
+    u64 u64Read = psh->sh_u64ReadPos;
+    u64 u64Write = jf_atomic_loadU64(&psh->sh_u64WritePos);
+    u32 u32Offset = (u32)(u64Read & (psh->sh_u32Capacity - 1));
+    u32 u32Len = 0;
+
+    if (u64Read == u64Write)
+        return JF_ERR_QUEUE_EMPTY;
+
+    u32Len = *(u32 *)(pu8Data + u32Offset);
+    if (u32Len == SHMRING_WRAP_MARKER)
+    {
+        /*The record is at the beginning of data area.*/
+        u64Read += psh->sh_u32Capacity - u32Offset;
+        u32Offset = 0;
+        u32Len = *(u32 *)pu8Data;
+    }
+
+    if (u32Len > *pu32Len)
+    {
+        *pu32Len = u32Len;
+        return JF_ERR_BUFFER_TOO_SMALL;
+    }
+
+    if (u32Len > 0)
+        ol_memcpy(pBuf, pu8Data + u32Offset + SHMRING_RECORD_HEADER_SIZE, u32Len);
+    *pu32Len = u32Len;
+
+    /*Free the space.*/
+    jf_atomic_storeU64(&psh->sh_u64ReadPos, u64Read + SHMRING_RECORD_SIZE(u32Len));
+
+    _notifyShmring(&psh->sh_u32ProducerWaiting, &psh->sh_u32SpaceSignal);
+
+    return JF_ERR_NO_ERROR;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_shmring_getMemorySize(u32 u32Capacity)
+{
+    u32 u32Size = JF_SHMRING_MIN_CAPACITY;
+
+    while ((u32Size < u32Capacity) && (u32Size < JF_SHMRING_MAX_CAPACITY))
+        u32Size <<= 1;
+
+    return JF_SHMRING_HEADER_SIZE + u32Size;
+}
+
+u32 jf_shmring_init(void * pMemory, u32 u32MemorySize, jf_shmring_t ** ppRing)
+{
+    shmring_header_t * psh = (shmring_header_t *)pMemory;
+    u32 u32Capacity = JF_SHMRING_MIN_CAPACITY;
+
+    assert((pMemory != NULL) && (ppRing != NULL));
+    assert(sizeof(shmring_header_t) <= JF_SHMRING_HEADER_SIZE);
+
+    if (u32MemorySize < JF_SHMRING_HEADER_SIZE + JF_SHMRING_MIN_CAPACITY)
+        return JF_ERR_INVALID_PARAM;
+
+    /*The largest power of 2 which fits in the memory.*/
+    while ((u32Capacity < JF_SHMRING_MAX_CAPACITY) &&
+           ((u64)u32Capacity * 2 <= u32MemorySize - JF_SHMRING_HEADER_SIZE))
+        u32Capacity <<= 1;
+
+    ol_bzero(psh, JF_SHMRING_HEADER_SIZE);
+    psh->sh_u32Capacity = u32Capacity;
+    /*The record takes at most half of the data area, so it always fits after wrap around.*/
+    psh->sh_u32MaxRecordLen = u32Capacity / 2 - SHMRING_RECORD_ALIGN;
+
+    jf_atomic_storeU32(&psh->sh_u32Magic, SHMRING_MAGIC);
+
+    *ppRing = psh;
+
+    return JF_ERR_NO_ERROR;
+}
+
+u32 jf_shmring_attach(void * pMemory, jf_shmring_t ** ppRing)
+{
+    shmring_header_t * psh = (shmring_header_t *)pMemory;
+
+    assert((pMemory != NULL) && (ppRing != NULL));
+
+    if (jf_atomic_loadU32(&psh->sh_u32Magic) != SHMRING_MAGIC)
+        return JF_ERR_NOT_INITIALIZED;
+
+    *ppRing = psh;
+
+    return JF_ERR_NO_ERROR;
+}
+
+u32 jf_shmring_getMaxRecordLen(jf_shmring_t * pRing)
+{
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+
+    assert(pRing != NULL);
+
+    return psh->sh_u32MaxRecordLen;
+}
+
+u32 jf_shmring_getSize(jf_shmring_t * pRing)
+{
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+    u64 u64Read = 0, u64Write = 0;
+
+    assert(pRing != NULL);
+
+    u64Read = jf_atomic_loadU64(&psh->sh_u64ReadPos);
+    u64Write = jf_atomic_loadU64(&psh->sh_u64WritePos);
+
+    return (u32)(u64Write - u64Read);
+}
+
+u32 jf_shmring_write(jf_shmring_t * pRing, const void * pData, u32 u32Len)
+{
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+
+    assert(pRing != NULL);
+
+    if (u32Len > psh->sh_u32MaxRecordLen)
+        return JF_ERR_INVALID_PARAM;
+
+    return _writeShmring(psh, pData, u32Len);
+}
+
+u32 jf_shmring_writeWait(jf_shmring_t * pRing, const void * pData, u32 u32Len, u32 u32Timeout)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+    u64 u64Deadline = _getShmringTime() + u32Timeout;
+    u32 u32Signal = 0, u32Remain = 0;
+
+    assert(pRing != NULL);
+
+    if (u32Len > psh->sh_u32MaxRecordLen)
+        return JF_ERR_INVALID_PARAM;
+
+    while ((u32Ret = _writeShmring(psh, pData, u32Len)) == JF_ERR_BUFFER_IS_FULL)
+    {
+        if (! _getShmringRemainTime(u64Deadline, u32Timeout, &u32Remain))
+        {
+            u32Ret = JF_ERR_TIMEOUT;
+            break;
+        }
+
+        jf_atomic_storeU32(&psh->sh_u32ProducerWaiting, 1);
+        u32Signal = jf_atomic_loadU32(&psh->sh_u32SpaceSignal);
+        jf_atomic_fence();
+
+        u32Ret = _writeShmring(psh, pData, u32Len);
+        if (u32Ret == JF_ERR_BUFFER_IS_FULL)
+            _waitShmringSignal(&psh->sh_u32SpaceSignal, u32Signal, u32Remain);
+
+        jf_atomic_storeU32(&psh->sh_u32ProducerWaiting, 0);
+
+        if (u32Ret != JF_ERR_BUFFER_IS_FULL)
+            break;
+    }
+
+    return u32Ret;
+}
+
+u32 jf_shmring_read(jf_shmring_t * pRing, void * pBuf, u32 * pu32Len)
+{
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+
+    assert((pRing != NULL) && (pu32Len != NULL));
+
+    return _readShmring(psh, pBuf, pu32Len);
+}
+
+u32 jf_shmring_readWait(jf_shmring_t * pRing, void * pBuf, u32 * pu32Len, u32 u32Timeout)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    shmring_header_t * psh = (shmring_header_t *)pRing;
+    u64 u64Deadline = _getShmringTime() + u32Timeout;
+    u32 u32Signal = 0, u32Remain = 0;
+
+    assert((pRing != NULL) && (pu32Len != NULL));
+
+    while ((u32Ret = _readShmring(psh, pBuf, pu32Len)) == JF_ERR_QUEUE_EMPTY)
+    {
+        if (! _getShmringRemainTime(u64Deadline, u32Timeout, &u32Remain))
+        {
+            u32Ret = JF_ERR_TIMEOUT;
+            break;
+        }
+
+        jf_atomic_storeU32(&psh->sh_u32ConsumerWaiting, 1);
+        u32Signal = jf_atomic_loadU32(&psh->sh_u32DataSignal);
+        jf_atomic_fence();
+
+        u32Ret = _readShmring(psh, pBuf, pu32Len);
+        if (u32Ret == JF_ERR_QUEUE_EMPTY)
+            _waitShmringSignal(&psh->sh_u32DataSignal, u32Signal, u32Remain);
+
+        jf_atomic_storeU32(&psh->sh_u32ConsumerWaiting, 0);
+
+        if (u32Ret != JF_ERR_QUEUE_EMPTY)
+            break;
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,169 @@
+/**
+ *  @file jf_shmring.h
+ *
+ *  @brief Header file which defines the ring buffer in shared memory.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_shmring object.
+ *  -# The ring is a single producer, single consumer record ring. The producer and consumer can be
+ *   in different processes, the ring is laid out in the memory provided by caller, usually a
+ *   shared memory segment from jf_sharedmemory.
+ *  -# A record is a block of data with length, the record is read as a whole in the same order as
+ *   it's written. The record can be empty.
+ *  -# The ring has no pointer inside, it can be mapped to different address in different process.
+ *  -# The write position and read position are in different cache lines. No lock is used.
+ *  -# The waiting routines park the thread on a process shared futex on Linux, they poll the ring
+ *   with sleep on other platforms.
+ */
+
+#ifndef JIUTAI_SHMRING_H
+#define JIUTAI_SHMRING_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Define the shared memory ring data type.
+ */
+typedef void  jf_shmring_t;
+
+/** Size of the ring header in front of the data area.
+ */
+#define JF_SHMRING_HEADER_SIZE             (256)
+
+/** Minimum size of the data area.
+ */
+#define JF_SHMRING_MIN_CAPACITY            (64)
+
+/** Maximum size of the data area.
+ */
+#define JF_SHMRING_MAX_CAPACITY            (1 << 30)
+
+/** Wait until the operation succeeds.
+ */
+#define JF_SHMRING_WAIT_FOREVER            (U32_MAX)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Get the memory size for the ring with the specified capacity.
+ *
+ *  @param u32Capacity [in] The size of data area, it's rounded up to power of 2.
+ *
+ *  @return The memory size including the ring header.
+ */
+u32 jf_shmring_getMemorySize(u32 u32Capacity);
+
+/** Initialize the ring in the memory, it's called by the creator of the shared memory before other
+ *  process attaches the ring.
+ *
+ *  @note
+ *  -# The data area is the largest power of 2 which fits in the memory.
+ *
+ *  @param pMemory [in] The memory, it should be aligned to cache line.
+ *  @param u32MemorySize [in] The size of the memory.
+ *  @param ppRing [out] The ring.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM The memory is too small or too large.
+ */
+u32 jf_shmring_init(void * pMemory, u32 u32MemorySize, jf_shmring_t ** ppRing);
+
+/** Attach the ring which is initialized by other process.
+ *
+ *  @param pMemory [in] The memory.
+ *  @param ppRing [out] The ring.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_NOT_INITIALIZED The ring is not initialized.
+ */
+u32 jf_shmring_attach(void * pMemory, jf_shmring_t ** ppRing);
+
+/** Get the maximum length of a record.
+ *
+ *  @param pRing [in] The ring.
+ *
+ *  @return The maximum length.
+ */
+u32 jf_shmring_getMaxRecordLen(jf_shmring_t * pRing);
+
+/** Get the number of bytes used in the ring, including the record header.
+ *
+ *  @param pRing [in] The ring.
+ *
+ *  @return The number of bytes.
+ */
+u32 jf_shmring_getSize(jf_shmring_t * pRing);
+
+/** Write a record, the consumer waiting for record is woken up.
+ *
+ *  @param pRing [in] The ring.
+ *  @param pData [in] The data of the record.
+ *  @param u32Len [in] The length of the record.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_BUFFER_IS_FULL No enough space in ring.
+ *  @retval JF_ERR_INVALID_PARAM The record is too long.
+ */
+u32 jf_shmring_write(jf_shmring_t * pRing, const void * pData, u32 u32Len);
+
+/** Write a record, wait if there is no enough space in ring.
+ *
+ *  @param pRing [in] The ring.
+ *  @param pData [in] The data of the record.
+ *  @param u32Len [in] The length of the record.
+ *  @param u32Timeout [in] The maximum waiting period in milliseconds, or JF_SHMRING_WAIT_FOREVER.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_TIMEOUT Timeout.
+ *  @retval JF_ERR_INVALID_PARAM The record is too long.
+ */
+u32 jf_shmring_writeWait(jf_shmring_t * pRing, const void * pData, u32 u32Len, u32 u32Timeout);
+
+/** Read a record, the producer waiting for space is woken up.
+ *
+ *  @param pRing [in] The ring.
+ *  @param pBuf [out] The buffer for the record.
+ *  @param pu32Len [in/out] The size of the buffer as in parameter, the length of the record as out
+ *   parameter.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_QUEUE_EMPTY The ring is empty.
+ *  @retval JF_ERR_BUFFER_TOO_SMALL The buffer is too small, the record is not read, the length
+ *   of the record is returned.
+ */
+u32 jf_shmring_read(jf_shmring_t * pRing, void * pBuf, u32 * pu32Len);
+
+/** Read a record, wait if the ring is empty.
+ *
+ *  @param pRing [in] The ring.
+ *  @param pBuf [out] The buffer for the record.
+ *  @param pu32Len [in/out] The size of the buffer as in parameter, the length of the record as out
+ *   parameter.
+ *  @param u32Timeout [in] The maximum waiting period in milliseconds, or JF_SHMRING_WAIT_FOREVER.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_TIMEOUT Timeout.
+ *  @retval JF_ERR_BUFFER_TOO_SMALL The buffer is too small.
+ */
+u32 jf_shmring_readWait(jf_shmring_t * pRing, void * pBuf, u32 * pu32Len, u32 u32Timeout);
+
+#endif /*JIUTAI_SHMRING_H*/
+
+/*------------------------------------------------------------------------------------------------*/
@@ -11,6 +11,15 @@
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#if defined(LINUX) && ! defined(_GNU_SOURCE)
+    /*The object is also built by libraries without _GNU_SOURCE, pthread_setaffinity_np() and
+      pthread_setname_np() require it.*/
+    #define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <ctype.h>
+
 #if defined(WINDOWS)
     #include <time.h>
     #include <process.h>
@@ -19,6 +28,7 @@
     #include <sys/stat.h>
     #include <fcntl.h>
     #include <sys/wait.h>
+    #include <sched.h>
 #endif
 
 /* --- internal header files -------------------------------------------------------------------- */
@@ -45,25 +55,206 @@ typedef struct
  */
 static signal_handler_arg ls_shaSignalArg;
 
+/** Define the argument of the routine setting name of the created thread.
+ */
+typedef struct
+{
+    /**The routine of the thread.*/
+    jf_thread_fnRoutine_t tna_fnRoutine;
+    /**The argument of the routine.*/
+    void * tna_pArg;
+    /**The name of the thread.*/
+    olchar_t tna_strName[JF_THREAD_MAX_NAME_LEN + 1];
+} thread_name_arg_t;
+
 #endif
 
 /* --- private routine section ------------------------------------------------------------------ */
 
 #if defined(LINUX)
 
+static u32 _setThreadSchedAttr(jf_thread_attr_t * pjta, pthread_attr_t * ppa)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nPolicy = SCHED_OTHER;
+    struct sched_param param;
+
+    ol_bzero(&param, sizeof(param));
+
+    switch (pjta->jta_u8SchedPolicy)
+    {
+    case JF_THREAD_SCHED_POLICY_OTHER:
+        nPolicy = SCHED_OTHER;
+        break;
+    case JF_THREAD_SCHED_POLICY_FIFO:
+        nPolicy = SCHED_FIFO;
+        param.sched_priority = (olint_t)pjta->jta_u32Priority;
+        break;
+    case JF_THREAD_SCHED_POLICY_RR:
+        nPolicy = SCHED_RR;
+        param.sched_priority = (olint_t)pjta->jta_u32Priority;
+        break;
+    case JF_THREAD_SCHED_POLICY_BATCH:
+        nPolicy = SCHED_BATCH;
+        break;
+    case JF_THREAD_SCHED_POLICY_IDLE:
+        nPolicy = SCHED_IDLE;
+        break;
+    default:
+        u32Ret = JF_ERR_INVALID_PARAM;
+        break;
+    }
+
+    /*The policy is ignored if the thread inherits it from the creating thread.*/
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (pthread_attr_setinheritsched(ppa, PTHREAD_EXPLICIT_SCHED) != 0))
+        u32Ret = JF_ERR_INVALID_PARAM;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pthread_attr_setschedpolicy(ppa, nPolicy) != 0))
+        u32Ret = JF_ERR_INVALID_PARAM;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pthread_attr_setschedparam(ppa, &param) != 0))
+        u32Ret = JF_ERR_INVALID_PARAM;
+
+    return u32Ret;
+}
+
+static void _getSystemCpuSet(const jf_thread_cpu_set_t * pjtcs, cpu_set_t * pcs)
+{
+    u32 u32Cpu = 0;
+
+    CPU_ZERO(pcs);
+
+    for (u32Cpu = 0; (u32Cpu < JF_THREAD_MAX_CPU) && (u32Cpu < CPU_SETSIZE); u32Cpu ++)
+    {
+        if (jf_thread_isCpuInCpuSet(pjtcs, u32Cpu))
+            CPU_SET(u32Cpu, pcs);
+    }
+}
+
 static u32 _setThreadAttr(jf_thread_attr_t * pjta, pthread_attr_t * ppa)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
+    cpu_set_t cs;
 
-    pthread_attr_init(ppa);
     if (pjta->jta_bDetached)
         pthread_attr_setdetachstate(ppa, PTHREAD_CREATE_DETACHED);
     else
         pthread_attr_setdetachstate(ppa, PTHREAD_CREATE_JOINABLE);
 
+    /*The stack size must not be less than PTHREAD_STACK_MIN.*/
+    if ((pjta->jta_sStack != 0) && (pthread_attr_setstacksize(ppa, pjta->jta_sStack) != 0))
+        u32Ret = JF_ERR_INVALID_PARAM;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (pjta->jta_u8SchedPolicy != JF_THREAD_SCHED_POLICY_DEFAULT))
+        u32Ret = _setThreadSchedAttr(pjta, ppa);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && pjta->jta_bAffinity)
+    {
+        _getSystemCpuSet(&pjta->jta_jtcsAffinity, &cs);
+        if (CPU_COUNT(&cs) == 0)
+            u32Ret = JF_ERR_INVALID_PARAM;
+        else if (pthread_attr_setaffinity_np(ppa, sizeof(cs), &cs) != 0)
+            u32Ret = JF_ERR_INVALID_PARAM;
+    }
+
     return u32Ret;
 }
 
+/** The routine of the thread with name, the name is set by the thread itself before the routine
+ *  is run.
+ *
+ *  @note
+ *  -# Setting the name from the creating thread is not safe as the detached thread may have exited.
+ */
+static JF_THREAD_RETURN_VALUE _threadNameRoutine(void * pArg)
+{
+    thread_name_arg_t tna;
+
+    ol_memcpy(&tna, pArg, sizeof(tna));
+    free(pArg);
+
+    pthread_setname_np(pthread_self(), tna.tna_strName);
+
+    return tna.tna_fnRoutine(tna.tna_pArg);
+}
+
+static u32 _newThreadNameArg(
+    const olchar_t * pstrName, jf_thread_fnRoutine_t fnRoutine, void * pArg,
+    thread_name_arg_t ** ppArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    thread_name_arg_t * ptna = NULL;
+
+    ptna = (thread_name_arg_t *)malloc(sizeof(*ptna));
+    if (ptna == NULL)
+        u32Ret = JF_ERR_FAIL_CREATE_THREAD;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ptna->tna_fnRoutine = fnRoutine;
+        ptna->tna_pArg = pArg;
+        ol_strncpy(ptna->tna_strName, pstrName, JF_THREAD_MAX_NAME_LEN);
+        ptna->tna_strName[JF_THREAD_MAX_NAME_LEN] = '\0';
+
+        *ppArg = ptna;
+    }
+
+    return u32Ret;
+}
+
+#elif defined(WINDOWS)
+
+static u32 _setThreadAttr(jf_thread_attr_t * pjta, HANDLE hThread)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nPriority = THREAD_PRIORITY_NORMAL;
+
+    if (pjta->jta_bAffinity)
+    {
+        /*Only the first 64 CPUs are supported as the affinity mask is a DWORD_PTR.*/
+        if (pjta->jta_jtcsAffinity.jtcs_u64Mask[0] == 0)
+            u32Ret = JF_ERR_INVALID_PARAM;
+        else if (SetThreadAffinityMask(
+                     hThread, (DWORD_PTR)pjta->jta_jtcsAffinity.jtcs_u64Mask[0]) == 0)
+            u32Ret = JF_ERR_INVALID_PARAM;
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (pjta->jta_u8SchedPolicy != JF_THREAD_SCHED_POLICY_DEFAULT))
+    {
+        switch (pjta->jta_u8SchedPolicy)
+        {
+        case JF_THREAD_SCHED_POLICY_OTHER:
+        case JF_THREAD_SCHED_POLICY_BATCH:
+            nPriority = THREAD_PRIORITY_NORMAL;
+            break;
+        case JF_THREAD_SCHED_POLICY_FIFO:
+            nPriority = THREAD_PRIORITY_TIME_CRITICAL;
+            break;
+        case JF_THREAD_SCHED_POLICY_RR:
+            nPriority = THREAD_PRIORITY_HIGHEST;
+            break;
+        case JF_THREAD_SCHED_POLICY_IDLE:
+            nPriority = THREAD_PRIORITY_IDLE;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        }
+
+        if ((u32Ret == JF_ERR_NO_ERROR) && (! SetThreadPriority(hThread, nPriority)))
+            u32Ret = JF_ERR_INVALID_PARAM;
+    }
+
+    return u32Ret;
+}
+
+#endif
+
+#if defined(LINUX)
+
 /** The thread to handle signal.
  *
  *  @note
@@ -96,6 +287,40 @@ JF_THREAD_RETURN_VALUE _signalHandlerThread(void * pArg)
 
 #endif
 
+/** Parse a CPU number and skip the spaces around it.
+ */
+static u32 _parseCpuNumber(const olchar_t ** ppstr, u32 * pu32Cpu)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    const olchar_t * pstr = *ppstr;
+    u32 u32Cpu = 0;
+
+    while (*pstr == ' ')
+        pstr ++;
+
+    if (! isdigit(*pstr))
+        u32Ret = JF_ERR_INVALID_STRING;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && isdigit(*pstr))
+    {
+        /*Stop accumulating to avoid overflow, the CPU is out of range anyway.*/
+        if (u32Cpu < JF_THREAD_MAX_CPU)
+            u32Cpu = u32Cpu * 10 + (u32)(*pstr - '0');
+        pstr ++;
+    }
+
+    while (*pstr == ' ')
+        pstr ++;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        *pu32Cpu = u32Cpu;
+        *ppstr = pstr;
+    }
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 void jf_thread_initId(jf_thread_id_t * pThreadId)
@@ -127,28 +352,69 @@ u32 jf_thread_create(
 #if defined(LINUX)
     pthread_attr_t attr;
     olint_t ret;
+    thread_name_arg_t * ptna = NULL;
 
     pthread_attr_init(&attr);
     if (pAttr != NULL)
         u32Ret = _setThreadAttr(pAttr, &attr);
 
+    /*The name is set by the created thread, the routine is run after that.*/
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pAttr != NULL) && (pAttr->jta_pstrName != NULL))
+        u32Ret = _newThreadNameArg(pAttr->jta_pstrName, fnRoutine, pArg, &ptna);
+
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        ret = pthread_create(&(jti.jti_ptThreadId), &attr, fnRoutine, pArg);
+        if (ptna != NULL)
+            ret = pthread_create(&(jti.jti_ptThreadId), &attr, _threadNameRoutine, ptna);
+        else
+            ret = pthread_create(&(jti.jti_ptThreadId), &attr, fnRoutine, pArg);
+
         if (ret != 0)
+        {
             u32Ret = JF_ERR_FAIL_CREATE_THREAD;
+            if (ptna != NULL)
+                free(ptna);
+        }
     }
 
+    pthread_attr_destroy(&attr);
+
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         if (pThreadId != NULL)
             ol_memcpy(pThreadId, &jti, sizeof(jf_thread_id_t));
     }
 #elif defined(WINDOWS)
-    jti.jti_hThread = CreateThread(NULL, 0, fnRoutine, pArg, 0, NULL);
+    olsize_t sStack = 0;
+    u32 u32Flags = 0;
+
+    if (pAttr != NULL)
+    {
+        /*Create the thread suspended so the attribute is applied before it runs.*/
+        sStack = pAttr->jta_sStack;
+        u32Flags = CREATE_SUSPENDED;
+        if (sStack != 0)
+            u32Flags |= STACK_SIZE_PARAM_IS_A_RESERVATION;
+    }
+
+    jti.jti_hThread = CreateThread(NULL, sStack, fnRoutine, pArg, u32Flags, NULL);
     if (jti.jti_hThread == NULL) 
         u32Ret = JF_ERR_FAIL_CREATE_THREAD;
 
+    if ((u32Ret == JF_ERR_NO_ERROR) && (pAttr != NULL))
+    {
+        u32Ret = _setThreadAttr(pAttr, jti.jti_hThread);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ResumeThread(jti.jti_hThread);
+        }
+        else
+        {
+            TerminateThread(jti.jti_hThread, 0);
+            CloseHandle(jti.jti_hThread);
+        }
+    }
+
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         if (pThreadId != NULL)
@@ -204,6 +470,111 @@ u32 jf_thread_waitForThreadTermination(jf_thread_id_t threadId, u32 * pu32RetCod
     return u32Ret;
 }
 
+void jf_thread_clearCpuSet(jf_thread_cpu_set_t * pjtcs)
+{
+    ol_bzero(pjtcs, sizeof(*pjtcs));
+}
+
+void jf_thread_addCpuToCpuSet(jf_thread_cpu_set_t * pjtcs, u32 u32Cpu)
+{
+    if (u32Cpu < JF_THREAD_MAX_CPU)
+        pjtcs->jtcs_u64Mask[u32Cpu / 64] |= ((u64)1 << (u32Cpu % 64));
+}
+
+boolean_t jf_thread_isCpuInCpuSet(const jf_thread_cpu_set_t * pjtcs, u32 u32Cpu)
+{
+    if (u32Cpu >= JF_THREAD_MAX_CPU)
+        return FALSE;
+
+    return ((pjtcs->jtcs_u64Mask[u32Cpu / 64] & ((u64)1 << (u32Cpu % 64))) != 0);
+}
+
+u32 jf_thread_getCpuSetFromString(const olchar_t * pstrCpuList, jf_thread_cpu_set_t * pjtcs)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    const olchar_t * pstr = pstrCpuList;
+    u32 u32First = 0, u32Last = 0;
+
+    jf_thread_clearCpuSet(pjtcs);
+
+    if (pstrCpuList == NULL)
+        return u32Ret;
+
+    /*The list is like "0~3, 8, 10~11", the trailing ',' is allowed.*/
+    while ((u32Ret == JF_ERR_NO_ERROR) && (*pstr != '\0'))
+    {
+        u32Ret = _parseCpuNumber(&pstr, &u32First);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            u32Last = u32First;
+            if (*pstr == '~')
+            {
+                pstr ++;
+                u32Ret = _parseCpuNumber(&pstr, &u32Last);
+            }
+        }
+
+        /*The range is invalid like '6~3'.*/
+        if ((u32Ret == JF_ERR_NO_ERROR) && (u32Last < u32First))
+            u32Ret = JF_ERR_INVALID_STRING;
+
+        if ((u32Ret == JF_ERR_NO_ERROR) && (u32Last >= JF_THREAD_MAX_CPU))
+            u32Ret = JF_ERR_INVALID_PARAM;
+
+        while ((u32Ret == JF_ERR_NO_ERROR) && (u32First <= u32Last))
+        {
+            jf_thread_addCpuToCpuSet(pjtcs, u32First);
+            u32First ++;
+        }
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            if (*pstr == ',')
+                pstr ++;
+            else if (*pstr != '\0')
+                u32Ret = JF_ERR_INVALID_STRING;
+        }
+    }
+
+    return u32Ret;
+}
+
+u32 jf_thread_setCurrentAffinity(const jf_thread_cpu_set_t * pjtcs)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+#if defined(LINUX)
+    cpu_set_t cs;
+
+    _getSystemCpuSet(pjtcs, &cs);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs) != 0)
+        u32Ret = JF_ERR_OPERATION_FAIL;
+#elif defined(WINDOWS)
+    if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)pjtcs->jtcs_u64Mask[0]) == 0)
+        u32Ret = JF_ERR_OPERATION_FAIL;
+#endif
+
+    return u32Ret;
+}
+
+u32 jf_thread_setCurrentName(const olchar_t * pstrName)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+#if defined(LINUX)
+    olchar_t strName[JF_THREAD_MAX_NAME_LEN + 1];
+
+    ol_strncpy(strName, pstrName, JF_THREAD_MAX_NAME_LEN);
+    strName[JF_THREAD_MAX_NAME_LEN] = '\0';
+
+    if (pthread_setname_np(pthread_self(), strName) != 0)
+        u32Ret = JF_ERR_OPERATION_FAIL;
+#elif defined(WINDOWS)
+    u32Ret = JF_ERR_NOT_SUPPORTED;
+#endif
+
+    return u32Ret;
+}
+
 u32 jf_thread_registerSignalHandlers(jf_thread_fnSignalHandler_t fnSignalHandler)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -37,15 +37,66 @@
     typedef DWORD                             pthread_t;
 #endif
 
+/** Maximum number of CPU supported by the CPU set.
+ */
+#define JF_THREAD_MAX_CPU                     (256)
+
+/** Maximum length of thread name, the name is truncated if it's longer. Linux limits the name to
+ *  16 bytes including the null-terminator.
+ */
+#define JF_THREAD_MAX_NAME_LEN                (15)
+
 /* --- data structures -------------------------------------------------------------------------- */
 
+/** Define the scheduling policy of thread.
+ */
+typedef enum
+{
+    /**Inherit the scheduling policy from the creating thread.*/
+    JF_THREAD_SCHED_POLICY_DEFAULT = 0,
+    /**Standard round-robin time-sharing policy.*/
+    JF_THREAD_SCHED_POLICY_OTHER,
+    /**Real-time first-in first-out policy, jta_u32Priority is used.*/
+    JF_THREAD_SCHED_POLICY_FIFO,
+    /**Real-time round-robin policy, jta_u32Priority is used.*/
+    JF_THREAD_SCHED_POLICY_RR,
+    /**Batch style policy for CPU-intensive thread.*/
+    JF_THREAD_SCHED_POLICY_BATCH,
+    /**Policy for running very low priority background thread.*/
+    JF_THREAD_SCHED_POLICY_IDLE,
+} jf_thread_sched_policy_t;
+
+/** Define the CPU set data type, bit N is for CPU N.
+ */
+typedef struct
+{
+    u64 jtcs_u64Mask[JF_THREAD_MAX_CPU / 64];
+} jf_thread_cpu_set_t;
+
 /** Define the thread attribute data type.
+ *
+ *  @note
+ *  -# The attribute should be zeroed before use, the zero value means default for all fields.
  */
 typedef struct
 {
     /**Detach the thread if it's TRUE.*/
     boolean_t jta_bDetached;
-    u8 jta_u8Reserved[31];
+    /**Bind the thread to the CPUs in jta_jtcsAffinity if it's TRUE.*/
+    boolean_t jta_bAffinity;
+    /**Scheduling policy, refer to jf_thread_sched_policy_t.*/
+    u8 jta_u8SchedPolicy;
+    u8 jta_u8Reserved[5];
+    /**Priority for real-time policy, 1 to 99 on Linux. It's ignored for other policies.*/
+    u32 jta_u32Priority;
+    u32 jta_u32Reserved;
+    /**Stack size in byte, the default size is used if it's 0.*/
+    olsize_t jta_sStack;
+    /**Name of the thread, the name is not set if it's NULL.*/
+    const olchar_t * jta_pstrName;
+    /**The CPU set for affinity.*/
+    jf_thread_cpu_set_t jta_jtcsAffinity;
+    u8 jta_u8Reserved2[32];
 } jf_thread_attr_t;
 
 /** Define the thread id data type.
@@ -100,6 +151,14 @@ void jf_thread_initId(jf_thread_id_t * pThreadId);
 boolean_t jf_thread_isValidId(jf_thread_id_t * pThreadId);
 
 /** Create thread and run the specified routine.
+ *
+ *  @note
+ *  -# Real-time scheduling policy requires privilege, the thread is not created if the calling
+ *   process doesn't have the privilege.
+ *  -# The name is set by the created thread before the routine is run, failure of setting name
+ *   is ignored.
+ *  -# On Windows, only the first 64 CPUs in the CPU set are used, the real-time policy is mapped
+ *   to thread priority, the name is not supported.
  *
  *  @param pThreadId [out] The thread id created.
  *  @param pAttr [in] The attribute for creating the thread.
@@ -108,6 +167,8 @@ boolean_t jf_thread_isValidId(jf_thread_id_t * pThreadId);
  *
  *  @return The error code.
  *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_PARAM Invalid attribute.
+ *  @retval JF_ERR_FAIL_CREATE_THREAD Failed to create the thread.
  */
 u32 jf_thread_create(
     jf_thread_id_t * pThreadId, jf_thread_attr_t * pAttr, jf_thread_fnRoutine_t fnRoutine,
@@ -140,6 +201,70 @@ u32 jf_thread_terminate(jf_thread_id_t * pThreadId);
  */
 u32 jf_thread_waitForThreadTermination(jf_thread_id_t threadId, u32 * pu32RetCode);
 
+/** Clear all CPUs in the CPU set.
+ *
+ *  @param pjtcs [out] The CPU set.
+ *
+ *  @return Void.
+ */
+void jf_thread_clearCpuSet(jf_thread_cpu_set_t * pjtcs);
+
+/** Add CPU to the CPU set.
+ *
+ *  @param pjtcs [in/out] The CPU set.
+ *  @param u32Cpu [in] The CPU to add, it's ignored if it's not less than JF_THREAD_MAX_CPU.
+ *
+ *  @return Void.
+ */
+void jf_thread_addCpuToCpuSet(jf_thread_cpu_set_t * pjtcs, u32 u32Cpu);
+
+/** Check if the CPU is in the CPU set.
+ *
+ *  @param pjtcs [in] The CPU set.
+ *  @param u32Cpu [in] The CPU to check.
+ *
+ *  @return The status of the CPU.
+ *  @retval TRUE The CPU is in the CPU set.
+ *  @retval FALSE The CPU is not in the CPU set.
+ */
+boolean_t jf_thread_isCpuInCpuSet(const jf_thread_cpu_set_t * pjtcs, u32 u32Cpu);
+
+/** Get CPU set from string.
+ *
+ *  @note
+ *  -# The syntax is the same as jf_string_getIdListFromString(), eg. "0~3, 8, 10~11".
+ *
+ *  @param pstrCpuList [in] The CPU list string.
+ *  @param pjtcs [out] The CPU set.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_INVALID_STRING Invalid CPU list string.
+ *  @retval JF_ERR_INVALID_PARAM The CPU is out of range.
+ */
+u32 jf_thread_getCpuSetFromString(const olchar_t * pstrCpuList, jf_thread_cpu_set_t * pjtcs);
+
+/** Bind the calling thread to the CPUs in the CPU set.
+ *
+ *  @param pjtcs [in] The CPU set.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OPERATION_FAIL Failed to set the affinity.
+ */
+u32 jf_thread_setCurrentAffinity(const jf_thread_cpu_set_t * pjtcs);
+
+/** Set name of the calling thread.
+ *
+ *  @param pstrName [in] The name, it's truncated to JF_THREAD_MAX_NAME_LEN characters.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_OPERATION_FAIL Failed to set the name.
+ *  @retval JF_ERR_NOT_SUPPORTED The name is not supported on Windows.
+ */
+u32 jf_thread_setCurrentName(const olchar_t * pstrName);
+
 /** Register signal handler for thread.
  *
  *  @note
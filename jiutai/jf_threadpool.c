@@ -0,0 +1,1060 @@
+/**
+ *  @file jf_threadpool.c
+ *
+ *  @brief Implementation file for work-stealing thread pool.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The deque follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.),
+ *   the buffer has fixed size. The top and bottom index start from 1, so "bottom - 1" never wraps
+ *   when the deque is empty.
+ *  -# The owner of the deque pushes and pops at the bottom, the thieves steal at the top with CAS.
+ *   The CAS on the top is also used when the owner pops the last task.
+ *  -# The worker registers itself as idle before checking the queues for the last time, the
+ *   submitter publishes the task before checking the idle count, both with full barrier, so the
+ *   wakeup is never lost. The semaphore may have a spurious count, the worker checks the queues
+ *   again after waking up.
+ *  -# The future and parallel-for object have reference count, the worker drops its reference
+ *   after the semaphore is up, so the waiting thread never frees the object when the worker is
+ *   still using it.
+ *  -# The tasks run by a worker are cached in the free list of the worker.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#if defined(LINUX)
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_threadpool.h"
+#include "jf_thread.h"
+#include "jf_mutex.h"
+#include "jf_sem.h"
+#include "jf_atomic.h"
+#include "jf_jiukun.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Thread local storage specifier.
+ */
+#if defined(LINUX)
+    #define THREADPOOL_THREAD_LOCAL             __thread
+#elif defined(WINDOWS)
+    #define THREADPOOL_THREAD_LOCAL             __declspec(thread)
+#endif
+
+/** Number of spins before the idle worker sleeps, or the waiting worker yields CPU.
+ */
+#define THREADPOOL_SPIN_COUNT                   (64)
+
+/** Maximum number of task in the free list of worker.
+ */
+#define THREADPOOL_MAX_FREE_TASK                (256)
+
+/** Maximum size of the deque.
+ */
+#define THREADPOOL_MAX_DEQUE_SIZE               (JF_JIUKUN_MAX_MEMORY_SIZE / sizeof(void *))
+
+/** The initial value of top and bottom index of deque.
+ */
+#define THREADPOOL_DEQUE_INITIAL_INDEX          (1)
+
+struct internal_threadpool;
+struct threadpool_ref_object;
+
+/** Define the object with reference count, it's the future or parallel-for object.
+ */
+typedef struct threadpool_ref_object
+{
+    /**The thread pool.*/
+    struct internal_threadpool * tro_pitPool;
+    /**Reference count.*/
+    u32 tro_u32Ref;
+    /**Number of pending task, the object is done if it's 0.*/
+    u32 tro_u32NumOfPending;
+    /**The result.*/
+    u32 tro_u32Result;
+    u32 tro_u32Reserved;
+    /**The semaphore is up when the object is done.*/
+    jf_sem_t tro_jsDone;
+} threadpool_ref_object_t;
+
+/** Define the future data type.
+ */
+typedef threadpool_ref_object_t  internal_threadpool_future_t;
+
+/** Define the parallel-for data type.
+ */
+typedef struct
+{
+    /**The reference object, number of pending task is number of helper task.*/
+    threadpool_ref_object_t tpf_troObject;
+    /**The next index to be claimed.*/
+    u64 tpf_u64Next;
+    /**The index after the last index.*/
+    u64 tpf_u64End;
+    /**Number of index in a sub-range.*/
+    u64 tpf_u64Grain;
+    /**The function for the sub-range.*/
+    jf_threadpool_fnRange_t tpf_fnRange;
+    /**The argument of the function.*/
+    void * tpf_pArg;
+} threadpool_parallel_for_t;
+
+/** Define the task data type.
+ */
+typedef struct threadpool_task
+{
+    /**The task function.*/
+    jf_threadpool_fnTask_t tt_fnTask;
+    /**The argument of the task.*/
+    void * tt_pArg;
+    /**The completion function.*/
+    jf_threadpool_fnCompletion_t tt_fnCompletion;
+    /**The future of the task.*/
+    internal_threadpool_future_t * tt_pitfFuture;
+    /**The next task in shared queue or free list.*/
+    struct threadpool_task * tt_pttNext;
+} threadpool_task_t;
+
+/** Define the Chase-Lev deque data type.
+ */
+typedef struct
+{
+    /**The top index, it's changed by thieves and owner.*/
+    u64 td_u64Top;
+    u8 td_u8Reserved[JF_ATOMIC_CACHE_LINE_SIZE - sizeof(u64)];
+    /**The bottom index, it's changed by owner only.*/
+    u64 td_u64Bottom;
+    /**The mask of index, buffer size minus 1.*/
+    u64 td_u64Mask;
+    /**The buffer of task.*/
+    threadpool_task_t ** td_ppttBuffer;
+    u8 td_u8Reserved2[JF_ATOMIC_CACHE_LINE_SIZE - 2 * sizeof(u64) - sizeof(void *)];
+} threadpool_deque_t;
+
+/** Define the worker data type.
+ */
+typedef struct
+{
+    /**The deque of the worker.*/
+    threadpool_deque_t tw_tdDeque;
+    /**The thread pool.*/
+    struct internal_threadpool * tw_pitPool;
+    /**The thread id.*/
+    jf_thread_id_t tw_jtiThread;
+    /**The free list of task.*/
+    threadpool_task_t * tw_pttFree;
+    /**Number of task in free list.*/
+    u32 tw_u32NumOfFree;
+    /**The seed for choosing victim.*/
+    u32 tw_u32Seed;
+    /**The index of the worker.*/
+    u32 tw_u32Index;
+    u32 tw_u32Reserved;
+} threadpool_worker_t;
+
+/** Define the internal thread pool data type.
+ */
+typedef struct internal_threadpool
+{
+    /**The workers.*/
+    threadpool_worker_t * it_ptwWorker;
+    /**Number of worker.*/
+    u32 it_u32NumOfWorker;
+    /**Number of worker started.*/
+    u32 it_u32NumOfStarted;
+    /**Number of idle worker waiting on the semaphore.*/
+    u32 it_u32NumOfIdle;
+    /**The pool is being destroyed if it's not 0.*/
+    u32 it_u32Terminate;
+    /**The semaphore for idle worker.*/
+    jf_sem_t it_jsIdle;
+
+    /**Number of task in shared queue.*/
+    u32 it_u32NumOfShared;
+    u32 it_u32Reserved;
+    /**The mutex for shared queue.*/
+    jf_mutex_t it_jmShared;
+    /**The head of shared queue.*/
+    threadpool_task_t * it_pttSharedHead;
+    /**The tail of shared queue.*/
+    threadpool_task_t * it_pttSharedTail;
+} internal_threadpool_t;
+
+/** The worker of the calling thread, it's NULL if the calling thread is not a worker.
+ */
+static THREADPOOL_THREAD_LOCAL threadpool_worker_t * ls_ptwThreadpoolWorker = NULL;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static u32 _getThreadpoolNumOfCpu(void)
+{
+    u32 u32NumOfCpu = 1;
+#if defined(LINUX)
+    long lRet = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (lRet > 0)
+        u32NumOfCpu = (u32)lRet;
+#elif defined(WINDOWS)
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    u32NumOfCpu = (u32)si.dwNumberOfProcessors;
+#endif
+
+    return u32NumOfCpu;
+}
+
+static void _yieldThreadpoolThread(void)
+{
+#if defined(LINUX)
+    sched_yield();
+#elif defined(WINDOWS)
+    SwitchToThread();
+#endif
+}
+
+/** Get the worker of the calling thread if it's a worker of the pool.
+ */
+static inline threadpool_worker_t * _getThreadpoolCurrentWorker(internal_threadpool_t * pitp)
+{
+    threadpool_worker_t * ptw = ls_ptwThreadpoolWorker;
+
+    if ((ptw != NULL) && (ptw->tw_pitPool != pitp))
+        ptw = NULL;
+
+    return ptw;
+}
+
+/** Push the task to the bottom of the deque, it's called by owner.
+ *
+ *  @return The status of the operation.
+ *  @retval TRUE The task is pushed.
+ *  @retval FALSE The deque is full.
+ */
+static boolean_t _pushThreadpoolDeque(threadpool_deque_t * ptd, threadpool_task_t * ptt)
+{
+    u64 u64Bottom = ptd->td_u64Bottom;
+    u64 u64Top = jf_atomic_loadU64(&ptd->td_u64Top);
+
+    if (u64Bottom - u64Top > ptd->td_u64Mask)
+        return FALSE;
+
+    jf_atomic_storePtr((void **)&ptd->td_ppttBuffer[u64Bottom & ptd->td_u64Mask], ptt);
+    /*Release store, the task is visible before the bottom index.*/
+    jf_atomic_storeU64(&ptd->td_u64Bottom, u64Bottom + 1);
+
+    return TRUE;
+}
+
+/** Pop the task from the bottom of the deque, it's called by owner.
+ */
+static threadpool_task_t * _popThreadpoolDeque(threadpool_deque_t * ptd)
+{
+    threadpool_task_t * ptt = NULL;
+    u64 u64Bottom = ptd->td_u64Bottom - 1, u64Top = 0;
+
+    jf_atomic_storeU64(&ptd->td_u64Bottom, u64Bottom);
+    /*The store of bottom index must be visible before loading the top index.*/
+    jf_atomic_fence();
+    u64Top = jf_atomic_loadU64(&ptd->td_u64Top);
+
+    if (u64Top <= u64Bottom)
+    {
+        ptt = jf_atomic_loadPtr((void **)&ptd->td_ppttBuffer[u64Bottom & ptd->td_u64Mask]);
+        if (u64Top == u64Bottom)
+        {
+            /*The last task, race with thieves.*/
+            if (! jf_atomic_casU64(&ptd->td_u64Top, u64Top, u64Top + 1))
+                ptt = NULL;
+            jf_atomic_storeU64(&ptd->td_u64Bottom, u64Bottom + 1);
+        }
+    }
+    else
+    {
+        /*The deque is empty.*/
+        jf_atomic_storeU64(&ptd->td_u64Bottom, u64Bottom + 1);
+    }
+
+    return ptt;
+}
+
+/** Steal the task from the top of the deque, it's called by thieves.
+ *
+ *  @return The task stolen, NULL if the deque is empty or the race is lost.
+ */
+static threadpool_task_t * _stealThreadpoolDeque(threadpool_deque_t * ptd)
+{
+    threadpool_task_t * ptt = NULL;
+    u64 u64Top = jf_atomic_loadU64(&ptd->td_u64Top), u64Bottom = 0;
+
+    jf_atomic_fence();
+    u64Bottom = jf_atomic_loadU64(&ptd->td_u64Bottom);
+
+    if (u64Top < u64Bottom)
+    {
+        ptt = jf_atomic_loadPtr((void **)&ptd->td_ppttBuffer[u64Top & ptd->td_u64Mask]);
+        if (! jf_atomic_casU64(&ptd->td_u64Top, u64Top, u64Top + 1))
+            ptt = NULL;
+    }
+
+    return ptt;
+}
+
+static inline boolean_t _isThreadpoolDequeEmpty(threadpool_deque_t * ptd)
+{
+    return (jf_atomic_loadU64(&ptd->td_u64Top) >= jf_atomic_loadU64(&ptd->td_u64Bottom));
+}
+
+static void _pushThreadpoolSharedQueue(internal_threadpool_t * pitp, threadpool_task_t * ptt)
+{
+    ptt->tt_pttNext = NULL;
+
+    jf_mutex_acquire(&pitp->it_jmShared);
+
+    if (pitp->it_pttSharedTail == NULL)
+        pitp->it_pttSharedHead = ptt;
+    else
+        pitp->it_pttSharedTail->tt_pttNext = ptt;
+    pitp->it_pttSharedTail = ptt;
+    jf_atomic_fetchAddU32(&pitp->it_u32NumOfShared, 1);
+
+    jf_mutex_release(&pitp->it_jmShared);
+}
+
+static threadpool_task_t * _popThreadpoolSharedQueue(internal_threadpool_t * pitp)
+{
+    threadpool_task_t * ptt = NULL;
+
+    /*Don't acquire the mutex if the queue is empty.*/
+    if (jf_atomic_loadU32(&pitp->it_u32NumOfShared) == 0)
+        return NULL;
+
+    jf_mutex_acquire(&pitp->it_jmShared);
+
+    ptt = pitp->it_pttSharedHead;
+    if (ptt != NULL)
+    {
+        pitp->it_pttSharedHead = ptt->tt_pttNext;
+        if (pitp->it_pttSharedHead == NULL)
+            pitp->it_pttSharedTail = NULL;
+        jf_atomic_fetchAddU32(&pitp->it_u32NumOfShared, (u32)-1);
+    }
+
+    jf_mutex_release(&pitp->it_jmShared);
+
+    return ptt;
+}
+
+/** Steal task from other workers, the first victim is chosen randomly.
+ */
+static threadpool_task_t * _stealThreadpoolTask(threadpool_worker_t * ptw)
+{
+    internal_threadpool_t * pitp = ptw->tw_pitPool;
+    threadpool_task_t * ptt = NULL;
+    u32 u32Index = 0, u32Victim = 0;
+
+    if (pitp->it_u32NumOfWorker < 2)
+        return NULL;
+
+    /*Xorshift.*/
+    ptw->tw_u32Seed ^= ptw->tw_u32Seed << 13;
+    ptw->tw_u32Seed ^= ptw->tw_u32Seed >> 17;
+    ptw->tw_u32Seed ^= ptw->tw_u32Seed << 5;
+    u32Victim = ptw->tw_u32Seed % pitp->it_u32NumOfWorker;
+
+    for (u32Index = 0; (u32Index < pitp->it_u32NumOfWorker) && (ptt == NULL); u32Index ++)
+    {
+        if (u32Victim != ptw->tw_u32Index)
+            ptt = _stealThreadpoolDeque(&pitp->it_ptwWorker[u32Victim].tw_tdDeque);
+
+        u32Victim ++;
+        if (u32Victim == pitp->it_u32NumOfWorker)
+            u32Victim = 0;
+    }
+
+    return ptt;
+}
+
+/** Get a task for the worker, the own deque is checked first, then shared queue, then other
+ *  workers.
+ */
+static threadpool_task_t * _getThreadpoolTask(threadpool_worker_t * ptw)
+{
+    threadpool_task_t * ptt = NULL;
+
+    ptt = _popThreadpoolDeque(&ptw->tw_tdDeque);
+
+    if (ptt == NULL)
+        ptt = _popThreadpoolSharedQueue(ptw->tw_pitPool);
+
+    if (ptt == NULL)
+        ptt = _stealThreadpoolTask(ptw);
+
+    return ptt;
+}
+
+static boolean_t _hasThreadpoolTask(internal_threadpool_t * pitp)
+{
+    u32 u32Index = 0;
+
+    if (jf_atomic_loadU32(&pitp->it_u32NumOfShared) != 0)
+        return TRUE;
+
+    for (u32Index = 0; u32Index < pitp->it_u32NumOfWorker; u32Index ++)
+        if (! _isThreadpoolDequeEmpty(&pitp->it_ptwWorker[u32Index].tw_tdDeque))
+            return TRUE;
+
+    return FALSE;
+}
+
+/** Wake up an idle worker if there is any.
+ */
+static void _wakeThreadpoolWorker(internal_threadpool_t * pitp)
+{
+    u32 u32Idle = 0;
+
+    /*The task must be visible before checking the idle count.*/
+    jf_atomic_fence();
+
+    while ((u32Idle = jf_atomic_loadU32(&pitp->it_u32NumOfIdle)) != 0)
+    {
+        if (jf_atomic_casU32(&pitp->it_u32NumOfIdle, u32Idle, u32Idle - 1))
+        {
+            jf_sem_up(&pitp->it_jsIdle);
+            break;
+        }
+    }
+}
+
+/** Cancel the idle registration of the worker.
+ *
+ *  @note
+ *  -# If the registration is already taken by a submitter, the semaphore has a spurious count
+ *   which is consumed by the next sleep.
+ */
+static void _cancelThreadpoolIdle(internal_threadpool_t * pitp)
+{
+    u32 u32Idle = 0;
+
+    while ((u32Idle = jf_atomic_loadU32(&pitp->it_u32NumOfIdle)) != 0)
+    {
+        if (jf_atomic_casU32(&pitp->it_u32NumOfIdle, u32Idle, u32Idle - 1))
+            break;
+    }
+}
+
+static u32 _allocThreadpoolTask(threadpool_worker_t * ptw, threadpool_task_t ** ppTask)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    if ((ptw != NULL) && (ptw->tw_pttFree != NULL))
+    {
+        *ppTask = ptw->tw_pttFree;
+        ptw->tw_pttFree = (*ppTask)->tt_pttNext;
+        ptw->tw_u32NumOfFree --;
+    }
+    else
+    {
+        u32Ret = jf_jiukun_allocMemory((void **)ppTask, sizeof(threadpool_task_t));
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_bzero(*ppTask, sizeof(threadpool_task_t));
+
+    return u32Ret;
+}
+
+static void _freeThreadpoolTask(threadpool_worker_t * ptw, threadpool_task_t * ptt)
+{
+    if ((ptw != NULL) && (ptw->tw_u32NumOfFree < THREADPOOL_MAX_FREE_TASK))
+    {
+        ptt->tt_pttNext = ptw->tw_pttFree;
+        ptw->tw_pttFree = ptt;
+        ptw->tw_u32NumOfFree ++;
+    }
+    else
+    {
+        jf_jiukun_freeMemory((void **)&ptt);
+    }
+}
+
+static u32 _createThreadpoolRefObject(
+    internal_threadpool_t * pitp, olsize_t sObject, u32 u32NumOfPending,
+    threadpool_ref_object_t ** ppObject)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    threadpool_ref_object_t * ptro = NULL;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&ptro, sObject);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(ptro, sObject);
+        ptro->tro_pitPool = pitp;
+        /*One reference for the waiting thread, one for each pending task.*/
+        ptro->tro_u32Ref = 1 + u32NumOfPending;
+        ptro->tro_u32NumOfPending = u32NumOfPending;
+
+        u32Ret = jf_sem_init(&ptro->tro_jsDone, 0, 1);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            *ppObject = ptro;
+        else
+            jf_jiukun_freeMemory((void **)&ptro);
+    }
+
+    return u32Ret;
+}
+
+static void _releaseThreadpoolRefObject(threadpool_ref_object_t * ptro)
+{
+    if (jf_atomic_fetchAddU32(&ptro->tro_u32Ref, (u32)-1) == 1)
+    {
+        jf_sem_fini(&ptro->tro_jsDone);
+        jf_jiukun_freeMemory((void **)&ptro);
+    }
+}
+
+/** Complete a pending task of the object, then drop the reference of the task.
+ */
+static void _completeThreadpoolRefObject(threadpool_ref_object_t * ptro)
+{
+    if (jf_atomic_fetchAddU32(&ptro->tro_u32NumOfPending, (u32)-1) == 1)
+        jf_sem_up(&ptro->tro_jsDone);
+
+    _releaseThreadpoolRefObject(ptro);
+}
+
+static void _runThreadpoolTask(threadpool_worker_t * ptw, threadpool_task_t * ptt)
+{
+    u32 u32Result = 0;
+
+    u32Result = ptt->tt_fnTask(ptt->tt_pArg);
+
+    if (ptt->tt_fnCompletion != NULL)
+        ptt->tt_fnCompletion(ptt->tt_pArg, u32Result);
+
+    if (ptt->tt_pitfFuture != NULL)
+    {
+        ptt->tt_pitfFuture->tro_u32Result = u32Result;
+        _completeThreadpoolRefObject(ptt->tt_pitfFuture);
+    }
+
+    _freeThreadpoolTask(ptw, ptt);
+}
+
+/** Wait until the object is done.
+ *
+ *  @note
+ *  -# The worker runs other tasks when waiting, other threads sleep on the semaphore.
+ */
+static void _waitThreadpoolRefObject(threadpool_ref_object_t * ptro)
+{
+    threadpool_worker_t * ptw = _getThreadpoolCurrentWorker(ptro->tro_pitPool);
+    threadpool_task_t * ptt = NULL;
+    u32 u32Spin = 0;
+
+    while (jf_atomic_loadU32(&ptro->tro_u32NumOfPending) != 0)
+    {
+        if (ptw == NULL)
+        {
+            jf_sem_down(&ptro->tro_jsDone);
+            continue;
+        }
+
+        ptt = _getThreadpoolTask(ptw);
+        if (ptt != NULL)
+        {
+            _runThreadpoolTask(ptw, ptt);
+            u32Spin = 0;
+        }
+        else if (u32Spin < THREADPOOL_SPIN_COUNT)
+        {
+            jf_atomic_cpuRelax();
+            u32Spin ++;
+        }
+        else
+        {
+            _yieldThreadpoolThread();
+        }
+    }
+}
+
+/** Sleep until a task is submitted or the pool is being destroyed.
+ *
+ *  @return The status of the pool.
+ *  @retval TRUE The pool is being destroyed and there is no task.
+ *  @retval FALSE The worker should check the queues again.
+ */
+static boolean_t _sleepThreadpoolWorker(internal_threadpool_t * pitp)
+{
+    jf_atomic_fetchAddU32(&pitp->it_u32NumOfIdle, 1);
+
+    /*Check again after registering as idle, the task may be submitted before the registration.*/
+    if (_hasThreadpoolTask(pitp))
+    {
+        _cancelThreadpoolIdle(pitp);
+        return FALSE;
+    }
+
+    if (jf_atomic_loadU32(&pitp->it_u32Terminate) != 0)
+    {
+        _cancelThreadpoolIdle(pitp);
+        return TRUE;
+    }
+
+    jf_sem_down(&pitp->it_jsIdle);
+
+    return FALSE;
+}
+
+static JF_THREAD_RETURN_VALUE _threadpoolWorkerThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    threadpool_worker_t * ptw = (threadpool_worker_t *)pArg;
+    internal_threadpool_t * pitp = ptw->tw_pitPool;
+    threadpool_task_t * ptt = NULL;
+    u32 u32Spin = 0;
+
+    ls_ptwThreadpoolWorker = ptw;
+
+    while (TRUE)
+    {
+        ptt = _getThreadpoolTask(ptw);
+        if (ptt != NULL)
+        {
+            _runThreadpoolTask(ptw, ptt);
+            u32Spin = 0;
+        }
+        else if (u32Spin < THREADPOOL_SPIN_COUNT)
+        {
+            jf_atomic_cpuRelax();
+            u32Spin ++;
+        }
+        else if (_sleepThreadpoolWorker(pitp))
+        {
+            break;
+        }
+        else
+        {
+            u32Spin = 0;
+        }
+    }
+
+    ls_ptwThreadpoolWorker = NULL;
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+/** Queue the task, the task is pushed to the deque if the calling thread is a worker.
+ */
+static u32 _queueThreadpoolTask(
+    internal_threadpool_t * pitp, jf_threadpool_fnTask_t fnTask, void * pArg,
+    jf_threadpool_fnCompletion_t fnCompletion, internal_threadpool_future_t * pitf)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    threadpool_worker_t * ptw = _getThreadpoolCurrentWorker(pitp);
+    threadpool_task_t * ptt = NULL;
+
+    /*Worker can submit task when the pool is being destroyed, the task may be needed by the task
+      which is running.*/
+    if ((ptw == NULL) && (jf_atomic_loadU32(&pitp->it_u32Terminate) != 0))
+        return JF_ERR_THREADPOOL_TERMINATED;
+
+    u32Ret = _allocThreadpoolTask(ptw, &ptt);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ptt->tt_fnTask = fnTask;
+        ptt->tt_pArg = pArg;
+        ptt->tt_fnCompletion = fnCompletion;
+        ptt->tt_pitfFuture = pitf;
+
+        if ((ptw == NULL) || ! _pushThreadpoolDeque(&ptw->tw_tdDeque, ptt))
+            _pushThreadpoolSharedQueue(pitp, ptt);
+
+        _wakeThreadpoolWorker(pitp);
+    }
+
+    return u32Ret;
+}
+
+/** Claim a sub-range.
+ *
+ *  @note
+ *  -# The next index is advanced with compare and swap and never goes beyond the end, so it
+ *   doesn't wrap around if the end is close to U64_MAX.
+ *
+ *  @return The status of the claim.
+ *  @retval TRUE A sub-range is claimed.
+ *  @retval FALSE All sub-ranges are claimed.
+ */
+static boolean_t _claimThreadpoolParallelForRange(
+    threadpool_parallel_for_t * ptpf, u64 * pu64Begin, u64 * pu64End)
+{
+    u64 u64Begin = jf_atomic_loadU64(&ptpf->tpf_u64Next), u64End = 0;
+
+    while (u64Begin < ptpf->tpf_u64End)
+    {
+        if (ptpf->tpf_u64End - u64Begin > ptpf->tpf_u64Grain)
+            u64End = u64Begin + ptpf->tpf_u64Grain;
+        else
+            u64End = ptpf->tpf_u64End;
+
+        if (jf_atomic_casU64(&ptpf->tpf_u64Next, u64Begin, u64End))
+        {
+            *pu64Begin = u64Begin;
+            *pu64End = u64End;
+            return TRUE;
+        }
+
+        /*Other thread claimed the sub-range, try the next one.*/
+        u64Begin = jf_atomic_loadU64(&ptpf->tpf_u64Next);
+    }
+
+    return FALSE;
+}
+
+/** Claim and run the sub-ranges until all sub-ranges are claimed or error occurs.
+ */
+static void _runThreadpoolParallelFor(threadpool_parallel_for_t * ptpf)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Begin = 0, u64End = 0;
+
+    while ((jf_atomic_loadU32(&ptpf->tpf_troObject.tro_u32Result) == JF_ERR_NO_ERROR) &&
+           _claimThreadpoolParallelForRange(ptpf, &u64Begin, &u64End))
+    {
+        u32Ret = ptpf->tpf_fnRange(ptpf->tpf_pArg, u64Begin, u64End);
+        if (u32Ret != JF_ERR_NO_ERROR)
+            jf_atomic_casU32(&ptpf->tpf_troObject.tro_u32Result, JF_ERR_NO_ERROR, u32Ret);
+    }
+}
+
+static u32 _threadpoolParallelForTask(void * pArg)
+{
+    threadpool_parallel_for_t * ptpf = (threadpool_parallel_for_t *)pArg;
+
+    _runThreadpoolParallelFor(ptpf);
+
+    _completeThreadpoolRefObject(&ptpf->tpf_troObject);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _startThreadpoolWorker(internal_threadpool_t * pitp, u32 u32DequeSize)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    threadpool_worker_t * ptw = NULL;
+    u32 u32Index = 0;
+
+    for (u32Index = 0; (u32Index < pitp->it_u32NumOfWorker) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        ptw = &pitp->it_ptwWorker[u32Index];
+        ptw->tw_pitPool = pitp;
+        ptw->tw_u32Index = u32Index;
+        ptw->tw_u32Seed = 0x9E3779B9 * (u32Index + 1);
+        ptw->tw_tdDeque.td_u64Top = THREADPOOL_DEQUE_INITIAL_INDEX;
+        ptw->tw_tdDeque.td_u64Bottom = THREADPOOL_DEQUE_INITIAL_INDEX;
+        ptw->tw_tdDeque.td_u64Mask = u32DequeSize - 1;
+
+        u32Ret = jf_jiukun_allocMemory(
+            (void **)&ptw->tw_tdDeque.td_ppttBuffer, u32DequeSize * sizeof(threadpool_task_t *));
+    }
+
+    for (u32Index = 0; (u32Index < pitp->it_u32NumOfWorker) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        u32Ret = jf_thread_create(
+            &pitp->it_ptwWorker[u32Index].tw_jtiThread, NULL, _threadpoolWorkerThread,
+            &pitp->it_ptwWorker[u32Index]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            pitp->it_u32NumOfStarted ++;
+    }
+
+    return u32Ret;
+}
+
+/** Stop the workers, the workers quit after all tasks are completed.
+ */
+static void _stopThreadpoolWorker(internal_threadpool_t * pitp)
+{
+    u32 u32Index = 0;
+
+    jf_atomic_storeU32(&pitp->it_u32Terminate, 1);
+    jf_atomic_fence();
+
+    for (u32Index = 0; u32Index < pitp->it_u32NumOfStarted; u32Index ++)
+        jf_sem_up(&pitp->it_jsIdle);
+
+    for (u32Index = 0; u32Index < pitp->it_u32NumOfStarted; u32Index ++)
+        jf_thread_waitForThreadTermination(pitp->it_ptwWorker[u32Index].tw_jtiThread, NULL);
+
+    pitp->it_u32NumOfStarted = 0;
+}
+
+static void _freeThreadpoolWorker(internal_threadpool_t * pitp)
+{
+    u32 u32Index = 0;
+    threadpool_worker_t * ptw = NULL;
+    threadpool_task_t * ptt = NULL;
+
+    for (u32Index = 0; u32Index < pitp->it_u32NumOfWorker; u32Index ++)
+    {
+        ptw = &pitp->it_ptwWorker[u32Index];
+
+        while (ptw->tw_pttFree != NULL)
+        {
+            ptt = ptw->tw_pttFree;
+            ptw->tw_pttFree = ptt->tt_pttNext;
+            jf_jiukun_freeMemory((void **)&ptt);
+        }
+
+        if (ptw->tw_tdDeque.td_ppttBuffer != NULL)
+            jf_jiukun_freeMemory((void **)&ptw->tw_tdDeque.td_ppttBuffer);
+    }
+
+    jf_jiukun_freeMemory((void **)&pitp->it_ptwWorker);
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+u32 jf_threadpool_create(jf_threadpool_t ** ppPool, jf_threadpool_create_param_t * pjtcp)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_threadpool_t * pitp = NULL;
+    u32 u32NumOfWorker = 0, u32DequeSize = 1;
+
+    assert((ppPool != NULL) && (pjtcp != NULL));
+
+    u32NumOfWorker = pjtcp->jtcp_u32NumOfWorker;
+    if (u32NumOfWorker == 0)
+        u32NumOfWorker = _getThreadpoolNumOfCpu();
+    u32NumOfWorker = MIN(u32NumOfWorker, JF_THREADPOOL_MAX_WORKER);
+
+    if (pjtcp->jtcp_u32DequeSize == 0)
+        u32DequeSize = JF_THREADPOOL_DEF_DEQUE_SIZE;
+    else
+        while ((u32DequeSize < pjtcp->jtcp_u32DequeSize) &&
+               (u32DequeSize < THREADPOOL_MAX_DEQUE_SIZE))
+            u32DequeSize <<= 1;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pitp, sizeof(internal_threadpool_t));
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pitp, sizeof(internal_threadpool_t));
+        pitp->it_u32NumOfWorker = u32NumOfWorker;
+
+        u32Ret = jf_jiukun_allocMemory(
+            (void **)&pitp->it_ptwWorker, u32NumOfWorker * sizeof(threadpool_worker_t));
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pitp->it_ptwWorker, u32NumOfWorker * sizeof(threadpool_worker_t));
+
+        /*The semaphore may have a spurious count for each worker besides the count for stopping
+          the worker.*/
+        u32Ret = jf_sem_init(&pitp->it_jsIdle, 0, 2 * u32NumOfWorker);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_mutex_init(&pitp->it_jmShared);
+        if (u32Ret != JF_ERR_NO_ERROR)
+            jf_sem_fini(&pitp->it_jsIdle);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _startThreadpoolWorker(pitp, u32DequeSize);
+        if (u32Ret != JF_ERR_NO_ERROR)
+        {
+            _stopThreadpoolWorker(pitp);
+            jf_mutex_fini(&pitp->it_jmShared);
+            jf_sem_fini(&pitp->it_jsIdle);
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        *ppPool = pitp;
+    }
+    else if (pitp != NULL)
+    {
+        if (pitp->it_ptwWorker != NULL)
+            _freeThreadpoolWorker(pitp);
+        jf_jiukun_freeMemory((void **)&pitp);
+    }
+
+    return u32Ret;
+}
+
+u32 jf_threadpool_destroy(jf_threadpool_t ** ppPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_threadpool_t * pitp = NULL;
+
+    assert((ppPool != NULL) && (*ppPool != NULL));
+
+    pitp = (internal_threadpool_t *)*ppPool;
+    assert(_getThreadpoolCurrentWorker(pitp) == NULL);
+
+    _stopThreadpoolWorker(pitp);
+
+    jf_mutex_fini(&pitp->it_jmShared);
+    jf_sem_fini(&pitp->it_jsIdle);
+    _freeThreadpoolWorker(pitp);
+
+    jf_jiukun_freeMemory(ppPool);
+
+    return u32Ret;
+}
+
+u32 jf_threadpool_getNumOfWorker(jf_threadpool_t * pPool)
+{
+    internal_threadpool_t * pitp = (internal_threadpool_t *)pPool;
+
+    return pitp->it_u32NumOfWorker;
+}
+
+u32 jf_threadpool_submit(
+    jf_threadpool_t * pPool, jf_threadpool_fnTask_t fnTask, void * pArg,
+    jf_threadpool_fnCompletion_t fnCompletion)
+{
+    internal_threadpool_t * pitp = (internal_threadpool_t *)pPool;
+
+    assert((pitp != NULL) && (fnTask != NULL));
+
+    return _queueThreadpoolTask(pitp, fnTask, pArg, fnCompletion, NULL);
+}
+
+u32 jf_threadpool_submitWithFuture(
+    jf_threadpool_t * pPool, jf_threadpool_fnTask_t fnTask, void * pArg,
+    jf_threadpool_future_t ** ppFuture)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_threadpool_t * pitp = (internal_threadpool_t *)pPool;
+    internal_threadpool_future_t * pitf = NULL;
+
+    assert((pitp != NULL) && (fnTask != NULL) && (ppFuture != NULL));
+
+    u32Ret = _createThreadpoolRefObject(pitp, sizeof(internal_threadpool_future_t), 1, &pitf);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _queueThreadpoolTask(pitp, fnTask, pArg, NULL, pitf);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            *ppFuture = pitf;
+        }
+        else
+        {
+            /*Drop the reference of the task and the waiting thread.*/
+            _releaseThreadpoolRefObject(pitf);
+            _releaseThreadpoolRefObject(pitf);
+        }
+    }
+
+    return u32Ret;
+}
+
+u32 jf_threadpool_waitFuture(jf_threadpool_future_t * pFuture, u32 * pu32Result)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_threadpool_future_t * pitf = (internal_threadpool_future_t *)pFuture;
+
+    assert(pitf != NULL);
+
+    _waitThreadpoolRefObject(pitf);
+
+    if (pu32Result != NULL)
+        *pu32Result = pitf->tro_u32Result;
+
+    return u32Ret;
+}
+
+boolean_t jf_threadpool_isFutureReady(jf_threadpool_future_t * pFuture)
+{
+    internal_threadpool_future_t * pitf = (internal_threadpool_future_t *)pFuture;
+
+    return (jf_atomic_loadU32(&pitf->tro_u32NumOfPending) == 0);
+}
+
+u32 jf_threadpool_destroyFuture(jf_threadpool_future_t ** ppFuture)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    assert((ppFuture != NULL) && (*ppFuture != NULL));
+
+    _releaseThreadpoolRefObject((threadpool_ref_object_t *)*ppFuture);
+    *ppFuture = NULL;
+
+    return u32Ret;
+}
+
+u32 jf_threadpool_parallelFor(
+    jf_threadpool_t * pPool, u64 u64Begin, u64 u64End, u64 u64Grain,
+    jf_threadpool_fnRange_t fnRange, void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    internal_threadpool_t * pitp = (internal_threadpool_t *)pPool;
+    threadpool_parallel_for_t * ptpf = NULL;
+    u64 u64NumOfRange = 0;
+    u32 u32NumOfHelper = 0, u32Index = 0;
+
+    assert((pitp != NULL) && (fnRange != NULL));
+
+    if (u64Begin >= u64End)
+        return u32Ret;
+
+    if (u64Grain == 0)
+        u64Grain = 1;
+
+    /*The calling thread runs one sub-range, one helper task for each of other sub-ranges, no more
+      than number of worker.*/
+    u64NumOfRange = (u64End - u64Begin - 1) / u64Grain + 1;
+    u32NumOfHelper = (u32)MIN(u64NumOfRange - 1, pitp->it_u32NumOfWorker);
+
+    if (u32NumOfHelper == 0)
+        return fnRange(pArg, u64Begin, u64End);
+
+    u32Ret = _createThreadpoolRefObject(
+        pitp, sizeof(threadpool_parallel_for_t), u32NumOfHelper,
+        (threadpool_ref_object_t **)&ptpf);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ptpf->tpf_u64Next = u64Begin;
+        ptpf->tpf_u64End = u64End;
+        ptpf->tpf_u64Grain = u64Grain;
+        ptpf->tpf_fnRange = fnRange;
+        ptpf->tpf_pArg = pArg;
+
+        for (u32Index = 0; u32Index < u32NumOfHelper; u32Index ++)
+        {
+            if (_queueThreadpoolTask(pitp, _threadpoolParallelForTask, ptpf, NULL, NULL) !=
+                JF_ERR_NO_ERROR)
+                /*The calling thread runs the sub-ranges of the helper.*/
+                _completeThreadpoolRefObject(&ptpf->tpf_troObject);
+        }
+
+        _runThreadpoolParallelFor(ptpf);
+
+        _waitThreadpoolRefObject(&ptpf->tpf_troObject);
+
+        u32Ret = ptpf->tpf_troObject.tro_u32Result;
+        _releaseThreadpoolRefObject(&ptpf->tpf_troObject);
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
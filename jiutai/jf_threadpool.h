@@ -0,0 +1,217 @@
+/**
+ *  @file jf_threadpool.h
+ *
+ *  @brief Header file defines the interface for work-stealing thread pool.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# Routines declared in this file are included in jf_threadpool object.
+ *  -# Each worker has a Chase-Lev deque. The task submitted by a worker is pushed to the bottom of
+ *   its own deque, the worker pops task from the bottom, other workers steal task from the top when
+ *   they are idle. The task submitted by other threads is saved in a shared queue.
+ *  -# The deque has fixed size, the task is saved in the shared queue if the deque is full.
+ *  -# The idle worker is parked on a semaphore, it's waken up when a task is submitted.
+ *  -# If a worker waits for future or parallel-for, it runs other tasks when waiting, so the task
+ *   can submit sub-tasks and wait for them without deadlock.
+ *  -# Link with jf_thread, jf_mutex, jf_sem common objects and jf_jiukun library.
+ */
+
+#ifndef JIUTAI_THREADPOOL_H
+#define JIUTAI_THREADPOOL_H
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+/* --- internal header files -------------------------------------------------------------------- */
+#include "jf_basic.h"
+#include "jf_err.h"
+
+/* --- constant definitions --------------------------------------------------------------------- */
+
+/** Maximum number of worker in the thread pool.
+ */
+#define JF_THREADPOOL_MAX_WORKER              (256)
+
+/** Default size of the deque of worker.
+ */
+#define JF_THREADPOOL_DEF_DEQUE_SIZE          (4096)
+
+/* --- data structures -------------------------------------------------------------------------- */
+
+/** Define the thread pool data type.
+ */
+typedef void  jf_threadpool_t;
+
+/** Define the future data type, it's used to get the result of the task.
+ */
+typedef void  jf_threadpool_future_t;
+
+/** Define the function data type for the task.
+ *
+ *  @param pArg [in] The argument of the task.
+ *
+ *  @return The result of the task.
+ */
+typedef u32 (* jf_threadpool_fnTask_t)(void * pArg);
+
+/** Define the function data type which is called in worker thread after the task is completed.
+ *
+ *  @param pArg [in] The argument of the task.
+ *  @param u32Result [in] The result of the task.
+ *
+ *  @return The error code, it's ignored.
+ */
+typedef u32 (* jf_threadpool_fnCompletion_t)(void * pArg, u32 u32Result);
+
+/** Define the function data type for parallel-for, it's called with a sub-range [u64Begin, u64End).
+ *
+ *  @param pArg [in] The argument of parallel-for.
+ *  @param u64Begin [in] The first index of the sub-range.
+ *  @param u64End [in] The index after the last index of the sub-range.
+ *
+ *  @return The error code.
+ */
+typedef u32 (* jf_threadpool_fnRange_t)(void * pArg, u64 u64Begin, u64 u64End);
+
+/** The parameter for creating thread pool.
+ */
+typedef struct
+{
+    /**Number of worker, it's the number of CPUs if it's 0.*/
+    u32 jtcp_u32NumOfWorker;
+    /**Size of the deque of worker, it's rounded up to power of 2. JF_THREADPOOL_DEF_DEQUE_SIZE is
+       used if it's 0.*/
+    u32 jtcp_u32DequeSize;
+    u32 jtcp_u32Reserved[6];
+} jf_threadpool_create_param_t;
+
+/* --- functional routines ---------------------------------------------------------------------- */
+
+/** Create a thread pool, the workers are started.
+ *
+ *  @param ppPool [out] The thread pool created.
+ *  @param pjtcp [in] The parameter for creating the thread pool.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_FAIL_CREATE_THREAD Failed to create worker thread.
+ */
+u32 jf_threadpool_create(jf_threadpool_t ** ppPool, jf_threadpool_create_param_t * pjtcp);
+
+/** Destroy the thread pool.
+ *
+ *  @note
+ *  -# The tasks in the pool are completed before the workers quit.
+ *  -# It must not be called by worker of the pool.
+ *
+ *  @param ppPool [in/out] The thread pool to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_threadpool_destroy(jf_threadpool_t ** ppPool);
+
+/** Get number of worker in the thread pool.
+ *
+ *  @param pPool [in] The thread pool.
+ *
+ *  @return Number of worker.
+ */
+u32 jf_threadpool_getNumOfWorker(jf_threadpool_t * pPool);
+
+/** Submit a task to the thread pool.
+ *
+ *  @param pPool [in] The thread pool.
+ *  @param fnTask [in] The task function.
+ *  @param pArg [in] The argument of the task.
+ *  @param fnCompletion [in] The function called after the task is completed, it can be NULL.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_THREADPOOL_TERMINATED The thread pool is being destroyed.
+ *  @retval JF_ERR_JIUKUN_OUT_OF_MEMORY Out of memory.
+ */
+u32 jf_threadpool_submit(
+    jf_threadpool_t * pPool, jf_threadpool_fnTask_t fnTask, void * pArg,
+    jf_threadpool_fnCompletion_t fnCompletion);
+
+/** Submit a task to the thread pool and return a future for the result.
+ *
+ *  @note
+ *  -# The future must be destroyed by jf_threadpool_destroyFuture().
+ *
+ *  @param pPool [in] The thread pool.
+ *  @param fnTask [in] The task function.
+ *  @param pArg [in] The argument of the task.
+ *  @param ppFuture [out] The future of the task.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ *  @retval JF_ERR_THREADPOOL_TERMINATED The thread pool is being destroyed.
+ *  @retval JF_ERR_JIUKUN_OUT_OF_MEMORY Out of memory.
+ */
+u32 jf_threadpool_submitWithFuture(
+    jf_threadpool_t * pPool, jf_threadpool_fnTask_t fnTask, void * pArg,
+    jf_threadpool_future_t ** ppFuture);
+
+/** Wait until the task of the future is completed.
+ *
+ *  @note
+ *  -# If it's called by worker, the worker runs other tasks when waiting.
+ *
+ *  @param pFuture [in] The future.
+ *  @param pu32Result [out] The result of the task, it can be NULL.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_threadpool_waitFuture(jf_threadpool_future_t * pFuture, u32 * pu32Result);
+
+/** Check if the task of the future is completed, the calling thread is not blocked.
+ *
+ *  @param pFuture [in] The future.
+ *
+ *  @return The status of the task.
+ *  @retval TRUE The task is completed.
+ *  @retval FALSE The task is not completed.
+ */
+boolean_t jf_threadpool_isFutureReady(jf_threadpool_future_t * pFuture);
+
+/** Destroy the future.
+ *
+ *  @note
+ *  -# The future can be destroyed before the task is completed, the result is dropped.
+ *
+ *  @param ppFuture [in/out] The future to be destroyed.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_threadpool_destroyFuture(jf_threadpool_future_t ** ppFuture);
+
+/** Run the function over index range [u64Begin, u64End) in parallel.
+ *
+ *  @note
+ *  -# The range is split into sub-ranges with u64Grain indexes, the sub-ranges are claimed by the
+ *   calling thread and workers dynamically.
+ *  -# The routine returns after all sub-ranges are completed.
+ *  -# If the function returns error, the sub-ranges not claimed yet are skipped and the first error
+ *   is returned.
+ *
+ *  @param pPool [in] The thread pool.
+ *  @param u64Begin [in] The first index.
+ *  @param u64End [in] The index after the last index.
+ *  @param u64Grain [in] Number of index in a sub-range, it's 1 if it's 0.
+ *  @param fnRange [in] The function for the sub-range.
+ *  @param pArg [in] The argument of the function.
+ *
+ *  @return The error code.
+ *  @retval JF_ERR_NO_ERROR Success.
+ */
+u32 jf_threadpool_parallelFor(
+    jf_threadpool_t * pPool, u64 u64Begin, u64 u64End, u64 u64Grain,
+    jf_threadpool_fnRange_t fnRange, void * pArg);
+
+#endif /*JIUTAI_THREADPOOL_H*/
+
+/*------------------------------------------------------------------------------------------------*/
@@ -141,7 +141,8 @@ u32 jf_time_getClockTime(jf_time_clock_t clkid, jf_time_spec_t * pjts)
 #elif defined(WINDOWS)
     u64 u64Time = 0;
 
-    if ((clkid == JF_TIME_CLOCK_MONOTONIC) || (clkid == JF_TIME_CLOCK_MONOTONIC_RAW))
+    if ((clkid == JF_TIME_CLOCK_MONOTONIC) || (clkid == JF_TIME_CLOCK_MONOTONIC_RAW) ||
+        (clkid == JF_TIME_CLOCK_MONOTONIC_COARSE))
     {
         /*Retrieves the number of milliseconds that have elapsed since the system was started.*/
         u64Time = (u64)GetTickCount64();
@@ -48,6 +48,10 @@ typedef enum
     JF_TIME_CLOCK_THREAD_CPUTIME_ID = CLOCK_THREAD_CPUTIME_ID,
     /**Monotonic raw clock id.*/
     JF_TIME_CLOCK_MONOTONIC_RAW = CLOCK_MONOTONIC_RAW,
+    /**Coarse real time clock id, it's faster but updated only on ticks.*/
+    JF_TIME_CLOCK_REALTIME_COARSE = CLOCK_REALTIME_COARSE,
+    /**Coarse monotonic clock id, it's faster but updated only on ticks.*/
+    JF_TIME_CLOCK_MONOTONIC_COARSE = CLOCK_MONOTONIC_COARSE,
 #elif defined(WINDOWS)
     /**Real time clock id.*/
     JF_TIME_CLOCK_REALTIME = 0,
@@ -59,6 +63,10 @@ typedef enum
     JF_TIME_CLOCK_THREAD_CPUTIME_ID,
     /**Monotonic raw clock id.*/
     JF_TIME_CLOCK_MONOTONIC_RAW,
+    /**Coarse real time clock id, it's faster but updated only on ticks.*/
+    JF_TIME_CLOCK_REALTIME_COARSE,
+    /**Coarse monotonic clock id, it's faster but updated only on ticks.*/
+    JF_TIME_CLOCK_MONOTONIC_COARSE,
 #endif
 } jf_time_clock_t;
 
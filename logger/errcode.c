@@ -88,6 +88,8 @@ static internal_error_code_desc_t ls_iecdErrorCodeDesc[] =
 
 /* queue error */
     {JF_ERR_FAIL_CREATE_QUEUE, "Failed to creat queue."},
+    {JF_ERR_QUEUE_FULL, "Queue is full."},
+    {JF_ERR_QUEUE_EMPTY, "Queue is empty."},
 /* mem error */
     {JF_ERR_OUT_OF_MEMORY, "Out of memory."},
 /* array error */
@@ -100,6 +102,8 @@ static internal_error_code_desc_t ls_iecdErrorCodeDesc[] =
 /* respool error */
     {JF_ERR_RESOURCE_BUSY, "The requested resource is busy."},
 /* hash error */
+    {JF_ERR_HASH_ENTRY_NOT_FOUND, "Hash entry is not found."},
+    {JF_ERR_HASH_ENTRY_ALREADY_EXIST, "Hash entry already exists."},
 
 /* conffile error */
 
@@ -118,6 +122,7 @@ static internal_error_code_desc_t ls_iecdErrorCodeDesc[] =
     {JF_ERR_FAIL_INIT_SOCKET, "Failed to initialize socket."},
     {JF_ERR_FAIL_FINI_SOCKET, "Failed to initialize socket."},
 /* thread error */
+    {JF_ERR_THREADPOOL_TERMINATED, "Thread pool is terminated."},
     {JF_ERR_FAIL_CREATE_THREAD, "Failed to create thread."},
     {JF_ERR_FAIL_STOP_THREAD, "Failed to stop thread."},
     {JF_ERR_FAIL_WAIT_THREAD_TERMINATION, "Failed to wait thread termination."},
@@ -261,6 +266,7 @@ static internal_error_code_desc_t ls_iecdErrorCodeDesc[] =
     {JF_ERR_JIUKUN_MEMORY_LEAK, "Jiukun memory leak is detected."},
     {JF_ERR_JIUKUN_MEMORY_CORRUPTED, "Jiukun memory is corrupted."},
     {JF_ERR_JIUKUN_MEMORY_OUT_OF_BOUND, "Jiukun memory access is out of bound."},
+    {JF_ERR_FAIL_EXTEND_JIUKUN_PAGE, "Failed to extend jiukun page in place."},
 /* ifmgmt error */
     {JF_ERR_INVALID_IP, "Invalid IP address."},
     {JF_ERR_INVALID_IP_ADDR_TYPE, "Invalid IP address type."},
@@ -32,6 +32,11 @@ else
     CFLAGS += -DNDEBUG
 endif
 
+# Mutex contention profiler, all objects must be built with the same flag.
+ifeq ("$(PROFILE_MUTEX)", "yes")
+    CFLAGS += -DJF_MUTEX_PROFILE
+endif
+
 # C++ flags.
 CXXFLAGS = $(CFLAGS)
 
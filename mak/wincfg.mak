@@ -65,6 +65,11 @@ LDFLAGS = $(LDFLAGS) /RELEASE
 DLLFLAGS = $(DLLFLAGS) /RELEASE
 !endif
 
+# Mutex contention profiler, all objects must be built with the same flag.
+!if "$(PROFILE_MUTEX)" == "yes"
+CFLAGS = $(CFLAGS) /DJF_MUTEX_PROFILE
+!endif
+
 # C++ flags.
 CXXFLAGS = $(CFLAGS)
 
@@ -205,6 +205,80 @@ static u32 _testArray(void)
     return u32Ret;
 }
 
+#define NUM_OF_TEST_LARGE_ARRAY_DATA     (100000)
+
+static u32 _testLargeArray(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_array_t * pjaArray = NULL;
+    jf_array_element_t * pjae = NULL;
+    u32 index = 0;
+
+    ol_printf("---------------------------------------------------------------------------\n");
+    ol_printf("Append %u elements to array.\n", NUM_OF_TEST_LARGE_ARRAY_DATA);
+    u32Ret = jf_array_create(&pjaArray);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    /*The element is the index, it's not accessed.*/
+    for (index = 0; (u32Ret == JF_ERR_NO_ERROR) && (index < NUM_OF_TEST_LARGE_ARRAY_DATA); index ++)
+        u32Ret = jf_array_appendElementTo(pjaArray, (jf_array_element_t *)(ulong)index);
+
+    for (index = 0; (u32Ret == JF_ERR_NO_ERROR) && (index < NUM_OF_TEST_LARGE_ARRAY_DATA); index ++)
+    {
+        u32Ret = jf_array_getElementAt(pjaArray, index, &pjae);
+        if ((u32Ret == JF_ERR_NO_ERROR) && ((ulong)pjae != index))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("Swap remove the first element.\n");
+        u32Ret = jf_array_swapRemoveElementAt(pjaArray, 0);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_array_getElementAt(pjaArray, 0, &pjae);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (((ulong)pjae != NUM_OF_TEST_LARGE_ARRAY_DATA - 1) ||
+         (jf_array_getSize(pjaArray) != NUM_OF_TEST_LARGE_ARRAY_DATA - 1)))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("Remove the second element.\n");
+        u32Ret = jf_array_removeElementAt(pjaArray, 1);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_array_getElementAt(pjaArray, 1, &pjae);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && ((ulong)pjae != 2))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_array_getElementAt(pjaArray, NUM_OF_TEST_LARGE_ARRAY_DATA - 2, &pjae) !=
+         JF_ERR_OUT_OF_RANGE))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("Remove all elements and reserve memory.\n");
+        jf_array_removeAllElements(pjaArray);
+        u32Ret = jf_array_reserve(pjaArray, NUM_OF_TEST_LARGE_ARRAY_DATA * 2);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_array_getSize(pjaArray) != 0))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    jf_array_destroy(&pjaArray);
+
+    ol_printf("Large array test: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 olint_t main(olint_t argc, olchar_t ** argv)
@@ -231,6 +305,8 @@ olint_t main(olint_t argc, olchar_t ** argv)
             if (ls_bTestArray)
             {
                 u32Ret = _testArray();
+                if (u32Ret == JF_ERR_NO_ERROR)
+                    u32Ret = _testLargeArray();
             }
             else
             {
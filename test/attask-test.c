@@ -6,11 +6,15 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The default test adds items with random delay, removes some of them by handle or data, and
+ *   checks no item is triggered before its expire time and the removed items are never triggered.
+ *   Then the add and remove operations are benchmarked.
+ *  -# Use "-l" to run the demo loop until a signal is received.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -22,15 +26,107 @@
 #include "jf_jiukun.h"
 #include "jf_attask.h"
 #include "jf_process.h"
+#include "jf_option.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Number of item in the functional test.
+ */
+#define ATTASK_TEST_NUM_OF_ITEM           (2000)
+
+/** Maximum delay in milli-second of item in the functional test.
+ */
+#define ATTASK_TEST_MAX_DELAY             (1500)
+
+/** Number of item in the benchmark.
+ */
+#define ATTASK_TEST_NUM_OF_BENCH_ITEM     (100000)
+
+/** Define the item data type for the functional test.
+ */
+typedef struct
+{
+    /**Expire time in milli-second.*/
+    u64 tai_u64Expire;
+    /**The item is removed.*/
+    boolean_t tai_bRemoved;
+    /**The item is triggered.*/
+    boolean_t tai_bTriggered;
+    /**The item is destroyed.*/
+    boolean_t tai_bDestroyed;
+    u8 tai_u8Reserved[5];
+    /**Handle of the item.*/
+    jf_attask_handle_t tai_handle;
+} test_attask_item_t;
+
 static boolean_t ls_bToTerminateTestAttask = FALSE;
 
 static u32 ls_u32TestAttaskIndex = 0;
 
+static boolean_t ls_bTestAttaskLoop = FALSE;
+
+static test_attask_item_t ls_taiTestAttaskItem[ATTASK_TEST_NUM_OF_ITEM];
+
+static u32 ls_u32TestAttaskError = 0;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static void _printAttaskTestUsage(void)
+{
+    ol_printf("\
+Usage: attask-test [-l] [-h]\n\
+  -l: run the demo loop until a signal is received.\n\
+  -h: print the usage.\n");
+
+    ol_printf("\n");
+}
+
+static u32 _parseAttaskTestCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt = 0;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "lh")) != -1))
+    {
+        switch (nOpt)
+        {
+        case ':':
+        case '?':
+        case 'h':
+            _printAttaskTestUsage();
+            exit(0);
+            break;
+        case 'l':
+            ls_bTestAttaskLoop = TRUE;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static u64 _getAttaskTestMilliTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC_RAW, &jts);
+
+    return jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND +
+        jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND;
+}
+
+static u64 _getAttaskTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
 static void _terminate(olint_t signal)
 {
     ol_printf("get signal\n");
@@ -106,11 +202,219 @@ static u32 _enterTestAttaskLoop(jf_attask_t * pAttask)
     return u32Ret;
 }
 
+static u32 _onCallbackOfAttaskTestItem(void * pData)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_attask_item_t * ptai = pData;
+
+    if (ptai->tai_bRemoved || ptai->tai_bTriggered)
+    {
+        ol_printf("item %ld is triggered unexpectedly\n", (long)(ptai - ls_taiTestAttaskItem));
+        ls_u32TestAttaskError ++;
+    }
+
+    if (_getAttaskTestMilliTime() < ptai->tai_u64Expire)
+    {
+        ol_printf("item %ld is triggered early\n", (long)(ptai - ls_taiTestAttaskItem));
+        ls_u32TestAttaskError ++;
+    }
+
+    ptai->tai_bTriggered = TRUE;
+
+    return u32Ret;
+}
+
+static u32 _destroyAttaskTestItemData(void ** ppData)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_attask_item_t * ptai = *ppData;
+
+    if (ptai->tai_bDestroyed)
+        ls_u32TestAttaskError ++;
+
+    ptai->tai_bDestroyed = TRUE;
+
+    return u32Ret;
+}
+
+static u32 _addAttaskTestItems(jf_attask_t * pAttask)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0, u32Delay = 0;
+    test_attask_item_t * ptai = NULL;
+
+    for (u32Index = 0; (u32Index < ATTASK_TEST_NUM_OF_ITEM) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        ptai = &ls_taiTestAttaskItem[u32Index];
+        u32Delay = jf_rand_getU32InRange(0, ATTASK_TEST_MAX_DELAY);
+        ptai->tai_u64Expire = _getAttaskTestMilliTime() + u32Delay;
+
+        u32Ret = jf_attask_addItemWithHandle(
+            pAttask, ptai, u32Delay, _onCallbackOfAttaskTestItem, _destroyAttaskTestItemData,
+            &ptai->tai_handle);
+    }
+
+    /*Remove every 4th item by handle, and every 7th item by data.*/
+    for (u32Index = 0; (u32Index < ATTASK_TEST_NUM_OF_ITEM) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        ptai = &ls_taiTestAttaskItem[u32Index];
+        if (u32Index % 4 == 0)
+            u32Ret = jf_attask_removeItemByHandle(pAttask, ptai->tai_handle);
+        else if (u32Index % 7 == 0)
+            u32Ret = jf_attask_removeItem(pAttask, ptai);
+        else
+            continue;
+
+        ptai->tai_bRemoved = TRUE;
+        /*The handle is invalid after the item is removed.*/
+        if ((u32Ret == JF_ERR_NO_ERROR) &&
+            (jf_attask_removeItemByHandle(pAttask, ptai->tai_handle) == JF_ERR_NO_ERROR))
+            ls_u32TestAttaskError ++;
+    }
+
+    return u32Ret;
+}
+
+static u32 _verifyAttaskTestItems(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0;
+    test_attask_item_t * ptai = NULL;
+
+    for (u32Index = 0; u32Index < ATTASK_TEST_NUM_OF_ITEM; u32Index ++)
+    {
+        ptai = &ls_taiTestAttaskItem[u32Index];
+        if ((ptai->tai_bRemoved == ptai->tai_bTriggered) || ! ptai->tai_bDestroyed)
+        {
+            ol_printf("item %u is not handled correctly\n", u32Index);
+            ls_u32TestAttaskError ++;
+        }
+    }
+
+    if (ls_u32TestAttaskError != 0)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static u32 _testAttaskWheel(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_attask_t * pAttask = NULL;
+    u32 u32Blocktime = 0, u32Check = 0;
+    u64 u64End = 0, u64Now = 0;
+
+    ol_printf("Testing attask with %u items, max delay %u ms\n", ATTASK_TEST_NUM_OF_ITEM,
+              ATTASK_TEST_MAX_DELAY);
+
+    u32Ret = jf_attask_create(&pAttask);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _addAttaskTestItems(pAttask);
+
+    u64End = _getAttaskTestMilliTime() + ATTASK_TEST_MAX_DELAY;
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((u64Now = _getAttaskTestMilliTime()) <= u64End))
+    {
+        u32Ret = jf_attask_check(pAttask, &u32Blocktime);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            u32Check ++;
+            /*The default block time is returned if all items are triggered.*/
+            jf_time_milliSleep((u32)MIN(u32Blocktime, u64End + 1 - u64Now));
+        }
+    }
+
+    /*Trigger the items expired during the last sleep.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_attask_check(pAttask, &u32Blocktime);
+
+    if (pAttask != NULL)
+        jf_attask_destroy(&pAttask);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _verifyAttaskTestItems();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass, %u checks\n", u32Check);
+
+    return u32Ret;
+}
+
+static u32 _destroyAttaskBenchItemData(void ** ppData)
+{
+    *ppData = NULL;
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _benchAttask(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_attask_t * pAttask = NULL;
+    jf_attask_handle_t * pHandle = NULL;
+    u32 u32Index = 0;
+    u64 u64Start = 0, u64Add = 0, u64Remove = 0;
+
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pHandle, ATTASK_TEST_NUM_OF_BENCH_ITEM * sizeof(jf_attask_handle_t));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_attask_create(&pAttask);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getAttaskTestNanoTime();
+        for (u32Index = 0;
+             (u32Index < ATTASK_TEST_NUM_OF_BENCH_ITEM) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Index ++)
+            u32Ret = jf_attask_addItemWithHandle(
+                pAttask, &pHandle[u32Index], jf_rand_getU32InRange(1, 3600000),
+                _onCallbackOfTestAttaskItem, _destroyAttaskBenchItemData, &pHandle[u32Index]);
+        u64Add = _getAttaskTestNanoTime() - u64Start;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Remove in reverse order, the cost doesn't depend on the position of the item.*/
+        u64Start = _getAttaskTestNanoTime();
+        for (u32Index = ATTASK_TEST_NUM_OF_BENCH_ITEM;
+             (u32Index > 0) && (u32Ret == JF_ERR_NO_ERROR); u32Index --)
+            u32Ret = jf_attask_removeItemByHandle(pAttask, pHandle[u32Index - 1]);
+        u64Remove = _getAttaskTestNanoTime() - u64Start;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf(
+            "Benchmark %u items: add %llu ns/op, remove by handle %llu ns/op\n",
+            ATTASK_TEST_NUM_OF_BENCH_ITEM, u64Add / ATTASK_TEST_NUM_OF_BENCH_ITEM,
+            u64Remove / ATTASK_TEST_NUM_OF_BENCH_ITEM);
+
+    if (pAttask != NULL)
+        jf_attask_destroy(&pAttask);
+
+    if (pHandle != NULL)
+        jf_jiukun_freeMemory((void **)&pHandle);
+
+    return u32Ret;
+}
+
 static u32 _testAttask(void)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     jf_attask_t * pAttask = NULL;
 
+    if (! ls_bTestAttaskLoop)
+    {
+        u32Ret = _testAttaskWheel();
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _benchAttask();
+
+        return u32Ret;
+    }
+
     u32Ret = jf_attask_create(&pAttask);
 
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -131,6 +435,14 @@ olint_t main(olint_t argc, olchar_t ** argv)
     jf_logger_init_param_t jlipParam;
     jf_jiukun_init_param_t jjip;
 
+    u32Ret = _parseAttaskTestCmdLineParam(argc, argv);
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        jf_err_readDescription(u32Ret, strErrMsg, 300);
+        ol_printf("%s\n", strErrMsg);
+        return u32Ret;
+    }
+
     ol_bzero(&jlipParam, sizeof(jlipParam));
     jlipParam.jlip_pstrCallerName = "ATTASK-TEST";
     jlipParam.jlip_bLogToStdout = TRUE;
@@ -17,6 +17,8 @@
 #include "jf_basic.h"
 #include "jf_err.h"
 #include "jf_bitarray.h"
+#include "jf_bitmap.h"
+#include "jf_jiukun.h"
 #include "jf_string.h"
 #include "jf_option.h"
 
@@ -24,14 +26,21 @@
 
 static boolean_t ls_bSizeof = FALSE;
 
+static boolean_t ls_bBitmap = FALSE;
+
+/** Size of bitmap tested, the sizes around word boundary are tested.
+ */
+static u32 ls_u32TestBitmapSize[] = {1, 63, 64, 65, 127, 1000, 4096, 100003};
+
 /* --- private routine section ------------------------------------------------------------------ */
 
 static void _printBitarrayTestUsage(void)
 {
     ol_printf("\
-Usage: bitarray-test [-h] [-t]\n\
+Usage: bitarray-test [-h] [-t] [-m]\n\
   -h: show this usage\n\
   -t: test sizeof on local machine\n\
+  -m: test bitmap\n\
   By default, basic function of bit array is tested.\n");
     ol_printf("\n");
 }
@@ -41,7 +50,7 @@ static u32 _parseBitarrayTestCmdLineParam(olint_t argc, olchar_t ** argv)
     u32 u32Ret = JF_ERR_NO_ERROR;
     olint_t nOpt;
 
-    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "th?")) != -1))
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "tmh?")) != -1))
     {
         switch (nOpt)
         {
@@ -56,6 +65,9 @@ static u32 _parseBitarrayTestCmdLineParam(olint_t argc, olchar_t ** argv)
         case 't':
             ls_bSizeof = TRUE;
             break;
+        case 'm':
+            ls_bBitmap = TRUE;
+            break;
         default:
             u32Ret = JF_ERR_INVALID_OPTION;
             break;
@@ -244,6 +256,250 @@ static u32 _testBitArray(void)
     return u32Ret;
 }
 
+/** Get a pseudo random number for bitmap test, the sequence is the same for each run.
+ */
+static u32 _getBitmapTestRandom(u32 * pu32Seed)
+{
+    *pu32Seed = *pu32Seed * 1103515245 + 12345;
+
+    return *pu32Seed >> 8;
+}
+
+/** Check the bitmap against the reference array with one byte for each bit.
+ */
+static u32 _checkBitmap(jf_bitmap_t * pBitmap, u8 * pu8Ref, u32 u32Size)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index, u32Count = 0, u32Pos, u32Expect;
+
+    for (u32Index = 0; (u32Index < u32Size) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        if (jf_bitmap_testBit(pBitmap, u32Index) != pu8Ref[u32Index])
+            u32Ret = JF_ERR_INVALID_DATA;
+
+        u32Count += pu8Ref[u32Index];
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_bitmap_countSetBit(pBitmap) != u32Count))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    /*Walk through the set bits and the zero bits.*/
+    for (u32Index = 0; (u32Index < u32Size) && (u32Ret == JF_ERR_NO_ERROR); u32Index += 7)
+    {
+        for (u32Expect = u32Index; (u32Expect < u32Size) && (! pu8Ref[u32Expect]); u32Expect ++)
+            ;
+        if (jf_bitmap_findNextSetBit(pBitmap, u32Index, &u32Pos) != JF_ERR_NO_ERROR)
+            u32Pos = u32Size;
+        if (u32Pos != u32Expect)
+            u32Ret = JF_ERR_INVALID_DATA;
+
+        for (u32Expect = u32Index; (u32Expect < u32Size) && pu8Ref[u32Expect]; u32Expect ++)
+            ;
+        if (jf_bitmap_findNextZeroBit(pBitmap, u32Index, &u32Pos) != JF_ERR_NO_ERROR)
+            u32Pos = u32Size;
+        if (u32Pos != u32Expect)
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    return u32Ret;
+}
+
+static u32 _testBitmapWithSize(u32 u32Size)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_bitmap_t * pBitmap[3] = {NULL, NULL, NULL};
+    u8 * pu8Ref[3] = {NULL, NULL, NULL};
+    u32 u32Index, u32Map, u32Start, u32Count, u32Pos;
+    u32 u32Seed = u32Size;
+
+    for (u32Map = 0; (u32Map < 3) && (u32Ret == JF_ERR_NO_ERROR); u32Map ++)
+    {
+        u32Ret = jf_bitmap_create(&pBitmap[u32Map], u32Size);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_jiukun_allocMemory((void **)&pu8Ref[u32Map], u32Size);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            ol_bzero(pu8Ref[u32Map], u32Size);
+    }
+
+    /*Set random bits and random ranges.*/
+    for (u32Map = 0; (u32Map < 3) && (u32Ret == JF_ERR_NO_ERROR); u32Map ++)
+    {
+        for (u32Index = 0; u32Index < u32Size / 3 + 1; u32Index ++)
+        {
+            u32Pos = _getBitmapTestRandom(&u32Seed) % u32Size;
+            jf_bitmap_setBit(pBitmap[u32Map], u32Pos);
+            pu8Ref[u32Map][u32Pos] = 1;
+        }
+
+        u32Start = _getBitmapTestRandom(&u32Seed) % u32Size;
+        u32Count = _getBitmapTestRandom(&u32Seed) % (u32Size - u32Start + 1);
+        u32Ret = jf_bitmap_setRange(pBitmap[u32Map], u32Start, u32Count);
+        ol_memset(&pu8Ref[u32Map][u32Start], 1, u32Count);
+
+        u32Start = _getBitmapTestRandom(&u32Seed) % u32Size;
+        u32Count = _getBitmapTestRandom(&u32Seed) % (u32Size - u32Start + 1);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_bitmap_clearRange(pBitmap[u32Map], u32Start, u32Count);
+        ol_memset(&pu8Ref[u32Map][u32Start], 0, u32Count);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[u32Map], pu8Ref[u32Map], u32Size);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_bitmap_setRange(pBitmap[0], u32Size, 1) != JF_ERR_OUT_OF_RANGE))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_bitmap_and(pBitmap[2], pBitmap[0], pBitmap[1]);
+        for (u32Index = 0; u32Index < u32Size; u32Index ++)
+            pu8Ref[2][u32Index] = pu8Ref[0][u32Index] & pu8Ref[1][u32Index];
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[2], pu8Ref[2], u32Size);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_bitmap_or(pBitmap[2], pBitmap[0], pBitmap[1]);
+        for (u32Index = 0; u32Index < u32Size; u32Index ++)
+            pu8Ref[2][u32Index] = pu8Ref[0][u32Index] | pu8Ref[1][u32Index];
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[2], pu8Ref[2], u32Size);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_bitmap_xor(pBitmap[2], pBitmap[0], pBitmap[1]);
+        for (u32Index = 0; u32Index < u32Size; u32Index ++)
+            pu8Ref[2][u32Index] = pu8Ref[0][u32Index] ^ pu8Ref[1][u32Index];
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[2], pu8Ref[2], u32Size);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The destination is one of the sources.*/
+        u32Ret = jf_bitmap_andNot(pBitmap[0], pBitmap[0], pBitmap[1]);
+        for (u32Index = 0; u32Index < u32Size; u32Index ++)
+            pu8Ref[0][u32Index] = pu8Ref[0][u32Index] & ! pu8Ref[1][u32Index];
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[0], pu8Ref[0], u32Size);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_bitmap_setAll(pBitmap[1]);
+        ol_memset(pu8Ref[1], 1, u32Size);
+        u32Ret = _checkBitmap(pBitmap[1], pu8Ref[1], u32Size);
+        if ((u32Ret == JF_ERR_NO_ERROR) &&
+            (jf_bitmap_findFirstZeroBit(pBitmap[1], &u32Pos) != JF_ERR_NOT_FOUND))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Shrink and enlarge the bitmap, the enlarged bits are cleared.*/
+        u32Count = u32Size / 2 + 1;
+        u32Ret = jf_bitmap_resize(pBitmap[1], u32Count);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_bitmap_resize(pBitmap[1], u32Size);
+        ol_memset(&pu8Ref[1][u32Count], 0, u32Size - u32Count);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _checkBitmap(pBitmap[1], pu8Ref[1], u32Size);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_bitmap_clearAll(pBitmap[2]);
+        if ((jf_bitmap_findFirstSetBit(pBitmap[2], &u32Pos) != JF_ERR_NOT_FOUND) ||
+            (jf_bitmap_countSetBit(pBitmap[2]) != 0))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    for (u32Map = 0; u32Map < 3; u32Map ++)
+    {
+        if (pBitmap[u32Map] != NULL)
+            jf_bitmap_destroy(&pBitmap[u32Map]);
+        if (pu8Ref[u32Map] != NULL)
+            jf_jiukun_freeMemory((void **)&pu8Ref[u32Map]);
+    }
+
+    return u32Ret;
+}
+
+/** Allocate ID with bitmap, the ID is the first zero bit.
+ */
+static u32 _testBitmapIdAllocation(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_bitmap_t * pBitmap = NULL;
+    u32 u32Index, u32Id;
+
+    u32Ret = jf_bitmap_create(&pBitmap, 200);
+    for (u32Index = 0; (u32Index < 200) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        u32Ret = jf_bitmap_findFirstZeroBit(pBitmap, &u32Id);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            if (u32Id != u32Index)
+                u32Ret = JF_ERR_INVALID_DATA;
+            jf_bitmap_setBit(pBitmap, u32Id);
+        }
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_bitmap_findFirstZeroBit(pBitmap, &u32Id) != JF_ERR_NOT_FOUND))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Free 2 IDs, they are allocated again in order.*/
+        jf_bitmap_clearBit(pBitmap, 150);
+        jf_bitmap_clearBit(pBitmap, 70);
+        u32Ret = jf_bitmap_findFirstZeroBit(pBitmap, &u32Id);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (u32Id != 70))
+            u32Ret = JF_ERR_INVALID_DATA;
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_bitmap_findNextZeroBit(pBitmap, u32Id + 1, &u32Id);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (u32Id != 150))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    if (pBitmap != NULL)
+        jf_bitmap_destroy(&pBitmap);
+
+    return u32Ret;
+}
+
+static u32 _testBitmap(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index;
+    jf_bitmap_t * pBitmap = NULL;
+
+    if (jf_bitmap_create(&pBitmap, 0) != JF_ERR_INVALID_PARAM)
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    for (u32Index = 0;
+         (u32Index < ARRAY_SIZE(ls_u32TestBitmapSize)) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        ol_printf("test bitmap with %u bits\n", ls_u32TestBitmapSize[u32Index]);
+        u32Ret = _testBitmapWithSize(ls_u32TestBitmapSize[u32Index]);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("test ID allocation with bitmap\n");
+        u32Ret = _testBitmapIdAllocation();
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("bitmap test passed\n");
+
+    return u32Ret;
+}
+
 static void _testSizeof(void)
 {
     jf_bitarray_t a[20];
@@ -266,6 +522,7 @@ olint_t main(olint_t argc, olchar_t ** argv)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
     olchar_t strErrMsg[300];
+    jf_jiukun_init_param_t jjip;
 
     u32Ret = _parseBitarrayTestCmdLineParam(argc, argv);
     if (u32Ret == JF_ERR_NO_ERROR)
@@ -274,6 +531,19 @@ olint_t main(olint_t argc, olchar_t ** argv)
         {
             _testSizeof();
         }
+        else if (ls_bBitmap)
+        {
+            ol_bzero(&jjip, sizeof(jjip));
+            jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
+
+            u32Ret = jf_jiukun_init(&jjip);
+            if (u32Ret == JF_ERR_NO_ERROR)
+            {
+                u32Ret = _testBitmap();
+
+                jf_jiukun_fini();
+            }
+        }
         else
         {
             _testBitArray();
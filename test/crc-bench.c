@@ -0,0 +1,288 @@
+/**
+ *  @file crc-bench.c
+ *
+ *  @brief Benchmark file for crc32c defined in jf_crc common object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The benchmark compares jf_crc_crc32c() with the byte-wise table calculation for buffers
+ *   with different size, the throughput is printed in MB/s.
+ *  -# The results are compared before measuring, the benchmark fails if they are different.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_crc.h"
+#include "jf_time.h"
+#include "jf_option.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Default number of bytes processed for each buffer size.
+ */
+#define CRC_BENCH_DEFAULT_TOTAL_MB        (256)
+
+/** The buffer sizes benchmarked if not specified.
+ */
+static u32 ls_u32CrcBenchSize[] =
+{
+    64,
+    1024,
+    64 * 1024,
+    1024 * 1024,
+};
+
+/** The buffer size specified by user, 0 means all sizes in the list.
+ */
+static u32 ls_u32CrcBenchBufferSize = 0;
+
+/** Number of MB processed for each buffer size.
+ */
+static u32 ls_u32CrcBenchTotalMb = CRC_BENCH_DEFAULT_TOTAL_MB;
+
+/** Print the result in JSON format if it's TRUE.
+ */
+static boolean_t ls_bCrcBenchJson = FALSE;
+
+/** The table for byte-wise calculation.
+ */
+static u32 ls_u32CrcBenchTable[256];
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static void _printCrcBenchUsage(void)
+{
+    ol_printf("\
+Usage: crc-bench [-s size] [-c MB] [-j] [-h]\n\
+  -s: the size of buffer in bytes, 64, 1K, 64K and 1M are benchmarked if not specified.\n\
+  -c: number of MB processed for each buffer size, default is %u.\n\
+  -j: print the result in JSON format.\n", CRC_BENCH_DEFAULT_TOTAL_MB);
+
+    ol_printf("\n");
+}
+
+static u32 _parseCrcBenchCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt = 0;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) &&
+           ((nOpt = jf_option_get(argc, argv, "s:c:jh")) != -1))
+    {
+        switch (nOpt)
+        {
+        case ':':
+        case '?':
+        case 'h':
+            _printCrcBenchUsage();
+            exit(0);
+            break;
+        case 's':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32CrcBenchBufferSize);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32CrcBenchBufferSize == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'c':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32CrcBenchTotalMb);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32CrcBenchTotalMb == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'j':
+            ls_bCrcBenchJson = TRUE;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static inline u64 _getCrcBenchNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static void _initCrcBenchTable(void)
+{
+    u32 u32Index, u32Bit, u32Crc;
+
+    for (u32Index = 0; u32Index < 256; u32Index ++)
+    {
+        u32Crc = u32Index;
+        for (u32Bit = 0; u32Bit < 8; u32Bit ++)
+            u32Crc = (u32Crc & 1) ? (u32Crc >> 1) ^ 0x82F63B78 : u32Crc >> 1;
+        ls_u32CrcBenchTable[u32Index] = u32Crc;
+    }
+}
+
+static void _crc32cByByte(u8 * pu8Data, u32 u32Len, u32 u32Flags, u32 * pu32Result)
+{
+    u32 u32Crc = 0xFFFFFFFF;
+
+    while (u32Len-- > 0)
+        u32Crc = ls_u32CrcBenchTable[(u32Crc ^ *pu8Data++) & 0xFF] ^ (u32Crc >> 8);
+
+    *pu32Result = u32Crc ^ 0xFFFFFFFF;
+}
+
+static void _printCrcBenchCpuFeature(void)
+{
+    if (ls_bCrcBenchJson)
+        return;
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init();
+    ol_printf(
+        "CPU features: sse4.2 %s, pclmul %s\n",
+        __builtin_cpu_supports("sse4.2") ? "yes" : "no",
+        __builtin_cpu_supports("pclmul") ? "yes" : "no");
+#else
+    ol_printf("CPU features: no hardware acceleration\n");
+#endif
+}
+
+static double _benchCrc32cRoutine(
+    void (* fnCrc32c)(u8 *, u32, u32, u32 *), u8 * pu8Buffer, u32 u32Size, u32 * pu32Result)
+{
+    u64 u64Total = (u64)ls_u32CrcBenchTotalMb * 1024 * 1024;
+    u64 u64Loop = u64Total / u32Size, u64Index, u64Start, u64Elapsed;
+    u32 u32Result = 0;
+
+    if (u64Loop == 0)
+        u64Loop = 1;
+
+    u64Start = _getCrcBenchNanoTime();
+    for (u64Index = 0; u64Index < u64Loop; u64Index ++)
+    {
+        /*Chain the result so the calls cannot be merged by compiler.*/
+        pu8Buffer[0] = (u8)u32Result;
+        fnCrc32c(
+            pu8Buffer, u32Size,
+            JF_CRC_CRC32C_FLAG_INIT_RESULT | JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER, &u32Result);
+    }
+    u64Elapsed = _getCrcBenchNanoTime() - u64Start;
+    if (u64Elapsed == 0)
+        u64Elapsed = 1;
+
+    *pu32Result = u32Result;
+
+    /*Bytes per nanosecond to MB per second.*/
+    return (double)(u64Loop * u32Size) * 1000000000.0 / (double)u64Elapsed / (1024.0 * 1024.0);
+}
+
+static u32 _benchCrc32cSize(u8 * pu8Buffer, u32 u32Size, boolean_t bFirst)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Expected, u32Result;
+    double dbByte, dbCrc;
+
+    /*Cross check before measuring.*/
+    _crc32cByByte(pu8Buffer, u32Size, 0, &u32Expected);
+    jf_crc_crc32c(
+        pu8Buffer, u32Size, JF_CRC_CRC32C_FLAG_INIT_RESULT | JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER,
+        &u32Result);
+    if (u32Result != u32Expected)
+    {
+        ol_printf("size %u, CRC mismatch: 0x%X, expected 0x%X\n", u32Size, u32Result, u32Expected);
+        return JF_ERR_PROGRAM_ERROR;
+    }
+
+    dbByte = _benchCrc32cRoutine(_crc32cByByte, pu8Buffer, u32Size, &u32Expected);
+    dbCrc = _benchCrc32cRoutine(jf_crc_crc32c, pu8Buffer, u32Size, &u32Result);
+    if (u32Result != u32Expected)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (ls_bCrcBenchJson)
+        ol_printf(
+            "%s{\"size\": %u, \"bytewise_mbps\": %.1f, \"crc32c_mbps\": %.1f}",
+            bFirst ? "" : ",\n  ", u32Size, dbByte, dbCrc);
+    else
+        ol_printf(
+            "%10u %16.1f %16.1f %8.1fx\n", u32Size, dbByte, dbCrc, dbCrc / dbByte);
+
+    return u32Ret;
+}
+
+static u32 _benchCrc32c(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index, u32MaxSize = 0;
+    u8 * pu8Buffer = NULL;
+
+    _initCrcBenchTable();
+    _printCrcBenchCpuFeature();
+
+    for (u32Index = 0; u32Index < ARRAY_SIZE(ls_u32CrcBenchSize); u32Index ++)
+        u32MaxSize = MAX(u32MaxSize, ls_u32CrcBenchSize[u32Index]);
+    u32MaxSize = MAX(u32MaxSize, ls_u32CrcBenchBufferSize);
+
+    pu8Buffer = malloc(u32MaxSize);
+    if (pu8Buffer == NULL)
+        return JF_ERR_OUT_OF_MEMORY;
+
+    srand(1);
+    for (u32Index = 0; u32Index < u32MaxSize; u32Index ++)
+        pu8Buffer[u32Index] = (u8)rand();
+
+    if (ls_bCrcBenchJson)
+        ol_printf("[");
+    else
+        ol_printf("%10s %16s %16s %9s\n", "size", "byte-wise MB/s", "crc32c MB/s", "speedup");
+
+    if (ls_u32CrcBenchBufferSize != 0)
+    {
+        u32Ret = _benchCrc32cSize(pu8Buffer, ls_u32CrcBenchBufferSize, TRUE);
+    }
+    else
+    {
+        for (u32Index = 0;
+             (u32Index < ARRAY_SIZE(ls_u32CrcBenchSize)) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Index ++)
+            u32Ret = _benchCrc32cSize(pu8Buffer, ls_u32CrcBenchSize[u32Index], (u32Index == 0));
+    }
+
+    if (ls_bCrcBenchJson)
+        ol_printf("]\n");
+
+    free(pu8Buffer);
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+olint_t main(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olchar_t strErrMsg[300];
+
+    u32Ret = _parseCrcBenchCmdLineParam(argc, argv);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _benchCrc32c();
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        jf_err_readDescription(u32Ret, strErrMsg, sizeof(strErrMsg));
+        ol_printf("%s\n", strErrMsg);
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -6,11 +6,12 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The crc32c is compared with the byte-wise calculation for different length and alignment.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -22,6 +23,14 @@
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Size of the buffer for comparing with the byte-wise calculation.
+ */
+#define CRC_TEST_BUFFER_SIZE           (100000)
+
+/** The table for byte-wise calculation.
+ */
+static u32 ls_u32CrcTestTable[256];
+
 /* --- private routine section ------------------------------------------------------------------ */
 
 static u32 _printHexDumpInByte(u8 * pu8Buffer, u32 u32Length)
@@ -146,6 +155,137 @@ static void _testCrc32c()
 
 }
 
+static void _initCrcTestTable(void)
+{
+    u32 u32Index, u32Bit, u32Crc;
+
+    for (u32Index = 0; u32Index < 256; u32Index ++)
+    {
+        u32Crc = u32Index;
+        for (u32Bit = 0; u32Bit < 8; u32Bit ++)
+            u32Crc = (u32Crc & 1) ? (u32Crc >> 1) ^ 0x82F63B78 : u32Crc >> 1;
+        ls_u32CrcTestTable[u32Index] = u32Crc;
+    }
+}
+
+/** Calculate the crc32c byte by byte, the result is in network byte order.
+ */
+static u32 _crc32cByByte(u8 * pu8Data, u32 u32Len)
+{
+    u32 u32Crc = 0xFFFFFFFF;
+
+    while (u32Len-- > 0)
+        u32Crc = ls_u32CrcTestTable[(u32Crc ^ *pu8Data++) & 0xFF] ^ (u32Crc >> 8);
+
+    return u32Crc ^ 0xFFFFFFFF;
+}
+
+static u32 _testCrc32cLength(u8 * pu8Data, u32 u32Len)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Expected = _crc32cByByte(pu8Data, u32Len), u32Result, u32Crc1, u32Crc2, u32Split;
+    jf_crc_crc32c_vec_t jccv[3];
+
+    /*Single buffer.*/
+    jf_crc_crc32c(
+        pu8Data, u32Len, JF_CRC_CRC32C_FLAG_INIT_RESULT | JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER,
+        &u32Result);
+    if (u32Result != u32Expected)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Host byte order.*/
+    jf_crc_crc32c(pu8Data, u32Len, JF_CRC_CRC32C_FLAG_INIT_RESULT, &u32Result);
+    if (u32Result != ol_ntohl(u32Expected))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Continue from the result of the first segment with network byte order.*/
+    u32Split = u32Len / 3;
+    jf_crc_crc32c(
+        pu8Data, u32Split, JF_CRC_CRC32C_FLAG_INIT_RESULT | JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER,
+        &u32Result);
+    jf_crc_crc32c(
+        pu8Data + u32Split, u32Len - u32Split, JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER, &u32Result);
+    if (u32Result != u32Expected)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Continue from the result of the first segment with host byte order.*/
+    jf_crc_crc32c(pu8Data, u32Split, JF_CRC_CRC32C_FLAG_INIT_RESULT, &u32Result);
+    jf_crc_crc32c(pu8Data + u32Split, u32Len - u32Split, 0, &u32Result);
+    if (u32Result != ol_ntohl(u32Expected))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Vector with 3 segments.*/
+    jccv[0].jccv_pu8Buffer = pu8Data;
+    jccv[0].jccv_u32Len = u32Split;
+    jccv[1].jccv_pu8Buffer = pu8Data + u32Split;
+    jccv[1].jccv_u32Len = u32Len / 2 - u32Split;
+    jccv[2].jccv_pu8Buffer = pu8Data + u32Len / 2;
+    jccv[2].jccv_u32Len = u32Len - u32Len / 2;
+    jf_crc_crc32cVec(
+        jccv, 3, JF_CRC_CRC32C_FLAG_INIT_RESULT | JF_CRC_CRC32C_FLAG_NETWORK_BYTE_ORDER,
+        &u32Result);
+    if (u32Result != u32Expected)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    jf_crc_crc32cVec(jccv, 3, JF_CRC_CRC32C_FLAG_INIT_RESULT, &u32Result);
+    if (u32Result != ol_ntohl(u32Expected))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Combine 2 segments calculated independently.*/
+    jf_crc_crc32c(pu8Data, u32Split, JF_CRC_CRC32C_FLAG_INIT_RESULT, &u32Crc1);
+    jf_crc_crc32c(
+        pu8Data + u32Split, u32Len - u32Split, JF_CRC_CRC32C_FLAG_INIT_RESULT, &u32Crc2);
+    jf_crc_crc32cCombine(u32Crc1, u32Crc2, u32Len - u32Split, 0, &u32Result);
+    if (u32Result != ol_ntohl(u32Expected))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+        ol_printf("error, length %u, desired CRC: 0x%X\n", u32Len, u32Expected);
+
+    return u32Ret;
+}
+
+static u32 _testCrc32cByByte(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Buffer = NULL;
+    u32 u32Index, u32Len, u32Offset;
+
+    ol_printf("--------------------------------------------------------\n");
+    ol_printf("testing crc32c against byte-wise calculation\n");
+
+    _initCrcTestTable();
+
+    pu8Buffer = malloc(CRC_TEST_BUFFER_SIZE + 8);
+    if (pu8Buffer == NULL)
+        return JF_ERR_OUT_OF_MEMORY;
+
+    srand(1);
+    for (u32Index = 0; u32Index < CRC_TEST_BUFFER_SIZE + 8; u32Index ++)
+        pu8Buffer[u32Index] = (u8)rand();
+
+    /*All lengths around the block boundaries with all alignments.*/
+    for (u32Len = 0; (u32Len < 2400) && (u32Ret == JF_ERR_NO_ERROR); u32Len ++)
+        for (u32Offset = 0; (u32Offset < 8) && (u32Ret == JF_ERR_NO_ERROR); u32Offset ++)
+            u32Ret = _testCrc32cLength(pu8Buffer + u32Offset, u32Len);
+
+    for (u32Len = 24570; (u32Len < 24600) && (u32Ret == JF_ERR_NO_ERROR); u32Len ++)
+        u32Ret = _testCrc32cLength(pu8Buffer + (u32Len & 7), u32Len);
+
+    for (u32Index = 0; (u32Index < 200) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        u32Len = (u32)rand() % CRC_TEST_BUFFER_SIZE;
+        u32Ret = _testCrc32cLength(pu8Buffer + (u32Index & 7), u32Len);
+    }
+
+    free(pu8Buffer);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("pass\n");
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 olint_t main(olint_t argc, olchar_t ** argv)
@@ -155,6 +295,8 @@ olint_t main(olint_t argc, olchar_t ** argv)
 
     _testCrc32c();
 
+    u32Ret = _testCrc32cByByte();
+
     if (u32Ret != JF_ERR_NO_ERROR)
     {
         jf_err_readDescription(u32Ret, strErrMsg, 300);
@@ -1,7 +1,7 @@
 /**
  *  @file hashtable-test.c
  *
- *  @brief Test file for hash table function defined in jf_hashtable common object.
+ *  @brief Test file for hash table function defined in jf_hashtable and jf_flattable common object.
  *
  *  @author Min Zhang
  *
@@ -18,15 +18,25 @@
 #include "jf_limit.h"
 #include "jf_err.h"
 #include "jf_hashtable.h"
+#include "jf_flattable.h"
+#include "jf_concurrent_hashtable.h"
+#include "jf_hashfunc.h"
 #include "jf_process.h"
 #include "jf_jiukun.h"
 #include "jf_option.h"
+#include "jf_time.h"
+#include "jf_thread.h"
+#include "jf_mutex.h"
+#include "jf_atomic.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
 static boolean_t ls_bTerminateFlag = FALSE;
 static boolean_t ls_bHashU32 = FALSE;
 static boolean_t ls_bHashTable = FALSE;
+static boolean_t ls_bFlatTable = FALSE;
+static boolean_t ls_bBenchmark = FALSE;
+static boolean_t ls_bConcurrentTable = FALSE;
 
 #define TEST_HASHTABLE_HASHU32_BITS       (8)
 #define TEST_HASHTABLE_HASHU32_HIT_COUNT  (1 << TEST_HASHTABLE_HASHU32_BITS)
@@ -36,9 +46,12 @@ static boolean_t ls_bHashTable = FALSE;
 static void _printHashTableTestUsage(void)
 {
     ol_printf("\
-Usage: hashtable-test [-u] [-t] [-h]\n\
+Usage: hashtable-test [-u] [-t] [-f] [-b] [-c] [-h]\n\
   -u: test hash u32.\n\
   -t: test hash table.\n\
+  -f: test flat hash table.\n\
+  -b: benchmark flat hash table against hash table.\n\
+  -c: test concurrent hash table with multiple threads.\n\
   -h: print the usage\n");
 
     ol_printf("\n");
@@ -50,7 +63,7 @@ static u32 _parseHashTableTestCmdLineParam(
     u32 u32Ret = JF_ERR_NO_ERROR;
     olint_t nOpt;
 
-    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "uth?")) != -1))
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "utfbch?")) != -1))
     {
         switch (nOpt)
         {
@@ -65,6 +78,15 @@ static u32 _parseHashTableTestCmdLineParam(
         case 't':
             ls_bHashTable = TRUE;
             break;
+        case 'f':
+            ls_bFlatTable = TRUE;
+            break;
+        case 'b':
+            ls_bBenchmark = TRUE;
+            break;
+        case 'c':
+            ls_bConcurrentTable = TRUE;
+            break;
         case ':':
             u32Ret = JF_ERR_MISSING_PARAM;
             break;
@@ -234,6 +256,7 @@ static u32 _showHashTableStats(jf_hashtable_t * pjh)
     ol_printf("Collisions : %u\n", jhstat.jhs_u32Collisions);
     ol_printf("MaxEntries : %u\n", jhstat.jhs_u32MaxEntries);
     ol_printf("Resize     : %u\n", jhstat.jhs_u32CountOfResizeOp);
+    ol_printf("OldSize    : %u\n", jhstat.jhs_u32OldSize);
 
     return u32Ret;
 }
@@ -482,6 +505,143 @@ static u32 _testHashTable2(void)
     return u32Ret;
 }
 
+static olint_t _testHtU64CmpKeys(void * pKey1, void * pKey2)
+{
+    return (*(u64 *)pKey1 != *(u64 *)pKey2);
+}
+
+static olint_t _testHtU64HashKey(void * pKey)
+{
+    /*Use the same hash function as flat hash table.*/
+    return (olint_t)(jf_hashfunc_hashU64(*(u64 *)pKey) & 0x7FFFFFFF);
+}
+
+static void * _testHtU64GetKeyFromEntry(void * pEntry)
+{
+    return pEntry;
+}
+
+#define TEST_HASH_TABLE_REHASH_ENTRY     (100000)
+
+static u32 _testHashTableRehash(jf_hashtable_t * pjh, u64 * pu64Key, u32 u32NumOfKey)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0, u32Check = 0, u32Count = 0;
+    void * pEntry = NULL;
+    jf_hashtable_iterator_t iter;
+
+    /*All inserted entries must be found while the table is rehashing.*/
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+    {
+        u32Ret = jf_hashtable_insertEntry(pjh, &pu64Key[u32Index]);
+
+        for (u32Check = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Check <= u32Index);
+             u32Check += 1 + u32Index / 64)
+        {
+            u32Ret = jf_hashtable_getEntry(pjh, &pu64Key[u32Check], &pEntry);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (pEntry != &pu64Key[u32Check]))
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+        }
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_hashtable_getSize(pjh) != u32NumOfKey))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*The iterator covers both hash arrays.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_hashtable_setupIterator(pjh, &iter);
+        while (! jf_hashtable_isEndOfIterator(&iter))
+        {
+            u32Count ++;
+            jf_hashtable_incrementIterator(&iter);
+        }
+
+        if (u32Count != u32NumOfKey)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index += 2)
+        u32Ret = jf_hashtable_removeEntry(pjh, &pu64Key[u32Index]);
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+    {
+        if (jf_hashtable_isKeyInTable(pjh, &pu64Key[u32Index]) != ((u32Index & 1) != 0))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+static u32 _testHashTable3(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_hashtable_t * pjh = NULL;
+    jf_hashtable_create_param_t jhcp;
+    jf_hashtable_stat_t jhstat;
+    u64 * pu64Key = NULL;
+    u32 u32Index = 0;
+
+    ol_bzero(&jhcp, sizeof(jhcp));
+    jhcp.jhcp_u32MinSize = 7;
+    jhcp.jhcp_fnCmpKeys = _testHtU64CmpKeys;
+    jhcp.jhcp_fnHashKey = _testHtU64HashKey;
+    jhcp.jhcp_fnGetKeyFromEntry = _testHtU64GetKeyFromEntry;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pu64Key, sizeof(u64) * TEST_HASH_TABLE_REHASH_ENTRY);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        for (u32Index = 0; u32Index < TEST_HASH_TABLE_REHASH_ENTRY; u32Index ++)
+            pu64Key[u32Index] = (u64)(u32Index + 1) * 0x9E3779B97F4A7C15ULL;
+
+        /*The table is resized incrementally.*/
+        u32Ret = jf_hashtable_create(&pjh, &jhcp);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testHashTableRehash(pjh, pu64Key, TEST_HASH_TABLE_REHASH_ENTRY / 10);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        _showHashTableStats(pjh);
+
+    if (pjh != NULL)
+        jf_hashtable_destroy(&pjh);
+
+    /*The table is reserved, no resize is expected.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_hashtable_create(&pjh, &jhcp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_hashtable_reserve(pjh, TEST_HASH_TABLE_REHASH_ENTRY);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_hashtable_getStat(pjh, &jhstat);
+        u32Index = jhstat.jhs_u32CountOfResizeOp;
+
+        u32Ret = _testHashTableRehash(pjh, pu64Key, TEST_HASH_TABLE_REHASH_ENTRY);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_hashtable_getStat(pjh, &jhstat);
+        if (jhstat.jhs_u32CountOfResizeOp != u32Index)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+
+        _showHashTableStats(pjh);
+    }
+
+    if (pjh != NULL)
+        jf_hashtable_destroy(&pjh);
+
+    if (pu64Key != NULL)
+        jf_jiukun_freeMemory((void **)&pu64Key);
+
+    ol_printf("hash table rehash: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    return u32Ret;
+}
+
 static u32 _testHashTable(void)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -498,6 +658,765 @@ static u32 _testHashTable(void)
         u32Ret = _testHashTable2();
     }
 
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf(
+            "\n---------------------------- hash table test 3 -----------------------------\n");
+
+        u32Ret = _testHashTable3();
+    }
+
+    return u32Ret;
+}
+
+#define TEST_FLAT_TABLE_NUM_OF_KEY    (100000)
+
+static u32 _testFlatTableU32(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_flattable_t * pjf = NULL;
+    jf_flattable_create_param_t jfcp;
+    u32 u32Key = 0, u32Value = 0, u32Count = 0;
+    u32 * pu32Value = NULL;
+    jf_flattable_iterator_t jfi;
+
+    ol_bzero(&jfcp, sizeof(jfcp));
+    jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_U32;
+    jfcp.jfcp_u16ValueSize = sizeof(u32);
+
+    u32Ret = jf_flattable_create(&pjf, &jfcp);
+
+    /*Insert many keys so the table is resized several times.*/
+    for (u32Key = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Key < TEST_FLAT_TABLE_NUM_OF_KEY); u32Key ++)
+    {
+        u32Value = u32Key * 3;
+        u32Ret = jf_flattable_insertU32(pjf, u32Key, &u32Value);
+    }
+
+    for (u32Key = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Key < TEST_FLAT_TABLE_NUM_OF_KEY); u32Key ++)
+    {
+        u32Ret = jf_flattable_getU32(pjf, u32Key, (void **)&pu32Value);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (*pu32Value != u32Key * 3))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    /*Remove the odd keys, the even keys should be still in table.*/
+    for (u32Key = 1; (u32Ret == JF_ERR_NO_ERROR) && (u32Key < TEST_FLAT_TABLE_NUM_OF_KEY); u32Key += 2)
+        u32Ret = jf_flattable_removeU32(pjf, u32Key);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        if ((jf_flattable_getSize(pjf) != TEST_FLAT_TABLE_NUM_OF_KEY / 2) ||
+            (jf_flattable_getU32(pjf, 1, NULL) != JF_ERR_HASH_ENTRY_NOT_FOUND) ||
+            (jf_flattable_removeU32(pjf, 1) != JF_ERR_HASH_ENTRY_NOT_FOUND) ||
+            (jf_flattable_getU32(pjf, 2, NULL) != JF_ERR_NO_ERROR))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    /*Overwrite the value of existing key.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Value = 7;
+        u32Ret = jf_flattable_insertU32(pjf, 2, &u32Value);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_flattable_getU32(pjf, 2, (void **)&pu32Value);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((*pu32Value != 7) || (jf_flattable_getSize(pjf) != TEST_FLAT_TABLE_NUM_OF_KEY / 2)))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_flattable_setupIterator(pjf, &jfi);
+        while (! jf_flattable_isEndOfIterator(&jfi))
+        {
+            if ((*(u32 *)jf_flattable_getKeyFromIterator(&jfi) & 1) != 0)
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+            u32Count ++;
+            jf_flattable_incrementIterator(&jfi);
+        }
+
+        if (u32Count != TEST_FLAT_TABLE_NUM_OF_KEY / 2)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_flattable_clear(pjf);
+        if ((jf_flattable_getSize(pjf) != 0) ||
+            (jf_flattable_getU32(pjf, 2, NULL) != JF_ERR_HASH_ENTRY_NOT_FOUND))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    ol_printf("flat table with u32 key: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    if (pjf != NULL)
+        jf_flattable_destroy(&pjf);
+
+    return u32Ret;
+}
+
+static u32 _testFlatTablePtr(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_flattable_t * pjf = NULL;
+    jf_flattable_create_param_t jfcp;
+    test_hash_entry_t entry[TEST_HASH_TABLE_MAX_ENTRY];
+    test_hash_entry_t * pEntry = NULL;
+    olint_t index = 0;
+    void * pValue = NULL;
+
+    ol_bzero(&jfcp, sizeof(jfcp));
+    jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_PTR;
+    jfcp.jfcp_u16ValueSize = sizeof(void *);
+
+    u32Ret = jf_flattable_create(&pjf, &jfcp);
+
+    for (index = 0; (u32Ret == JF_ERR_NO_ERROR) && (index < TEST_HASH_TABLE_MAX_ENTRY); index ++)
+    {
+        pEntry = &entry[index];
+        u32Ret = jf_flattable_insertPtr(pjf, pEntry, &pEntry);
+    }
+
+    for (index = 0; (u32Ret == JF_ERR_NO_ERROR) && (index < TEST_HASH_TABLE_MAX_ENTRY); index ++)
+    {
+        u32Ret = jf_flattable_getPtr(pjf, &entry[index], &pValue);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (*(test_hash_entry_t **)pValue != &entry[index]))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_flattable_removePtr(pjf, &entry[3]);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_flattable_getPtr(pjf, &entry[3], NULL) != JF_ERR_HASH_ENTRY_NOT_FOUND))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    ol_printf("flat table with pointer key: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    if (pjf != NULL)
+        jf_flattable_destroy(&pjf);
+
+    return u32Ret;
+}
+
+static u32 _testFlatTableString(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_flattable_t * pjf = NULL;
+    jf_flattable_create_param_t jfcp;
+    test_hash_entry_t entry[TEST_HASH_TABLE_MAX_ENTRY];
+    olint_t index = 0;
+    olint_t * pnId = NULL;
+    olchar_t strKey[32];
+    jf_flattable_iterator_t jfi;
+
+    ol_bzero(&jfcp, sizeof(jfcp));
+    jfcp.jfcp_u32MinSize = 7;
+    jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_STRING;
+    jfcp.jfcp_u16ValueSize = sizeof(olint_t);
+
+    u32Ret = jf_flattable_create(&pjf, &jfcp);
+
+    for (index = 0; (u32Ret == JF_ERR_NO_ERROR) && (index < TEST_HASH_TABLE_MAX_ENTRY); index ++)
+    {
+        ol_bzero(&entry[index], sizeof(entry[index]));
+        ol_sprintf(entry[index].the_strName, "entry%d", index);
+        entry[index].the_nId = index;
+
+        u32Ret = jf_flattable_insert(pjf, entry[index].the_strName, &entry[index].the_nId);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_flattable_remove(pjf, "entry1");
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The key is compared by content, not by address.*/
+        ol_strcpy(strKey, "entry8");
+        u32Ret = jf_flattable_get(pjf, strKey, (void **)&pnId);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((*pnId != 8) || (jf_flattable_get(pjf, "entry1", NULL) != JF_ERR_HASH_ENTRY_NOT_FOUND)))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("\n---- iterate flat table start ----\n");
+        jf_flattable_setupIterator(pjf, &jfi);
+        while (! jf_flattable_isEndOfIterator(&jfi))
+        {
+            ol_printf(
+                "position: %u, key: %s, id: %d\n", jfi.jfi_u32Pos,
+                (olchar_t *)jf_flattable_getKeyFromIterator(&jfi),
+                *(olint_t *)jf_flattable_getValueFromIterator(&jfi));
+            jf_flattable_incrementIterator(&jfi);
+        }
+        ol_printf("---- iterate flat table end ----\n\n");
+    }
+
+    ol_printf("flat table with string key: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    if (pjf != NULL)
+        jf_flattable_destroy(&pjf);
+
+    return u32Ret;
+}
+
+static u32 _testFlatTableData(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_flattable_t * pjf = NULL;
+    jf_flattable_create_param_t jfcp;
+    olchar_t strKey[12];
+    u32 u32Index = 0;
+
+    /*A set with 12 bytes key.*/
+    ol_bzero(&jfcp, sizeof(jfcp));
+    jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_DATA;
+    jfcp.jfcp_u16KeySize = sizeof(strKey);
+
+    u32Ret = jf_flattable_create(&pjf, &jfcp);
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < 1000); u32Index ++)
+    {
+        ol_bzero(strKey, sizeof(strKey));
+        ol_snprintf(strKey, sizeof(strKey), "key%u", u32Index);
+        u32Ret = jf_flattable_insert(pjf, strKey, NULL);
+    }
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < 1000); u32Index ++)
+    {
+        ol_bzero(strKey, sizeof(strKey));
+        ol_snprintf(strKey, sizeof(strKey), "key%u", u32Index);
+        u32Ret = jf_flattable_get(pjf, strKey, NULL);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_flattable_getSize(pjf) != 1000))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    ol_printf("flat table with data key: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    if (pjf != NULL)
+        jf_flattable_destroy(&pjf);
+
+    return u32Ret;
+}
+
+static u32 _testFlatTable(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = _testFlatTableU32();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testFlatTablePtr();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testFlatTableString();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testFlatTableData();
+
+    return u32Ret;
+}
+
+static inline u64 _getBenchNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _benchmarkFlatTableWithKeys(u64 * pu64Key, u32 u32NumOfKey)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_flattable_t * pjf = NULL;
+    jf_flattable_create_param_t jfcp;
+    jf_hashtable_t * pjh = NULL;
+    jf_hashtable_create_param_t jhcp;
+    u32 u32Index = 0;
+    u64 u64Start = 0, u64Flat = 0, u64Hash = 0, u64HashMax = 0;
+    void * pValue = NULL;
+
+    ol_bzero(&jfcp, sizeof(jfcp));
+    jfcp.jfcp_u8KeyType = JF_FLATTABLE_KEY_TYPE_U64;
+    jfcp.jfcp_u16ValueSize = sizeof(void *);
+    u32Ret = jf_flattable_create(&pjf, &jfcp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(&jhcp, sizeof(jhcp));
+        jhcp.jhcp_u32MinSize = 16;
+        jhcp.jhcp_fnCmpKeys = _testHtU64CmpKeys;
+        jhcp.jhcp_fnHashKey = _testHtU64HashKey;
+        jhcp.jhcp_fnGetKeyFromEntry = _testHtU64GetKeyFromEntry;
+        u32Ret = jf_hashtable_create(&pjh, &jhcp);
+    }
+
+    /*Insert.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+        {
+            pValue = &pu64Key[u32Index];
+            u32Ret = jf_flattable_insertU64(pjf, pu64Key[u32Index], &pValue);
+        }
+        u64Flat = _getBenchNanoTime();
+        u64Flat -= u64Start;
+
+        /*Record the maximum latency of insert, the resize happens in some inserts.*/
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+        {
+            u64Start = _getBenchNanoTime();
+            u32Ret = jf_hashtable_insertEntry(pjh, &pu64Key[u32Index]);
+            u64Start = _getBenchNanoTime() - u64Start;
+            u64Hash += u64Start;
+            if (u64Start > u64HashMax)
+                u64HashMax = u64Start;
+        }
+
+        ol_printf(
+            "%8u keys, insert: flat %6llu ns/op, hash %6llu ns/op, hash max %llu ns\n",
+            u32NumOfKey, u64Flat / u32NumOfKey, u64Hash / u32NumOfKey, u64HashMax);
+    }
+
+    /*Lookup.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+            u32Ret = jf_flattable_getU64(pjf, pu64Key[u32Index], &pValue);
+        u64Flat = _getBenchNanoTime();
+        u64Flat -= u64Start;
+
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+            u32Ret = jf_hashtable_getEntry(pjh, &pu64Key[u32Index], &pValue);
+        u64Hash = _getBenchNanoTime();
+        u64Hash -= u64Start;
+
+        ol_printf(
+            "%8u keys, get   : flat %6llu ns/op, hash %6llu ns/op\n", u32NumOfKey,
+            u64Flat / u32NumOfKey, u64Hash / u32NumOfKey);
+    }
+
+    /*Remove.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+            u32Ret = jf_flattable_removeU64(pjf, pu64Key[u32Index]);
+        u64Flat = _getBenchNanoTime();
+        u64Flat -= u64Start;
+
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfKey); u32Index ++)
+            u32Ret = jf_hashtable_removeEntry(pjh, &pu64Key[u32Index]);
+        u64Hash = _getBenchNanoTime();
+        u64Hash -= u64Start;
+
+        ol_printf(
+            "%8u keys, remove: flat %6llu ns/op, hash %6llu ns/op\n", u32NumOfKey,
+            u64Flat / u32NumOfKey, u64Hash / u32NumOfKey);
+    }
+
+    if (pjh != NULL)
+        jf_hashtable_destroy(&pjh);
+
+    if (pjf != NULL)
+        jf_flattable_destroy(&pjf);
+
+    return u32Ret;
+}
+
+static u32 _benchmarkFlatTable(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32NumOfKey[] = {1000, 10000, 100000, 1000000};
+    u32 u32Index = 0, u32Key = 0;
+    u64 * pu64Key = NULL;
+
+    for (u32Index = 0;
+         (u32Ret == JF_ERR_NO_ERROR) && (u32Index < ARRAY_SIZE(u32NumOfKey)); u32Index ++)
+    {
+        u32Ret = jf_jiukun_allocMemory((void **)&pu64Key, sizeof(u64) * u32NumOfKey[u32Index]);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            /*Keys like session id, unique and spread over 64 bits, multiplying by odd number is a
+              bijection.*/
+            for (u32Key = 0; u32Key < u32NumOfKey[u32Index]; u32Key ++)
+                pu64Key[u32Key] = (u64)(u32Key + 1) * 0x9E3779B97F4A7C15ULL;
+
+            u32Ret = _benchmarkFlatTableWithKeys(pu64Key, u32NumOfKey[u32Index]);
+
+            jf_jiukun_freeMemory((void **)&pu64Key);
+        }
+    }
+
+    return u32Ret;
+}
+
+#define TEST_CHT_NUM_OF_KEY           (4096)
+#define TEST_CHT_NUM_OF_READER        (4)
+#define TEST_CHT_NUM_OF_WRITER        (2)
+#define TEST_CHT_READ_OPS             (1000000)
+#define TEST_CHT_WRITE_OPS            (100000)
+
+/** The entry of concurrent hash table test, the check field is the complement of the key, it's
+ *  cleared when the entry is freed.
+ */
+typedef struct
+{
+    u64 tce_u64Key;
+    u64 tce_u64Check;
+} test_cht_entry_t;
+
+typedef struct
+{
+    /**The concurrent hash table, NULL if hash table with mutex is tested.*/
+    jf_concurrent_hashtable_t * tct_pjch;
+    jf_hashtable_t * tct_pjh;
+    jf_mutex_t * tct_pjmLock;
+    u32 tct_u32Id;
+    boolean_t tct_bWriter;
+    u8 tct_u8Reserved[3];
+    u32 tct_u32Rand;
+    u32 tct_u32Error;
+    u64 tct_u64Found;
+} test_cht_thread_t;
+
+static boolean_t ls_bChtStart = FALSE;
+
+static u32 _freeTestChtEntry(void ** ppEntry)
+{
+    test_cht_entry_t * ptce = *ppEntry;
+
+    ptce->tce_u64Check = 0;
+    jf_jiukun_freeMemory(ppEntry);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static inline u32 _getTestChtRand(test_cht_thread_t * ptct)
+{
+    ptct->tct_u32Rand = ptct->tct_u32Rand * 1103515245 + 12345;
+
+    return ptct->tct_u32Rand >> 8;
+}
+
+static void _readTestCht(test_cht_thread_t * ptct)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0;
+    u64 u64Key = 0;
+    test_cht_entry_t * ptce = NULL;
+    jf_concurrent_hashtable_reader_t jchr;
+
+    for (u32Index = 0; u32Index < TEST_CHT_READ_OPS; u32Index ++)
+    {
+        u64Key = _getTestChtRand(ptct) % TEST_CHT_NUM_OF_KEY;
+
+        if (ptct->tct_pjch != NULL)
+        {
+            jf_concurrent_hashtable_beginRead(ptct->tct_pjch, &jchr);
+            u32Ret = jf_concurrent_hashtable_getEntry(ptct->tct_pjch, &u64Key, (void **)&ptce);
+        }
+        else
+        {
+            jf_mutex_acquire(ptct->tct_pjmLock);
+            u32Ret = jf_hashtable_getEntry(ptct->tct_pjh, &u64Key, (void **)&ptce);
+        }
+
+        /*The entry must not be freed while it's being accessed.*/
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ptct->tct_u64Found ++;
+            if ((ptce->tce_u64Key != u64Key) || (ptce->tce_u64Check != ~u64Key))
+                ptct->tct_u32Error ++;
+        }
+
+        if (ptct->tct_pjch != NULL)
+            jf_concurrent_hashtable_endRead(ptct->tct_pjch, &jchr);
+        else
+            jf_mutex_release(ptct->tct_pjmLock);
+    }
+}
+
+static void _writeTestChtWithMutex(test_cht_thread_t * ptct, u64 u64Key, boolean_t bRemove)
+{
+    test_cht_entry_t * ptce = NULL;
+
+    jf_mutex_acquire(ptct->tct_pjmLock);
+
+    if (jf_hashtable_getEntry(ptct->tct_pjh, &u64Key, (void **)&ptce) == JF_ERR_NO_ERROR)
+    {
+        jf_hashtable_removeEntry(ptct->tct_pjh, ptce);
+        _freeTestChtEntry((void **)&ptce);
+    }
+
+    if (! bRemove && (jf_jiukun_allocMemory((void **)&ptce, sizeof(*ptce)) == JF_ERR_NO_ERROR))
+    {
+        ptce->tce_u64Key = u64Key;
+        ptce->tce_u64Check = ~u64Key;
+        jf_hashtable_insertEntry(ptct->tct_pjh, ptce);
+    }
+
+    jf_mutex_release(ptct->tct_pjmLock);
+}
+
+static void _writeTestCht(test_cht_thread_t * ptct)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0, u32Op = 0;
+    u64 u64Key = 0;
+    test_cht_entry_t * ptce = NULL;
+
+    for (u32Index = 0; u32Index < TEST_CHT_WRITE_OPS; u32Index ++)
+    {
+        /*Each writer owns the keys with the same remainder.*/
+        u64Key = (_getTestChtRand(ptct) % (TEST_CHT_NUM_OF_KEY / TEST_CHT_NUM_OF_WRITER)) *
+            TEST_CHT_NUM_OF_WRITER + ptct->tct_u32Id;
+        u32Op = _getTestChtRand(ptct) % 3;
+
+        if (ptct->tct_pjch == NULL)
+        {
+            _writeTestChtWithMutex(ptct, u64Key, u32Op == 0);
+            continue;
+        }
+
+        if (u32Op == 0)
+        {
+            u32Ret = jf_concurrent_hashtable_removeEntry(ptct->tct_pjch, &u64Key);
+            if ((u32Ret != JF_ERR_NO_ERROR) && (u32Ret != JF_ERR_HASH_ENTRY_NOT_FOUND))
+                ptct->tct_u32Error ++;
+            continue;
+        }
+
+        u32Ret = jf_jiukun_allocMemory((void **)&ptce, sizeof(*ptce));
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ptce->tce_u64Key = u64Key;
+            ptce->tce_u64Check = ~u64Key;
+
+            if (u32Op == 1)
+                u32Ret = jf_concurrent_hashtable_insertEntry(ptct->tct_pjch, ptce);
+            else
+                u32Ret = jf_concurrent_hashtable_overwriteEntry(ptct->tct_pjch, ptce);
+
+            if (u32Ret == JF_ERR_HASH_ENTRY_ALREADY_EXIST)
+                _freeTestChtEntry((void **)&ptce);
+            else if (u32Ret != JF_ERR_NO_ERROR)
+                ptct->tct_u32Error ++;
+        }
+    }
+}
+
+JF_THREAD_RETURN_VALUE _testChtThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_cht_thread_t * ptct = (test_cht_thread_t *)pArg;
+
+    /*Wait for all threads to be created.*/
+    while (! jf_atomic_loadU32((u32 *)&ls_bChtStart))
+        jf_atomic_cpuRelax();
+
+    if (ptct->tct_bWriter)
+        _writeTestCht(ptct);
+    else
+        _readTestCht(ptct);
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _runTestChtThreads(
+    jf_concurrent_hashtable_t * pjch, jf_hashtable_t * pjh, jf_mutex_t * pjmLock)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_cht_thread_t tct[TEST_CHT_NUM_OF_READER + TEST_CHT_NUM_OF_WRITER];
+    jf_thread_id_t threadId[TEST_CHT_NUM_OF_READER + TEST_CHT_NUM_OF_WRITER];
+    u32 u32Index = 0, u32Created = 0, u32RetCode = 0, u32Error = 0;
+    u64 u64Start = 0, u64Found = 0;
+
+    ol_bzero(tct, sizeof(tct));
+    /*The flag is accessed as u32.*/
+    jf_atomic_storeU32((u32 *)&ls_bChtStart, FALSE);
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < ARRAY_SIZE(tct)); u32Index ++)
+    {
+        tct[u32Index].tct_pjch = pjch;
+        tct[u32Index].tct_pjh = pjh;
+        tct[u32Index].tct_pjmLock = pjmLock;
+        tct[u32Index].tct_bWriter = (u32Index < TEST_CHT_NUM_OF_WRITER);
+        tct[u32Index].tct_u32Id = u32Index % TEST_CHT_NUM_OF_WRITER;
+        tct[u32Index].tct_u32Rand = u32Index + 1;
+
+        u32Ret = jf_thread_create(&threadId[u32Index], NULL, _testChtThread, &tct[u32Index]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Created ++;
+    }
+
+    u64Start = _getBenchNanoTime();
+    jf_atomic_storeU32((u32 *)&ls_bChtStart, TRUE);
+
+    for (u32Index = 0; u32Index < u32Created; u32Index ++)
+    {
+        jf_thread_waitForThreadTermination(threadId[u32Index], &u32RetCode);
+        u32Error += tct[u32Index].tct_u32Error;
+        u64Found += tct[u32Index].tct_u64Found;
+    }
+
+    u64Start = _getBenchNanoTime() - u64Start;
+
+    ol_printf(
+        "%-18s %u readers, %u writers, %.2f Mops/s read, found %llu, error %u\n",
+        (pjch != NULL) ? "concurrent table:" : "table with mutex:", TEST_CHT_NUM_OF_READER,
+        TEST_CHT_NUM_OF_WRITER,
+        (oldouble_t)TEST_CHT_READ_OPS * TEST_CHT_NUM_OF_READER * 1000.0 / (oldouble_t)u64Start,
+        u64Found, u32Error);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (u32Error != 0))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static u32 _testConcurrentTableBasic(jf_concurrent_hashtable_t * pjch)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_cht_entry_t * ptce = NULL, * ptceFound = NULL;
+    u64 u64Key = 0;
+    u32 u32Index = 0;
+
+    /*Insert enough entries to resize the bucket array.*/
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < TEST_CHT_NUM_OF_KEY); u32Index ++)
+    {
+        u32Ret = jf_jiukun_allocMemory((void **)&ptce, sizeof(*ptce));
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            ptce->tce_u64Key = u32Index;
+            ptce->tce_u64Check = ~(u64)u32Index;
+            u32Ret = jf_concurrent_hashtable_insertEntry(pjch, ptce);
+        }
+    }
+
+    /*Insert the entry with existing key.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_jiukun_allocMemory((void **)&ptce, sizeof(*ptce));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ptce->tce_u64Key = 1;
+        ptce->tce_u64Check = ~(u64)1;
+        if (jf_concurrent_hashtable_insertEntry(pjch, ptce) != JF_ERR_HASH_ENTRY_ALREADY_EXIST)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+        else
+            u32Ret = jf_concurrent_hashtable_overwriteEntry(pjch, ptce);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Key = 1;
+        if (! jf_concurrent_hashtable_isKeyInTable(pjch, &u64Key) ||
+            (jf_concurrent_hashtable_getSize(pjch) != TEST_CHT_NUM_OF_KEY))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_concurrent_hashtable_reader_t jchr;
+
+        jf_concurrent_hashtable_beginRead(pjch, &jchr);
+        u32Ret = jf_concurrent_hashtable_getEntry(pjch, &u64Key, (void **)&ptceFound);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (ptceFound != ptce))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+        jf_concurrent_hashtable_endRead(pjch, &jchr);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_concurrent_hashtable_removeEntry(pjch, &u64Key);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((jf_concurrent_hashtable_removeEntry(pjch, &u64Key) != JF_ERR_HASH_ENTRY_NOT_FOUND) ||
+         jf_concurrent_hashtable_isKeyInTable(pjch, &u64Key)))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_concurrent_hashtable_reclaim(pjch);
+
+    ol_printf("concurrent table basic: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    return u32Ret;
+}
+
+static u32 _testConcurrentTable(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_concurrent_hashtable_t * pjch = NULL;
+    jf_concurrent_hashtable_create_param_t jchcp;
+    jf_hashtable_t * pjh = NULL;
+    jf_hashtable_create_param_t jhcp;
+    jf_mutex_t jmLock;
+
+    ol_bzero(&jchcp, sizeof(jchcp));
+    jchcp.jchcp_fnCmpKeys = _testHtU64CmpKeys;
+    jchcp.jchcp_fnHashKey = _testHtU64HashKey;
+    jchcp.jchcp_fnGetKeyFromEntry = _testHtU64GetKeyFromEntry;
+    jchcp.jchcp_fnFreeEntry = _freeTestChtEntry;
+
+    u32Ret = jf_concurrent_hashtable_create(&pjch, &jchcp);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testConcurrentTableBasic(pjch);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _runTestChtThreads(pjch, NULL, NULL);
+
+    if (pjch != NULL)
+        jf_concurrent_hashtable_destroy(&pjch);
+
+    /*Hash table protected by mutex for comparison.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(&jhcp, sizeof(jhcp));
+        jhcp.jhcp_u32MinSize = TEST_CHT_NUM_OF_KEY;
+        jhcp.jhcp_fnCmpKeys = _testHtU64CmpKeys;
+        jhcp.jhcp_fnHashKey = _testHtU64HashKey;
+        jhcp.jhcp_fnGetKeyFromEntry = _testHtU64GetKeyFromEntry;
+
+        u32Ret = jf_hashtable_create(&pjh, &jhcp);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_mutex_init(&jmLock);
+        u32Ret = _runTestChtThreads(NULL, pjh, &jmLock);
+        jf_mutex_fini(&jmLock);
+    }
+
+    if (pjh != NULL)
+    {
+        /*Free the entries left in table.*/
+        jf_hashtable_iterator_t iter;
+        test_cht_entry_t * ptce = NULL;
+
+        jf_hashtable_setupIterator(pjh, &iter);
+        while (! jf_hashtable_isEndOfIterator(&iter))
+        {
+            ptce = jf_hashtable_getEntryFromIterator(&iter);
+            jf_hashtable_incrementIterator(&iter);
+            _freeTestChtEntry((void **)&ptce);
+        }
+
+        jf_hashtable_destroy(&pjh);
+    }
+
     return u32Ret;
 }
 
@@ -534,6 +1453,18 @@ olint_t main(olint_t argc, olchar_t ** argv)
             {
                 u32Ret = _testHashTable();
             }
+            else if (ls_bFlatTable)
+            {
+                u32Ret = _testFlatTable();
+            }
+            else if (ls_bBenchmark)
+            {
+                u32Ret = _benchmarkFlatTable();
+            }
+            else if (ls_bConcurrentTable)
+            {
+                u32Ret = _testConcurrentTable();
+            }
             else
             {
                 ol_printf("No operation is specified !!!!\n\n");
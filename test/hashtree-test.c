@@ -10,7 +10,7 @@
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
-
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -20,18 +20,30 @@
 #include "jf_err.h"
 #include "jf_jiukun.h"
 #include "jf_option.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
 static boolean_t ls_bHashTree = FALSE;
 
+static boolean_t ls_bBenchHashTree = FALSE;
+
+/** Number of keys for the hash tree benchmark.
+ */
+static u32 ls_u32BenchHashTreeKeys[] = {1000, 100000, 1000000};
+
+/** Maximum length of the key in benchmark.
+ */
+#define HASHTREE_BENCH_KEY_LEN           (32)
+
 /* --- private routine section ------------------------------------------------------------------ */
 
 static void _printHashtreeTestUsage(void)
 {
     ol_printf("\
-Usage: hashtree-test [-t] [-T <trace level>] [-F <trace log file>] [-S <trace file size>]\n\
-    -t test hash tree\n");
+Usage: hashtree-test [-t] [-b] [-T <trace level>] [-F <trace log file>] [-S <trace file size>]\n\
+    -t test hash tree\n\
+    -b benchmark hash tree with 1k, 100k and 1M keys\n");
 
     ol_printf("\n");
 }
@@ -42,7 +54,7 @@ static u32 _parseHashTreeTestCmdLineParam(
     u32 u32Ret = JF_ERR_NO_ERROR;
     olint_t nOpt;
 
-    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "tT:F:S:h")) != -1))
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "tbT:F:S:h")) != -1))
     {
         switch (nOpt)
         {
@@ -54,6 +66,9 @@ static u32 _parseHashTreeTestCmdLineParam(
         case 't':
             ls_bHashTree = TRUE;
             break;
+        case 'b':
+            ls_bBenchHashTree = TRUE;
+            break;
         case 'T':
             u32Ret = jf_option_getU8FromString(jf_option_getArg(), &pjlip->jlip_u8TraceLevel);
             break;
@@ -222,6 +237,141 @@ static u32 _testHashTree(void)
     return u32Ret;
 }
 
+static inline u64 _getBenchNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static void _printBenchHashTreeResult(const olchar_t * pstrOp, u32 u32Keys, u64 u64Time)
+{
+    ol_printf(
+        "%-10s %10u %12.1f %12.0f\n", pstrOp, u32Keys, (double)u64Time / u32Keys,
+        (double)u32Keys * 1000000000.0 / (double)u64Time);
+}
+
+/** Benchmark the hash tree, the keys are in the form of "ip:port" which is used by web client.
+ */
+static u32 _benchHashTreeWithKeys(u32 u32Keys)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_hashtree_t hashtree;
+    jf_hashtree_enumerator_t en;
+    olchar_t * pstrKeys = NULL, * pstrKey = NULL, strMiss[HASHTREE_BENCH_KEY_LEN];
+    olsize_t * psKeys = NULL, sMiss = 0;
+    u32 u32Index = 0, u32Count = 0;
+    u64 u64Start = 0;
+    void * pData = NULL;
+
+    jf_hashtree_init(&hashtree);
+
+    pstrKeys = malloc(u32Keys * HASHTREE_BENCH_KEY_LEN);
+    psKeys = malloc(u32Keys * sizeof(olsize_t));
+    if ((pstrKeys == NULL) || (psKeys == NULL))
+        u32Ret = JF_ERR_OUT_OF_MEMORY;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        for (u32Index = 0; u32Index < u32Keys; u32Index ++)
+            psKeys[u32Index] = ol_snprintf(
+                pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN, HASHTREE_BENCH_KEY_LEN,
+                "10.%u.%u.%u:%u", (u32Index >> 16) & 0xFF, (u32Index >> 8) & 0xFF,
+                u32Index & 0xFF, 80 + (u32Index >> 24));
+
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Index < u32Keys) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+            u32Ret = jf_hashtree_addEntry(
+                &hashtree, pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN, psKeys[u32Index],
+                pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            _printBenchHashTreeResult("add", u32Keys, _getBenchNanoTime() - u64Start);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Index < u32Keys) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        {
+            pstrKey = pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN;
+            u32Ret = jf_hashtree_getEntry(&hashtree, pstrKey, psKeys[u32Index], &pData);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (pData != pstrKey))
+                u32Ret = JF_ERR_HASHTREE_ENTRY_NOT_FOUND;
+        }
+        if (u32Ret == JF_ERR_NO_ERROR)
+            _printBenchHashTreeResult("get-hit", u32Keys, _getBenchNanoTime() - u64Start);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Index < u32Keys) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        {
+            /*The key is changed from "10.x.x.x:port" to "11.x.x.x:port".*/
+            sMiss = psKeys[u32Index];
+            ol_memcpy(strMiss, pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN, sMiss);
+            strMiss[1] = '1';
+            if (jf_hashtree_hasEntry(&hashtree, strMiss, sMiss))
+                u32Ret = JF_ERR_INVALID_DATA;
+        }
+        if (u32Ret == JF_ERR_NO_ERROR)
+            _printBenchHashTreeResult("get-miss", u32Keys, _getBenchNanoTime() - u64Start);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Every item must be enumerated once.*/
+        jf_hashtree_initEnumerator(&hashtree, &en);
+        while (! jf_hashtree_isEndOfEnumerator(&en))
+        {
+            u32Count ++;
+            jf_hashtree_moveEnumerator(&en);
+        }
+        jf_hashtree_finiEnumerator(&en);
+
+        if ((u32Count != u32Keys) || (jf_hashtree_getSize(&hashtree) != u32Keys))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Start = _getBenchNanoTime();
+        for (u32Index = 0; (u32Index < u32Keys) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+            u32Ret = jf_hashtree_deleteEntry(
+                &hashtree, pstrKeys + u32Index * HASHTREE_BENCH_KEY_LEN, psKeys[u32Index]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            _printBenchHashTreeResult("delete", u32Keys, _getBenchNanoTime() - u64Start);
+
+        if ((u32Ret == JF_ERR_NO_ERROR) && ! jf_hashtree_isEmpty(&hashtree))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    jf_hashtree_fini(&hashtree);
+
+    if (pstrKeys != NULL)
+        free(pstrKeys);
+
+    if (psKeys != NULL)
+        free(psKeys);
+
+    return u32Ret;
+}
+
+static u32 _benchHashTree(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0;
+
+    ol_printf("%-10s %10s %12s %12s\n", "operation", "keys", "ns/op", "ops/s");
+    for (u32Index = 0; (u32Index < ARRAY_SIZE(ls_u32BenchHashTreeKeys)) &&
+             (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = _benchHashTreeWithKeys(ls_u32BenchHashTreeKeys[u32Index]);
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 olint_t main(olint_t argc, olchar_t ** argv)
@@ -252,6 +402,10 @@ olint_t main(olint_t argc, olchar_t ** argv)
             {
                 u32Ret = _testHashTree();
             }
+            else if (ls_bBenchHashTree)
+            {
+                u32Ret = _benchHashTree();
+            }
             else
             {
                 ol_printf("No operation is specified !!!!\n\n");
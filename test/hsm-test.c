@@ -6,7 +6,8 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The sparse state machine uses large state id and event id so the transition table is
+ *   indexed with hash table. The entries with the same state and event are guarded by parameter.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -46,8 +47,35 @@ enum rice_cooker_event_id
     RCE_PRESS_FIREPOWER_BUTTON, /**<Firepower low, mid, high.*/
 };
 
+enum sparse_state_id
+{
+    SPS_IDLE = 0x1000,
+    SPS_CONNECTING = 0x20000,
+    SPS_CONNECTED = 0x300000,
+    SPS_RETRY = 0x4000000, /**<Sub state for connecting state.*/
+    SPS_WAIT = 0x5000000, /**<Sub state for connecting state.*/
+};
+
+enum sparse_event_id
+{
+    SPE_CONNECT = 0x7F000001,
+    SPE_RESPONSE = 0x10001,
+    SPE_TIMEOUT = 0x2002,
+    SPE_CLOSE = 0x333333,
+};
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static boolean_t _guardSparseAccept(jf_hsm_event_t * pEvent)
+{
+    return (pEvent->jhe_s64Param == 1);
+}
+
+static boolean_t _guardSparseReject(jf_hsm_event_t * pEvent)
+{
+    return (pEvent->jhe_s64Param == 2);
+}
+
 static boolean_t _guardPowerOffForPlugIn(jf_hsm_event_t * pEvent)
 {
     boolean_t bRet = FALSE;
@@ -312,6 +340,75 @@ static u32 _testHsm(void)
     return u32Ret;
 }
 
+static u32 _testSparseHsm(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_hsm_t * pjh = NULL;
+    jf_hsm_event_t event;
+    u32 u32Index = 0;
+    jf_hsm_transition_t sparseTransitionTable[] = {
+        {SPS_IDLE, SPE_CONNECT, NULL, NULL, SPS_CONNECTING},
+        {SPS_CONNECTING, SPE_RESPONSE, _guardSparseAccept, NULL, SPS_CONNECTED},
+        {SPS_CONNECTING, SPE_RESPONSE, _guardSparseReject, NULL, SPS_IDLE},
+        {SPS_CONNECTING, SPE_CLOSE, NULL, NULL, SPS_IDLE},
+        {SPS_CONNECTED, SPE_CLOSE, NULL, NULL, SPS_IDLE},
+        {JF_HSM_LAST_STATE_ID, JF_HSM_LAST_EVENT_ID, NULL, NULL, JF_HSM_LAST_STATE_ID},
+    };
+    jf_hsm_transition_t connectingTransitionTable[] = {
+        {SPS_WAIT, SPE_TIMEOUT, NULL, NULL, SPS_RETRY},
+        {SPS_RETRY, SPE_TIMEOUT, NULL, NULL, SPS_WAIT},
+        {JF_HSM_LAST_STATE_ID, JF_HSM_LAST_EVENT_ID, NULL, NULL, JF_HSM_LAST_STATE_ID},
+    };
+    /*The event, the parameter and the expected state after the event.*/
+    struct
+    {
+        jf_hsm_event_id_t eventId;
+        s64 s64Param;
+        jf_hsm_state_id_t stateId;
+    } step[] = {
+        {SPE_RESPONSE, 1, SPS_IDLE},
+        {SPE_CONNECT, 0, SPS_WAIT},
+        {SPE_TIMEOUT, 0, SPS_RETRY},
+        {SPE_TIMEOUT, 0, SPS_WAIT},
+        {SPE_RESPONSE, 0, SPS_WAIT},
+        {SPE_RESPONSE, 2, SPS_IDLE},
+        {SPE_CONNECT, 0, SPS_WAIT},
+        {SPE_TIMEOUT, 0, SPS_RETRY},
+        {SPE_RESPONSE, 1, SPS_CONNECTED},
+        {SPE_TIMEOUT, 0, SPS_CONNECTED},
+        {SPE_CLOSE, 0, SPS_IDLE},
+    };
+
+    ol_printf("Test sparse state machine\n");
+
+    u32Ret = jf_hsm_create(&pjh, sparseTransitionTable, SPS_IDLE);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_hsm_addStateTransition(
+            pjh, SPS_CONNECTING, connectingTransitionTable, SPS_WAIT);
+
+    for (u32Index = 0; (u32Index < ARRAY_SIZE(step)) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        jf_hsm_initEvent(&event, step[u32Index].eventId, NULL, step[u32Index].s64Param);
+        jf_hsm_processEvent(pjh, &event);
+
+        if (jf_hsm_getCurrentStateId(pjh) != step[u32Index].stateId)
+        {
+            ol_printf(
+                "Step %u, state 0x%X, expected 0x%X\n", u32Index, jf_hsm_getCurrentStateId(pjh),
+                step[u32Index].stateId);
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    if (pjh != NULL)
+        jf_hsm_destroy(&pjh);
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 olint_t main(olint_t argc, olchar_t ** argv)
@@ -336,6 +433,9 @@ olint_t main(olint_t argc, olchar_t ** argv)
     {
         u32Ret = _testHsm();
 
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testSparseHsm();
+
         jf_jiukun_fini();
     }
 
@@ -0,0 +1,820 @@
+/**
+ *  @file jiukun-bench.c
+ *
+ *  @brief Benchmark file for memory allocation function defined in jf_jiukun library.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The benchmark compares jiukun with the C library malloc under several workloads.
+ *  -# Workload "small" allocates and frees batches of small objects in each thread.
+ *  -# Workload "message" keeps a window of 1KB to 128KB messages like the dispatcher.
+ *  -# Workload "prodcon" allocates memory in producer thread and frees it in consumer thread.
+ *  -# Workload "soak" keeps a large live set and replaces objects with shifting sizes to measure
+ *   fragmentation.
+ *  -# The result can be printed in JSON format so regressions can be tracked.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#if defined(LINUX)
+    #include <malloc.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_jiukun.h"
+#include "jf_logger.h"
+#include "jf_thread.h"
+#include "jf_time.h"
+#include "jf_option.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+/** Maximum number of benchmark thread.
+ */
+#define MAX_BENCH_THREADS                 (64)
+
+/** Number of latency sample kept by one thread.
+ */
+#define BENCH_LATENCY_SAMPLES             (1 << 14)
+
+/** One out of the number of allocations is timed.
+ */
+#define BENCH_LATENCY_SAMPLE_RATE         (8)
+
+/** Number of object allocated in one batch in "small" workload.
+ */
+#define BENCH_SMALL_BATCH                 (64)
+
+/** Number of message kept by one thread in "message" workload.
+ */
+#define BENCH_MESSAGE_WINDOW              (32)
+
+/** Number of object kept by one thread in "soak" workload.
+ */
+#define BENCH_SOAK_LIVE_SET               (2048)
+
+/** Size of the ring between producer and consumer in "prodcon" workload, must be power of 2.
+ */
+#define BENCH_RING_SIZE                   (1024)
+
+/** Default number of allocation per thread.
+ */
+#define BENCH_DEFAULT_OPS                 (200000)
+
+typedef enum
+{
+    BENCH_WORKLOAD_SMALL = 0,
+    BENCH_WORKLOAD_MESSAGE,
+    BENCH_WORKLOAD_PRODCON,
+    BENCH_WORKLOAD_SOAK,
+    BENCH_WORKLOAD_MAX,
+} bench_workload_t;
+
+static const olchar_t * ls_pstrBenchWorkload[BENCH_WORKLOAD_MAX] =
+{
+    "small",
+    "message",
+    "prodcon",
+    "soak",
+};
+
+/** Define the allocator data type, the allocator under benchmark.
+ */
+typedef struct
+{
+    const olchar_t * ba_pstrName;
+    u32 (* ba_fnAlloc)(void ** pptr, olsize_t size);
+    void (* ba_fnFree)(void ** pptr);
+} bench_allocator_t;
+
+/** Define the ring data type between producer and consumer.
+ */
+typedef struct
+{
+    /**Index written by producer.*/
+    volatile u64 br_u64Head __attribute__((aligned(64)));
+    /**Index written by consumer.*/
+    volatile u64 br_u64Tail __attribute__((aligned(64)));
+    /**Producer has finished if it's TRUE.*/
+    volatile boolean_t br_bDone;
+    void * br_pSlot[BENCH_RING_SIZE] __attribute__((aligned(64)));
+} bench_ring_t;
+
+/** Define the benchmark thread data type.
+ */
+typedef struct
+{
+    u32 bt_u32Id;
+    /**The thread is a consumer in "prodcon" workload if it's TRUE.*/
+    boolean_t bt_bConsumer;
+    u8 bt_u8Reserved[3];
+    bench_allocator_t * bt_pbaAllocator;
+    bench_ring_t * bt_pbrRing;
+    u64 bt_u64Seed;
+    /**Number of allocation and free operation.*/
+    u64 bt_u64Ops;
+    /**Number of failed allocation.*/
+    u64 bt_u64Failed;
+    /**Live bytes left when the thread quits.*/
+    u64 bt_u64LiveBytes;
+    /**Number of latency sample.*/
+    u32 bt_u32Samples;
+    u32 bt_u32Live;
+    /**Latency of allocation in nano-second.*/
+    u32 * bt_pu32Latency;
+    /**Objects left when the thread quits, freed by main thread after measuring RSS.*/
+    void ** bt_ppLive;
+} bench_thread_t;
+
+/** Define the benchmark result data type.
+ */
+typedef struct
+{
+    const olchar_t * br_pstrAllocator;
+    const olchar_t * br_pstrWorkload;
+    u32 br_u32Threads;
+    u64 br_u64Ops;
+    u64 br_u64Failed;
+    oldouble_t br_dbOpsPerSec;
+    u32 br_u32P50Latency;
+    u32 br_u32P99Latency;
+    u64 br_u64RssKb;
+    oldouble_t br_dbFragmentation;
+} bench_result_t;
+
+static u32 ls_u32MaxThreads = 4;
+static u32 ls_u32OpsPerThread = BENCH_DEFAULT_OPS;
+static boolean_t ls_bJsonOutput = FALSE;
+static boolean_t ls_bWorkload[BENCH_WORKLOAD_MAX] = {TRUE, TRUE, TRUE, TRUE};
+static boolean_t ls_bBenchJiukun = TRUE;
+static boolean_t ls_bBenchMalloc = TRUE;
+
+static volatile boolean_t ls_bBenchStart = FALSE;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static void _printJiukunBenchUsage(void)
+{
+    ol_printf("\
+Usage: jiukun-bench [-n threads] [-c count] [-w small|message|prodcon|soak] [-a jiukun|malloc] \n\
+    [-j] [logger options]\n\
+  -n: maximum number of thread, the benchmark runs with 1, 2, 4 ... up to the number.\n\
+  -c: number of allocation per thread.\n\
+  -w: run the workload only, all workloads are run if not specified.\n\
+  -a: benchmark the allocator only, jiukun and malloc are compared if not specified.\n\
+  -j: print the result in JSON format.\n\
+logger options: [-T <0|1|2|3|4|5>] [-O] [-F log file] [-S log file size] \n\
+  -T: the log level. 0: no log, 1: error, 2: warn, 3: info, 4: debug, 5: data.\n\
+  -O: output the log to stdout.\n\
+  -F: the log file.\n\
+  -S: the size of log file. No limit if not specified.\n");
+
+    ol_printf("\n");
+}
+
+static u32 _parseJiukunBenchCmdLineParam(
+    olint_t argc, olchar_t ** argv, jf_logger_init_param_t * pjlip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt = 0;
+    u32 u32Index = 0;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) &&
+           ((nOpt = jf_option_get(argc, argv, "n:c:w:a:jOT:F:S:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case ':':
+        case '?':
+        case 'h':
+            _printJiukunBenchUsage();
+            exit(0);
+            break;
+        case 'n':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32MaxThreads);
+            if ((u32Ret == JF_ERR_NO_ERROR) &&
+                ((ls_u32MaxThreads == 0) || (ls_u32MaxThreads > MAX_BENCH_THREADS)))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'c':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32OpsPerThread);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32OpsPerThread == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'w':
+            u32Ret = JF_ERR_INVALID_PARAM;
+            for (u32Index = 0; u32Index < BENCH_WORKLOAD_MAX; u32Index ++)
+            {
+                ls_bWorkload[u32Index] = FALSE;
+                if (ol_strcmp(jf_option_getArg(), ls_pstrBenchWorkload[u32Index]) == 0)
+                {
+                    ls_bWorkload[u32Index] = TRUE;
+                    u32Ret = JF_ERR_NO_ERROR;
+                }
+            }
+            break;
+        case 'a':
+            ls_bBenchJiukun = (ol_strcmp(jf_option_getArg(), "jiukun") == 0);
+            ls_bBenchMalloc = (ol_strcmp(jf_option_getArg(), "malloc") == 0);
+            if (! ls_bBenchJiukun && ! ls_bBenchMalloc)
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'j':
+            ls_bJsonOutput = TRUE;
+            break;
+        case 'T':
+            u32Ret = jf_option_getU8FromString(jf_option_getArg(), &pjlip->jlip_u8TraceLevel);
+            break;
+        case 'F':
+            pjlip->jlip_bLogToFile = TRUE;
+            pjlip->jlip_pstrLogFile = jf_option_getArg();
+            break;
+        case 'S':
+            u32Ret = jf_option_getS32FromString(jf_option_getArg(), &pjlip->jlip_sLogFile);
+            break;
+        case 'O':
+            pjlip->jlip_bLogToStdout = TRUE;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static u32 _mallocAlloc(void ** pptr, olsize_t size)
+{
+    *pptr = malloc(size);
+    if (*pptr == NULL)
+        return JF_ERR_OUT_OF_MEMORY;
+
+    return JF_ERR_NO_ERROR;
+}
+
+static void _mallocFree(void ** pptr)
+{
+    free(*pptr);
+    *pptr = NULL;
+}
+
+static bench_allocator_t ls_baJiukun = {"jiukun", jf_jiukun_allocMemory, jf_jiukun_freeMemory};
+
+static bench_allocator_t ls_baMalloc = {"malloc", _mallocAlloc, _mallocFree};
+
+static inline u64 _getBenchNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+/** Xorshift random number generator, it's per thread so it's not a point of contention.
+ */
+static inline u32 _getBenchRand(bench_thread_t * pbt)
+{
+    u64 x = pbt->bt_u64Seed;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    pbt->bt_u64Seed = x;
+
+    return (u32)(x >> 16);
+}
+
+/** Get the resident set size of the process in KB.
+ */
+static u64 _getBenchRssKb(void)
+{
+    u64 u64Rss = 0;
+#if defined(LINUX)
+    FILE * fp = NULL;
+    unsigned long ulSize = 0, ulResident = 0;
+
+    fp = fopen("/proc/self/statm", "r");
+    if (fp != NULL)
+    {
+        if (fscanf(fp, "%lu %lu", &ulSize, &ulResident) == 2)
+            u64Rss = (u64)ulResident * sysconf(_SC_PAGESIZE) / 1024;
+        fclose(fp);
+    }
+#endif
+    return u64Rss;
+}
+
+/** Allocate memory and record the latency for some of the allocations.
+ */
+static inline void * _benchAlloc(bench_thread_t * pbt, olsize_t size)
+{
+    void * ptr = NULL;
+    u64 u64Start = 0;
+    u32 u32Ret = JF_ERR_NO_ERROR, u32Offset = 0;
+
+    if ((pbt->bt_u64Ops % BENCH_LATENCY_SAMPLE_RATE) == 0)
+    {
+        u64Start = _getBenchNanoTime();
+        u32Ret = pbt->bt_pbaAllocator->ba_fnAlloc(&ptr, size);
+        pbt->bt_pu32Latency[pbt->bt_u32Samples % BENCH_LATENCY_SAMPLES] =
+            (u32)(_getBenchNanoTime() - u64Start);
+        pbt->bt_u32Samples ++;
+    }
+    else
+    {
+        u32Ret = pbt->bt_pbaAllocator->ba_fnAlloc(&ptr, size);
+    }
+
+    pbt->bt_u64Ops ++;
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        pbt->bt_u64Failed ++;
+        return NULL;
+    }
+
+    /*Touch every page as a real user does, the requested size is saved for fragmentation.*/
+    for (u32Offset = 4096; u32Offset < (u32)size; u32Offset += 4096)
+        ((u8 *)ptr)[u32Offset] = (u8)u32Offset;
+    *(u32 *)ptr = (u32)size;
+
+    return ptr;
+}
+
+static inline void _benchFree(bench_thread_t * pbt, void ** pptr)
+{
+    pbt->bt_pbaAllocator->ba_fnFree(pptr);
+    pbt->bt_u64Ops ++;
+}
+
+static void _runBenchSmall(bench_thread_t * pbt)
+{
+    void * pObj[BENCH_SMALL_BATCH];
+    u32 u32Loop = 0, u32Index = 0;
+
+    for (u32Loop = 0; u32Loop < ls_u32OpsPerThread; u32Loop += BENCH_SMALL_BATCH)
+    {
+        for (u32Index = 0; u32Index < BENCH_SMALL_BATCH; u32Index ++)
+            pObj[u32Index] = _benchAlloc(pbt, 8 + _getBenchRand(pbt) % 249);
+
+        /*Free in reverse order like a stack of temporary objects.*/
+        for (u32Index = BENCH_SMALL_BATCH; u32Index > 0; u32Index --)
+        {
+            if (pObj[u32Index - 1] != NULL)
+                _benchFree(pbt, &pObj[u32Index - 1]);
+        }
+    }
+}
+
+static void _runBenchMessage(bench_thread_t * pbt)
+{
+    u32 u32Loop = 0, u32Slot = 0;
+
+    pbt->bt_u32Live = BENCH_MESSAGE_WINDOW;
+
+    for (u32Loop = 0; u32Loop < ls_u32OpsPerThread; u32Loop ++)
+    {
+        u32Slot = _getBenchRand(pbt) % BENCH_MESSAGE_WINDOW;
+        if (pbt->bt_ppLive[u32Slot] != NULL)
+            _benchFree(pbt, &pbt->bt_ppLive[u32Slot]);
+
+        pbt->bt_ppLive[u32Slot] = _benchAlloc(pbt, 1024 + _getBenchRand(pbt) % (127 * 1024));
+    }
+}
+
+static void _runBenchProducer(bench_thread_t * pbt)
+{
+    bench_ring_t * pbr = pbt->bt_pbrRing;
+    u32 u32Loop = 0;
+    void * ptr = NULL;
+
+    for (u32Loop = 0; u32Loop < ls_u32OpsPerThread; u32Loop ++)
+    {
+        ptr = _benchAlloc(pbt, 64 + _getBenchRand(pbt) % 4033);
+        if (ptr == NULL)
+            continue;
+
+        /*Wait until the ring has space.*/
+        while (pbr->br_u64Head - __atomic_load_n(&pbr->br_u64Tail, __ATOMIC_ACQUIRE) >=
+               BENCH_RING_SIZE)
+            sched_yield();
+
+        pbr->br_pSlot[pbr->br_u64Head & (BENCH_RING_SIZE - 1)] = ptr;
+        __atomic_store_n(&pbr->br_u64Head, pbr->br_u64Head + 1, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&pbr->br_bDone, TRUE, __ATOMIC_RELEASE);
+}
+
+static void _runBenchConsumer(bench_thread_t * pbt)
+{
+    bench_ring_t * pbr = pbt->bt_pbrRing;
+    void * ptr = NULL;
+    boolean_t bDone = FALSE;
+
+    while (TRUE)
+    {
+        bDone = __atomic_load_n(&pbr->br_bDone, __ATOMIC_ACQUIRE);
+        if (pbr->br_u64Tail == __atomic_load_n(&pbr->br_u64Head, __ATOMIC_ACQUIRE))
+        {
+            if (bDone)
+                break;
+            sched_yield();
+            continue;
+        }
+
+        ptr = pbr->br_pSlot[pbr->br_u64Tail & (BENCH_RING_SIZE - 1)];
+        __atomic_store_n(&pbr->br_u64Tail, pbr->br_u64Tail + 1, __ATOMIC_RELEASE);
+
+        /*The memory is freed in a thread different from the one allocating it.*/
+        _benchFree(pbt, &ptr);
+    }
+}
+
+static void _runBenchSoak(bench_thread_t * pbt)
+{
+    u32 u32Loop = 0, u32Slot = 0, u32Shift = 0, u32Size = 0, u32Phase = 0;
+
+    pbt->bt_u32Live = BENCH_SOAK_LIVE_SET;
+
+    for (u32Loop = 0; u32Loop < ls_u32OpsPerThread; u32Loop ++)
+    {
+        /*The size distribution moves every quarter so freed holes do not fit the new objects.*/
+        u32Phase = u32Loop / (ls_u32OpsPerThread / 4 + 1);
+
+        u32Slot = _getBenchRand(pbt) % BENCH_SOAK_LIVE_SET;
+        if (pbt->bt_ppLive[u32Slot] != NULL)
+            _benchFree(pbt, &pbt->bt_ppLive[u32Slot]);
+
+        /*Sizes are skewed to small objects, from 16 bytes up to 64KB.*/
+        u32Shift = (_getBenchRand(pbt) % 7) + (_getBenchRand(pbt) % 7);
+        u32Shift = (u32Shift + u32Phase) % 13;
+        u32Size = (16 << u32Shift) + _getBenchRand(pbt) % (8 << u32Shift);
+        pbt->bt_ppLive[u32Slot] = _benchAlloc(pbt, u32Size);
+    }
+}
+
+JF_THREAD_RETURN_VALUE _benchThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    bench_thread_t * pbt = (bench_thread_t *)pArg;
+    bench_workload_t workload = (bench_workload_t)pbt->bt_u32Live;
+
+    pbt->bt_u32Live = 0;
+
+    /*Wait for all threads to be created.*/
+    while (! __atomic_load_n(&ls_bBenchStart, __ATOMIC_ACQUIRE))
+        sched_yield();
+
+    if (workload == BENCH_WORKLOAD_SMALL)
+        _runBenchSmall(pbt);
+    else if (workload == BENCH_WORKLOAD_MESSAGE)
+        _runBenchMessage(pbt);
+    else if ((workload == BENCH_WORKLOAD_PRODCON) && pbt->bt_bConsumer)
+        _runBenchConsumer(pbt);
+    else if (workload == BENCH_WORKLOAD_PRODCON)
+        _runBenchProducer(pbt);
+    else if (workload == BENCH_WORKLOAD_SOAK)
+        _runBenchSoak(pbt);
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static olint_t _compareBenchLatency(const void * a, const void * b)
+{
+    u32 u32A = *(const u32 *)a, u32B = *(const u32 *)b;
+
+    return (u32A > u32B) - (u32A < u32B);
+}
+
+/** Collect the result of all threads.
+ */
+static void _collectBenchResult(
+    bench_thread_t * pbt, u32 u32Threads, u64 u64Elapsed, u64 u64RssKb, bench_result_t * pbr)
+{
+    u32 u32Index = 0, u32Samples = 0, u32Count = 0;
+    u32 * pu32Latency = NULL;
+    u64 u64LiveBytes = 0, u64UsedBytes = 0;
+
+    for (u32Index = 0; u32Index < u32Threads; u32Index ++)
+    {
+        pbr->br_u64Ops += pbt[u32Index].bt_u64Ops;
+        pbr->br_u64Failed += pbt[u32Index].bt_u64Failed;
+        u64LiveBytes += pbt[u32Index].bt_u64LiveBytes;
+        u32Samples += MIN(pbt[u32Index].bt_u32Samples, BENCH_LATENCY_SAMPLES);
+    }
+
+    pbr->br_dbOpsPerSec = (oldouble_t)pbr->br_u64Ops * 1000000000.0 / (oldouble_t)u64Elapsed;
+    pbr->br_u64RssKb = u64RssKb;
+
+    /*Fragmentation is the part of resident memory not used by the live objects.*/
+    u64UsedBytes = u64RssKb * 1024;
+    if ((u64LiveBytes != 0) && (u64UsedBytes > u64LiveBytes))
+        pbr->br_dbFragmentation =
+            (oldouble_t)(u64UsedBytes - u64LiveBytes) / (oldouble_t)u64UsedBytes;
+
+    if (u32Samples == 0)
+        return;
+
+    pu32Latency = malloc(u32Samples * sizeof(u32));
+    if (pu32Latency == NULL)
+        return;
+
+    for (u32Index = 0; u32Index < u32Threads; u32Index ++)
+    {
+        u32 u32Num = MIN(pbt[u32Index].bt_u32Samples, BENCH_LATENCY_SAMPLES);
+
+        ol_memcpy(pu32Latency + u32Count, pbt[u32Index].bt_pu32Latency, u32Num * sizeof(u32));
+        u32Count += u32Num;
+    }
+
+    ol_qsort(pu32Latency, u32Count, sizeof(u32), _compareBenchLatency);
+    pbr->br_u32P50Latency = pu32Latency[u32Count / 2];
+    pbr->br_u32P99Latency = pu32Latency[(u32)((u64)u32Count * 99 / 100)];
+
+    free(pu32Latency);
+}
+
+/** Free the objects left by the threads, it's called after RSS is measured.
+ */
+static void _freeBenchLiveObjects(bench_thread_t * pbt)
+{
+    u32 u32Index = 0;
+
+    for (u32Index = 0; u32Index < pbt->bt_u32Live; u32Index ++)
+    {
+        if (pbt->bt_ppLive[u32Index] != NULL)
+            pbt->bt_pbaAllocator->ba_fnFree(&pbt->bt_ppLive[u32Index]);
+    }
+}
+
+/** Calculate the bytes requested for the objects left by the thread.
+ */
+static u64 _getBenchLiveBytes(bench_thread_t * pbt)
+{
+    u64 u64Bytes = 0;
+    u32 u32Index = 0;
+
+    for (u32Index = 0; u32Index < pbt->bt_u32Live; u32Index ++)
+    {
+        if (pbt->bt_ppLive[u32Index] != NULL)
+            u64Bytes += *(u32 *)pbt->bt_ppLive[u32Index];
+    }
+
+    return u64Bytes;
+}
+
+static u32 _initBenchAllocator(bench_allocator_t * pba)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_jiukun_init_param_t jjip;
+
+    if (pba == &ls_baJiukun)
+    {
+        ol_bzero(&jjip, sizeof(jjip));
+        jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
+
+        u32Ret = jf_jiukun_init(&jjip);
+    }
+#if defined(LINUX)
+    else
+    {
+        /*Return the memory cached by malloc so RSS starts from the same point.*/
+        malloc_trim(0);
+    }
+#endif
+
+    return u32Ret;
+}
+
+static void _finiBenchAllocator(bench_allocator_t * pba)
+{
+    if (pba == &ls_baJiukun)
+        jf_jiukun_fini();
+}
+
+static u32 _runBench(
+    bench_allocator_t * pba, bench_workload_t workload, u32 u32Threads, bench_result_t * pbr)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR, u32RetCode = 0;
+    u32 u32Index = 0, u32Created = 0;
+    bench_thread_t * pbt = NULL;
+    bench_ring_t * pRing = NULL;
+    jf_thread_id_t threadId[MAX_BENCH_THREADS * 2];
+    u64 u64Start = 0, u64Elapsed = 0, u64RssBase = 0, u64Rss = 0;
+
+    ol_bzero(pbr, sizeof(*pbr));
+    pbr->br_pstrAllocator = pba->ba_pstrName;
+    pbr->br_pstrWorkload = ls_pstrBenchWorkload[workload];
+    pbr->br_u32Threads = u32Threads;
+
+    /*Each thread in "prodcon" workload is paired with a consumer.*/
+    if (workload == BENCH_WORKLOAD_PRODCON)
+        u32Threads *= 2;
+
+    pbt = calloc(u32Threads, sizeof(bench_thread_t));
+    pRing = aligned_alloc(64, ALIGN_CEIL(sizeof(bench_ring_t) * u32Threads / 2 + 64, 64));
+    if ((pbt == NULL) || (pRing == NULL))
+        u32Ret = JF_ERR_OUT_OF_MEMORY;
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32Threads); u32Index ++)
+    {
+        pbt[u32Index].bt_u32Id = u32Index;
+        pbt[u32Index].bt_pbaAllocator = pba;
+        pbt[u32Index].bt_u64Seed = 0x9E3779B97F4A7C15ULL * (u32Index + 1);
+        pbt[u32Index].bt_pu32Latency = calloc(BENCH_LATENCY_SAMPLES, sizeof(u32));
+        pbt[u32Index].bt_ppLive = calloc(BENCH_SOAK_LIVE_SET, sizeof(void *));
+        if ((pbt[u32Index].bt_pu32Latency == NULL) || (pbt[u32Index].bt_ppLive == NULL))
+            u32Ret = JF_ERR_OUT_OF_MEMORY;
+
+        if (workload == BENCH_WORKLOAD_PRODCON)
+        {
+            pbt[u32Index].bt_pbrRing = &pRing[u32Index / 2];
+            pbt[u32Index].bt_bConsumer = (u32Index % 2) != 0;
+        }
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(pRing, sizeof(bench_ring_t) * u32Threads / 2);
+        u64RssBase = _getBenchRssKb();
+        u32Ret = _initBenchAllocator(pba);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ls_bBenchStart = FALSE;
+        for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32Threads); u32Index ++)
+        {
+            /*The workload is passed in the live count which is reset by the thread.*/
+            pbt[u32Index].bt_u32Live = workload;
+            u32Ret = jf_thread_create(&threadId[u32Index], NULL, _benchThread, &pbt[u32Index]);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Created ++;
+        }
+
+        u64Start = _getBenchNanoTime();
+        __atomic_store_n(&ls_bBenchStart, TRUE, __ATOMIC_RELEASE);
+
+        for (u32Index = 0; u32Index < u32Created; u32Index ++)
+            jf_thread_waitForThreadTermination(threadId[u32Index], &u32RetCode);
+
+        u64Elapsed = _getBenchNanoTime() - u64Start;
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            /*Measure the memory with the live objects held.*/
+            u64Rss = _getBenchRssKb();
+            u64Rss = (u64Rss > u64RssBase) ? u64Rss - u64RssBase : 0;
+
+            for (u32Index = 0; u32Index < u32Threads; u32Index ++)
+            {
+                if (pbt[u32Index].bt_u32Live != 0)
+                    pbt[u32Index].bt_u64LiveBytes = _getBenchLiveBytes(&pbt[u32Index]);
+            }
+
+            _collectBenchResult(pbt, u32Threads, u64Elapsed, u64Rss, pbr);
+        }
+
+        for (u32Index = 0; u32Index < u32Threads; u32Index ++)
+            _freeBenchLiveObjects(&pbt[u32Index]);
+
+        _finiBenchAllocator(pba);
+    }
+
+    if (pbt != NULL)
+    {
+        for (u32Index = 0; u32Index < u32Threads; u32Index ++)
+        {
+            free(pbt[u32Index].bt_pu32Latency);
+            free(pbt[u32Index].bt_ppLive);
+        }
+        free(pbt);
+    }
+
+    free(pRing);
+
+    return u32Ret;
+}
+
+static void _printBenchResult(bench_result_t * pbr, boolean_t bFirst)
+{
+    if (ls_bJsonOutput)
+    {
+        ol_printf(
+            "%s    {\"allocator\": \"%s\", \"workload\": \"%s\", \"threads\": %u, "
+            "\"ops\": %llu, \"failed\": %llu, \"ops_per_sec\": %.0f, \"p50_alloc_ns\": %u, "
+            "\"p99_alloc_ns\": %u, \"rss_kb\": %llu, \"fragmentation\": %.4f}",
+            bFirst ? "" : ",\n", pbr->br_pstrAllocator, pbr->br_pstrWorkload,
+            pbr->br_u32Threads, pbr->br_u64Ops, pbr->br_u64Failed, pbr->br_dbOpsPerSec,
+            pbr->br_u32P50Latency, pbr->br_u32P99Latency, pbr->br_u64RssKb,
+            pbr->br_dbFragmentation);
+    }
+    else
+    {
+        ol_printf(
+            "%-8s %-8s %7u %14.0f %10u %10u %10llu %8.2f%% %8llu\n", pbr->br_pstrAllocator,
+            pbr->br_pstrWorkload, pbr->br_u32Threads, pbr->br_dbOpsPerSec, pbr->br_u32P50Latency,
+            pbr->br_u32P99Latency, pbr->br_u64RssKb, pbr->br_dbFragmentation * 100,
+            pbr->br_u64Failed);
+    }
+    ol_fflush(stdout);
+}
+
+static u32 _benchJiukun(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    bench_allocator_t * pba[2];
+    u32 u32NumOfAllocator = 0, u32Allocator = 0, u32Workload = 0, u32Threads = 0;
+    bench_result_t br;
+    boolean_t bFirst = TRUE;
+
+    if (ls_bBenchJiukun)
+        pba[u32NumOfAllocator ++] = &ls_baJiukun;
+    if (ls_bBenchMalloc)
+        pba[u32NumOfAllocator ++] = &ls_baMalloc;
+
+    if (ls_bJsonOutput)
+        ol_printf(
+            "{\n  \"benchmark\": \"jiukun-bench\",\n  \"ops_per_thread\": %u,\n  \"results\": [\n",
+            ls_u32OpsPerThread);
+    else
+        ol_printf(
+            "%-8s %-8s %7s %14s %10s %10s %10s %9s %8s\n", "alloc", "workload", "threads",
+            "ops/s", "p50(ns)", "p99(ns)", "rss(KB)", "frag", "failed");
+
+    for (u32Workload = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Workload < BENCH_WORKLOAD_MAX);
+         u32Workload ++)
+    {
+        if (! ls_bWorkload[u32Workload])
+            continue;
+
+        for (u32Threads = 1; (u32Ret == JF_ERR_NO_ERROR) && (u32Threads <= ls_u32MaxThreads);
+             u32Threads = (u32Threads * 2 > ls_u32MaxThreads && u32Threads != ls_u32MaxThreads) ?
+                 ls_u32MaxThreads : u32Threads * 2)
+        {
+            /*Run the allocators next to each other with the same thread count.*/
+            for (u32Allocator = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Allocator < u32NumOfAllocator);
+                 u32Allocator ++)
+            {
+                u32Ret = _runBench(pba[u32Allocator], u32Workload, u32Threads, &br);
+                if (u32Ret == JF_ERR_NO_ERROR)
+                {
+                    _printBenchResult(&br, bFirst);
+                    bFirst = FALSE;
+                }
+            }
+        }
+    }
+
+    if (ls_bJsonOutput)
+        ol_printf("\n  ]\n}\n");
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+olint_t main(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olchar_t strErrMsg[300];
+    jf_logger_init_param_t jlipParam;
+
+    ol_bzero(&jlipParam, sizeof(jlipParam));
+
+    jlipParam.jlip_pstrCallerName = "JIUKUN-BENCH";
+    jlipParam.jlip_u8TraceLevel = JF_LOGGER_TRACE_LEVEL_ERROR;
+
+    u32Ret = _parseJiukunBenchCmdLineParam(argc, argv, &jlipParam);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_logger_init(&jlipParam);
+
+        u32Ret = _benchJiukun();
+
+        jf_logger_fini();
+    }
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+    {
+        jf_err_readDescription(u32Ret, strErrMsg, sizeof(strErrMsg));
+        ol_printf("%s\n", strErrMsg);
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -47,15 +47,25 @@ boolean_t ls_bDoubleFree = FALSE;
 boolean_t ls_bUnallocatedFree = FALSE;
 boolean_t ls_bAllocateWithoutFree = FALSE;
 
+boolean_t ls_bHugePage = FALSE;
+boolean_t ls_bNumaNode = FALSE;
+boolean_t ls_bReclaimer = FALSE;
+
+static u32 ls_u32PressureCount = 0;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
 static void _printJiukunTestUsage(void)
 {
     ol_printf("\
-Usage: jiukun-test [-t] [-j page|memory|object] [stress testing option] [allocate without free] \n\
-    [double free option] [unallocated free option] [out of bound option] [logger options]\n\
+Usage: jiukun-test [-t] [-j page|memory|object] [-g] [-n] [-r] [stress testing option] \n\
+    [allocate without free] [double free option] [unallocated free option] [out of bound option] \n\
+    [logger options]\n\
   -t: test in multi-threading environment.\n\
   -j: specify the test target.\n\
+  -g: back the jiukun pool with huge page.\n\
+  -n: bind the jiukun pool to NUMA node.\n\
+  -r: test the reclaimer thread.\n\
 double free option:\n\
   -d: test double free.\n\
 unallocated free option:\n\
@@ -83,7 +93,7 @@ static u32 _parseJiukunTestCmdLineParam(
     olint_t nOpt = 0;
 
     while ((u32Ret == JF_ERR_NO_ERROR) &&
-           ((nOpt = jf_option_get(argc, argv, "bwj:tsduOT:F:S:h")) != -1))
+           ((nOpt = jf_option_get(argc, argv, "bwj:tsdugnrOT:F:S:h")) != -1))
     {
         switch (nOpt)
         {
@@ -119,6 +129,15 @@ static u32 _parseJiukunTestCmdLineParam(
         case 'w':
             ls_bAllocateWithoutFree = TRUE;
             break;
+        case 'g':
+            ls_bHugePage = TRUE;
+            break;
+        case 'n':
+            ls_bNumaNode = TRUE;
+            break;
+        case 'r':
+            ls_bReclaimer = TRUE;
+            break;
         case 'T':
             u32Ret = jf_option_getU8FromString(jf_option_getArg(), &pjlip->jlip_u8TraceLevel);
             break;
@@ -730,6 +749,127 @@ static u32 _testJiukunOutOfBound(void)
     return u32Ret;
 }
 
+static void _notifyJiukunPressure(u32 u32FreePercent, void * pArg)
+{
+    ol_printf("memory pressure, free: %u%%\n", u32FreePercent);
+    ls_u32PressureCount ++;
+}
+
+static u32 _testJiukunReclaimer(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Mem[48];
+    u32 u32Index = 0;
+
+    ol_bzero(pu8Mem, sizeof(pu8Mem));
+
+    /*Use 3/4 of the pool, the pressure should be notified.*/
+    for (u32Index = 0; (u32Index < ARRAY_SIZE(pu8Mem)) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        u32Ret = jf_jiukun_allocMemory((void **)&pu8Mem[u32Index], 64 * 1024);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            ol_memset(pu8Mem[u32Index], 0xA5, 64 * 1024);
+    }
+
+    ol_sleep(1);
+
+    ol_printf("reclaimer: pressure is notified %u times\n", ls_u32PressureCount);
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32PressureCount == 0))
+        u32Ret = JF_ERR_JIUKUN_OUT_OF_MEMORY;
+
+    for (u32Index = 0; u32Index < ARRAY_SIZE(pu8Mem); u32Index ++)
+        if (pu8Mem[u32Index] != NULL)
+            jf_jiukun_freeMemory((void **)&pu8Mem[u32Index]);
+
+    /*The free slabs are reaped and the pages are returned to kernel, no pressure any more.*/
+    ol_sleep(1);
+    ls_u32PressureCount = 0;
+    ol_sleep(1);
+
+    ol_printf("reclaimer: pressure is notified %u times after free\n", ls_u32PressureCount);
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32PressureCount != 0))
+        u32Ret = JF_ERR_FAIL_REAP_JIUKUN;
+
+    return u32Ret;
+}
+
+static u32 _testJiukunReallocMemory(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Mem = NULL, * pu8Old = NULL;
+    olsize_t size = 16, sIndex = 0;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pu8Mem, size);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_memset(pu8Mem, 0xA5, size);
+
+    /*Double the memory like a growing buffer, the data must be kept.*/
+    while ((u32Ret == JF_ERR_NO_ERROR) && (size < (1 << 20)))
+    {
+        pu8Old = pu8Mem;
+        u32Ret = jf_jiukun_reallocMemory((void **)&pu8Mem, size * 2);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            for (sIndex = 0; sIndex < size; sIndex ++)
+                if (pu8Mem[sIndex] != 0xA5)
+                    u32Ret = JF_ERR_JIUKUN_MEMORY_CORRUPTED;
+
+            jf_logger_logInfoMsg(
+                "realloc %d bytes, %s", size * 2, (pu8Old == pu8Mem) ? "in place" : "moved");
+            size *= 2;
+            ol_memset(pu8Mem, 0xA5, size);
+        }
+    }
+
+    /*Shrinking the memory does not move it.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pu8Old = pu8Mem;
+        u32Ret = jf_jiukun_reallocMemory((void **)&pu8Mem, 100);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (pu8Old != pu8Mem))
+            u32Ret = JF_ERR_JIUKUN_MEMORY_CORRUPTED;
+    }
+
+    if (pu8Mem != NULL)
+        jf_jiukun_freeMemory((void **)&pu8Mem);
+
+    return u32Ret;
+}
+
+static u32 _testJiukunHwcacheAlign(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_jiukun_cache_create_param_t jjccp;
+    jf_jiukun_cache_t * cache = NULL;
+    void * object[100];
+    u32 i = 0;
+
+    ol_bzero(object, sizeof(object));
+    ol_bzero(&jjccp, sizeof(jjccp));
+    jjccp.jjccp_pstrName = "jiukun-test-align";
+    jjccp.jjccp_sObj = 24;
+    JF_FLAG_SET(jjccp.jjccp_jfCache, JF_JIUKUN_CACHE_CREATE_FLAG_HWCACHE_ALIGN);
+
+    u32Ret = jf_jiukun_createCache(&cache, &jjccp);
+
+    /*All objects must start at cache line boundary.*/
+    for (i = 0; (i < ARRAY_SIZE(object)) && (u32Ret == JF_ERR_NO_ERROR); i ++)
+    {
+        u32Ret = jf_jiukun_allocObject(cache, &object[i]);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (((ulong)object[i] & 63) != 0))
+            u32Ret = JF_ERR_JIUKUN_MEMORY_CORRUPTED;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(object); i ++)
+        if (object[i] != NULL)
+            jf_jiukun_freeObject(cache, &object[i]);
+
+    if (cache != NULL)
+        jf_jiukun_destroyCache(&cache);
+
+    return u32Ret;
+}
+
 static u32 _baseJiukunFunc(void)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -764,6 +904,30 @@ static u32 _baseJiukunFunc(void)
         ol_printf("fail\n");
     }
 
+    ol_printf("reallocate jiukun memory: ");
+    u32Ret = _testJiukunReallocMemory();
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("success\n");
+    }
+    else
+    {
+        ol_printf("fail\n");
+        return u32Ret;
+    }
+
+    ol_printf("allocate cache line aligned jiukun object: ");
+    u32Ret = _testJiukunHwcacheAlign();
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("success\n");
+    }
+    else
+    {
+        ol_printf("fail\n");
+        return u32Ret;
+    }
+
     ol_printf("create jiukun cache: ");
     ol_memset(&jjccp, 0, sizeof(jjccp));
     jjccp.jjccp_pstrName = "jiukun-test";
@@ -814,6 +978,16 @@ olint_t main(olint_t argc, olchar_t ** argv)
     {
         ol_memset(&jjip, 0, sizeof(jjip));
         jjip.jjip_sPool = (1 << MAX_JIUKUN_TEST_ORDER) * JF_JIUKUN_PAGE_SIZE;
+        jjip.jjip_bHugePage = ls_bHugePage;
+        jjip.jjip_bNumaNode = ls_bNumaNode;
+        if (ls_bReclaimer)
+        {
+            jjip.jjip_bReclaimer = TRUE;
+            jjip.jjip_u32ReclaimInterval = 100;
+            jjip.jjip_sReclaimThreshold = 64 * 1024;
+            jjip.jjip_u8PressurePercent = 50;
+            jjip.jjip_fnNotifyPressure = _notifyJiukunPressure;
+        }
 
         u32Ret = jf_jiukun_init(&jjip);
         if (u32Ret == JF_ERR_NO_ERROR)
@@ -830,6 +1004,8 @@ olint_t main(olint_t argc, olchar_t ** argv)
                 u32Ret = _testJiukunAllocateWithoutFree();
             else if (ls_bOutOfBound)
                 u32Ret = _testJiukunOutOfBound();
+            else if (ls_bReclaimer)
+                u32Ret = _testJiukunReclaimer();
             else
                 u32Ret = _baseJiukunFunc();
 
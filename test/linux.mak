@@ -15,28 +15,31 @@ include $(TOPDIR)/mak/lnxcfg.mak
 PROGRAMS = mem-test option-test hashtree-test listhead-test hlisthead-test            \
     listarray-test logger-test process-test thread-test hashtable-test mutex-test     \
     rwlock-test sem-test date-test time-test string-test attask-test                  \
-    bitarray-test conffile-test menu-test crc-test dynlib-test array-test             \
+    bitarray-test conffile-test menu-test crc-test crc-bench dynlib-test array-test   \
     ifmgmt-test ipaddr-test sharedmemory-test-consumer sharedmemory-test-worker       \
     files-test hsm-test host-test respool-test bitop-test ptree-test                  \
-    jiukun-test cghash-test cgmac-test encrypt-test dlinklist-test                    \
+    jiukun-test jiukun-bench cghash-test cgmac-test encrypt-test dlinklist-test       \
     prng-test encode-test xmlparser-test rand-test persistency-test                   \
     archive-test user-test httpparser-test network-test linklist-test                 \
     network-test-server network-test-client network-test-client-chain                 \
     matrix-test webclient-test sqlite-test hex-test utimer-test                       \
-    configmgr-test dispatcher-test-bgad dispatcher-test-sysctld
+    configmgr-test dispatcher-test-bgad dispatcher-test-sysctld ringqueue-test        \
+    threadpool-test
 
 SOURCES = mem-test.c option-test.c hashtree-test.c listhead-test.c hlisthead-test.c             \
     listarray-test.c logger-test.c process-test.c thread-test.c hashtable-test.c mutex-test.c   \
     rwlock-test.c sem-test.c date-test.c time-test.c string-test.c attask-test.c                \
-    bitarray-test.c conffile-test.c menu-test.c crc-test.c dynlib-test.c array-test.c           \
+    bitarray-test.c conffile-test.c menu-test.c crc-test.c crc-bench.c dynlib-test.c            \
+    array-test.c                                                                                \
     ifmgmt-test.c ipaddr-test.c sharedmemory-test-consumer.c sharedmemory-test-worker.c         \
     files-test.c hsm-test.c host-test.c respool-test.c bitop-test.c ptree-test.c                \
-    jiukun-test.c cghash-test.c cgmac-test.c encrypt-test.c dlinklist-test.c                    \
+    jiukun-test.c jiukun-bench.c cghash-test.c cgmac-test.c encrypt-test.c dlinklist-test.c     \
     prng-test.c encode-test.c xmlparser-test.c rand-test.c persistency-test.c                   \
     archive-test.c user-test.c httpparser-test.c network-test.c linklist-test.c                 \
     network-test-server.c network-test-client.c network-test-client-chain.c                     \
     matrix-test.c webclient-test.c sqlite-test.c hex-test.c utimer-test.c                       \
-    configmgr-test.c dispatcher-test-bgad.c dispatcher-test-sysctld.c
+    configmgr-test.c dispatcher-test-bgad.c dispatcher-test-sysctld.c ringqueue-test.c          \
+    threadpool-test.c
 
 include $(TOPDIR)/mak/lnxobjdef.mak
 
@@ -49,13 +52,14 @@ EXTRA_INC_DIR =
 all: $(FULL_PROGRAMS)
 
 $(BIN_DIR)/time-test: time-test.o $(JIUTAI_DIR)/jf_time.o $(JIUTAI_DIR)/jf_date.o \
-       $(JIUTAI_DIR)/jf_option.o
+       $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_clock.o $(JIUTAI_DIR)/jf_thread.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_string -ljf_logger
 
 $(BIN_DIR)/date-test: date-test.o $(JIUTAI_DIR)/jf_date.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_string -ljf_logger
 
-$(BIN_DIR)/hashtree-test: hashtree-test.o $(JIUTAI_DIR)/jf_hashtree.o $(JIUTAI_DIR)/jf_option.o
+$(BIN_DIR)/hashtree-test: hashtree-test.o $(JIUTAI_DIR)/jf_hashtree.o $(JIUTAI_DIR)/jf_option.o \
+       $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
 $(BIN_DIR)/option-test: option-test.o $(JIUTAI_DIR)/jf_option.o
@@ -86,19 +90,21 @@ $(BIN_DIR)/mem-test: mem-test.o $(JIUTAI_DIR)/jf_mem.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS)
 
 $(BIN_DIR)/sem-test: sem-test.o $(JIUTAI_DIR)/jf_sem.o $(JIUTAI_DIR)/jf_process.o \
-       $(JIUTAI_DIR)/jf_thread.o
+       $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
 
 $(BIN_DIR)/mutex-test: mutex-test.o $(JIUTAI_DIR)/jf_mutex.o $(JIUTAI_DIR)/jf_process.o \
-       $(JIUTAI_DIR)/jf_thread.o
+       $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
 
 $(BIN_DIR)/rwlock-test: rwlock-test.o $(JIUTAI_DIR)/jf_rwlock.o $(JIUTAI_DIR)/jf_process.o \
-       $(JIUTAI_DIR)/jf_thread.o
-	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
+       $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_drwlock.o $(JIUTAI_DIR)/jf_option.o \
+       $(JIUTAI_DIR)/jf_time.o
+	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
 $(BIN_DIR)/hashtable-test: hashtable-test.o $(JIUTAI_DIR)/jf_hashtable.o $(JIUTAI_DIR)/jf_process.o \
-       $(JIUTAI_DIR)/jf_option.o
+       $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_flattable.o $(JIUTAI_DIR)/jf_time.o \
+       $(JIUTAI_DIR)/jf_concurrent_hashtable.o $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_mutex.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
 $(BIN_DIR)/string-test: string-test.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_hex.o
@@ -106,13 +112,13 @@ $(BIN_DIR)/string-test: string-test.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf
        -ljf_jiukun
 
 $(BIN_DIR)/attask-test: attask-test.o $(JIUTAI_DIR)/jf_attask.o $(JIUTAI_DIR)/jf_time.o \
-       $(JIUTAI_DIR)/jf_rand.o $(JIUTAI_DIR)/jf_process.o
+       $(JIUTAI_DIR)/jf_rand.o $(JIUTAI_DIR)/jf_process.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
 $(BIN_DIR)/hex-test: hex-test.o $(JIUTAI_DIR)/jf_hex.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
 
-$(BIN_DIR)/bitarray-test: bitarray-test.o $(JIUTAI_DIR)/jf_option.o
+$(BIN_DIR)/bitarray-test: bitarray-test.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_bitmap.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_string \
        -ljf_jiukun
 
@@ -127,17 +133,33 @@ $(BIN_DIR)/menu-test: menu-test.o $(JIUTAI_DIR)/jf_menu.o $(JIUTAI_DIR)/jf_proce
 $(BIN_DIR)/crc-test: crc-test.o $(JIUTAI_DIR)/jf_crc.o $(JIUTAI_DIR)/jf_hex.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
 
+$(BIN_DIR)/crc-bench: crc-bench.o $(JIUTAI_DIR)/jf_crc.o $(JIUTAI_DIR)/jf_time.o \
+       $(JIUTAI_DIR)/jf_option.o
+	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger
+
 $(BIN_DIR)/dynlib-test: dynlib-test.o $(JIUTAI_DIR)/jf_dynlib.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ldl -ljf_logger -ljf_jiukun
 
+$(BIN_DIR)/ringqueue-test: ringqueue-test.o $(JIUTAI_DIR)/jf_ringqueue.o $(JIUTAI_DIR)/jf_queue.o \
+       $(JIUTAI_DIR)/jf_mutex.o $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_time.o \
+       $(JIUTAI_DIR)/jf_option.o
+	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
+
+$(BIN_DIR)/threadpool-test: threadpool-test.o $(JIUTAI_DIR)/jf_threadpool.o \
+       $(JIUTAI_DIR)/jf_mutex.o $(JIUTAI_DIR)/jf_sem.o $(JIUTAI_DIR)/jf_thread.o \
+       $(JIUTAI_DIR)/jf_time.o $(JIUTAI_DIR)/jf_option.o
+	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
+
 $(BIN_DIR)/array-test: array-test.o $(JIUTAI_DIR)/jf_array.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
-$(BIN_DIR)/sharedmemory-test-worker: sharedmemory-test-worker.o $(JIUTAI_DIR)/jf_sharedmemory.o
+$(BIN_DIR)/sharedmemory-test-worker: sharedmemory-test-worker.o $(JIUTAI_DIR)/jf_sharedmemory.o \
+       $(JIUTAI_DIR)/jf_shmring.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun \
        -ljf_uuid -ljf_cghash -ljf_ifmgmt -ljf_prng -ljf_files -ljf_string
 
-$(BIN_DIR)/sharedmemory-test-consumer: sharedmemory-test-consumer.o $(JIUTAI_DIR)/jf_sharedmemory.o
+$(BIN_DIR)/sharedmemory-test-consumer: sharedmemory-test-consumer.o $(JIUTAI_DIR)/jf_sharedmemory.o \
+       $(JIUTAI_DIR)/jf_shmring.o $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun \
        -ljf_uuid
 
@@ -161,15 +183,16 @@ $(BIN_DIR)/host-test: host-test.o $(JIUTAI_DIR)/jf_host.o
        -ljf_logger -ljf_files -ljf_jiukun
 
 $(BIN_DIR)/respool-test: respool-test.o $(JIUTAI_DIR)/jf_respool.o $(JIUTAI_DIR)/jf_mutex.o \
-       $(JIUTAI_DIR)/jf_array.o $(JIUTAI_DIR)/jf_process.o $(JIUTAI_DIR)/jf_sem.o \
-       $(JIUTAI_DIR)/jf_thread.o
+       $(JIUTAI_DIR)/jf_process.o $(JIUTAI_DIR)/jf_sem.o $(JIUTAI_DIR)/jf_thread.o \
+       $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
 $(BIN_DIR)/bitop-test: bitop-test.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) 
 
 $(BIN_DIR)/ptree-test: ptree-test.o $(JIUTAI_DIR)/jf_ptree.o $(JIUTAI_DIR)/jf_option.o \
-       $(JIUTAI_DIR)/jf_linklist.o $(JIUTAI_DIR)/jf_hashtree.o $(JIUTAI_DIR)/jf_stack.o
+       $(JIUTAI_DIR)/jf_linklist.o $(JIUTAI_DIR)/jf_hashtree.o $(JIUTAI_DIR)/jf_stack.o \
+       $(JIUTAI_DIR)/jf_time.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun \
        -ljf_string
 
@@ -177,6 +200,10 @@ $(BIN_DIR)/jiukun-test: jiukun-test.o $(JIUTAI_DIR)/jf_process.o $(JIUTAI_DIR)/j
        $(JIUTAI_DIR)/jf_thread.o $(JIUTAI_DIR)/jf_option.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
 
+$(BIN_DIR)/jiukun-bench: jiukun-bench.o $(JIUTAI_DIR)/jf_mutex.o $(JIUTAI_DIR)/jf_thread.o \
+       $(JIUTAI_DIR)/jf_time.o $(JIUTAI_DIR)/jf_option.o
+	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_logger -ljf_jiukun
+
 $(BIN_DIR)/cghash-test: cghash-test.o $(JIUTAI_DIR)/jf_option.o $(JIUTAI_DIR)/jf_hex.o
 	$(CC) $(LDFLAGS) $(EXTRA_LDFLAGS) -L$(LIB_DIR) $^ -o $@ $(SYSLIBS) -ljf_cghash -ljf_logger \
        -ljf_string
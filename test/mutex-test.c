@@ -6,11 +6,12 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# Build with PROFILE_MUTEX=yes to see the contention profile of the function test.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -20,6 +21,8 @@
 #include "jf_mutex.h"
 #include "jf_process.h"
 #include "jf_thread.h"
+#include "jf_option.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -29,8 +32,215 @@ static olint_t nMutex = 0;
 
 #define MAX_RESOURCE_COUNT  1
 
+static boolean_t ls_bMutexTestFunction = FALSE;
+static u32 ls_u32MutexTestNumOfThread = 4;
+static u32 ls_u32MutexTestNumOfOp = 1000000;
+
+/** The mutex and counter for performance test.
+ */
+static jf_mutex_t ls_jmMutexTestLock;
+static u64 ls_u64MutexTestCounter;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static void _printMutexTestUsage(void)
+{
+    ol_printf("\
+Usage: mutex-test [-t] [-p count] [-n count] [-h]\n\
+  -t: test timed acquire and compare the normal and adaptive mutex.\n\
+  -p: number of threads for performance test, 4 by default.\n\
+  -n: number of acquire per thread for performance test, 1000000 by default.\n\
+  -h: print the usage.\n\
+  By default, the producer and consumer run for about 1 minute.\n");
+    ol_printf("\n");
+}
+
+static u32 _parseMutexTestCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "tp:n:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printMutexTestUsage();
+            exit(0);
+            break;
+        case 't':
+            ls_bMutexTestFunction = TRUE;
+            break;
+        case 'p':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32MutexTestNumOfThread);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32MutexTestNumOfThread == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'n':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32MutexTestNumOfOp);
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static inline u64 _getMutexTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+JF_THREAD_RETURN_VALUE _mutexTestHolderThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Hold = *(u32 *)pArg;
+
+    /*The main thread waits until the holder acquires the mutex.*/
+    jf_mutex_acquire(&ls_jmMutexTestLock);
+    *(u32 *)pArg = 0;
+    jf_time_milliSleep(u32Hold);
+    jf_mutex_release(&ls_jmMutexTestLock);
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+/** Acquire the mutex with timeout when another thread holds the mutex for "u32Hold" ms.
+ */
+static u32 _testMutexTimedAcquire(u32 u32Hold, u32 u32Timeout, u32 u32Expected)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR, u32Acquire;
+    volatile u32 u32Arg = u32Hold;
+    jf_thread_id_t jti;
+    u64 u64Time;
+
+    u32Ret = jf_thread_create(&jti, NULL, _mutexTestHolderThread, (void *)&u32Arg);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    while (u32Arg != 0)
+        jf_time_milliSleep(1);
+
+    u64Time = _getMutexTestNanoTime();
+    u32Acquire = jf_mutex_acquireWithTimeout(&ls_jmMutexTestLock, u32Timeout);
+    u64Time = (_getMutexTestNanoTime() - u64Time) / 1000000;
+    if (u32Acquire == JF_ERR_NO_ERROR)
+        jf_mutex_release(&ls_jmMutexTestLock);
+
+    jf_thread_waitForThreadTermination(jti, NULL);
+
+    ol_printf(
+        "hold %u ms, acquire with %u ms timeout: %s after %llu ms\n", u32Hold, u32Timeout,
+        (u32Acquire == JF_ERR_NO_ERROR) ? "acquired" : "timeout", u64Time);
+
+    if (u32Acquire != u32Expected)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if ((u32Acquire == JF_ERR_NO_ERROR) && (u64Time >= u32Timeout))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if ((u32Acquire == JF_ERR_TIMEOUT) && (u64Time < u32Timeout))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+JF_THREAD_RETURN_VALUE _mutexTestWorkerThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index;
+
+    for (u32Index = 0; u32Index < ls_u32MutexTestNumOfOp; u32Index ++)
+    {
+        jf_mutex_acquire(&ls_jmMutexTestLock);
+        ls_u64MutexTestCounter ++;
+        jf_mutex_release(&ls_jmMutexTestLock);
+    }
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _testMutexPerformance(boolean_t bAdaptive)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index, u32NumOfThread = 0;
+    jf_thread_id_t jti[64];
+    u64 u64Time, u64NumOfOp;
+
+    if (bAdaptive)
+        u32Ret = jf_mutex_initAdaptive(&ls_jmMutexTestLock);
+    else
+        u32Ret = jf_mutex_init(&ls_jmMutexTestLock);
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    ls_u64MutexTestCounter = 0;
+    u64Time = _getMutexTestNanoTime();
+
+    for (u32Index = 0; (u32Index < MIN(ls_u32MutexTestNumOfThread, ARRAY_SIZE(jti))) &&
+             (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        u32Ret = jf_thread_create(&jti[u32Index], NULL, _mutexTestWorkerThread, NULL);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32NumOfThread ++;
+    }
+
+    for (u32Index = 0; u32Index < u32NumOfThread; u32Index ++)
+        jf_thread_waitForThreadTermination(jti[u32Index], NULL);
+
+    u64Time = _getMutexTestNanoTime() - u64Time;
+    u64NumOfOp = (u64)u32NumOfThread * ls_u32MutexTestNumOfOp;
+
+    jf_mutex_fini(&ls_jmMutexTestLock);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf(
+            "%s mutex: %u threads, %llu acquire in %llu ms, %llu ns each\n",
+            bAdaptive ? "adaptive" : "normal", u32NumOfThread, u64NumOfOp, u64Time / 1000000,
+            u64Time / MAX(u64NumOfOp, 1));
+
+        if (ls_u64MutexTestCounter != u64NumOfOp)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+static u32 _testMutexFunction(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = jf_mutex_init(&ls_jmMutexTestLock);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The mutex is acquired as soon as it's released.*/
+        u32Ret = _testMutexTimedAcquire(200, 2000, JF_ERR_NO_ERROR);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testMutexTimedAcquire(500, 100, JF_ERR_TIMEOUT);
+
+        jf_mutex_fini(&ls_jmMutexTestLock);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testMutexPerformance(FALSE);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testMutexPerformance(TRUE);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("mutex test passed\n");
+
+    return u32Ret;
+}
+
 JF_THREAD_RETURN_VALUE consumer(void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -94,8 +304,17 @@ olint_t main(olint_t argc, olchar_t ** argv)
     u32 u32Ret = JF_ERR_NO_ERROR;
     olchar_t strErrMsg[300];
 
-    u32Ret = jf_mutex_init(&ls_jmLock);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    u32Ret = _parseMutexTestCmdLineParam(argc, argv);
+    if ((u32Ret == JF_ERR_NO_ERROR) && ls_bMutexTestFunction)
+    {
+        u32Ret = _testMutexFunction();
+    }
+    else if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_mutex_init(&ls_jmLock);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (! ls_bMutexTestFunction))
     {
         u32Ret = jf_thread_create(NULL, NULL, producer, (void *)1);
         if (u32Ret == JF_ERR_NO_ERROR)
@@ -6,11 +6,15 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The path index is tested by applying the same operations to trees with and without the
+ *   index, the nodes found must be the same and in the same order.
+ *  -# The arena mode is tested in the same way with trees created with and without arena.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
+
 /* --- internal header files -------------------------------------------------------------------- */
 
 #include "jf_basic.h"
@@ -19,9 +23,35 @@
 #include "jf_ptree.h"
 #include "jf_option.h"
 #include "jf_jiukun.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Number of operation for testing path index.
+ */
+#define PTREE_TEST_INDEX_OPS                 (3000)
+
+/** Number of section and item in the tree for testing path index.
+ */
+#define PTREE_TEST_INDEX_SECTIONS            (16)
+#define PTREE_TEST_INDEX_ITEMS               (32)
+
+/** Number of add and delete operation for testing the size of path index.
+ */
+#define PTREE_TEST_INDEX_CHURN_OPS           (100000)
+
+/** Maximum number of node with the same path.
+ */
+#define PTREE_TEST_MAX_NODES                 (256)
+
+/** Size of arena chunk for testing arena, it's small so many chunks are allocated.
+ */
+#define PTREE_TEST_ARENA_CHUNK_SIZE          (1024)
+
+/** Number of section and item in the tree for measuring the build and destroy time.
+ */
+#define PTREE_TEST_BENCH_SECTIONS            (200)
+#define PTREE_TEST_BENCH_ITEMS               (100)
 
 /* --- private routine section ------------------------------------------------------------------ */
 
@@ -242,7 +272,7 @@ static u32 _testPtreeNode(void)
         u32Ret = jf_ptree_findAllNode(pPtree, pstr, ol_strlen(pstr), fnode, &u16NumOfNode);
         if (u32Ret == JF_ERR_NO_ERROR)
         {
-            u32Ret = jf_ptree_deleteNode(&fnode[0]);
+            u32Ret = jf_ptree_deleteNode(pPtree, &fnode[0]);
         }
 
         if (u32Ret == JF_ERR_NO_ERROR)
@@ -257,12 +287,552 @@ static u32 _testPtreeNode(void)
     return u32Ret;
 }
 
+static inline u64 _getPtreeTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+/** Apply one random operation to both trees, the second tree is the one under test.
+ */
+static u32 _applyPtreeTestOp(jf_ptree_t ** pPtree, u32 u32Op)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Sec = (u32)rand() % PTREE_TEST_INDEX_SECTIONS;
+    u32 u32Item = (u32)rand() % PTREE_TEST_INDEX_ITEMS;
+    u32 u32Pick = (u32)rand(), u32Index = 0;
+    olchar_t strKey[64], strName[32], strValue[16];
+    olsize_t sValue = ol_sprintf(strValue, "%u", u32Op);
+    jf_ptree_node_t * fnode[PTREE_TEST_MAX_NODES];
+    jf_ptree_node_t * pNode = NULL;
+    u16 u16NumOfNode = 0;
+
+    for (u32Index = 0; (u32Index < 2) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+    {
+        u16NumOfNode = ARRAY_SIZE(fnode);
+
+        switch (u32Op % 8)
+        {
+        case 0:
+            /*Duplicate section.*/
+            ol_sprintf(strName, "sec%u", u32Sec);
+            u32Ret = jf_ptree_findNode(pPtree[u32Index], "conf", 4, &pNode);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_addChildNode(
+                    pPtree[u32Index], pNode, NULL, 0, strName, ol_strlen(strName), NULL, 0,
+                    &pNode);
+            break;
+        case 1:
+        case 2:
+            /*Duplicate item in a random section.*/
+            ol_sprintf(strKey, "conf.sec%u", u32Sec);
+            ol_sprintf(strName, "item%u", u32Item);
+            u32Ret = jf_ptree_findAllNode(
+                pPtree[u32Index], strKey, ol_strlen(strKey), fnode, &u16NumOfNode);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_addChildNode(
+                    pPtree[u32Index], fnode[u32Pick % u16NumOfNode], NULL, 0, strName,
+                    ol_strlen(strName), strValue, sValue, &pNode);
+            else if (u32Ret == JF_ERR_PTREE_NODE_NOT_FOUND)
+                u32Ret = JF_ERR_NO_ERROR;
+            break;
+        case 3:
+            /*Delete a random item.*/
+            ol_sprintf(strKey, "conf.sec%u.item%u", u32Sec, u32Item);
+            u32Ret = jf_ptree_findAllNode(
+                pPtree[u32Index], strKey, ol_strlen(strKey), fnode, &u16NumOfNode);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_deleteNode(pPtree[u32Index], &fnode[u32Pick % u16NumOfNode]);
+            else if (u32Ret == JF_ERR_PTREE_NODE_NOT_FOUND)
+                u32Ret = JF_ERR_NO_ERROR;
+            break;
+        default:
+            /*Add or change the item.*/
+            ol_sprintf(strKey, "conf.sec%u.item%u", u32Sec, u32Item);
+            u32Ret = jf_ptree_replaceNode(
+                pPtree[u32Index], strKey, ol_strlen(strKey), strValue, sValue, NULL);
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static u32 _comparePtreeTestResult(jf_ptree_t ** pPtree)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Sec = 0, u32Item = 0, u32Index = 0, u32Tree = 0;
+    olchar_t strKey[64];
+    jf_ptree_node_t * fnode[2][PTREE_TEST_MAX_NODES];
+    u16 u16NumOfNode[2];
+    u32 u32Ret2[2];
+    olchar_t * pstrValue[2];
+    olsize_t sValue[2];
+
+    for (u32Sec = 0; (u32Sec < PTREE_TEST_INDEX_SECTIONS) && (u32Ret == JF_ERR_NO_ERROR); u32Sec ++)
+    {
+        for (u32Item = 0; (u32Item <= PTREE_TEST_INDEX_ITEMS) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Item ++)
+        {
+            /*The last one is the section.*/
+            if (u32Item == PTREE_TEST_INDEX_ITEMS)
+                ol_sprintf(strKey, "conf.sec%u", u32Sec);
+            else
+                ol_sprintf(strKey, "conf.sec%u.item%u", u32Sec, u32Item);
+
+            for (u32Tree = 0; u32Tree < 2; u32Tree ++)
+            {
+                u16NumOfNode[u32Tree] = PTREE_TEST_MAX_NODES;
+                u32Ret2[u32Tree] = jf_ptree_findAllNode(
+                    pPtree[u32Tree], strKey, ol_strlen(strKey), fnode[u32Tree],
+                    &u16NumOfNode[u32Tree]);
+            }
+
+            if ((u32Ret2[0] != u32Ret2[1]) ||
+                ((u32Ret2[0] == JF_ERR_NO_ERROR) && (u16NumOfNode[0] != u16NumOfNode[1])))
+            {
+                ol_printf("Key %s, different number of node\n", strKey);
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+            }
+
+            for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Ret2[0] == JF_ERR_NO_ERROR) &&
+                     (u32Index < u16NumOfNode[0]); u32Index ++)
+            {
+                for (u32Tree = 0; u32Tree < 2; u32Tree ++)
+                    jf_ptree_getNodeValue(
+                        fnode[u32Tree][u32Index], &pstrValue[u32Tree], &sValue[u32Tree]);
+
+                if ((sValue[0] != sValue[1]) ||
+                    ((sValue[0] > 0) && (ol_memcmp(pstrValue[0], pstrValue[1], sValue[0]) != 0)))
+                {
+                    ol_printf("Key %s, node %u has different value\n", strKey, u32Index);
+                    u32Ret = JF_ERR_PROGRAM_ERROR;
+                }
+            }
+        }
+    }
+
+    return u32Ret;
+}
+
+static u32 _benchPtreeFindNode(jf_ptree_t * pPtree, const olchar_t * pstrName)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0, u32Loop = 100000;
+    olchar_t strKey[64];
+    jf_ptree_node_t * pNode = NULL;
+    u64 u64Start = 0, u64Elapsed = 0;
+
+    u64Start = _getPtreeTestNanoTime();
+    for (u32Index = 0; u32Index < u32Loop; u32Index ++)
+    {
+        ol_sprintf(
+            strKey, "conf.sec%u.item%u", u32Index % PTREE_TEST_INDEX_SECTIONS,
+            (u32Index / PTREE_TEST_INDEX_SECTIONS) % PTREE_TEST_INDEX_ITEMS);
+        jf_ptree_findNode(pPtree, strKey, ol_strlen(strKey), &pNode);
+    }
+    u64Elapsed = _getPtreeTestNanoTime() - u64Start;
+
+    ol_printf("findNode %s: %llu ns/op\n", pstrName, u64Elapsed / u32Loop);
+
+    return u32Ret;
+}
+
+static u32 _testPtreePathIndex(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ptree_t * pPtree[2] = {NULL, NULL};
+    jf_ptree_node_t * pNode = NULL;
+    u32 u32Op = 0;
+
+    ol_printf("Test path index\n");
+
+    srand(1);
+
+    u32Ret = jf_ptree_create(&pPtree[0]);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_create(&pPtree[1]);
+
+    /*The index is enabled before adding nodes.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_enablePathIndex(pPtree[1]);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree[0], NULL, NULL, 0, "conf", 4, NULL, 0, &pNode);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree[1], NULL, NULL, 0, "conf", 4, NULL, 0, &pNode);
+
+    for (u32Op = 0; (u32Op < PTREE_TEST_INDEX_OPS) && (u32Ret == JF_ERR_NO_ERROR); u32Op ++)
+        u32Ret = _applyPtreeTestOp(pPtree, u32Op);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _comparePtreeTestResult(pPtree);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        _benchPtreeFindNode(pPtree[0], "without index");
+        _benchPtreeFindNode(pPtree[1], "with index");
+
+        /*The index is enabled with existing nodes.*/
+        u32Ret = jf_ptree_enablePathIndex(pPtree[0]);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _comparePtreeTestResult(pPtree);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    if (pPtree[0] != NULL)
+        jf_ptree_destroy(&pPtree[0]);
+
+    if (pPtree[1] != NULL)
+        jf_ptree_destroy(&pPtree[1]);
+
+    return u32Ret;
+}
+
+/** Add and delete a node with child repeatedly, the path index must not grow.
+ */
+static u32 _testPtreePathIndexChurn(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ptree_t * pPtree = NULL;
+    jf_ptree_node_t * pRoot = NULL, * pNode = NULL, * pChild = NULL;
+    jf_ptree_path_index_stat_t stat;
+    u32 u32Op = 0;
+
+    ol_printf("Test path index with adding and deleting node\n");
+
+    u32Ret = jf_ptree_create(&pPtree);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_enablePathIndex(pPtree);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree, NULL, NULL, 0, "conf", 4, NULL, 0, &pRoot);
+
+    jf_ptree_getPathIndexStat(pPtree, &stat);
+    ol_printf(
+        "Initial: %u nodes, %u buckets\n", stat.jppis_u32NumOfNode, stat.jppis_u32NumOfBucket);
+
+    for (u32Op = 0; (u32Op < PTREE_TEST_INDEX_CHURN_OPS) && (u32Ret == JF_ERR_NO_ERROR); u32Op ++)
+    {
+        u32Ret = jf_ptree_addChildNode(pPtree, pRoot, NULL, 0, "sec", 3, NULL, 0, &pNode);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_ptree_addChildNode(pPtree, pNode, NULL, 0, "item", 4, "1", 1, &pChild);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_ptree_deleteNode(pPtree, &pNode);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Only the root node is left, the index is not grown.*/
+        jf_ptree_getPathIndexStat(pPtree, &stat);
+        ol_printf(
+            "After %u add and delete: %u nodes, %u buckets\n", PTREE_TEST_INDEX_CHURN_OPS,
+            stat.jppis_u32NumOfNode, stat.jppis_u32NumOfBucket);
+        if ((stat.jppis_u32NumOfNode != 1) || (stat.jppis_u32NumOfBucket > 64))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    if (pPtree != NULL)
+        jf_ptree_destroy(&pPtree);
+
+    return u32Ret;
+}
+
+/** Add, change and delete attributes of sections in both trees and compare the attributes.
+ */
+static u32 _testPtreeArenaAttribute(jf_ptree_t ** pPtree)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Sec = 0, u32Attr = 0, u32Tree = 0;
+    olchar_t strKey[64], strName[16], strValue[PTREE_TEST_ARENA_CHUNK_SIZE];
+    jf_ptree_node_t * pNode[2];
+    jf_ptree_node_attribute_t * pAttr[2];
+    u32 u32Ret2[2];
+    olchar_t * pstrValue[2];
+    olsize_t sValue[2], sValueNew = 0;
+
+    for (u32Sec = 0; (u32Sec < PTREE_TEST_INDEX_SECTIONS) && (u32Ret == JF_ERR_NO_ERROR); u32Sec ++)
+    {
+        ol_sprintf(strKey, "conf.sec%u", u32Sec);
+        for (u32Tree = 0; (u32Tree < 2) && (u32Ret == JF_ERR_NO_ERROR); u32Tree ++)
+            u32Ret = jf_ptree_findNode(pPtree[u32Tree], strKey, ol_strlen(strKey), &pNode[u32Tree]);
+
+        for (u32Attr = 0; (u32Attr < 8) && (u32Ret == JF_ERR_NO_ERROR); u32Attr ++)
+        {
+            ol_sprintf(strName, "attr%u", u32Attr);
+            /*The value is empty, short, or longer than the chunk of arena.*/
+            sValueNew = (olsize_t)((u32)rand() % 4) * 300;
+            ol_memset(strValue, 'a' + u32Attr, sValueNew);
+
+            for (u32Tree = 0; (u32Tree < 2) && (u32Ret == JF_ERR_NO_ERROR); u32Tree ++)
+            {
+                u32Ret = jf_ptree_addNodeAttribute(
+                    pNode[u32Tree], "a", 1, strName, ol_strlen(strName), strValue, sValueNew);
+
+                /*Change the value of existing attribute, the value can be longer or shorter.*/
+                if (u32Ret == JF_ERR_NO_ERROR)
+                    u32Ret = jf_ptree_findNodeAttribute(
+                        pNode[u32Tree], "a", 1, "attr0", 5, &pAttr[u32Tree]);
+
+                if (u32Ret == JF_ERR_NO_ERROR)
+                    u32Ret = jf_ptree_changeNodeAttributeValue(
+                        pAttr[u32Tree], strValue, sValueNew / 2);
+
+                if ((u32Ret == JF_ERR_NO_ERROR) && (u32Attr == 7))
+                    u32Ret = jf_ptree_findNodeAttribute(
+                        pNode[u32Tree], "a", 1, "attr3", 5, &pAttr[u32Tree]);
+
+                if ((u32Ret == JF_ERR_NO_ERROR) && (u32Attr == 7))
+                    u32Ret = jf_ptree_deleteNodeAttribute(pNode[u32Tree], pAttr[u32Tree]);
+            }
+        }
+
+        for (u32Attr = 0; (u32Attr < 8) && (u32Ret == JF_ERR_NO_ERROR); u32Attr ++)
+        {
+            ol_sprintf(strName, "attr%u", u32Attr);
+            for (u32Tree = 0; u32Tree < 2; u32Tree ++)
+            {
+                sValue[u32Tree] = 0;
+                u32Ret2[u32Tree] = jf_ptree_findNodeAttribute(
+                    pNode[u32Tree], "a", 1, strName, ol_strlen(strName), &pAttr[u32Tree]);
+                if (u32Ret2[u32Tree] == JF_ERR_NO_ERROR)
+                    jf_ptree_getNodeAttributeValue(
+                        pAttr[u32Tree], &pstrValue[u32Tree], &sValue[u32Tree]);
+            }
+
+            if ((u32Ret2[0] != u32Ret2[1]) || (sValue[0] != sValue[1]) ||
+                ((sValue[0] > 0) && (ol_memcmp(pstrValue[0], pstrValue[1], sValue[0]) != 0)))
+            {
+                ol_printf("Key %s, attribute %s is different\n", strKey, strName);
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+            }
+        }
+    }
+
+    return u32Ret;
+}
+
+static u32 _benchPtreeBuildAndDestroy(jf_ptree_create_param_t * pjpcp, const olchar_t * pstrName)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Sec = 0, u32Item = 0;
+    olchar_t strName[32], strValue[16];
+    jf_ptree_t * pPtree = NULL;
+    jf_ptree_node_t * pRoot = NULL, * pSec = NULL, * pItem = NULL;
+    u64 u64Start = 0, u64Build = 0, u64Destroy = 0;
+
+    u64Start = _getPtreeTestNanoTime();
+
+    u32Ret = jf_ptree_createWithParam(&pPtree, pjpcp);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree, NULL, NULL, 0, "conf", 4, NULL, 0, &pRoot);
+
+    for (u32Sec = 0; (u32Sec < PTREE_TEST_BENCH_SECTIONS) && (u32Ret == JF_ERR_NO_ERROR); u32Sec ++)
+    {
+        u32Ret = jf_ptree_addChildNode(pPtree, pRoot, NULL, 0, "section", 7, NULL, 0, &pSec);
+
+        for (u32Item = 0; (u32Item < PTREE_TEST_BENCH_ITEMS) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Item ++)
+        {
+            ol_sprintf(strName, "item%u", u32Item);
+            ol_sprintf(strValue, "%u", u32Sec * PTREE_TEST_BENCH_ITEMS + u32Item);
+            u32Ret = jf_ptree_addChildNode(
+                pPtree, pSec, NULL, 0, strName, ol_strlen(strName), strValue, ol_strlen(strValue),
+                &pItem);
+
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_addNodeAttribute(pItem, NULL, 0, "type", 4, "string", 6);
+        }
+    }
+
+    u64Build = _getPtreeTestNanoTime() - u64Start;
+
+    u64Start = _getPtreeTestNanoTime();
+    if (pPtree != NULL)
+        jf_ptree_destroy(&pPtree);
+    u64Destroy = _getPtreeTestNanoTime() - u64Start;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf(
+            "%s: build %llu us, destroy %llu us for %u nodes\n", pstrName, u64Build / 1000,
+            u64Destroy / 1000, PTREE_TEST_BENCH_SECTIONS * (PTREE_TEST_BENCH_ITEMS + 1) + 1);
+
+    return u32Ret;
+}
+
+/** Change the value short and long again in arena, the value must be overwritten in place.
+ */
+static u32 _testPtreeArenaValue(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ptree_t * pPtree = NULL;
+    jf_ptree_create_param_t jpcp;
+    jf_ptree_node_t * pNode = NULL;
+    jf_ptree_node_attribute_t * pAttr = NULL;
+    olchar_t * pstrValue = NULL, * pstrNodeValue = NULL, * pstrAttrValue = NULL;
+    olsize_t sValue = 0;
+    u32 u32Op = 0;
+
+    ol_printf("Test changing value in arena\n");
+
+    ol_bzero(&jpcp, sizeof(jpcp));
+    jpcp.jpcp_bArena = TRUE;
+
+    u32Ret = jf_ptree_createWithParam(&pPtree, &jpcp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(
+            pPtree, NULL, NULL, 0, "startup", 7, "automatic", 9, &pNode);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addNodeAttribute(pNode, NULL, 0, "type", 4, "automatic", 9);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_findNodeAttribute(pNode, NULL, 0, "type", 4, &pAttr);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_ptree_getNodeValue(pNode, &pstrNodeValue, &sValue);
+        jf_ptree_getNodeAttributeValue(pAttr, &pstrAttrValue, &sValue);
+    }
+
+    for (u32Op = 0; (u32Op < 100) && (u32Ret == JF_ERR_NO_ERROR); u32Op ++)
+    {
+        if (u32Op % 2 == 0)
+        {
+            u32Ret = jf_ptree_changeNodeValue(pNode, "manual", 6);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_changeNodeAttributeValue(pAttr, "manual", 6);
+        }
+        else
+        {
+            u32Ret = jf_ptree_changeNodeValue(pNode, "automatic", 9);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_ptree_changeNodeAttributeValue(pAttr, "automatic", 9);
+        }
+
+        /*The value is not reallocated as it's not longer than the first one.*/
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            jf_ptree_getNodeValue(pNode, &pstrValue, &sValue);
+            if (pstrValue != pstrNodeValue)
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+        }
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            jf_ptree_getNodeAttributeValue(pAttr, &pstrValue, &sValue);
+            if (pstrValue != pstrAttrValue)
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+        }
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ol_strcmp(pstrNodeValue, "automatic") != 0))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    if (pPtree != NULL)
+        jf_ptree_destroy(&pPtree);
+
+    return u32Ret;
+}
+
+static u32 _testPtreeArena(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ptree_t * pPtree[2] = {NULL, NULL};
+    jf_ptree_create_param_t jpcp;
+    jf_ptree_node_t * pNode = NULL;
+    olchar_t strKey[64];
+    u32 u32Op = 0;
+
+    ol_printf("Test arena\n");
+
+    srand(1);
+
+    ol_bzero(&jpcp, sizeof(jpcp));
+    jpcp.jpcp_bArena = TRUE;
+    jpcp.jpcp_u32ArenaChunkSize = PTREE_TEST_ARENA_CHUNK_SIZE;
+
+    u32Ret = jf_ptree_create(&pPtree[0]);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_createWithParam(&pPtree[1], &jpcp);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree[0], NULL, NULL, 0, "conf", 4, NULL, 0, &pNode);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_ptree_addChildNode(pPtree[1], NULL, NULL, 0, "conf", 4, NULL, 0, &pNode);
+
+    for (u32Op = 0; (u32Op < PTREE_TEST_INDEX_OPS) && (u32Ret == JF_ERR_NO_ERROR); u32Op ++)
+        u32Ret = _applyPtreeTestOp(pPtree, u32Op);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _comparePtreeTestResult(pPtree);
+
+    /*Make sure all sections exist.*/
+    for (u32Op = 0; (u32Op < PTREE_TEST_INDEX_SECTIONS * 2) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Op ++)
+    {
+        ol_sprintf(strKey, "conf.sec%u", u32Op / 2);
+        u32Ret = jf_ptree_replaceNode(pPtree[u32Op % 2], strKey, ol_strlen(strKey), NULL, 0, NULL);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testPtreeArenaAttribute(pPtree);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_bzero(&jpcp, sizeof(jpcp));
+        _benchPtreeBuildAndDestroy(&jpcp, "without arena");
+        jpcp.jpcp_bArena = TRUE;
+        _benchPtreeBuildAndDestroy(&jpcp, "with arena");
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    if (pPtree[0] != NULL)
+        jf_ptree_destroy(&pPtree[0]);
+
+    if (pPtree[1] != NULL)
+        jf_ptree_destroy(&pPtree[1]);
+
+    return u32Ret;
+}
+
 static u32 _testPtree(void)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
 
     _testPtreeNode();
 
+    u32Ret = _testPtreePathIndex();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testPtreePathIndexChurn();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testPtreeArena();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testPtreeArenaValue();
+
     return u32Ret;
 }
 
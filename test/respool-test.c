@@ -24,6 +24,9 @@
 #include "jf_mutex.h"
 #include "jf_sem.h"
 #include "jf_jiukun.h"
+#include "jf_option.h"
+#include "jf_time.h"
+#include "jf_atomic.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -50,9 +53,63 @@ static jf_thread_id_t ls_jtiRespoolTestProducer;
 static boolean_t ls_bRespoolTestTerminateProducer;
 static jf_respool_resource_t * ls_pjrrRespoolTestResource[RESPOOL_TEST_MAX_RESOURCES];
 
+static boolean_t ls_bRespoolTestFunction = FALSE;
+
+#define RESPOOL_TEST_NUM_OF_THREAD     (4)
+#define RESPOOL_TEST_NUM_OF_LOOP       (100000)
+
+/** Number of resources created and destroyed in function test.
+ */
+static u32 ls_u32RespoolTestCreated;
+static u32 ls_u32RespoolTestDestroyed;
+/** Number of resources in use and the maximum number in function test.
+ */
+static u32 ls_u32RespoolTestBusy;
+static u32 ls_u32RespoolTestMaxBusy;
+static u32 ls_u32RespoolTestThreadRet[RESPOOL_TEST_NUM_OF_THREAD];
+static jf_respool_t * ls_pjrRespoolTestPool;
+
 
 /* --- private routine section ------------------------------------------------------------------ */
 
+static void _printRespoolTestUsage(void)
+{
+    ol_printf("\
+Usage: respool-test [-t] [-h]\n\
+  -t: test the get, put and reap of resource pool.\n\
+  -h: print the usage.\n\
+  By default, the worker pool runs until a signal is received.\n");
+    ol_printf("\n");
+}
+
+static u32 _parseRespoolTestCmdLineParam(
+    olint_t argc, olchar_t ** argv, jf_logger_init_param_t * pjlip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "th")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printRespoolTestUsage();
+            exit(0);
+            break;
+        case 't':
+            ls_bRespoolTestFunction = TRUE;
+            pjlip->jlip_u8TraceLevel = JF_LOGGER_TRACE_LEVEL_ERROR;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
 JF_THREAD_RETURN_VALUE _respoolTestWorkerThread(void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -200,6 +257,265 @@ static u32 _testRespool(void)
     return u32Ret;
 }
 
+static u32 _createRespoolTestCounter(
+    jf_respool_resource_t * pr, jf_respool_resource_data_t ** pprd)
+{
+    jf_atomic_fetchAddU32(&ls_u32RespoolTestCreated, 1);
+    *pprd = pr;
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _destroyRespoolTestCounter(
+    jf_respool_resource_t * pr, jf_respool_resource_data_t ** pprd)
+{
+    jf_atomic_fetchAddU32(&ls_u32RespoolTestDestroyed, 1);
+    *pprd = NULL;
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _createRespoolTestCounterPool(
+    jf_respool_t ** ppjr, u32 u32Min, u32 u32Max, boolean_t bReapParttime)
+{
+    jf_respool_create_param_t jrcp;
+
+    ls_u32RespoolTestCreated = ls_u32RespoolTestDestroyed = 0;
+
+    ol_bzero(&jrcp, sizeof(jf_respool_create_param_t));
+    jrcp.jrcp_pstrName = RESPOOL_TEST_RESOURCE_POOL_NAME;
+    jrcp.jrcp_u32MinResources = u32Min;
+    jrcp.jrcp_u32MaxResources = u32Max;
+    jrcp.jrcp_bReapParttime = bReapParttime;
+    jrcp.jrcp_fnCreateResource = _createRespoolTestCounter;
+    jrcp.jrcp_fnDestroyResource = _destroyRespoolTestCounter;
+
+    return jf_respool_create(ppjr, &jrcp);
+}
+
+static inline u64 _getRespoolTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+JF_THREAD_RETURN_VALUE _respoolTestPutThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_respool_resource_t * pjrr = pArg;
+
+    jf_time_milliSleep(200);
+    u32Ret = jf_respool_putResource(ls_pjrRespoolTestPool, &pjrr);
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+JF_THREAD_RETURN_VALUE _respoolTestStressThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 * pu32Ret = pArg;
+    u32 u32Index, u32Busy, u32Max;
+    jf_respool_resource_t * pjrr = NULL;
+
+    for (u32Index = 0; (u32Index < RESPOOL_TEST_NUM_OF_LOOP) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        if (u32Index % 3 == 0)
+        {
+            u32Ret = jf_respool_getResource(ls_pjrRespoolTestPool, &pjrr);
+            if (u32Ret == JF_ERR_REACH_MAX_RESOURCES)
+            {
+                u32Ret = JF_ERR_NO_ERROR;
+                continue;
+            }
+        }
+        else
+        {
+            u32Ret = jf_respool_waitForResource(ls_pjrRespoolTestPool, &pjrr);
+        }
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            u32Busy = jf_atomic_fetchAddU32(&ls_u32RespoolTestBusy, 1) + 1;
+            u32Max = jf_atomic_loadU32(&ls_u32RespoolTestMaxBusy);
+            while ((u32Busy > u32Max) &&
+                   (! jf_atomic_casU32(&ls_u32RespoolTestMaxBusy, u32Max, u32Busy)))
+                u32Max = jf_atomic_loadU32(&ls_u32RespoolTestMaxBusy);
+
+            jf_atomic_fetchAddU32(&ls_u32RespoolTestBusy, (u32)-1);
+            u32Ret = jf_respool_putResource(ls_pjrRespoolTestPool, &pjrr);
+        }
+    }
+
+    *pu32Ret = u32Ret;
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _testRespoolGetPut(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_respool_resource_t * pjrr[4], * pjrrExtra = NULL, * pjrrPut = NULL;
+    jf_thread_id_t jti;
+    u32 u32Index;
+
+    ol_printf("test get and put\n");
+
+    /*2 full time resources and 2 part time resources, part time resources are reaped.*/
+    u32Ret = _createRespoolTestCounterPool(&ls_pjrRespoolTestPool, 2, 4, TRUE);
+
+    for (u32Index = 0; (u32Index < 4) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = jf_respool_getResource(ls_pjrRespoolTestPool, &pjrr[u32Index]);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_respool_getResource(ls_pjrRespoolTestPool, &pjrrExtra) !=
+         JF_ERR_REACH_MAX_RESOURCES))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The resource put back by the thread is got again from cache.*/
+        pjrrPut = pjrr[1];
+        u32Ret = jf_respool_putResource(ls_pjrRespoolTestPool, &pjrr[1]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_respool_getResource(ls_pjrRespoolTestPool, &pjrr[1]);
+        if ((u32Ret == JF_ERR_NO_ERROR) && (pjrr[1] != pjrrPut))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The caller is blocked until the resource is put back by another thread.*/
+        pjrrPut = pjrr[3];
+        u32Ret = jf_thread_create(&jti, NULL, _respoolTestPutThread, pjrr[3]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            u32Ret = jf_respool_waitForResource(ls_pjrRespoolTestPool, &pjrr[3]);
+            jf_thread_waitForThreadTermination(jti, NULL);
+        }
+        if ((u32Ret == JF_ERR_NO_ERROR) && (pjrr[3] != pjrrPut))
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    for (u32Index = 0; (u32Index < 4) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = jf_respool_putResource(ls_pjrRespoolTestPool, &pjrr[u32Index]);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_respool_reapResource(ls_pjrRespoolTestPool);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((ls_u32RespoolTestCreated != 4) || (ls_u32RespoolTestDestroyed != 2)))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    if (ls_pjrRespoolTestPool != NULL)
+        jf_respool_destroy(&ls_pjrRespoolTestPool);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32RespoolTestDestroyed != 4))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    return u32Ret;
+}
+
+static u32 _testRespoolImmediateRelease(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_respool_resource_t * pjrr[3];
+    u32 u32Index;
+
+    ol_printf("test immediate release of part time resource\n");
+
+    u32Ret = _createRespoolTestCounterPool(&ls_pjrRespoolTestPool, 1, 3, FALSE);
+
+    for (u32Index = 0; (u32Index < 3) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = jf_respool_getResource(ls_pjrRespoolTestPool, &pjrr[u32Index]);
+
+    for (u32Index = 0; (u32Index < 3) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = jf_respool_putResource(ls_pjrRespoolTestPool, &pjrr[u32Index]);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((ls_u32RespoolTestCreated != 3) || (ls_u32RespoolTestDestroyed != 2)))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    if (ls_pjrRespoolTestPool != NULL)
+        jf_respool_destroy(&ls_pjrRespoolTestPool);
+
+    return u32Ret;
+}
+
+static u32 _testRespoolStress(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_id_t jti[RESPOOL_TEST_NUM_OF_THREAD];
+    u32 u32Index, u32Created = 0;
+    u64 u64Time = 0;
+
+    ol_printf(
+        "test %u threads, %u get and put in each thread\n", RESPOOL_TEST_NUM_OF_THREAD,
+        RESPOOL_TEST_NUM_OF_LOOP);
+
+    ls_u32RespoolTestBusy = ls_u32RespoolTestMaxBusy = 0;
+    u32Ret = _createRespoolTestCounterPool(&ls_pjrRespoolTestPool, 1, 2, TRUE);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u64Time = _getRespoolTestNanoTime();
+
+    for (u32Index = 0; (u32Index < RESPOOL_TEST_NUM_OF_THREAD) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        u32Ret = jf_thread_create(
+            &jti[u32Index], NULL, _respoolTestStressThread, &ls_u32RespoolTestThreadRet[u32Index]);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Created ++;
+    }
+
+    for (u32Index = 0; u32Index < u32Created; u32Index ++)
+    {
+        jf_thread_waitForThreadTermination(jti[u32Index], NULL);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = ls_u32RespoolTestThreadRet[u32Index];
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Time = _getRespoolTestNanoTime() - u64Time;
+        ol_printf(
+            "%llu ms, max %u resources in use, %u resources created\n", u64Time / 1000000,
+            ls_u32RespoolTestMaxBusy, ls_u32RespoolTestCreated);
+
+        if (ls_u32RespoolTestMaxBusy > 2)
+            u32Ret = JF_ERR_INVALID_DATA;
+    }
+
+    if (ls_pjrRespoolTestPool != NULL)
+        jf_respool_destroy(&ls_pjrRespoolTestPool);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32RespoolTestCreated != ls_u32RespoolTestDestroyed))
+        u32Ret = JF_ERR_INVALID_DATA;
+
+    return u32Ret;
+}
+
+static u32 _testRespoolFunction(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = _testRespoolGetPut();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testRespoolImmediateRelease();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testRespoolStress();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("respool test passed\n");
+
+    return u32Ret;
+}
+
 static void _terminate(olint_t signal)
 {
     ol_printf("get signal\n");
@@ -240,9 +556,20 @@ olint_t main(olint_t argc, olchar_t ** argv)
     ol_bzero(&jjip, sizeof(jjip));
     jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
 
-    jf_logger_init(&jlipParam);
-    u32Ret = jf_jiukun_init(&jjip);
+    u32Ret = _parseRespoolTestCmdLineParam(argc, argv, &jlipParam);
     if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_logger_init(&jlipParam);
+        u32Ret = jf_jiukun_init(&jjip);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && ls_bRespoolTestFunction)
+    {
+        u32Ret = _testRespoolFunction();
+
+        jf_jiukun_fini();
+    }
+    else if (u32Ret == JF_ERR_NO_ERROR)
     {
         u32Ret = jf_process_registerSignalHandlers(_terminate);
 
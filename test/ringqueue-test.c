@@ -0,0 +1,500 @@
+/**
+ *  @file ringqueue-test.c
+ *
+ *  @brief Test file for ring queue defined in jf_ringqueue object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_ringqueue.h"
+#include "jf_queue.h"
+#include "jf_mutex.h"
+#include "jf_thread.h"
+#include "jf_atomic.h"
+#include "jf_time.h"
+#include "jf_jiukun.h"
+#include "jf_option.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+#define TEST_RINGQUEUE_MAX_THREAD            (8)
+#define TEST_RINGQUEUE_CAPACITY              (1024)
+#define TEST_RINGQUEUE_NUM_OF_ITEM           (200000)
+#define TEST_RINGQUEUE_SPIN                  (100)
+
+/** The item is (producer id << 24) + sequence + 1, it's never NULL.
+ */
+#define TEST_RINGQUEUE_ITEM(id, seq)         ((ulong)(((id) << 24) + (seq) + 1))
+#define TEST_RINGQUEUE_ITEM_ID(item)         ((u32)(((ulong)(item) - 1) >> 24))
+#define TEST_RINGQUEUE_ITEM_SEQ(item)        ((u32)(((ulong)(item) - 1) & 0xFFFFFF))
+
+typedef struct
+{
+    /**The ring queue, NULL if jf_queue with mutex is tested.*/
+    jf_ringqueue_t * trt_pjrQueue;
+    jf_queue_t * trt_pjqQueue;
+    jf_mutex_t * trt_pjmLock;
+    u32 trt_u32Id;
+    u32 trt_u32NumOfProducer;
+    u32 trt_u32Error;
+    u32 trt_u32Count;
+    /**Last sequence seen from each producer.*/
+    u32 trt_u32LastSeq[TEST_RINGQUEUE_MAX_THREAD];
+} test_ringqueue_thread_t;
+
+static boolean_t ls_bTestRingqueue = FALSE;
+static boolean_t ls_bBenchmarkRingqueue = FALSE;
+
+/**Number of items consumed by all consumers.*/
+static u32 ls_u32Consumed = 0;
+static u32 ls_u32Start = FALSE;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static void _printRingqueueTestUsage(void)
+{
+    ol_printf("\
+Usage: ringqueue-test [-t] [-b] [logger options] \n\
+  -t: test ring queue.\n\
+  -b: benchmark ring queue against queue with mutex.\n\
+logger options: [-T <0|1|2|3|4|5>] [-O] [-F log file] [-S log file size] \n\
+  -T: the log level. 0: no log, 1: error, 2: warn, 3: info, 4: debug, 5: data.\n\
+  -O: output the log to stdout.\n\
+  -F: output the log to file.\n\
+  -S: the size of log file. No limit if not specified.\n\
+    ");
+    ol_printf("\n");
+}
+
+static u32 _parseRingqueueTestCmdLineParam(
+    olint_t argc, olchar_t ** argv, jf_logger_init_param_t * pjlip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) &&
+           ((nOpt = jf_option_get(argc, argv, "tbT:F:OS:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printRingqueueTestUsage();
+            exit(0);
+            break;
+        case 't':
+            ls_bTestRingqueue = TRUE;
+            break;
+        case 'b':
+            ls_bBenchmarkRingqueue = TRUE;
+            break;
+        case 'T':
+            u32Ret = jf_option_getU8FromString(jf_option_getArg(), &pjlip->jlip_u8TraceLevel);
+            break;
+        case 'F':
+            pjlip->jlip_bLogToFile = TRUE;
+            pjlip->jlip_pstrLogFile = jf_option_getArg();
+            break;
+        case 'O':
+            pjlip->jlip_bLogToStdout = TRUE;
+            break;
+        case 'S':
+            u32Ret = jf_option_getS32FromString(jf_option_getArg(), &pjlip->jlip_sLogFile);
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static inline u64 _getRingqueueTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _testRingqueueBasic(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ringqueue_t * pjr = NULL;
+    jf_ringqueue_create_param_t jrcp;
+    u32 u32Index = 0;
+    void * pData = NULL;
+
+    ol_bzero(&jrcp, sizeof(jrcp));
+    jrcp.jrcp_u32Capacity = 5;
+    jrcp.jrcp_bSingleConsumer = TRUE;
+
+    u32Ret = jf_ringqueue_create(&pjr, &jrcp);
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_ringqueue_getCapacity(pjr) != 8))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Fill the queue twice to test the wrap around.*/
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < 8); u32Index ++)
+        u32Ret = jf_ringqueue_enqueue(pjr, (void *)(ulong)u32Index);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_ringqueue_enqueue(pjr, NULL) != JF_ERR_QUEUE_FULL))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_ringqueue_getSize(pjr) != 8))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < 12); u32Index ++)
+    {
+        u32Ret = jf_ringqueue_dequeue(pjr, &pData);
+        if ((u32Ret == JF_ERR_NO_ERROR) && ((ulong)pData != u32Index))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_ringqueue_enqueue(pjr, (void *)(ulong)(u32Index + 8));
+    }
+
+    for (u32Index = 12; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < 20); u32Index ++)
+    {
+        u32Ret = jf_ringqueue_dequeueWait(pjr, &pData);
+        if ((u32Ret == JF_ERR_NO_ERROR) && ((ulong)pData != u32Index))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_ringqueue_dequeue(pjr, &pData) != JF_ERR_QUEUE_EMPTY))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_ringqueue_dequeueWaitWithTimeout(pjr, &pData, 10) != JF_ERR_TIMEOUT))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (pjr != NULL)
+        jf_ringqueue_destroy(&pjr);
+
+    ol_printf("Basic test: %s\n", (u32Ret == JF_ERR_NO_ERROR) ? "OK" : "FAILED");
+
+    return u32Ret;
+}
+
+static u32 _enqueueRingqueueTest(test_ringqueue_thread_t * ptrt, void * pData)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Spin = 0;
+
+    while (TRUE)
+    {
+        if (ptrt->trt_pjrQueue != NULL)
+        {
+            u32Ret = jf_ringqueue_enqueue(ptrt->trt_pjrQueue, pData);
+        }
+        else
+        {
+            jf_mutex_acquire(ptrt->trt_pjmLock);
+            u32Ret = jf_queue_enqueue(ptrt->trt_pjqQueue, pData);
+            jf_mutex_release(ptrt->trt_pjmLock);
+        }
+
+        if (u32Ret != JF_ERR_QUEUE_FULL)
+            break;
+
+        /*The queue is full, wait for the consumer.*/
+        if (u32Spin < TEST_RINGQUEUE_SPIN)
+        {
+            jf_atomic_cpuRelax();
+            u32Spin ++;
+        }
+        else
+        {
+            jf_time_microSleep(1);
+        }
+    }
+
+    return u32Ret;
+}
+
+JF_THREAD_RETURN_VALUE _ringqueueTestProducer(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_ringqueue_thread_t * ptrt = (test_ringqueue_thread_t *)pArg;
+    u32 u32Seq = 0;
+
+    while (! jf_atomic_loadU32(&ls_u32Start))
+        jf_atomic_cpuRelax();
+
+    for (u32Seq = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Seq < TEST_RINGQUEUE_NUM_OF_ITEM);
+         u32Seq ++)
+        u32Ret = _enqueueRingqueueTest(
+            ptrt, (void *)TEST_RINGQUEUE_ITEM(ptrt->trt_u32Id, u32Seq));
+
+    if (u32Ret != JF_ERR_NO_ERROR)
+        ptrt->trt_u32Error ++;
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _dequeueRingqueueTest(test_ringqueue_thread_t * ptrt, void ** ppData)
+{
+    u32 u32Ret = JF_ERR_QUEUE_EMPTY;
+
+    /*The consumer may start waiting after the last consumer wakes up others, so the waiting
+      period is limited.*/
+    if (ptrt->trt_pjrQueue != NULL)
+        return jf_ringqueue_dequeueWaitWithTimeout(ptrt->trt_pjrQueue, ppData, 100);
+
+    /*The consumer polls the queue with mutex.*/
+    while ((u32Ret != JF_ERR_NO_ERROR) &&
+           (jf_atomic_loadU32(&ls_u32Consumed) <
+            ptrt->trt_u32NumOfProducer * TEST_RINGQUEUE_NUM_OF_ITEM))
+    {
+        jf_mutex_acquire(ptrt->trt_pjmLock);
+        *ppData = jf_queue_dequeue(ptrt->trt_pjqQueue);
+        jf_mutex_release(ptrt->trt_pjmLock);
+
+        if (*ppData != NULL)
+            u32Ret = JF_ERR_NO_ERROR;
+        else
+            jf_atomic_cpuRelax();
+    }
+
+    return u32Ret;
+}
+
+JF_THREAD_RETURN_VALUE _ringqueueTestConsumer(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_ringqueue_thread_t * ptrt = (test_ringqueue_thread_t *)pArg;
+    u32 u32Total = ptrt->trt_u32NumOfProducer * TEST_RINGQUEUE_NUM_OF_ITEM;
+    u32 u32Id = 0, u32Seq = 0;
+    void * pData = NULL;
+
+    while (! jf_atomic_loadU32(&ls_u32Start))
+        jf_atomic_cpuRelax();
+
+    while (jf_atomic_loadU32(&ls_u32Consumed) < u32Total)
+    {
+        if (_dequeueRingqueueTest(ptrt, &pData) != JF_ERR_NO_ERROR)
+            continue;
+
+        ptrt->trt_u32Count ++;
+
+        /*The items from the same producer must be dequeued in order.*/
+        u32Id = TEST_RINGQUEUE_ITEM_ID(pData);
+        u32Seq = TEST_RINGQUEUE_ITEM_SEQ(pData);
+        if ((u32Id >= ptrt->trt_u32NumOfProducer) || (u32Seq + 1 <= ptrt->trt_u32LastSeq[u32Id]))
+            ptrt->trt_u32Error ++;
+        else
+            ptrt->trt_u32LastSeq[u32Id] = u32Seq + 1;
+
+        /*The last consumer wakes up others.*/
+        if ((jf_atomic_fetchAddU32(&ls_u32Consumed, 1) + 1 == u32Total) &&
+            (ptrt->trt_pjrQueue != NULL))
+            jf_ringqueue_wakeupAll(ptrt->trt_pjrQueue);
+    }
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _runRingqueueTestThreads(
+    jf_ringqueue_t * pjr, jf_queue_t * pjq, jf_mutex_t * pjmLock, u32 u32NumOfProducer,
+    u32 u32NumOfConsumer)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_ringqueue_thread_t trt[TEST_RINGQUEUE_MAX_THREAD * 2];
+    jf_thread_id_t threadId[TEST_RINGQUEUE_MAX_THREAD * 2];
+    u32 u32Index = 0, u32Created = 0, u32RetCode = 0, u32Error = 0, u32Count = 0;
+    u64 u64Time = 0;
+
+    ol_bzero(trt, sizeof(trt));
+    jf_atomic_storeU32(&ls_u32Start, FALSE);
+    jf_atomic_storeU32(&ls_u32Consumed, 0);
+
+    for (u32Index = 0;
+         (u32Ret == JF_ERR_NO_ERROR) && (u32Index < u32NumOfProducer + u32NumOfConsumer);
+         u32Index ++)
+    {
+        trt[u32Index].trt_pjrQueue = pjr;
+        trt[u32Index].trt_pjqQueue = pjq;
+        trt[u32Index].trt_pjmLock = pjmLock;
+        trt[u32Index].trt_u32NumOfProducer = u32NumOfProducer;
+
+        if (u32Index < u32NumOfProducer)
+        {
+            trt[u32Index].trt_u32Id = u32Index;
+            u32Ret = jf_thread_create(
+                &threadId[u32Index], NULL, _ringqueueTestProducer, &trt[u32Index]);
+        }
+        else
+        {
+            u32Ret = jf_thread_create(
+                &threadId[u32Index], NULL, _ringqueueTestConsumer, &trt[u32Index]);
+        }
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Created ++;
+    }
+
+    /*Stop the threads if some of them are not created.*/
+    if (u32Ret != JF_ERR_NO_ERROR)
+        jf_atomic_storeU32(&ls_u32Consumed, U32_MAX);
+
+    u64Time = _getRingqueueTestNanoTime();
+    jf_atomic_storeU32(&ls_u32Start, TRUE);
+
+    for (u32Index = 0; u32Index < u32Created; u32Index ++)
+    {
+        jf_thread_waitForThreadTermination(threadId[u32Index], &u32RetCode);
+        u32Error += trt[u32Index].trt_u32Error;
+        u32Count += trt[u32Index].trt_u32Count;
+    }
+
+    u64Time = _getRingqueueTestNanoTime() - u64Time;
+
+    ol_printf(
+        "%-18s %u producers, %u consumers, %u items, %.2f Mops/s, error %u\n",
+        (pjr != NULL) ? "ring queue:" : "queue with mutex:", u32NumOfProducer, u32NumOfConsumer,
+        u32Count, (oldouble_t)u32Count * 1000.0 / (oldouble_t)u64Time, u32Error);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        ((u32Error != 0) || (u32Count != u32NumOfProducer * TEST_RINGQUEUE_NUM_OF_ITEM)))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static u32 _testRingqueueWithThreads(
+    boolean_t bSingleConsumer, u32 u32NumOfProducer, u32 u32NumOfConsumer)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_ringqueue_t * pjr = NULL;
+    jf_ringqueue_create_param_t jrcp;
+
+    ol_bzero(&jrcp, sizeof(jrcp));
+    jrcp.jrcp_u32Capacity = TEST_RINGQUEUE_CAPACITY;
+    jrcp.jrcp_bSingleConsumer = bSingleConsumer;
+
+    u32Ret = jf_ringqueue_create(&pjr, &jrcp);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _runRingqueueTestThreads(pjr, NULL, NULL, u32NumOfProducer, u32NumOfConsumer);
+
+        if ((u32Ret == JF_ERR_NO_ERROR) && (jf_ringqueue_getSize(pjr) != 0))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+
+        jf_ringqueue_destroy(&pjr);
+    }
+
+    return u32Ret;
+}
+
+static u32 _testQueueWithMutex(u32 u32NumOfProducer, u32 u32NumOfConsumer)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_queue_t jqQueue;
+    jf_mutex_t jmLock;
+
+    jf_queue_init(&jqQueue);
+    u32Ret = jf_mutex_init(&jmLock);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _runRingqueueTestThreads(
+            NULL, &jqQueue, &jmLock, u32NumOfProducer, u32NumOfConsumer);
+
+        jf_mutex_fini(&jmLock);
+    }
+    jf_queue_fini(&jqQueue);
+
+    return u32Ret;
+}
+
+static u32 _testRingqueue(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = _testRingqueueBasic();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testRingqueueWithThreads(TRUE, 4, 1);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testRingqueueWithThreads(FALSE, 4, 4);
+
+    return u32Ret;
+}
+
+static u32 _benchmarkRingqueue(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32NumOfProducer = 0;
+
+    for (u32NumOfProducer = 1;
+         (u32Ret == JF_ERR_NO_ERROR) && (u32NumOfProducer <= 4); u32NumOfProducer *= 2)
+    {
+        u32Ret = _testRingqueueWithThreads(TRUE, u32NumOfProducer, 1);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testQueueWithMutex(u32NumOfProducer, 1);
+    }
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+olint_t main(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_logger_init_param_t jlipParam;
+    jf_jiukun_init_param_t jjip;
+
+    ol_bzero(&jlipParam, sizeof(jlipParam));
+    jlipParam.jlip_pstrCallerName = "RINGQUEUE-TEST";
+    jlipParam.jlip_u8TraceLevel = JF_LOGGER_TRACE_LEVEL_DEBUG;
+
+    ol_bzero(&jjip, sizeof(jjip));
+    jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
+
+    u32Ret = _parseRingqueueTestCmdLineParam(argc, argv, &jlipParam);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_logger_init(&jlipParam);
+
+        u32Ret = jf_jiukun_init(&jjip);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            if (ls_bTestRingqueue)
+            {
+                u32Ret = _testRingqueue();
+            }
+            else if (ls_bBenchmarkRingqueue)
+            {
+                u32Ret = _benchmarkRingqueue();
+            }
+            else
+            {
+                ol_printf("No operation is specified !!!!\n\n");
+                _printRingqueueTestUsage();
+            }
+
+            jf_jiukun_fini();
+        }
+
+        jf_logger_logErrMsg(u32Ret, "Quit");
+        jf_logger_fini();
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -6,11 +6,12 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The benchmark compares jf_rwlock, jf_drwlock and jf_seqlock with read-mostly threads.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -18,7 +19,13 @@
 #include "jf_limit.h"
 #include "jf_err.h"
 #include "jf_rwlock.h"
+#include "jf_drwlock.h"
+#include "jf_seqlock.h"
+#include "jf_atomic.h"
 #include "jf_thread.h"
+#include "jf_option.h"
+#include "jf_time.h"
+#include "jf_jiukun.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -28,8 +35,99 @@ static olint_t nRwlock = 0;
 
 #define MAX_RESOURCE_COUNT  1
 
+/** The lock type for benchmark.
+ */
+enum rwlock_test_lock_type
+{
+    RWLOCK_TEST_LOCK_RWLOCK = 0,
+    RWLOCK_TEST_LOCK_DRWLOCK,
+    RWLOCK_TEST_LOCK_SEQLOCK,
+    RWLOCK_TEST_LOCK_MAX,
+};
+
+static const olchar_t * ls_pstrRwlockTestLockName[RWLOCK_TEST_LOCK_MAX] =
+{
+    "rwlock",
+    "drwlock",
+    "seqlock",
+};
+
+/** The data protected by the lock in benchmark, the 2 fields are always the same.
+ */
+typedef struct
+{
+    u64 rtd_u64First;
+    u64 rtd_u64Second;
+} rwlock_test_data_t;
+
+static boolean_t ls_bRwlockTestBenchmark = FALSE;
+static u32 ls_u32RwlockTestNumOfThread = 4;
+static u32 ls_u32RwlockTestNumOfOp = 1000000;
+/** One write operation every "ls_u32RwlockTestWriteInterval" operations.
+ */
+static u32 ls_u32RwlockTestWriteInterval = 100;
+
+static u8 ls_u8RwlockTestLockType;
+static jf_drwlock_t ls_jdRwlockTestLock;
+static jf_seqlock_t ls_jsRwlockTestLock;
+static rwlock_test_data_t ls_rtdRwlockTestData;
+static u32 ls_u32RwlockTestNumOfError;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static void _printRwlockTestUsage(void)
+{
+    ol_printf("\
+Usage: rwlock-test [-b] [-t count] [-n count] [-w interval] [-h]\n\
+  -b: benchmark jf_rwlock, jf_drwlock and jf_seqlock.\n\
+  -t: number of threads for benchmark, 4 by default.\n\
+  -n: number of operations per thread for benchmark, 1000000 by default.\n\
+  -w: one write every \"interval\" operations for benchmark, 100 by default.\n\
+  -h: print the usage.\n\
+  By default, the producer and consumers run with jf_rwlock for about 1 minute.\n");
+    ol_printf("\n");
+}
+
+static u32 _parseRwlockTestCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "bt:n:w:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printRwlockTestUsage();
+            exit(0);
+            break;
+        case 'b':
+            ls_bRwlockTestBenchmark = TRUE;
+            break;
+        case 't':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32RwlockTestNumOfThread);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32RwlockTestNumOfThread == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        case 'n':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32RwlockTestNumOfOp);
+            break;
+        case 'w':
+            u32Ret = jf_option_getU32FromString(
+                jf_option_getArg(), &ls_u32RwlockTestWriteInterval);
+            if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32RwlockTestWriteInterval == 0))
+                u32Ret = JF_ERR_INVALID_PARAM;
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
 JF_THREAD_RETURN_VALUE consumer1(void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -111,6 +209,189 @@ JF_THREAD_RETURN_VALUE producer(void * pArg)
     JF_THREAD_RETURN(u32Ret);
 }
 
+static inline u64 _getRwlockTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static inline void _writeRwlockTestData(void)
+{
+    ls_rtdRwlockTestData.rtd_u64First ++;
+    ls_rtdRwlockTestData.rtd_u64Second ++;
+}
+
+static inline void _readRwlockTestData(rwlock_test_data_t * prtd)
+{
+    volatile rwlock_test_data_t * pData = &ls_rtdRwlockTestData;
+
+    prtd->rtd_u64First = pData->rtd_u64First;
+    prtd->rtd_u64Second = pData->rtd_u64Second;
+}
+
+JF_THREAD_RETURN_VALUE _rwlockTestBenchmarkThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index, u32Seq, u32Error = 0;
+    rwlock_test_data_t rtd;
+
+    for (u32Index = 1; u32Index <= ls_u32RwlockTestNumOfOp; u32Index ++)
+    {
+        if (u32Index % ls_u32RwlockTestWriteInterval == 0)
+        {
+            if (ls_u8RwlockTestLockType == RWLOCK_TEST_LOCK_RWLOCK)
+            {
+                jf_rwlock_acquireWritelock(&ls_jrLock);
+                _writeRwlockTestData();
+                jf_rwlock_releaseWritelock(&ls_jrLock);
+            }
+            else if (ls_u8RwlockTestLockType == RWLOCK_TEST_LOCK_DRWLOCK)
+            {
+                jf_drwlock_acquireWritelock(&ls_jdRwlockTestLock);
+                _writeRwlockTestData();
+                jf_drwlock_releaseWritelock(&ls_jdRwlockTestLock);
+            }
+            else
+            {
+                jf_seqlock_acquireWritelock(&ls_jsRwlockTestLock);
+                _writeRwlockTestData();
+                jf_seqlock_releaseWritelock(&ls_jsRwlockTestLock);
+            }
+            continue;
+        }
+
+        if (ls_u8RwlockTestLockType == RWLOCK_TEST_LOCK_RWLOCK)
+        {
+            jf_rwlock_acquireReadlock(&ls_jrLock);
+            _readRwlockTestData(&rtd);
+            jf_rwlock_releaseReadlock(&ls_jrLock);
+        }
+        else if (ls_u8RwlockTestLockType == RWLOCK_TEST_LOCK_DRWLOCK)
+        {
+            jf_drwlock_acquireReadlock(&ls_jdRwlockTestLock);
+            _readRwlockTestData(&rtd);
+            jf_drwlock_releaseReadlock(&ls_jdRwlockTestLock);
+        }
+        else
+        {
+            do
+            {
+                u32Seq = jf_seqlock_beginRead(&ls_jsRwlockTestLock);
+                _readRwlockTestData(&rtd);
+            } while (jf_seqlock_retryRead(&ls_jsRwlockTestLock, u32Seq));
+        }
+
+        if (rtd.rtd_u64First != rtd.rtd_u64Second)
+            u32Error ++;
+    }
+
+    if (u32Error != 0)
+        jf_atomic_fetchAddU32(&ls_u32RwlockTestNumOfError, u32Error);
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _benchmarkRwlockTestLock(u8 u8Type)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index, u32NumOfThread = 0;
+    jf_thread_id_t * pjti = NULL;
+    u64 u64Time, u64NumOfOp, u64NumOfWrite;
+
+    ls_u8RwlockTestLockType = u8Type;
+    ls_u32RwlockTestNumOfError = 0;
+    ol_bzero(&ls_rtdRwlockTestData, sizeof(ls_rtdRwlockTestData));
+
+    u32Ret = jf_jiukun_allocMemory(
+        (void **)&pjti, sizeof(jf_thread_id_t) * ls_u32RwlockTestNumOfThread);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    u64Time = _getRwlockTestNanoTime();
+
+    for (u32Index = 0; (u32Index < ls_u32RwlockTestNumOfThread) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        u32Ret = jf_thread_create(&pjti[u32Index], NULL, _rwlockTestBenchmarkThread, NULL);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32NumOfThread ++;
+    }
+
+    for (u32Index = 0; u32Index < u32NumOfThread; u32Index ++)
+        jf_thread_waitForThreadTermination(pjti[u32Index], NULL);
+
+    u64Time = _getRwlockTestNanoTime() - u64Time;
+
+    jf_jiukun_freeMemory((void **)&pjti);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64NumOfOp = (u64)ls_u32RwlockTestNumOfOp * ls_u32RwlockTestNumOfThread;
+        u64NumOfWrite = (u64)(ls_u32RwlockTestNumOfOp / ls_u32RwlockTestWriteInterval) *
+            ls_u32RwlockTestNumOfThread;
+
+        ol_printf(
+            "%-8s: %llu ops in %llu ms, %.2f ns/op, %llu writes, %u errors\n",
+            ls_pstrRwlockTestLockName[u8Type], u64NumOfOp, u64Time / 1000000,
+            (double)u64Time / (u64NumOfOp != 0 ? u64NumOfOp : 1), u64NumOfWrite,
+            ls_u32RwlockTestNumOfError);
+
+        if ((ls_u32RwlockTestNumOfError != 0) ||
+            (ls_rtdRwlockTestData.rtd_u64First != u64NumOfWrite) ||
+            (ls_rtdRwlockTestData.rtd_u64Second != u64NumOfWrite))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+static u32 _benchmarkRwlockTest(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_jiukun_init_param_t jjip;
+    u8 u8Type;
+
+    ol_bzero(&jjip, sizeof(jjip));
+    jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
+
+    u32Ret = jf_jiukun_init(&jjip);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    u32Ret = jf_rwlock_init(&ls_jrLock);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_drwlock_init(&ls_jdRwlockTestLock);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            jf_seqlock_init(&ls_jsRwlockTestLock);
+
+            ol_printf(
+                "threads: %u, operations per thread: %u, one write every %u operations\n",
+                ls_u32RwlockTestNumOfThread, ls_u32RwlockTestNumOfOp,
+                ls_u32RwlockTestWriteInterval);
+
+            for (u8Type = 0; (u8Type < RWLOCK_TEST_LOCK_MAX) && (u32Ret == JF_ERR_NO_ERROR);
+                 u8Type ++)
+                u32Ret = _benchmarkRwlockTestLock(u8Type);
+
+            jf_drwlock_fini(&ls_jdRwlockTestLock);
+        }
+
+        jf_rwlock_fini(&ls_jrLock);
+    }
+
+    jf_jiukun_fini();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("rwlock benchmark passed\n");
+
+    return u32Ret;
+}
+
 /* --- public routine section ------------------------------------------------------------------- */
 
 olint_t main(olint_t argc, olchar_t ** argv)
@@ -118,8 +399,17 @@ olint_t main(olint_t argc, olchar_t ** argv)
     u32 u32Ret = JF_ERR_NO_ERROR;
     olchar_t strErrMsg[300];
 
-    u32Ret = jf_rwlock_init(&ls_jrLock);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    u32Ret = _parseRwlockTestCmdLineParam(argc, argv);
+    if ((u32Ret == JF_ERR_NO_ERROR) && ls_bRwlockTestBenchmark)
+    {
+        u32Ret = _benchmarkRwlockTest();
+    }
+    else if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_rwlock_init(&ls_jrLock);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (! ls_bRwlockTestBenchmark))
     {
         u32Ret = jf_thread_create(NULL, NULL, producer, (void *)1);
         if (u32Ret == JF_ERR_NO_ERROR)
@@ -6,11 +6,14 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The function test checks the count, maximum count and timeout of semaphore, then measures the
+ *   round trip time of 2 threads signaling each other with the intra-process semaphore and the
+ *   cross-process semaphore.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
 
+#include <stdlib.h>
 
 /* --- internal header files -------------------------------------------------------------------- */
 
@@ -19,6 +22,8 @@
 #include "jf_err.h"
 #include "jf_sem.h"
 #include "jf_thread.h"
+#include "jf_option.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -27,8 +32,228 @@ static boolean_t ls_bToTerminate = FALSE;
 
 #define MAX_RESOURCE_COUNT  5
 
+static boolean_t ls_bSemTestFunction = FALSE;
+static u32 ls_u32SemTestNumOfRoundTrip = 100000;
+
+/** The semaphores for ping-pong test.
+ */
+static jf_sem_t ls_jsSemTestPing;
+static jf_sem_t ls_jsSemTestPong;
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static void _printSemTestUsage(void)
+{
+    ol_printf("\
+Usage: sem-test [-t] [-n count] [-h]\n\
+  -t: test the function and performance of semaphore.\n\
+  -n: number of round trips for performance test, 100000 by default.\n\
+  -h: print the usage.\n\
+  By default, the producer and consumers run for 5 minutes.\n");
+    ol_printf("\n");
+}
+
+static u32 _parseSemTestCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "tn:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printSemTestUsage();
+            exit(0);
+            break;
+        case 't':
+            ls_bSemTestFunction = TRUE;
+            break;
+        case 'n':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32SemTestNumOfRoundTrip);
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static inline u64 _getSemTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _testSemCount(jf_sem_t * pSem, const olchar_t * pstrName, boolean_t bMaxCount)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Time;
+
+    ol_printf("test count of %s semaphore\n", pstrName);
+
+    /*The semaphore is initialized with 1 and the maximum count is 2.*/
+    if (jf_sem_tryDown(pSem) != JF_ERR_NO_ERROR)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if (jf_sem_tryDown(pSem) == JF_ERR_NO_ERROR)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if ((jf_sem_up(pSem) != JF_ERR_NO_ERROR) || (jf_sem_up(pSem) != JF_ERR_NO_ERROR))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    /*The up at the maximum count succeeds but the count is not changed, the third down below
+      times out.*/
+    else if (bMaxCount && (jf_sem_up(pSem) != JF_ERR_NO_ERROR))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if (jf_sem_down(pSem) != JF_ERR_NO_ERROR)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    else if (jf_sem_downWithTimeout(pSem, 100) != JF_ERR_NO_ERROR)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Time = _getSemTestNanoTime();
+        if (jf_sem_downWithTimeout(pSem, 100) == JF_ERR_NO_ERROR)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+        u64Time = _getSemTestNanoTime() - u64Time;
+
+        ol_printf("down with 100ms timeout returns after %llu us\n", u64Time / 1000);
+        if (u64Time < 100000000ULL)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+JF_THREAD_RETURN_VALUE _semTestPongThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index;
+
+    for (u32Index = 0; (u32Index < ls_u32SemTestNumOfRoundTrip) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        u32Ret = jf_sem_down(&ls_jsSemTestPing);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_sem_up(&ls_jsSemTestPong);
+    }
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _testSemPingPong(boolean_t bShared)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR, u32Index;
+    jf_thread_id_t jti;
+    u64 u64Time;
+    const olchar_t * pstrName = bShared ? "cross-process" : "intra-process";
+
+    if (bShared)
+    {
+        u32Ret = jf_sem_initShared(&ls_jsSemTestPing, 0, 1);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_sem_initShared(&ls_jsSemTestPong, 0, 1);
+    }
+    else
+    {
+        u32Ret = jf_sem_init(&ls_jsSemTestPing, 0, 1);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_sem_init(&ls_jsSemTestPong, 0, 1);
+    }
+
+    /*Up and down without contention.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Time = _getSemTestNanoTime();
+
+        for (u32Index = 0;
+             (u32Index < ls_u32SemTestNumOfRoundTrip) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Index ++)
+        {
+            u32Ret = jf_sem_up(&ls_jsSemTestPing);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_sem_down(&ls_jsSemTestPing);
+        }
+
+        u64Time = _getSemTestNanoTime() - u64Time;
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            ol_printf(
+                "%s semaphore: %u uncontended up and down in %llu ms, %llu ns each\n", pstrName,
+                ls_u32SemTestNumOfRoundTrip, u64Time / 1000000,
+                u64Time / (ls_u32SemTestNumOfRoundTrip != 0 ? ls_u32SemTestNumOfRoundTrip : 1));
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_thread_create(&jti, NULL, _semTestPongThread, NULL);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Time = _getSemTestNanoTime();
+
+        for (u32Index = 0;
+             (u32Index < ls_u32SemTestNumOfRoundTrip) && (u32Ret == JF_ERR_NO_ERROR);
+             u32Index ++)
+        {
+            u32Ret = jf_sem_up(&ls_jsSemTestPing);
+            if (u32Ret == JF_ERR_NO_ERROR)
+                u32Ret = jf_sem_down(&ls_jsSemTestPong);
+        }
+
+        u64Time = _getSemTestNanoTime() - u64Time;
+
+        jf_thread_waitForThreadTermination(jti, NULL);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            ol_printf(
+                "%s semaphore: %u round trips in %llu ms, %llu ns per round trip\n", pstrName,
+                ls_u32SemTestNumOfRoundTrip, u64Time / 1000000,
+                u64Time / (ls_u32SemTestNumOfRoundTrip != 0 ? ls_u32SemTestNumOfRoundTrip : 1));
+    }
+
+    jf_sem_fini(&ls_jsSemTestPong);
+    jf_sem_fini(&ls_jsSemTestPing);
+
+    return u32Ret;
+}
+
+static u32 _testSemFunction(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_sem_t jsSem;
+
+    u32Ret = jf_sem_init(&jsSem, 1, 2);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _testSemCount(&jsSem, "intra-process", TRUE);
+        jf_sem_fini(&jsSem);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_sem_initShared(&jsSem, 1, 2);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = _testSemCount(&jsSem, "cross-process", FALSE);
+        jf_sem_fini(&jsSem);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testSemPingPong(FALSE);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testSemPingPong(TRUE);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("semaphore test passed\n");
+
+    return u32Ret;
+}
+
 JF_THREAD_RETURN_VALUE consumer(void * pArg)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -93,8 +318,17 @@ olint_t main(olint_t argc, olchar_t ** argv)
     u32 u32Id[MAX_RESOURCE_COUNT];
     u32 u32ProducerId = 1;
 
-    u32Ret = jf_sem_init(&ls_jsSem, 0, MAX_RESOURCE_COUNT);
-    if (u32Ret == JF_ERR_NO_ERROR)
+    u32Ret = _parseSemTestCmdLineParam(argc, argv);
+    if ((u32Ret == JF_ERR_NO_ERROR) && ls_bSemTestFunction)
+    {
+        u32Ret = _testSemFunction();
+    }
+    else if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_sem_init(&ls_jsSem, 0, MAX_RESOURCE_COUNT);
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (! ls_bSemTestFunction))
     {
         u32Ret = jf_thread_create(NULL, NULL, producer, &u32ProducerId);
         if (u32Ret == JF_ERR_NO_ERROR)
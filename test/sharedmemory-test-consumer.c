@@ -7,7 +7,8 @@
  *  @author Min Zhang
  *
  *  @note
- *
+ *  -# The consumer reads the records from the ring in shared memory created by worker, checks the
+ *   sequence number and reports the throughput.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -19,29 +20,93 @@
 #include "jf_limit.h"
 #include "jf_err.h"
 #include "jf_sharedmemory.h"
+#include "jf_shmring.h"
 #include "jf_jiukun.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+/** Maximum milliseconds to wait for the record.
+ */
+#define SHAREDMEMORY_TEST_WAIT_RECORD             (10000)
+
 /* --- private routine section ------------------------------------------------------------------ */
 
+static inline u64 _getSharedmemoryTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _readSharedmemoryTestRecords(jf_shmring_t * pRing)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u8 * pu8Record = NULL;
+    u32 u32MaxLen = jf_shmring_getMaxRecordLen(pRing), u32Len = 0;
+    u64 u64Seq = 0, u64Expected = 0, u64Bytes = 0, u64Time = 0;
+
+    u32Ret = jf_jiukun_allocMemory((void **)&pu8Record, u32MaxLen);
+    if (u32Ret != JF_ERR_NO_ERROR)
+        return u32Ret;
+
+    while (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Len = u32MaxLen;
+        u32Ret = jf_shmring_readWait(pRing, pu8Record, &u32Len, SHAREDMEMORY_TEST_WAIT_RECORD);
+        if ((u32Ret != JF_ERR_NO_ERROR) || (u32Len == 0))
+            break;
+
+        /*Start the timer when the first record is read.*/
+        if (u64Expected == 0)
+            u64Time = _getSharedmemoryTestNanoTime();
+
+        ol_memcpy(&u64Seq, pu8Record, sizeof(u64Seq));
+        if ((u32Len < sizeof(u64Seq)) || (u64Seq != u64Expected))
+            u32Ret = JF_ERR_INVALID_DATA;
+
+        u64Expected ++;
+        u64Bytes += u32Len;
+    }
+
+    u64Time = _getSharedmemoryTestNanoTime() - u64Time;
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (u64Expected > 0))
+    {
+        ol_printf(
+            "Read %llu records, %llu bytes, %.2f records/s, %.2f MB/s\n", u64Expected, u64Bytes,
+            (oldouble_t)u64Expected * 1000000000.0 / (oldouble_t)u64Time,
+            (oldouble_t)u64Bytes * 1000.0 / (oldouble_t)u64Time);
+    }
+
+    jf_jiukun_freeMemory((void **)&pu8Record);
+
+    return u32Ret;
+}
+
 static u32 _sharedmemoryTestConsumer(jf_sharedmemory_id_t * pjsi)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    olchar_t * pstrShared;
+    void * pShared = NULL;
+    jf_shmring_t * pRing = NULL;
 
     ol_printf("Shared memory ID: %s\n", pjsi);
-    u32Ret = jf_sharedmemory_attach(pjsi, (void **)&pstrShared);
+    u32Ret = jf_sharedmemory_attach(pjsi, &pShared);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         ol_printf("Succeed to attach shared memroy\n");
-        ol_printf("%s\n", pstrShared);
 
-        u32Ret = jf_sharedmemory_detach((void **)&pstrShared);
+        u32Ret = jf_shmring_attach(pShared, &pRing);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _readSharedmemoryTestRecords(pRing);
+
+    if (pShared != NULL)
     {
+        jf_sharedmemory_detach(&pShared);
         ol_printf("Succeed to detach shared memory\n");
     }
 
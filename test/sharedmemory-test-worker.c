@@ -7,6 +7,9 @@
  *  @author Min Zhang
  *
  *  @note
+ *  -# The worker creates a shared memory with ring defined in jf_shmring object, and writes the
+ *   records to the ring. The consumer reads the records and reports the throughput.
+ *  -# The first 8 bytes of the record is the sequence number, the empty record is the end.
  */
 
 /* --- standard C lib header files -------------------------------------------------------------- */
@@ -18,53 +21,167 @@
 #include "jf_limit.h"
 #include "jf_err.h"
 #include "jf_sharedmemory.h"
+#include "jf_shmring.h"
 #include "jf_jiukun.h"
 #include "jf_uuid.h"
+#include "jf_option.h"
+#include "jf_time.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
+static u32 ls_u32NumOfRecord = 1000000;
+static u32 ls_u32RecordSize = 64;
+static u32 ls_u32RingCapacity = 1024 * 1024;
+
+/** Maximum seconds to wait for the consumer to read all records.
+ */
+#define SHAREDMEMORY_TEST_WAIT_CONSUMER           (60)
+
 /* --- private routine section ------------------------------------------------------------------ */
 
-static u32 _sharedmemoryTestWorker(void)
+static void _printSharedmemoryTestWorkerUsage(void)
+{
+    ol_printf("\
+Usage: sharedmemory-test-worker [-n number] [-s size] [-c capacity] [-h]\n\
+  -n: number of records to write, default is 1000000.\n\
+  -s: size of record in bytes, default is 64.\n\
+  -c: capacity of the ring in bytes, default is 1048576.\n\
+Run sharedmemory-test-consumer with the shared memory ID printed by worker.\n");
+    ol_printf("\n");
+}
+
+static u32 _parseSharedmemoryTestWorkerCmdLineParam(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "n:s:c:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printSharedmemoryTestWorkerUsage();
+            exit(0);
+            break;
+        case 'n':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32NumOfRecord);
+            break;
+        case 's':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32RecordSize);
+            break;
+        case 'c':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32RingCapacity);
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32RecordSize < sizeof(u64)))
+        u32Ret = JF_ERR_INVALID_PARAM;
+
+    return u32Ret;
+}
+
+static inline u64 _getSharedmemoryTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _writeSharedmemoryTestRecords(jf_shmring_t * pRing)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
-    jf_sharedmemory_id_t * pjsi;
-    olchar_t * pstrShared;
+    u8 * pu8Record = NULL;
+    u64 u64Seq = 0, u64Time = 0;
+    u32 u32Wait = 0;
+
+    if (ls_u32RecordSize > jf_shmring_getMaxRecordLen(pRing))
+        return JF_ERR_INVALID_PARAM;
 
-    u32Ret = jf_sharedmemory_create(&pjsi, 4000);
+    u32Ret = jf_jiukun_allocMemory((void **)&pu8Record, ls_u32RecordSize);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        ol_printf("Succeed to create shared memory\n");
-        ol_printf("Shared memory ID: %s\n", pjsi);
+        ol_memset(pu8Record, 0xA5, ls_u32RecordSize);
+
+        ol_printf("Write %u records of %u bytes ....\n", ls_u32NumOfRecord, ls_u32RecordSize);
+        u64Time = _getSharedmemoryTestNanoTime();
 
-        u32Ret = jf_sharedmemory_attach(pjsi, (void **)&pstrShared);
+        for (u64Seq = 0; (u32Ret == JF_ERR_NO_ERROR) && (u64Seq < ls_u32NumOfRecord); u64Seq ++)
+        {
+            ol_memcpy(pu8Record, &u64Seq, sizeof(u64Seq));
+            u32Ret = jf_shmring_writeWait(
+                pRing, pu8Record, ls_u32RecordSize, JF_SHMRING_WAIT_FOREVER);
+        }
+
+        /*The empty record is the end.*/
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_shmring_writeWait(pRing, NULL, 0, JF_SHMRING_WAIT_FOREVER);
+
+        u64Time = _getSharedmemoryTestNanoTime() - u64Time;
+
+        jf_jiukun_freeMemory((void **)&pu8Record);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        ol_printf("Succeed to attach shared memory\n");
-        ol_strcpy(pstrShared, "have a good day");
-        ol_printf("Write to shared memory\n");
+        ol_printf(
+            "Succeed to write records, %.2f records/s, %.2f MB/s\n",
+            (oldouble_t)ls_u32NumOfRecord * 1000000000.0 / (oldouble_t)u64Time,
+            (oldouble_t)ls_u32NumOfRecord * ls_u32RecordSize * 1000.0 / (oldouble_t)u64Time);
+
+        /*Wait for the consumer to read the records before the shared memory is destroyed.*/
+        while ((jf_shmring_getSize(pRing) != 0) &&
+               (u32Wait < SHAREDMEMORY_TEST_WAIT_CONSUMER * 100))
+        {
+            jf_time_milliSleep(10);
+            u32Wait ++;
+        }
     }
 
+    return u32Ret;
+}
+
+static u32 _sharedmemoryTestWorker(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_sharedmemory_id_t * pjsi = NULL;
+    u32 u32MemorySize = jf_shmring_getMemorySize(ls_u32RingCapacity);
+    void * pShared = NULL;
+    jf_shmring_t * pRing = NULL;
+
+    u32Ret = jf_sharedmemory_create(&pjsi, u32MemorySize);
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        ol_printf("Sleep ....\n");
-        ol_sleep(60);
+        ol_printf("Succeed to create shared memory\n");
+        ol_printf("Shared memory ID: %s\n", pjsi);
 
-        u32Ret = jf_sharedmemory_detach((void **)&pstrShared);
+        u32Ret = jf_sharedmemory_attach(pjsi, &pShared);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("Succeed to attach shared memory\n");
+        u32Ret = jf_shmring_init(pShared, u32MemorySize, &pRing);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _writeSharedmemoryTestRecords(pRing);
+
+    if (pShared != NULL)
     {
+        jf_sharedmemory_detach(&pShared);
         ol_printf("succeed to detach the shared memory\n");
     }
 
     if (pjsi != NULL)
-        u32Ret = jf_sharedmemory_destroy(&pjsi);
-
-    if (u32Ret == JF_ERR_NO_ERROR)
     {
+        jf_sharedmemory_destroy(&pjsi);
         ol_printf("succeed to destroy shared memory\n");
     }
 
@@ -82,7 +199,10 @@ olint_t main(olint_t argc, olchar_t ** argv)
     ol_bzero(&jjip, sizeof(jjip));
     jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
 
-    u32Ret = jf_jiukun_init(&jjip);
+    u32Ret = _parseSharedmemoryTestWorkerCmdLineParam(argc, argv);
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_jiukun_init(&jjip);
+
     if (u32Ret == JF_ERR_NO_ERROR)
     {
         u32Ret = jf_uuid_init();
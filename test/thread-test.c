@@ -30,6 +30,12 @@ static boolean_t ls_bThreadTestCreate = FALSE;
 
 static boolean_t ls_bThreadTestBasic = FALSE;
 
+static boolean_t ls_bThreadTestAttr = FALSE;
+
+static olchar_t * ls_pstrThreadTestCpuList = "0";
+
+static olchar_t * ls_pstrThreadTestName = "jf-thread-test";
+
 #define MAX_THREAD_COUNT  5
 
 /* --- private routine section ------------------------------------------------------------------ */
@@ -37,9 +43,12 @@ static boolean_t ls_bThreadTestBasic = FALSE;
 static void _printThreadTestUsage(void)
 {
     ol_printf("\
-Usage: thread-test [-c] [-b] [-h] \n\
+Usage: thread-test [-c] [-b] [-a] [-p cpu-list] [-n name] [-h] \n\
   -c: test thread create.\n\
   -b: test basic thread function.\n\
+  -a: test thread attribute.\n\
+  -p: the CPU list for affinity, eg. \"0~3, 8\", default is \"0\".\n\
+  -n: the thread name, default is \"jf-thread-test\".\n\
   -h: print this usage.");
 
     ol_printf("\n");
@@ -52,7 +61,7 @@ static u32 _parseThreadTestCmdLineParam(
     olint_t nOpt;
 
     while ((u32Ret == JF_ERR_NO_ERROR) &&
-           ((nOpt = jf_option_get(argc, argv, "cbh")) != -1))
+           ((nOpt = jf_option_get(argc, argv, "cbap:n:h")) != -1))
     {
         switch (nOpt)
         {
@@ -62,6 +71,15 @@ static u32 _parseThreadTestCmdLineParam(
         case 'b':
             ls_bThreadTestBasic = TRUE;
             break;
+        case 'a':
+            ls_bThreadTestAttr = TRUE;
+            break;
+        case 'p':
+            ls_pstrThreadTestCpuList = jf_option_getArg();
+            break;
+        case 'n':
+            ls_pstrThreadTestName = jf_option_getArg();
+            break;
         case ':':
         case '?':
         case 'h':
@@ -146,6 +164,134 @@ static u32 _threadTestBasic(void)
     return u32Ret;
 }
 
+static u32 _threadTestCpuSetString(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_cpu_set_t jtcs;
+    const olchar_t * pstrInvalid[] = {"", " ", "1~", "~1", "3~1", "1,,2", "1 2", "a", "0~256"};
+    u32 u32Index = 0;
+
+    ol_printf("cpu set from string\n");
+
+    u32Ret = jf_thread_getCpuSetFromString(" 0~2, 5 ,64~65, 255,", &jtcs);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        if ((jtcs.jtcs_u64Mask[0] != 0x27) || (jtcs.jtcs_u64Mask[1] != 0x3) ||
+            (jtcs.jtcs_u64Mask[2] != 0) || (! jf_thread_isCpuInCpuSet(&jtcs, 255)))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    for (u32Index = 0; (u32Ret == JF_ERR_NO_ERROR) && (u32Index < ARRAY_SIZE(pstrInvalid));
+         u32Index ++)
+    {
+        /*The empty string is valid for jf_string_getIdListFromString() only if it's NULL.*/
+        if (jf_thread_getCpuSetFromString(pstrInvalid[u32Index], &jtcs) == JF_ERR_NO_ERROR)
+        {
+            if ((u32Index != 0) || (jtcs.jtcs_u64Mask[0] != 0))
+            {
+                ol_printf("\"%s\" should be invalid\n", pstrInvalid[u32Index]);
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+            }
+        }
+    }
+
+    return u32Ret;
+}
+
+#if defined(LINUX)
+
+JF_THREAD_RETURN_VALUE _threadTestAttrThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_cpu_set_t * pjtcs = pArg;
+    olchar_t strName[32];
+    cpu_set_t cs;
+    u32 u32Cpu = 0;
+
+    ol_bzero(strName, sizeof(strName));
+    pthread_getname_np(pthread_self(), strName, sizeof(strName));
+    ol_printf("thread name: %s\n", strName);
+    if (ol_strncmp(strName, ls_pstrThreadTestName, JF_THREAD_MAX_NAME_LEN) != 0)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pthread_getaffinity_np(pthread_self(), sizeof(cs), &cs);
+        ol_printf("thread affinity:");
+        for (u32Cpu = 0; u32Cpu < JF_THREAD_MAX_CPU; u32Cpu ++)
+        {
+            if (CPU_ISSET(u32Cpu, &cs))
+                ol_printf(" %u", u32Cpu);
+            /*The CPU not online is not in the affinity even it's in the CPU set.*/
+            if (CPU_ISSET(u32Cpu, &cs) && ! jf_thread_isCpuInCpuSet(pjtcs, u32Cpu))
+                u32Ret = JF_ERR_PROGRAM_ERROR;
+        }
+        ol_printf("\n");
+    }
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _threadTestCreateWithAttr(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_attr_t jta;
+    jf_thread_id_t jti;
+    u32 u32RetCode = 0;
+    void * pRet = NULL;
+
+    ol_bzero(&jta, sizeof(jta));
+    jta.jta_sStack = 64 * 1024;
+    jta.jta_pstrName = ls_pstrThreadTestName;
+    jta.jta_bAffinity = TRUE;
+    jta.jta_u8SchedPolicy = JF_THREAD_SCHED_POLICY_OTHER;
+
+    u32Ret = jf_thread_getCpuSetFromString(ls_pstrThreadTestCpuList, &jta.jta_jtcsAffinity);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("create thread with attribute\n");
+        u32Ret = jf_thread_create(&jti, &jta, _threadTestAttrThread, &jta.jta_jtcsAffinity);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        pthread_join(jti.jti_ptThreadId, &pRet);
+        u32RetCode = (u32)(ulong)pRet;
+        u32Ret = u32RetCode;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*The stack size less than PTHREAD_STACK_MIN is invalid.*/
+        jta.jta_sStack = 1;
+        if (jf_thread_create(NULL, &jta, _threadTestAttrThread, NULL) != JF_ERR_INVALID_PARAM)
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+#endif
+
+static u32 _threadTestAttr(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = _threadTestCpuSetString();
+
+#if defined(LINUX)
+    /*The name and affinity are read back with the pthread routines, they are Linux only.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _threadTestCreateWithAttr();
+#endif
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("thread attribute test passed\n");
+
+    return u32Ret;
+}
+
 static void _threadTestSignalHandler(olint_t signal)
 {
     ol_printf("get signal %d\n", signal);
@@ -178,6 +324,8 @@ olint_t main(olint_t argc, olchar_t ** argv)
             u32Ret = _threadTestCreate();
         else if (ls_bThreadTestBasic)
             u32Ret = _threadTestBasic();
+        else if (ls_bThreadTestAttr)
+            u32Ret = _threadTestAttr();
         else
             _printThreadTestUsage();
 
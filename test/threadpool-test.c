@@ -0,0 +1,607 @@
+/**
+ *  @file threadpool-test.c
+ *
+ *  @brief Test file for work-stealing thread pool defined in jf_threadpool object.
+ *
+ *  @author Min Zhang
+ *
+ *  @note
+ *  -# The benchmark compares the overhead of task in thread pool with creating a thread for each
+ *   task.
+ */
+
+/* --- standard C lib header files -------------------------------------------------------------- */
+
+
+/* --- internal header files -------------------------------------------------------------------- */
+
+#include "jf_basic.h"
+#include "jf_limit.h"
+#include "jf_err.h"
+#include "jf_threadpool.h"
+#include "jf_thread.h"
+#include "jf_sem.h"
+#include "jf_atomic.h"
+#include "jf_time.h"
+#include "jf_jiukun.h"
+#include "jf_option.h"
+
+/* --- private data/data structure section ------------------------------------------------------ */
+
+#define TEST_THREADPOOL_NUM_OF_TASK          (100000)
+#define TEST_THREADPOOL_NUM_OF_FUTURE        (1000)
+#define TEST_THREADPOOL_FIB                  (20)
+#define TEST_THREADPOOL_RANGE                (10000000)
+#define TEST_THREADPOOL_RANGE_GRAIN          (10000)
+#define TEST_THREADPOOL_ERROR_INDEX          (1234567)
+
+#define BENCH_THREADPOOL_NUM_OF_TASK         (1000000)
+#define BENCH_THREADPOOL_NUM_OF_THREAD       (5000)
+#define BENCH_THREADPOOL_FIB                 (25)
+
+/** The argument of task for recursive fibonacci.
+ */
+typedef struct
+{
+    jf_threadpool_t * ttf_pjtPool;
+    u32 ttf_u32N;
+    u32 ttf_u32Reserved;
+} test_threadpool_fib_t;
+
+static boolean_t ls_bTestThreadpool = FALSE;
+static boolean_t ls_bBenchmarkThreadpool = FALSE;
+static u32 ls_u32NumOfWorker = 0;
+
+/**Number of completed task.*/
+static u32 ls_u32NumOfCompleted = 0;
+/**Number of completed task expected, the semaphore is up when it's reached.*/
+static u32 ls_u32NumOfExpected = 0;
+static u32 ls_u32TestThreadpoolError = 0;
+static jf_sem_t ls_jsCompleted;
+
+/**The sum of indexes in parallel-for.*/
+static u64 ls_u64RangeSum = 0;
+
+/* --- private routine section ------------------------------------------------------------------ */
+
+static void _printThreadpoolTestUsage(void)
+{
+    ol_printf("\
+Usage: threadpool-test [-t] [-b] [-w number] [logger options] \n\
+  -t: test thread pool.\n\
+  -b: benchmark thread pool against creating thread for each task.\n\
+  -w: number of worker, it's the number of CPUs if not specified.\n\
+logger options: [-T <0|1|2|3|4|5>] [-O] [-F log file] [-S log file size] \n\
+  -T: the log level. 0: no log, 1: error, 2: warn, 3: info, 4: debug, 5: data.\n\
+  -O: output the log to stdout.\n\
+  -F: output the log to file.\n\
+  -S: the size of log file. No limit if not specified.\n\
+    ");
+    ol_printf("\n");
+}
+
+static u32 _parseThreadpoolTestCmdLineParam(
+    olint_t argc, olchar_t ** argv, jf_logger_init_param_t * pjlip)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    olint_t nOpt;
+
+    while ((u32Ret == JF_ERR_NO_ERROR) &&
+           ((nOpt = jf_option_get(argc, argv, "tbw:T:F:OS:h")) != -1))
+    {
+        switch (nOpt)
+        {
+        case '?':
+        case 'h':
+            _printThreadpoolTestUsage();
+            exit(0);
+            break;
+        case 't':
+            ls_bTestThreadpool = TRUE;
+            break;
+        case 'b':
+            ls_bBenchmarkThreadpool = TRUE;
+            break;
+        case 'w':
+            u32Ret = jf_option_getU32FromString(jf_option_getArg(), &ls_u32NumOfWorker);
+            break;
+        case 'T':
+            u32Ret = jf_option_getU8FromString(jf_option_getArg(), &pjlip->jlip_u8TraceLevel);
+            break;
+        case 'F':
+            pjlip->jlip_bLogToFile = TRUE;
+            pjlip->jlip_pstrLogFile = jf_option_getArg();
+            break;
+        case 'O':
+            pjlip->jlip_bLogToStdout = TRUE;
+            break;
+        case 'S':
+            u32Ret = jf_option_getS32FromString(jf_option_getArg(), &pjlip->jlip_sLogFile);
+            break;
+        default:
+            u32Ret = JF_ERR_INVALID_OPTION;
+            break;
+        }
+    }
+
+    return u32Ret;
+}
+
+static inline u64 _getThreadpoolTestNanoTime(void)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+
+    return jts.jts_u64Second * 1000000000ULL + jts.jts_u64NanoSecond;
+}
+
+static u32 _createThreadpoolTestPool(jf_threadpool_t ** ppPool)
+{
+    jf_threadpool_create_param_t jtcp;
+
+    ol_bzero(&jtcp, sizeof(jtcp));
+    jtcp.jtcp_u32NumOfWorker = ls_u32NumOfWorker;
+
+    return jf_threadpool_create(ppPool, &jtcp);
+}
+
+static u32 _threadpoolTestTask(void * pArg)
+{
+    return (u32)(ulong)pArg * 2;
+}
+
+static u32 _threadpoolTestEmptyTask(void * pArg)
+{
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _onThreadpoolTestCompletion(void * pArg, u32 u32Result)
+{
+    if (u32Result != (u32)(ulong)pArg * 2)
+        jf_atomic_fetchAddU32(&ls_u32TestThreadpoolError, 1);
+
+    if (jf_atomic_fetchAddU32(&ls_u32NumOfCompleted, 1) + 1 == ls_u32NumOfExpected)
+        jf_sem_up(&ls_jsCompleted);
+
+    return JF_ERR_NO_ERROR;
+}
+
+/** Submit tasks with completion callback and wait for all of them.
+ */
+static u32 _submitThreadpoolTestTasks(
+    jf_threadpool_t * pPool, jf_threadpool_fnTask_t fnTask, u32 u32NumOfTask)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u32 u32Index = 0;
+
+    jf_atomic_storeU32(&ls_u32NumOfCompleted, 0);
+    ls_u32NumOfExpected = u32NumOfTask;
+
+    for (u32Index = 0; (u32Index < u32NumOfTask) && (u32Ret == JF_ERR_NO_ERROR); u32Index ++)
+        u32Ret = jf_threadpool_submit(
+            pPool, fnTask, (void *)(ulong)u32Index, _onThreadpoolTestCompletion);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = jf_sem_down(&ls_jsCompleted);
+
+    return u32Ret;
+}
+
+/** Recursive fibonacci, fib(n - 1) is submitted to the pool, fib(n - 2) is calculated by the
+ *  calling task, then the task waits for the future.
+ */
+static u32 _threadpoolTestFibTask(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_threadpool_fib_t * pttf = (test_threadpool_fib_t *)pArg;
+    test_threadpool_fib_t ttf1, ttf2;
+    jf_threadpool_future_t * pFuture = NULL;
+    u32 u32Result1 = 0, u32Result2 = 0;
+
+    if (pttf->ttf_u32N < 2)
+        return pttf->ttf_u32N;
+
+    ttf1 = *pttf;
+    ttf1.ttf_u32N = pttf->ttf_u32N - 1;
+    ttf2 = *pttf;
+    ttf2.ttf_u32N = pttf->ttf_u32N - 2;
+
+    u32Ret = jf_threadpool_submitWithFuture(
+        pttf->ttf_pjtPool, _threadpoolTestFibTask, &ttf1, &pFuture);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Result2 = _threadpoolTestFibTask(&ttf2);
+        jf_threadpool_waitFuture(pFuture, &u32Result1);
+        jf_threadpool_destroyFuture(&pFuture);
+    }
+    else
+    {
+        /*Calculate it in the calling task.*/
+        u32Result1 = _threadpoolTestFibTask(&ttf1);
+        u32Result2 = _threadpoolTestFibTask(&ttf2);
+    }
+
+    return u32Result1 + u32Result2;
+}
+
+static u32 _getThreadpoolTestFib(u32 u32N)
+{
+    u32 u32Fib0 = 0, u32Fib1 = 1, u32Index = 0, u32Fib = 0;
+
+    if (u32N < 2)
+        return u32N;
+
+    for (u32Index = 2; u32Index <= u32N; u32Index ++)
+    {
+        u32Fib = u32Fib0 + u32Fib1;
+        u32Fib0 = u32Fib1;
+        u32Fib1 = u32Fib;
+    }
+
+    return u32Fib;
+}
+
+static u32 _threadpoolTestRange(void * pArg, u64 u64Begin, u64 u64End)
+{
+    u64 u64Sum = 0, u64Index = 0;
+
+    for (u64Index = u64Begin; u64Index < u64End; u64Index ++)
+    {
+        if ((pArg != NULL) && (u64Index == TEST_THREADPOOL_ERROR_INDEX))
+            return JF_ERR_INVALID_PARAM;
+
+        u64Sum += u64Index;
+    }
+
+    jf_atomic_fetchAddU64(&ls_u64RangeSum, u64Sum);
+
+    return JF_ERR_NO_ERROR;
+}
+
+/** Count the indexes in the sub-range.
+ */
+static u32 _threadpoolTestRangeCount(void * pArg, u64 u64Begin, u64 u64End)
+{
+    jf_atomic_fetchAddU64(&ls_u64RangeSum, u64End - u64Begin);
+
+    return JF_ERR_NO_ERROR;
+}
+
+static u32 _testThreadpoolSubmit(jf_threadpool_t * pPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    u32Ret = _submitThreadpoolTestTasks(pPool, _threadpoolTestTask, TEST_THREADPOOL_NUM_OF_TASK);
+
+    ol_printf(
+        "submit: %u tasks, completed %u, error %u\n", TEST_THREADPOOL_NUM_OF_TASK,
+        jf_atomic_loadU32(&ls_u32NumOfCompleted), ls_u32TestThreadpoolError);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (ls_u32TestThreadpoolError != 0))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static u32 _testThreadpoolFuture(jf_threadpool_t * pPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_threadpool_future_t * pFuture[TEST_THREADPOOL_NUM_OF_FUTURE];
+    u32 u32Index = 0, u32Result = 0, u32Error = 0;
+
+    ol_bzero(pFuture, sizeof(pFuture));
+
+    for (u32Index = 0; (u32Index < TEST_THREADPOOL_NUM_OF_FUTURE) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+        u32Ret = jf_threadpool_submitWithFuture(
+            pPool, _threadpoolTestTask, (void *)(ulong)u32Index, &pFuture[u32Index]);
+
+    for (u32Index = 0; u32Index < TEST_THREADPOOL_NUM_OF_FUTURE; u32Index ++)
+    {
+        if (pFuture[u32Index] == NULL)
+            continue;
+
+        /*Destroy every 10th future without waiting.*/
+        if ((u32Index % 10) != 0)
+        {
+            jf_threadpool_waitFuture(pFuture[u32Index], &u32Result);
+            if ((u32Result != u32Index * 2) || ! jf_threadpool_isFutureReady(pFuture[u32Index]))
+                u32Error ++;
+        }
+
+        jf_threadpool_destroyFuture(&pFuture[u32Index]);
+    }
+
+    ol_printf("future: %u futures, error %u\n", TEST_THREADPOOL_NUM_OF_FUTURE, u32Error);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (u32Error != 0))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static u32 _testThreadpoolNested(jf_threadpool_t * pPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    test_threadpool_fib_t ttf;
+    jf_threadpool_future_t * pFuture = NULL;
+    u32 u32Result = 0;
+
+    ol_bzero(&ttf, sizeof(ttf));
+    ttf.ttf_pjtPool = pPool;
+    ttf.ttf_u32N = TEST_THREADPOOL_FIB;
+
+    u32Ret = jf_threadpool_submitWithFuture(pPool, _threadpoolTestFibTask, &ttf, &pFuture);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_threadpool_waitFuture(pFuture, &u32Result);
+        jf_threadpool_destroyFuture(&pFuture);
+
+        ol_printf(
+            "nested: fib(%u) = %u, expected %u\n", TEST_THREADPOOL_FIB, u32Result,
+            _getThreadpoolTestFib(TEST_THREADPOOL_FIB));
+
+        if (u32Result != _getThreadpoolTestFib(TEST_THREADPOOL_FIB))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+static u32 _testThreadpoolParallelFor(jf_threadpool_t * pPool)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Expected = (u64)TEST_THREADPOOL_RANGE * (TEST_THREADPOOL_RANGE - 1) / 2;
+
+    jf_atomic_storeU64(&ls_u64RangeSum, 0);
+    u32Ret = jf_threadpool_parallelFor(
+        pPool, 0, TEST_THREADPOOL_RANGE, TEST_THREADPOOL_RANGE_GRAIN, _threadpoolTestRange, NULL);
+
+    ol_printf(
+        "parallel-for: sum %llu, expected %llu\n", jf_atomic_loadU64(&ls_u64RangeSum),
+        u64Expected);
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_atomic_loadU64(&ls_u64RangeSum) != u64Expected))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*The error of the function is returned.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u32Ret = jf_threadpool_parallelFor(
+            pPool, 0, TEST_THREADPOOL_RANGE, TEST_THREADPOOL_RANGE_GRAIN, _threadpoolTestRange,
+            pPool);
+
+        ol_printf("parallel-for: error 0x%x, expected 0x%x\n", u32Ret, JF_ERR_INVALID_PARAM);
+
+        if (u32Ret == JF_ERR_INVALID_PARAM)
+            u32Ret = JF_ERR_NO_ERROR;
+        else
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    /*The range ends at U64_MAX, each index is run once.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_atomic_storeU64(&ls_u64RangeSum, 0);
+        u32Ret = jf_threadpool_parallelFor(
+            pPool, U64_MAX - TEST_THREADPOOL_RANGE, U64_MAX, TEST_THREADPOOL_RANGE_GRAIN,
+            _threadpoolTestRangeCount, NULL);
+
+        ol_printf(
+            "parallel-for: %llu indexes run at the end of u64, expected %u\n",
+            jf_atomic_loadU64(&ls_u64RangeSum), TEST_THREADPOOL_RANGE);
+
+        if ((u32Ret == JF_ERR_NO_ERROR) &&
+            (jf_atomic_loadU64(&ls_u64RangeSum) != TEST_THREADPOOL_RANGE))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
+/** Destroy the pool with pending tasks, all tasks are completed before the pool is destroyed.
+ */
+static u32 _testThreadpoolDestroy(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_threadpool_t * pPool = NULL;
+    u32 u32Index = 0;
+
+    jf_atomic_storeU32(&ls_u32NumOfCompleted, 0);
+    ls_u32NumOfExpected = TEST_THREADPOOL_NUM_OF_TASK;
+
+    u32Ret = _createThreadpoolTestPool(&pPool);
+    for (u32Index = 0; (u32Index < TEST_THREADPOOL_NUM_OF_TASK) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+        u32Ret = jf_threadpool_submit(
+            pPool, _threadpoolTestTask, (void *)(ulong)u32Index, _onThreadpoolTestCompletion);
+
+    if (pPool != NULL)
+        jf_threadpool_destroy(&pPool);
+
+    ol_printf(
+        "destroy: %u tasks, completed %u\n", TEST_THREADPOOL_NUM_OF_TASK,
+        jf_atomic_loadU32(&ls_u32NumOfCompleted));
+
+    if ((u32Ret == JF_ERR_NO_ERROR) &&
+        (jf_atomic_loadU32(&ls_u32NumOfCompleted) != TEST_THREADPOOL_NUM_OF_TASK))
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*Consume the count of the semaphore.*/
+    if (u32Ret == JF_ERR_NO_ERROR)
+        jf_sem_down(&ls_jsCompleted);
+
+    return u32Ret;
+}
+
+static u32 _testThreadpool(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_threadpool_t * pPool = NULL;
+
+    u32Ret = _createThreadpoolTestPool(&pPool);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("thread pool with %u workers\n", jf_threadpool_getNumOfWorker(pPool));
+
+        u32Ret = _testThreadpoolSubmit(pPool);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testThreadpoolFuture(pPool);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testThreadpoolNested(pPool);
+
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = _testThreadpoolParallelFor(pPool);
+
+        jf_threadpool_destroy(&pPool);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _testThreadpoolDestroy();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        ol_printf("Pass\n");
+
+    return u32Ret;
+}
+
+static JF_THREAD_RETURN_VALUE _threadpoolTestEmptyThread(void * pArg)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+
+    JF_THREAD_RETURN(u32Ret);
+}
+
+static u32 _benchmarkThreadpoolThread(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_thread_id_t jti;
+    u32 u32Index = 0;
+    u64 u64Time = 0;
+
+    u64Time = _getThreadpoolTestNanoTime();
+    for (u32Index = 0; (u32Index < BENCH_THREADPOOL_NUM_OF_THREAD) && (u32Ret == JF_ERR_NO_ERROR);
+         u32Index ++)
+    {
+        u32Ret = jf_thread_create(&jti, NULL, _threadpoolTestEmptyThread, NULL);
+        if (u32Ret == JF_ERR_NO_ERROR)
+            u32Ret = jf_thread_waitForThreadTermination(jti, NULL);
+    }
+    u64Time = _getThreadpoolTestNanoTime() - u64Time;
+
+    ol_printf(
+        "%-28s %8u tasks, %10.1f ns/task\n", "thread create and join:",
+        BENCH_THREADPOOL_NUM_OF_THREAD, (oldouble_t)u64Time / BENCH_THREADPOOL_NUM_OF_THREAD);
+
+    return u32Ret;
+}
+
+static u32 _benchmarkThreadpool(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_threadpool_t * pPool = NULL;
+    test_threadpool_fib_t ttf;
+    u32 u32NumOfTask = 0;
+    u64 u64Time = 0;
+
+    u32Ret = _benchmarkThreadpoolThread();
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _createThreadpoolTestPool(&pPool);
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf("thread pool with %u workers\n", jf_threadpool_getNumOfWorker(pPool));
+
+        /*Tasks submitted by non-worker thread go to the shared queue.*/
+        u64Time = _getThreadpoolTestNanoTime();
+        u32Ret = _submitThreadpoolTestTasks(
+            pPool, _threadpoolTestEmptyTask, BENCH_THREADPOOL_NUM_OF_TASK);
+        u64Time = _getThreadpoolTestNanoTime() - u64Time;
+
+        ol_printf(
+            "%-28s %8u tasks, %10.1f ns/task\n", "pool submit and complete:",
+            BENCH_THREADPOOL_NUM_OF_TASK, (oldouble_t)u64Time / BENCH_THREADPOOL_NUM_OF_TASK);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        /*Tasks submitted by worker go to the deque, fib(n) creates fib(n + 1) - 1 tasks.*/
+        ol_bzero(&ttf, sizeof(ttf));
+        ttf.ttf_pjtPool = pPool;
+        ttf.ttf_u32N = BENCH_THREADPOOL_FIB;
+        u32NumOfTask = _getThreadpoolTestFib(BENCH_THREADPOOL_FIB + 1) - 1;
+
+        u64Time = _getThreadpoolTestNanoTime();
+        if (_threadpoolTestFibTask(&ttf) != _getThreadpoolTestFib(BENCH_THREADPOOL_FIB))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+        u64Time = _getThreadpoolTestNanoTime() - u64Time;
+
+        ol_printf(
+            "%-28s %8u tasks, %10.1f ns/task\n", "pool nested with future:", u32NumOfTask,
+            (oldouble_t)u64Time / u32NumOfTask);
+    }
+
+    if (pPool != NULL)
+        jf_threadpool_destroy(&pPool);
+
+    return u32Ret;
+}
+
+/* --- public routine section ------------------------------------------------------------------- */
+
+olint_t main(olint_t argc, olchar_t ** argv)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_logger_init_param_t jlipParam;
+    jf_jiukun_init_param_t jjip;
+
+    ol_bzero(&jlipParam, sizeof(jlipParam));
+    jlipParam.jlip_pstrCallerName = "THREADPOOL-TEST";
+    jlipParam.jlip_u8TraceLevel = JF_LOGGER_TRACE_LEVEL_DEBUG;
+
+    ol_bzero(&jjip, sizeof(jjip));
+    jjip.jjip_sPool = JF_JIUKUN_MAX_POOL_SIZE;
+
+    u32Ret = _parseThreadpoolTestCmdLineParam(argc, argv, &jlipParam);
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        jf_logger_init(&jlipParam);
+
+        u32Ret = jf_jiukun_init(&jjip);
+        if (u32Ret == JF_ERR_NO_ERROR)
+        {
+            u32Ret = jf_sem_init(&ls_jsCompleted, 0, 1);
+            if (u32Ret == JF_ERR_NO_ERROR)
+            {
+                if (ls_bTestThreadpool)
+                {
+                    u32Ret = _testThreadpool();
+                }
+                else if (ls_bBenchmarkThreadpool)
+                {
+                    u32Ret = _benchmarkThreadpool();
+                }
+                else
+                {
+                    ol_printf("No operation is specified !!!!\n\n");
+                    _printThreadpoolTestUsage();
+                }
+
+                jf_sem_fini(&ls_jsCompleted);
+            }
+
+            jf_jiukun_fini();
+        }
+
+        jf_logger_logErrMsg(u32Ret, "Quit");
+        jf_logger_fini();
+    }
+
+    return u32Ret;
+}
+
+/*------------------------------------------------------------------------------------------------*/
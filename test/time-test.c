@@ -21,6 +21,7 @@
 #include "jf_string.h"
 #include "jf_date.h"
 #include "jf_option.h"
+#include "jf_clock.h"
 
 /* --- private data/data structure section ------------------------------------------------------ */
 
@@ -34,13 +35,20 @@ static boolean_t ls_bTimeTestString = FALSE;
 
 static boolean_t ls_bTimeTestSystemTime = FALSE;
 
+static boolean_t ls_bTimeTestCachedClock = FALSE;
+
+/** Number of call in the benchmark of cached clock.
+ */
+#define TIME_TEST_CLOCK_BENCH_COUNT  (1000000)
+
 /* --- private routine section ------------------------------------------------------------------ */
 
 static void _printTimeTestUsage(void)
 {
     ol_printf("\
-Usage: time-test [-c] [-p] [-r] [-t] [-s]\n\
+Usage: time-test [-c] [-o] [-p] [-r] [-t] [-s]\n\
   -c: test clock time.\n\
+  -o: test and benchmark cached clock.\n\
   -p: test time period.\n\
   -r: test time recur.\n\
   -t: test system time.\n\
@@ -55,7 +63,7 @@ static u32 _parseTimeTestCmdLineParam(olint_t argc, olchar_t ** argv)
     u32 u32Ret = JF_ERR_NO_ERROR;
     olint_t nOpt;
 
-    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "cprtsh?")) != -1))
+    while ((u32Ret == JF_ERR_NO_ERROR) && ((nOpt = jf_option_get(argc, argv, "coprtsh?")) != -1))
     {
         switch (nOpt)
         {
@@ -67,6 +75,9 @@ static u32 _parseTimeTestCmdLineParam(olint_t argc, olchar_t ** argv)
         case 'c':
             ls_bTimeTestClock = TRUE;
             break;
+        case 'o':
+            ls_bTimeTestCachedClock = TRUE;
+            break;
         case 'p':
             ls_bTimeTestPeriod = TRUE;
             break;
@@ -132,6 +143,155 @@ static u32 _testTimeClock(void)
     return u32Ret;
 }
 
+static u64 _getTimeTestMilliSecond(jf_time_clock_t clkid)
+{
+    jf_time_spec_t jts;
+
+    jf_time_getClockTime(clkid, &jts);
+
+    return jts.jts_u64Second * JF_TIME_SECOND_TO_MILLISECOND +
+        jts.jts_u64NanoSecond / JF_TIME_MILLISECOND_TO_NANOSECOND;
+}
+
+static u32 _checkTimeTestCachedClock(const olchar_t * pstrName, u64 u64Clock, u64 u64Expected)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    u64 u64Diff = (u64Clock > u64Expected) ? (u64Clock - u64Expected) : (u64Expected - u64Clock);
+
+    ol_printf(
+        "%s: %llu, expected: %llu, diff: %llu ms\n", pstrName, u64Clock, u64Expected, u64Diff);
+
+    /*The coarse clock is updated on ticks, the cached clock lags for the ticker interval.*/
+    if (u64Diff > 20)
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    return u32Ret;
+}
+
+static void _printTimeTestBench(const olchar_t * pstrName, u64 u64Start)
+{
+    u64 u64NanoSecond = jf_clock_getNanoSecondFromTick(jf_clock_getTick() - u64Start);
+
+    ol_printf("%-20s: %llu ns/call\n", pstrName, u64NanoSecond / TIME_TEST_CLOCK_BENCH_COUNT);
+}
+
+static void _benchTimeCachedClock(void)
+{
+    u32 u32Index = 0;
+    u64 u64Start = 0, u64Sum = 0;
+    jf_time_spec_t jts;
+
+    u64Start = jf_clock_getTick();
+    for (u32Index = 0; u32Index < TIME_TEST_CLOCK_BENCH_COUNT; u32Index ++)
+    {
+        jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC, &jts);
+        u64Sum += jts.jts_u64NanoSecond;
+    }
+    _printTimeTestBench("monotonic clock", u64Start);
+
+    u64Start = jf_clock_getTick();
+    for (u32Index = 0; u32Index < TIME_TEST_CLOCK_BENCH_COUNT; u32Index ++)
+    {
+        jf_time_getClockTime(JF_TIME_CLOCK_MONOTONIC_COARSE, &jts);
+        u64Sum += jts.jts_u64NanoSecond;
+    }
+    _printTimeTestBench("coarse clock", u64Start);
+
+    u64Start = jf_clock_getTick();
+    for (u32Index = 0; u32Index < TIME_TEST_CLOCK_BENCH_COUNT; u32Index ++)
+        u64Sum += jf_clock_getMonotonicMilliSecond();
+    _printTimeTestBench("cached clock", u64Start);
+
+    u64Start = jf_clock_getTick();
+    for (u32Index = 0; u32Index < TIME_TEST_CLOCK_BENCH_COUNT; u32Index ++)
+        u64Sum += jf_clock_getTick();
+    _printTimeTestBench("tick", u64Start);
+
+    ol_printf("(checksum %llu)\n", u64Sum);
+}
+
+static u32 _testTimeCachedClock(void)
+{
+    u32 u32Ret = JF_ERR_NO_ERROR;
+    jf_clock_init_param_t jcip;
+    u64 u64Tick = 0, u64NanoSecond = 0, u64MilliSecond = 0;
+
+    ol_printf("----------------------------------------------------\n");
+    ol_printf("without ticker\n");
+
+    u32Ret = _checkTimeTestCachedClock(
+        "monotonic", jf_clock_getMonotonicMilliSecond(),
+        _getTimeTestMilliSecond(JF_TIME_CLOCK_MONOTONIC));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _checkTimeTestCachedClock(
+            "realtime", jf_clock_getRealtimeMilliSecond(),
+            _getTimeTestMilliSecond(JF_TIME_CLOCK_REALTIME));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        _benchTimeCachedClock();
+
+        ol_printf("----------------------------------------------------\n");
+        ol_printf("with ticker and TSC\n");
+
+        ol_bzero(&jcip, sizeof(jcip));
+        jcip.jcip_bTicker = TRUE;
+        jcip.jcip_bTsc = TRUE;
+
+        u32Ret = jf_clock_init(&jcip);
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        ol_printf(
+            "ticker running: %s, TSC used: %s\n", jf_clock_isTickerRunning() ? "yes" : "no",
+            jf_clock_isTscUsed() ? "yes" : "no");
+        if (! jf_clock_isTickerRunning())
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+    {
+        u64Tick = jf_clock_getTick();
+        jf_time_milliSleep(100);
+        u64NanoSecond = jf_clock_getNanoSecondFromTick(jf_clock_getTick() - u64Tick);
+        ol_printf("sleep 100 ms, tick: %llu ns\n", u64NanoSecond);
+        if ((u64NanoSecond < 90 * JF_TIME_MILLISECOND_TO_NANOSECOND) ||
+            (u64NanoSecond > 500 * JF_TIME_MILLISECOND_TO_NANOSECOND))
+            u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _checkTimeTestCachedClock(
+            "monotonic", jf_clock_getMonotonicMilliSecond(),
+            _getTimeTestMilliSecond(JF_TIME_CLOCK_MONOTONIC));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        u32Ret = _checkTimeTestCachedClock(
+            "realtime", jf_clock_getRealtimeMilliSecond(),
+            _getTimeTestMilliSecond(JF_TIME_CLOCK_REALTIME));
+
+    if (u32Ret == JF_ERR_NO_ERROR)
+        _benchTimeCachedClock();
+
+    u64MilliSecond = jf_clock_getMonotonicMilliSecond();
+
+    jf_clock_fini();
+
+    if ((u32Ret == JF_ERR_NO_ERROR) && jf_clock_isTickerRunning())
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+
+    /*The monotonic clock never steps back after the ticker is stopped.*/
+    if ((u32Ret == JF_ERR_NO_ERROR) && (jf_clock_getMonotonicMilliSecond() < u64MilliSecond))
+    {
+        ol_printf("monotonic clock steps back after the ticker is stopped\n");
+        u32Ret = JF_ERR_PROGRAM_ERROR;
+    }
+
+    return u32Ret;
+}
+
 static u32 _testTimeString(void)
 {
     u32 u32Ret = JF_ERR_NO_ERROR;
@@ -334,6 +494,8 @@ olint_t main(olint_t argc, olchar_t ** argv)
     {
         if (ls_bTimeTestClock)
             u32Ret = _testTimeClock();
+        else if (ls_bTimeTestCachedClock)
+            u32Ret = _testTimeCachedClock();
         else if (ls_bTimeTestString)
             u32Ret = _testTimeString();
         else if (ls_bTimeTestPeriod)
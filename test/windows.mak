@@ -32,7 +32,7 @@ PROGRAMS = $(BIN_DIR)\mem-test.exe $(BIN_DIR)\option-test.exe $(BIN_DIR)\hashtre
     $(BIN_DIR)\linklist-test.exe $(BIN_DIR)\network-test-server.exe                               \
     $(BIN_DIR)\network-test-client.exe $(BIN_DIR)\network-test-client-chain.exe                   \
     $(BIN_DIR)\matrix-test.exe $(BIN_DIR)\webclient-test.exe $(BIN_DIR)\hex-test.exe              \
-    $(BIN_DIR)\utimer-test.exe
+    $(BIN_DIR)\utimer-test.exe $(BIN_DIR)\ringqueue-test.exe $(BIN_DIR)\threadpool-test.exe
 
 SOURCES = mem-test.c option-test.c hashtree-test.c listhead-test.c hlisthead-test.c           \
     listarray-test.c logger-test.c process-test.c thread-test.c hashtable-test.c mutex-test.c \
@@ -44,7 +44,7 @@ SOURCES = mem-test.c option-test.c hashtree-test.c listhead-test.c hlisthead-tes
     prng-test.c encode-test.c xmlparser-test.c rand-test.c persistency-test.c                 \
     archive-test.c user-test.c httpparser-test.c network-test.c linklist-test.c               \
     network-test-server.c network-test-client.c network-test-client-chain.c                   \
-    matrix-test.c webclient-test.c hex-test.c utimer-test.c
+    matrix-test.c webclient-test.c hex-test.c utimer-test.c ringqueue-test.c threadpool-test.c
 
 !include $(TOPDIR)\mak\winobjdef.mak
 
@@ -64,7 +64,7 @@ $(BIN_DIR)\option-test.exe: option-test.obj $(JIUTAI_DIR)\jf_option.obj
        jf_jiukun.lib
 
 $(BIN_DIR)\hashtree-test.exe: hashtree-test.obj $(JIUTAI_DIR)\jf_hashtree.obj \
-       $(JIUTAI_DIR)\jf_option.obj
+       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib
 
@@ -91,24 +91,30 @@ $(BIN_DIR)\thread-test.exe: thread-test.obj $(JIUTAI_DIR)\jf_thread.obj $(JIUTAI
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
 
 $(BIN_DIR)\hashtable-test.exe: hashtable-test.obj $(JIUTAI_DIR)\jf_hashtable.obj \
-       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_process.obj
+       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_process.obj $(JIUTAI_DIR)\jf_flattable.obj \
+       $(JIUTAI_DIR)\jf_time.obj $(JIUTAI_DIR)\jf_concurrent_hashtable.obj \
+       $(JIUTAI_DIR)\jf_thread.obj $(JIUTAI_DIR)\jf_mutex.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib ws2_32.lib Psapi.lib
 
-$(BIN_DIR)\mutex-test.exe: mutex-test.obj $(JIUTAI_DIR)\jf_mutex.obj $(JIUTAI_DIR)\jf_thread.obj
+$(BIN_DIR)\mutex-test.exe: mutex-test.obj $(JIUTAI_DIR)\jf_mutex.obj $(JIUTAI_DIR)\jf_thread.obj \
+       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
 
-$(BIN_DIR)\rwlock-test.exe: rwlock-test.obj $(JIUTAI_DIR)\jf_rwlock.obj $(JIUTAI_DIR)\jf_thread.obj
-	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
+$(BIN_DIR)\rwlock-test.exe: rwlock-test.obj $(JIUTAI_DIR)\jf_rwlock.obj $(JIUTAI_DIR)\jf_thread.obj \
+       $(JIUTAI_DIR)\jf_drwlock.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
+	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
+       jf_jiukun.lib synchronization.lib
 
-$(BIN_DIR)\sem-test.exe: sem-test.obj $(JIUTAI_DIR)\jf_sem.obj $(JIUTAI_DIR)\jf_thread.obj
+$(BIN_DIR)\sem-test.exe: sem-test.obj $(JIUTAI_DIR)\jf_sem.obj $(JIUTAI_DIR)\jf_thread.obj \
+       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
 
 $(BIN_DIR)\date-test.exe: date-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_date.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
 
 $(BIN_DIR)\time-test.exe: time-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj \
-       $(JIUTAI_DIR)\jf_date.obj
+       $(JIUTAI_DIR)\jf_date.obj $(JIUTAI_DIR)\jf_clock.obj $(JIUTAI_DIR)\jf_thread.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib
 
 $(BIN_DIR)\string-test.exe: string-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_hex.obj
@@ -116,11 +122,11 @@ $(BIN_DIR)\string-test.exe: string-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI
        jf_jiukun.lib jf_string.lib
 
 $(BIN_DIR)\attask-test.exe: attask-test.obj $(JIUTAI_DIR)\jf_attask.obj $(JIUTAI_DIR)\jf_time.obj \
-       $(JIUTAI_DIR)\jf_process.obj $(JIUTAI_DIR)\jf_rand.obj
+       $(JIUTAI_DIR)\jf_process.obj $(JIUTAI_DIR)\jf_rand.obj $(JIUTAI_DIR)\jf_option.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib ws2_32.lib Psapi.lib
 
-$(BIN_DIR)\bitarray-test.exe: bitarray-test.obj $(JIUTAI_DIR)\jf_option.obj
+$(BIN_DIR)\bitarray-test.exe: bitarray-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_bitmap.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_string.lib
 
@@ -140,6 +146,18 @@ $(BIN_DIR)\dynlib-test.exe: dynlib-test.obj $(JIUTAI_DIR)\jf_dynlib.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib
 
+$(BIN_DIR)\ringqueue-test.exe: ringqueue-test.obj $(JIUTAI_DIR)\jf_ringqueue.obj \
+       $(JIUTAI_DIR)\jf_queue.obj $(JIUTAI_DIR)\jf_mutex.obj $(JIUTAI_DIR)\jf_thread.obj \
+       $(JIUTAI_DIR)\jf_time.obj $(JIUTAI_DIR)\jf_option.obj
+	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
+       jf_jiukun.lib synchronization.lib
+
+$(BIN_DIR)\threadpool-test.exe: threadpool-test.obj $(JIUTAI_DIR)\jf_threadpool.obj \
+       $(JIUTAI_DIR)\jf_mutex.obj $(JIUTAI_DIR)\jf_sem.obj $(JIUTAI_DIR)\jf_thread.obj \
+       $(JIUTAI_DIR)\jf_time.obj $(JIUTAI_DIR)\jf_option.obj
+	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
+       jf_jiukun.lib synchronization.lib
+
 $(BIN_DIR)\array-test.exe: array-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_array.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib
@@ -152,11 +170,13 @@ $(BIN_DIR)\ipaddr-test.exe: ipaddr-test.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_ifmgmt.lib jf_string.lib ws2_32.lib Psapi.lib
 
-$(BIN_DIR)\sharedmemory-test-consumer.exe: sharedmemory-test-consumer.obj $(JIUTAI_DIR)\jf_sharedmemory.obj
+$(BIN_DIR)\sharedmemory-test-consumer.exe: sharedmemory-test-consumer.obj $(JIUTAI_DIR)\jf_sharedmemory.obj \
+       $(JIUTAI_DIR)\jf_shmring.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib jf_uuid.lib
 
-$(BIN_DIR)\sharedmemory-test-worker.exe: sharedmemory-test-worker.obj $(JIUTAI_DIR)\jf_sharedmemory.obj
+$(BIN_DIR)\sharedmemory-test-worker.exe: sharedmemory-test-worker.obj $(JIUTAI_DIR)\jf_sharedmemory.obj \
+       $(JIUTAI_DIR)\jf_shmring.obj $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib jf_uuid.lib
 
@@ -173,8 +193,8 @@ $(BIN_DIR)\host-test.exe: host-test.obj $(JIUTAI_DIR)\jf_host.obj
        jf_string.lib jf_ifmgmt.lib Iphlpapi.lib User32.lib Advapi32.lib
 
 $(BIN_DIR)\respool-test.exe: respool-test.obj $(JIUTAI_DIR)\jf_respool.obj $(JIUTAI_DIR)\jf_mutex.obj \
-       $(JIUTAI_DIR)\jf_array.obj $(JIUTAI_DIR)\jf_process.obj $(JIUTAI_DIR)\jf_thread.obj \
-       $(JIUTAI_DIR)\jf_sem.obj
+       $(JIUTAI_DIR)\jf_process.obj $(JIUTAI_DIR)\jf_thread.obj $(JIUTAI_DIR)\jf_sem.obj \
+       $(JIUTAI_DIR)\jf_option.obj $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_jiukun.lib ws2_32.lib Psapi.lib
 
@@ -182,7 +202,8 @@ $(BIN_DIR)\bitop-test.exe: bitop-test.obj $(JIUTAI_DIR)\jf_option.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS)
 
 $(BIN_DIR)\ptree-test.exe: ptree-test.obj $(JIUTAI_DIR)\jf_ptree.obj $(JIUTAI_DIR)\jf_option.obj \
-       $(JIUTAI_DIR)\jf_linklist.obj $(JIUTAI_DIR)\jf_hashtree.obj $(JIUTAI_DIR)\jf_stack.obj
+       $(JIUTAI_DIR)\jf_linklist.obj $(JIUTAI_DIR)\jf_hashtree.obj $(JIUTAI_DIR)\jf_stack.obj \
+       $(JIUTAI_DIR)\jf_time.obj
 	@$(LINK) $(LDFLAGS) $(EXTRA_LDFLAGS) /LIBPATH:$(LIB_DIR) /OUT:$@ $** $(SYSLIBS) jf_logger.lib \
        jf_string.lib jf_jiukun.lib
 
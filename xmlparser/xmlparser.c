@@ -666,6 +666,7 @@ u32 jf_xmlparser_parseXmlDoc(
     u32 u32Ret = JF_ERR_NO_ERROR;
     internal_xmlparser_xml_doc_t * pixxd = NULL;
     jf_ptree_t * pjpXml = NULL;
+    jf_ptree_create_param_t jpcp;
 
     *ppPtree = NULL;
     initXmlErrMsg();
@@ -674,8 +675,10 @@ u32 jf_xmlparser_parseXmlDoc(
 
     if (u32Ret == JF_ERR_NO_ERROR)
     {
-        /*Create the property tree.*/
-        u32Ret = jf_ptree_create(&pjpXml);
+        /*Create the property tree in arena mode, the document is mostly read after parsing.*/
+        ol_bzero(&jpcp, sizeof(jpcp));
+        jpcp.jpcp_bArena = TRUE;
+        u32Ret = jf_ptree_createWithParam(&pjpXml, &jpcp);
     }
 
     if (u32Ret == JF_ERR_NO_ERROR)